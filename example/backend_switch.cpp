@@ -23,7 +23,7 @@ run_backend_probe(simplenet::io_context& context) {
 
 int main(int argc, char** argv) {
     if (argc > 2) {
-        std::cerr << "usage: simplenet_backend_switch [epoll|io_uring]\n";
+        std::cerr << "usage: simplenet_backend_switch [epoll|io_uring|automatic]\n";
         return 2;
     }
 
@@ -34,9 +34,11 @@ int main(int argc, char** argv) {
         backend = simplenet::runtime::engine::backend::epoll;
     } else if (backend_name == "io_uring") {
         backend = simplenet::runtime::engine::backend::io_uring;
+    } else if (backend_name == "automatic") {
+        backend = simplenet::runtime::engine::backend::automatic;
     } else {
         std::cerr << "unknown backend '" << backend_name
-                  << "', expected 'epoll' or 'io_uring'\n";
+                  << "', expected 'epoll', 'io_uring' or 'automatic'\n";
         return 2;
     }
 
@@ -54,6 +56,15 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::cout << "backend " << backend_name << " executed successfully\n";
+    std::cout << "backend " << backend_name << " executed successfully";
+    if (backend == simplenet::runtime::engine::backend::automatic) {
+        std::cout << " (selected "
+                  << (context.selected_backend() ==
+                              simplenet::runtime::engine::backend::io_uring
+                          ? "io_uring"
+                          : "epoll")
+                  << ")";
+    }
+    std::cout << '\n';
     return 0;
 }
@@ -316,9 +316,9 @@ simplenet::runtime::task<void> run_accept_loop(
         }
 
         accepted_count.fetch_add(1, std::memory_order_relaxed);
-        context.spawn(run_echo_session(std::move(accepted.value()), iterations,
-                                       payload_size, failed, error_mutex,
-                                       error_message));
+        context.spawn_detached(run_echo_session(std::move(accepted.value()),
+                                                iterations, payload_size, failed,
+                                                error_mutex, error_message));
     }
 
     co_return;
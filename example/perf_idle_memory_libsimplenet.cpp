@@ -0,0 +1,281 @@
+#include "simplenet/simplenet.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <vector>
+
+// Count live heap bytes so the figure covers every allocation a parked
+// connection holds: coroutine frames, writer queues and read buffers.
+namespace {
+
+std::atomic<std::int64_t> g_live_bytes{0};
+
+void *counted_allocate(std::size_t size, std::size_t alignment) {
+    void *memory = alignment <= alignof(std::max_align_t)
+                       ? std::malloc(size == 0U ? 1U : size)
+                       : std::aligned_alloc(alignment,
+                                            (size + alignment - 1U) / alignment *
+                                                alignment);
+    if (memory == nullptr) {
+        throw std::bad_alloc{};
+    }
+    g_live_bytes.fetch_add(static_cast<std::int64_t>(::malloc_usable_size(memory)),
+                           std::memory_order_relaxed);
+    return memory;
+}
+
+void counted_free(void *memory) noexcept {
+    if (memory == nullptr) {
+        return;
+    }
+    g_live_bytes.fetch_sub(static_cast<std::int64_t>(::malloc_usable_size(memory)),
+                           std::memory_order_relaxed);
+    std::free(memory);
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    return counted_allocate(size, alignof(std::max_align_t));
+}
+void *operator new[](std::size_t size) {
+    return counted_allocate(size, alignof(std::max_align_t));
+}
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_allocate(size, alignof(std::max_align_t));
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_allocate(size, alignof(std::max_align_t));
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+void operator delete(void *memory) noexcept {
+    counted_free(memory);
+}
+void operator delete[](void *memory) noexcept {
+    counted_free(memory);
+}
+void operator delete(void *memory, std::size_t) noexcept {
+    counted_free(memory);
+}
+void operator delete[](void *memory, std::size_t) noexcept {
+    counted_free(memory);
+}
+void operator delete(void *memory, std::align_val_t) noexcept {
+    counted_free(memory);
+}
+void operator delete[](void *memory, std::align_val_t) noexcept {
+    counted_free(memory);
+}
+void operator delete(void *memory, const std::nothrow_t&) noexcept {
+    counted_free(memory);
+}
+void operator delete[](void *memory, const std::nothrow_t&) noexcept {
+    counted_free(memory);
+}
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept {
+    counted_free(memory);
+}
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept {
+    counted_free(memory);
+}
+
+namespace {
+
+struct options {
+    std::size_t connections{1000};
+    std::string backend{"epoll"};
+    /// `idle` frees read buffers between messages; `eager` keeps them.
+    std::string reader{"idle"};
+};
+
+bool parse_positive_size(const char* text, std::size_t& value) {
+    if (text == nullptr || *text == '\0') {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || parsed == 0) {
+        return false;
+    }
+    if (parsed > static_cast<unsigned long long>(std::numeric_limits<std::size_t>::max())) {
+        return false;
+    }
+
+    value = static_cast<std::size_t>(parsed);
+    return true;
+}
+
+bool parse_args(int argc, char** argv, options& out) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (arg == "--connections" && i + 1 < argc) {
+            if (!parse_positive_size(argv[++i], out.connections)) {
+                return false;
+            }
+            continue;
+        }
+        if (arg == "--backend" && i + 1 < argc) {
+            out.backend = argv[++i];
+            if (out.backend != "epoll" && out.backend != "io_uring") {
+                return false;
+            }
+            continue;
+        }
+        if (arg == "--reader" && i + 1 < argc) {
+            out.reader = argv[++i];
+            if (out.reader != "idle" && out.reader != "eager") {
+                return false;
+            }
+            continue;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void print_usage() {
+    std::cerr << "usage: simplenet_perf_idle_memory_libsimplenet "
+                 "[--connections N] [--backend epoll|io_uring] "
+                 "[--reader idle|eager]\n";
+}
+
+/// Two descriptors per connection; lift the soft limit as far as allowed.
+void raise_descriptor_limit() {
+    ::rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        (void)::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+/// A line-echo session that spends the measurement parked on a read.
+simplenet::runtime::task<void>
+idle_session(simplenet::nonblocking::tcp_stream stream, bool release_when_idle) {
+    simplenet::runtime::queued_writer writer{std::move(stream)};
+    simplenet::runtime::framed_reader reader{
+        writer.stream(),
+        simplenet::runtime::framed_reader_options{.release_when_idle =
+                                                      release_when_idle}};
+    while (true) {
+        auto line = co_await simplenet::runtime::async_read_until(reader, "\r\n");
+        if (!line.has_value() || !line.value().has_value()) {
+            co_return;
+        }
+        (void)writer.enqueue(line.value()->bytes);
+        (void)co_await writer.flush(std::chrono::seconds{1});
+    }
+}
+
+/// Sample the heap once every session is parked, then hang up the clients.
+simplenet::runtime::task<void>
+measure(std::vector<simplenet::blocking::tcp_stream>& clients,
+        std::int64_t& parked_bytes) {
+    (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{200});
+    parked_bytes = g_live_bytes.load(std::memory_order_relaxed);
+    clients.clear();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts{};
+    if (!parse_args(argc, argv, opts)) {
+        print_usage();
+        return 2;
+    }
+    raise_descriptor_limit();
+
+    simplenet::io_context context{opts.backend == "epoll"
+                                      ? simplenet::io_context::backend::epoll
+                                      : simplenet::io_context::backend::io_uring};
+    if (!context.valid()) {
+        std::cerr << "backend unavailable: " << opts.backend << "\n";
+        return 1;
+    }
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::socket_address::loopback(0));
+    if (!listener_result.has_value()) {
+        std::cerr << "bind failed: " << listener_result.error().message() << "\n";
+        return 1;
+    }
+    auto listener = std::move(listener_result.value());
+    const auto address = listener.local_address();
+    if (!address.has_value()) {
+        std::cerr << "local_address failed: " << address.error().message() << "\n";
+        return 1;
+    }
+
+    std::vector<simplenet::blocking::tcp_stream> clients;
+    std::vector<simplenet::nonblocking::tcp_stream> accepted;
+    clients.reserve(opts.connections);
+    accepted.reserve(opts.connections);
+    for (std::size_t index = 0; index < opts.connections; ++index) {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(address.value().port()));
+        if (!client.has_value()) {
+            std::cerr << "connect failed after " << index
+                      << " connections: " << client.error().message() << "\n";
+            return 1;
+        }
+        auto server = listener.accept();
+        if (!server.has_value()) {
+            std::cerr << "accept failed: " << server.error().message() << "\n";
+            return 1;
+        }
+        clients.push_back(std::move(client.value()));
+        accepted.push_back(std::move(server.value()));
+    }
+
+    const bool release_when_idle = opts.reader == "idle";
+    const auto baseline = g_live_bytes.load(std::memory_order_relaxed);
+    for (auto& stream : accepted) {
+        context.spawn(idle_session(std::move(stream), release_when_idle));
+    }
+    std::int64_t parked = baseline;
+    context.spawn(measure(clients, parked));
+
+    const auto run_status = context.run();
+    if (!run_status.has_value()) {
+        std::cerr << "runtime error: " << run_status.error().message() << "\n";
+        return 1;
+    }
+
+    const auto held = parked > baseline ? parked - baseline : 0;
+    std::cout << std::fixed << std::setprecision(1)
+              << "PERF,impl=libsimplenet,scenario=idle_memory,backend="
+              << opts.backend << ",reader=" << opts.reader
+              << ",connections=" << opts.connections << ",heap_bytes=" << held
+              << ",bytes_per_connection="
+              << static_cast<double>(held) / static_cast<double>(opts.connections)
+              << "\n";
+    return 0;
+}
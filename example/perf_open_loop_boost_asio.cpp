@@ -0,0 +1,144 @@
+#include "perf_open_loop_common.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace {
+
+using tcp = boost::asio::ip::tcp;
+
+bool parse_args(int argc, char** argv, open_loop::options& out) {
+    for (int i = 1; i < argc; ++i) {
+        bool ok = true;
+        if (!open_loop::parse_flag(argc, argv, i, out, ok) || !ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_usage() {
+    std::cerr << "usage: simplenet_perf_open_loop_boost_asio "
+              << open_loop::usage_flags << "\n";
+}
+
+/// Echo whatever arrives; requests are pipelined, so no framing is needed.
+boost::asio::awaitable<void> run_echo_session(tcp::socket socket,
+                                              std::shared_ptr<std::atomic_bool> failed) {
+    std::array<char, 16384> buffer{};
+    boost::system::error_code ec;
+    while (true) {
+        const std::size_t read_count = co_await socket.async_read_some(
+            boost::asio::buffer(buffer),
+            boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        if (ec == boost::asio::error::eof) {
+            co_return;
+        }
+        if (ec) {
+            failed->store(true, std::memory_order_release);
+            co_return;
+        }
+        co_await boost::asio::async_write(
+            socket, boost::asio::buffer(buffer.data(), read_count),
+            boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        if (ec) {
+            failed->store(true, std::memory_order_release);
+            co_return;
+        }
+    }
+}
+
+boost::asio::awaitable<void> run_accept_loop(tcp::acceptor& acceptor,
+                                             std::size_t connections,
+                                             std::shared_ptr<std::atomic_bool> failed) {
+    auto executor = co_await boost::asio::this_coro::executor;
+    boost::system::error_code ec;
+    for (std::size_t c = 0; c < connections; ++c) {
+        tcp::socket socket = co_await acceptor.async_accept(
+            boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        if (ec) {
+            failed->store(true, std::memory_order_release);
+            co_return;
+        }
+        socket.set_option(tcp::no_delay(true), ec);
+        boost::asio::co_spawn(executor, run_echo_session(std::move(socket), failed),
+                              boost::asio::detached);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    open_loop::options opts{};
+    if (!parse_args(argc, argv, opts)) {
+        print_usage();
+        return 2;
+    }
+
+    boost::asio::io_context io;
+    tcp::acceptor acceptor(io);
+    boost::system::error_code ec;
+    acceptor.open(tcp::v4(), ec);
+    if (!ec) {
+        acceptor.set_option(tcp::acceptor::reuse_address(true), ec);
+    }
+    if (!ec) {
+        acceptor.bind(tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0), ec);
+    }
+    if (!ec) {
+        acceptor.listen(static_cast<int>(opts.connections > 64 ? opts.connections : 64),
+                        ec);
+    }
+    const std::uint16_t port = ec ? 0 : acceptor.local_endpoint(ec).port();
+    if (ec) {
+        std::cerr << "acceptor setup failed: " << ec.message() << "\n";
+        return 1;
+    }
+
+    auto failed = std::make_shared<std::atomic_bool>(false);
+    boost::asio::co_spawn(io, run_accept_loop(acceptor, opts.connections, failed),
+                          boost::asio::detached);
+    auto guard = boost::asio::make_work_guard(io);
+    std::thread io_thread([&]() { io.run(); });
+
+    const auto result = open_loop::run(port, opts);
+
+    guard.reset();
+    io.stop();
+    io_thread.join();
+
+    if (!result.error.empty()) {
+        std::cerr << "benchmark failed: " << result.error << "\n";
+        return 1;
+    }
+    if (failed->load(std::memory_order_acquire)) {
+        std::cerr << "benchmark failed: server error\n";
+        return 1;
+    }
+    if (result.unanswered != 0U) {
+        std::cerr << "benchmark failed: " << result.unanswered
+                  << " requests unanswered after the drain window\n";
+        return 1;
+    }
+
+    std::cout << "PERF,impl=boost_asio,scenario=open_loop_echo,backend=epoll"
+              << ",rate=" << opts.rate << ",connections=" << opts.connections
+              << ",payload_size=" << opts.payload_size
+              << ",duration_ms=" << opts.duration_ms;
+    open_loop::print_results(std::cout, result);
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,412 @@
+#pragma once
+
+// Open-loop echo load generator shared by the perf_open_loop_* benchmarks.
+//
+// Requests go out on a fixed schedule whether or not earlier ones were
+// answered, and each latency is measured from the time the request was
+// *scheduled* to be sent. A server (or generator) stall therefore shows up
+// in the latency of every request it delayed, instead of silently lowering
+// the offered rate the way a closed-loop client does (coordinated
+// omission). The uncorrected histogram measures from the time the generator
+// actually queued the request, for comparison.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace open_loop {
+
+using steady = std::chrono::steady_clock;
+
+struct options {
+    std::uint64_t rate{20000};
+    std::size_t connections{64};
+    std::size_t payload_size{64};
+    std::uint64_t duration_ms{2000};
+    std::uint64_t drain_ms{5000};
+};
+
+/**
+ * HDR-style log-linear histogram of nanosecond values.
+ *
+ * Values below 2048 get exact buckets; above that every power-of-two range
+ * is split into 1024 buckets, so a reported value is within 0.1% of the
+ * recorded one. Values past about 18 minutes are clamped.
+ */
+class latency_histogram {
+public:
+    latency_histogram() : counts_(bucket_count, 0) {}
+
+    void record(std::uint64_t nanoseconds) {
+        ++counts_[index_of(std::min(nanoseconds, max_trackable))];
+        ++total_;
+        max_ = std::max(max_, nanoseconds);
+    }
+
+    [[nodiscard]] std::uint64_t total() const { return total_; }
+    [[nodiscard]] std::uint64_t max() const { return max_; }
+
+    /// Highest value equivalent to the `quantile` sample (0 < quantile <= 1).
+    [[nodiscard]] std::uint64_t value_at(double quantile) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        const auto wanted = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(quantile * static_cast<double>(total_) +
+                                          0.999999));
+        std::uint64_t seen = 0;
+        for (std::size_t index = 0; index < counts_.size(); ++index) {
+            seen += counts_[index];
+            if (seen >= wanted) {
+                return std::min(highest_equivalent(index), max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    static constexpr unsigned sub_bucket_bits = 11;
+    static constexpr std::uint64_t sub_bucket_count = 1ULL << sub_bucket_bits;
+    static constexpr std::uint64_t sub_bucket_half = sub_bucket_count / 2;
+    static constexpr unsigned max_magnitude = 40;
+    static constexpr std::uint64_t max_trackable = (1ULL << max_magnitude) - 1;
+    static constexpr std::size_t bucket_count =
+        (max_magnitude - sub_bucket_bits + 1) * sub_bucket_half + sub_bucket_count;
+
+    static std::size_t index_of(std::uint64_t value) {
+        if (value < sub_bucket_count) {
+            return static_cast<std::size_t>(value);
+        }
+        const auto shift =
+            static_cast<unsigned>(std::bit_width(value)) - sub_bucket_bits;
+        return static_cast<std::size_t>(shift * sub_bucket_half + (value >> shift));
+    }
+
+    static std::uint64_t highest_equivalent(std::size_t index) {
+        if (index < sub_bucket_count) {
+            return index;
+        }
+        const std::uint64_t shift = index / sub_bucket_half - 1;
+        const std::uint64_t sub = index - shift * sub_bucket_half;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_{0};
+    std::uint64_t max_{0};
+};
+
+struct report {
+    latency_histogram corrected{};
+    latency_histogram uncorrected{};
+    std::uint64_t scheduled{0};
+    std::uint64_t unanswered{0};
+    double elapsed_s{0.0};
+    std::string error{};
+};
+
+inline bool parse_positive(const char* text, std::uint64_t& value) {
+    if (text == nullptr || *text == '\0') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || parsed == 0) {
+        return false;
+    }
+    value = static_cast<std::uint64_t>(parsed);
+    return true;
+}
+
+/// Consume one generator flag at `argv[i]`; returns false when it is not one.
+inline bool parse_flag(int argc, char** argv, int& i, options& out, bool& ok) {
+    const std::string_view arg{argv[i]};
+    std::uint64_t value = 0;
+    const auto take = [&]() {
+        ok = i + 1 < argc && parse_positive(argv[++i], value);
+        return value;
+    };
+    if (arg == "--rate") {
+        out.rate = take();
+    } else if (arg == "--connections") {
+        out.connections = static_cast<std::size_t>(take());
+    } else if (arg == "--payload-size") {
+        out.payload_size = static_cast<std::size_t>(take());
+    } else if (arg == "--duration-ms") {
+        out.duration_ms = take();
+    } else if (arg == "--drain-ms") {
+        out.drain_ms = take();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline constexpr std::string_view usage_flags =
+    "[--rate REQ_PER_SEC] [--connections N] [--payload-size N] "
+    "[--duration-ms N] [--drain-ms N]";
+
+namespace detail {
+
+struct pending_request {
+    steady::time_point intended;
+    steady::time_point queued;
+};
+
+struct connection {
+    int fd{-1};
+    std::uint64_t issued{0};
+    std::size_t unsent{0};
+    std::size_t partial{0};
+    std::deque<pending_request> outstanding{};
+};
+
+inline std::string errno_text(const char* what, int error_number) {
+    return std::string{what} + ": " +
+           std::error_code(error_number, std::generic_category()).message();
+}
+
+inline bool connect_loopback(std::uint16_t port, int& out, std::string& error) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = errno_text("client socket failed", errno);
+        return false;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int rc = 0;
+    do {
+        rc = ::connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                       sizeof(address));
+    } while (rc != 0 && errno == EINTR);
+    const int enabled = 1;
+    if (rc != 0 ||
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled)) != 0 ||
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+        error = errno_text("client connect failed", errno);
+        static_cast<void>(::close(fd));
+        return false;
+    }
+    out = fd;
+    return true;
+}
+
+inline timespec to_timespec(steady::time_point when) {
+    const auto since = when.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since);
+    timespec out{};
+    out.tv_sec = static_cast<time_t>(seconds.count());
+    out.tv_nsec = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since - seconds)
+            .count());
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * Drive `opts.rate` echo requests per second, spread evenly over
+ * `opts.connections` loopback connections to `port`, for `opts.duration_ms`.
+ * Runs on the calling thread with its own epoll set; the server under test
+ * runs elsewhere.
+ */
+inline report run(std::uint16_t port, const options& opts) {
+    report out{};
+    const auto duration = std::chrono::milliseconds{opts.duration_ms};
+    const std::uint64_t per_connection =
+        std::max<std::uint64_t>(1, opts.rate * opts.duration_ms / 1000 /
+                                       opts.connections);
+    // One connection's gap between requests; connections are staggered.
+    const auto interval = std::chrono::nanoseconds{
+        static_cast<std::int64_t>(1e9 * static_cast<double>(opts.connections) /
+                                  static_cast<double>(opts.rate))};
+
+    std::vector<detail::connection> connections(opts.connections);
+    const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    const int timer_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    const auto cleanup = [&]() {
+        for (auto& conn : connections) {
+            if (conn.fd >= 0) {
+                static_cast<void>(::close(conn.fd));
+            }
+        }
+        static_cast<void>(::close(timer_fd));
+        static_cast<void>(::close(epoll_fd));
+    };
+    if (epoll_fd < 0 || timer_fd < 0) {
+        out.error = detail::errno_text("epoll/timerfd setup failed", errno);
+        cleanup();
+        return out;
+    }
+    epoll_event timer_event{};
+    timer_event.events = EPOLLIN;
+    timer_event.data.u64 = std::numeric_limits<std::uint64_t>::max();
+    static_cast<void>(::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &timer_event));
+
+    for (std::size_t index = 0; index < connections.size(); ++index) {
+        if (!detail::connect_loopback(port, connections[index].fd, out.error)) {
+            cleanup();
+            return out;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        event.data.u64 = index;
+        static_cast<void>(
+            ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connections[index].fd, &event));
+    }
+
+    const std::vector<std::byte> outgoing(std::max<std::size_t>(opts.payload_size, 65536),
+                                          std::byte{0x42});
+    std::vector<std::byte> incoming(65536);
+    const auto start = steady::now() + std::chrono::milliseconds{10};
+    const auto due = [&](std::size_t index) {
+        const auto stagger = interval * static_cast<std::int64_t>(index) /
+                             static_cast<std::int64_t>(connections.size());
+        return start + stagger +
+               interval * static_cast<std::int64_t>(connections[index].issued);
+    };
+    const auto drain_deadline =
+        start + duration + interval + std::chrono::milliseconds{opts.drain_ms};
+    const std::uint64_t total = per_connection * connections.size();
+    std::uint64_t answered = 0;
+
+    const auto flush = [&](detail::connection& conn) {
+        while (conn.unsent > 0) {
+            const std::size_t chunk = std::min(conn.unsent, outgoing.size());
+            const ssize_t wrote = ::send(conn.fd, outgoing.data(), chunk, MSG_NOSIGNAL);
+            if (wrote < 0) {
+                if (errno != EAGAIN && errno != EINTR) {
+                    out.error = detail::errno_text("client send failed", errno);
+                }
+                return;
+            }
+            conn.unsent -= static_cast<std::size_t>(wrote);
+        }
+    };
+    const auto drain = [&](detail::connection& conn) {
+        while (true) {
+            const ssize_t got = ::recv(conn.fd, incoming.data(), incoming.size(), 0);
+            if (got <= 0) {
+                if (got == 0) {
+                    out.error = "server closed a connection";
+                } else if (errno != EAGAIN && errno != EINTR) {
+                    out.error = detail::errno_text("client recv failed", errno);
+                }
+                return;
+            }
+            conn.partial += static_cast<std::size_t>(got);
+            const auto now = steady::now();
+            while (conn.partial >= opts.payload_size && !conn.outstanding.empty()) {
+                conn.partial -= opts.payload_size;
+                const auto request = conn.outstanding.front();
+                conn.outstanding.pop_front();
+                out.corrected.record(static_cast<std::uint64_t>(
+                    std::chrono::nanoseconds{now - request.intended}.count()));
+                out.uncorrected.record(static_cast<std::uint64_t>(
+                    std::chrono::nanoseconds{now - request.queued}.count()));
+                ++answered;
+            }
+        }
+    };
+
+    std::vector<epoll_event> events(connections.size() + 1);
+    while (answered < total && out.error.empty()) {
+        auto now = steady::now();
+        if (now >= drain_deadline) {
+            break;
+        }
+
+        auto next = drain_deadline;
+        for (std::size_t index = 0; index < connections.size(); ++index) {
+            auto& conn = connections[index];
+            bool queued = false;
+            while (conn.issued < per_connection && due(index) <= now) {
+                conn.outstanding.push_back({due(index), now});
+                conn.unsent += opts.payload_size;
+                ++conn.issued;
+                queued = true;
+            }
+            if (queued) {
+                flush(conn);
+            }
+            if (conn.issued < per_connection) {
+                next = std::min(next, due(index));
+            }
+        }
+
+        itimerspec timer{};
+        timer.it_value = detail::to_timespec(next);
+        static_cast<void>(::timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr));
+        const int ready = ::epoll_wait(epoll_fd, events.data(),
+                                       static_cast<int>(events.size()), -1);
+        if (ready < 0 && errno != EINTR) {
+            out.error = detail::errno_text("epoll_wait failed", errno);
+            break;
+        }
+        for (int slot = 0; slot < ready; ++slot) {
+            const auto key = events[static_cast<std::size_t>(slot)].data.u64;
+            if (key == timer_event.data.u64) {
+                std::uint64_t expirations = 0;
+                static_cast<void>(::read(timer_fd, &expirations, sizeof(expirations)));
+                continue;
+            }
+            auto& conn = connections[static_cast<std::size_t>(key)];
+            drain(conn);
+            flush(conn);
+        }
+    }
+
+    out.elapsed_s =
+        std::chrono::duration<double>{steady::now() - start}.count();
+    for (const auto& conn : connections) {
+        out.scheduled += conn.issued;
+    }
+    out.unanswered = total - answered;
+    cleanup();
+    return out;
+}
+
+/// Append request counts and percentiles, in microseconds, to a PERF line.
+inline void print_results(std::ostream& os, const report& result) {
+    const auto us = [](std::uint64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    };
+    const auto fields = [&](std::string_view prefix, const latency_histogram& h) {
+        os << "," << prefix << "p50_us=" << us(h.value_at(0.50)) << "," << prefix
+           << "p99_us=" << us(h.value_at(0.99)) << "," << prefix
+           << "p999_us=" << us(h.value_at(0.999)) << "," << prefix
+           << "max_us=" << us(h.max());
+    };
+    os << ",requests=" << result.corrected.total() << std::fixed
+       << std::setprecision(3) << ",achieved_rate="
+       << static_cast<double>(result.corrected.total()) / result.elapsed_s;
+    fields("", result.corrected);
+    fields("uncorrected_", result.uncorrected);
+}
+
+} // namespace open_loop
@@ -0,0 +1,186 @@
+#include "perf_open_loop_common.hpp"
+#include "simplenet/simplenet.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace {
+
+struct options {
+    open_loop::options load{};
+    simplenet::runtime::engine::backend backend{
+        simplenet::runtime::engine::backend::epoll};
+    std::uint32_t uring_queue_depth{512};
+};
+
+bool parse_backend(std::string_view arg, simplenet::runtime::engine::backend& out) {
+    if (arg == "epoll") {
+        out = simplenet::runtime::engine::backend::epoll;
+        return true;
+    }
+    if (arg == "io_uring") {
+        out = simplenet::runtime::engine::backend::io_uring;
+        return true;
+    }
+    return false;
+}
+
+const char* backend_name(simplenet::runtime::engine::backend backend) {
+    if (backend == simplenet::runtime::engine::backend::io_uring) {
+        return "io_uring";
+    }
+    return "epoll";
+}
+
+bool parse_args(int argc, char** argv, options& out) {
+    for (int i = 1; i < argc; ++i) {
+        bool ok = true;
+        if (open_loop::parse_flag(argc, argv, i, out.load, ok)) {
+            if (!ok) {
+                return false;
+            }
+            continue;
+        }
+
+        const std::string arg{argv[i]};
+        if (arg == "--backend" && i + 1 < argc) {
+            if (!parse_backend(argv[++i], out.backend)) {
+                return false;
+            }
+            continue;
+        }
+        if (arg == "--uring-queue-depth" && i + 1 < argc) {
+            std::uint64_t depth = 0;
+            if (!open_loop::parse_positive(argv[++i], depth) ||
+                depth > UINT32_MAX) {
+                return false;
+            }
+            out.uring_queue_depth = static_cast<std::uint32_t>(depth);
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+void print_usage() {
+    std::cerr << "usage: simplenet_perf_open_loop_libsimplenet "
+              << open_loop::usage_flags
+              << " [--backend epoll|io_uring] [--uring-queue-depth N]\n";
+}
+
+/// Echo whatever arrives; requests are pipelined, so no framing is needed.
+simplenet::runtime::task<void> run_echo_session(
+    simplenet::nonblocking::tcp_stream stream, std::atomic_bool& failed) {
+    std::array<std::byte, 16384> buffer{};
+    while (true) {
+        auto read = co_await simplenet::runtime::async_read_some(stream, buffer);
+        if (!read.has_value()) {
+            failed.store(true, std::memory_order_release);
+            co_return;
+        }
+        if (read.value() == 0U) {
+            co_return;
+        }
+        auto written = co_await simplenet::runtime::async_write_all(
+            stream, std::span<const std::byte>{buffer.data(), read.value()});
+        if (!written.has_value()) {
+            failed.store(true, std::memory_order_release);
+            co_return;
+        }
+    }
+}
+
+simplenet::runtime::task<void>
+run_accept_loop(simplenet::io_context& context,
+                simplenet::nonblocking::tcp_listener& listener,
+                std::size_t connections, std::atomic_bool& failed) {
+    for (std::size_t c = 0; c < connections; ++c) {
+        auto accepted = co_await simplenet::runtime::async_accept(listener);
+        if (!accepted.has_value()) {
+            failed.store(true, std::memory_order_release);
+            co_return;
+        }
+        context.spawn_detached(
+            run_echo_session(std::move(accepted.value()), failed));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts{};
+    if (!parse_args(argc, argv, opts)) {
+        print_usage();
+        return 2;
+    }
+
+    simplenet::io_context context{opts.backend, opts.uring_queue_depth};
+    if (!context.valid()) {
+        std::cerr << "backend unavailable: " << backend_name(opts.backend) << "\n";
+        return 3;
+    }
+
+    const simplenet::nonblocking::listen_options listen{
+        .backlog = static_cast<int>(
+            opts.load.connections > 64 ? opts.load.connections : 64),
+        .socket = {.no_delay = true}};
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), listen);
+    if (!listener_result.has_value()) {
+        std::cerr << "bind failed: " << listener_result.error().message() << "\n";
+        return 1;
+    }
+    auto listener = std::move(listener_result.value());
+    const auto port = listener.local_port();
+    if (!port.has_value()) {
+        std::cerr << "local_port failed: " << port.error().message() << "\n";
+        return 1;
+    }
+
+    std::atomic_bool failed{false};
+    context.spawn(
+        run_accept_loop(context, listener, opts.load.connections, failed));
+    std::promise<simplenet::result<void>> run_promise;
+    auto run_future = run_promise.get_future();
+    std::thread runtime_thread([&]() { run_promise.set_value(context.run()); });
+
+    const auto result = open_loop::run(port.value(), opts.load);
+
+    context.stop();
+    runtime_thread.join();
+    const auto run_status = run_future.get();
+
+    if (!result.error.empty()) {
+        std::cerr << "benchmark failed: " << result.error << "\n";
+        return 1;
+    }
+    if (!run_status.has_value() || failed.load(std::memory_order_acquire)) {
+        std::cerr << "benchmark failed: server error\n";
+        return 1;
+    }
+    if (result.unanswered != 0U) {
+        std::cerr << "benchmark failed: " << result.unanswered
+                  << " requests unanswered after the drain window\n";
+        return 1;
+    }
+
+    std::cout << "PERF,impl=libsimplenet,scenario=open_loop_echo,backend="
+              << backend_name(opts.backend) << ",rate=" << opts.load.rate
+              << ",connections=" << opts.load.connections
+              << ",payload_size=" << opts.load.payload_size
+              << ",duration_ms=" << opts.load.duration_ms
+              << ",uring_queue_depth=" << opts.uring_queue_depth;
+    open_loop::print_results(std::cout, result);
+    std::cout << "\n";
+    return 0;
+}
@@ -24,6 +24,7 @@ enum class bench_mode {
     all,
     alloc_only,
     reuse_only,
+    direct_only,
 };
 
 struct bench_result {
@@ -61,9 +62,10 @@ bench_result run_alloc_baseline(int epoll_fd, std::size_t iterations) {
         .waits_per_sec = static_cast<double>(iterations) / total_s};
 }
 
-bench_result run_reuse_path(simplenet::epoll::reactor& reactor,
-                            std::size_t iterations) {
-    std::array<simplenet::epoll::ready_event, kBatchSize> events{};
+template <class Event>
+bench_result run_reactor_path(simplenet::epoll::reactor& reactor,
+                              std::size_t iterations) {
+    std::array<Event, kBatchSize> events{};
     const auto start = std::chrono::steady_clock::now();
 
     for (std::size_t i = 0; i < iterations; ++i) {
@@ -98,6 +100,10 @@ bool parse_mode(const std::string_view value, bench_mode& mode) {
         mode = bench_mode::reuse_only;
         return true;
     }
+    if (value == "direct") {
+        mode = bench_mode::direct_only;
+        return true;
+    }
     return false;
 }
 
@@ -138,7 +144,7 @@ int main(int argc, char** argv) {
     bench_mode mode = bench_mode::all;
     if (!parse_args(argc, argv, iterations, mode)) {
         std::cerr
-            << "usage: simplenet_perf_reactor_wait [iterations] [--mode all|alloc|reuse]\n";
+            << "usage: simplenet_perf_reactor_wait [iterations] [--mode all|alloc|reuse|direct]\n";
         return 1;
     }
 
@@ -180,7 +186,8 @@ int main(int argc, char** argv) {
     }
 
     if (mode == bench_mode::reuse_only) {
-        const auto reuse = run_reuse_path(reactor, iterations);
+        const auto reuse =
+            run_reactor_path<simplenet::epoll::ready_event>(reactor, iterations);
         if (reuse.total_ms <= 0.0) {
             std::cerr << "benchmark failed\n";
             return 1;
@@ -190,9 +197,24 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    if (mode == bench_mode::direct_only) {
+        const auto direct = run_reactor_path<::epoll_event>(reactor, iterations);
+        if (direct.total_ms <= 0.0) {
+            std::cerr << "benchmark failed\n";
+            return 1;
+        }
+        std::cout << "direct_path," << iterations << "," << direct.total_ms
+                  << "," << direct.avg_ns_per_wait << ","
+                  << direct.waits_per_sec << "\n";
+        return 0;
+    }
+
     const auto alloc = run_alloc_baseline(reactor.native_handle(), iterations);
-    const auto reuse = run_reuse_path(reactor, iterations);
-    if (reuse.total_ms <= 0.0 || alloc.total_ms <= 0.0) {
+    const auto reuse =
+        run_reactor_path<simplenet::epoll::ready_event>(reactor, iterations);
+    const auto direct = run_reactor_path<::epoll_event>(reactor, iterations);
+    if (reuse.total_ms <= 0.0 || alloc.total_ms <= 0.0 ||
+        direct.total_ms <= 0.0) {
         std::cerr << "benchmark failed\n";
         return 1;
     }
@@ -201,6 +223,8 @@ int main(int argc, char** argv) {
               << alloc.avg_ns_per_wait << "," << alloc.waits_per_sec << "\n";
     std::cout << "reuse_path," << iterations << "," << reuse.total_ms << ","
               << reuse.avg_ns_per_wait << "," << reuse.waits_per_sec << "\n";
+    std::cout << "direct_path," << iterations << "," << direct.total_ms << ","
+              << direct.avg_ns_per_wait << "," << direct.waits_per_sec << "\n";
     std::cout << "speedup_x," << speedup << "\n";
     return 0;
 }
@@ -0,0 +1,353 @@
+#include "simplenet/simplenet.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+// Isolated costs of the runtime's own machinery. Every case prints one
+// `PERF,impl=libsimplenet,scenario=runtime_micro,case=...` line whose
+// `ns_per_op` is the figure to track.
+namespace {
+
+using steady = std::chrono::steady_clock;
+using simplenet::runtime::task;
+
+struct options {
+    std::size_t iterations{200000};
+    /// Entries kept scheduled in the wheel while `timer_insert_cancel` runs.
+    std::size_t resident_timers{100000};
+    std::string only{};
+    simplenet::runtime::engine::backend backend{
+        simplenet::runtime::engine::backend::epoll};
+};
+
+struct measurement {
+    std::size_t ops{0};
+    steady::duration elapsed{};
+    bool ok{false};
+};
+
+/// Defeats dead-code elimination of benchmark results.
+volatile std::uint64_t g_sink = 0;
+
+bool parse_positive_size(const char* text, std::size_t& value) {
+    if (text == nullptr || *text == '\0') {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || parsed == 0) {
+        return false;
+    }
+    if (parsed > static_cast<unsigned long long>(std::numeric_limits<std::size_t>::max())) {
+        return false;
+    }
+
+    value = static_cast<std::size_t>(parsed);
+    return true;
+}
+
+const char* backend_name(simplenet::runtime::engine::backend backend) {
+    if (backend == simplenet::runtime::engine::backend::io_uring) {
+        return "io_uring";
+    }
+    return "epoll";
+}
+
+/// Run `root` to completion on a fresh engine.
+bool run_on_loop(simplenet::runtime::engine::backend backend, task<void> root) {
+    simplenet::runtime::engine loop{backend};
+    if (!loop.valid()) {
+        return false;
+    }
+    loop.spawn(std::move(root));
+    return loop.run().has_value();
+}
+
+task<std::uint64_t> leaf(std::uint64_t value) {
+    co_return value + 1U;
+}
+
+task<std::uint64_t> chain(std::size_t depth, std::uint64_t value) {
+    if (depth == 0U) {
+        co_return co_await leaf(value);
+    }
+    co_return co_await chain(depth - 1U, value) + 1U;
+}
+
+/// Create one child task and `co_await` it to completion.
+task<void> task_await_loop(std::size_t iterations, measurement& out) {
+    std::uint64_t total = 0;
+    const auto start = steady::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        total += co_await leaf(i);
+    }
+    out.elapsed = steady::now() - start;
+    out.ops = iterations;
+    out.ok = true;
+    g_sink = total;
+}
+
+/// Eight nested `chain` frames plus a leaf per iteration; an op is one frame.
+task<void> task_chain_loop(std::size_t iterations, measurement& out) {
+    constexpr std::size_t kDepth = 8;
+    std::uint64_t total = 0;
+    const auto start = steady::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        total += co_await chain(kDepth - 1U, i);
+    }
+    out.elapsed = steady::now() - start;
+    out.ops = iterations * (kDepth + 1U);
+    out.ok = true;
+    g_sink = total;
+}
+
+/// `yield()` is one `schedule()` plus one resume from the ready queue.
+task<void> schedule_resume_loop(std::size_t iterations, measurement& out) {
+    const auto start = steady::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        co_await simplenet::runtime::yield();
+    }
+    out.elapsed = steady::now() - start;
+    out.ops = iterations;
+    out.ok = true;
+}
+
+/// Make the peer readable, wait for it, consume the byte.
+task<void> wait_readable_loop(std::size_t iterations, measurement& out) {
+    auto made = simplenet::nonblocking::local_stream::pair();
+    if (!made.has_value()) {
+        co_return;
+    }
+    auto& [writer, reader] = made.value();
+    const std::byte token{0x2a};
+    std::byte received{};
+    const auto start = steady::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        if (!writer.write_some(std::span{&token, 1}).has_value()) {
+            co_return;
+        }
+        if (!(co_await simplenet::runtime::wait_readable(reader.native_handle()))
+                 .has_value() ||
+            !reader.read_some(std::span{&received, 1}).has_value()) {
+            co_return;
+        }
+    }
+    out.elapsed = steady::now() - start;
+    out.ops = iterations;
+    out.ok = true;
+}
+
+/// Small messages: enqueue a batch, flush it, drain the peer.
+task<void> writer_enqueue_flush_loop(std::size_t iterations, measurement& out) {
+    constexpr std::size_t kBatch = 16;
+    constexpr std::size_t kMessage = 32;
+    auto made = simplenet::nonblocking::local_stream::pair();
+    if (!made.has_value()) {
+        co_return;
+    }
+    simplenet::runtime::queued_writer writer{std::move(made.value().first)};
+    auto& peer = made.value().second;
+    const std::array<std::byte, kMessage> message{};
+    std::array<std::byte, kBatch * kMessage> drained{};
+
+    const std::size_t batches = (iterations + kBatch - 1U) / kBatch;
+    const auto start = steady::now();
+    for (std::size_t batch = 0; batch < batches; ++batch) {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            if (!writer.enqueue(message).has_value()) {
+                co_return;
+            }
+        }
+        if (!(co_await writer.flush(std::chrono::seconds{1})).has_value()) {
+            co_return;
+        }
+        std::size_t pending = drained.size();
+        while (pending > 0U) {
+            const auto read = peer.read_some(std::span{drained.data(), pending});
+            if (!read.has_value() || read.value() == 0U) {
+                co_return;
+            }
+            pending -= read.value();
+        }
+    }
+    out.elapsed = steady::now() - start;
+    out.ops = batches * kBatch;
+    out.ok = true;
+}
+
+/// Insert plus cancel one entry next to `resident` scheduled ones; the
+/// deadlines are spread over all wheel levels.
+measurement timer_insert_cancel(std::size_t iterations, std::size_t resident) {
+    const auto epoch = steady::now();
+    simplenet::runtime::timer_wheel wheel{epoch};
+    auto entries = std::make_unique<simplenet::runtime::timer_entry[]>(resident);
+    for (std::size_t i = 0; i < resident; ++i) {
+        wheel.schedule(entries[i], epoch + std::chrono::milliseconds{(i * 7919U) % 36'000'000U});
+    }
+
+    simplenet::runtime::timer_entry probe;
+    measurement out{};
+    const auto start = steady::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        wheel.schedule(probe, epoch + std::chrono::milliseconds{(i * 104729U) % 36'000'000U});
+        wheel.cancel(probe);
+    }
+    out.elapsed = steady::now() - start;
+    out.ops = iterations;
+    out.ok = true;
+
+    for (std::size_t i = 0; i < resident; ++i) {
+        wheel.cancel(entries[i]);
+    }
+    return out;
+}
+
+/// Source creation, one token copy, destruction.
+measurement cancel_source_create(std::size_t iterations) {
+    measurement out{};
+    std::uint64_t possible = 0;
+    const auto start = steady::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        const simplenet::runtime::cancel_source source;
+        const auto token = source.token();
+        possible += token.stop_possible() ? 1U : 0U;
+    }
+    out.elapsed = steady::now() - start;
+    out.ops = iterations;
+    out.ok = true;
+    g_sink = possible;
+    return out;
+}
+
+bool parse_args(int argc, char** argv, options& out) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--iterations") {
+            if (!parse_positive_size(value, out.iterations)) {
+                return false;
+            }
+        } else if (arg == "--resident-timers") {
+            if (!parse_positive_size(value, out.resident_timers)) {
+                return false;
+            }
+        } else if (arg == "--case") {
+            out.only = value;
+        } else if (arg == "--backend") {
+            const std::string_view name{value};
+            if (name == "epoll") {
+                out.backend = simplenet::runtime::engine::backend::epoll;
+            } else if (name == "io_uring") {
+                out.backend = simplenet::runtime::engine::backend::io_uring;
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr std::array<std::string_view, 7> kCases{
+    "task_await",          "task_chain",      "schedule_resume",
+    "wait_readable",       "writer_enqueue_flush", "timer_insert_cancel",
+    "cancel_source_create"};
+
+void print_usage() {
+    std::cerr << "usage: simplenet_perf_runtime_micro [--iterations N] "
+                 "[--resident-timers N] [--backend epoll|io_uring] [--case ";
+    for (std::size_t i = 0; i < kCases.size(); ++i) {
+        std::cerr << (i == 0U ? "" : "|") << kCases[i];
+    }
+    std::cerr << "]\n";
+}
+
+std::optional<measurement> run_case(std::string_view name, const options& opts) {
+    measurement out{};
+    bool ran = true;
+    if (name == "task_await") {
+        ran = run_on_loop(opts.backend, task_await_loop(opts.iterations, out));
+    } else if (name == "task_chain") {
+        ran = run_on_loop(opts.backend, task_chain_loop(opts.iterations, out));
+    } else if (name == "schedule_resume") {
+        ran = run_on_loop(opts.backend, schedule_resume_loop(opts.iterations, out));
+    } else if (name == "wait_readable") {
+        ran = run_on_loop(opts.backend, wait_readable_loop(opts.iterations, out));
+    } else if (name == "writer_enqueue_flush") {
+        ran = run_on_loop(opts.backend, writer_enqueue_flush_loop(opts.iterations, out));
+    } else if (name == "timer_insert_cancel") {
+        out = timer_insert_cancel(opts.iterations, opts.resident_timers);
+    } else if (name == "cancel_source_create") {
+        out = cancel_source_create(opts.iterations);
+    } else {
+        return std::nullopt;
+    }
+    if (!ran) {
+        out.ok = false;
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts{};
+    if (!parse_args(argc, argv, opts)) {
+        print_usage();
+        return 2;
+    }
+    {
+        simplenet::runtime::engine probe{opts.backend};
+        if (!probe.valid()) {
+            std::cerr << "backend unavailable: " << backend_name(opts.backend) << "\n";
+            return 3;
+        }
+    }
+
+    bool matched = false;
+    for (const auto name : kCases) {
+        if (!opts.only.empty() && opts.only != name) {
+            continue;
+        }
+        matched = true;
+        const auto result = run_case(name, opts);
+        if (!result.has_value() || !result->ok || result->ops == 0U) {
+            std::cerr << "benchmark failed: " << name << "\n";
+            return 1;
+        }
+        const double total_s = std::chrono::duration<double>(result->elapsed).count();
+        const double ops = static_cast<double>(result->ops);
+        std::cout << std::fixed << std::setprecision(3)
+                  << "PERF,impl=libsimplenet,scenario=runtime_micro,case=" << name
+                  << ",backend=" << backend_name(opts.backend)
+                  << ",iterations=" << opts.iterations << ",ops=" << result->ops
+                  << ",total_ms=" << total_s * 1000.0
+                  << ",ns_per_op=" << total_s * 1e9 / ops
+                  << ",ops_per_sec=" << ops / total_s << "\n";
+    }
+    if (!matched) {
+        print_usage();
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,568 @@
+#include "simplenet/simplenet.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// One matrix cell of the scalability sweep: `idle` connections park on a
+// read while `active` connections drive closed-loop echo traffic, on
+// `threads` server loops. The loops are measured from the inside (thread
+// CPU clock) so client cost does not leak into the per-request figure.
+namespace {
+
+using steady = std::chrono::steady_clock;
+
+struct options {
+    std::size_t idle_connections{1000};
+    std::size_t active_connections{64};
+    std::size_t threads{1};
+    std::size_t client_threads{1};
+    std::size_t payload_size{64};
+    std::size_t duration_ms{2000};
+    std::size_t warmup_ms{200};
+    /// `0` parks sessions on plain reads; otherwise reads re-arm a timeout.
+    std::size_t read_timeout_ms{0};
+    simplenet::runtime::engine::backend backend{
+        simplenet::runtime::engine::backend::epoll};
+    std::uint32_t uring_queue_depth{512};
+};
+
+/// Loopback ports per source address before moving to the next one.
+constexpr std::size_t kConnectionsPerSource = 16384;
+
+bool parse_size(const char* text, std::size_t& value, bool allow_zero) {
+    if (text == nullptr || *text == '\0') {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || (parsed == 0 && !allow_zero)) {
+        return false;
+    }
+    if (parsed > static_cast<unsigned long long>(std::numeric_limits<std::size_t>::max())) {
+        return false;
+    }
+
+    value = static_cast<std::size_t>(parsed);
+    return true;
+}
+
+const char* backend_name(simplenet::runtime::engine::backend backend) {
+    if (backend == simplenet::runtime::engine::backend::io_uring) {
+        return "io_uring";
+    }
+    return "epoll";
+}
+
+bool parse_args(int argc, char** argv, options& out) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{argv[i]};
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (arg == "--idle-connections") {
+            ok = parse_size(value, out.idle_connections, true);
+        } else if (arg == "--active-connections") {
+            ok = parse_size(value, out.active_connections, false);
+        } else if (arg == "--threads") {
+            ok = parse_size(value, out.threads, false);
+        } else if (arg == "--client-threads") {
+            ok = parse_size(value, out.client_threads, false);
+        } else if (arg == "--payload-size") {
+            ok = parse_size(value, out.payload_size, false);
+        } else if (arg == "--duration-ms") {
+            ok = parse_size(value, out.duration_ms, false);
+        } else if (arg == "--warmup-ms") {
+            ok = parse_size(value, out.warmup_ms, true);
+        } else if (arg == "--read-timeout-ms") {
+            ok = parse_size(value, out.read_timeout_ms, true);
+        } else if (arg == "--backend") {
+            const std::string_view name{value};
+            if (name == "epoll") {
+                out.backend = simplenet::runtime::engine::backend::epoll;
+            } else if (name == "io_uring") {
+                out.backend = simplenet::runtime::engine::backend::io_uring;
+            } else {
+                ok = false;
+            }
+        } else if (arg == "--uring-queue-depth") {
+            std::size_t depth = 0;
+            ok = parse_size(value, depth, false) && depth <= UINT32_MAX;
+            out.uring_queue_depth = static_cast<std::uint32_t>(depth);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_usage() {
+    std::cerr << "usage: simplenet_perf_scalability_libsimplenet "
+                 "[--idle-connections N] [--active-connections N] [--threads N] "
+                 "[--client-threads N] [--payload-size N] [--duration-ms N] "
+                 "[--warmup-ms N] [--read-timeout-ms N] "
+                 "[--backend epoll|io_uring] [--uring-queue-depth N]\n";
+}
+
+/// Two descriptors per connection; lift the soft limit as far as allowed.
+void raise_descriptor_limit() {
+    ::rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        (void)::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+std::size_t resident_bytes() {
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+        return 0;
+    }
+    unsigned long long total_pages = 0;
+    unsigned long long resident_pages = 0;
+    const int fields = std::fscanf(statm, "%llu %llu", &total_pages, &resident_pages);
+    std::fclose(statm);
+    if (fields != 2) {
+        return 0;
+    }
+    return static_cast<std::size_t>(resident_pages) *
+           static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+std::chrono::nanoseconds thread_cpu_time() {
+    timespec now{};
+    (void)::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return std::chrono::seconds{now.tv_sec} + std::chrono::nanoseconds{now.tv_nsec};
+}
+
+std::string errno_text(const char* what, int error_number) {
+    return std::string{what} + ": " +
+           std::error_code(error_number, std::generic_category()).message();
+}
+
+/**
+ * Connect from `127.0.0.(1 + index / kConnectionsPerSource)` so large sweeps
+ * are not capped by one source address's ephemeral port range.
+ */
+bool connect_loopback(std::uint16_t port, std::size_t index, int& out,
+                      std::string& error) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = errno_text("client socket failed", errno);
+        return false;
+    }
+
+    const int enabled = 1;
+    sockaddr_in source{};
+    source.sin_family = AF_INET;
+    source.sin_addr.s_addr = htonl(static_cast<std::uint32_t>(
+        INADDR_LOOPBACK + index / kConnectionsPerSource));
+    // Defer the port choice to connect(), where it only has to be unique
+    // per destination.
+    (void)::setsockopt(fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &enabled,
+                       sizeof(enabled));
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(port);
+    destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int rc = ::bind(fd, reinterpret_cast<const sockaddr*>(&source), sizeof(source));
+    if (rc == 0) {
+        do {
+            rc = ::connect(fd, reinterpret_cast<const sockaddr*>(&destination),
+                           sizeof(destination));
+        } while (rc != 0 && errno == EINTR);
+    }
+    if (rc != 0 ||
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled)) != 0 ||
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+        error = errno_text("client connect failed", errno);
+        static_cast<void>(::close(fd));
+        return false;
+    }
+    out = fd;
+    return true;
+}
+
+struct server_state {
+    std::atomic<std::size_t> accepted{0};
+    std::atomic_bool failed{false};
+};
+
+/// Echo until EOF; idle sessions spend the whole run parked in the read.
+simplenet::runtime::task<void> run_echo_session(
+    simplenet::nonblocking::tcp_stream stream, std::size_t buffer_size,
+    std::chrono::milliseconds read_timeout, server_state& state) {
+    std::vector<std::byte> buffer(buffer_size);
+    while (true) {
+        auto read = read_timeout.count() > 0
+                        ? co_await simplenet::runtime::async_read_some_with_timeout(
+                              stream, buffer, read_timeout)
+                        : co_await simplenet::runtime::async_read_some(stream, buffer);
+        if (!read.has_value()) {
+            if (read.error().value() == ETIMEDOUT) {
+                continue;
+            }
+            state.failed.store(true, std::memory_order_release);
+            co_return;
+        }
+        if (read.value() == 0U) {
+            co_return;
+        }
+        auto written = co_await simplenet::runtime::async_write_all(
+            stream, std::span<const std::byte>{buffer.data(), read.value()});
+        if (!written.has_value()) {
+            state.failed.store(true, std::memory_order_release);
+            co_return;
+        }
+    }
+}
+
+simplenet::runtime::task<void>
+run_accept_loop(simplenet::runtime::engine& loop,
+                simplenet::nonblocking::tcp_listener& listener,
+                const options& opts, server_state& state) {
+    const std::size_t buffer_size = std::min<std::size_t>(opts.payload_size, 65536);
+    const std::chrono::milliseconds read_timeout{opts.read_timeout_ms};
+    while (true) {
+        auto accepted = co_await simplenet::runtime::async_accept(listener);
+        if (!accepted.has_value()) {
+            state.failed.store(true, std::memory_order_release);
+            co_return;
+        }
+        loop.spawn_detached(run_echo_session(std::move(accepted.value()),
+                                             buffer_size, read_timeout, state));
+        state.accepted.fetch_add(1, std::memory_order_release);
+    }
+}
+
+/// Closed-loop echo client: each connection keeps one request in flight.
+struct active_connection {
+    int fd{-1};
+    std::size_t written{0};
+    std::size_t received{0};
+};
+
+struct client_shard {
+    std::vector<active_connection> connections{};
+    std::atomic<std::uint64_t> completed{0};
+    std::string error{};
+};
+
+/// Write then read as far as the socket allows; returns `false` on error.
+bool pump(active_connection& connection, std::span<const std::byte> payload,
+          std::span<std::byte> scratch, std::atomic<std::uint64_t>& completed) {
+    while (true) {
+        while (connection.written < payload.size()) {
+            const ssize_t sent = ::send(connection.fd, payload.data() + connection.written,
+                                        payload.size() - connection.written, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EINTR) {
+                    break;
+                }
+                return false;
+            }
+            connection.written += static_cast<std::size_t>(sent);
+        }
+        while (connection.received < payload.size()) {
+            const ssize_t got = ::recv(connection.fd, scratch.data(),
+                                       std::min(scratch.size(),
+                                                payload.size() - connection.received),
+                                       0);
+            if (got < 0) {
+                if (errno == EAGAIN || errno == EINTR) {
+                    return true;
+                }
+                return false;
+            }
+            if (got == 0) {
+                errno = ECONNRESET;
+                return false;
+            }
+            connection.received += static_cast<std::size_t>(got);
+        }
+        if (connection.written < payload.size()) {
+            return true;
+        }
+        completed.fetch_add(1, std::memory_order_relaxed);
+        connection.written = 0;
+        connection.received = 0;
+    }
+}
+
+void run_client_shard(client_shard& shard, std::size_t payload_size,
+                      const std::atomic_bool& stop) {
+    const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        shard.error = errno_text("client epoll_create1 failed", errno);
+        return;
+    }
+    const std::vector<std::byte> payload(payload_size, std::byte{0x5a});
+    std::vector<std::byte> scratch(std::min<std::size_t>(payload_size, 65536));
+    for (auto& connection : shard.connections) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        event.data.ptr = &connection;
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection.fd, &event) != 0) {
+            shard.error = errno_text("client epoll_ctl failed", errno);
+            static_cast<void>(::close(epoll_fd));
+            return;
+        }
+    }
+
+    std::vector<epoll_event> events(std::max<std::size_t>(shard.connections.size(), 1));
+    while (!stop.load(std::memory_order_acquire)) {
+        const int ready = ::epoll_wait(epoll_fd, events.data(),
+                                       static_cast<int>(events.size()), 10);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            shard.error = errno_text("client epoll_wait failed", errno);
+            break;
+        }
+        for (int index = 0; index < ready; ++index) {
+            auto& connection =
+                *static_cast<active_connection*>(events[static_cast<std::size_t>(index)].data.ptr);
+            if (!pump(connection, payload, scratch, shard.completed)) {
+                shard.error = errno_text("client echo failed", errno);
+                static_cast<void>(::close(epoll_fd));
+                return;
+            }
+        }
+    }
+    static_cast<void>(::close(epoll_fd));
+}
+
+/// Sum of every loop thread's CPU clock, sampled on the loops themselves.
+std::optional<std::chrono::nanoseconds>
+sample_loop_cpu(simplenet::runtime::loop_pool& pool) {
+    std::vector<std::chrono::nanoseconds> samples(pool.size());
+    std::atomic<std::size_t> pending{pool.size()};
+    for (std::size_t index = 0; index < pool.size(); ++index) {
+        auto* slot = &samples[index];
+        auto* counter = &pending;
+        auto posted = pool.post(index, [slot, counter]() noexcept {
+            *slot = thread_cpu_time();
+            counter->fetch_sub(1, std::memory_order_release);
+        });
+        if (!posted.has_value()) {
+            return std::nullopt;
+        }
+    }
+    const auto give_up = steady::now() + std::chrono::seconds{5};
+    while (pending.load(std::memory_order_acquire) != 0U) {
+        if (steady::now() > give_up) {
+            return std::nullopt;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+    }
+    std::chrono::nanoseconds total{0};
+    for (const auto sample : samples) {
+        total += sample;
+    }
+    return total;
+}
+
+bool wait_for_accepts(const server_state& state, std::size_t expected) {
+    const auto give_up = steady::now() + std::chrono::seconds{60};
+    while (state.accepted.load(std::memory_order_acquire) < expected) {
+        if (state.failed.load(std::memory_order_acquire) || steady::now() > give_up) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
+
+/// Closes client descriptors on every exit path.
+struct fd_list {
+    std::vector<int> fds{};
+    ~fd_list() {
+        for (const int fd : fds) {
+            static_cast<void>(::close(fd));
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts{};
+    if (!parse_args(argc, argv, opts)) {
+        print_usage();
+        return 2;
+    }
+    raise_descriptor_limit();
+
+    simplenet::runtime::loop_pool pool{simplenet::runtime::loop_pool_options{
+        .selected_backend = opts.backend,
+        .threads = opts.threads,
+        .uring_queue_depth = opts.uring_queue_depth}};
+    if (!pool.valid()) {
+        std::cerr << "backend unavailable: " << backend_name(opts.backend) << "\n";
+        return 3;
+    }
+
+    auto listeners_result =
+        pool.listen_sharded(simplenet::nonblocking::endpoint::loopback(0));
+    if (!listeners_result.has_value()) {
+        std::cerr << "bind failed: " << listeners_result.error().message() << "\n";
+        return 1;
+    }
+    auto listeners = std::move(listeners_result.value());
+    const auto port = listeners.front().local_port();
+    if (!port.has_value()) {
+        std::cerr << "local_port failed: " << port.error().message() << "\n";
+        return 1;
+    }
+
+    server_state state{};
+    pool.spawn_each([&](std::size_t index) {
+        return run_accept_loop(pool.loop(index), listeners[index], opts, state);
+    });
+    std::optional<simplenet::result<void>> run_status;
+    std::thread pool_thread([&]() { run_status = pool.run(); });
+
+    std::string failure;
+    fd_list client_fds{};
+    const std::size_t total = opts.idle_connections + opts.active_connections;
+    client_fds.fds.reserve(total);
+
+    // Let the loops settle so their own footprint is in the baseline.
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    const std::size_t rss_before = resident_bytes();
+    for (std::size_t index = 0; index < total && failure.empty(); ++index) {
+        int fd = -1;
+        if (connect_loopback(port.value(), index, fd, failure)) {
+            client_fds.fds.push_back(fd);
+        } else {
+            failure += " after " + std::to_string(index) + " connections";
+        }
+    }
+    if (failure.empty() && !wait_for_accepts(state, total)) {
+        failure = "server did not accept every connection";
+    }
+    const std::size_t rss_after = resident_bytes();
+
+    std::vector<client_shard> shards(std::min(opts.client_threads, opts.active_connections));
+    if (failure.empty()) {
+        for (std::size_t index = 0; index < opts.active_connections; ++index) {
+            shards[index % shards.size()].connections.push_back(
+                active_connection{.fd = client_fds.fds[opts.idle_connections + index]});
+        }
+    }
+
+    std::atomic_bool stop_clients{false};
+    std::vector<std::thread> clients;
+    std::uint64_t requests = 0;
+    double elapsed_s = 0.0;
+    std::chrono::nanoseconds loop_cpu{0};
+    if (failure.empty()) {
+        for (auto& shard : shards) {
+            clients.emplace_back(run_client_shard, std::ref(shard), opts.payload_size,
+                                 std::cref(stop_clients));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{opts.warmup_ms});
+
+        const auto cpu_start = sample_loop_cpu(pool);
+        std::uint64_t completed_start = 0;
+        for (const auto& shard : shards) {
+            completed_start += shard.completed.load(std::memory_order_relaxed);
+        }
+        const auto wall_start = steady::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds{opts.duration_ms});
+        const auto cpu_end = sample_loop_cpu(pool);
+        std::uint64_t completed_end = 0;
+        for (const auto& shard : shards) {
+            completed_end += shard.completed.load(std::memory_order_relaxed);
+        }
+        elapsed_s = std::chrono::duration<double>(steady::now() - wall_start).count();
+
+        requests = completed_end - completed_start;
+        if (!cpu_start.has_value() || !cpu_end.has_value()) {
+            failure = "loop CPU sample timed out";
+        } else {
+            loop_cpu = *cpu_end - *cpu_start;
+        }
+
+        stop_clients.store(true, std::memory_order_release);
+        for (auto& client : clients) {
+            client.join();
+        }
+        for (const auto& shard : shards) {
+            if (failure.empty() && !shard.error.empty()) {
+                failure = shard.error;
+            }
+        }
+    }
+
+    pool.stop();
+    pool_thread.join();
+
+    if (failure.empty() && state.failed.load(std::memory_order_acquire)) {
+        failure = "server error";
+    }
+    if (failure.empty() && run_status.has_value() && !run_status->has_value()) {
+        failure = "runtime error: " + run_status->error().message();
+    }
+    if (failure.empty() && requests == 0U) {
+        failure = "no requests completed";
+    }
+    if (!failure.empty()) {
+        std::cerr << "benchmark failed: " << failure << "\n";
+        return 1;
+    }
+
+    const double held = rss_after > rss_before
+                            ? static_cast<double>(rss_after - rss_before)
+                            : 0.0;
+    const double loop_cpu_s = std::chrono::duration<double>(loop_cpu).count();
+    std::cout << std::fixed << std::setprecision(3)
+              << "PERF,impl=libsimplenet,scenario=scalability,backend="
+              << backend_name(opts.backend) << ",threads=" << pool.size()
+              << ",idle_connections=" << opts.idle_connections
+              << ",active_connections=" << opts.active_connections
+              << ",payload_size=" << opts.payload_size
+              << ",duration_ms=" << opts.duration_ms
+              << ",read_timeout_ms=" << opts.read_timeout_ms
+              << ",requests=" << requests
+              << ",throughput_rps=" << static_cast<double>(requests) / elapsed_s
+              << ",rss_bytes_per_connection=" << held / static_cast<double>(total)
+              << ",loop_cpu_us_per_request="
+              << loop_cpu_s * 1e6 / static_cast<double>(requests)
+              << ",loop_cpu_utilization="
+              << loop_cpu_s / (elapsed_s * static_cast<double>(pool.size())) << "\n";
+    return 0;
+}
@@ -2,19 +2,23 @@
 
 /**
  * @file
- * @brief Endpoint primitives for host/port socket addressing.
+ * @brief Endpoint primitives for host/port socket addressing, textual and
+ * binary.
  */
 
+#include "simplenet/core/result.hpp"
+
 #include <cstdint>
 #include <string>
+#include <sys/socket.h>
 
 namespace simplenet::blocking {
 
 /**
- * @brief IPv4 endpoint represented as textual host and TCP/UDP port.
+ * @brief IPv4 or IPv6 endpoint represented as textual host and TCP/UDP port.
  */
 struct endpoint {
-    /// Hostname or IPv4 literal.
+    /// Hostname, or IPv4/IPv6 literal (IPv6 without brackets).
     std::string host;
     /// Network port in host byte order.
     std::uint16_t port{};
@@ -31,4 +35,53 @@ struct endpoint {
     [[nodiscard]] static endpoint any(std::uint16_t port);
 };
 
+/**
+ * @brief IPv4 or IPv6 address and port in the binary form the kernel uses.
+ *
+ * Connect, bind, accept and receive paths pass it straight to the socket
+ * calls, so no host string is parsed or formatted per operation;
+ * `from_endpoint()` and `to_endpoint()` convert at the edges.
+ */
+struct socket_address {
+    /// Raw address; `length` bytes of it are meaningful.
+    ::sockaddr_storage storage{};
+    /// Address length in bytes, `0` when unset.
+    ::socklen_t length{0};
+
+    /**
+     * @brief Build an address from an IPv4 or IPv6 literal endpoint.
+     * @return `EINVAL` when `ep.host` is neither literal.
+     */
+    [[nodiscard]] static result<socket_address>
+    from_endpoint(const endpoint& ep) noexcept;
+    /**
+     * @brief Copy a kernel-provided address.
+     * @return `EINVAL` when `length` exceeds `sockaddr_storage`.
+     */
+    [[nodiscard]] static result<socket_address>
+    from_native(const ::sockaddr *address, ::socklen_t length) noexcept;
+    /// @return `127.0.0.1:port`.
+    [[nodiscard]] static socket_address loopback(std::uint16_t port) noexcept;
+    /// @return `[::1]:port`.
+    [[nodiscard]] static socket_address
+    ipv6_loopback(std::uint16_t port) noexcept;
+    /// @return `0.0.0.0:port`.
+    [[nodiscard]] static socket_address any(std::uint16_t port) noexcept;
+    /// @return `[::]:port`, dual-stack when `IPV6_V6ONLY` is off.
+    [[nodiscard]] static socket_address ipv6_any(std::uint16_t port) noexcept;
+
+    /// @return Textual host (without brackets) and port.
+    [[nodiscard]] result<endpoint> to_endpoint() const noexcept;
+    /// @return `AF_INET`, `AF_INET6`, or `AF_UNSPEC` when unset.
+    [[nodiscard]] int family() const noexcept;
+    /// @return Port in host byte order, `0` for non-IP families.
+    [[nodiscard]] std::uint16_t port() const noexcept;
+    /// @return Address as `sockaddr *` for socket calls.
+    [[nodiscard]] const ::sockaddr *data() const noexcept;
+
+    /// @brief Byte-wise comparison of the meaningful prefix.
+    friend bool operator==(const socket_address& lhs,
+                           const socket_address& rhs) noexcept;
+};
+
 } // namespace simplenet::blocking
@@ -9,9 +9,11 @@
 #include "simplenet/core/result.hpp"
 #include "simplenet/core/unique_fd.hpp"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <sys/uio.h>
 
 namespace simplenet::blocking {
 
@@ -51,6 +53,23 @@ public:
      */
     [[nodiscard]] result<std::size_t>
     write_some(std::span<const std::byte> buffer) noexcept;
+    /**
+     * @brief `read_some()` that gives up after `timeout`.
+     *
+     * Tries the read first and only `poll()`s when nothing is queued, so
+     * ready data costs one syscall; socket options are left alone.
+     * @return `ETIMEDOUT` when nothing arrived in time.
+     */
+    [[nodiscard]] result<std::size_t>
+    read_some(std::span<std::byte> buffer,
+              std::chrono::milliseconds timeout) noexcept;
+    /**
+     * @brief `write_some()` that gives up after `timeout`.
+     * @return `ETIMEDOUT` when the send buffer stayed full.
+     */
+    [[nodiscard]] result<std::size_t>
+    write_some(std::span<const std::byte> buffer,
+               std::chrono::milliseconds timeout) noexcept;
     /// @brief Shutdown the write half of the connection.
     [[nodiscard]] result<void> shutdown_write() noexcept;
 
@@ -116,5 +135,43 @@ write_all(tcp_stream& stream, std::span<const std::byte> buffer) noexcept;
  */
 [[nodiscard]] result<void> read_exact(tcp_stream& stream,
                                       std::span<std::byte> buffer) noexcept;
+/**
+ * @brief `write_all()` bounded by one deadline `timeout` from now.
+ * @return `ETIMEDOUT` when the bytes did not all leave in time; a prefix
+ *         may have been sent.
+ */
+[[nodiscard]] result<void> write_all(tcp_stream& stream,
+                                     std::span<const std::byte> buffer,
+                                     std::chrono::milliseconds timeout) noexcept;
+/**
+ * @brief `read_exact()` bounded by one deadline `timeout` from now.
+ * @return `ETIMEDOUT` when the buffer did not fill in time.
+ */
+[[nodiscard]] result<void> read_exact(tcp_stream& stream,
+                                      std::span<std::byte> buffer,
+                                      std::chrono::milliseconds timeout) noexcept;
+/**
+ * @brief Send every byte of `buffers` in order with `sendmsg`.
+ *
+ * Each call gathers up to 64 buffers, and partial sends resume mid-buffer,
+ * so one syscall usually carries a whole header-plus-body message.
+ * @param buffers Regions to send; left unmodified.
+ */
+[[nodiscard]] result<void> writev_all(tcp_stream& stream,
+                                      std::span<const ::iovec> buffers) noexcept;
+/**
+ * @brief Fill every byte of `buffers` in order with `recvmsg`.
+ * @return `ECONNRESET` when the peer closes first.
+ */
+[[nodiscard]] result<void> readv_exact(tcp_stream& stream,
+                                       std::span<const ::iovec> buffers) noexcept;
+/// @brief `writev_all()` bounded by one deadline `timeout` from now.
+[[nodiscard]] result<void> writev_all(tcp_stream& stream,
+                                      std::span<const ::iovec> buffers,
+                                      std::chrono::milliseconds timeout) noexcept;
+/// @brief `readv_exact()` bounded by one deadline `timeout` from now.
+[[nodiscard]] result<void> readv_exact(tcp_stream& stream,
+                                       std::span<const ::iovec> buffers,
+                                       std::chrono::milliseconds timeout) noexcept;
 
 } // namespace simplenet::blocking
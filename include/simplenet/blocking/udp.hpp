@@ -9,6 +9,7 @@
 #include "simplenet/core/result.hpp"
 #include "simplenet/core/unique_fd.hpp"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <span>
@@ -25,6 +26,35 @@ struct received_datagram {
     endpoint from{};
 };
 
+/**
+ * @brief One slot of a batched receive.
+ *
+ * The caller provides `buffer`; a receive fills the remaining fields.
+ */
+struct udp_message {
+    /// Destination bytes.
+    std::span<std::byte> buffer{};
+    /// Bytes received.
+    std::size_t size{0};
+    /// Sender address.
+    socket_address from{};
+    /// `true` when the datagram was longer than `buffer`.
+    bool truncated{false};
+};
+
+/**
+ * @brief One datagram of a batched send.
+ */
+struct udp_outgoing {
+    /// Datagram payload.
+    std::span<const std::byte> payload{};
+    /// Destination address.
+    socket_address to{};
+};
+
+/// Largest batch one `recv_batch()`/`send_batch()` call hands the kernel.
+inline constexpr std::size_t udp_batch_limit = 1024;
+
 /**
  * @brief Blocking UDP datagram socket.
  */
@@ -60,6 +90,39 @@ public:
      */
     [[nodiscard]] result<received_datagram>
     recv_from(std::span<std::byte> buffer) noexcept;
+    /**
+     * @brief `recv_from()` that gives up after `timeout`.
+     *
+     * Polls only when nothing is queued; `SO_RCVTIMEO` is left alone.
+     * @return `ETIMEDOUT` when no datagram arrived in time.
+     */
+    [[nodiscard]] result<received_datagram>
+    recv_from(std::span<std::byte> buffer,
+              std::chrono::milliseconds timeout) noexcept;
+    /**
+     * @brief Block until at least one datagram arrives, then take every
+     *        queued one that fits `messages` with one `recvmmsg`.
+     *
+     * At most `udp_batch_limit` slots are used per call.
+     * @return Number of slots filled, at least one.
+     */
+    [[nodiscard]] result<std::size_t>
+    recv_batch(std::span<udp_message> messages) noexcept;
+    /**
+     * @brief `recv_batch()` that gives up after `timeout`.
+     * @return `ETIMEDOUT` when no datagram arrived in time.
+     */
+    [[nodiscard]] result<std::size_t>
+    recv_batch(std::span<udp_message> messages,
+               std::chrono::milliseconds timeout) noexcept;
+    /**
+     * @brief Send `datagrams` in order with one `sendmmsg`.
+     *
+     * At most `udp_batch_limit` datagrams are passed per call.
+     * @return Number of datagrams sent; may be fewer than given.
+     */
+    [[nodiscard]] result<std::size_t>
+    send_batch(std::span<const udp_outgoing> datagrams) noexcept;
     /// @return Bound local port number.
     [[nodiscard]] result<std::uint16_t> local_port() const noexcept;
 
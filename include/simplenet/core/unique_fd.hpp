@@ -59,4 +59,29 @@ private:
  */
 [[nodiscard]] result<void> close_fd(int fd) noexcept;
 
+namespace detail {
+
+/**
+ * @brief Per-thread observer told about a descriptor just before it closes.
+ *
+ * `unique_fd` and `close_fd()` notify every listener installed on the
+ * calling thread, so an event loop can drop cached state for that number
+ * before the kernel hands it out again. A raw `::close()` is not seen.
+ */
+struct close_listener {
+    /// Called with the descriptor that is about to be closed.
+    void (*on_close)(close_listener& listener, int fd) noexcept {nullptr};
+    /// Opaque owner pointer available to `on_close`.
+    void *context{nullptr};
+    /// Next listener on the same thread.
+    close_listener *next{nullptr};
+};
+
+/// @brief Install `listener` on the calling thread.
+void add_close_listener(close_listener& listener) noexcept;
+/// @brief Remove a listener installed on the calling thread.
+void remove_close_listener(close_listener& listener) noexcept;
+
+} // namespace detail
+
 } // namespace simplenet
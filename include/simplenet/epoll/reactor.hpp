@@ -12,6 +12,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <sys/epoll.h>
 
 namespace simplenet::epoll {
 
@@ -57,6 +58,30 @@ public:
     [[nodiscard]] result<std::size_t>
     wait(std::span<ready_event> events,
          std::chrono::milliseconds timeout) noexcept;
+    /**
+     * @brief Wait for readiness events straight into `epoll_event` storage.
+     *
+     * Skips the scratch buffer and copy of the `ready_event` overload; the
+     * descriptor is in `data.fd`.
+     */
+    [[nodiscard]] result<std::size_t>
+    wait(std::span<::epoll_event> events,
+         std::chrono::milliseconds timeout) noexcept;
+
+    /**
+     * @brief Enable kernel busy polling for this epoll instance.
+     *
+     * `EPOLL_IOC_SET_BUSY_POLL` (Linux 6.9+): each blocking `epoll_wait`
+     * first polls the NAPI contexts of the sockets it watches for up to
+     * `usecs`. A zero `usecs` turns it off again.
+     * @param usecs Busy-poll time per wait.
+     * @param budget Packets per poll; `0` keeps the kernel default.
+     * @param prefer Ask NAPI to prefer busy polling over interrupts.
+     * @return `ENOTTY`/`EINVAL` on kernels without the ioctl.
+     */
+    [[nodiscard]] result<void> set_busy_poll(std::chrono::microseconds usecs,
+                                             std::uint16_t budget,
+                                             bool prefer) noexcept;
 
     /// @return Native epoll descriptor.
     [[nodiscard]] int native_handle() const noexcept;
@@ -64,6 +89,9 @@ public:
     [[nodiscard]] bool valid() const noexcept;
 
 private:
+    [[nodiscard]] result<std::size_t>
+    wait_into(std::span<ready_event> events, std::span<::epoll_event> scratch,
+              std::chrono::milliseconds timeout) noexcept;
     [[nodiscard]] result<void> ctl(int operation, int fd, std::uint32_t events,
                                    bool has_event) noexcept;
 
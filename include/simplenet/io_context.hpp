@@ -5,9 +5,17 @@
  * @brief High-level runtime context used to drive async tasks.
  */
 
+#include "simplenet/nonblocking/tcp.hpp"
 #include "simplenet/runtime/engine.hpp"
+#include "simplenet/runtime/io_backend.hpp"
+#include "simplenet/runtime/op_latency.hpp"
 
+#include <chrono>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <span>
 #include <utility>
 
 namespace simplenet {
@@ -23,6 +31,8 @@ class io_context {
 public:
     /// Runtime backend selector.
     using backend = runtime::engine::backend;
+    /// `io_uring` ring setup options.
+    using uring_options = runtime::uring_options;
 
     /**
      * @brief Construct a runtime context.
@@ -33,6 +43,14 @@ public:
                         std::uint32_t uring_queue_depth = 256)
         : engine_(selected_backend, uring_queue_depth) {}
 
+    /**
+     * @brief Construct a runtime context with explicit `io_uring` options.
+     * @param selected_backend Backend implementation to use.
+     * @param uring Ring setup (SQPOLL, DEFER_TASKRUN, CQ size, ...).
+     */
+    io_context(backend selected_backend, const uring_options& uring)
+        : engine_(selected_backend, uring) {}
+
     /// @return `true` when backend initialization succeeded.
     [[nodiscard]] bool valid() const noexcept {
         return engine_.valid();
@@ -53,6 +71,16 @@ public:
         engine_.spawn(std::move(work));
     }
 
+    /**
+     * @brief Schedule a root task that frees its frame when it finishes.
+     * @tparam T Task result type; the result is discarded.
+     * @param work Task object to transfer into the runtime.
+     */
+    template <class T>
+    void spawn_detached(runtime::task<T>&& work) noexcept {
+        engine_.spawn_detached(std::move(work));
+    }
+
     /**
      * @brief Run the event loop until all root tasks complete or stop is requested.
      * @return Success or the first loop error.
@@ -61,6 +89,17 @@ public:
         return engine_.run();
     }
 
+    /**
+     * @brief Run `work` on the loop thread; safe from any thread.
+     *
+     * `work` is a coroutine handle to resume or a nothrow callable; a burst
+     * of posts wakes the loop once.
+     */
+    template <class Work>
+    [[nodiscard]] result<void> post(Work&& work) noexcept {
+        return engine_.post(std::forward<Work>(work));
+    }
+
     /// @brief Request loop shutdown at the next wake-up boundary.
     void stop() noexcept {
         engine_.stop();
@@ -70,4 +109,230 @@ private:
     runtime::engine engine_;
 };
 
+/**
+ * @brief `io_context` for a backend fixed at build time.
+ *
+ * Holds the loop itself instead of an `engine`, so `spawn()`, `run()` and
+ * `post()` go straight to `Backend` with no branch on the selected
+ * backend. `readable()` / `writable()`, `async_accept()`,
+ * `async_read_some()` and `async_write_some()` submit to and wait on the
+ * loop through calls bound at compile time, and must be awaited from a task
+ * running on `loop()` (otherwise `EINVAL`). Backend-specific knobs are
+ * reached through `loop()`. Operations from `io_ops.hpp` keep working and
+ * still find the loop through the awaiting task's `scheduler`.
+ * @tparam Backend `runtime::event_loop` or `runtime::uring_event_loop`.
+ */
+template <runtime::io_backend Backend> class basic_io_context {
+public:
+    /// Loop type owned by this context.
+    using backend_type = Backend;
+    /// `true` when sockets complete through the ring rather than readiness.
+    static constexpr bool completion_io = Backend::completion_io;
+
+    /// @brief Construct the loop from `args` (e.g. `uring_options`).
+    template <class... Args>
+        requires std::constructible_from<Backend, Args...>
+    explicit basic_io_context(Args&&... args) noexcept
+        : loop_(std::forward<Args>(args)...) {}
+
+    basic_io_context(const basic_io_context&) = delete;
+    basic_io_context& operator=(const basic_io_context&) = delete;
+
+    /// @return `true` when backend initialization succeeded.
+    [[nodiscard]] bool valid() const noexcept {
+        return loop_.valid();
+    }
+
+    /// @return The owned loop.
+    [[nodiscard]] Backend& loop() noexcept {
+        return loop_;
+    }
+
+    /// @brief Schedule a root coroutine task.
+    template <class T>
+    void spawn(runtime::task<T>&& work) noexcept {
+        loop_.spawn(std::move(work));
+    }
+
+    /// @brief Schedule a root task that frees its frame when it finishes.
+    template <class T>
+    void spawn_detached(runtime::task<T>&& work) noexcept {
+        loop_.spawn_detached(std::move(work));
+    }
+
+    /**
+     * @brief Run the event loop until all root tasks complete or stop is requested.
+     * @return Success or the first loop error.
+     */
+    [[nodiscard]] result<void> run() noexcept {
+        return loop_.run();
+    }
+
+    /// @brief Run `work` on the loop thread; safe from any thread.
+    template <class Work>
+    [[nodiscard]] result<void> post(Work&& work) noexcept {
+        return loop_.post(std::forward<Work>(work));
+    }
+
+    /// @brief Request loop shutdown at the next wake-up boundary.
+    void stop() noexcept {
+        loop_.stop();
+    }
+
+    /**
+     * @brief Wait until `fd` is readable, from a task running on `loop()`.
+     * @param deadline Optional absolute deadline; `ETIMEDOUT` once it passes.
+     */
+    [[nodiscard]] runtime::readiness_awaitable<Backend>
+    readable(int fd,
+             std::optional<std::chrono::steady_clock::time_point> deadline =
+                 std::nullopt) noexcept {
+        return {loop_, fd, true, deadline};
+    }
+
+    /// @brief Wait until `fd` is writable; see `readable()`.
+    [[nodiscard]] runtime::readiness_awaitable<Backend>
+    writable(int fd,
+             std::optional<std::chrono::steady_clock::time_point> deadline =
+                 std::nullopt) noexcept {
+        return {loop_, fd, false, deadline};
+    }
+
+    /**
+     * @brief Accept one connection; `io_ops.hpp`'s `async_accept()` bound
+     *        to `Backend`.
+     */
+    runtime::task<result<nonblocking::tcp_stream>>
+    async_accept(nonblocking::tcp_listener& listener) {
+        if constexpr (completion_io) {
+            if (loop_.supports_completion_io() && listener.valid()) {
+                runtime::io_operation operation{};
+                operation.opcode = runtime::io_opcode::accept;
+                operation.fd = listener.native_handle();
+
+                const auto accepted = co_await runtime::submission_awaitable<
+                    Backend>{loop_, operation};
+                if (accepted.has_value()) {
+                    co_return nonblocking::tcp_stream{
+                        unique_fd{accepted.value()}};
+                }
+                if (!nonblocking::is_would_block(accepted.error())) {
+                    co_return err<nonblocking::tcp_stream>(accepted.error());
+                }
+            }
+        }
+
+        while (true) {
+            auto accept_result = listener.accept();
+            if (accept_result.has_value() ||
+                !nonblocking::is_would_block(accept_result.error())) {
+                co_return accept_result;
+            }
+
+            const auto wait_result = co_await runtime::readiness_awaitable<
+                Backend>{loop_, listener.native_handle(), true, std::nullopt,
+                         true};
+            if (!wait_result.has_value()) {
+                co_return err<nonblocking::tcp_stream>(wait_result.error());
+            }
+        }
+    }
+
+    /**
+     * @brief Read up to `buffer.size()` bytes; `io_ops.hpp`'s
+     *        `async_read_some()` bound to `Backend`.
+     */
+    runtime::task<result<std::size_t>>
+    async_read_some(nonblocking::tcp_stream& stream,
+                    std::span<std::byte> buffer) {
+        const runtime::detail::op_latency_timer timer{
+            runtime::op_kind::read_some, &loop_};
+        if constexpr (completion_io) {
+            if (loop_.supports_completion_io() && stream.valid() &&
+                !buffer.empty()) {
+                runtime::io_operation operation{};
+                operation.opcode = runtime::io_opcode::recv;
+                operation.fd = stream.native_handle();
+                operation.buffer = buffer.data();
+                operation.length = buffer.size();
+
+                const auto received = co_await runtime::submission_awaitable<
+                    Backend>{loop_, operation};
+                if (received.has_value()) {
+                    co_return static_cast<std::size_t>(received.value());
+                }
+                if (!nonblocking::is_would_block(received.error())) {
+                    co_return err<std::size_t>(received.error());
+                }
+            }
+        }
+
+        while (true) {
+            auto read_result = stream.read_some(buffer);
+            if (read_result.has_value() ||
+                !nonblocking::is_would_block(read_result.error())) {
+                co_return read_result;
+            }
+
+            const auto wait_result = co_await runtime::readiness_awaitable<
+                Backend>{loop_, stream.native_handle(), true, std::nullopt,
+                         true};
+            if (!wait_result.has_value()) {
+                co_return err<std::size_t>(wait_result.error());
+            }
+        }
+    }
+
+    /**
+     * @brief Write up to `buffer.size()` bytes; `io_ops.hpp`'s
+     *        `async_write_some()` bound to `Backend`.
+     */
+    runtime::task<result<std::size_t>>
+    async_write_some(nonblocking::tcp_stream& stream,
+                     std::span<const std::byte> buffer) {
+        if constexpr (completion_io) {
+            if (loop_.supports_completion_io() && stream.valid() &&
+                !buffer.empty()) {
+                runtime::io_operation operation{};
+                operation.opcode = runtime::io_opcode::send;
+                operation.fd = stream.native_handle();
+                operation.buffer = const_cast<std::byte *>(buffer.data());
+                operation.length = buffer.size();
+
+                const auto sent = co_await runtime::submission_awaitable<
+                    Backend>{loop_, operation};
+                if (sent.has_value()) {
+                    co_return static_cast<std::size_t>(sent.value());
+                }
+                if (!nonblocking::is_would_block(sent.error())) {
+                    co_return err<std::size_t>(sent.error());
+                }
+            }
+        }
+
+        while (true) {
+            auto write_result = stream.write_some(buffer);
+            if (write_result.has_value() ||
+                !nonblocking::is_would_block(write_result.error())) {
+                co_return write_result;
+            }
+
+            const auto wait_result = co_await runtime::readiness_awaitable<
+                Backend>{loop_, stream.native_handle(), false, std::nullopt,
+                         true};
+            if (!wait_result.has_value()) {
+                co_return err<std::size_t>(wait_result.error());
+            }
+        }
+    }
+
+private:
+    Backend loop_;
+};
+
+/// Context fixed to the `epoll` backend.
+using epoll_io_context = basic_io_context<runtime::event_loop>;
+/// Context fixed to the `io_uring` backend.
+using uring_io_context = basic_io_context<runtime::uring_event_loop>;
+
 } // namespace simplenet
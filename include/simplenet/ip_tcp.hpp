@@ -10,12 +10,17 @@
 
 namespace simplenet::ip {
 
+/// Binary IPv4/IPv6 address and port, accepted wherever `endpoint` is.
+using address = simplenet::blocking::socket_address;
+
 /**
  * @brief Protocol tag that exposes canonical TCP endpoint/socket types.
  */
 struct tcp {
     /// TCP address/port pair.
     using endpoint = simplenet::blocking::endpoint;
+    /// Binary TCP address/port pair.
+    using address = simplenet::blocking::socket_address;
     /// Nonblocking stream socket type.
     using socket = simplenet::nonblocking::tcp_stream;
     /// Nonblocking listening socket type.
@@ -0,0 +1,179 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Nonblocking Unix domain sockets for same-host IPC, with descriptor
+ *        passing.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/core/unique_fd.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <utility>
+
+namespace simplenet::nonblocking {
+
+/// Socket type of a `local_stream` and its listener.
+enum class local_kind : std::uint8_t {
+    /// `SOCK_STREAM`: a byte stream, like TCP.
+    stream,
+    /// `SOCK_SEQPACKET`: connected, ordered, and each write is read back
+    /// as one message.
+    seqpacket,
+};
+
+/// Most descriptors one `send_fds()` call may carry (the kernel's `SCM_MAX_FD`).
+inline constexpr std::size_t max_passed_fds = 253;
+
+/// Outcome of `local_stream::receive_fds()`.
+struct fd_message {
+    /// Payload bytes written to the buffer; `0` at end of stream.
+    std::size_t size{0};
+    /// Descriptors stored at the front of the `fds` span.
+    std::size_t fds{0};
+    /// `true` when descriptors arrived that did not fit; the kernel closed
+    /// the extra ones.
+    bool truncated{false};
+};
+
+/**
+ * @brief Nonblocking connected `AF_UNIX` socket.
+ *
+ * Addresses are filesystem paths, or names in the Linux abstract namespace
+ * when they start with `@` (the `@` is not part of the name). Byte I/O
+ * behaves like `tcp_stream`, and `socket()` exposes the descriptor as one
+ * so async operations and `queued_writer` work unchanged.
+ */
+class local_stream {
+public:
+    /// Construct an empty stream.
+    local_stream() noexcept = default;
+    /// Construct from an already-open connected `AF_UNIX` socket.
+    explicit local_stream(simplenet::unique_fd fd) noexcept;
+
+    local_stream(const local_stream&) = delete;
+    local_stream& operator=(const local_stream&) = delete;
+    local_stream(local_stream&&) noexcept = default;
+    local_stream& operator=(local_stream&&) noexcept = default;
+
+    /**
+     * @brief Connect to a `local_listener`.
+     *
+     * Local connects finish at once; there is no `finish_connect()` step.
+     * @return `ECONNREFUSED` when nothing listens on `path`, `EAGAIN` when
+     *         the listener's backlog is full, `ENAMETOOLONG` when `path`
+     *         does not fit `sockaddr_un`.
+     */
+    [[nodiscard]] static result<local_stream>
+    connect(std::string_view path, local_kind kind = local_kind::stream) noexcept;
+    /**
+     * @brief Create two connected sockets with `socketpair(2)`.
+     *
+     * Suits a parent that hands one end to a child process or thread.
+     */
+    [[nodiscard]] static result<std::pair<local_stream, local_stream>>
+    pair(local_kind kind = local_kind::stream) noexcept;
+
+    /// @brief Read available bytes without blocking.
+    [[nodiscard]] result<std::size_t>
+    read_some(std::span<std::byte> buffer) noexcept;
+    /// @brief Write available bytes without blocking.
+    [[nodiscard]] result<std::size_t>
+    write_some(std::span<const std::byte> buffer) noexcept;
+    /// @brief Scatter available bytes into `buffers` with one `recvmsg`.
+    [[nodiscard]] result<std::size_t>
+    read_some(std::span<const ::iovec> buffers) noexcept;
+    /// @brief Gather `buffers` into one `sendmsg` without blocking.
+    [[nodiscard]] result<std::size_t>
+    write_some(std::span<const ::iovec> buffers) noexcept;
+    /// @brief Check, without consuming anything, whether a read would not block.
+    [[nodiscard]] result<void> check_readable() noexcept;
+    /**
+     * @brief Send `bytes` with duplicates of `fds` attached (`SCM_RIGHTS`).
+     *
+     * The receiver gets its own descriptors for the same open files; the
+     * caller's stay open. On a stream socket the descriptors travel with
+     * the first byte of `bytes`, so a read that does not ask for them
+     * loses them.
+     * @return Bytes sent; `EINVAL` when `bytes` is empty or `fds` holds
+     *         more than `max_passed_fds` entries.
+     */
+    [[nodiscard]] result<std::size_t>
+    send_fds(std::span<const std::byte> bytes, std::span<const int> fds) noexcept;
+    /**
+     * @brief Read bytes and take ownership of any descriptors sent with them.
+     *
+     * Received descriptors are close-on-exec and fill `fds` from the front.
+     * At most `max_passed_fds` are taken per call.
+     */
+    [[nodiscard]] result<fd_message>
+    receive_fds(std::span<std::byte> buffer,
+                std::span<simplenet::unique_fd> fds) noexcept;
+    /// @brief Shutdown the write half of the connection.
+    [[nodiscard]] result<void> shutdown_write() noexcept;
+
+    /**
+     * @brief The connection as a `tcp_stream`, for APIs written against it.
+     *
+     * Move from it to hand the socket to a `queued_writer`. TCP-only
+     * features (`set_options()`, kTLS, zero-copy) fail with the kernel's
+     * error on a local socket.
+     */
+    [[nodiscard]] tcp_stream& socket() noexcept {
+        return socket_;
+    }
+
+    /// @return Native socket descriptor.
+    [[nodiscard]] int native_handle() const noexcept;
+    /// @return `true` when a valid socket is owned.
+    [[nodiscard]] bool valid() const noexcept;
+
+private:
+    tcp_stream socket_{};
+};
+
+/**
+ * @brief Nonblocking `AF_UNIX` listening socket.
+ *
+ * A filesystem path stays behind when the listener closes; remove it
+ * before binding again. Abstract names vanish with the socket.
+ */
+class local_listener {
+public:
+    /// Construct an empty listener.
+    local_listener() noexcept = default;
+    /// Construct from an already-open listening socket.
+    explicit local_listener(simplenet::unique_fd fd) noexcept;
+
+    local_listener(const local_listener&) = delete;
+    local_listener& operator=(const local_listener&) = delete;
+    local_listener(local_listener&&) noexcept = default;
+    local_listener& operator=(local_listener&&) noexcept = default;
+
+    /**
+     * @brief Bind and listen on `path`.
+     * @return `EADDRINUSE` when the path or abstract name already exists.
+     */
+    [[nodiscard]] static result<local_listener>
+    bind(std::string_view path, local_kind kind = local_kind::stream,
+         int backlog = SOMAXCONN) noexcept;
+    /// @brief Accept one connection without blocking.
+    [[nodiscard]] result<local_stream> accept() noexcept;
+
+    /// @return Native listening socket descriptor.
+    [[nodiscard]] int native_handle() const noexcept;
+    /// @return `true` when a valid socket is owned.
+    [[nodiscard]] bool valid() const noexcept;
+
+private:
+    simplenet::unique_fd fd_{};
+};
+
+} // namespace simplenet::nonblocking
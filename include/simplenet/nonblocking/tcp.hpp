@@ -9,14 +9,117 @@
 #include "simplenet/core/result.hpp"
 #include "simplenet/core/unique_fd.hpp"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 namespace simplenet::nonblocking {
 
 /// Alias to the shared endpoint type.
 using endpoint = simplenet::blocking::endpoint;
+/// Alias to the shared binary address type.
+using socket_address = simplenet::blocking::socket_address;
+
+/**
+ * @brief Kernel release of `MSG_ZEROCOPY` sends, from the error queue.
+ *
+ * Covers notification ids `first` through `last` inclusive (`uint32`,
+ * wrapping).
+ */
+struct zerocopy_notification {
+    /// First released send id.
+    std::uint32_t first{0};
+    /// Last released send id.
+    std::uint32_t last{0};
+    /// `true` when the kernel fell back to copying the data.
+    bool copied{false};
+
+    /// @return `true` when send `id` is covered.
+    [[nodiscard]] bool contains(std::uint32_t id) const noexcept {
+        return id - first <= last - first;
+    }
+};
+
+/// Cipher suites the kernel TLS layer can take over.
+enum class tls_cipher : std::uint8_t {
+    aes_gcm_128,
+    aes_gcm_256,
+    chacha20_poly1305,
+};
+
+/**
+ * @brief Traffic keys for one direction of a session, from the handshake.
+ *
+ * Sizes per cipher: `key` 16/32/32 bytes, `iv` 8/8/12, `salt` 4/4/0. For
+ * AES-GCM, the handshake's 12-byte static IV splits into `salt` (first 4
+ * bytes) and `iv` (last 8). The spans are only read during the call.
+ */
+struct tls_key_material {
+    /// `0x0303` for TLS 1.2, `0x0304` for TLS 1.3.
+    std::uint16_t version{0x0304};
+    /// Negotiated cipher.
+    tls_cipher cipher{tls_cipher::aes_gcm_128};
+    /// Traffic key.
+    std::span<const std::byte> key{};
+    /// Per-connection IV (the explicit nonce base).
+    std::span<const std::byte> iv{};
+    /// Implicit nonce prefix.
+    std::span<const std::byte> salt{};
+    /// Sequence number of the next record in this direction.
+    std::uint64_t record_sequence{0};
+};
+
+/// TLS record content types (RFC 8446 section 5.1).
+inline constexpr std::uint8_t tls_alert = 21;
+/// Post-handshake messages such as `KeyUpdate` and `NewSessionTicket`.
+inline constexpr std::uint8_t tls_handshake = 22;
+/// Ordinary payload.
+inline constexpr std::uint8_t tls_application_data = 23;
+
+/// One decrypted record returned by `tcp_stream::read_tls_record()`.
+struct tls_record {
+    /// Plaintext bytes written to the buffer.
+    std::size_t size{0};
+    /// Content type, such as `tls_alert` or `tls_application_data`.
+    std::uint8_t type{tls_application_data};
+};
+
+/**
+ * @brief Per-socket kernel tuning applied by `connect`, `open` and `bind`.
+ *
+ * Every field defaults to "leave the kernel default", so only the options
+ * that are set cost a `setsockopt`. Set on a listener, Linux copies them
+ * to each accepted connection.
+ */
+struct socket_options {
+    /// `TCP_NODELAY`: send small segments without waiting for ACKs.
+    bool no_delay{false};
+    /**
+     * `TCP_QUICKACK`: ACK at once instead of delaying. The kernel may leave
+     * quick-ACK mode again on its own, so this only covers the first
+     * exchanges.
+     */
+    bool quick_ack{false};
+    /**
+     * `TCP_FASTOPEN_CONNECT` (client only): `connect()` returns at once and
+     * the first write carries the data in the SYN when a cookie is cached.
+     */
+    bool fast_open_connect{false};
+    /// `SO_RCVBUF` in bytes; `0` keeps autotuning. Set before connecting.
+    int receive_buffer{0};
+    /// `SO_SNDBUF` in bytes; `0` keeps autotuning.
+    int send_buffer{0};
+    /// `SO_INCOMING_CPU`; `-1` leaves the socket unbound to a CPU.
+    int incoming_cpu{-1};
+    /**
+     * `TCP_NOTSENT_LOWAT`: report writable only while fewer unsent bytes
+     * than this sit in the kernel; `0` leaves the sysctl default.
+     */
+    std::uint32_t notsent_lowat{0};
+};
 
 /**
  * @brief Nonblocking connected TCP socket.
@@ -39,14 +142,141 @@ public:
      */
     [[nodiscard]] static result<tcp_stream>
     connect(const endpoint& remote) noexcept;
+    /**
+     * @brief Start a nonblocking connect to a binary IPv4 or IPv6 address.
+     * @param remote Destination address; no text is parsed.
+     * @param options Applied before the SYN is sent.
+     */
+    [[nodiscard]] static result<tcp_stream>
+    connect(const socket_address& remote,
+            const socket_options& options = {}) noexcept;
+    /**
+     * @brief Create an unconnected nonblocking stream socket.
+     *
+     * Used by completion-based backends that issue the connect themselves.
+     * @param family `AF_INET` or `AF_INET6`.
+     * @param options Applied to the new socket.
+     */
+    [[nodiscard]] static result<tcp_stream>
+    open(int family = AF_INET, const socket_options& options = {}) noexcept;
     /// @brief Complete a pending nonblocking connect.
     [[nodiscard]] result<void> finish_connect() noexcept;
     /// @brief Read available bytes without blocking.
     [[nodiscard]] result<std::size_t>
     read_some(std::span<std::byte> buffer) noexcept;
-    /// @brief Write available bytes without blocking.
+    /**
+     * @brief Check, without consuming anything, whether a read would return
+     *        bytes or end of stream.
+     *
+     * Peeks one byte into a local, so callers need no read buffer.
+     * @return Success when a read would not block; `EAGAIN` when it would.
+     */
+    [[nodiscard]] result<void> check_readable() noexcept;
+    /**
+     * @brief Write available bytes without blocking.
+     *
+     * A fast-open socket whose SYN is still in flight reports `EAGAIN`.
+     */
     [[nodiscard]] result<std::size_t>
     write_some(std::span<const std::byte> buffer) noexcept;
+    /**
+     * @brief Scatter available bytes into `buffers` with one `recvmsg`.
+     *
+     * At most `IOV_MAX` entries are used per call.
+     */
+    [[nodiscard]] result<std::size_t>
+    read_some(std::span<const ::iovec> buffers) noexcept;
+    /**
+     * @brief Gather `buffers` into one `sendmsg` without blocking.
+     *
+     * At most `IOV_MAX` entries are used per call.
+     */
+    [[nodiscard]] result<std::size_t>
+    write_some(std::span<const ::iovec> buffers) noexcept;
+    /**
+     * @brief Send file bytes without copying them through userspace.
+     *
+     * One `sendfile(2)` call. The file's own offset is left alone.
+     * @param file_fd Readable regular file (or anything `sendfile` accepts).
+     * @param offset Position in `file_fd` to read from.
+     * @param count Bytes to send at most.
+     * @return Bytes sent; `0` when `offset` is at or past the end of file.
+     */
+    [[nodiscard]] result<std::size_t>
+    send_file(int file_fd, std::uint64_t offset, std::size_t count) noexcept;
+    /**
+     * @brief Turn on `SO_ZEROCOPY` so `write_some_zerocopy()` can pin pages.
+     * @return `ENOPROTOOPT` (or similar) on kernels without support.
+     */
+    [[nodiscard]] result<void> enable_zerocopy() noexcept;
+    /// @return `true` once `enable_zerocopy()` succeeded.
+    [[nodiscard]] bool zerocopy_enabled() const noexcept {
+        return zerocopy_enabled_;
+    }
+    /**
+     * @brief Gather `buffers` into one `MSG_ZEROCOPY` send.
+     *
+     * Each successful call takes the id `next_zerocopy_id()` returned
+     * beforehand. The kernel reads the pages after this returns, so the
+     * bytes must stay allocated and unchanged until `reap_zerocopy()`
+     * reports that id. Keep to one zero-copy sender per socket so ids line
+     * up with the kernel's counter.
+     * @return `EINVAL` unless `enable_zerocopy()` succeeded.
+     */
+    [[nodiscard]] result<std::size_t>
+    write_some_zerocopy(std::span<const ::iovec> buffers) noexcept;
+    /// @return Id the next successful zero-copy send will be reported under.
+    [[nodiscard]] std::uint32_t next_zerocopy_id() const noexcept {
+        return next_zerocopy_id_;
+    }
+    /**
+     * @brief Take one zero-copy completion off the socket error queue.
+     * @return `EAGAIN` when none is pending.
+     */
+    [[nodiscard]] result<zerocopy_notification> reap_zerocopy() noexcept;
+    /**
+     * @brief Hand record encryption for sent bytes to the kernel (kTLS).
+     *
+     * Call once the external handshake is done and its output is flushed.
+     * Afterwards every write path, including `send_file()` and vectored
+     * writes, emits application-data records. Attaches the `tls` ULP on
+     * first use.
+     * @return `ENOENT` when the kernel has no TLS support, `EINVAL` for
+     *         key sizes that do not match the cipher.
+     */
+    [[nodiscard]] result<void>
+    enable_ktls_tx(const tls_key_material& keys) noexcept;
+    /**
+     * @brief Hand record decryption for received bytes to the kernel.
+     *
+     * Reads then return plaintext. A non-data record fails `read_some()`
+     * with `EIO`; take it with `read_tls_record()` instead.
+     */
+    [[nodiscard]] result<void>
+    enable_ktls_rx(const tls_key_material& keys) noexcept;
+    /// @return `true` once `enable_ktls_tx()` succeeded.
+    [[nodiscard]] bool ktls_tx_enabled() const noexcept {
+        return ktls_tx_;
+    }
+    /// @return `true` once `enable_ktls_rx()` succeeded.
+    [[nodiscard]] bool ktls_rx_enabled() const noexcept {
+        return ktls_rx_;
+    }
+    /**
+     * @brief Read one decrypted record and report its content type.
+     *
+     * Data records may be merged into one read like with `read_some()`.
+     * A control record is always returned alone.
+     * @return `EINVAL` unless `enable_ktls_rx()` succeeded.
+     */
+    [[nodiscard]] result<tls_record>
+    read_tls_record(std::span<std::byte> buffer) noexcept;
+    /**
+     * @brief Send `bytes` as one record of content `type`, such as an alert.
+     * @return `EINVAL` unless `enable_ktls_tx()` succeeded.
+     */
+    [[nodiscard]] result<std::size_t>
+    write_tls_record(std::uint8_t type, std::span<const std::byte> bytes) noexcept;
     /// @brief Shutdown the write half of the connection.
     [[nodiscard]] result<void> shutdown_write() noexcept;
     /**
@@ -54,6 +284,29 @@ public:
      * @param bytes Requested SO_SNDBUF value.
      */
     [[nodiscard]] result<void> set_send_buffer_size(int bytes) noexcept;
+    /**
+     * @brief Apply the fields of `options` that are set.
+     * @return The first `setsockopt` error; earlier options stay applied.
+     */
+    [[nodiscard]] result<void> set_options(const socket_options& options) noexcept;
+    /**
+     * @brief Busy-poll the device queue on blocking reads (`SO_BUSY_POLL`).
+     *
+     * Raising the value above the `net.core.busy_read` sysctl needs
+     * `CAP_NET_ADMIN`. Pairs with `event_loop::set_kernel_busy_poll()`.
+     * @param usecs Busy-poll time; `0` disables it.
+     */
+    [[nodiscard]] result<void>
+    set_busy_poll(std::chrono::microseconds usecs) noexcept;
+    /**
+     * @brief Cap the kernel's pacing rate (`SO_MAX_PACING_RATE`).
+     *
+     * The `fq` qdisc spaces the socket's packets to this rate; on other
+     * qdiscs TCP paces internally. Either way no user-space timer runs.
+     * @param bytes_per_second Rate cap; `0` removes it.
+     */
+    [[nodiscard]] result<void>
+    set_max_pacing_rate(std::uint64_t bytes_per_second) noexcept;
 
     /// @return Native socket descriptor.
     [[nodiscard]] int native_handle() const noexcept;
@@ -61,7 +314,45 @@ public:
     [[nodiscard]] bool valid() const noexcept;
 
 private:
+    [[nodiscard]] result<void> attach_tls() noexcept;
+
     simplenet::unique_fd fd_{};
+    bool zerocopy_enabled_{false};
+    bool ktls_tx_{false};
+    bool ktls_rx_{false};
+    std::uint32_t next_zerocopy_id_{0};
+};
+
+/**
+ * @brief Socket options applied by `tcp_listener::bind` before `listen()`.
+ */
+struct listen_options {
+    /// Kernel listen backlog; the kernel caps it at `net.core.somaxconn`.
+    int backlog{SOMAXCONN};
+    /**
+     * Set `SO_REUSEPORT` so several listeners can share one address; the
+     * kernel then spreads incoming connections across the group.
+     */
+    bool reuse_port{false};
+    /**
+     * `IPV6_V6ONLY` for IPv6 listeners. The `false` default makes a `[::]`
+     * listener dual-stack: IPv4 clients arrive as `::ffff:a.b.c.d`.
+     */
+    bool v6_only{false};
+    /**
+     * `TCP_FASTOPEN` queue length: pending SYN-data connections accepted
+     * before the handshake completes; `0` disables server fast open. Also
+     * needs bit `0x2` of the `net.ipv4.tcp_fastopen` sysctl.
+     */
+    int fast_open_queue{0};
+    /**
+     * `TCP_DEFER_ACCEPT`: hold a connection out of `accept()` until its
+     * first data arrives, giving up after roughly this long; `0` disables.
+     * Suits protocols where the client speaks first.
+     */
+    std::chrono::seconds defer_accept{0};
+    /// Options set on the listener and inherited by accepted connections.
+    socket_options socket{};
 };
 
 /**
@@ -84,12 +375,55 @@ public:
      * @param local Local host/port.
      * @param backlog Kernel listen backlog.
      */
-    [[nodiscard]] static result<tcp_listener> bind(const endpoint& local,
-                                                   int backlog = 128) noexcept;
+    [[nodiscard]] static result<tcp_listener>
+    bind(const endpoint& local, int backlog = SOMAXCONN) noexcept;
+    /**
+     * @brief Bind and listen on a local endpoint with extra socket options.
+     * @param local Local host/port.
+     * @param options Backlog, reuse flags and socket options.
+     */
+    [[nodiscard]] static result<tcp_listener>
+    bind(const endpoint& local, const listen_options& options) noexcept;
+    /**
+     * @brief Bind and listen on a binary IPv4 or IPv6 address.
+     * @param local Address to bind; no text is parsed.
+     * @param options Backlog, reuse flags and socket options.
+     */
+    [[nodiscard]] static result<tcp_listener>
+    bind(const socket_address& local,
+         const listen_options& options = {}) noexcept;
     /// @brief Accept one connection without blocking.
     [[nodiscard]] result<tcp_stream> accept() noexcept;
+    /**
+     * @brief Accept one connection and report its peer without formatting.
+     * @param peer Receives the remote address on success.
+     */
+    [[nodiscard]] result<tcp_stream> accept(socket_address& peer) noexcept;
+    /**
+     * @brief Accept up to `streams.size()` pending connections.
+     *
+     * Calls `accept4` until the queue is empty or the span is full.
+     * @return Number of filled slots, or the error when none was accepted;
+     *         a would-block error means the queue was empty.
+     */
+    [[nodiscard]] result<std::size_t>
+    accept_batch(std::span<tcp_stream> streams) noexcept;
     /// @return Bound local port number.
     [[nodiscard]] result<std::uint16_t> local_port() const noexcept;
+    /// @return Bound local address.
+    [[nodiscard]] result<socket_address> local_address() const noexcept;
+    /**
+     * @brief Steer each connection to the `SO_REUSEPORT` member for its CPU.
+     *
+     * Attaches a classic BPF program that selects group member
+     * `cpu % group_size`, where `cpu` is the CPU handling the incoming SYN.
+     * The program is shared by the whole group, so one call on any member
+     * is enough. Members are indexed in bind order.
+     *
+     * @param group_size Number of listeners in the reuse-port group.
+     */
+    [[nodiscard]] result<void>
+    steer_by_cpu(std::uint32_t group_size) noexcept;
 
     /// @return Native listening socket descriptor.
     [[nodiscard]] int native_handle() const noexcept;
@@ -0,0 +1,237 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Nonblocking UDP socket with batched `recvmmsg`/`sendmmsg` I/O and
+ * `UDP_SEGMENT`/`UDP_GRO` offload.
+ */
+
+#include "simplenet/blocking/udp.hpp"
+#include "simplenet/core/result.hpp"
+#include "simplenet/core/unique_fd.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <sys/socket.h>
+
+namespace simplenet::nonblocking {
+
+/**
+ * @brief Metadata returned by `udp_socket::recv_from()`.
+ */
+struct udp_datagram {
+    /// Bytes copied into the caller buffer.
+    std::size_t size{0};
+    /// Sender address.
+    socket_address from{};
+    /// `true` when the datagram was longer than the buffer.
+    bool truncated{false};
+};
+
+/// @copydoc simplenet::blocking::udp_message
+using udp_message = simplenet::blocking::udp_message;
+/// @copydoc simplenet::blocking::udp_outgoing
+using udp_outgoing = simplenet::blocking::udp_outgoing;
+using simplenet::blocking::udp_batch_limit;
+
+/// Most segments one `send_segmented()` call may carry (`UDP_MAX_SEGMENTS`).
+inline constexpr std::size_t udp_max_segments = 64;
+
+/**
+ * @brief Forward range of fixed-size segments within a coalesced datagram.
+ *
+ * Every segment is `segment_size` bytes except a possibly shorter last one.
+ */
+class udp_segments {
+public:
+    /// Iterator yielding each segment as a byte span.
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::span<const std::byte>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+        iterator(std::span<const std::byte> rest,
+                 std::size_t segment_size) noexcept
+            : rest_(rest), segment_size_(segment_size) {}
+
+        [[nodiscard]] value_type operator*() const noexcept {
+            return rest_.first(std::min(rest_.size(), segment_size_));
+        }
+        iterator& operator++() noexcept {
+            rest_ = rest_.subspan(std::min(rest_.size(), segment_size_));
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+        [[nodiscard]] friend bool operator==(const iterator& lhs,
+                                             const iterator& rhs) noexcept {
+            return lhs.rest_.size() == rhs.rest_.size();
+        }
+
+    private:
+        std::span<const std::byte> rest_{};
+        std::size_t segment_size_{0};
+    };
+
+    udp_segments() noexcept = default;
+    /// View `bytes` as segments of `segment_size` (`0` means one segment).
+    udp_segments(std::span<const std::byte> bytes,
+                 std::size_t segment_size) noexcept
+        : bytes_(bytes),
+          segment_size_(segment_size == 0 ? bytes.size() : segment_size) {}
+
+    [[nodiscard]] iterator begin() const noexcept {
+        return {bytes_, segment_size_};
+    }
+    [[nodiscard]] iterator end() const noexcept {
+        return {bytes_.last(0), segment_size_};
+    }
+    /// @return Number of segments.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return segment_size_ == 0
+                   ? 0
+                   : (bytes_.size() + segment_size_ - 1) / segment_size_;
+    }
+
+private:
+    std::span<const std::byte> bytes_{};
+    std::size_t segment_size_{0};
+};
+
+/**
+ * @brief Result of `udp_socket::recv_coalesced()`.
+ *
+ * With `UDP_GRO` enabled the kernel may merge consecutive same-flow
+ * datagrams into one receive; `segments()` splits them again.
+ */
+struct udp_coalesced {
+    /// Received bytes, a prefix of the caller buffer.
+    std::span<const std::byte> data{};
+    /// Size of each merged datagram; equals `data.size()` when not merged.
+    std::size_t segment_size{0};
+    /// Sender address.
+    socket_address from{};
+    /// `true` when the receive was longer than the buffer.
+    bool truncated{false};
+
+    /// @return The original datagrams.
+    [[nodiscard]] udp_segments segments() const noexcept {
+        return {data, segment_size};
+    }
+};
+
+/**
+ * @brief Nonblocking UDP datagram socket.
+ */
+class udp_socket {
+public:
+    /// Construct an empty socket.
+    udp_socket() noexcept = default;
+    /// Take ownership of an already-open nonblocking datagram socket.
+    explicit udp_socket(simplenet::unique_fd fd) noexcept;
+
+    udp_socket(const udp_socket&) = delete;
+    udp_socket& operator=(const udp_socket&) = delete;
+    udp_socket(udp_socket&&) noexcept = default;
+    udp_socket& operator=(udp_socket&&) noexcept = default;
+
+    /**
+     * @brief Create a nonblocking socket bound to `local`.
+     * @param local IPv4 or IPv6 literal host and port (`0` picks one).
+     */
+    [[nodiscard]] static result<udp_socket>
+    bind(const endpoint& local) noexcept;
+    /**
+     * @brief Create a nonblocking socket bound to a binary IPv4 or IPv6
+     * address.
+     */
+    [[nodiscard]] static result<udp_socket>
+    bind(const socket_address& local) noexcept;
+
+    /**
+     * @brief Send one datagram.
+     * @return Bytes sent, or a would-block error when the buffer is full.
+     */
+    [[nodiscard]] result<std::size_t>
+    send_to(std::span<const std::byte> buffer,
+            const socket_address& to) noexcept;
+    /**
+     * @brief Receive one datagram.
+     * @return Size and sender, or a would-block error when none is queued.
+     */
+    [[nodiscard]] result<udp_datagram>
+    recv_from(std::span<std::byte> buffer) noexcept;
+    /**
+     * @brief Receive up to `messages.size()` datagrams with one `recvmmsg`.
+     *
+     * At most `udp_batch_limit` slots are used per call.
+     * @return Number of filled slots, or a would-block error when none.
+     */
+    [[nodiscard]] result<std::size_t>
+    recv_batch(std::span<udp_message> messages) noexcept;
+    /**
+     * @brief Send a prefix of `datagrams` with one `sendmmsg`.
+     *
+     * At most `udp_batch_limit` datagrams are passed per call.
+     * @return Datagrams sent, or a would-block error when none fit.
+     */
+    [[nodiscard]] result<std::size_t>
+    send_batch(std::span<const udp_outgoing> datagrams) noexcept;
+
+    /**
+     * @brief Send `payload` as datagrams of `segment_size` bytes with one
+     * `sendmsg` (`UDP_SEGMENT` control message).
+     *
+     * The last datagram may be shorter. The kernel (or NIC) does the split.
+     * @return Bytes sent; `EINVAL` when `segment_size` is `0` or `payload`
+     * needs more than `udp_max_segments` segments.
+     */
+    [[nodiscard]] result<std::size_t>
+    send_segmented(std::span<const std::byte> payload, const socket_address& to,
+                   std::uint16_t segment_size) noexcept;
+    /**
+     * @brief Receive one, possibly GRO-coalesced, datagram.
+     *
+     * Size `buffer` for a full coalesced receive (up to 64 KiB).
+     * @return Received bytes and their segment size, or a would-block error.
+     */
+    [[nodiscard]] result<udp_coalesced>
+    recv_coalesced(std::span<std::byte> buffer) noexcept;
+    /**
+     * @brief Set the socket-wide `UDP_SEGMENT` size for plain sends.
+     * @param segment_size Bytes per datagram, `0` turns segmentation off.
+     */
+    [[nodiscard]] result<void>
+    set_gso_segment_size(std::uint16_t segment_size) noexcept;
+    /**
+     * @brief Toggle `UDP_GRO` so receives may return coalesced datagrams.
+     *
+     * Read a GRO socket with `recv_coalesced()`; other receives do not
+     * report the segment size.
+     */
+    [[nodiscard]] result<void> enable_gro(bool enabled = true) noexcept;
+
+    /// @return Bound local port number.
+    [[nodiscard]] result<std::uint16_t> local_port() const noexcept;
+    /// @return Bound local address.
+    [[nodiscard]] result<socket_address> local_address() const noexcept;
+
+    /// @return Native socket descriptor.
+    [[nodiscard]] int native_handle() const noexcept;
+    /// @return `true` when a valid socket is owned.
+    [[nodiscard]] bool valid() const noexcept;
+
+private:
+    simplenet::unique_fd fd_;
+};
+
+} // namespace simplenet::nonblocking
@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Multishot connection acceptor with readiness-based fallback.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/core/unique_fd.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <optional>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Stream of accepted connections backed by one multishot accept.
+ *
+ * On schedulers with completion I/O (`io_uring`) the first `accept()` arms a
+ * single `IORING_ACCEPT_MULTISHOT` request; every connection it produces is
+ * buffered until pulled. On other schedulers, or kernels without multishot
+ * accept, `accept()` behaves like `async_accept()`.
+ *
+ * The acceptor must not outlive the event loop that runs it, and only one
+ * coroutine may wait in `accept()` at a time.
+ */
+class multishot_acceptor {
+public:
+    /**
+     * @brief Construct an acceptor over an existing listener.
+     * @param listener Listening socket; must outlive the acceptor.
+     */
+    explicit multishot_acceptor(
+        simplenet::nonblocking::tcp_listener& listener) noexcept;
+    /// Cancel the multishot request and close unclaimed connections.
+    ~multishot_acceptor();
+
+    multishot_acceptor(const multishot_acceptor&) = delete;
+    multishot_acceptor& operator=(const multishot_acceptor&) = delete;
+    multishot_acceptor(multishot_acceptor&&) = delete;
+    multishot_acceptor& operator=(multishot_acceptor&&) = delete;
+
+    /// @brief Pull the next accepted connection, suspending until one arrives.
+    [[nodiscard]] task<result<simplenet::nonblocking::tcp_stream>> accept();
+
+    /// @return `true` while a multishot request is armed in the kernel.
+    [[nodiscard]] bool multishot_active() const noexcept;
+    /// @return Number of accepted connections buffered but not yet pulled.
+    [[nodiscard]] std::size_t pending() const noexcept;
+
+private:
+    class next_connection_awaitable;
+
+    static void on_completion(io_operation& operation, int result,
+                              bool more) noexcept;
+
+    simplenet::nonblocking::tcp_listener *listener_{nullptr};
+    scheduler *scheduler_{nullptr};
+    io_operation operation_{};
+    std::deque<simplenet::unique_fd> ready_{};
+    std::optional<simplenet::error> pending_error_{};
+    std::coroutine_handle<> waiter_{};
+    bool armed_{false};
+    bool fallback_{false};
+};
+
+} // namespace simplenet::runtime
@@ -0,0 +1,190 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Per-loop pool of I/O buffers in power-of-two size classes.
+ */
+
+#include "simplenet/core/result.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace simplenet::runtime {
+
+class buffer_pool;
+class scheduler;
+
+/// Size classes and backing memory for one `buffer_pool`.
+struct buffer_pool_options {
+    /// Smallest class; rounded up to a power of two of at least 64.
+    std::size_t min_size{256};
+    /// Largest pooled class; bigger requests are one-off heap buffers.
+    std::size_t max_size{1024U * 1024U};
+    /// Heap buffers kept free per class; arena buffers are always kept.
+    std::size_t cache_per_class{64};
+    /// Bytes of one up-front `mmap` region buffers are carved from; `0`
+    /// backs every buffer with the heap.
+    std::size_t arena_bytes{0};
+    /// Back the arena with huge pages: `MAP_HUGETLB` when reserved pages
+    /// exist, transparent huge pages (`MADV_HUGEPAGE`) otherwise.
+    bool huge_pages{false};
+    /// Prefer this NUMA node for the arena's pages, e.g. the node of the
+    /// loop that owns the pool (`loop_pool::numa_node()`); `-1` leaves it
+    /// to first touch.
+    int numa_node{-1};
+};
+
+/// Counters kept by one `buffer_pool`.
+struct buffer_pool_stats {
+    /// Buffers handed out.
+    std::uint64_t acquisitions{0};
+    /// Acquisitions served from a free list.
+    std::uint64_t reuses{0};
+    /// Buffers newly taken from the heap, including oversized ones.
+    std::uint64_t heap_allocations{0};
+    /// Buffers newly carved from the arena.
+    std::uint64_t arena_allocations{0};
+    /// Buffers waiting in free lists.
+    std::size_t cached_buffers{0};
+    /// Arena bytes carved so far.
+    std::size_t arena_used{0};
+};
+
+/**
+ * @brief One buffer on loan from a `buffer_pool`; returned on destruction.
+ *
+ * `bytes()` spans the requested size, which `resize()` may move anywhere up
+ * to `capacity()`, such as to the count an `async_read_some` filled in.
+ */
+class pooled_buffer {
+public:
+    /// Construct an empty handle.
+    pooled_buffer() noexcept = default;
+    /// Return the buffer to its pool.
+    ~pooled_buffer();
+
+    pooled_buffer(const pooled_buffer&) = delete;
+    pooled_buffer& operator=(const pooled_buffer&) = delete;
+    pooled_buffer(pooled_buffer&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)),
+          data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0U)),
+          capacity_(std::exchange(other.capacity_, 0U)) {}
+    pooled_buffer& operator=(pooled_buffer&& other) noexcept;
+
+    /// @return The first `size()` bytes.
+    [[nodiscard]] std::span<std::byte> bytes() noexcept {
+        return {data_, size_};
+    }
+    /// @return The first `size()` bytes.
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept {
+        return {data_, size_};
+    }
+    /// @return Requested size.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+    /// @return Size of the class the buffer came from.
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+    /// @return `true` while a buffer is held.
+    [[nodiscard]] bool valid() const noexcept {
+        return data_ != nullptr;
+    }
+    /// @brief Set `size()`; clamped to `capacity()`.
+    void resize(std::size_t size) noexcept {
+        size_ = size < capacity_ ? size : capacity_;
+    }
+
+private:
+    friend class buffer_pool;
+
+    pooled_buffer(buffer_pool& pool, std::byte *data, std::size_t size,
+                  std::size_t capacity) noexcept
+        : pool_(&pool), data_(data), size_(size), capacity_(capacity) {}
+    void release() noexcept;
+
+    buffer_pool *pool_{nullptr};
+    std::byte *data_{nullptr};
+    std::size_t size_{0};
+    std::size_t capacity_{0};
+};
+
+/**
+ * @brief Recycles I/O buffers so steady-state traffic allocates nothing.
+ *
+ * Requests round up to a power-of-two class, and freed buffers wait on
+ * that class's free list for the next request. A pool belongs to one loop
+ * thread: its lists take no locks, and buffers must be acquired and
+ * dropped on that thread. `thread_buffer_pool()` is the calling thread's
+ * default pool. With an arena, `register_with()` makes the whole arena an
+ * io_uring fixed buffer, so receives into pooled buffers skip per-call
+ * page pinning.
+ *
+ * The pool must outlive its buffers.
+ */
+class buffer_pool {
+public:
+    /**
+     * @brief Construct a pool; an arena that cannot be mapped leaves the
+     *        pool heap-backed, which `arena()` reports as empty.
+     */
+    explicit buffer_pool(buffer_pool_options options = {});
+    /// Free cached buffers and unmap the arena.
+    ~buffer_pool();
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+    buffer_pool(buffer_pool&&) = delete;
+    buffer_pool& operator=(buffer_pool&&) = delete;
+
+    /// @return A buffer of at least `size` bytes with `size()` == `size`.
+    [[nodiscard]] pooled_buffer acquire(std::size_t size);
+
+    /**
+     * @brief Register the arena as `scheduler`'s fixed buffer.
+     * @return `EINVAL` without an arena; `EOPNOTSUPP` on the epoll loop.
+     */
+    [[nodiscard]] result<void> register_with(scheduler& loop) noexcept;
+
+    /// @return The arena region, or an empty span.
+    [[nodiscard]] std::span<const std::byte> arena() const noexcept;
+    /// @return `true` when the arena is backed by `MAP_HUGETLB` pages.
+    [[nodiscard]] bool huge_pages() const noexcept;
+    /// @return Pool counters since construction.
+    [[nodiscard]] buffer_pool_stats stats() const noexcept;
+    /// @brief Free every cached heap buffer.
+    void trim() noexcept;
+
+private:
+    friend class pooled_buffer;
+
+    [[nodiscard]] std::size_t class_of(std::size_t size) const noexcept;
+    [[nodiscard]] bool in_arena(const std::byte *data) const noexcept;
+    void release(std::byte *data, std::size_t capacity) noexcept;
+
+    /// Free list of one class. `free` is kept with room for every
+    /// outstanding buffer, so returning one never allocates.
+    struct class_list {
+        std::vector<std::byte *> free{};
+        std::size_t outstanding{0};
+    };
+
+    buffer_pool_options options_;
+    buffer_pool_stats stats_{};
+    /// Smallest class first.
+    std::vector<class_list> classes_{};
+    std::byte *arena_{nullptr};
+    std::size_t arena_size_{0};
+    bool huge_pages_{false};
+};
+
+/// @return The calling thread's default pool, created on first use.
+[[nodiscard]] buffer_pool& thread_buffer_pool();
+
+} // namespace simplenet::runtime
@@ -6,10 +6,93 @@
  */
 
 #include <atomic>
-#include <memory>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace simplenet::runtime {
 
+class cancel_callback_base;
+
+namespace detail {
+
+/**
+ * @brief Shared stop state behind a source and its tokens.
+ *
+ * Intrusively reference counted and recycled through a per-thread free list,
+ * so creating a source normally costs no heap allocation.
+ */
+struct cancel_state {
+    std::atomic<std::uint32_t> references{1};
+    std::atomic<bool> requested{false};
+    std::mutex mutex{};
+    std::condition_variable callback_finished{};
+    /// Registered callbacks, guarded by `mutex`.
+    cancel_callback_base *callbacks{nullptr};
+    /// Callback being invoked by `request_stop()`, guarded by `mutex`.
+    const cancel_callback_base *running{nullptr};
+    std::thread::id running_thread{};
+    /// Free-list link while the state is pooled.
+    cancel_state *next_free{nullptr};
+
+    /// @brief Take a fresh state from the pool (or the heap).
+    [[nodiscard]] static cancel_state *acquire();
+    /// @brief Drop one reference, recycling the state on the last one.
+    static void release(cancel_state *state) noexcept;
+};
+
+/// @brief Owning reference to a `cancel_state`.
+class cancel_state_ref {
+public:
+    cancel_state_ref() noexcept = default;
+    explicit cancel_state_ref(cancel_state *state) noexcept : state_(state) {}
+    ~cancel_state_ref() {
+        reset();
+    }
+
+    cancel_state_ref(const cancel_state_ref& other) noexcept
+        : state_(other.state_) {
+        if (state_ != nullptr) {
+            state_->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    cancel_state_ref& operator=(const cancel_state_ref& other) noexcept {
+        if (this != &other) {
+            cancel_state_ref copy{other};
+            std::swap(state_, copy.state_);
+        }
+        return *this;
+    }
+    cancel_state_ref(cancel_state_ref&& other) noexcept
+        : state_(std::exchange(other.state_, nullptr)) {}
+    cancel_state_ref& operator=(cancel_state_ref&& other) noexcept {
+        if (this != &other) {
+            reset();
+            state_ = std::exchange(other.state_, nullptr);
+        }
+        return *this;
+    }
+
+    void reset() noexcept {
+        if (state_ != nullptr) {
+            cancel_state::release(std::exchange(state_, nullptr));
+        }
+    }
+
+    [[nodiscard]] cancel_state *get() const noexcept {
+        return state_;
+    }
+
+private:
+    cancel_state *state_{nullptr};
+};
+
+} // namespace detail
+
 /**
  * @brief Read-only cancellation token shared with async operations.
  */
@@ -20,15 +103,22 @@ public:
 
     /// @return `true` when associated source has requested cancellation.
     [[nodiscard]] bool stop_requested() const noexcept {
-        return state_ != nullptr && state_->load(std::memory_order_acquire);
+        return state_.get() != nullptr &&
+               state_.get()->requested.load(std::memory_order_acquire);
+    }
+
+    /// @return `true` when the token is bound to a source and can be cancelled.
+    [[nodiscard]] bool stop_possible() const noexcept {
+        return state_.get() != nullptr;
     }
 
 private:
     friend class cancel_source;
-    explicit cancel_token(std::shared_ptr<std::atomic<bool>> state)
+    friend class cancel_callback_base;
+    explicit cancel_token(detail::cancel_state_ref state) noexcept
         : state_(std::move(state)) {}
 
-    std::shared_ptr<std::atomic<bool>> state_{};
+    detail::cancel_state_ref state_{};
 };
 
 /**
@@ -37,20 +127,101 @@ private:
 class cancel_source {
 public:
     /// Construct an active source.
-    cancel_source() : state_(std::make_shared<std::atomic<bool>>(false)) {}
+    cancel_source() : state_(detail::cancel_state::acquire()) {}
 
     /// @return Token bound to this source.
     [[nodiscard]] cancel_token token() const {
         return cancel_token{state_};
     }
 
-    /// @brief Request cancellation for all tokens derived from this source.
-    void request_stop() const noexcept {
-        state_->store(true, std::memory_order_release);
+    /**
+     * @brief Request cancellation for all tokens derived from this source.
+     *
+     * Registered callbacks run synchronously on the calling thread, which
+     * may be any thread.
+     * @return `true` for the call that made the request, `false` afterwards.
+     */
+    bool request_stop() const noexcept;
+
+private:
+    detail::cancel_state_ref state_{};
+};
+
+/**
+ * @brief Type-erased part of `cancel_callback`.
+ *
+ * Mirrors `std::stop_callback`: the callback runs on the thread that calls
+ * `request_stop()`, or inline during registration when stop was already
+ * requested. Deregistration waits for a callback running on another thread
+ * to return; a callback may destroy its own registration.
+ */
+class cancel_callback_base {
+public:
+    cancel_callback_base(const cancel_callback_base&) = delete;
+    cancel_callback_base& operator=(const cancel_callback_base&) = delete;
+    cancel_callback_base(cancel_callback_base&&) = delete;
+    cancel_callback_base& operator=(cancel_callback_base&&) = delete;
+
+protected:
+    using invoke_fn = void (*)(cancel_callback_base& callback) noexcept;
+
+    explicit cancel_callback_base(invoke_fn invoke) noexcept
+        : invoke_(invoke) {}
+    ~cancel_callback_base() = default;
+
+    /// @brief Register with `token`'s source, or invoke now if already stopped.
+    void attach(const cancel_token& token) noexcept;
+    /// @brief Deregister; no-op after the callback has run.
+    void detach() noexcept;
+
+private:
+    friend class cancel_source;
+
+    invoke_fn invoke_;
+    detail::cancel_state_ref state_{};
+    cancel_callback_base *prev_{nullptr};
+    cancel_callback_base *next_{nullptr};
+    /// Set while invoked so a self-destroying callback can report it.
+    bool *destroyed_{nullptr};
+    bool registered_{false};
+};
+
+/**
+ * @brief Scoped registration of `Callback` against a `cancel_token`.
+ * @tparam Callback Nothrow-invocable callable.
+ */
+template <class Callback>
+    requires std::is_nothrow_invocable_v<Callback&>
+class cancel_callback final : private cancel_callback_base {
+public:
+    /// Register `callback`; invokes it immediately if stop was requested.
+    template <class C>
+        requires std::constructible_from<Callback, C&&>
+    explicit cancel_callback(const cancel_token& token, C&& callback) noexcept(
+        std::is_nothrow_constructible_v<Callback, C&&>)
+        : cancel_callback_base(&invoke), callback_(std::forward<C>(callback)) {
+        attach(token);
     }
 
+    /// Deregister, waiting for a concurrent invocation to finish.
+    ~cancel_callback() {
+        detach();
+    }
+
+    cancel_callback(const cancel_callback&) = delete;
+    cancel_callback& operator=(const cancel_callback&) = delete;
+    cancel_callback(cancel_callback&&) = delete;
+    cancel_callback& operator=(cancel_callback&&) = delete;
+
 private:
-    std::shared_ptr<std::atomic<bool>> state_{};
+    static void invoke(cancel_callback_base& base) noexcept {
+        static_cast<cancel_callback&>(base).callback_();
+    }
+
+    Callback callback_;
 };
 
+template <class Callback>
+cancel_callback(const cancel_token&, Callback) -> cancel_callback<Callback>;
+
 } // namespace simplenet::runtime
@@ -0,0 +1,619 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Bounded channels between coroutines: `channel` within one loop,
+ *        `mpmc_channel` across loops.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace simplenet::runtime {
+
+namespace detail {
+
+/// Intrusive FIFO of parked channel operations; `Node` supplies the links.
+template <class Node>
+class waiter_fifo {
+public:
+    [[nodiscard]] bool empty() const noexcept {
+        return head_ == nullptr;
+    }
+
+    void push_back(Node& node) noexcept {
+        node.prev = tail_;
+        node.next = nullptr;
+        if (tail_ != nullptr) {
+            tail_->next = &node;
+        } else {
+            head_ = &node;
+        }
+        tail_ = &node;
+        node.linked = true;
+    }
+
+    void erase(Node& node) noexcept {
+        if (node.prev != nullptr) {
+            node.prev->next = node.next;
+        } else {
+            head_ = node.next;
+        }
+        if (node.next != nullptr) {
+            node.next->prev = node.prev;
+        } else {
+            tail_ = node.prev;
+        }
+        node.prev = nullptr;
+        node.next = nullptr;
+        node.linked = false;
+    }
+
+    /// @return Oldest node (now unlinked), or `nullptr`.
+    [[nodiscard]] Node *pop_front() noexcept {
+        auto *node = head_;
+        if (node != nullptr) {
+            erase(*node);
+        }
+        return node;
+    }
+
+private:
+    Node *head_{nullptr};
+    Node *tail_{nullptr};
+};
+
+/// @return Scheduler of the awaiting task, or `nullptr`.
+template <class Promise>
+[[nodiscard]] scheduler *
+awaiting_scheduler(std::coroutine_handle<Promise> awaiting) noexcept {
+    if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+        return awaiting.promise().scheduler_ptr();
+    } else {
+        return nullptr;
+    }
+}
+
+/// Resume a parked operation through its loop; inline without one.
+inline void resume_parked(scheduler *owner, std::coroutine_handle<> handle) noexcept {
+    if (owner != nullptr) {
+        owner->schedule(handle);
+    } else {
+        handle.resume();
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Bounded FIFO between coroutines on one loop.
+ *
+ * `co_await send(value)` parks the sender while `capacity()` items are
+ * buffered, and `co_await receive()` parks the receiver while none are, so
+ * a fast producer is held back by its consumer. Nothing touches a
+ * descriptor or an atomic: a send to a parked receiver hands the value
+ * straight into the receiver's awaiter, and a receive from a full buffer
+ * refills it from the first parked sender. Parked operations are resumed
+ * through `scheduler::schedule()` in FIFO order.
+ *
+ * Loop thread only; use `mpmc_channel` between loops. The channel must
+ * outlive operations parked on it.
+ *
+ * @tparam T Element type; must be nothrow move-constructible.
+ */
+template <class T>
+class channel {
+    static_assert(std::is_nothrow_move_constructible_v<T>);
+
+public:
+    /// @brief Awaiter behind `send()`; yields `EPIPE` once the channel is closed.
+    class send_awaiter {
+    public:
+        send_awaiter(channel& owner, T&& value) noexcept
+            : channel_(owner), value_(std::move(value)) {}
+        ~send_awaiter() {
+            if (linked) {
+                channel_.senders_.erase(*this);
+            }
+        }
+
+        send_awaiter(const send_awaiter&) = delete;
+        send_awaiter& operator=(const send_awaiter&) = delete;
+
+        [[nodiscard]] bool await_ready() {
+            if (channel_.closed_) {
+                status_ = err<void>(make_error_from_errno(EPIPE));
+                return true;
+            }
+            return channel_.offer(value_);
+        }
+
+        template <class Promise>
+        void await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+            handle_ = awaiting;
+            owner_ = detail::awaiting_scheduler(awaiting);
+            channel_.senders_.push_back(*this);
+        }
+
+        [[nodiscard]] result<void> await_resume() noexcept {
+            return std::move(status_);
+        }
+
+        /// Queue links owned by the channel.
+        send_awaiter *prev{nullptr};
+        send_awaiter *next{nullptr};
+        bool linked{false};
+
+    private:
+        friend class channel;
+
+        channel& channel_;
+        T value_;
+        result<void> status_{ok()};
+        std::coroutine_handle<> handle_{};
+        scheduler *owner_{nullptr};
+    };
+
+    /// @brief Awaiter behind `receive()`; `std::nullopt` once closed and drained.
+    class receive_awaiter {
+    public:
+        explicit receive_awaiter(channel& owner) noexcept : channel_(owner) {}
+        ~receive_awaiter() {
+            if (linked) {
+                channel_.receivers_.erase(*this);
+            }
+        }
+
+        receive_awaiter(const receive_awaiter&) = delete;
+        receive_awaiter& operator=(const receive_awaiter&) = delete;
+
+        [[nodiscard]] bool await_ready() {
+            return channel_.take(slot_);
+        }
+
+        template <class Promise>
+        void await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+            handle_ = awaiting;
+            owner_ = detail::awaiting_scheduler(awaiting);
+            channel_.receivers_.push_back(*this);
+        }
+
+        [[nodiscard]] std::optional<T> await_resume() noexcept {
+            return std::move(slot_);
+        }
+
+        /// Queue links owned by the channel.
+        receive_awaiter *prev{nullptr};
+        receive_awaiter *next{nullptr};
+        bool linked{false};
+
+    private:
+        friend class channel;
+
+        channel& channel_;
+        std::optional<T> slot_{};
+        std::coroutine_handle<> handle_{};
+        scheduler *owner_{nullptr};
+    };
+
+    /// @brief Construct a channel buffering up to `capacity` items (at least 1).
+    explicit channel(std::size_t capacity)
+        : slots_(capacity == 0U ? 1U : capacity) {}
+    ~channel() = default;
+
+    channel(const channel&) = delete;
+    channel& operator=(const channel&) = delete;
+    channel(channel&&) = delete;
+    channel& operator=(channel&&) = delete;
+
+    /// @return Awaiter that delivers `value`, parking while the buffer is full.
+    [[nodiscard]] send_awaiter send(T value) noexcept {
+        return send_awaiter{*this, std::move(value)};
+    }
+
+    /// @return Awaiter for the next item, parking while none is buffered.
+    [[nodiscard]] receive_awaiter receive() noexcept {
+        return receive_awaiter{*this};
+    }
+
+    /**
+     * @brief Deliver `value` without parking.
+     * @return `false`, leaving `value` untouched, when full or closed.
+     */
+    [[nodiscard]] bool try_send(T&& value) {
+        return !closed_ && offer(value);
+    }
+
+    /// @return The next buffered item, or `std::nullopt` when none is.
+    [[nodiscard]] std::optional<T> try_receive() {
+        std::optional<T> item;
+        (void)take(item);
+        return item;
+    }
+
+    /**
+     * @brief Refuse further sends and wake every parked operation.
+     *
+     * Parked senders resume with `EPIPE`; receivers drain what is buffered,
+     * then get `std::nullopt`.
+     */
+    void close() noexcept {
+        closed_ = true;
+        while (auto *sender = senders_.pop_front()) {
+            sender->status_ = err<void>(make_error_from_errno(EPIPE));
+            detail::resume_parked(sender->owner_, sender->handle_);
+        }
+        while (auto *receiver = receivers_.pop_front()) {
+            detail::resume_parked(receiver->owner_, receiver->handle_);
+        }
+    }
+
+    /// @return `true` after `close()`.
+    [[nodiscard]] bool closed() const noexcept {
+        return closed_;
+    }
+    /// @return Buffered item count.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+    /// @return Items buffered before senders park.
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return slots_.size();
+    }
+
+private:
+    /// Move `value` to a parked receiver or the buffer; `false` when full.
+    [[nodiscard]] bool offer(T& value) {
+        if (auto *receiver = receivers_.pop_front()) {
+            receiver->slot_.emplace(std::move(value));
+            detail::resume_parked(receiver->owner_, receiver->handle_);
+            return true;
+        }
+        if (size_ == slots_.size()) {
+            return false;
+        }
+        slots_[(head_ + size_) % slots_.size()].emplace(std::move(value));
+        ++size_;
+        return true;
+    }
+
+    /// Fill `item` from the buffer; `false` when the receiver must park.
+    [[nodiscard]] bool take(std::optional<T>& item) {
+        if (size_ != 0U) {
+            auto& front = slots_[head_];
+            item.emplace(std::move(*front));
+            front.reset();
+            head_ = (head_ + 1U) % slots_.size();
+            --size_;
+            // The buffer was full: let the first parked sender in.
+            if (auto *sender = senders_.pop_front()) {
+                (void)offer(sender->value_);
+                detail::resume_parked(sender->owner_, sender->handle_);
+            }
+            return true;
+        }
+        return closed_;
+    }
+
+    std::vector<std::optional<T>> slots_;
+    std::size_t head_{0};
+    std::size_t size_{0};
+    detail::waiter_fifo<send_awaiter> senders_{};
+    detail::waiter_fifo<receive_awaiter> receivers_{};
+    bool closed_{false};
+};
+
+/**
+ * @brief Bounded multi-producer, multi-consumer channel between loops.
+ *
+ * Items pass through a lock-free ring (Vyukov's bounded queue): each slot
+ * carries a sequence number, and the producer and consumer indices sit on
+ * their own cache lines, so `try_send()`/`try_receive()` cost one
+ * compare-exchange each and never take a lock. Only operations that must
+ * park take the waiter mutex: a parked coroutine holds
+ * `scheduler::retain_external()` and is woken through `post_wakeup()` on
+ * its own loop, so no descriptor is involved beyond the loop's wake-up.
+ * A woken operation retries, and parks again if another consumer or
+ * producer got there first.
+ *
+ * `send()` and `receive()` are tasks and must run on a loop; their frames
+ * come from the loop thread's frame pool. The channel must outlive them.
+ *
+ * @tparam T Element type; must be nothrow move-constructible.
+ */
+template <class T>
+class mpmc_channel {
+    static_assert(std::is_nothrow_move_constructible_v<T>);
+
+    struct cell {
+        std::atomic<std::size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    /// One parked `send()` or `receive()`, living in its task's frame.
+    struct parked_waiter {
+        parked_waiter *prev{nullptr};
+        parked_waiter *next{nullptr};
+        bool linked{false};
+        /// Set, under the mutex, once a waker has posted `wakeup`.
+        bool posted{false};
+        /// Loop-thread flag: holding `retain_external()`.
+        bool armed{false};
+        remote_wakeup wakeup{};
+        std::coroutine_handle<> handle{};
+        scheduler *owner{nullptr};
+    };
+
+    struct waiter_list {
+        detail::waiter_fifo<parked_waiter> fifo{};
+        std::atomic<std::size_t> count{0};
+    };
+
+    /// Park until `list` is woken, unless `ready()` turns true meanwhile.
+    class park_awaiter {
+    public:
+        park_awaiter(mpmc_channel& owner, waiter_list& list, bool receiving) noexcept
+            : channel_(owner), list_(list), receiving_(receiving) {}
+
+        ~park_awaiter() {
+            if (!waiter_.armed) {
+                return;
+            }
+            // Destroyed while parked, e.g. at loop teardown.
+            const std::lock_guard lock{channel_.mutex_};
+            if (waiter_.linked) {
+                list_.fifo.erase(waiter_);
+                list_.count.fetch_sub(1, std::memory_order_relaxed);
+            } else if (waiter_.posted) {
+                waiter_.owner->withdraw_wakeup(waiter_.wakeup);
+            }
+            waiter_.owner->release_external();
+        }
+
+        park_awaiter(const park_awaiter&) = delete;
+        park_awaiter& operator=(const park_awaiter&) = delete;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <class Promise>
+        bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+            auto *owner = detail::awaiting_scheduler(awaiting);
+            if (owner == nullptr) {
+                // No loop to wake us: retry at once.
+                return false;
+            }
+            waiter_.handle = awaiting;
+            waiter_.owner = owner;
+            waiter_.wakeup.run = &resume_waiter;
+            waiter_.wakeup.context = &waiter_;
+
+            const std::lock_guard lock{channel_.mutex_};
+            list_.fifo.push_back(waiter_);
+            list_.count.fetch_add(1, std::memory_order_relaxed);
+            // Pairs with the fence in `wake_one()`: either the waker sees
+            // this waiter, or this check sees the waker's item or slot.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const bool ready = channel_.closed_.load(std::memory_order_acquire) ||
+                               (receiving_ ? channel_.readable()
+                                           : channel_.writable());
+            if (ready) {
+                list_.fifo.erase(waiter_);
+                list_.count.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            owner->retain_external();
+            waiter_.armed = true;
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        static void resume_waiter(remote_wakeup& wakeup) noexcept {
+            auto& waiter = *static_cast<parked_waiter *>(wakeup.context);
+            waiter.posted = false;
+            waiter.armed = false;
+            waiter.owner->release_external();
+            waiter.owner->schedule(waiter.handle);
+        }
+
+        mpmc_channel& channel_;
+        waiter_list& list_;
+        parked_waiter waiter_{};
+        bool receiving_;
+    };
+
+public:
+    /// @brief Construct a channel of `capacity` slots, rounded up to a power of two.
+    explicit mpmc_channel(std::size_t capacity) {
+        std::size_t slots = 2;
+        while (slots < capacity) {
+            slots *= 2U;
+        }
+        mask_ = slots - 1U;
+        cells_ = std::make_unique<cell[]>(slots);
+        for (std::size_t index = 0; index < slots; ++index) {
+            cells_[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+    ~mpmc_channel() {
+        while (try_receive().has_value()) {
+        }
+    }
+
+    mpmc_channel(const mpmc_channel&) = delete;
+    mpmc_channel& operator=(const mpmc_channel&) = delete;
+    mpmc_channel(mpmc_channel&&) = delete;
+    mpmc_channel& operator=(mpmc_channel&&) = delete;
+
+    /**
+     * @brief Deliver `value` without parking; safe from any thread.
+     * @return `false`, leaving `value` untouched, when full or closed.
+     */
+    [[nodiscard]] bool try_send(T&& value) noexcept {
+        if (closed_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        cell *target = nullptr;
+        while (true) {
+            target = &cells_[position & mask_];
+            const auto sequence = target->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+            if (lag == 0) {
+                if (enqueue_position_.compare_exchange_weak(
+                        position, position + 1U, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (static_cast<void *>(target->storage)) T(std::move(value));
+        target->sequence.store(position + 1U, std::memory_order_release);
+        wake_one(receivers_);
+        return true;
+    }
+
+    /// @return The next item, or `std::nullopt` when empty; safe from any thread.
+    [[nodiscard]] std::optional<T> try_receive() noexcept {
+        std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+        cell *source = nullptr;
+        while (true) {
+            source = &cells_[position & mask_];
+            const auto sequence = source->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - (position + 1U));
+            if (lag == 0) {
+                if (dequeue_position_.compare_exchange_weak(
+                        position, position + 1U, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return std::nullopt;
+            } else {
+                position = dequeue_position_.load(std::memory_order_relaxed);
+            }
+        }
+        auto *item = std::launder(reinterpret_cast<T *>(source->storage));
+        std::optional<T> taken{std::move(*item)};
+        item->~T();
+        source->sequence.store(position + mask_ + 1U, std::memory_order_release);
+        wake_one(senders_);
+        return taken;
+    }
+
+    /**
+     * @brief Deliver `value`, parking while the ring is full.
+     * @return `EPIPE` once the channel is closed.
+     */
+    [[nodiscard]] task<result<void>> send(T value) {
+        while (true) {
+            if (closed_.load(std::memory_order_acquire)) {
+                co_return err<void>(make_error_from_errno(EPIPE));
+            }
+            if (try_send(std::move(value))) {
+                co_return ok();
+            }
+            co_await park_awaiter{*this, senders_, false};
+        }
+    }
+
+    /// @return The next item, parking while empty; `std::nullopt` once
+    /// closed and drained.
+    [[nodiscard]] task<std::optional<T>> receive() {
+        while (true) {
+            if (auto item = try_receive()) {
+                co_return item;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                // A send may have landed just before the close.
+                co_return try_receive();
+            }
+            co_await park_awaiter{*this, receivers_, true};
+        }
+    }
+
+    /**
+     * @brief Refuse further sends and wake every parked operation; safe
+     *        from any thread. Receivers still drain buffered items.
+     */
+    void close() noexcept {
+        closed_.store(true, std::memory_order_release);
+        const std::lock_guard lock{mutex_};
+        for (auto *list : {&senders_, &receivers_}) {
+            while (auto *waiter = list->fifo.pop_front()) {
+                list->count.fetch_sub(1, std::memory_order_relaxed);
+                post_locked(*waiter);
+            }
+        }
+    }
+
+    /// @return `true` after `close()`.
+    [[nodiscard]] bool closed() const noexcept {
+        return closed_.load(std::memory_order_acquire);
+    }
+    /// @return Slots in the ring.
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return mask_ + 1U;
+    }
+
+private:
+    /// @return `true` when the next receive would find an item.
+    [[nodiscard]] bool readable() const noexcept {
+        const auto position = dequeue_position_.load(std::memory_order_relaxed);
+        return cells_[position & mask_].sequence.load(std::memory_order_acquire) ==
+               position + 1U;
+    }
+
+    /// @return `true` when the next send would find a free slot.
+    [[nodiscard]] bool writable() const noexcept {
+        const auto position = enqueue_position_.load(std::memory_order_relaxed);
+        return cells_[position & mask_].sequence.load(std::memory_order_acquire) ==
+               position;
+    }
+
+    void wake_one(waiter_list& list) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (list.count.load(std::memory_order_relaxed) == 0U) {
+            return;
+        }
+        const std::lock_guard lock{mutex_};
+        if (auto *waiter = list.fifo.pop_front()) {
+            list.count.fetch_sub(1, std::memory_order_relaxed);
+            post_locked(*waiter);
+        }
+    }
+
+    /// Posting under the mutex keeps a parked frame alive until it is done.
+    static void post_locked(parked_waiter& waiter) noexcept {
+        waiter.posted = true;
+        waiter.owner->post_wakeup(waiter.wakeup);
+    }
+
+    std::unique_ptr<cell[]> cells_{};
+    std::size_t mask_{0};
+    alignas(64) std::atomic<std::size_t> enqueue_position_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_position_{0};
+    alignas(64) std::mutex mutex_{};
+    waiter_list senders_{};
+    waiter_list receivers_{};
+    std::atomic<bool> closed_{false};
+};
+
+} // namespace simplenet::runtime
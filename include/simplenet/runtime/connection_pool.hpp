@@ -0,0 +1,195 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Keep-alive pool of outbound TCP connections keyed by address.
+ */
+
+#include "simplenet/blocking/endpoint.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+namespace simplenet::runtime {
+
+namespace detail {
+
+struct pool_host;
+
+/// Hashes the address bytes, so equal `socket_address`es share a bucket.
+struct socket_address_hash {
+    [[nodiscard]] std::size_t
+    operator()(const simplenet::blocking::socket_address& address) const noexcept;
+};
+
+} // namespace detail
+
+/**
+ * @brief Limits applied by `connection_pool` to each remote address.
+ */
+struct connection_pool_options {
+    /// Idle connections kept per address; further returns are closed.
+    std::size_t max_idle_per_host{8};
+    /// Leased plus connecting sockets per address; `acquire()` queues past it.
+    std::size_t max_active_per_host{64};
+    /// An idle connection unused for this long is closed.
+    std::chrono::milliseconds idle_timeout{std::chrono::seconds{30}};
+    /// Socket options for new connections.
+    simplenet::nonblocking::socket_options socket{};
+};
+
+/// Counters kept by one `connection_pool`.
+struct connection_pool_stats {
+    /// Connections opened with `async_connect`.
+    std::uint64_t connects{0};
+    /// Leases served from an idle connection.
+    std::uint64_t reuses{0};
+    /// Idle connections the checkout health check found closed or dirty.
+    std::uint64_t stale{0};
+    /// Idle connections closed by the idle timer.
+    std::uint64_t expired{0};
+    /// `acquire()` calls that queued for a free slot.
+    std::uint64_t waits{0};
+};
+
+class connection_pool;
+
+/**
+ * @brief Exclusive use of one pooled connection.
+ *
+ * Call `recycle()` once the connection sits at a request boundary. A lease
+ * dropped without it closes the connection, since its protocol state is
+ * unknown. Either way the address's active slot is freed.
+ */
+class pooled_connection {
+public:
+    /// Construct an empty lease.
+    pooled_connection() noexcept = default;
+    /// Close the connection unless it was recycled.
+    ~pooled_connection();
+
+    pooled_connection(const pooled_connection&) = delete;
+    pooled_connection& operator=(const pooled_connection&) = delete;
+    pooled_connection(pooled_connection&& other) noexcept;
+    pooled_connection& operator=(pooled_connection&& other) noexcept;
+
+    /// @return The leased stream.
+    [[nodiscard]] simplenet::nonblocking::tcp_stream& stream() noexcept {
+        return stream_;
+    }
+    /// @return `true` when the lease came from an idle connection.
+    [[nodiscard]] bool reused() const noexcept {
+        return reused_;
+    }
+    /// @return `true` while the lease holds a connection.
+    [[nodiscard]] bool valid() const noexcept {
+        return host_ != nullptr;
+    }
+
+    /// @brief Return the connection to the pool's idle list.
+    void recycle() noexcept;
+    /// @brief Close the connection now.
+    void discard() noexcept;
+
+private:
+    friend class connection_pool;
+
+    pooled_connection(connection_pool& pool, detail::pool_host& host,
+                      simplenet::nonblocking::tcp_stream stream,
+                      bool reused) noexcept;
+    void release(bool reusable) noexcept;
+
+    connection_pool *pool_{nullptr};
+    detail::pool_host *host_{nullptr};
+    simplenet::nonblocking::tcp_stream stream_{};
+    bool reused_{false};
+};
+
+/**
+ * @brief Reuses outbound TCP connections across requests.
+ *
+ * `acquire()` hands out a healthy idle connection to the address when one
+ * exists. Otherwise it opens a new one while the address is under
+ * `max_active_per_host`, or queues until a lease is recycled or dropped.
+ * Idle connections are checked with a `MSG_PEEK` read at checkout. A
+ * connection the peer closed, or one holding unread bytes, is dropped.
+ *
+ * Idle expiry runs on the loop's timer. The armed timer keeps `run()`
+ * going while idle connections remain, so call `close_idle()` to let the
+ * loop finish early. Use the pool from one loop thread. It must not
+ * outlive that loop or its leases.
+ */
+class connection_pool {
+public:
+    /// Construct an empty pool.
+    explicit connection_pool(connection_pool_options options = {}) noexcept;
+    /// Close idle connections and disarm the idle timer.
+    ~connection_pool();
+
+    connection_pool(const connection_pool&) = delete;
+    connection_pool& operator=(const connection_pool&) = delete;
+    connection_pool(connection_pool&&) = delete;
+    connection_pool& operator=(connection_pool&&) = delete;
+
+    /**
+     * @brief Lease a connection to `remote`.
+     * @param remote Destination address.
+     * @param token Cancels a queued wait with `ECANCELED`.
+     * @return The lease, or the `async_connect` error.
+     */
+    [[nodiscard]] task<result<pooled_connection>>
+    acquire(const simplenet::blocking::socket_address& remote,
+            cancel_token token = {});
+
+    /// @return Idle connections held for `remote`.
+    [[nodiscard]] std::size_t
+    idle_count(const simplenet::blocking::socket_address& remote) const noexcept;
+    /// @return Leased and connecting sockets for `remote`.
+    [[nodiscard]] std::size_t active_count(
+        const simplenet::blocking::socket_address& remote) const noexcept;
+    /// @return Pool counters since construction.
+    [[nodiscard]] connection_pool_stats stats() const noexcept;
+    /// @brief Close every idle connection and disarm the idle timer.
+    void close_idle() noexcept;
+
+private:
+    friend class pooled_connection;
+    class slot_awaitable;
+    class idle_wait_awaitable;
+
+    [[nodiscard]] std::optional<pooled_connection>
+    take_idle(detail::pool_host& host) noexcept;
+    void release(detail::pool_host& host,
+                 simplenet::nonblocking::tcp_stream stream,
+                 bool reusable) noexcept;
+    void wake_one(detail::pool_host& host) noexcept;
+    void expire_idle(std::chrono::steady_clock::time_point now) noexcept;
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point>
+    next_expiry() const noexcept;
+    void start_reaper() noexcept;
+    void stop_reaper() noexcept;
+    task<void> reap();
+
+    connection_pool_options options_{};
+    connection_pool_stats stats_{};
+    // No default member initializer: it would need `pool_host` complete.
+    std::unordered_map<simplenet::blocking::socket_address,
+                       std::unique_ptr<detail::pool_host>,
+                       detail::socket_address_hash>
+        hosts_;
+    scheduler *scheduler_{nullptr};
+    timer_operation idle_timer_{};
+    std::coroutine_handle<> reaper_{};
+    /// The reaper's wait while it is suspended on `idle_timer_`.
+    idle_wait_awaitable *idle_wait_{nullptr};
+};
+
+} // namespace simplenet::runtime
@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Native DNS stub resolver that runs on the event loop.
+ */
+
+#include "simplenet/blocking/endpoint.hpp"
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/// Nameservers honoured from a `resolv.conf`, as in glibc.
+inline constexpr std::size_t dns_max_nameservers = 3;
+
+/**
+ * @brief Settings for `async_dns_resolve()`.
+ */
+struct dns_options {
+    /// Servers tried in order; empty means the `/etc/resolv.conf` list.
+    std::vector<simplenet::blocking::socket_address> nameservers{};
+    /// Wait for answers from one server before moving to the next.
+    std::chrono::milliseconds timeout{std::chrono::seconds{5}};
+    /// Passes over the server list before giving up with `ETIMEDOUT`.
+    int attempts{2};
+};
+
+/**
+ * @brief Parse `nameserver` and `options timeout:/attempts:` lines.
+ *
+ * At most `dns_max_nameservers` servers are kept. A file with none yields
+ * `127.0.0.1:53`, matching glibc.
+ * @param path File to read.
+ * @return Parsed settings, or the `open` error.
+ */
+[[nodiscard]] result<dns_options>
+load_resolv_conf(const std::string& path = "/etc/resolv.conf");
+
+/**
+ * @brief Resolve `host` by querying DNS servers over UDP from this loop.
+ *
+ * Sends the A and AAAA queries together on one socket and waits on the
+ * event loop, so no thread is involved and a stop request ends the lookup
+ * immediately. A truncated UDP answer is fetched again over TCP. IPv6
+ * results come before IPv4 results.
+ *
+ * A literal address is returned without a query. The name is queried as
+ * given: `search` domains and `/etc/hosts` are not consulted, so use
+ * `async_resolve_addresses()` when those are needed.
+ * @param host Hostname or literal address.
+ * @param service Numeric port.
+ * @param family `AF_UNSPEC` (A and AAAA), `AF_INET` or `AF_INET6`.
+ * @param options Servers and timeouts; defaults come from `/etc/resolv.conf`,
+ * read once and reused.
+ * @param token Optional cancellation token.
+ * @return `ENOENT` for unknown names or names without addresses, `EINVAL`
+ * for malformed names or ports, `ETIMEDOUT` when no server answered.
+ */
+[[nodiscard]] task<result<std::vector<simplenet::blocking::socket_address>>>
+async_dns_resolve(std::string host, std::string service, int family = AF_UNSPEC,
+                  dns_options options = {}, cancel_token token = {});
+
+} // namespace simplenet::runtime
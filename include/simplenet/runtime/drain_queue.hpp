@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Loop-thread intrusive queue of drain hooks for event loops.
+ */
+
+#include "simplenet/runtime/task.hpp"
+
+#include <cstddef>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief FIFO of `drain_hook` nodes, touched only by the owning loop thread.
+ *
+ * Nodes are linked in place, so deferring never allocates.
+ */
+class drain_queue {
+public:
+    drain_queue() noexcept = default;
+    ~drain_queue() = default;
+
+    drain_queue(const drain_queue&) = delete;
+    drain_queue& operator=(const drain_queue&) = delete;
+    drain_queue(drain_queue&&) = delete;
+    drain_queue& operator=(drain_queue&&) = delete;
+
+    /**
+     * @brief Append `hook` unless it is already queued.
+     * @return `true` when `hook` was appended.
+     */
+    bool push(drain_hook& hook) noexcept;
+    /// @brief Unlink `hook` if it is still queued.
+    void withdraw(drain_hook& hook) noexcept;
+    /// @return Oldest queued hook (now unlinked), or `nullptr`.
+    [[nodiscard]] drain_hook *pop() noexcept;
+    /// @return Number of queued hooks.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+    /// @return `true` when nothing is queued.
+    [[nodiscard]] bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+private:
+    std::size_t size_{0};
+    drain_hook *head_{nullptr};
+    drain_hook *tail_{nullptr};
+};
+
+} // namespace simplenet::runtime
@@ -9,6 +9,7 @@
 #include "simplenet/runtime/task.hpp"
 #include "simplenet/runtime/uring_event_loop.hpp"
 
+#include <cerrno>
 #include <cstdint>
 #include <optional>
 #include <utility>
@@ -24,6 +25,12 @@ public:
     enum class backend {
         epoll,
         io_uring,
+        /**
+         * `io_uring` when `uring::cached_support().runtime_ready()` and the
+         * ring comes up, `epoll` otherwise. `selected_backend()` reports
+         * the outcome.
+         */
+        automatic,
     };
 
     /**
@@ -33,20 +40,33 @@ public:
      */
     explicit engine(backend choice = backend::epoll,
                     std::uint32_t uring_queue_depth = 256);
+    /**
+     * @brief Construct engine with explicit `io_uring` setup options.
+     * @param choice Backend implementation to use.
+     * @param uring Ring options, ignored for `epoll`.
+     */
+    engine(backend choice, const uring_options& uring);
 
     engine(const engine&) = delete;
     engine& operator=(const engine&) = delete;
     engine(engine&&) = delete;
     engine& operator=(engine&&) = delete;
 
-    /// @return Active backend selected at construction.
+    /// @return Backend in use; never `automatic`.
     [[nodiscard]] backend selected_backend() const noexcept;
+    /**
+     * @brief Backend `automatic` would pick on this host.
+     * @return `choice` itself unless it is `automatic`.
+     */
+    [[nodiscard]] static backend resolve(backend choice) noexcept;
     /// @return `true` when backend initialization succeeded.
     [[nodiscard]] bool valid() const noexcept;
     /// @brief Run active backend loop.
     [[nodiscard]] result<void> run() noexcept;
     /// @brief Request active backend loop to stop.
     void stop() noexcept;
+    /// @return Scheduler of the active backend, or `nullptr` if none.
+    [[nodiscard]] scheduler *active_scheduler() noexcept;
 
     /**
      * @brief Spawn a root task on the active backend.
@@ -65,6 +85,36 @@ public:
         }
     }
 
+    /**
+     * @brief Spawn a self-destroying root task on the active backend.
+     * @see event_loop::spawn_detached
+     */
+    template <class T>
+    void spawn_detached(task<T>&& work) noexcept {
+        if (epoll_loop_.has_value()) {
+            epoll_loop_->spawn_detached(std::move(work));
+            return;
+        }
+
+        if (uring_loop_.has_value()) {
+            uring_loop_->spawn_detached(std::move(work));
+        }
+    }
+
+    /**
+     * @brief Run `work` on the active loop; safe from any thread.
+     * @param work Coroutine handle to resume or nothrow callable to invoke.
+     * @see scheduler::post
+     */
+    template <class Work>
+    [[nodiscard]] result<void> post(Work&& work) noexcept {
+        auto *active = active_scheduler();
+        if (active == nullptr) {
+            return err<void>(make_error_from_errno(EINVAL));
+        }
+        return active->post(std::forward<Work>(work));
+    }
+
 private:
     backend backend_{backend::epoll};
     std::optional<event_loop> epoll_loop_{};
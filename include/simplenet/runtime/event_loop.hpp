@@ -5,8 +5,17 @@
  * @brief Single-threaded epoll-backed scheduler implementation.
  */
 
+#include "simplenet/core/unique_fd.hpp"
 #include "simplenet/epoll/reactor.hpp"
+#include "simplenet/runtime/drain_queue.hpp"
+#include "simplenet/runtime/fd_table.hpp"
+#include "simplenet/runtime/loop_metrics.hpp"
+#include "simplenet/runtime/loop_watchdog.hpp"
 #include "simplenet/runtime/task.hpp"
+#include "simplenet/runtime/timer_wheel.hpp"
+#include "simplenet/runtime/post_queue.hpp"
+#include "simplenet/runtime/resume_budget.hpp"
+#include "simplenet/runtime/wakeup_queue.hpp"
 
 #include <atomic>
 #include <cerrno>
@@ -16,16 +25,50 @@
 #include <cstdint>
 #include <deque>
 #include <optional>
-#include <unordered_map>
+#include <span>
+#include <sys/epoll.h>
 #include <vector>
 
 namespace simplenet::runtime {
 
+/**
+ * @brief Counters describing where an `event_loop` spent its waits.
+ *
+ * `spin_time` is CPU burnt in the busy-poll phase; compare it with the
+ * latency it bought via `spin_hits`.
+ */
+struct loop_stats {
+    /// Passes through the wait phase of `run()`.
+    std::uint64_t iterations{0};
+    /// Waits that blocked (or slept until a timer) in `epoll_wait`.
+    std::uint64_t blocking_waits{0};
+    /// Nonblocking `epoll_wait` calls made while spinning.
+    std::uint64_t spin_polls{0};
+    /// Spin phases that found an event before their budget ran out.
+    std::uint64_t spin_hits{0};
+    /// Time spent spinning.
+    std::chrono::nanoseconds spin_time{0};
+    /// Current adaptive spin budget.
+    std::chrono::microseconds spin_budget{0};
+    /// Waits that filled the whole event batch.
+    std::uint64_t full_batches{0};
+    /// Current event batch size.
+    std::size_t poll_batch{0};
+    /// `epoll_ctl` calls made to register or drop descriptors.
+    std::uint64_t interest_updates{0};
+};
+
+/// Default number of events (or completions) reaped per loop wait.
+inline constexpr std::size_t default_poll_batch = 64;
+
 /**
  * @brief Coroutine scheduler/event loop backed by `epoll`.
  */
 class event_loop final : public scheduler {
 public:
+    /// Sockets are driven by readiness waits; `submit_io()` is unsupported.
+    static constexpr bool completion_io = false;
+
     /// Construct and initialize loop resources.
     event_loop() noexcept;
     /// Destroy loop and outstanding root tasks.
@@ -43,6 +86,74 @@ public:
     /// @brief Request loop shutdown.
     void stop() noexcept;
 
+    /**
+     * @brief Spin on nonblocking `epoll_wait` before blocking.
+     *
+     * When `run()` would block, it first polls for up to the current spin
+     * budget, never past the next timer deadline. The budget starts at
+     * `max_spin`, doubles after a spin that found events and halves after
+     * one that did not, down to `max_spin / 16`, so a busy loop keeps
+     * spinning and an idle one mostly sleeps. Trades CPU for wake-up
+     * latency; see `stats()`.
+     * @param max_spin Largest spin budget; `0` turns spinning off.
+     */
+    void set_busy_poll(std::chrono::microseconds max_spin) noexcept;
+    /**
+     * @brief Enable in-kernel busy polling for the loop's waits.
+     * @see simplenet::epoll::reactor::set_busy_poll
+     */
+    [[nodiscard]] result<void>
+    set_kernel_busy_poll(std::chrono::microseconds usecs,
+                         std::uint16_t budget = 0,
+                         bool prefer = false) noexcept;
+    /**
+     * @brief Set how many events one `epoll_wait` may return.
+     *
+     * With `max_size > size`, a wait that fills the batch doubles it, up
+     * to `max_size`, so a loop with many active descriptors drains them in
+     * fewer calls. Call from the loop thread.
+     * @param size Batch size; `0` is treated as `1`.
+     * @param max_size Growth limit; `0` (or `<= size`) keeps it fixed.
+     */
+    void set_poll_batch(std::size_t size, std::size_t max_size = 0) noexcept;
+    /**
+     * @brief Bound the resumes one pass over the ready queue may take.
+     *
+     * By default a pass runs until the queue is empty, so coroutines that
+     * keep rescheduling themselves (`yield()`, `schedule()`) starve I/O.
+     * Once `max_resumes` resumes or `max_time` have been spent, the loop
+     * polls without blocking, handles whatever became ready, and goes
+     * back to the queue. Call from the loop thread.
+     * @param max_resumes Resumes per pass; `0` is unlimited.
+     * @param max_time Time per pass, checked after each resume; `0` is
+     *        unlimited, otherwise each resume also reads the clock.
+     */
+    void set_resume_budget(std::size_t max_resumes,
+                           std::chrono::microseconds max_time = {}) noexcept;
+    /// @return Wait-phase counters since construction.
+    [[nodiscard]] loop_stats stats() const noexcept;
+    /// @return Instrumentation snapshot; all zero unless `metrics_enabled`.
+    [[nodiscard]] loop_metrics metrics() const noexcept;
+    /**
+     * @brief Fill the latency histograms of `metrics()`.
+     *
+     * Off by default: each resume and each loop pass then reads the clock.
+     * A no-op unless `metrics_enabled`.
+     */
+    void set_latency_sampling(bool on) noexcept;
+    /// @brief Install (or, with `nullptr`, remove) the metrics exporter.
+    void set_metrics_hook(metrics_hook *hook) noexcept;
+    /**
+     * @brief Time every resume and report those past `hook->threshold`.
+     *
+     * Off by default; while on, each resume reads the clock twice and
+     * keeps `heartbeat()` current for a `stall_monitor`. `nullptr` removes
+     * the hook. Call from the loop thread.
+     */
+    void set_watchdog(watchdog_hook *hook) noexcept;
+    /// @return Resume in progress, for `stall_monitor::watch()`.
+    [[nodiscard]] const loop_heartbeat& heartbeat() const noexcept;
+
     /**
      * @brief Spawn a root task tracked by this loop.
      * @tparam T Task result type.
@@ -56,72 +167,150 @@ public:
         }
 
         handle.promise().set_scheduler(this, true);
+        handle.promise().link().frame = handle;
         ++active_task_count_;
-        root_tasks_.push_back(handle);
+        live_roots_.push(handle.promise().link());
+        schedule(handle);
+    }
+
+    /**
+     * @brief Spawn a root task that frees its frame as soon as it finishes.
+     *
+     * Its result and any exception are discarded. Until then it is tracked
+     * like `spawn()`, so `run()` waits for it and teardown destroys it.
+     * @tparam T Task result type.
+     * @param work Task object to transfer.
+     */
+    template <class T>
+    void spawn_detached(task<T>&& work) noexcept {
+        auto handle = work.release();
+        if (!handle) {
+            return;
+        }
+
+        handle.promise().set_scheduler(this, true);
+        handle.promise().set_detached();
+        handle.promise().link().frame = handle;
+        ++active_task_count_;
+        live_roots_.push(handle.promise().link());
         schedule(handle);
     }
 
     /// @brief Queue a coroutine for resume on the loop thread.
     void schedule(std::coroutine_handle<> handle) noexcept override;
-    /// @brief Notify loop that a tracked root task has finished.
-    void on_task_completed() noexcept override;
+    /// @brief Move a finished root onto the list destroyed after its resume.
+    void on_task_completed(detail::task_link& root) noexcept override;
+    /// @brief Unlink a finished detached root before it frees itself.
+    void on_detached_completed(detail::task_link& root) noexcept override;
     /// @brief Suspend coroutine until descriptor is readable.
     [[nodiscard]] result<void>
-    wait_for_readable(int fd, std::coroutine_handle<> handle,
-                      std::optional<std::chrono::milliseconds> timeout,
+    wait_for_readable(int fd, wait_operation& operation,
+                      std::optional<std::chrono::steady_clock::time_point> deadline,
                       error timeout_error) noexcept override;
     /// @brief Suspend coroutine until descriptor is writable.
     [[nodiscard]] result<void>
-    wait_for_writable(int fd, std::coroutine_handle<> handle,
-                      std::optional<std::chrono::milliseconds> timeout,
+    wait_for_writable(int fd, wait_operation& operation,
+                      std::optional<std::chrono::steady_clock::time_point> deadline,
                       error timeout_error) noexcept override;
-    /// @brief Consume readiness/timeout result produced for a waiting coroutine.
+    /// @brief Resume a coroutine once `deadline` passes.
     [[nodiscard]] result<void>
-    consume_wait_result(std::coroutine_handle<> handle) noexcept override;
+    schedule_at(std::chrono::steady_clock::time_point deadline,
+                timer_operation& operation) noexcept override;
+    /// @brief Cancel an armed timer, resuming it with `-ECANCELED`.
+    bool cancel_timer(timer_operation& operation) noexcept override;
+    /// @brief Disarm a timer without resuming it.
+    void abandon_timer(timer_operation& operation) noexcept override;
+    /// @brief Dequeue a readiness waiter, resuming it with `ECANCELED`.
+    bool cancel_wait(int fd, bool readable,
+                     wait_operation& operation) noexcept override;
+    /// @brief Queue a callback for the loop thread; safe from any thread.
+    void post_wakeup(remote_wakeup& wakeup) noexcept override;
+    /// @brief Drop a posted callback that has not run yet.
+    void withdraw_wakeup(remote_wakeup& wakeup) noexcept override;
+    /// @brief Run `hook` after the ready queue drains, before polling.
+    [[nodiscard]] bool defer_to_drain(drain_hook& hook) noexcept override;
+    /// @brief Drop a deferred hook that has not run yet.
+    void withdraw_drain_hook(drain_hook& hook) noexcept override;
+    /// @brief Keep `run()` alive for a wake-up expected from another thread.
+    void retain_external() noexcept override;
+    /// @brief Drop one `retain_external()` hold.
+    void release_external() noexcept override;
+    /// @brief Queue posted work; safe from any thread, one wake-up per burst.
+    [[nodiscard]] bool post_work(posted_work& work) noexcept override;
 
 private:
-    struct wait_registration {
-        std::coroutine_handle<> handle{};
-        std::optional<std::chrono::steady_clock::time_point> deadline{};
-        error timeout_error = make_error_from_errno(ETIMEDOUT);
-    };
-
+    /**
+     * Stays registered for both directions once an owned-descriptor wait
+     * arms it; see `arm_waiter()`. Deadlines live in the armed operations,
+     * so an idle descriptor costs two pointers and four flags.
+     */
     struct waiter_slot {
-        wait_registration readable{};
-        wait_registration writable{};
-        std::uint32_t registered_mask{0};
+        wait_operation *readable{nullptr};
+        wait_operation *writable{nullptr};
+        bool registered{false};
+        /// Registered for raw-descriptor waits only; dropped once idle.
+        bool transient{false};
+        /// Edges reported while nobody waited in that direction.
+        bool read_edge{false};
+        bool write_edge{false};
     };
 
     [[nodiscard]] result<void>
-    arm_waiter(int fd, std::coroutine_handle<> handle, bool readable,
-               std::optional<std::chrono::milliseconds> timeout,
+    arm_waiter(int fd, wait_operation& operation, bool readable,
+               std::optional<std::chrono::steady_clock::time_point> deadline,
                error timeout_error) noexcept;
-    [[nodiscard]] result<void> refresh_interest(int fd,
-                                                waiter_slot& slot) noexcept;
+    [[nodiscard]] result<void>
+    ensure_registered(int fd, waiter_slot& slot, bool owned) noexcept;
+    void drop_transient_registration(int fd) noexcept;
+    static void on_descriptor_closed(simplenet::detail::close_listener& listener,
+                                     int fd) noexcept;
+    void forget_idle_registrations() noexcept;
+    [[nodiscard]] result<void> run_iterations() noexcept;
     void process_expired_waiters() noexcept;
+    void fail_registration(wait_operation *& registration,
+                           error reason) noexcept;
+    void complete_registration(wait_operation *& registration) noexcept;
+    void release_registration(wait_operation *& registration) noexcept;
+    void signal_wakeup() noexcept;
     void consume_wakeup() noexcept;
-    void process_ready_event(const simplenet::epoll::ready_event& event) noexcept;
-    [[nodiscard]] static std::uintptr_t
-    handle_key(std::coroutine_handle<> handle) noexcept;
+    void run_remote_wakeups() noexcept;
+    void run_drain_hooks() noexcept;
+    void run_posted_work() noexcept;
+    void process_ready_event(const ::epoll_event& event) noexcept;
+    [[nodiscard]] result<std::size_t> wait_for_events(int timeout_ms) noexcept;
+    void note_batch(std::size_t ready) noexcept;
+    void publish_metrics() noexcept;
     void cleanup_completed_roots() noexcept;
     void destroy_all_roots() noexcept;
+    static void destroy_roots(detail::task_list& roots) noexcept;
 
     simplenet::epoll::reactor reactor_{};
     std::optional<simplenet::error> init_error_{};
     std::optional<simplenet::error> loop_error_{};
 
     std::deque<std::coroutine_handle<>> ready_queue_{};
-    std::unordered_map<int, waiter_slot> waiters_{};
-    std::unordered_map<std::uintptr_t, result<void>> wait_results_{};
-    std::vector<std::coroutine_handle<>> root_tasks_{};
+    fd_table<waiter_slot> waiters_{};
+    /// Spawned roots still running, and finished ones awaiting `destroy()`.
+    detail::task_list live_roots_{};
+    detail::task_list finished_roots_{};
+    timer_wheel timers_{};
+    wakeup_queue remote_wakeups_{};
+    drain_queue drain_hooks_{};
+    post_queue posted_{};
 
+    std::vector<::epoll_event> events_{};
+    std::size_t max_poll_batch_{0};
+    loop_stats stats_{};
+    [[no_unique_address]] detail::loop_recorder recorder_{};
+    detail::stall_watch watch_{};
+    detail::resume_budget budget_{};
+    std::chrono::microseconds max_spin_{0};
     std::size_t pending_waiter_count_{0};
-    std::size_t timed_waiter_count_{0};
     std::size_t active_task_count_{0};
-    std::optional<std::chrono::steady_clock::time_point> next_deadline_{};
-    bool deadline_index_dirty_{false};
+    std::size_t external_hold_count_{0};
     std::atomic_bool stop_requested_{false};
     simplenet::unique_fd wake_fd_{};
+    simplenet::detail::close_listener close_listener_{};
 };
 
 } // namespace simplenet::runtime
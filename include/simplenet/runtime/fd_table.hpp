@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Flat descriptor-indexed slot table used by runtime event loops.
+ */
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Per-descriptor slots addressed directly by fd.
+ *
+ * Descriptors are small dense integers, so lookups are two array indexes
+ * with no hashing. Slots live in fixed-size chunks allocated on first use
+ * and never move, which keeps intrusive hooks (timer entries) inside them
+ * valid. Slots are reused rather than erased.
+ *
+ * @tparam Slot Default-constructible per-descriptor state.
+ */
+template <class Slot>
+class fd_table {
+public:
+    /// Slots per lazily allocated chunk.
+    static constexpr std::size_t chunk_size = 64;
+
+    fd_table() noexcept = default;
+    ~fd_table() = default;
+
+    fd_table(const fd_table&) = delete;
+    fd_table& operator=(const fd_table&) = delete;
+    fd_table(fd_table&&) = delete;
+    fd_table& operator=(fd_table&&) = delete;
+
+    /// @return Slot for `fd`, or `nullptr` when it was never created.
+    [[nodiscard]] Slot *find(int fd) noexcept {
+        if (fd < 0) {
+            return nullptr;
+        }
+        const auto index = static_cast<std::size_t>(fd);
+        const auto chunk = index / chunk_size;
+        if (chunk >= chunks_.size() || chunks_[chunk] == nullptr) {
+            return nullptr;
+        }
+        return &(*chunks_[chunk])[index % chunk_size];
+    }
+
+    /// @return Slot for `fd`, allocating its chunk; `nullptr` on failure.
+    [[nodiscard]] Slot *get_or_create(int fd) noexcept {
+        if (fd < 0) {
+            return nullptr;
+        }
+        const auto index = static_cast<std::size_t>(fd);
+        const auto chunk = index / chunk_size;
+        if (chunk >= chunks_.size()) {
+            chunks_.resize(chunk + 1);
+        }
+        if (chunks_[chunk] == nullptr) {
+            chunks_[chunk].reset(new (std::nothrow) chunk_type{});
+            if (chunks_[chunk] == nullptr) {
+                return nullptr;
+            }
+        }
+        return &(*chunks_[chunk])[index % chunk_size];
+    }
+
+    /// @brief Invoke `fn(Slot&)` for every allocated slot.
+    template <class Fn>
+    void for_each(Fn&& fn) noexcept {
+        for (auto& chunk : chunks_) {
+            if (chunk == nullptr) {
+                continue;
+            }
+            for (auto& slot : *chunk) {
+                fn(slot);
+            }
+        }
+    }
+
+    /// @brief Release every chunk.
+    void clear() noexcept {
+        chunks_.clear();
+    }
+
+private:
+    using chunk_type = std::array<Slot, chunk_size>;
+
+    std::vector<std::unique_ptr<chunk_type>> chunks_{};
+};
+
+} // namespace simplenet::runtime
@@ -0,0 +1,58 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Per-thread, size-class-bucketed allocator for coroutine frames.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Frame pool counters for the calling thread.
+ *
+ * Each loop runs on one thread, so these are effectively per-loop. Frames
+ * are returned to the pool of the thread that frees them.
+ */
+struct frame_pool_stats {
+    /// Frames handed out, pooled or not.
+    std::uint64_t allocations{0};
+    /// Allocations served from a free list without touching the heap.
+    std::uint64_t reuses{0};
+    /// Allocations too large for any size class (always heap).
+    std::uint64_t oversized{0};
+    /// Frames currently parked in free lists.
+    std::size_t cached_frames{0};
+    /// Bytes currently parked in free lists.
+    std::size_t cached_bytes{0};
+};
+
+/// Frames up to this many bytes are pooled.
+inline constexpr std::size_t frame_pool_max_size = 2048;
+/// Size-class granularity in bytes.
+inline constexpr std::size_t frame_pool_granularity = 64;
+
+/// @return Frame pool counters for the calling thread.
+[[nodiscard]] frame_pool_stats frame_pool_thread_stats() noexcept;
+
+/// @brief Return every frame cached by the calling thread to the heap.
+void frame_pool_trim() noexcept;
+
+namespace detail {
+
+/**
+ * @brief Allocate a coroutine frame of `size` bytes.
+ *
+ * Pooled sizes come from the calling thread's free list for their class
+ * and only fall back to `operator new` when that list is empty.
+ */
+[[nodiscard]] void *allocate_frame(std::size_t size);
+
+/// @brief Release a frame from `allocate_frame(size)`.
+void deallocate_frame(void *frame, std::size_t size) noexcept;
+
+} // namespace detail
+
+} // namespace simplenet::runtime
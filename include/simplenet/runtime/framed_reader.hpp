@@ -0,0 +1,221 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Buffered reader that splits a TCP byte stream into whole frames.
+ */
+
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/// Layout of one complete frame at the front of the buffered bytes.
+struct frame_extent {
+    /// Bytes before the payload, such as a length prefix.
+    std::size_t header{0};
+    /// Payload bytes.
+    std::size_t payload{0};
+    /// Bytes after the payload, such as a delimiter.
+    std::size_t trailer{0};
+};
+
+/**
+ * @brief Frame layout a `framed_reader` can split on.
+ *
+ * `decode(bytes)` looks at the unconsumed bytes, which always start at a
+ * frame boundary. It returns the extent of the first frame once all of it
+ * is buffered, `std::nullopt` while more bytes are needed, or an error
+ * for a malformed or oversized frame. Decoders may keep state between
+ * calls for the frame in progress, so use one per reader.
+ */
+template <class Decoder>
+concept frame_decoder = requires(Decoder& decoder, std::span<const std::byte> bytes) {
+    { decoder.decode(bytes) } -> std::same_as<result<std::optional<frame_extent>>>;
+};
+
+/**
+ * @brief Frames carrying a fixed-size unsigned length before the payload.
+ */
+struct length_prefix_decoder {
+    /// Prefix width in bytes: 1, 2, 4 or 8.
+    std::size_t header_size{4};
+    /// Network byte order when `true`, little-endian otherwise.
+    bool big_endian{true};
+    /// Longer payloads fail with `EMSGSIZE`.
+    std::size_t max_payload{16U * 1024U * 1024U};
+
+    /// @return `EINVAL` for an unsupported `header_size`.
+    [[nodiscard]] result<std::optional<frame_extent>>
+    decode(std::span<const std::byte> bytes) const noexcept;
+};
+
+/**
+ * @brief Frames prefixed by a base-128 varint length, as in protobuf
+ *        length-delimited streams.
+ */
+struct varint_prefix_decoder {
+    /// Longer payloads fail with `EMSGSIZE`.
+    std::size_t max_payload{16U * 1024U * 1024U};
+
+    /// @return `EBADMSG` for a prefix longer than 10 bytes.
+    [[nodiscard]] result<std::optional<frame_extent>>
+    decode(std::span<const std::byte> bytes) const noexcept;
+};
+
+/**
+ * @brief Frames ended by a delimiter such as `"\r\n"`.
+ *
+ * The delimiter is reported as the trailer, not part of the payload.
+ * Bytes already searched are not scanned again when more arrive. The scan
+ * tests 16 candidate offsets per step with SSE2, 32 when built with AVX2,
+ * and falls back to `memchr` otherwise.
+ */
+struct delimiter_decoder {
+    /// Frame terminator; must be non-empty and outlive the decoder.
+    std::span<const std::byte> delimiter{};
+    /// Payloads that grow past this without a delimiter fail with `EMSGSIZE`.
+    std::size_t max_payload{64U * 1024U};
+    /// Prefix of the frame in progress known not to hold the delimiter.
+    std::size_t searched{0};
+
+    /// @return `EINVAL` for an empty delimiter.
+    [[nodiscard]] result<std::optional<frame_extent>>
+    decode(std::span<const std::byte> bytes) noexcept;
+};
+
+/// One frame returned by `framed_reader::next()`.
+struct frame {
+    /// Payload bytes inside the reader's buffer.
+    std::span<const std::byte> payload{};
+    /// The whole frame, header and trailer included.
+    std::span<const std::byte> bytes{};
+};
+
+/// Buffer sizing for `framed_reader`.
+struct framed_reader_options {
+    /// Capacity allocated by the first read.
+    std::size_t initial_capacity{16U * 1024U};
+    /// The buffer doubles up to this to fit a large frame; `EMSGSIZE` past it.
+    std::size_t max_capacity{16U * 1024U * 1024U + 64U};
+    /**
+     * Free the buffer whenever every buffered byte has been consumed, and
+     * wait with `readable_op()` before allocating it again, so an idle
+     * connection holds no read buffer. Costs an allocation per refill.
+     */
+    bool release_when_idle{false};
+};
+
+/**
+ * @brief Reads whole frames from a stream into one contiguous buffer.
+ *
+ * Each refill is a single read of all the free buffer space, so one
+ * syscall can bring in many pipelined frames, which later `next()` calls
+ * return without touching the socket. Frames are handed out as views into
+ * the buffer, with no copy. A view stays valid until the next `next()`
+ * call. Consumed bytes are dropped by sliding the unread tail to the
+ * front when the free space runs low.
+ *
+ * The stream is borrowed and must outlive the reader. Writes on the same
+ * stream are unaffected.
+ */
+class framed_reader {
+public:
+    /// Construct a reader over `stream`.
+    explicit framed_reader(simplenet::nonblocking::tcp_stream& stream,
+                           framed_reader_options options = {});
+
+    framed_reader(const framed_reader&) = delete;
+    framed_reader& operator=(const framed_reader&) = delete;
+    framed_reader(framed_reader&&) noexcept = default;
+    framed_reader& operator=(framed_reader&&) noexcept = default;
+    ~framed_reader() = default;
+
+    /**
+     * @brief Return the next whole frame, reading from the socket only when
+     *        the buffered bytes hold none.
+     * @return The frame; `std::nullopt` when the peer closed between frames;
+     *         `ECONNRESET` when it closed mid-frame; `EMSGSIZE` when a frame
+     *         exceeds `max_capacity`; or the decoder's error.
+     */
+    template <frame_decoder Decoder>
+    [[nodiscard]] task<result<std::optional<frame>>> next(Decoder& decoder) {
+        release();
+        while (true) {
+            auto found = decoder.decode(buffered());
+            if (!found.has_value()) {
+                co_return err<std::optional<frame>>(found.error());
+            }
+            if (found.value().has_value()) {
+                co_return take(*found.value());
+            }
+
+            const auto filled = co_await fill();
+            if (!filled.has_value()) {
+                co_return err<std::optional<frame>>(filled.error());
+            }
+            if (filled.value() == 0U) {
+                if (buffered().empty()) {
+                    co_return std::optional<frame>{};
+                }
+                co_return err<std::optional<frame>>(make_error_from_errno(ECONNRESET));
+            }
+        }
+    }
+
+    /**
+     * @return Bytes read past the last returned frame. A parser may look
+     *         ahead here, such as for a pipelined request, without a copy.
+     */
+    [[nodiscard]] std::span<const std::byte> buffered() const noexcept;
+    /// @return Current buffer capacity; `0` before the first read and while
+    ///         released by `release_when_idle`.
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    /// @return Socket reads issued so far.
+    [[nodiscard]] std::uint64_t reads() const noexcept;
+
+private:
+    /// Drop the frame returned by the previous `next()`.
+    void release() noexcept;
+    [[nodiscard]] result<std::optional<frame>> take(const frame_extent& extent) noexcept;
+    /// Make room, then read once into all free space. `0` means end of stream.
+    [[nodiscard]] task<result<std::size_t>> fill();
+
+    simplenet::nonblocking::tcp_stream *stream_;
+    framed_reader_options options_;
+    std::vector<std::byte> buffer_;
+    /// Unread bytes are `[begin_, end_)`.
+    std::size_t begin_{0};
+    std::size_t end_{0};
+    /// Length of the frame returned last, consumed by the next call.
+    std::size_t pending_{0};
+    std::uint64_t reads_{0};
+};
+
+/**
+ * @brief Read up to and including the next `delimiter`, as for text
+ *        protocols such as HTTP headers or RESP lines.
+ *
+ * Partial reads resume the search where it stopped, so a long line costs
+ * one pass over its bytes. The bytes of `delimiter` must stay valid until
+ * the call completes.
+ * @param reader Buffered reader over the stream.
+ * @param delimiter Terminator, such as `"\r\n"`; `EINVAL` when empty.
+ * @param max_line Longest payload before `EMSGSIZE`.
+ * @return The line as a `frame` whose payload excludes the delimiter, or
+ *         the `framed_reader::next()` outcomes.
+ */
+[[nodiscard]] task<result<std::optional<frame>>>
+async_read_until(framed_reader& reader, std::string_view delimiter,
+                 std::size_t max_line = 64U * 1024U);
+
+} // namespace simplenet::runtime
@@ -0,0 +1,166 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Contract for loops chosen at build time, and awaitables that call
+ *        them without virtual dispatch.
+ */
+
+#include "simplenet/runtime/loop_metrics.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <coroutine>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief A single-threaded loop usable as `basic_io_context`'s backend.
+ *
+ * The class must be `final`, so that calls made through it bind directly
+ * instead of through the `scheduler` vtable, and must say at compile time
+ * whether it completes socket I/O itself (`completion_io`).
+ */
+template <class Backend>
+concept io_backend =
+    std::derived_from<Backend, scheduler> && std::is_final_v<Backend> &&
+    std::same_as<std::remove_cv_t<decltype(Backend::completion_io)>, bool> &&
+    requires(Backend& loop, const Backend& view, task<void> work, int fd,
+             wait_operation& operation) {
+        { view.valid() } -> std::same_as<bool>;
+        { loop.run() } -> std::same_as<result<void>>;
+        loop.stop();
+        loop.spawn(std::move(work));
+        loop.spawn_detached(std::move(work));
+        { view.metrics() } -> std::same_as<loop_metrics>;
+        {
+            loop.wait_for_readable(fd, operation, std::nullopt,
+                                   make_error_from_errno(ETIMEDOUT))
+        } -> std::same_as<result<void>>;
+        {
+            loop.wait_for_writable(fd, operation, std::nullopt,
+                                   make_error_from_errno(ETIMEDOUT))
+        } -> std::same_as<result<void>>;
+    };
+
+/// An `io_backend` whose sockets complete through `submit_io()`.
+template <class Backend>
+concept completion_backend =
+    io_backend<Backend> && Backend::completion_io &&
+    requires(Backend& loop, io_operation& operation) {
+        { loop.submit_io(operation) } -> std::same_as<result<void>>;
+    };
+
+/**
+ * @brief Readiness wait armed directly on a known `Backend`.
+ *
+ * Same outcome as `wait_readable()` / `wait_writable()`, but the loop is
+ * named by type rather than read from the awaiting task, so the arm call
+ * binds statically. The awaiting coroutine must run on that loop;
+ * otherwise the result is `EINVAL`. Pass `retry` right after `EAGAIN` on
+ * a descriptor a `unique_fd` owns; see `wait_operation::owned_fd`.
+ */
+template <io_backend Backend> class readiness_awaitable {
+public:
+    readiness_awaitable(
+        Backend& loop, int fd, bool readable,
+        std::optional<std::chrono::steady_clock::time_point> deadline =
+            std::nullopt,
+        bool retry = false) noexcept
+        : loop_(loop), deadline_(deadline), fd_(fd), readable_(readable) {
+        operation_.after_would_block = retry;
+        operation_.owned_fd = retry;
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            if (handle.promise().scheduler_ptr() == &loop_) {
+                operation_.handle = handle;
+                const auto timeout = make_error_from_errno(ETIMEDOUT);
+                status_ = readable_ ? loop_.wait_for_readable(fd_, operation_,
+                                                              deadline_, timeout)
+                                    : loop_.wait_for_writable(fd_, operation_,
+                                                              deadline_, timeout);
+                return status_.has_value();
+            }
+        }
+        status_ = err<void>(make_error_from_errno(EINVAL));
+        return false;
+    }
+
+    [[nodiscard]] result<void> await_resume() noexcept {
+        if (!status_.has_value()) {
+            return status_;
+        }
+        return std::move(operation_.status);
+    }
+
+private:
+    Backend& loop_;
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
+    wait_operation operation_{};
+    result<void> status_{ok()};
+    int fd_;
+    bool readable_;
+};
+
+/**
+ * @brief Socket operation submitted directly to a known completion `Backend`.
+ *
+ * Yields the kernel result as `io_operation::result` does, with failures as
+ * errors. A send on a fast-open socket still in its handshake reports
+ * `EAGAIN`, so callers fall back to waiting for writability.
+ */
+template <completion_backend Backend> class submission_awaitable {
+public:
+    submission_awaitable(Backend& loop, io_operation& operation) noexcept
+        : loop_(loop), operation_(operation) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            if (handle.promise().scheduler_ptr() == &loop_) {
+                operation_.handle = handle;
+                status_ = loop_.submit_io(operation_);
+                return status_.has_value();
+            }
+        }
+        status_ = err<void>(make_error_from_errno(EINVAL));
+        return false;
+    }
+
+    [[nodiscard]] result<int> await_resume() const noexcept {
+        if (!status_.has_value()) {
+            return err<int>(status_.error());
+        }
+        if (operation_.result < 0) {
+            if (operation_.result == -EINPROGRESS &&
+                operation_.opcode == io_opcode::send) {
+                return err<int>(make_error_from_errno(EAGAIN));
+            }
+            return err<int>(make_error_from_errno(-operation_.result));
+        }
+        return operation_.result;
+    }
+
+private:
+    Backend& loop_;
+    io_operation& operation_;
+    result<void> status_{ok()};
+};
+
+} // namespace simplenet::runtime
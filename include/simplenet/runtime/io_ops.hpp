@@ -5,13 +5,19 @@
  * @brief Coroutine-based async I/O operations built on `scheduler`.
  */
 
+#include "simplenet/nonblocking/local.hpp"
 #include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/nonblocking/udp.hpp"
 #include "simplenet/runtime/cancel.hpp"
 #include "simplenet/runtime/task.hpp"
 
+#include <cerrno>
 #include <chrono>
+#include <coroutine>
 #include <cstddef>
+#include <optional>
 #include <span>
+#include <sys/uio.h>
 
 namespace simplenet::runtime {
 
@@ -25,13 +31,78 @@ wait_readable_for(int fd, std::chrono::milliseconds timeout);
 /// @brief Suspend until writable or timeout.
 [[nodiscard]] task<result<void>>
 wait_writable_for(int fd, std::chrono::milliseconds timeout);
+/// @brief Suspend until readable, the absolute deadline passes or a stop.
+[[nodiscard]] task<result<void>>
+wait_readable_until(int fd, std::chrono::steady_clock::time_point deadline,
+                    cancel_token token = {});
+/// @brief Suspend until writable, the absolute deadline passes or a stop.
+[[nodiscard]] task<result<void>>
+wait_writable_until(int fd, std::chrono::steady_clock::time_point deadline,
+                    cancel_token token = {});
+
+/**
+ * @brief Suspend until `fd` may hold new `MSG_ZEROCOPY` completions, the
+ *        absolute deadline passes or a stop.
+ *
+ * Completions raise `EPOLLERR`, which wakes a readiness waiter of either
+ * direction; the writable slot is used while another task waits readable.
+ * Wakes can be spurious, so reap with `tcp_stream::reap_zerocopy()` after
+ * each one.
+ */
+[[nodiscard]] task<result<void>>
+wait_zerocopy_until(int fd, std::chrono::steady_clock::time_point deadline,
+                    cancel_token token = {});
 
 /// @brief Accept one TCP connection asynchronously.
 [[nodiscard]] task<result<simplenet::nonblocking::tcp_stream>>
 async_accept(simplenet::nonblocking::tcp_listener& listener);
+/**
+ * @brief Wait for connections, then drain up to `streams.size()` of them.
+ *
+ * One readiness wait per burst on both backends, rather than one resume
+ * per connection. Accepted sockets are already nonblocking.
+ * @return Number of filled slots, at least one.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_accept_batch(simplenet::nonblocking::tcp_listener& listener,
+                   std::span<simplenet::nonblocking::tcp_stream> streams);
 /// @brief Connect to a remote endpoint asynchronously.
 [[nodiscard]] task<result<simplenet::nonblocking::tcp_stream>>
 async_connect(const simplenet::nonblocking::endpoint& endpoint);
+/**
+ * @brief Connect to a binary IPv4 or IPv6 address asynchronously.
+ *
+ * No host text is parsed, so prefer it for connect-heavy workloads.
+ * @param address Destination address.
+ * @param options Socket options applied before the SYN is sent.
+ */
+[[nodiscard]] task<result<simplenet::nonblocking::tcp_stream>>
+async_connect(const simplenet::nonblocking::socket_address& address,
+              simplenet::nonblocking::socket_options options = {});
+
+/**
+ * @brief Tuning for the Happy Eyeballs (RFC 8305) multi-address connect.
+ */
+struct happy_eyeballs_options {
+    /// Head start an attempt gets before the next address is tried too.
+    std::chrono::milliseconds attempt_delay{250};
+    /// Socket options for every attempt; `fast_open_connect` is ignored.
+    simplenet::nonblocking::socket_options socket{};
+};
+
+/**
+ * @brief Connect to the first of `candidates` that answers (RFC 8305).
+ *
+ * Address families are interleaved, starting with the family of the first
+ * candidate. A new attempt starts every `attempt_delay` while earlier ones
+ * are still in flight, or right away when one fails. The first attempt to
+ * complete wins and the others are closed, so a dead family costs at most
+ * one delay.
+ * @return The connected stream, or the last attempt's error.
+ */
+[[nodiscard]] task<result<simplenet::nonblocking::tcp_stream>>
+async_connect(std::span<const simplenet::nonblocking::socket_address> candidates,
+              happy_eyeballs_options options = {});
 
 /// @brief Read available bytes from a stream asynchronously.
 [[nodiscard]] task<result<std::size_t>>
@@ -42,6 +113,49 @@ async_read_some(simplenet::nonblocking::tcp_stream& stream,
 async_write_some(simplenet::nonblocking::tcp_stream& stream,
                  std::span<const std::byte> buffer);
 
+/**
+ * @brief Send `count` bytes of `file_fd` from `offset` without a userspace
+ * copy.
+ *
+ * The epoll backend calls `sendfile(2)` and waits for writability when the
+ * socket is full. The io_uring backend moves the bytes with
+ * `IORING_OP_SPLICE` through a private pipe. `file_fd` must stay open
+ * until the task completes.
+ * @return Bytes sent; fewer than `count` only when the file ended first.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_sendfile(simplenet::nonblocking::tcp_stream& stream, int file_fd,
+               std::uint64_t offset, std::size_t count);
+/**
+ * @brief Move up to `count` bytes from `in_fd` to `out_fd` in the kernel.
+ *
+ * One of the two must be a pipe; the other may be a socket, a file (read
+ * at its current offset) or another pipe. Waits once data and room are
+ * available, then transfers what it can, like `async_read_some`.
+ * @return Bytes moved; `0` when `in_fd` is at end of stream.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_splice(int in_fd, int out_fd, std::size_t count);
+/**
+ * @brief Read one kTLS record's plaintext, waiting until one arrives.
+ *
+ * Requires `enable_ktls_rx()`. A record larger than `buffer` is returned
+ * in several pieces with the same type.
+ */
+[[nodiscard]] task<result<simplenet::nonblocking::tls_record>>
+async_read_tls_record(simplenet::nonblocking::tcp_stream& stream,
+                      std::span<std::byte> buffer);
+/**
+ * @brief Send `bytes` as a kTLS record of `type`, waiting for room.
+ *
+ * Requires `enable_ktls_tx()`. Use it for alerts and post-handshake
+ * messages; application data can go through the ordinary write paths.
+ * @return Bytes accepted, as with `async_write_some`.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_write_tls_record(simplenet::nonblocking::tcp_stream& stream,
+                       std::uint8_t type, std::span<const std::byte> bytes);
+
 /// @brief Read exactly `buffer.size()` bytes unless an error occurs.
 [[nodiscard]] task<result<void>>
 async_read_exact(simplenet::nonblocking::tcp_stream& stream,
@@ -51,6 +165,176 @@ async_read_exact(simplenet::nonblocking::tcp_stream& stream,
 async_write_all(simplenet::nonblocking::tcp_stream& stream,
                 std::span<const std::byte> buffer);
 
+/**
+ * @brief Scatter available bytes into `buffers` asynchronously.
+ *
+ * One `recvmsg` (`IORING_OP_RECVMSG` on io_uring) fills the buffers in
+ * order. The iovec array must stay valid until the operation completes.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_readv(simplenet::nonblocking::tcp_stream& stream,
+            std::span<const ::iovec> buffers);
+/**
+ * @brief Gather `buffers` into one send asynchronously.
+ *
+ * Uses `sendmsg` (`IORING_OP_SENDMSG` on io_uring) and may write only a
+ * prefix. The iovec array must stay valid until the operation completes.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_writev(simplenet::nonblocking::tcp_stream& stream,
+             std::span<const ::iovec> buffers);
+/**
+ * @brief Write every byte described by `buffers` unless an error occurs.
+ *
+ * `buffers` is not modified; after a partial write the remainder is copied
+ * once into a private iovec list.
+ */
+[[nodiscard]] task<result<void>>
+async_writev_all(simplenet::nonblocking::tcp_stream& stream,
+                 std::span<const ::iovec> buffers);
+/**
+ * @brief Gather-write before an absolute deadline, with optional cancellation.
+ * @param stream Stream to write to.
+ * @param buffers Source iovecs.
+ * @param deadline Absolute deadline; `ETIMEDOUT` once it passes.
+ * @param token Optional cancellation token.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_writev_until(simplenet::nonblocking::tcp_stream& stream,
+                   std::span<const ::iovec> buffers,
+                   std::chrono::steady_clock::time_point deadline,
+                   cancel_token token = {});
+
+/**
+ * @brief Send `buffer` without copying it into the kernel.
+ *
+ * On io_uring this is one `IORING_OP_SEND_ZC`; elsewhere (or when the
+ * kernel lacks it) a `MSG_ZEROCOPY` send on a socket with `SO_ZEROCOPY`
+ * enabled on demand. Either way the task completes only once the kernel
+ * has released the buffer, so `buffer` may be reused right after. May
+ * send only a prefix. Use one zero-copy sender per stream at a time.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_send_zerocopy(simplenet::nonblocking::tcp_stream& stream,
+                    std::span<const std::byte> buffer);
+/**
+ * @brief `MSG_ZEROCOPY` gather-write before a deadline, with cancellation.
+ *
+ * Same as `async_writev_until`, but through
+ * `tcp_stream::write_some_zerocopy()`: the bytes stay in use after this
+ * returns, until `reap_zerocopy()` reports the send's id.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_writev_zerocopy_until(simplenet::nonblocking::tcp_stream& stream,
+                            std::span<const ::iovec> buffers,
+                            std::chrono::steady_clock::time_point deadline,
+                            cancel_token token = {});
+
+/**
+ * @brief Receive one datagram asynchronously.
+ *
+ * `IORING_OP_RECVMSG` on io_uring, `recvmsg` after readiness elsewhere.
+ * The sender comes back as a binary `socket_address`.
+ */
+[[nodiscard]] task<result<simplenet::nonblocking::udp_datagram>>
+async_recv_from(simplenet::nonblocking::udp_socket& socket,
+                std::span<std::byte> buffer);
+/**
+ * @brief Send one datagram asynchronously.
+ *
+ * `IORING_OP_SENDMSG` on io_uring, `sendto` elsewhere.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_send_to(simplenet::nonblocking::udp_socket& socket,
+              std::span<const std::byte> buffer,
+              const simplenet::nonblocking::socket_address& to);
+/**
+ * @brief Wait for datagrams, then drain up to `messages.size()` of them.
+ *
+ * One `recvmmsg` per wake-up on both backends.
+ * @return Number of filled slots, at least one.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_recv_batch(simplenet::nonblocking::udp_socket& socket,
+                 std::span<simplenet::nonblocking::udp_message> messages);
+/**
+ * @brief Send every datagram in `datagrams` with as few `sendmmsg` calls
+ * as the socket buffer allows.
+ *
+ * Waits for writability whenever the socket buffer is full.
+ * @return Datagrams sent. A failure after a partial send reports the
+ *         partial count; one before anything was sent reports the error.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_send_batch(simplenet::nonblocking::udp_socket& socket,
+                 std::span<const simplenet::nonblocking::udp_outgoing> datagrams);
+/**
+ * @brief Send `payload` as `segment_size`-byte datagrams with one
+ * `UDP_SEGMENT` `sendmsg`, waiting for writability as needed.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_send_segmented(simplenet::nonblocking::udp_socket& socket,
+                     std::span<const std::byte> payload,
+                     const simplenet::nonblocking::socket_address& to,
+                     std::uint16_t segment_size);
+/**
+ * @brief Wait for a datagram, then receive it with its GRO segment size.
+ */
+[[nodiscard]] task<result<simplenet::nonblocking::udp_coalesced>>
+async_recv_coalesced(simplenet::nonblocking::udp_socket& socket,
+                     std::span<std::byte> buffer);
+
+/// @brief Accept one Unix domain connection asynchronously.
+[[nodiscard]] task<result<simplenet::nonblocking::local_stream>>
+async_accept(simplenet::nonblocking::local_listener& listener);
+/// @brief `async_read_some` on a Unix domain socket.
+[[nodiscard]] task<result<std::size_t>>
+async_read_some(simplenet::nonblocking::local_stream& stream,
+                std::span<std::byte> buffer);
+/// @brief `async_write_some` on a Unix domain socket.
+[[nodiscard]] task<result<std::size_t>>
+async_write_some(simplenet::nonblocking::local_stream& stream,
+                 std::span<const std::byte> buffer);
+/// @brief `async_read_exact` on a Unix domain socket.
+[[nodiscard]] task<result<void>>
+async_read_exact(simplenet::nonblocking::local_stream& stream,
+                 std::span<std::byte> buffer);
+/// @brief `async_write_all` on a Unix domain socket.
+[[nodiscard]] task<result<void>>
+async_write_all(simplenet::nonblocking::local_stream& stream,
+                std::span<const std::byte> buffer);
+/// @brief `async_readv` on a Unix domain socket.
+[[nodiscard]] task<result<std::size_t>>
+async_readv(simplenet::nonblocking::local_stream& stream,
+            std::span<const ::iovec> buffers);
+/// @brief `async_writev` on a Unix domain socket.
+[[nodiscard]] task<result<std::size_t>>
+async_writev(simplenet::nonblocking::local_stream& stream,
+             std::span<const ::iovec> buffers);
+/// @brief `async_writev_all` on a Unix domain socket.
+[[nodiscard]] task<result<void>>
+async_writev_all(simplenet::nonblocking::local_stream& stream,
+                 std::span<const ::iovec> buffers);
+/**
+ * @brief Send `bytes` with descriptors attached, waiting for writability.
+ *
+ * A readiness wait then `sendmsg` on both backends; see
+ * `local_stream::send_fds()`. The descriptors may be closed once this
+ * returns.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_send_fds(simplenet::nonblocking::local_stream& stream,
+               std::span<const std::byte> bytes, std::span<const int> fds);
+/**
+ * @brief Wait for data, then read it with any descriptors sent along.
+ *
+ * See `local_stream::receive_fds()`.
+ */
+[[nodiscard]] task<result<simplenet::nonblocking::fd_message>>
+async_receive_fds(simplenet::nonblocking::local_stream& stream,
+                  std::span<std::byte> buffer,
+                  std::span<simplenet::unique_fd> fds);
+
 /**
  * @brief Asynchronous sleep with optional cancellation.
  * @param duration Sleep duration.
@@ -80,4 +364,232 @@ async_write_all(simplenet::nonblocking::tcp_stream& stream,
     simplenet::nonblocking::tcp_stream& stream, std::span<const std::byte> buffer,
     std::chrono::milliseconds timeout, cancel_token token = {});
 
+/**
+ * @brief Read before an absolute deadline, with optional cancellation.
+ *
+ * The deadline is registered once with the scheduler, so callers issuing
+ * several reads against one budget share it without re-slicing.
+ * @param stream Stream to read from.
+ * @param buffer Destination bytes.
+ * @param deadline Absolute deadline; `ETIMEDOUT` once it passes.
+ * @param token Optional cancellation token.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_read_some_until(simplenet::nonblocking::tcp_stream& stream,
+                      std::span<std::byte> buffer,
+                      std::chrono::steady_clock::time_point deadline,
+                      cancel_token token = {});
+/**
+ * @brief Write before an absolute deadline, with optional cancellation.
+ * @param stream Stream to write to.
+ * @param buffer Source bytes.
+ * @param deadline Absolute deadline; `ETIMEDOUT` once it passes.
+ * @param token Optional cancellation token.
+ */
+[[nodiscard]] task<result<std::size_t>>
+async_write_some_until(simplenet::nonblocking::tcp_stream& stream,
+                       std::span<const std::byte> buffer,
+                       std::chrono::steady_clock::time_point deadline,
+                       cancel_token token = {});
+
+namespace detail {
+
+/**
+ * @brief `wait_*_until` for a descriptor a `unique_fd` owns, armed right
+ *        after it returned `EAGAIN`.
+ *
+ * The epoll loop keeps such a descriptor registered between waits and
+ * ignores readiness it cached before the `EAGAIN`; see
+ * `wait_operation::owned_fd`.
+ */
+[[nodiscard]] task<result<void>>
+wait_after_would_block(int fd, bool readable,
+                       std::chrono::steady_clock::time_point deadline,
+                       cancel_token token = {});
+
+/// @brief Readiness wait shared by the frameless stream operations.
+class stream_wait {
+protected:
+    template <class Promise>
+    bool arm(std::coroutine_handle<Promise> handle, int fd,
+             bool readable) noexcept {
+        waited_ = true;
+        scheduler *active = nullptr;
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            active = handle.promise().scheduler_ptr();
+        }
+        if (active == nullptr) {
+            wait_.status = err<void>(make_error_from_errno(EINVAL));
+            return false;
+        }
+
+        wait_.handle = handle;
+        wait_.after_would_block = true;
+        wait_.owned_fd = true;
+        auto armed =
+            readable ? active->wait_for_readable(fd, wait_, std::nullopt,
+                                                 make_error_from_errno(ETIMEDOUT))
+                     : active->wait_for_writable(fd, wait_, std::nullopt,
+                                                 make_error_from_errno(ETIMEDOUT));
+        if (!armed.has_value()) {
+            wait_.status = std::move(armed);
+            return false;
+        }
+        return true;
+    }
+
+    /// `true` once the attempt in `await_ready()` would have blocked.
+    bool waited_{false};
+    wait_operation wait_{};
+};
+
+} // namespace detail
+
+/**
+ * @brief Frameless `async_read_some`; see `read_some_op()`.
+ */
+class read_some_operation : private detail::stream_wait {
+public:
+    read_some_operation(simplenet::nonblocking::tcp_stream& stream,
+                        std::span<std::byte> buffer) noexcept
+        : stream_(&stream), buffer_(buffer) {}
+
+    /// Tries the read; an immediate result never suspends.
+    [[nodiscard]] bool await_ready() noexcept {
+        outcome_ = stream_->read_some(buffer_);
+        return outcome_.has_value() ||
+               !simplenet::nonblocking::is_would_block(outcome_.error());
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        return arm(handle, stream_->native_handle(), true);
+    }
+
+    [[nodiscard]] result<std::size_t> await_resume() noexcept {
+        if (waited_) {
+            if (!wait_.status.has_value()) {
+                return err<std::size_t>(wait_.status.error());
+            }
+            outcome_ = stream_->read_some(buffer_);
+        }
+        return outcome_;
+    }
+
+private:
+    simplenet::nonblocking::tcp_stream *stream_;
+    std::span<std::byte> buffer_;
+    result<std::size_t> outcome_{std::size_t{0}};
+};
+
+/**
+ * @brief Frameless `async_write_some`; see `write_some_op()`.
+ */
+class write_some_operation : private detail::stream_wait {
+public:
+    write_some_operation(simplenet::nonblocking::tcp_stream& stream,
+                         std::span<const std::byte> buffer) noexcept
+        : stream_(&stream), buffer_(buffer) {}
+
+    /// Tries the write; an immediate result never suspends.
+    [[nodiscard]] bool await_ready() noexcept {
+        outcome_ = stream_->write_some(buffer_);
+        return outcome_.has_value() ||
+               !simplenet::nonblocking::is_would_block(outcome_.error());
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        return arm(handle, stream_->native_handle(), false);
+    }
+
+    [[nodiscard]] result<std::size_t> await_resume() noexcept {
+        if (waited_) {
+            if (!wait_.status.has_value()) {
+                return err<std::size_t>(wait_.status.error());
+            }
+            outcome_ = stream_->write_some(buffer_);
+        }
+        return outcome_;
+    }
+
+private:
+    simplenet::nonblocking::tcp_stream *stream_;
+    std::span<const std::byte> buffer_;
+    result<std::size_t> outcome_{std::size_t{0}};
+};
+
+/**
+ * @brief Frameless readiness wait that holds no buffer; see `readable_op()`.
+ */
+class readable_operation : private detail::stream_wait {
+public:
+    explicit readable_operation(simplenet::nonblocking::tcp_stream& stream) noexcept
+        : stream_(&stream) {}
+
+    /// Peeks the socket; pending bytes or end of stream never suspend.
+    [[nodiscard]] bool await_ready() noexcept {
+        outcome_ = stream_->check_readable();
+        return outcome_.has_value() ||
+               !simplenet::nonblocking::is_would_block(outcome_.error());
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        return arm(handle, stream_->native_handle(), true);
+    }
+
+    [[nodiscard]] result<void> await_resume() noexcept {
+        if (waited_) {
+            return std::move(wait_.status);
+        }
+        return std::move(outcome_);
+    }
+
+private:
+    simplenet::nonblocking::tcp_stream *stream_;
+    result<void> outcome_{ok()};
+};
+
+/**
+ * @brief Read available bytes without allocating a coroutine frame.
+ *
+ * The nonblocking `recv` runs in `await_ready()`, so data already queued is
+ * returned without suspending. Only on `EAGAIN` does the awaiting task
+ * register one readiness wait, after which the read is retried once. A
+ * spurious wake-up (another reader drained the socket first) therefore
+ * completes with the would-block error; `async_read_some` loops instead.
+ * Uses readiness on both backends.
+ */
+[[nodiscard]] inline read_some_operation
+read_some_op(simplenet::nonblocking::tcp_stream& stream,
+             std::span<std::byte> buffer) noexcept {
+    return read_some_operation{stream, buffer};
+}
+
+/**
+ * @brief Wait until a read on `stream` would not block, without a buffer.
+ *
+ * Idle connections can park here holding no read buffer and no coroutine
+ * frame of their own, then take a buffer, for example from a
+ * `buffer_pool`, only once bytes arrive. Readiness, end of stream and
+ * socket errors all complete the wait; the following read reports which.
+ * A spurious wake-up (another reader drained the socket first) makes that
+ * read report the would-block error.
+ */
+[[nodiscard]] inline readable_operation
+readable_op(simplenet::nonblocking::tcp_stream& stream) noexcept {
+    return readable_operation{stream};
+}
+
+/**
+ * @brief Write available bytes without allocating a coroutine frame.
+ * @see read_some_op
+ */
+[[nodiscard]] inline write_some_operation
+write_some_op(simplenet::nonblocking::tcp_stream& stream,
+              std::span<const std::byte> buffer) noexcept {
+    return write_some_operation{stream, buffer};
+}
+
 } // namespace simplenet::runtime
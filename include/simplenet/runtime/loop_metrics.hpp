@@ -0,0 +1,385 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Per-loop instrumentation: counters, latency histograms and an
+ *        export hook, all compiled out unless `SIMPLENET_ENABLE_METRICS`.
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#ifndef SIMPLENET_ENABLE_METRICS
+#define SIMPLENET_ENABLE_METRICS 0
+#endif
+
+#if SIMPLENET_ENABLE_METRICS && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+/// USDT probe `simplenet:<name>`; a single `nop` until a tracer attaches.
+#define SIMPLENET_LOOP_PROBE2(name, a, b) DTRACE_PROBE2(simplenet, name, a, b)
+#else
+#define SIMPLENET_LOOP_PROBE2(name, a, b) ((void)0)
+#endif
+
+namespace simplenet::runtime {
+
+/// `true` when the library was built with `SIMPLENET_ENABLE_METRICS=ON`.
+inline constexpr bool metrics_enabled = SIMPLENET_ENABLE_METRICS != 0;
+
+/**
+ * @brief Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 16ns get a bucket each; above that every power of two is
+ * split into 16 buckets, so any recorded value is known to within 1/16
+ * (about 6%). Values past about 4.9 hours land in the last bucket.
+ * Recording is an index computation and an increment.
+ */
+class latency_histogram {
+public:
+    /// Linear buckets per power of two.
+    static constexpr std::size_t sub_buckets = 16;
+    /// Total bucket count.
+    static constexpr std::size_t bucket_count = sub_buckets * 41;
+
+    /// @brief Count one sample of `value` (negative values count as zero).
+    void record(std::chrono::nanoseconds value) noexcept {
+        const auto ns =
+            static_cast<std::uint64_t>(std::max<std::int64_t>(value.count(), 0));
+        ++counts_[bucket_index(ns)];
+        ++count_;
+        sum_ += ns;
+        max_ = std::max(max_, ns);
+    }
+
+    /// @brief Add every sample of `other`.
+    void merge(const latency_histogram& other) noexcept {
+        for (std::size_t index = 0; index < bucket_count; ++index) {
+            counts_[index] += other.counts_[index];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    /**
+     * @brief Add bucket counts kept elsewhere, e.g. read from a copy that
+     *        another thread is still writing.
+     */
+    void merge_buckets(const std::array<std::uint64_t, bucket_count>& counts,
+                       std::chrono::nanoseconds sum,
+                       std::chrono::nanoseconds max) noexcept {
+        for (std::size_t index = 0; index < bucket_count; ++index) {
+            counts_[index] += counts[index];
+            count_ += counts[index];
+        }
+        sum_ += static_cast<std::uint64_t>(std::max<std::int64_t>(sum.count(), 0));
+        max_ = std::max(max_, static_cast<std::uint64_t>(
+                                  std::max<std::int64_t>(max.count(), 0)));
+    }
+
+    /// @brief Drop every sample.
+    void reset() noexcept {
+        *this = latency_histogram{};
+    }
+
+    /// @return Samples recorded.
+    [[nodiscard]] std::uint64_t count() const noexcept {
+        return count_;
+    }
+    /// @return Sum of all samples.
+    [[nodiscard]] std::chrono::nanoseconds sum() const noexcept {
+        return std::chrono::nanoseconds{static_cast<std::int64_t>(sum_)};
+    }
+    /// @return Largest sample, exact.
+    [[nodiscard]] std::chrono::nanoseconds max() const noexcept {
+        return std::chrono::nanoseconds{static_cast<std::int64_t>(max_)};
+    }
+    /// @return Samples in bucket `index`.
+    [[nodiscard]] std::uint64_t count_at(std::size_t index) const noexcept {
+        return counts_[index];
+    }
+
+    /**
+     * @brief Value below which `quantile` of the samples fall.
+     * @param quantile In `[0, 1]`.
+     * @return Highest value of the bucket reaching that rank, capped at
+     *         `max()`; zero when empty.
+     */
+    [[nodiscard]] std::chrono::nanoseconds
+    value_at_quantile(double quantile) const noexcept {
+        if (count_ == 0U) {
+            return std::chrono::nanoseconds{0};
+        }
+        const double clamped = std::clamp(quantile, 0.0, 1.0);
+        const auto rank = std::max<std::uint64_t>(
+            1U, static_cast<std::uint64_t>(clamped * static_cast<double>(count_) +
+                                           0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t index = 0; index < bucket_count; ++index) {
+            seen += counts_[index];
+            if (seen >= rank) {
+                const auto highest = bucket_upper_bound(index) - 1U;
+                return std::chrono::nanoseconds{
+                    static_cast<std::int64_t>(std::min(highest, max_))};
+            }
+        }
+        return max();
+    }
+
+    /// @return Smallest value, in nanoseconds, that maps to bucket `index`.
+    [[nodiscard]] static constexpr std::uint64_t
+    bucket_lower_bound(std::size_t index) noexcept {
+        if (index < sub_buckets) {
+            return index;
+        }
+        const auto shift = (index - sub_buckets) / sub_buckets;
+        const auto sub = (index - sub_buckets) % sub_buckets;
+        return static_cast<std::uint64_t>(sub_buckets + sub) << shift;
+    }
+
+    /// @return First value, in nanoseconds, past bucket `index`.
+    [[nodiscard]] static constexpr std::uint64_t
+    bucket_upper_bound(std::size_t index) noexcept {
+        if (index < sub_buckets) {
+            return index + 1U;
+        }
+        const auto shift = (index - sub_buckets) / sub_buckets;
+        return bucket_lower_bound(index) + (std::uint64_t{1} << shift);
+    }
+
+    /// @return Bucket counting samples of `ns` nanoseconds.
+    [[nodiscard]] static constexpr std::size_t
+    bucket_index(std::uint64_t ns) noexcept {
+        if (ns < sub_buckets) {
+            return static_cast<std::size_t>(ns);
+        }
+        // The top five bits pick the bucket: the leading one selects the
+        // power of two, the next four the linear step within it.
+        const auto shift = static_cast<std::size_t>(std::bit_width(ns)) - 5U;
+        const auto index = sub_buckets + shift * sub_buckets +
+                           static_cast<std::size_t>((ns >> shift) - sub_buckets);
+        return std::min(index, bucket_count - 1U);
+    }
+
+private:
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t max_{0};
+};
+
+/**
+ * @brief Instrumentation counters for one `event_loop` or `uring_event_loop`.
+ *
+ * Counters are cumulative since construction; `pending_waiters` and
+ * `timed_waiters` are sampled when the snapshot is taken. The histograms
+ * only fill while latency sampling is on, since each sample reads the
+ * clock.
+ */
+struct loop_metrics {
+    /// Passes through the wait phase (`epoll_wait` or `io_uring_enter`).
+    std::uint64_t iterations{0};
+    /// Events or completions reaped by those waits.
+    std::uint64_t events{0};
+    /// Most events a single wait returned.
+    std::uint64_t max_events_per_wait{0};
+    /// Coroutine resumes taken from the ready queue.
+    std::uint64_t resumes{0};
+    /// Deepest the ready queue has been when a resume pass began.
+    std::uint64_t ready_high_water{0};
+    /// Passes cut short by the resume budget, each followed by a poll.
+    std::uint64_t budget_polls{0};
+    /// Readiness waits, timers and completion I/O currently outstanding.
+    std::uint64_t pending_waiters{0};
+    /// Entries currently on the timer wheel.
+    std::uint64_t timed_waiters{0};
+    /// Timer-wheel entries fired: wait deadlines and `schedule_at()` timers.
+    std::uint64_t timeouts_fired{0};
+    /// `epoll_ctl` calls (epoll backend).
+    std::uint64_t interest_updates{0};
+    /// SQEs handed to the kernel (io_uring backend).
+    std::uint64_t sqes_submitted{0};
+    /// `io_uring_enter` calls that submitted SQEs (io_uring backend).
+    std::uint64_t submit_calls{0};
+    /// Busy time of one loop pass, from a wait's return to the next wait.
+    latency_histogram iteration_latency{};
+    /// Time one `resume()` ran before its coroutine suspended again.
+    latency_histogram resume_latency{};
+};
+
+/**
+ * @brief Caller-owned exporter invoked by a loop with fresh metrics.
+ *
+ * The loop calls `publish` on its own thread after a wait once `interval`
+ * has passed since the last call, and once more when `run()` returns.
+ * The hook must outlive its registration (`set_metrics_hook(nullptr)`).
+ */
+struct metrics_hook {
+    /// Receives the snapshot; copy what must outlive the call.
+    void (*publish)(const loop_metrics& metrics, void *context) noexcept {nullptr};
+    /// Opaque owner pointer passed to `publish`.
+    void *context{nullptr};
+    /// Minimum time between calls.
+    std::chrono::milliseconds interval{1000};
+};
+
+/**
+ * @brief Render `metrics` in the Prometheus text exposition format.
+ *
+ * Counters become `simplenet_loop_*_total`, gauges plain samples, and the
+ * histograms `simplenet_loop_{iteration,resume}_seconds` with one bucket
+ * per power of two; every sample carries `loop="<loop>"`.
+ */
+[[nodiscard]] std::string format_prometheus(const loop_metrics& metrics,
+                                            std::string_view loop);
+
+namespace detail {
+
+/// Records into a `loop_metrics`; the loops hold one of these.
+template <bool Enabled> class basic_loop_recorder {
+public:
+    void set_sampling(bool on) noexcept {
+        sampling_ = on;
+        pass_started_.reset();
+    }
+    [[nodiscard]] bool sampling() const noexcept {
+        return sampling_;
+    }
+    void set_hook(metrics_hook *hook) noexcept {
+        hook_ = hook;
+        next_publish_ = {};
+    }
+    [[nodiscard]] metrics_hook *hook() const noexcept {
+        return hook_;
+    }
+
+    /// Start of a pass over the ready queue.
+    void begin_resumes(std::size_t ready) noexcept {
+        metrics_.ready_high_water =
+            std::max<std::uint64_t>(metrics_.ready_high_water, ready);
+        if (sampling_) {
+            mark_ = clock::now();
+        }
+    }
+    /// A resume from the ready queue returned.
+    void resumed() noexcept {
+        ++metrics_.resumes;
+        if (sampling_) {
+            const auto now = clock::now();
+            metrics_.resume_latency.record(now - mark_);
+            mark_ = now;
+        }
+    }
+    /// About to wait; closes the pass opened by the previous `waited()`.
+    void begin_wait() noexcept {
+        if (sampling_ && pass_started_.has_value()) {
+            metrics_.iteration_latency.record(clock::now() - *pass_started_);
+        }
+    }
+    /// A wait returned `ready` events.
+    void waited(std::size_t ready) noexcept {
+        ++metrics_.iterations;
+        metrics_.events += ready;
+        metrics_.max_events_per_wait =
+            std::max<std::uint64_t>(metrics_.max_events_per_wait, ready);
+        SIMPLENET_LOOP_PROBE2(loop_wait, metrics_.iterations, ready);
+        if (sampling_) {
+            pass_started_ = clock::now();
+        }
+    }
+    /// The resume budget ended a pass with coroutines still ready.
+    void budget_spent() noexcept {
+        ++metrics_.budget_polls;
+    }
+    void timeouts_fired(std::size_t fired) noexcept {
+        metrics_.timeouts_fired += fired;
+    }
+    void interest_updated() noexcept {
+        ++metrics_.interest_updates;
+    }
+    void submitted(std::size_t sqes) noexcept {
+        metrics_.sqes_submitted += sqes;
+        ++metrics_.submit_calls;
+    }
+
+    /// @return `true` when the hook is due; `force` ignores its interval.
+    [[nodiscard]] bool publish_due(bool force) noexcept {
+        if (hook_ == nullptr || hook_->publish == nullptr) {
+            return false;
+        }
+        const auto now = clock::now();
+        if (!force && now < next_publish_) {
+            return false;
+        }
+        next_publish_ = now + hook_->interval;
+        return true;
+    }
+
+    /// @return Snapshot with the gauges filled in.
+    [[nodiscard]] loop_metrics snapshot(std::size_t pending,
+                                        std::size_t timed) const noexcept {
+        auto copy = metrics_;
+        copy.pending_waiters = pending;
+        copy.timed_waiters = timed;
+        return copy;
+    }
+
+    /// Fill the gauges in place and hand the live metrics to the hook.
+    void publish(std::size_t pending, std::size_t timed) noexcept {
+        metrics_.pending_waiters = pending;
+        metrics_.timed_waiters = timed;
+        SIMPLENET_LOOP_PROBE2(loop_metrics, &metrics_, sizeof(metrics_));
+        hook_->publish(metrics_, hook_->context);
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    loop_metrics metrics_{};
+    metrics_hook *hook_{nullptr};
+    clock::time_point next_publish_{};
+    clock::time_point mark_{};
+    std::optional<clock::time_point> pass_started_{};
+    bool sampling_{false};
+};
+
+/// Disabled build: every call is an empty inline function.
+template <> class basic_loop_recorder<false> {
+public:
+    void set_sampling(bool) noexcept {}
+    [[nodiscard]] bool sampling() const noexcept {
+        return false;
+    }
+    void set_hook(metrics_hook *) noexcept {}
+    [[nodiscard]] metrics_hook *hook() const noexcept {
+        return nullptr;
+    }
+    void begin_resumes(std::size_t) noexcept {}
+    void resumed() noexcept {}
+    void begin_wait() noexcept {}
+    void waited(std::size_t) noexcept {}
+    void budget_spent() noexcept {}
+    void timeouts_fired(std::size_t) noexcept {}
+    void interest_updated() noexcept {}
+    void submitted(std::size_t) noexcept {}
+    [[nodiscard]] bool publish_due(bool) noexcept {
+        return false;
+    }
+    [[nodiscard]] loop_metrics snapshot(std::size_t, std::size_t) const noexcept {
+        return {};
+    }
+    void publish(std::size_t, std::size_t) noexcept {}
+};
+
+using loop_recorder = basic_loop_recorder<metrics_enabled>;
+
+} // namespace detail
+
+} // namespace simplenet::runtime
@@ -0,0 +1,356 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Fixed set of per-thread runtime engines, one pinned thread each.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/engine.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Construction options for `loop_pool`.
+ */
+struct loop_pool_options {
+    /// Backend used by every loop; `automatic` is resolved once for all.
+    engine::backend selected_backend{engine::backend::epoll};
+    /// Loop count; `0` means one per placement CPU (see `cpus`).
+    std::size_t threads{0};
+    /// SQ/CQ entry count per loop when `io_uring` is selected.
+    std::uint32_t uring_queue_depth{256};
+    /// Pin loop `i` to the `i`-th placement CPU (wrapping around).
+    bool pin_threads{true};
+    /**
+     * Let idle loops steal `stealable()` work from busy ones. Loops then
+     * keep running until `stop()`, so they are around to steal.
+     */
+    bool work_stealing{false};
+    /**
+     * Placement CPUs in loop order; empty means the process affinity mask.
+     * Loop `i` runs on `cpus[i % cpus.size()]`.
+     */
+    std::vector<int> cpus{};
+    /**
+     * Keep placement CPUs on this NUMA node only, typically the NIC's
+     * (`numa::node_of_interface()`); `-1` ignores NUMA. Ignored when the
+     * node has none of the placement CPUs.
+     */
+    int numa_node{-1};
+    /**
+     * Start `io_uring` rings with SQPOLL, each kernel thread pinned to
+     * `sqpoll_cpus[i % sqpoll_cpus.size()]`, or to its loop's CPU when
+     * that list is empty.
+     */
+    bool uring_sqpoll{false};
+    /// SQPOLL thread CPUs; pick siblings on the loops' node.
+    std::vector<int> sqpoll_cpus{};
+    /**
+     * Give `listen_sharded()` listener `i` the `SO_INCOMING_CPU` of loop
+     * `i`, so the kernel prefers that listener for connections whose SYN
+     * it handles on that CPU (and the accepted sockets inherit the hint).
+     */
+    bool steer_incoming_cpu{false};
+};
+
+namespace detail {
+
+/// @brief Unit of stealable work queued on a pool loop.
+struct steal_job {
+    /// Runs the work on whichever loop thread took the job.
+    void (*run)(steal_job& job) noexcept {nullptr};
+    /// Opaque owner pointer available to `run`.
+    void *context{nullptr};
+};
+
+/**
+ * @brief Queue `job` on the calling thread's work-stealing pool loop.
+ * @return `false` when the caller is not running on such a loop.
+ */
+[[nodiscard]] bool submit_stealable(steal_job& job) noexcept;
+
+/**
+ * @brief Awaiter behind `stealable()`.
+ *
+ * Hands the child task to the pool as a `steal_job`. The child runs to
+ * completion on the thread that takes the job, and the awaiting coroutine
+ * is resumed on its home scheduler through `post_wakeup()`.
+ */
+template <class T>
+class stealable_awaiter {
+public:
+    using handle_type = typename task<T>::handle_type;
+
+    explicit stealable_awaiter(task<T>&& work) noexcept
+        : child_(work.release()) {}
+
+    ~stealable_awaiter() {
+        // Only reached with a hand-off outstanding once every pool thread
+        // has exited, so the job can no longer run.
+        if (home_ != nullptr) {
+            home_->withdraw_wakeup(return_);
+            home_->release_external();
+        }
+        if (child_) {
+            child_.destroy();
+        }
+    }
+
+    stealable_awaiter(const stealable_awaiter&) = delete;
+    stealable_awaiter& operator=(const stealable_awaiter&) = delete;
+    stealable_awaiter(stealable_awaiter&&) = delete;
+    stealable_awaiter& operator=(stealable_awaiter&&) = delete;
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return !child_ || child_.done();
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        scheduler *home = nullptr;
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            home = awaiting.promise().scheduler_ptr();
+        }
+
+        if (home != nullptr) {
+            awaiting_ = awaiting;
+            job_.run = &run_job;
+            job_.context = this;
+            return_.run = &resume_home;
+            return_.context = this;
+            home_ = home;
+            home->retain_external();
+            if (submit_stealable(job_)) {
+                return true;
+            }
+            home->release_external();
+            home_ = nullptr;
+        }
+
+        // Not on a stealing loop: run inline. The child has no scheduler,
+        // so it completes before `resume()` returns.
+        child_.resume();
+        return false;
+    }
+
+    T await_resume() {
+        if (!child_) {
+            throw std::logic_error("stealable task has no coroutine handle");
+        }
+        if constexpr (std::is_void_v<T>) {
+            child_.promise().consume_result();
+            child_.destroy();
+            child_ = {};
+        } else {
+            auto value = child_.promise().consume_result();
+            child_.destroy();
+            child_ = {};
+            return value;
+        }
+    }
+
+private:
+    static void run_job(steal_job& job) noexcept {
+        auto& self = *static_cast<stealable_awaiter *>(job.context);
+        self.child_.resume();
+        // The awaiting frame may be gone as soon as this is posted.
+        self.home_->post_wakeup(self.return_);
+    }
+
+    static void resume_home(remote_wakeup& wakeup) noexcept {
+        auto& self = *static_cast<stealable_awaiter *>(wakeup.context);
+        auto *home = std::exchange(self.home_, nullptr);
+        home->release_external();
+        home->schedule(self.awaiting_);
+    }
+
+    handle_type child_{};
+    std::coroutine_handle<> awaiting_{};
+    scheduler *home_{nullptr};
+    steal_job job_{};
+    remote_wakeup return_{};
+};
+
+} // namespace detail
+
+/**
+ * @brief Run CPU-bound `work` on whichever pool loop is free first.
+ *
+ * On a `loop_pool` with `work_stealing`, `work` is queued on the current
+ * loop, idle loops may steal it, and the awaiting coroutine resumes on its
+ * own loop afterwards, so I/O stays with the loop that owns the
+ * descriptor. `work` runs without a scheduler: I/O and timers inside it
+ * fail with `EINVAL`. Elsewhere `work` simply runs inline.
+ *
+ * @return Awaitable yielding `work`'s result.
+ */
+template <class T>
+[[nodiscard]] detail::stealable_awaiter<T> stealable(task<T>&& work) noexcept {
+    return detail::stealable_awaiter<T>{std::move(work)};
+}
+
+/**
+ * @brief Runs N independent engines, each on its own thread.
+ *
+ * Loops share nothing: a task stays on the loop it was spawned on, and
+ * descriptors must be used from the loop that waits on them. Spread
+ * accepted connections by giving each loop its own listener from
+ * `listen_sharded()`; spread CPU-heavy sections with `stealable()`.
+ */
+class loop_pool final {
+public:
+    /// Runtime backend selector.
+    using backend = engine::backend;
+
+    /// @brief Construct `options.threads` engines (none run yet).
+    explicit loop_pool(loop_pool_options options = {});
+    ~loop_pool();
+
+    loop_pool(const loop_pool&) = delete;
+    loop_pool& operator=(const loop_pool&) = delete;
+    loop_pool(loop_pool&&) = delete;
+    loop_pool& operator=(loop_pool&&) = delete;
+
+    /// @return `true` when every engine initialized.
+    [[nodiscard]] bool valid() const noexcept;
+    /// @return Number of loops.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return loops_.size();
+    }
+    /// @return Backend shared by all loops.
+    [[nodiscard]] backend selected_backend() const noexcept {
+        return options_.selected_backend;
+    }
+    /**
+     * @brief CPU loop `index` is placed on.
+     * @return `-1` when loops are not pinned or `index >= size()`.
+     */
+    [[nodiscard]] int cpu(std::size_t index) const noexcept;
+    /**
+     * @brief NUMA node of loop `index`'s CPU, for NUMA-local arenas such
+     *        as `buffer_pool_options::numa_node`.
+     * @return `-1` when unpinned or unknown.
+     */
+    [[nodiscard]] int numa_node(std::size_t index) const noexcept;
+    /// @return Engine for loop `index` (`index < size()`).
+    [[nodiscard]] engine& loop(std::size_t index) noexcept {
+        return *loops_[index];
+    }
+
+    /**
+     * @brief Spawn a root task on loop `index`.
+     *
+     * Call before `run()`, or from a task already running on that loop;
+     * other threads go through `post()`.
+     * @return `EINVAL` when `index` is out of range.
+     */
+    template <class T>
+    [[nodiscard]] result<void> spawn_on(std::size_t index,
+                                        task<T>&& work) noexcept {
+        if (index >= loops_.size()) {
+            return err<void>(make_error_from_errno(EINVAL));
+        }
+        loops_[index]->spawn(std::move(work));
+        return ok();
+    }
+
+    /**
+     * @brief Run `work` on loop `index`; safe from any thread.
+     * @see engine::post
+     * @return `EINVAL` when `index` is out of range.
+     */
+    template <class Work>
+    [[nodiscard]] result<void> post(std::size_t index, Work&& work) noexcept {
+        if (index >= loops_.size()) {
+            return err<void>(make_error_from_errno(EINVAL));
+        }
+        return loops_[index]->post(std::forward<Work>(work));
+    }
+
+    /**
+     * @brief Spawn `factory(index)` on every loop.
+     *
+     * A coroutine lambda's captures live in the lambda object, so keep a
+     * capturing `factory` alive until `run()` returns.
+     * @tparam Factory Callable returning a `task<T>` for a loop index.
+     */
+    template <class Factory>
+    void spawn_each(Factory&& factory) noexcept {
+        for (std::size_t index = 0; index < loops_.size(); ++index) {
+            loops_[index]->spawn(factory(index));
+        }
+    }
+
+    /**
+     * @brief Bind one `SO_REUSEPORT` listener per loop on `local`.
+     *
+     * Port `0` is resolved by the first bind and reused for the rest.
+     * With `steer_by_cpu`, a CPU-steering program maps a connection
+     * received on CPU `c` to listener `c % size()`; that lines up with the
+     * loop pinned to CPU `c` when the pool covers CPUs `0..size()-1`.
+     * With `loop_pool_options::steer_incoming_cpu` each listener also
+     * carries its loop's `SO_INCOMING_CPU`.
+     *
+     * @return Listener `i` is meant for loop `i`.
+     */
+    [[nodiscard]] result<std::vector<nonblocking::tcp_listener>>
+    listen_sharded(const nonblocking::endpoint& local, int backlog = SOMAXCONN,
+                   bool steer_by_cpu = false) const noexcept;
+
+    /**
+     * @brief Run every loop on its own thread and wait for all of them.
+     *
+     * Each loop returns once its root tasks complete or `stop()` is called.
+     * The first loop to fail stops the others.
+     * @return Success or the first loop error.
+     */
+    [[nodiscard]] result<void> run() noexcept;
+
+    /**
+     * @brief Stop every loop; callable from any thread.
+     *
+     * A stop issued before `run()`, or while it starts the workers, ends
+     * that run as soon as each loop starts. It is cleared when `run()`
+     * returns.
+     */
+    void stop() noexcept;
+
+private:
+    friend bool detail::submit_stealable(detail::steal_job& job) noexcept;
+
+    struct worker;
+    struct stealing_worker;
+
+    static void *worker_main(void *argument) noexcept;
+    void run_worker(std::size_t index) noexcept;
+    void record_error(error failure) noexcept;
+    [[nodiscard]] int placement_cpu(std::size_t index) const noexcept;
+    [[nodiscard]] task<void> honour_early_stop(std::size_t index) noexcept;
+
+    loop_pool_options options_;
+    std::vector<int> cpus_{};
+    std::vector<std::unique_ptr<engine>> loops_{};
+    /// Per-loop steal state; empty unless `options_.work_stealing`.
+    std::vector<std::unique_ptr<stealing_worker>> stealers_{};
+    /// Guards `stopping_` and `first_error_`.
+    std::mutex state_mutex_{};
+    bool stopping_{false};
+    std::optional<error> first_error_{};
+};
+
+} // namespace simplenet::runtime
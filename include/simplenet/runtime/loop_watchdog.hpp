@@ -0,0 +1,157 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Opt-in detection of coroutine resumes that hold a loop too long.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/// One resume that ran past a `watchdog_hook` threshold.
+struct stall_report {
+    /// Frame address of the resumed coroutine (`handle.address()`).
+    const void *coroutine{nullptr};
+    /// Last `set_stall_tag()` made during the resume, or `nullptr`.
+    const char *tag{nullptr};
+    /// Time the resume had run when reported.
+    std::chrono::nanoseconds elapsed{0};
+    /// `true` when a `stall_monitor` saw it before the resume returned.
+    bool still_running{false};
+};
+
+/**
+ * @brief Caller-owned stall reporter.
+ *
+ * A loop with a hook installed (`set_watchdog()`) times every resume from
+ * its ready queue and calls `report` on its own thread after one that ran
+ * for at least `threshold`. A `stall_monitor` holding the same hook calls
+ * it from the monitor thread for resumes that are still running past
+ * `threshold`. The hook must outlive every registration.
+ */
+struct watchdog_hook {
+    /// Receives the report; the tag string is the caller's own.
+    void (*report)(const stall_report& stall, void *context) noexcept {nullptr};
+    /// Opaque owner pointer passed to `report`.
+    void *context{nullptr};
+    /// Shortest resume that is reported.
+    std::chrono::nanoseconds threshold{std::chrono::milliseconds{5}};
+};
+
+/**
+ * @brief Name the work the current resume is doing, for stall reports.
+ *
+ * Call from a coroutine running on a loop with a watchdog installed; the
+ * tag is kept until that resume returns. `tag` must outlive the resume,
+ * which a string literal always does. A no-op elsewhere.
+ */
+void set_stall_tag(const char *tag) noexcept;
+
+/**
+ * @brief What a loop is resuming right now, readable from other threads.
+ *
+ * Written by the loop thread only while a watchdog is installed. Each
+ * resume bumps `sequence` before it writes the other fields, so a reader
+ * that loads `sequence` before and after them knows whether it saw one
+ * resume.
+ */
+class loop_heartbeat {
+public:
+    loop_heartbeat() noexcept = default;
+    loop_heartbeat(const loop_heartbeat&) = delete;
+    loop_heartbeat& operator=(const loop_heartbeat&) = delete;
+
+    /// Resumes begun since construction.
+    std::atomic<std::uint64_t> sequence{0};
+    /// `steady_clock` nanoseconds when the current resume began; `0` idle.
+    std::atomic<std::int64_t> started{0};
+    std::atomic<const void *> coroutine{nullptr};
+    std::atomic<const char *> tag{nullptr};
+};
+
+/**
+ * @brief Sidecar thread that reports resumes still running past a threshold.
+ *
+ * Catches hard stalls, such as a handler stuck in a blocking call, that a
+ * loop would only report once they end. Every `period` the monitor reads
+ * each watched heartbeat and reports a resume once. Only loops with a
+ * watchdog installed keep their heartbeat current.
+ */
+class stall_monitor {
+public:
+    /**
+     * @brief Start the monitor thread; `hook` must outlive the monitor.
+     * @param period Sampling interval. A stall is reported up to `period`
+     *        after it crosses the threshold; shorter periods wake the
+     *        monitor thread more often.
+     */
+    explicit stall_monitor(
+        const watchdog_hook& hook,
+        std::chrono::milliseconds period = std::chrono::milliseconds{25});
+    /// @brief Stop and join the monitor thread.
+    ~stall_monitor();
+
+    stall_monitor(const stall_monitor&) = delete;
+    stall_monitor& operator=(const stall_monitor&) = delete;
+
+    /// @brief Start sampling `heartbeat`; safe from any thread.
+    void watch(const loop_heartbeat& heartbeat);
+    /// @brief Stop sampling `heartbeat`; returns once no sample is in flight.
+    void unwatch(const loop_heartbeat& heartbeat) noexcept;
+
+private:
+    struct watched {
+        const loop_heartbeat *heartbeat;
+        std::uint64_t reported;
+    };
+
+    void run() noexcept;
+
+    const watchdog_hook *hook_;
+    std::chrono::milliseconds period_;
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::vector<watched> watched_{};
+    bool stop_{false};
+    std::thread thread_{};
+};
+
+namespace detail {
+
+/// Per-loop resume timer; one null check per resume while uninstalled.
+class stall_watch {
+public:
+    void set_hook(watchdog_hook *hook) noexcept;
+    [[nodiscard]] const loop_heartbeat& heartbeat() const noexcept {
+        return heartbeat_;
+    }
+
+    void begin(const void *coroutine) noexcept {
+        if (hook_ != nullptr) {
+            start(coroutine);
+        }
+    }
+    void end() noexcept {
+        if (hook_ != nullptr) {
+            finish();
+        }
+    }
+
+private:
+    void start(const void *coroutine) noexcept;
+    void finish() noexcept;
+
+    watchdog_hook *hook_{nullptr};
+    loop_heartbeat heartbeat_{};
+};
+
+} // namespace detail
+
+} // namespace simplenet::runtime
@@ -0,0 +1,46 @@
+#pragma once
+
+/**
+ * @file
+ * @brief NUMA topology lookups and memory placement for loop placement.
+ */
+
+#include "simplenet/core/result.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace simplenet::runtime::numa {
+
+/**
+ * @brief CPUs of NUMA node `node`, from
+ *        `/sys/devices/system/node/node<N>/cpulist`.
+ * @return Ascending CPU ids; empty when the node does not exist.
+ */
+[[nodiscard]] std::vector<int> cpus_of_node(int node);
+
+/// @return Node that CPU `cpu` belongs to, or `-1` when unknown.
+[[nodiscard]] int node_of_cpu(int cpu) noexcept;
+
+/**
+ * @brief Node a network interface's device is attached to.
+ *
+ * Reads `/sys/class/net/<name>/device/numa_node`, so a loop pool can be
+ * placed next to the NIC queues it serves.
+ * @return `-1` for virtual devices, single-node hosts and unknown names.
+ */
+[[nodiscard]] int node_of_interface(std::string_view name) noexcept;
+
+/**
+ * @brief Prefer node `node` for the pages of `[address, address + length)`
+ *        (`mbind(MPOL_PREFERRED)`).
+ *
+ * Only affects pages not yet touched, so call it right after `mmap`. The
+ * kernel falls back to other nodes when `node` runs out of memory.
+ * @return `EINVAL` for a negative node; the `mbind` error otherwise.
+ */
+[[nodiscard]] result<void> prefer_node(void *address, std::size_t length,
+                                       int node) noexcept;
+
+} // namespace simplenet::runtime::numa
@@ -0,0 +1,168 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Opt-in latency histograms for individual I/O operations, kept per
+ *        thread and merged on demand.
+ */
+
+#include "simplenet/runtime/loop_metrics.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace simplenet::runtime {
+
+/// Operations timed while op-latency sampling is on.
+enum class op_kind : std::uint8_t {
+    /// One `async_read_some()` call, including any readiness or ring wait.
+    read_some,
+    /// One `async_connect()` to a single address, handshake included.
+    connect,
+    /// One `queued_writer::flush()` until the queue drained or it failed.
+    flush,
+};
+/// Number of `op_kind` values.
+inline constexpr std::size_t op_kind_count = 3;
+
+/// How the loop that ran the operation performs I/O.
+enum class op_backend : std::uint8_t {
+    /// Readiness waits (`event_loop`).
+    readiness,
+    /// Ring completions (`uring_event_loop`).
+    completion,
+};
+/// Number of `op_backend` values.
+inline constexpr std::size_t op_backend_count = 2;
+
+/**
+ * @brief One latency histogram per operation and backend.
+ *
+ * Failed, cancelled and timed-out operations are counted too, at the time
+ * they gave up.
+ */
+struct op_latency_snapshot {
+    std::array<std::array<latency_histogram, op_kind_count>, op_backend_count>
+        histograms{};
+
+    [[nodiscard]] latency_histogram& at(op_kind kind,
+                                        op_backend backend) noexcept {
+        return histograms[static_cast<std::size_t>(backend)]
+                         [static_cast<std::size_t>(kind)];
+    }
+    [[nodiscard]] const latency_histogram& at(op_kind kind,
+                                              op_backend backend) const noexcept {
+        return histograms[static_cast<std::size_t>(backend)]
+                         [static_cast<std::size_t>(kind)];
+    }
+    /// @brief Add every sample of `other`.
+    void merge(const op_latency_snapshot& other) noexcept {
+        for (std::size_t backend = 0; backend < op_backend_count; ++backend) {
+            for (std::size_t kind = 0; kind < op_kind_count; ++kind) {
+                histograms[backend][kind].merge(other.histograms[backend][kind]);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Turn op-latency sampling on or off for every thread.
+ *
+ * Off by default. While on, each timed operation reads the cycle counter
+ * twice (the invariant TSC on x86-64, calibrated once against
+ * `steady_clock`; `steady_clock` elsewhere) and bumps one bucket of the
+ * calling thread's histograms. A thread's histograms are allocated on its
+ * first sample. A no-op unless `metrics_enabled`.
+ */
+void set_op_latency_sampling(bool on) noexcept;
+/// @return `true` while op-latency sampling is on.
+[[nodiscard]] bool op_latency_sampling() noexcept;
+
+/// @return Samples recorded by the calling thread.
+[[nodiscard]] op_latency_snapshot op_latency_thread_snapshot() noexcept;
+/**
+ * @brief Samples recorded by every thread, including ones that have exited.
+ *
+ * Safe from any thread while others keep recording; each bucket is read
+ * atomically, so a sample in flight may be missing from the totals.
+ */
+[[nodiscard]] op_latency_snapshot op_latency_process_snapshot() noexcept;
+
+namespace detail {
+
+/// @return Current cycle-counter reading in calibrated ticks.
+[[nodiscard]] std::uint64_t op_clock_ticks() noexcept;
+/// @brief Record the time since `started` (from `op_clock_ticks()`).
+void record_op_latency(op_kind kind, op_backend backend,
+                       std::uint64_t started) noexcept;
+/// @return Flag read on every timed operation.
+[[nodiscard]] bool op_latency_flag() noexcept;
+
+/// Times one operation when sampling is on; records on destruction.
+class op_latency_timer {
+public:
+    op_latency_timer() noexcept = default;
+    op_latency_timer(op_kind kind, const scheduler *loop) noexcept {
+        if constexpr (metrics_enabled) {
+            if (op_latency_flag()) {
+                kind_ = kind;
+                backend_ = loop != nullptr && loop->supports_completion_io()
+                               ? op_backend::completion
+                               : op_backend::readiness;
+                started_ = op_clock_ticks();
+            }
+        }
+    }
+    ~op_latency_timer() {
+        if constexpr (metrics_enabled) {
+            if (started_ != 0U) {
+                record_op_latency(kind_, backend_, started_);
+            }
+        }
+    }
+
+    op_latency_timer(const op_latency_timer&) = delete;
+    op_latency_timer& operator=(const op_latency_timer&) = delete;
+    op_latency_timer(op_latency_timer&& other) noexcept
+        : kind_(other.kind_), backend_(other.backend_),
+          started_(std::exchange(other.started_, 0U)) {}
+    op_latency_timer& operator=(op_latency_timer&&) = delete;
+
+private:
+    op_kind kind_{op_kind::read_some};
+    op_backend backend_{op_backend::readiness};
+    std::uint64_t started_{0};
+};
+
+/// Non-suspending awaitable yielding an `op_latency_timer` for the
+/// awaiting task's loop.
+class start_op_timer {
+public:
+    explicit start_op_timer(op_kind kind) noexcept : kind_(kind) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            loop_ = handle.promise().scheduler_ptr();
+        }
+        return false;
+    }
+    [[nodiscard]] op_latency_timer await_resume() const noexcept {
+        return op_latency_timer{kind_, loop_};
+    }
+
+private:
+    op_kind kind_;
+    const scheduler *loop_{nullptr};
+};
+
+} // namespace detail
+
+} // namespace simplenet::runtime
@@ -0,0 +1,68 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Lock-free multi-producer queue of work posted to an event loop.
+ */
+
+#include "simplenet/runtime/task.hpp"
+
+#include <atomic>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Intrusive MPSC queue of `posted_work` nodes (Vyukov).
+ *
+ * `push` is wait-free and may be called from any thread; `pop` runs on the
+ * owning loop thread only. The queue also carries the loop's "signal
+ * pending" flag so a burst of posts costs a single wake-up: only the push
+ * that finds the flag clear is told to signal, and the loop clears it with
+ * `rearm()` before draining.
+ *
+ * Nodes still queued at destruction are discarded through
+ * `complete(work, false)`.
+ */
+class post_queue {
+public:
+    post_queue() noexcept = default;
+    ~post_queue();
+
+    post_queue(const post_queue&) = delete;
+    post_queue& operator=(const post_queue&) = delete;
+    post_queue(post_queue&&) = delete;
+    post_queue& operator=(post_queue&&) = delete;
+
+    /**
+     * @brief Append `work`.
+     * @return `true` when the caller must wake the loop.
+     */
+    [[nodiscard]] bool push(posted_work& work) noexcept;
+    /**
+     * @return Oldest node, or `nullptr` when empty. May also return
+     * `nullptr` while a producer is mid-push; that producer's own wake-up
+     * covers its node.
+     */
+    [[nodiscard]] posted_work *pop() noexcept;
+
+    /// @brief Clear the pending flag before a drain (loop thread).
+    void rearm() noexcept {
+        signal_pending_.store(false, std::memory_order_seq_cst);
+    }
+    /// @return `true` when the caller set the pending flag and must signal.
+    [[nodiscard]] bool claim_signal() noexcept {
+        return !signal_pending_.exchange(true, std::memory_order_seq_cst);
+    }
+
+private:
+    void link(posted_work& work) noexcept;
+
+    posted_work stub_{};
+    /// Producer end; every push exchanges itself in here.
+    std::atomic<posted_work *> back_{&stub_};
+    /// Consumer end (loop thread only).
+    posted_work *front_{&stub_};
+    std::atomic<bool> signal_pending_{false};
+};
+
+} // namespace simplenet::runtime
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Multishot stream receiver yielding borrowed provided buffers.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Received bytes on loan from the scheduler's buffer pool.
+ *
+ * The buffer returns to the pool when released or destroyed. An empty buffer
+ * signals end of stream. Must be released before the owning loop is destroyed.
+ */
+class borrowed_buffer {
+public:
+    /// Construct an empty buffer (end of stream).
+    borrowed_buffer() noexcept = default;
+    /// Return the buffer to its pool.
+    ~borrowed_buffer();
+
+    borrowed_buffer(const borrowed_buffer&) = delete;
+    borrowed_buffer& operator=(const borrowed_buffer&) = delete;
+    /// Move-construct the loan.
+    borrowed_buffer(borrowed_buffer&& other) noexcept;
+    /// Move-assign the loan, releasing any held buffer first.
+    borrowed_buffer& operator=(borrowed_buffer&& other) noexcept;
+
+    /// @return Received bytes.
+    [[nodiscard]] std::span<const std::byte> data() const noexcept;
+    /// @return Number of received bytes.
+    [[nodiscard]] std::size_t size() const noexcept;
+    /// @return `true` when no bytes are held (end of stream).
+    [[nodiscard]] bool empty() const noexcept;
+    /// @brief Return the buffer to its pool early.
+    void release() noexcept;
+
+private:
+    friend class multishot_receiver;
+
+    borrowed_buffer(scheduler *owner, std::uint16_t id,
+                    std::span<const std::byte> view) noexcept;
+    explicit borrowed_buffer(std::vector<std::byte> owned) noexcept;
+
+    scheduler *owner_{nullptr};
+    std::uint16_t id_{0};
+    std::span<const std::byte> view_{};
+    std::vector<std::byte> owned_{};
+};
+
+/**
+ * @brief Pull-based receiver over one multishot recv request.
+ *
+ * On `io_uring` one `IORING_RECV_MULTISHOT` submission keeps delivering data
+ * into loop-owned provided buffers, so idle connections pin no receive memory.
+ * On other schedulers, kernels without multishot recv, or while the pool is
+ * exhausted, `receive()` reads into a freshly allocated buffer instead.
+ *
+ * The receiver must not outlive the event loop that runs it, and only one
+ * coroutine may wait in `receive()` at a time.
+ */
+class multishot_receiver {
+public:
+    /// Default size of buffers allocated when no provided buffer is available.
+    static constexpr std::size_t fallback_buffer_size = 4096;
+
+    /**
+     * @brief Construct a receiver for a connected stream.
+     * @param stream Stream to read; must outlive the receiver.
+     */
+    explicit multishot_receiver(
+        simplenet::nonblocking::tcp_stream& stream) noexcept;
+    /// Cancel the multishot request and return unclaimed buffers.
+    ~multishot_receiver();
+
+    multishot_receiver(const multishot_receiver&) = delete;
+    multishot_receiver& operator=(const multishot_receiver&) = delete;
+    multishot_receiver(multishot_receiver&&) = delete;
+    multishot_receiver& operator=(multishot_receiver&&) = delete;
+
+    /// @brief Receive the next chunk; an empty buffer means end of stream.
+    [[nodiscard]] task<result<borrowed_buffer>> receive();
+
+    /// @return `true` while a multishot request is armed in the kernel.
+    [[nodiscard]] bool multishot_active() const noexcept;
+
+private:
+    struct chunk {
+        int buffer_id{-1};
+        std::size_t length{0};
+    };
+
+    class next_chunk_awaitable;
+
+    static void on_completion(io_operation& operation, int result,
+                              bool more) noexcept;
+
+    simplenet::nonblocking::tcp_stream *stream_{nullptr};
+    scheduler *scheduler_{nullptr};
+    io_operation operation_{};
+    std::deque<chunk> ready_{};
+    std::optional<simplenet::error> pending_error_{};
+    std::coroutine_handle<> waiter_{};
+    bool armed_{false};
+    bool exhausted_{false};
+    bool fallback_{false};
+};
+
+} // namespace simplenet::runtime
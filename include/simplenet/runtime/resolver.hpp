@@ -7,8 +7,13 @@
 
 #include "simplenet/blocking/endpoint.hpp"
 #include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/io_ops.hpp"
 #include "simplenet/runtime/task.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -17,6 +22,63 @@ namespace simplenet::runtime {
 
 /// Alias to endpoint type used throughout runtime APIs.
 using endpoint = simplenet::blocking::endpoint;
+/// Alias to the binary address type used by connect/bind overloads.
+using socket_address = simplenet::blocking::socket_address;
+
+/// Upper bound for `resolver_options::workers`.
+inline constexpr std::size_t resolver_max_workers = 64;
+
+/**
+ * @brief Process-wide settings for the `async_resolve*` cache and workers.
+ *
+ * `getaddrinfo` does not report record TTLs, so the same lifetime applies
+ * to every successful answer.
+ */
+struct resolver_options {
+    /// Lifetime of a successful answer; `0` turns off positive caching.
+    std::chrono::milliseconds positive_ttl{std::chrono::seconds{30}};
+    /**
+     * Lifetime of a definite failure, such as an unknown host or service;
+     * `0` turns off negative caching. `EAGAIN` and `ENOMEM` are never cached.
+     */
+    std::chrono::milliseconds negative_ttl{std::chrono::seconds{5}};
+    /// Cached (host, service, family) keys kept before the oldest is evicted.
+    std::size_t max_entries{1024};
+    /// Threads running `getaddrinfo`, from 1 to `resolver_max_workers`.
+    std::size_t workers{1};
+};
+
+/// Process-wide resolver cache counters.
+struct resolver_stats {
+    /// Lookups answered from a cached success.
+    std::uint64_t hits{0};
+    /// Lookups answered from a cached failure.
+    std::uint64_t negative_hits{0};
+    /// Lookups that queued a new worker job.
+    std::uint64_t misses{0};
+    /// Lookups that joined a job already in flight for the same key.
+    std::uint64_t coalesced{0};
+    /// Entries dropped to stay within `max_entries`.
+    std::uint64_t evictions{0};
+    /// Entries currently cached or in flight.
+    std::size_t entries{0};
+    /// Worker threads started so far.
+    std::size_t workers{0};
+};
+
+/**
+ * @brief Replace the resolver settings.
+ *
+ * Raising `workers` starts threads at once. Lowering it parks the extras
+ * once their current lookups finish. Cached entries keep the expiry they
+ * were stored with.
+ * @return `EINVAL` when `workers` is outside `[1, resolver_max_workers]`.
+ */
+[[nodiscard]] result<void> configure_resolver(const resolver_options& options);
+/// @return Resolver cache counters.
+[[nodiscard]] resolver_stats resolver_counters() noexcept;
+/// @brief Drop every cached answer; lookups in flight are kept.
+void resolver_cache_clear() noexcept;
 
 /**
  * @brief Parse `host:port` style IPv4 endpoint text.
@@ -25,18 +87,63 @@ using endpoint = simplenet::blocking::endpoint;
  */
 [[nodiscard]] result<endpoint> parse_ipv4_endpoint(std::string_view value);
 /**
- * @brief Format an endpoint into `host:port`.
+ * @brief Parse `a.b.c.d:port` or `[v6]:port` endpoint text.
+ * @param value Input text; IPv6 hosts must be bracketed.
+ * @return Parsed endpoint (host without brackets) on success.
+ */
+[[nodiscard]] result<endpoint> parse_endpoint(std::string_view value);
+/**
+ * @brief Format an endpoint into `host:port`, bracketing IPv6 hosts.
  * @param value Endpoint to format.
  */
 [[nodiscard]] std::string format_endpoint(const endpoint& value);
 
 /**
  * @brief Resolve host/service into a list of endpoints asynchronously.
+ *
+ * Answers come from the resolver cache when fresh. Concurrent lookups of
+ * the same key share one `getaddrinfo` call.
  * @param host Hostname or literal address.
  * @param service Service name or port string.
  * @param token Optional cancellation token.
  */
 [[nodiscard]] task<result<std::vector<endpoint>>>
 async_resolve(std::string host, std::string service, cancel_token token = {});
+/**
+ * @brief Resolve host/service into binary addresses asynchronously.
+ *
+ * Results feed `async_connect(socket_address)` directly, with no
+ * `inet_ntop`/`inet_pton` round trip.
+ * @param host Hostname or literal address.
+ * @param service Service name or port string.
+ * @param family `AF_UNSPEC` (IPv4 and IPv6), `AF_INET` or `AF_INET6`.
+ * @param token Optional cancellation token.
+ */
+[[nodiscard]] task<result<std::vector<socket_address>>>
+async_resolve_addresses(std::string host, std::string service,
+                        int family = AF_UNSPEC, cancel_token token = {});
+/**
+ * @brief Resolve `host` for IPv4 and IPv6, then connect with Happy
+ * Eyeballs over the results.
+ * @param host Hostname or literal address.
+ * @param service Service name or port string.
+ * @param options Attempt spacing for the connect race.
+ * @param token Optional cancellation token for the resolution.
+ */
+[[nodiscard]] task<result<simplenet::nonblocking::tcp_stream>>
+async_connect(std::string host, std::string service,
+              happy_eyeballs_options options = {}, cancel_token token = {});
+
+namespace detail {
+
+/**
+ * @brief Run `job` on a resolver worker after the lookups already queued.
+ *
+ * Test hook: a job that blocks holds every later lookup in the queue, so
+ * a test can act on a lookup that is known not to have started.
+ */
+void post_resolver_job(std::function<void()> job);
+
+} // namespace detail
 
 } // namespace simplenet::runtime
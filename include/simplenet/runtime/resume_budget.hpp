@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Sharing one loop between coroutines that stay ready and pending I/O.
+ */
+
+#include "simplenet/runtime/task.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+
+namespace simplenet::runtime {
+
+/// Awaitable returned by `yield()`.
+class yield_awaitable {
+public:
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            if (auto *loop = handle.promise().scheduler_ptr(); loop != nullptr) {
+                loop->schedule(handle);
+                return true;
+            }
+        }
+        return false;
+    }
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Requeue the awaiting coroutine behind the work already ready.
+ *
+ * Long computations that `co_await yield()` between steps let the other
+ * ready coroutines run, and, once the loop's resume budget is spent
+ * (`set_resume_budget()`), fresh I/O readiness too. Continues inline when
+ * the coroutine has no scheduler.
+ */
+[[nodiscard]] inline yield_awaitable yield() noexcept {
+    return {};
+}
+
+namespace detail {
+
+/// Resumes one ready-queue pass may take before the loop polls for I/O.
+class resume_budget {
+public:
+    void set(std::size_t max_resumes, std::chrono::microseconds max_time) noexcept {
+        max_resumes_ = max_resumes;
+        max_time_ = std::max(max_time, std::chrono::microseconds{0});
+    }
+
+    void begin_pass() noexcept {
+        used_ = 0;
+        if (max_time_.count() > 0) {
+            deadline_ = clock::now() + max_time_;
+        }
+    }
+    /// Count one resume. @return `true` once the pass has used its budget.
+    [[nodiscard]] bool spend() noexcept {
+        ++used_;
+        if (max_resumes_ != 0 && used_ >= max_resumes_) {
+            return true;
+        }
+        return max_time_.count() > 0 && clock::now() >= deadline_;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    std::size_t max_resumes_{0};
+    std::size_t used_{0};
+    std::chrono::microseconds max_time_{0};
+    clock::time_point deadline_{};
+};
+
+} // namespace detail
+
+} // namespace simplenet::runtime
@@ -0,0 +1,210 @@
+#pragma once
+
+/**
+ * @file
+ * @brief FIFO ring that holds no storage while empty.
+ */
+
+#include "simplenet/runtime/frame_pool.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Growable FIFO over one power-of-two ring of slots.
+ *
+ * Unlike `std::deque`, which allocates a map and a block on construction,
+ * an empty queue owns nothing: storage is taken on the first push and
+ * returned once the last element is popped. Idle owners, such as a
+ * `queued_writer` on a quiet connection, then cost four words. Rings up
+ * to `frame_pool_max_size` bytes come from the thread's frame pool, so the
+ * allocate-on-push, free-on-drain cycle of a busy queue stays off the heap.
+ *
+ * @tparam T Element type; must be nothrow move-constructible.
+ */
+template <class T>
+class ring_queue {
+    static_assert(std::is_nothrow_move_constructible_v<T>);
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using owner_type = std::conditional_t<Const, const ring_queue, ring_queue>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T *, T *>;
+
+        basic_iterator() noexcept = default;
+        basic_iterator(owner_type *owner, std::size_t index) noexcept
+            : owner_(owner), index_(index) {}
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return *owner_->slot(index_);
+        }
+        [[nodiscard]] pointer operator->() const noexcept {
+            return owner_->slot(index_);
+        }
+        basic_iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            auto previous = *this;
+            ++index_;
+            return previous;
+        }
+        [[nodiscard]] bool operator==(const basic_iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+    private:
+        owner_type *owner_{nullptr};
+        std::size_t index_{0};
+    };
+
+public:
+    using value_type = T;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    /// Construct an empty queue; allocates nothing.
+    ring_queue() noexcept = default;
+    ~ring_queue() {
+        clear();
+    }
+
+    ring_queue(const ring_queue&) = delete;
+    ring_queue& operator=(const ring_queue&) = delete;
+    ring_queue(ring_queue&& other) noexcept
+        : slots_(std::exchange(other.slots_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0U)),
+          head_(std::exchange(other.head_, 0U)),
+          size_(std::exchange(other.size_, 0U)) {}
+    ring_queue& operator=(ring_queue&& other) noexcept {
+        if (this != &other) {
+            clear();
+            slots_ = std::exchange(other.slots_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0U);
+            head_ = std::exchange(other.head_, 0U);
+            size_ = std::exchange(other.size_, 0U);
+        }
+        return *this;
+    }
+
+    /// @return `true` when no elements are queued.
+    [[nodiscard]] bool empty() const noexcept {
+        return size_ == 0U;
+    }
+    /// @return Queued element count.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+    /// @return Slots in the current ring; `0` while empty.
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    [[nodiscard]] T& front() noexcept {
+        return *slot(0);
+    }
+    [[nodiscard]] const T& front() const noexcept {
+        return *slot(0);
+    }
+    [[nodiscard]] T& back() noexcept {
+        return *slot(size_ - 1U);
+    }
+    [[nodiscard]] const T& back() const noexcept {
+        return *slot(size_ - 1U);
+    }
+
+    /// @brief Append an element, doubling the ring when it is full.
+    template <class... Args>
+    T& emplace_back(Args&&...args) {
+        if (size_ == capacity_) {
+            grow();
+        }
+        T *added = ::new (static_cast<void *>(slot(size_)))
+            T(std::forward<Args>(args)...);
+        ++size_;
+        return *added;
+    }
+    void push_back(T&& value) {
+        (void)emplace_back(std::move(value));
+    }
+
+    /// @brief Destroy the front element; the last one frees the ring.
+    void pop_front() noexcept {
+        slot(0)->~T();
+        head_ = (head_ + 1U) & (capacity_ - 1U);
+        if (--size_ == 0U) {
+            release_storage();
+        }
+    }
+
+    /// @brief Destroy every element and free the ring.
+    void clear() noexcept {
+        for (std::size_t index = 0; index < size_; ++index) {
+            slot(index)->~T();
+        }
+        size_ = 0;
+        release_storage();
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+        return iterator{this, 0};
+    }
+    [[nodiscard]] iterator end() noexcept {
+        return iterator{this, size_};
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator{this, 0};
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator{this, size_};
+    }
+
+private:
+    /// Smallest ring allocated by the first push.
+    static constexpr std::size_t initial_capacity = 4;
+
+    [[nodiscard]] T *slot(std::size_t index) const noexcept {
+        return slots_ + ((head_ + index) & (capacity_ - 1U));
+    }
+
+    void grow() {
+        const std::size_t grown = capacity_ == 0U ? initial_capacity : capacity_ * 2U;
+        auto *moved = static_cast<T *>(detail::allocate_frame(grown * sizeof(T)));
+        for (std::size_t index = 0; index < size_; ++index) {
+            T *from = slot(index);
+            ::new (static_cast<void *>(moved + index)) T(std::move(*from));
+            from->~T();
+        }
+        release_storage();
+        slots_ = moved;
+        capacity_ = grown;
+    }
+
+    void release_storage() noexcept {
+        if (slots_ != nullptr) {
+            detail::deallocate_frame(slots_, capacity_ * sizeof(T));
+        }
+        slots_ = nullptr;
+        capacity_ = 0;
+        head_ = 0;
+    }
+
+    T *slots_{nullptr};
+    std::size_t capacity_{0};
+    std::size_t head_{0};
+    std::size_t size_{0};
+};
+
+} // namespace simplenet::runtime
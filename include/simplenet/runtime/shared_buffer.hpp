@@ -0,0 +1,88 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Immutable reference-counted byte buffer for fan-out writes.
+ */
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace simplenet::runtime {
+
+/// Who may hold references to one `shared_buffer`.
+enum class buffer_sharing : std::uint8_t {
+    /// All copies live on one loop thread; the count is a plain integer.
+    loop_local,
+    /// Copies may be held and dropped on several threads; atomic count.
+    cross_thread,
+};
+
+/**
+ * @brief Immutable bytes shared by any number of holders.
+ *
+ * Copying bumps a reference count, never the bytes, so one message can be
+ * queued on thousands of `queued_writer`s at O(1) cost each. The count and
+ * bytes live in one block. Blocks up to `frame_pool_max_size` come from
+ * the thread's frame pool, so steady fan-out does not touch the heap.
+ *
+ * A `loop_local` buffer and all its copies must stay on one thread.
+ */
+class shared_buffer {
+public:
+    /// Construct an empty buffer.
+    shared_buffer() noexcept = default;
+    /// Drop this reference; the last one frees the block.
+    ~shared_buffer();
+
+    shared_buffer(const shared_buffer& other) noexcept;
+    shared_buffer& operator=(const shared_buffer& other) noexcept;
+    shared_buffer(shared_buffer&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr)) {}
+    shared_buffer& operator=(shared_buffer&& other) noexcept;
+
+    /// @return A buffer holding a copy of `bytes`.
+    [[nodiscard]] static shared_buffer
+    copy_of(std::span<const std::byte> bytes,
+            buffer_sharing sharing = buffer_sharing::loop_local);
+
+    /**
+     * @brief Allocate `size` bytes and let `fill` write them once, such as
+     *        a serializer, before the buffer is shared.
+     */
+    template <class Fill>
+        requires std::invocable<Fill&, std::span<std::byte>>
+    [[nodiscard]] static shared_buffer
+    build(std::size_t size, Fill fill,
+          buffer_sharing sharing = buffer_sharing::loop_local) {
+        auto buffer = allocate(size, sharing);
+        fill(buffer.writable());
+        return buffer;
+    }
+
+    /// @return The shared bytes.
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept;
+    /// @return Byte count.
+    [[nodiscard]] std::size_t size() const noexcept;
+    /// @return `true` when no bytes are held.
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0U;
+    }
+    /// @return Live references to the bytes; `0` for an empty buffer.
+    [[nodiscard]] std::size_t use_count() const noexcept;
+
+private:
+    struct block;
+
+    [[nodiscard]] static shared_buffer allocate(std::size_t size,
+                                                buffer_sharing sharing);
+    [[nodiscard]] std::span<std::byte> writable() noexcept;
+    void release() noexcept;
+
+    block *block_{nullptr};
+};
+
+} // namespace simplenet::runtime
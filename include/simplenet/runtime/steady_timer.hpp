@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Deadline timer backed by the scheduler's native timers.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Single-waiter monotonic timer built on `scheduler::schedule_at()`.
+ *
+ * A wait is one timer-wheel entry on epoll and one `IORING_OP_TIMEOUT` on
+ * io_uring; no descriptor is created and no per-wait syscall is made beyond
+ * the loop's own wait. The timer must not outlive the event loop that runs
+ * it, and only one coroutine may wait on it at a time.
+ */
+class steady_timer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /// Construct a timer that has already expired.
+    steady_timer() noexcept = default;
+    /// Construct a timer expiring at `expiry`.
+    explicit steady_timer(clock::time_point expiry) noexcept;
+    /// Construct a timer expiring `duration` from now.
+    explicit steady_timer(clock::duration duration) noexcept;
+    /// Disarm any pending wait without resuming it.
+    ~steady_timer();
+
+    steady_timer(const steady_timer&) = delete;
+    steady_timer& operator=(const steady_timer&) = delete;
+    steady_timer(steady_timer&&) = delete;
+    steady_timer& operator=(steady_timer&&) = delete;
+
+    /**
+     * @brief Set an absolute expiry, cancelling a pending wait.
+     * @return Number of waits cancelled (0 or 1).
+     */
+    std::size_t expires_at(clock::time_point expiry) noexcept;
+    /**
+     * @brief Set expiry relative to now, cancelling a pending wait.
+     * @return Number of waits cancelled (0 or 1).
+     */
+    std::size_t expires_after(clock::duration duration) noexcept;
+    /// @return Current expiry time.
+    [[nodiscard]] clock::time_point expiry() const noexcept;
+
+    /**
+     * @brief Suspend until the expiry time.
+     *
+     * Completes immediately when the expiry has already passed. Fails with
+     * `ECANCELED` after `cancel()` or once `token` is stopped (the wait is
+     * woken right away, even when stopped from another thread) and `EBUSY`
+     * when another wait is pending.
+     */
+    [[nodiscard]] task<result<void>> wait(cancel_token token = {});
+    /**
+     * @brief Wake the pending wait with `ECANCELED`.
+     * @return Number of waits cancelled (0 or 1).
+     */
+    std::size_t cancel() noexcept;
+    /// @return `true` while a coroutine is suspended in `wait()`.
+    [[nodiscard]] bool waiting() const noexcept;
+
+private:
+    class wait_awaitable;
+
+    clock::time_point expiry_{};
+    timer_operation operation_{};
+    scheduler *scheduler_{nullptr};
+    bool waiting_{false};
+};
+
+} // namespace simplenet::runtime
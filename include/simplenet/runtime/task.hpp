@@ -6,18 +6,302 @@
  */
 
 #include "simplenet/core/result.hpp"
+#include "simplenet/runtime/frame_pool.hpp"
+#include "simplenet/runtime/timer_wheel.hpp"
 
+#include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <concepts>
 #include <coroutine>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <new>
 #include <optional>
+#include <span>
 #include <stdexcept>
+#include <sys/uio.h>
 #include <type_traits>
 #include <utility>
 
 namespace simplenet::runtime {
 
+/**
+ * @brief Socket operations a completion-based scheduler can execute directly.
+ */
+enum class io_opcode : std::uint8_t {
+    recv,
+    send,
+    accept,
+    connect,
+    /// Multishot accept: one submission yields a CQE per accepted connection.
+    accept_multishot,
+    /// Multishot receive into scheduler-provided buffers.
+    recv_multishot,
+    /// Scatter receive; `buffer` points at a `msghdr`.
+    recvmsg,
+    /// Gather send; `buffer` points at a `msghdr`.
+    sendmsg,
+    /**
+     * Zero-copy send. A `handle` is resumed once the kernel has released
+     * the buffer, with `result` holding the byte count.
+     */
+    send_zc,
+    /**
+     * Move `length` bytes from `source_fd` into `fd` inside the kernel.
+     * One side must be a pipe.
+     */
+    splice,
+};
+
+/**
+ * @brief Caller-owned state for one completion-mode socket operation.
+ *
+ * The object must stay at a stable address until the scheduler resumes
+ * `handle`; coroutine frames satisfy this naturally.
+ */
+struct io_operation {
+    /// Operation to perform.
+    io_opcode opcode{io_opcode::recv};
+    /// Target descriptor.
+    int fd{-1};
+    /// Data buffer for `recv`/`send`, or the `msghdr` for `recvmsg`/`sendmsg`.
+    void *buffer{nullptr};
+    /// Buffer length in bytes.
+    std::size_t length{0};
+    /// Peer address for `connect`.
+    const void *address{nullptr};
+    /// Peer address length for `connect`.
+    std::uint32_t address_length{0};
+    /// Source descriptor for `splice`; `fd` is the destination.
+    int source_fd{-1};
+    /// Read offset in `source_fd` for `splice`; `-1` for pipes and sockets.
+    std::int64_t source_offset{-1};
+    /// Coroutine resumed when the operation completes.
+    std::coroutine_handle<> handle{};
+    /// Kernel result: byte count/descriptor on success, `-errno` on failure.
+    int result{0};
+    /**
+     * Optional per-completion callback used instead of resuming `handle`.
+     * Required for multishot operations; `more` is `false` on the final CQE.
+     */
+    void (*on_completion)(io_operation& operation, int result,
+                          bool more) noexcept {nullptr};
+    /// Opaque owner pointer available to `on_completion`.
+    void *context{nullptr};
+    /// Provided-buffer id filled by the latest completion, or `-1`.
+    int buffer_id{-1};
+    /// Scheduler-assigned submission token.
+    std::uint64_t token{0};
+};
+
+/**
+ * @brief Caller-owned state for one scheduler timer.
+ *
+ * Like `io_operation`, the object must stay at a stable address until the
+ * scheduler resumes `handle` or the timer is abandoned.
+ */
+struct timer_operation {
+    /// Coroutine resumed when the timer fires or is cancelled.
+    std::coroutine_handle<> handle{};
+    /// `0` when the deadline was reached, `-ECANCELED` after `cancel_timer()`.
+    int result{0};
+    /// Wheel hook used by schedulers that keep timers in user space.
+    timer_entry entry{};
+    /// Scheduler-assigned submission token while the timer is armed.
+    std::uint64_t token{0};
+};
+
+/**
+ * @brief Caller-owned state for one readiness wait.
+ *
+ * The scheduler writes the outcome into `status` before resuming `handle`,
+ * and keeps the wait's deadline hook and token here rather than in its
+ * per-descriptor table, which then holds only a pointer per direction.
+ * The object must stay at a stable address until `handle` is resumed.
+ */
+struct wait_operation {
+    /// Coroutine resumed on readiness, deadline expiry or cancellation.
+    std::coroutine_handle<> handle{};
+    /**
+     * Wake-up outcome: success, the timeout error, `ECANCELED` or a poll
+     * error. Holds the timeout error while a deadline is armed.
+     */
+    result<void> status{ok()};
+    /// Wheel hook for the deadline, used by schedulers that time waits in
+    /// user space.
+    timer_entry timer{};
+    /// Scheduler-assigned submission token while the wait is armed.
+    std::uint64_t token{0};
+    /// Descriptor the wait is armed on, set by the scheduler.
+    int fd{-1};
+    /// Direction the wait is armed for, set by the scheduler.
+    bool readable{true};
+    /// Set by schedulers that left the deadline to the kernel, not `timer`.
+    bool kernel_deadline{false};
+    /**
+     * Set when the caller got `EAGAIN` on this descriptor since the loop
+     * last polled. Readiness the loop cached before then is stale and must
+     * not complete the wait.
+     */
+    bool after_would_block{false};
+    /**
+     * Set when a `unique_fd` owns `fd`, so its close reaches the loop's
+     * close listener and the loop may keep the descriptor registered
+     * between waits. Other descriptors are registered for one wait.
+     */
+    bool owned_fd{false};
+};
+
+/**
+ * @brief Caller-owned callback a scheduler runs on its loop thread.
+ *
+ * Posted with `scheduler::post_wakeup()` from any thread. The object must
+ * stay at a stable address until `run` is invoked or `withdraw_wakeup()`
+ * returns.
+ */
+struct remote_wakeup {
+    /// Invoked once per post on the loop thread.
+    void (*run)(remote_wakeup& wakeup) noexcept {nullptr};
+    /// Opaque owner pointer available to `run`.
+    void *context{nullptr};
+    /// Queue links owned by the scheduler.
+    remote_wakeup *prev{nullptr};
+    remote_wakeup *next{nullptr};
+    /// `true` while posted and not yet run.
+    bool queued{false};
+};
+
+/**
+ * @brief Caller-owned callback a loop runs once its ready queue drains.
+ *
+ * Deferred with `scheduler::defer_to_drain()` from the loop thread, it
+ * runs after the currently runnable tasks have had their turn and before
+ * the loop polls for I/O, so work those tasks batched up can be issued
+ * once per loop iteration. The object must stay at a stable address until
+ * `run` is invoked or `withdraw_drain_hook()` returns.
+ */
+struct drain_hook {
+    /// Invoked once per deferral on the loop thread.
+    void (*run)(drain_hook& hook) noexcept {nullptr};
+    /// Opaque owner pointer available to `run`.
+    void *context{nullptr};
+    /// Queue links owned by the scheduler.
+    drain_hook *prev{nullptr};
+    drain_hook *next{nullptr};
+    /// `true` while deferred and not yet run.
+    bool queued{false};
+};
+
+/**
+ * @brief Heap node for work handed to a loop with `scheduler::post()`.
+ *
+ * Nodes are linked through a lock-free multi-producer queue and freed by
+ * `complete`, which either runs the work on the loop thread or, when the
+ * loop is destroyed first, only discards it.
+ */
+struct posted_work {
+    /// Queue link owned by the scheduler.
+    std::atomic<posted_work *> next{nullptr};
+    /// Run (`run == true`) or discard the work, then free the node.
+    void (*complete)(posted_work& work, bool run) noexcept {nullptr};
+};
+
+class scheduler;
+
+namespace detail {
+
+/// Intrusive links of a task owned by a `task_list`.
+struct task_link {
+    task_link *prev{nullptr};
+    task_link *next{nullptr};
+    /// Frame of the linked task.
+    std::coroutine_handle<> frame{};
+};
+
+/**
+ * @brief Unordered intrusive list of task frames.
+ *
+ * Insertion and removal are O(1) and never allocate: the links live in the
+ * tasks' promises.
+ */
+class task_list {
+public:
+    task_list() noexcept = default;
+    task_list(const task_list&) = delete;
+    task_list& operator=(const task_list&) = delete;
+
+    [[nodiscard]] bool empty() const noexcept {
+        return head_ == nullptr;
+    }
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+    /// @return First linked task, or `nullptr`.
+    [[nodiscard]] task_link *front() const noexcept {
+        return head_;
+    }
+
+    void push(task_link& link) noexcept {
+        link.prev = nullptr;
+        link.next = head_;
+        if (head_ != nullptr) {
+            head_->prev = &link;
+        }
+        head_ = &link;
+        ++size_;
+    }
+
+    void erase(task_link& link) noexcept {
+        if (link.prev != nullptr) {
+            link.prev->next = link.next;
+        } else {
+            head_ = link.next;
+        }
+        if (link.next != nullptr) {
+            link.next->prev = link.prev;
+        }
+        link.prev = nullptr;
+        link.next = nullptr;
+        --size_;
+    }
+
+private:
+    task_link *head_{nullptr};
+    std::size_t size_{0};
+};
+
+/// `posted_work` that resumes a coroutine through its target scheduler.
+struct posted_handle final : posted_work {
+    std::coroutine_handle<> handle{};
+    scheduler *target{nullptr};
+
+    static void complete_node(posted_work& work, bool run) noexcept;
+};
+
+/// `posted_work` owning a callable.
+template <class Fn>
+struct posted_callable final : posted_work {
+    template <class U>
+    explicit posted_callable(U&& value) noexcept
+        : fn(std::forward<U>(value)) {
+        complete = &complete_node;
+    }
+
+    Fn fn;
+
+    static void complete_node(posted_work& work, bool run) noexcept {
+        auto *self = static_cast<posted_callable *>(&work);
+        if (run) {
+            self->fn();
+        }
+        delete self;
+    }
+};
+
+} // namespace detail
+
 /**
  * @brief Scheduling interface implemented by runtime event loops.
  */
@@ -27,42 +311,329 @@ public:
 
     /// @brief Queue a coroutine for execution/resume.
     virtual void schedule(std::coroutine_handle<> handle) noexcept = 0;
-    /// @brief Notify scheduler when a tracked root task reaches final suspend.
-    virtual void on_task_completed() noexcept = 0;
+    /**
+     * @brief Notify scheduler when a tracked root task reaches final suspend.
+     * @param root Links of the finished root, as set up by `spawn()`.
+     */
+    virtual void on_task_completed(detail::task_link& root) noexcept = 0;
+    /**
+     * @brief Forget a detached root that reached final suspend.
+     *
+     * The root destroys its own frame once this returns.
+     * @param root Links of the finished root, as set up by `spawn_detached()`.
+     */
+    virtual void on_detached_completed(detail::task_link& root) noexcept = 0;
     /**
      * @brief Register wait-until-readable interest for a descriptor.
      * @param fd Descriptor to monitor.
-     * @param handle Waiting coroutine.
-     * @param timeout Optional timeout.
-     * @param timeout_error Error returned if timeout expires.
+     * @param operation Wait state; `operation.handle` is resumed with
+     * `operation.status` filled in.
+     * @param deadline Optional absolute deadline; one wheel/timer entry.
+     * @param timeout_error Error returned if the deadline passes first.
      */
     virtual result<void>
-    wait_for_readable(int fd, std::coroutine_handle<> handle,
-                      std::optional<std::chrono::milliseconds> timeout,
+    wait_for_readable(int fd, wait_operation& operation,
+                      std::optional<std::chrono::steady_clock::time_point> deadline,
                       error timeout_error) noexcept = 0;
     /**
      * @brief Register wait-until-writable interest for a descriptor.
      * @param fd Descriptor to monitor.
-     * @param handle Waiting coroutine.
-     * @param timeout Optional timeout.
-     * @param timeout_error Error returned if timeout expires.
+     * @param operation Wait state; `operation.handle` is resumed with
+     * `operation.status` filled in.
+     * @param deadline Optional absolute deadline; one wheel/timer entry.
+     * @param timeout_error Error returned if the deadline passes first.
      */
     virtual result<void>
-    wait_for_writable(int fd, std::coroutine_handle<> handle,
-                      std::optional<std::chrono::milliseconds> timeout,
+    wait_for_writable(int fd, wait_operation& operation,
+                      std::optional<std::chrono::steady_clock::time_point> deadline,
                       error timeout_error) noexcept = 0;
+
+    /// @return `true` when `submit_io()` can complete socket operations.
+    [[nodiscard]] virtual bool supports_completion_io() const noexcept {
+        return false;
+    }
     /**
-     * @brief Retrieve wake-up outcome for a waiter coroutine.
-     * @param handle Coroutine handle used as waiter key.
+     * @brief Submit a completion-mode socket operation.
+     * @param operation Operation state; `operation.handle` is resumed with
+     * `operation.result` filled in.
      */
-    virtual result<void>
-    consume_wait_result(std::coroutine_handle<> handle) noexcept = 0;
+    [[nodiscard]] virtual result<void>
+    submit_io(io_operation& operation) noexcept {
+        (void)operation;
+        return err<void>(make_error_from_errno(EOPNOTSUPP));
+    }
+    /**
+     * @brief Cancel an in-flight operation and stop delivering its completions.
+     *
+     * After this returns the scheduler no longer touches `operation`. Only use
+     * for operations that do not reference caller memory (e.g. accept).
+     * @param operation Operation previously passed to `submit_io()`.
+     */
+    virtual void abandon_io(io_operation& operation) noexcept {
+        (void)operation;
+    }
+    /**
+     * @brief Access a scheduler-provided receive buffer.
+     * @param id Buffer id reported through `io_operation::buffer_id`.
+     */
+    [[nodiscard]] virtual std::span<std::byte>
+    provided_buffer(std::uint16_t id) noexcept {
+        (void)id;
+        return {};
+    }
+    /**
+     * @brief Return a provided buffer so the kernel can fill it again.
+     * @param id Buffer id reported through `io_operation::buffer_id`.
+     */
+    virtual void recycle_provided_buffer(std::uint16_t id) noexcept {
+        (void)id;
+    }
+
+    /**
+     * @brief Resume `operation.handle` once `deadline` has passed.
+     *
+     * Costs no system call of its own: the loop folds the timer into its
+     * next wait. At most one arm per operation may be outstanding.
+     * @param deadline Absolute expiry time.
+     * @param operation Timer state; `operation.result` is filled on resume.
+     */
+    [[nodiscard]] virtual result<void>
+    schedule_at(std::chrono::steady_clock::time_point deadline,
+                timer_operation& operation) noexcept {
+        (void)deadline;
+        (void)operation;
+        return err<void>(make_error_from_errno(EOPNOTSUPP));
+    }
+    /**
+     * @brief Cancel an armed timer; its handle resumes with `-ECANCELED`.
+     *
+     * Delivery may be deferred to the loop (e.g. until the cancel CQE
+     * arrives); a timer that already fired resumes with `0` instead.
+     * @return `true` when a cancellation was requested.
+     */
+    virtual bool cancel_timer(timer_operation& operation) noexcept {
+        (void)operation;
+        return false;
+    }
+    /**
+     * @brief Disarm a timer without resuming its handle.
+     *
+     * After this returns the scheduler no longer touches `operation`.
+     */
+    virtual void abandon_timer(timer_operation& operation) noexcept {
+        (void)operation;
+    }
+
+    /**
+     * @brief Resume a parked readiness waiter with `ECANCELED`.
+     *
+     * Only acts when `operation` is still the waiter registered for `fd`
+     * in that direction, so stale requests are harmless.
+     * @return `true` when a waiter was dequeued.
+     */
+    virtual bool cancel_wait(int fd, bool readable,
+                             wait_operation& operation) noexcept {
+        (void)fd;
+        (void)readable;
+        (void)operation;
+        return false;
+    }
+    /**
+     * @brief Submit `fd` by registered-file index from now on.
+     *
+     * Only completion-based backends have such a table. The descriptor is
+     * held open while registered, so call `unregister_file()` before
+     * closing it. Loop thread only.
+     * @return `EOPNOTSUPP` when the backend has no registered files.
+     */
+    [[nodiscard]] virtual result<void> register_file(int fd) noexcept {
+        (void)fd;
+        return err<void>(make_error_from_errno(EOPNOTSUPP));
+    }
+    /// @brief Undo `register_file(fd)`; a no-op for unregistered descriptors.
+    [[nodiscard]] virtual result<void> unregister_file(int fd) noexcept {
+        (void)fd;
+        return ok();
+    }
+    /**
+     * @brief Register `buffers` as fixed buffers for completion-based reads.
+     *
+     * Receives whose destination lies inside one of them skip the per-call
+     * page pinning. The memory must outlive the registration. Loop thread
+     * only.
+     * @return `EOPNOTSUPP` when the backend has no fixed buffers.
+     */
+    [[nodiscard]] virtual result<void>
+    register_buffers(std::span<const ::iovec> buffers) noexcept {
+        (void)buffers;
+        return err<void>(make_error_from_errno(EOPNOTSUPP));
+    }
+    /// @brief Drop buffers registered with `register_buffers()`.
+    [[nodiscard]] virtual result<void> unregister_buffers() noexcept {
+        return ok();
+    }
+    /**
+     * @brief Queue `wakeup.run` for the loop thread and wake the loop.
+     *
+     * The only scheduler entry point that may be called from any thread.
+     * Posting an already queued wakeup is a no-op.
+     */
+    virtual void post_wakeup(remote_wakeup& wakeup) noexcept {
+        (void)wakeup;
+    }
+    /**
+     * @brief Drop a posted wakeup that has not run yet (loop thread only).
+     *
+     * After this returns the scheduler no longer touches `wakeup`.
+     */
+    virtual void withdraw_wakeup(remote_wakeup& wakeup) noexcept {
+        (void)wakeup;
+    }
+    /**
+     * @brief Run `hook.run` once the ready queue next drains (loop thread only).
+     *
+     * Deferring an already queued hook is a no-op. A hook that defers
+     * itself again runs after the next, non-blocking, poll.
+     * @return `false` when the scheduler has no loop to defer to.
+     */
+    [[nodiscard]] virtual bool defer_to_drain(drain_hook& hook) noexcept {
+        (void)hook;
+        return false;
+    }
+    /**
+     * @brief Drop a deferred hook that has not run yet (loop thread only).
+     *
+     * After this returns the scheduler no longer touches `hook`.
+     */
+    virtual void withdraw_drain_hook(drain_hook& hook) noexcept {
+        (void)hook;
+    }
+    /**
+     * @brief Keep `run()` going while a wake-up is expected from elsewhere.
+     *
+     * For waits that no descriptor or timer of this loop will end, such as
+     * work handed to another thread that returns through `post_wakeup()`.
+     * Loop thread only; balance each call with `release_external()`.
+     */
+    virtual void retain_external() noexcept {}
+    /// @brief Drop one `retain_external()` hold (loop thread only).
+    virtual void release_external() noexcept {}
+
+    /**
+     * @brief Queue `work` for the loop thread; safe from any thread.
+     *
+     * A burst of posts costs one loop wake-up. Ownership of `work` passes
+     * to the scheduler only when this returns `true`.
+     */
+    [[nodiscard]] virtual bool post_work(posted_work& work) noexcept {
+        (void)work;
+        return false;
+    }
+
+    /**
+     * @brief Resume `handle` on this scheduler's loop; safe from any thread.
+     *
+     * The handle goes through `schedule()` on the loop thread. A coroutine
+     * parked this way should hold `retain_external()` so its loop keeps
+     * running until the post arrives.
+     * @return `ENOMEM`, or `EOPNOTSUPP` for schedulers without a loop.
+     */
+    [[nodiscard]] result<void> post(std::coroutine_handle<> handle) noexcept {
+        auto *node = new (std::nothrow) detail::posted_handle{};
+        if (node == nullptr) {
+            return err<void>(make_error_from_errno(ENOMEM));
+        }
+        node->complete = &detail::posted_handle::complete_node;
+        node->handle = handle;
+        node->target = this;
+        return submit_posted(*node);
+    }
+
+    /**
+     * @brief Run `fn()` on this scheduler's loop; safe from any thread.
+     * @tparam Fn Nothrow-invocable callable, nothrow-constructible from `fn`.
+     * @return `ENOMEM`, or `EOPNOTSUPP` for schedulers without a loop.
+     */
+    template <class Fn>
+        requires std::is_nothrow_invocable_v<std::decay_t<Fn>&> &&
+                 std::is_nothrow_constructible_v<std::decay_t<Fn>, Fn&&>
+    [[nodiscard]] result<void> post(Fn&& fn) noexcept {
+        using node_type = detail::posted_callable<std::decay_t<Fn>>;
+        auto *node = new (std::nothrow) node_type{std::forward<Fn>(fn)};
+        if (node == nullptr) {
+            return err<void>(make_error_from_errno(ENOMEM));
+        }
+        return submit_posted(*node);
+    }
+
+    /**
+     * @brief Bound how deep `co_await task` chains resume inline.
+     *
+     * Awaiting a child task transfers control to it directly (symmetric
+     * transfer) and a finished child transfers straight back, with no
+     * ready-queue round trip. With a nonzero `depth`, tasks nested deeper
+     * than that bounce through `schedule()` instead, giving other ready
+     * work a turn inside deeply recursive code. `0`, the default, never
+     * hops.
+     */
+    void set_inline_depth_limit(std::uint32_t depth) noexcept {
+        inline_depth_limit_ = depth;
+    }
+    /// @return Limit set by `set_inline_depth_limit()`; `0` is unlimited.
+    [[nodiscard]] std::uint32_t inline_depth_limit() const noexcept {
+        return inline_depth_limit_;
+    }
+
+private:
+    [[nodiscard]] result<void> submit_posted(posted_work& work) noexcept {
+        if (post_work(work)) {
+            return ok();
+        }
+        work.complete(work, false);
+        return err<void>(make_error_from_errno(EOPNOTSUPP));
+    }
+
+    std::uint32_t inline_depth_limit_{0};
 };
 
+inline void detail::posted_handle::complete_node(posted_work& work,
+                                                 bool run) noexcept {
+    auto *self = static_cast<posted_handle *>(&work);
+    if (run) {
+        self->target->schedule(self->handle);
+    }
+    delete self;
+}
+
 namespace detail {
 
+class task_promise_base;
+
+/**
+ * @brief Caller-owned hook that replaces a task's continuation.
+ *
+ * Set by `when_all()`, `when_any()` and `task_group` on the children they
+ * start. At final suspend the child calls `arrive` instead of resuming an
+ * awaiter; it returns the coroutine to transfer to, or
+ * `std::noop_coroutine()`, and may destroy the child's frame.
+ */
+struct task_join {
+    std::coroutine_handle<> (*arrive)(task_join& join,
+                                      std::coroutine_handle<> child) noexcept {
+        nullptr};
+};
+
 class task_promise_base {
 public:
+    /// Frames come from the calling thread's `frame_pool`.
+    [[nodiscard]] static void *operator new(std::size_t size) {
+        return allocate_frame(size);
+    }
+
+    static void operator delete(void *frame, std::size_t size) noexcept {
+        deallocate_frame(frame, size);
+    }
+
     task_promise_base() noexcept = default;
     ~task_promise_base() = default;
     task_promise_base(const task_promise_base&) = delete;
@@ -89,10 +660,52 @@ public:
         return tracked_;
     }
 
+    /// @brief Make a tracked root destroy its own frame at final suspend.
+    void set_detached() noexcept {
+        detached_ = true;
+    }
+
+    [[nodiscard]] bool detached() const noexcept {
+        return detached_;
+    }
+
+    /// @return Nesting depth below the root task (the root is `0`).
+    [[nodiscard]] std::uint32_t depth() const noexcept {
+        return depth_;
+    }
+
+    void set_depth(std::uint32_t value) noexcept {
+        depth_ = value;
+    }
+
+    /// @return `true` when this task must start and finish via `schedule()`.
+    [[nodiscard]] bool hops_through_scheduler() const noexcept {
+        return scheduler_ != nullptr && scheduler_->inline_depth_limit() != 0 &&
+               depth_ > scheduler_->inline_depth_limit();
+    }
+
+    /// @brief Report completion to `join` instead of a continuation.
+    void set_join(task_join *join) noexcept {
+        join_ = join;
+    }
+
+    [[nodiscard]] task_join *join() const noexcept {
+        return join_;
+    }
+
+    /// @return Links used by the `task_list` tracking this task.
+    [[nodiscard]] task_link& link() noexcept {
+        return link_;
+    }
+
 private:
     scheduler *scheduler_{nullptr};
     std::coroutine_handle<> continuation_{};
+    task_join *join_{nullptr};
+    task_link link_{};
+    std::uint32_t depth_{0};
     bool tracked_{false};
+    bool detached_{false};
 };
 
 struct task_final_awaiter {
@@ -101,25 +714,38 @@ struct task_final_awaiter {
     }
 
     template <class Promise>
-    void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> handle) noexcept {
         auto& promise = handle.promise();
         auto *scheduler = promise.scheduler_ptr();
 
         if (promise.tracked() && scheduler != nullptr) {
-            scheduler->on_task_completed();
+            if (promise.detached()) {
+                // Nobody holds the result; free the frame now.
+                scheduler->on_detached_completed(promise.link());
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            scheduler->on_task_completed(promise.link());
+        }
+
+        if (auto *join = promise.join(); join != nullptr) {
+            // May destroy this frame; nothing below touches it.
+            return join->arrive(*join, handle);
         }
 
         const auto continuation = promise.continuation();
         if (!continuation) {
-            return;
+            return std::noop_coroutine();
         }
 
-        if (scheduler != nullptr) {
+        if (promise.hops_through_scheduler()) {
             scheduler->schedule(continuation);
-            return;
+            return std::noop_coroutine();
         }
 
-        continuation.resume();
+        // Transfer straight back to the awaiter.
+        return continuation;
     }
 
     void await_resume() const noexcept {}
@@ -236,7 +862,8 @@ public:
 
         /// @brief Wire continuation and schedule/resume child coroutine.
         template <class Promise>
-        bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
             auto& child = handle_.promise();
             child.set_continuation(awaiting);
 
@@ -245,16 +872,16 @@ public:
                     child.set_scheduler(awaiting.promise().scheduler_ptr(),
                                         false);
                 }
+                child.set_depth(awaiting.promise().depth() + 1);
             }
 
-            auto *scheduler = child.scheduler_ptr();
-            if (scheduler != nullptr) {
-                scheduler->schedule(handle_);
-                return true;
+            if (child.hops_through_scheduler()) {
+                child.scheduler_ptr()->schedule(handle_);
+                return std::noop_coroutine();
             }
 
-            handle_.resume();
-            return false;
+            // Symmetric transfer: run the child now, without a queue hop.
+            return handle_;
         }
 
         /// @brief Return child result or rethrow child exception.
@@ -384,7 +1011,8 @@ public:
 
         /// @brief Wire continuation and schedule/resume child coroutine.
         template <class Promise>
-        bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
             auto& child = handle_.promise();
             child.set_continuation(awaiting);
 
@@ -393,16 +1021,16 @@ public:
                     child.set_scheduler(awaiting.promise().scheduler_ptr(),
                                         false);
                 }
+                child.set_depth(awaiting.promise().depth() + 1);
             }
 
-            auto *scheduler = child.scheduler_ptr();
-            if (scheduler != nullptr) {
-                scheduler->schedule(handle_);
-                return true;
+            if (child.hops_through_scheduler()) {
+                child.scheduler_ptr()->schedule(handle_);
+                return std::noop_coroutine();
             }
 
-            handle_.resume();
-            return false;
+            // Symmetric transfer: run the child now, without a queue hop.
+            return handle_;
         }
 
         /// @brief Rethrow child exception, if any.
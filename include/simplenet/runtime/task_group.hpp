@@ -0,0 +1,545 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Structured concurrency: `when_all()`, `when_any()` and `task_group`.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/// Value `when_all()` yields for a `task<T>`; `std::monostate` for `void`.
+template <class T>
+using when_all_value_t =
+    std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+/// First task to finish in a `when_any()`, with its result.
+template <class T>
+struct when_any_result {
+    /// Position of the winner among the awaited tasks.
+    std::size_t index{0};
+    T value;
+};
+
+/// First task to finish in a `when_any()` over `task<void>`.
+template <>
+struct when_any_result<void> {
+    /// Position of the winner among the awaited tasks.
+    std::size_t index{0};
+};
+
+namespace detail {
+
+/// @return `work`'s handle; `work` keeps ownership.
+template <class T>
+[[nodiscard]] typename task<T>::handle_type
+peek_handle(task<T>& work) noexcept {
+    auto handle = work.release();
+    work = task<T>{handle};
+    return handle;
+}
+
+/**
+ * @brief Start `child` inline on the awaiting task's scheduler.
+ *
+ * It runs until its first suspension and reports completion to `join`.
+ */
+template <class Promise, class Child>
+void start_child(std::coroutine_handle<Promise> awaiting,
+                 std::coroutine_handle<Child> child, task_join& join) noexcept {
+    auto& promise = child.promise();
+    if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+        if (promise.scheduler_ptr() == nullptr) {
+            promise.set_scheduler(awaiting.promise().scheduler_ptr(), false);
+        }
+        promise.set_depth(awaiting.promise().depth() + 1);
+    }
+    promise.set_join(&join);
+    child.resume();
+}
+
+/// @return The finished child's result; rethrows its exception.
+template <class T>
+when_all_value_t<T> consume_child(typename task<T>::handle_type handle) {
+    if (!handle) {
+        throw std::logic_error("awaited task has no coroutine handle");
+    }
+    if constexpr (std::is_void_v<T>) {
+        handle.promise().consume_result();
+        return {};
+    } else {
+        return handle.promise().consume_result();
+    }
+}
+
+/**
+ * @brief Completion count shared by the children of one combinator.
+ *
+ * Holds an extra count while the children are started, so one that
+ * finishes synchronously cannot resume the awaiter from inside
+ * `await_suspend()`. Loop thread only.
+ */
+class join_counter : public task_join {
+public:
+    explicit join_counter(
+        std::coroutine_handle<> (*on_arrive)(task_join&,
+                                             std::coroutine_handle<>) noexcept =
+            &arrive) noexcept
+        : task_join{on_arrive} {}
+
+    join_counter(const join_counter&) = delete;
+    join_counter& operator=(const join_counter&) = delete;
+
+    /// @brief Start `child` unless it is empty or already finished.
+    template <class Promise, class Child>
+    void start(std::coroutine_handle<Promise> awaiting,
+               std::coroutine_handle<Child> child) noexcept {
+        if (!child || child.done()) {
+            return;
+        }
+        awaiting_ = awaiting;
+        ++pending_;
+        start_child(awaiting, child, *this);
+    }
+
+    /// @return `true` when the awaiter must wait for running children.
+    [[nodiscard]] bool suspend(std::coroutine_handle<> awaiting) noexcept {
+        awaiting_ = awaiting;
+        return --pending_ != 0;
+    }
+
+protected:
+    /// @brief Count one child out; the last one resumes the awaiter.
+    [[nodiscard]] std::coroutine_handle<> finish() noexcept {
+        if (--pending_ == 0) {
+            return awaiting_;
+        }
+        return std::noop_coroutine();
+    }
+
+private:
+    static std::coroutine_handle<> arrive(task_join& join,
+                                          std::coroutine_handle<>) noexcept {
+        return static_cast<join_counter&>(join).finish();
+    }
+
+    std::coroutine_handle<> awaiting_{};
+    std::size_t pending_{1};
+};
+
+/// `join_counter` that records the first child to finish.
+class any_counter final : public join_counter {
+public:
+    explicit any_counter(const cancel_source& losers) noexcept
+        : join_counter(&arrive), losers_(losers) {}
+
+    /// @return `true` once a child has finished.
+    [[nodiscard]] bool decided() const noexcept {
+        return winner_ != nullptr;
+    }
+    /// @return Frame address of the first child to finish.
+    [[nodiscard]] void *winner() const noexcept {
+        return winner_;
+    }
+
+private:
+    static std::coroutine_handle<> arrive(task_join& join,
+                                          std::coroutine_handle<> child) noexcept {
+        auto& self = static_cast<any_counter&>(join);
+        if (self.winner_ == nullptr) {
+            self.winner_ = child.address();
+            (void)self.losers_.request_stop();
+        }
+        return self.finish();
+    }
+
+    cancel_source losers_;
+    void *winner_{nullptr};
+};
+
+} // namespace detail
+
+/**
+ * @brief Awaiter behind the variadic `when_all()`.
+ *
+ * Starts every child in order on the awaiting task's scheduler and resumes
+ * the awaiter when the last one finishes. The children's results arrive as
+ * one tuple; the first exception, in argument order, is rethrown.
+ */
+template <class... Ts>
+class when_all_awaiter {
+public:
+    explicit when_all_awaiter(task<Ts>&&...tasks) noexcept
+        : children_(std::move(tasks)...) {}
+
+    when_all_awaiter(const when_all_awaiter&) = delete;
+    when_all_awaiter& operator=(const when_all_awaiter&) = delete;
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return sizeof...(Ts) == 0;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        std::apply(
+            [&](auto&...child) {
+                (join_.start(awaiting, detail::peek_handle(child)), ...);
+            },
+            children_);
+        return join_.suspend(awaiting);
+    }
+
+    std::tuple<when_all_value_t<Ts>...> await_resume() {
+        return collect(std::index_sequence_for<Ts...>{});
+    }
+
+private:
+    template <std::size_t... I>
+    std::tuple<when_all_value_t<Ts>...> collect(std::index_sequence<I...>) {
+        return std::tuple<when_all_value_t<Ts>...>{detail::consume_child<Ts>(
+            detail::peek_handle(std::get<I>(children_)))...};
+    }
+
+    std::tuple<task<Ts>...> children_;
+    detail::join_counter join_{};
+};
+
+/**
+ * @brief Awaiter behind `when_all()` over a vector of tasks.
+ *
+ * Yields the results in input order (nothing for `task<void>`).
+ */
+template <class T>
+class when_all_range_awaiter {
+public:
+    explicit when_all_range_awaiter(std::vector<task<T>>&& tasks) noexcept
+        : children_(std::move(tasks)) {}
+
+    when_all_range_awaiter(const when_all_range_awaiter&) = delete;
+    when_all_range_awaiter& operator=(const when_all_range_awaiter&) = delete;
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return children_.empty();
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        for (auto& child : children_) {
+            join_.start(awaiting, detail::peek_handle(child));
+        }
+        return join_.suspend(awaiting);
+    }
+
+    auto await_resume() {
+        if constexpr (std::is_void_v<T>) {
+            for (auto& child : children_) {
+                detail::consume_child<void>(detail::peek_handle(child));
+            }
+        } else {
+            std::vector<T> values;
+            values.reserve(children_.size());
+            for (auto& child : children_) {
+                values.push_back(
+                    detail::consume_child<T>(detail::peek_handle(child)));
+            }
+            return values;
+        }
+    }
+
+private:
+    std::vector<task<T>> children_;
+    detail::join_counter join_{};
+};
+
+/**
+ * @brief Awaiter behind `when_any()`.
+ *
+ * Starts the children in order; the first to finish wins and triggers
+ * `losers.request_stop()`. Children that pass the source's token to their
+ * operations are resumed with `ECANCELED` right away. The awaiter resumes
+ * once every started child has finished, so none outlives the call. If a
+ * child wins before the others start, they never run.
+ *
+ * @tparam Tasks `std::array` or `std::vector` of `task<T>`.
+ */
+template <class T, class Tasks>
+class when_any_awaiter {
+public:
+    when_any_awaiter(const cancel_source& losers, Tasks&& tasks) noexcept
+        : children_(std::move(tasks)), join_(losers) {}
+
+    when_any_awaiter(const when_any_awaiter&) = delete;
+    when_any_awaiter& operator=(const when_any_awaiter&) = delete;
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return children_.empty();
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        for (auto& child : children_) {
+            if (join_.decided()) {
+                break;
+            }
+            join_.start(awaiting, detail::peek_handle(child));
+        }
+        return join_.suspend(awaiting);
+    }
+
+    /// @return The winner; rethrows its exception. Losers' results are dropped.
+    when_any_result<T> await_resume() {
+        for (std::size_t index = 0; index < children_.size(); ++index) {
+            auto handle = detail::peek_handle(children_[index]);
+            if (!handle || handle.address() != join_.winner()) {
+                continue;
+            }
+            if constexpr (std::is_void_v<T>) {
+                detail::consume_child<void>(handle);
+                return when_any_result<void>{index};
+            } else {
+                return when_any_result<T>{index,
+                                          detail::consume_child<T>(handle)};
+            }
+        }
+        throw std::logic_error("when_any has no finished task");
+    }
+
+private:
+    Tasks children_;
+    detail::any_counter join_;
+};
+
+/**
+ * @brief Run `tasks` concurrently on the awaiting task's loop.
+ *
+ * Nothing is allocated beyond the children's own frames. Awaiting yields
+ * `std::tuple<when_all_value_t<Ts>...>`.
+ */
+template <class... Ts>
+[[nodiscard]] when_all_awaiter<Ts...> when_all(task<Ts>&&...tasks) noexcept {
+    return when_all_awaiter<Ts...>{std::move(tasks)...};
+}
+
+/// @brief Run every task in `tasks` concurrently; yields results in order.
+template <class T>
+[[nodiscard]] when_all_range_awaiter<T>
+when_all(std::vector<task<T>> tasks) noexcept {
+    return when_all_range_awaiter<T>{std::move(tasks)};
+}
+
+/**
+ * @brief Run `tasks` concurrently until the first finishes.
+ * @param losers Source whose stop is requested once a task wins; pass its
+ * token to the children's operations to cut them short.
+ */
+template <class T, class... Rest>
+    requires(std::same_as<T, Rest> && ...)
+[[nodiscard]] when_any_awaiter<T, std::array<task<T>, 1 + sizeof...(Rest)>>
+when_any(const cancel_source& losers, task<T>&& first,
+         task<Rest>&&...rest) noexcept {
+    return when_any_awaiter<T, std::array<task<T>, 1 + sizeof...(Rest)>>{
+        losers, std::array<task<T>, 1 + sizeof...(Rest)>{std::move(first),
+                                                        std::move(rest)...}};
+}
+
+/// @brief `when_any()` over a vector of tasks.
+template <class T>
+[[nodiscard]] when_any_awaiter<T, std::vector<task<T>>>
+when_any(const cancel_source& losers, std::vector<task<T>> tasks) noexcept {
+    return when_any_awaiter<T, std::vector<task<T>>>{losers, std::move(tasks)};
+}
+
+/**
+ * @brief Nursery scope for a dynamic set of concurrent child tasks.
+ *
+ * `co_await group.spawn(child)` starts the child on the awaiting task's
+ * loop and returns at its first suspension; `co_await group.join()` waits
+ * for every child. Children that fail, by returning an error or throwing,
+ * request stop on `token()`, so siblings that pass it to their operations
+ * wind down too; `join()` yields the first error and rethrows the first
+ * exception. Finished children are destroyed at once, and the group never
+ * allocates: its bookkeeping lives in the children's frames.
+ *
+ * Loop thread only. Destroying the group destroys children still running;
+ * await `join()` first unless the loop is being torn down.
+ */
+class task_group {
+    struct child_join : detail::task_join {
+        task_group *group{nullptr};
+    };
+
+public:
+    /// @brief Awaiter behind `spawn()`.
+    template <class T>
+    class spawn_awaiter {
+    public:
+        spawn_awaiter(task_group& group, task<T>&& child) noexcept
+            : group_(group), child_(child.release()) {}
+
+        ~spawn_awaiter() {
+            if (child_) {
+                child_.destroy();
+            }
+        }
+
+        spawn_awaiter(const spawn_awaiter&) = delete;
+        spawn_awaiter& operator=(const spawn_awaiter&) = delete;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return !child_ || child_.done();
+        }
+
+        template <class Promise>
+        bool await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+            auto child = std::exchange(child_, {});
+            child.promise().link().frame = child;
+            group_.children_.push(child.promise().link());
+            detail::start_child(awaiting, child,
+                                std::is_void_v<T> ? group_.void_join_
+                                                  : group_.result_join_);
+            return false;
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        task_group& group_;
+        typename task<T>::handle_type child_{};
+    };
+
+    /// @brief Awaiter behind `join()`.
+    class join_awaiter {
+    public:
+        explicit join_awaiter(task_group& group) noexcept : group_(group) {}
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return group_.children_.empty();
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            group_.joiner_ = awaiting;
+        }
+
+        /// @return First child error; rethrows the first child exception.
+        result<void> await_resume() {
+            if (group_.exception_ != nullptr) {
+                std::rethrow_exception(std::exchange(group_.exception_, nullptr));
+            }
+            return group_.status_;
+        }
+
+    private:
+        task_group& group_;
+    };
+
+    task_group() = default;
+    ~task_group() {
+        while (!children_.empty()) {
+            auto& link = *children_.front();
+            children_.erase(link);
+            link.frame.destroy();
+        }
+    }
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+    task_group(task_group&&) = delete;
+    task_group& operator=(task_group&&) = delete;
+
+    /**
+     * @brief Start `child` as a member of this group.
+     * @tparam T `void` or `result<void>`.
+     */
+    template <class T>
+        requires(std::is_void_v<T> || std::same_as<T, result<void>>)
+    [[nodiscard]] spawn_awaiter<T> spawn(task<T>&& child) noexcept {
+        return spawn_awaiter<T>{*this, std::move(child)};
+    }
+
+    /// @return Awaiter that resumes once no child is running.
+    [[nodiscard]] join_awaiter join() noexcept {
+        return join_awaiter{*this};
+    }
+
+    /// @return Token stopped by `cancel()` or the first child failure.
+    [[nodiscard]] cancel_token token() const {
+        return source_.token();
+    }
+
+    /// @brief Request stop on `token()`.
+    /// @return `true` for the call that made the request.
+    bool cancel() const noexcept {
+        return source_.request_stop();
+    }
+
+    /// @return Children still running.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return children_.size();
+    }
+
+private:
+    template <class T>
+    static std::coroutine_handle<> arrive(detail::task_join& join,
+                                          std::coroutine_handle<> child) noexcept {
+        auto& group = *static_cast<child_join&>(join).group;
+        auto handle = task<T>::handle_type::from_address(child.address());
+        try {
+            if constexpr (std::is_void_v<T>) {
+                handle.promise().consume_result();
+            } else {
+                auto status = handle.promise().consume_result();
+                if (!status.has_value()) {
+                    group.fail(status.error());
+                }
+            }
+        } catch (...) {
+            group.fail(std::current_exception());
+        }
+
+        group.children_.erase(handle.promise().link());
+        handle.destroy();
+        if (group.children_.empty() && group.joiner_) {
+            return std::exchange(group.joiner_, {});
+        }
+        return std::noop_coroutine();
+    }
+
+    void fail(const error& failure) noexcept {
+        if (status_.has_value() && exception_ == nullptr) {
+            status_ = err<void>(failure);
+        }
+        (void)source_.request_stop();
+    }
+
+    void fail(std::exception_ptr failure) noexcept {
+        if (status_.has_value() && exception_ == nullptr) {
+            exception_ = std::move(failure);
+        }
+        (void)source_.request_stop();
+    }
+
+    cancel_source source_{};
+    detail::task_list children_{};
+    child_join void_join_{{&arrive<void>}, this};
+    child_join result_join_{{&arrive<result<void>>}, this};
+    std::coroutine_handle<> joiner_{};
+    result<void> status_{ok()};
+    std::exception_ptr exception_{};
+};
+
+} // namespace simplenet::runtime
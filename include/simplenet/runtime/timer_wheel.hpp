@@ -0,0 +1,175 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Hierarchical timing wheel shared by runtime event loops.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace simplenet::runtime {
+
+class timer_wheel;
+
+namespace detail {
+
+/// Intrusive doubly linked list hook used by timer wheel slots.
+struct timer_link {
+    timer_link* prev{nullptr};
+    timer_link* next{nullptr};
+};
+
+} // namespace detail
+
+/**
+ * @brief Intrusive timer node embedded in the state it times out.
+ *
+ * The owner keeps the entry at a stable address while it is scheduled and
+ * must cancel it before destroying or reusing the enclosing object.
+ */
+class timer_entry : private detail::timer_link {
+public:
+    timer_entry() noexcept = default;
+    /// Destroying a scheduled entry is a bug; owners cancel first.
+    ~timer_entry() = default;
+
+    timer_entry(const timer_entry&) = delete;
+    timer_entry& operator=(const timer_entry&) = delete;
+    timer_entry(timer_entry&&) = delete;
+    timer_entry& operator=(timer_entry&&) = delete;
+
+    /// @return `true` while the entry is linked into a wheel.
+    [[nodiscard]] bool scheduled() const noexcept {
+        return next != nullptr;
+    }
+
+    /// @return Deadline passed to the last `timer_wheel::schedule` call.
+    [[nodiscard]] std::chrono::steady_clock::time_point
+    deadline() const noexcept {
+        return deadline_;
+    }
+
+    /// Owner-defined pointer handed back through expiry callbacks.
+    void* context{nullptr};
+    /// Owner-defined discriminator when one wheel times several kinds of state.
+    std::uint32_t tag{0};
+
+private:
+    friend class timer_wheel;
+
+    std::chrono::steady_clock::time_point deadline_{};
+    std::uint64_t expiry_tick_{0};
+    std::uint8_t level_{0};
+    std::uint8_t slot_{0};
+};
+
+/**
+ * @brief Four-level hashed timing wheel with 1 ms resolution.
+ *
+ * Scheduling and cancellation are O(1). `expire` jumps straight between
+ * non-empty slots, cascading coarse levels down as time advances, so its
+ * cost is proportional to expired entries plus at most three re-placements
+ * per entry.
+ *
+ * Timers never fire early; they may fire up to one tick late.
+ */
+class timer_wheel {
+public:
+    using clock = std::chrono::steady_clock;
+    /// Wheel resolution.
+    using tick = std::chrono::milliseconds;
+
+    /// Number of slots per level.
+    static constexpr std::size_t slots_per_level = 256;
+    /// Number of wheel levels; together they span 2^32 ticks (~49 days).
+    static constexpr std::size_t level_count = 4;
+
+    /// Construct an empty wheel whose tick zero is `epoch`.
+    explicit timer_wheel(clock::time_point epoch = clock::now()) noexcept;
+    ~timer_wheel() = default;
+
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+    timer_wheel(timer_wheel&&) = delete;
+    timer_wheel& operator=(timer_wheel&&) = delete;
+
+    /**
+     * @brief Schedule (or reschedule) an entry.
+     *
+     * Deadlines already in the past expire on the next `expire` call.
+     */
+    void schedule(timer_entry& entry, clock::time_point deadline) noexcept;
+    /// @brief Unlink an entry; no-op when it is not scheduled.
+    void cancel(timer_entry& entry) noexcept;
+
+    /**
+     * @brief Advance to `now` and invoke `on_expired(timer_entry&)` per due entry.
+     *
+     * Each entry is unlinked before its callback runs, so callbacks may
+     * reschedule it or cancel other entries (including ones still pending
+     * in this pass).
+     *
+     * @return Number of callbacks invoked.
+     */
+    template <class Fn>
+    std::size_t expire(clock::time_point now, Fn&& on_expired) noexcept {
+        advance(now);
+        std::size_t fired = 0;
+        while (expired_.next != &expired_) {
+            auto& entry = *static_cast<timer_entry*>(expired_.next);
+            unlink(entry);
+            ++fired;
+            on_expired(entry);
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Earliest point at which `expire` has work to do.
+     *
+     * Exact for timers within the current 256-tick window, otherwise the
+     * next cascade point (which never lies after the earliest deadline).
+     */
+    [[nodiscard]] std::optional<clock::time_point>
+    next_expiry() const noexcept;
+
+    /// @return Number of scheduled entries.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+    /// @return `true` when no entry is scheduled.
+    [[nodiscard]] bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+private:
+    static constexpr std::uint8_t kExpiredLevel = 0xFF;
+    static constexpr std::size_t kBitmapWords = slots_per_level / 64;
+
+    using bitmap = std::array<std::uint64_t, kBitmapWords>;
+
+    void advance(clock::time_point now) noexcept;
+    [[nodiscard]] std::optional<std::uint64_t> next_event_tick() const noexcept;
+    void place(timer_entry& entry) noexcept;
+    void cascade(std::size_t level, std::size_t slot) noexcept;
+    void move_to_expired(std::size_t slot) noexcept;
+    void link_tail(detail::timer_link& head, timer_entry& entry) noexcept;
+    void unlink(timer_entry& entry) noexcept;
+    [[nodiscard]] std::optional<std::size_t>
+    next_occupied(std::size_t level, std::size_t from) const noexcept;
+    [[nodiscard]] std::uint64_t to_tick(clock::time_point point) const noexcept;
+
+    clock::time_point epoch_;
+    std::uint64_t current_tick_{0};
+    std::size_t size_{0};
+    std::array<std::array<detail::timer_link, slots_per_level>, level_count>
+        slots_{};
+    std::array<bitmap, level_count> occupied_{};
+    detail::timer_link expired_{};
+};
+
+} // namespace simplenet::runtime
@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Byte-rate token bucket used to pace queued writers.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Token bucket counting bytes.
+ *
+ * Tokens accrue at `rate()` bytes per second up to `burst()` and are spent
+ * by `consume()`. The bucket refills lazily from the time passed to each
+ * call, so an idle bucket costs nothing. Share one through
+ * `pacing::shared` to cap several writers in aggregate, e.g. every
+ * connection of a tenant. Not thread-safe: its writers must run on one
+ * loop.
+ */
+class token_bucket {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Construct a full bucket.
+     * @param rate Refill rate in bytes per second; `0` never limits.
+     * @param burst Capacity in bytes; `0` picks 10 ms worth of `rate`,
+     *        at least 1 KiB.
+     */
+    explicit token_bucket(std::uint64_t rate, std::size_t burst = 0,
+                          clock::time_point now = clock::now()) noexcept;
+
+    /**
+     * @brief Change rate and capacity; tokens above the new capacity are
+     *        dropped.
+     */
+    void set_rate(std::uint64_t rate, std::size_t burst = 0,
+                  clock::time_point now = clock::now()) noexcept;
+
+    /// @return Whole bytes that may be sent at `now`.
+    [[nodiscard]] std::size_t available(clock::time_point now = clock::now()) noexcept;
+    /// Spend `bytes`; callers send at most `available()` first.
+    void consume(std::size_t bytes) noexcept;
+    /**
+     * @brief Earliest time `bytes`, capped at `burst()`, are available.
+     * @return `now` when they already are.
+     */
+    [[nodiscard]] clock::time_point ready_at(std::size_t bytes,
+                                             clock::time_point now = clock::now()) noexcept;
+
+    /// @return Refill rate in bytes per second.
+    [[nodiscard]] std::uint64_t rate() const noexcept;
+    /// @return Capacity in bytes.
+    [[nodiscard]] std::size_t burst() const noexcept;
+
+private:
+    void refill(clock::time_point now) noexcept;
+
+    std::uint64_t rate_{0};
+    std::size_t burst_{0};
+    double tokens_{0.0};
+    clock::time_point updated_{};
+};
+
+} // namespace simplenet::runtime
@@ -6,7 +6,16 @@
  */
 
 #include "simplenet/core/unique_fd.hpp"
+#include "simplenet/runtime/drain_queue.hpp"
+#include "simplenet/runtime/fd_table.hpp"
+#include "simplenet/runtime/loop_metrics.hpp"
+#include "simplenet/runtime/loop_watchdog.hpp"
 #include "simplenet/runtime/task.hpp"
+#include "simplenet/runtime/timer_wheel.hpp"
+#include "simplenet/runtime/post_queue.hpp"
+#include "simplenet/runtime/resume_budget.hpp"
+#include "simplenet/runtime/wakeup_queue.hpp"
+#include "simplenet/uring/buffer_ring.hpp"
 #include "simplenet/uring/reactor.hpp"
 
 #include <atomic>
@@ -17,21 +26,38 @@
 #include <cstdint>
 #include <deque>
 #include <optional>
+#include <span>
+#include <sys/uio.h>
 #include <unordered_map>
 #include <vector>
 
 namespace simplenet::runtime {
 
+/// Ring setup options for `uring_event_loop`.
+using uring_options = simplenet::uring::ring_options;
+
 /**
- * @brief Coroutine scheduler/event loop backed by `io_uring` poll operations.
+ * @brief Coroutine scheduler/event loop backed by `io_uring`.
+ *
+ * Socket operations submitted through `submit_io()` complete directly from
+ * CQEs; readiness waits use poll operations.
  */
 class uring_event_loop final : public scheduler {
 public:
+    /// Sockets complete through `submit_io()` on a `valid()` ring.
+    static constexpr bool completion_io = true;
+
     /**
      * @brief Construct loop and initialize `io_uring`.
      * @param queue_depth Ring queue depth.
      */
     explicit uring_event_loop(std::uint32_t queue_depth = 256) noexcept;
+    /**
+     * @brief Construct loop with explicit ring setup options.
+     *
+     * Flags the kernel rejects are dropped; see `setup_flags()`.
+     */
+    explicit uring_event_loop(const uring_options& options) noexcept;
     /// Destroy loop and outstanding root tasks.
     ~uring_event_loop() override;
 
@@ -42,10 +68,42 @@ public:
 
     /// @return `true` when initialization succeeded.
     [[nodiscard]] bool valid() const noexcept;
+    /// @return `IORING_SETUP_*` flags the ring actually runs with.
+    [[nodiscard]] std::uint32_t setup_flags() const noexcept;
     /// @brief Run loop until all root tasks complete or `stop()` is requested.
     [[nodiscard]] result<void> run() noexcept;
     /// @brief Request loop shutdown.
     void stop() noexcept;
+    /**
+     * @brief Set how many completions one wait may reap.
+     *
+     * Same growth rule as `event_loop::set_poll_batch()`: a full batch
+     * doubles it, up to `max_size`.
+     * @param size Batch size; `0` is treated as `1`.
+     * @param max_size Growth limit; `0` (or `<= size`) keeps it fixed.
+     */
+    void set_poll_batch(std::size_t size, std::size_t max_size = 0) noexcept;
+    /// @brief Bound each ready-queue pass; see `event_loop::set_resume_budget()`.
+    void set_resume_budget(std::size_t max_resumes,
+                           std::chrono::microseconds max_time = {}) noexcept;
+    /**
+     * @return `true` when timed waits link an `IORING_OP_LINK_TIMEOUT` to
+     * their poll, so the kernel enforces the deadline; otherwise they sit
+     * on the loop's timer wheel.
+     */
+    [[nodiscard]] bool uses_linked_timeouts() const noexcept;
+    /// @return Current completion batch size.
+    [[nodiscard]] std::size_t poll_batch() const noexcept;
+    /// @return Instrumentation snapshot; same contract as `event_loop::metrics()`.
+    [[nodiscard]] loop_metrics metrics() const noexcept;
+    /// @brief Fill the latency histograms; see `event_loop::set_latency_sampling()`.
+    void set_latency_sampling(bool on) noexcept;
+    /// @brief Install (or, with `nullptr`, remove) the metrics exporter.
+    void set_metrics_hook(metrics_hook *hook) noexcept;
+    /// @brief Report slow resumes; see `event_loop::set_watchdog()`.
+    void set_watchdog(watchdog_hook *hook) noexcept;
+    /// @return Resume in progress, for `stall_monitor::watch()`.
+    [[nodiscard]] const loop_heartbeat& heartbeat() const noexcept;
 
     /**
      * @brief Spawn a root task tracked by this loop.
@@ -60,80 +118,188 @@ public:
         }
 
         handle.promise().set_scheduler(this, true);
+        handle.promise().link().frame = handle;
         ++active_task_count_;
-        root_tasks_.push_back(handle);
+        live_roots_.push(handle.promise().link());
+        schedule(handle);
+    }
+
+    /**
+     * @brief Spawn a root task that frees its frame as soon as it finishes.
+     *
+     * Its result and any exception are discarded. Until then it is tracked
+     * like `spawn()`, so `run()` waits for it and teardown destroys it.
+     * @tparam T Task result type.
+     * @param work Task object to transfer.
+     */
+    template <class T>
+    void spawn_detached(task<T>&& work) noexcept {
+        auto handle = work.release();
+        if (!handle) {
+            return;
+        }
+
+        handle.promise().set_scheduler(this, true);
+        handle.promise().set_detached();
+        handle.promise().link().frame = handle;
+        ++active_task_count_;
+        live_roots_.push(handle.promise().link());
         schedule(handle);
     }
 
     /// @brief Queue a coroutine for resume on the loop thread.
     void schedule(std::coroutine_handle<> handle) noexcept override;
-    /// @brief Notify loop that a tracked root task has finished.
-    void on_task_completed() noexcept override;
+    /// @brief Move a finished root onto the list destroyed after its resume.
+    void on_task_completed(detail::task_link& root) noexcept override;
+    /// @brief Unlink a finished detached root before it frees itself.
+    void on_detached_completed(detail::task_link& root) noexcept override;
     /// @brief Suspend coroutine until descriptor is readable.
     [[nodiscard]] result<void>
-    wait_for_readable(int fd, std::coroutine_handle<> handle,
-                      std::optional<std::chrono::milliseconds> timeout,
+    wait_for_readable(int fd, wait_operation& operation,
+                      std::optional<std::chrono::steady_clock::time_point> deadline,
                       error timeout_error) noexcept override;
     /// @brief Suspend coroutine until descriptor is writable.
     [[nodiscard]] result<void>
-    wait_for_writable(int fd, std::coroutine_handle<> handle,
-                      std::optional<std::chrono::milliseconds> timeout,
+    wait_for_writable(int fd, wait_operation& operation,
+                      std::optional<std::chrono::steady_clock::time_point> deadline,
                       error timeout_error) noexcept override;
-    /// @brief Consume readiness/timeout result produced for a waiting coroutine.
+    /// @brief Resume a coroutine once `deadline` passes.
     [[nodiscard]] result<void>
-    consume_wait_result(std::coroutine_handle<> handle) noexcept override;
+    schedule_at(std::chrono::steady_clock::time_point deadline,
+                timer_operation& operation) noexcept override;
+    /// @brief Cancel an armed timer, resuming it with `-ECANCELED`.
+    bool cancel_timer(timer_operation& operation) noexcept override;
+    /// @brief Disarm a timer without resuming it.
+    void abandon_timer(timer_operation& operation) noexcept override;
+    /// @brief Dequeue a readiness waiter, resuming it with `ECANCELED`.
+    bool cancel_wait(int fd, bool readable,
+                     wait_operation& operation) noexcept override;
+    /// @brief Queue a callback for the loop thread; safe from any thread.
+    void post_wakeup(remote_wakeup& wakeup) noexcept override;
+    /// @brief Drop a posted callback that has not run yet.
+    void withdraw_wakeup(remote_wakeup& wakeup) noexcept override;
+    /**
+     * @brief Submit `fd` with `IOSQE_FIXED_FILE` until `unregister_file()`.
+     *
+     * Every later poll, receive, send, accept and connect on `fd` uses the
+     * registered slot. Unregister before closing the descriptor.
+     */
+    [[nodiscard]] result<void> register_file(int fd) noexcept override;
+    /// @brief Release the registered slot of `fd`.
+    [[nodiscard]] result<void> unregister_file(int fd) noexcept override;
+    /// @brief Register fixed buffers; receives into them use `READ_FIXED`.
+    [[nodiscard]] result<void>
+    register_buffers(std::span<const ::iovec> buffers) noexcept override;
+    /// @brief Drop the fixed buffers.
+    [[nodiscard]] result<void> unregister_buffers() noexcept override;
+    /// @brief Run `hook` after the ready queue drains, before polling.
+    [[nodiscard]] bool defer_to_drain(drain_hook& hook) noexcept override;
+    /// @brief Drop a deferred hook that has not run yet.
+    void withdraw_drain_hook(drain_hook& hook) noexcept override;
+    /// @brief Keep `run()` alive for a wake-up expected from another thread.
+    void retain_external() noexcept override;
+    /// @brief Drop one `retain_external()` hold.
+    void release_external() noexcept override;
+    /// @brief Queue posted work; safe from any thread, one wake-up per burst.
+    [[nodiscard]] bool post_work(posted_work& work) noexcept override;
+    /// @return `true` when the ring is usable for completion-mode I/O.
+    [[nodiscard]] bool supports_completion_io() const noexcept override;
+    /// @brief Submit a recv/send/accept/connect operation to the ring.
+    [[nodiscard]] result<void>
+    submit_io(io_operation& operation) noexcept override;
+    /// @brief Cancel an operation and drop its remaining completions.
+    void abandon_io(io_operation& operation) noexcept override;
+    /// @brief Access a buffer from the loop's provided-buffer ring.
+    [[nodiscard]] std::span<std::byte>
+    provided_buffer(std::uint16_t id) noexcept override;
+    /// @brief Return a buffer to the loop's provided-buffer ring.
+    void recycle_provided_buffer(std::uint16_t id) noexcept override;
 
-private:
-    struct wait_registration {
-        std::coroutine_handle<> handle{};
-        std::optional<std::chrono::steady_clock::time_point> deadline{};
-        error timeout_error = make_error_from_errno(ETIMEDOUT);
-        std::uint64_t token{0};
-    };
+    /// Number of buffers in the lazily created provided-buffer ring.
+    static constexpr std::uint16_t provided_buffer_count = 256;
+    /// Size of each provided buffer in bytes.
+    static constexpr std::size_t provided_buffer_size = 4096;
 
+private:
+    /// Armed waits; deadlines and poll tokens live in the operations.
     struct waiter_slot {
-        wait_registration readable{};
-        wait_registration writable{};
+        wait_operation *readable{nullptr};
+        wait_operation *writable{nullptr};
     };
 
-    struct poll_context {
-        int fd{-1};
-        bool readable{true};
+    struct inflight_timer {
+        /// Armed operation, or `nullptr` once abandoned.
+        timer_operation *operation{nullptr};
+        /// Absolute expiry read by the kernel when the SQE is submitted.
+        __kernel_timespec expiry{};
     };
 
     [[nodiscard]] result<void>
-    arm_waiter(int fd, std::coroutine_handle<> handle, bool readable,
-               std::optional<std::chrono::milliseconds> timeout,
+    arm_waiter(int fd, wait_operation& operation, bool readable,
+               std::optional<std::chrono::steady_clock::time_point> deadline,
                error timeout_error) noexcept;
     [[nodiscard]] result<void> queue_poll_add(std::uint64_t token, int fd,
                                               std::uint32_t poll_mask) noexcept;
-    [[nodiscard]] result<void> queue_poll_remove(std::uint64_t token) noexcept;
+    [[nodiscard]] result<void>
+    queue_timed_poll_add(std::uint64_t token, int fd, std::uint32_t poll_mask,
+                         std::chrono::steady_clock::time_point deadline) noexcept;
+    [[nodiscard]] result<void> queue_operation(std::uint64_t token,
+                                               io_operation& operation) noexcept;
+    [[nodiscard]] result<void> queue_cancel(std::uint64_t token) noexcept;
     [[nodiscard]] result<void> flush_submissions() noexcept;
+    void publish_metrics() noexcept;
+    [[nodiscard]] result<void> ensure_provided_buffers() noexcept;
+    void signal_wakeup() noexcept;
     void consume_wakeup() noexcept;
+    void run_remote_wakeups() noexcept;
+    void run_drain_hooks() noexcept;
+    void run_posted_work() noexcept;
     void process_expired_waiters() noexcept;
+    void fail_registration(wait_operation *& registration,
+                           error reason) noexcept;
+    void complete_registration(wait_operation *& registration) noexcept;
+    void release_registration(wait_operation *& registration) noexcept;
     void process_completion(const simplenet::uring::completion& completion) noexcept;
+    void process_poll_completion(
+        const simplenet::uring::completion& completion) noexcept;
+    void process_abandoned_completion(
+        const simplenet::uring::completion& completion) noexcept;
     [[nodiscard]] std::uint64_t allocate_token() noexcept;
-    [[nodiscard]] static std::uintptr_t
-    handle_key(std::coroutine_handle<> handle) noexcept;
     void cleanup_completed_roots() noexcept;
     void destroy_all_roots() noexcept;
+    static void destroy_roots(detail::task_list& roots) noexcept;
 
     simplenet::uring::reactor reactor_{};
+    simplenet::uring::buffer_ring provided_buffers_{};
     std::optional<simplenet::error> init_error_{};
     std::optional<simplenet::error> loop_error_{};
 
     std::deque<std::coroutine_handle<>> ready_queue_{};
-    std::unordered_map<int, waiter_slot> waiters_{};
-    std::unordered_map<std::uint64_t, poll_context> inflight_polls_{};
-    std::unordered_map<std::uintptr_t, result<void>> wait_results_{};
-    std::vector<std::coroutine_handle<>> root_tasks_{};
+    fd_table<waiter_slot> waiters_{};
+    std::unordered_map<std::uint64_t, io_operation *> inflight_ops_{};
+    std::unordered_map<std::uint64_t, io_opcode> abandoned_ops_{};
+    std::unordered_map<std::uint64_t, inflight_timer> inflight_timers_{};
+    /// Linked-timeout expiries of timed polls, by poll token, until the
+    /// poll's CQE arrives.
+    std::unordered_map<std::uint64_t, __kernel_timespec> link_deadlines_{};
+    /// Spawned roots still running, and finished ones awaiting `destroy()`.
+    detail::task_list live_roots_{};
+    detail::task_list finished_roots_{};
+    std::vector<simplenet::uring::completion> completions_{};
+    std::size_t max_poll_batch_{0};
+    timer_wheel timers_{};
+    wakeup_queue remote_wakeups_{};
+    drain_queue drain_hooks_{};
+    post_queue posted_{};
+    [[no_unique_address]] detail::loop_recorder recorder_{};
+    detail::stall_watch watch_{};
+    detail::resume_budget budget_{};
 
     std::size_t pending_waiter_count_{0};
-    std::size_t timed_waiter_count_{0};
     std::size_t active_task_count_{0};
-    std::optional<std::chrono::steady_clock::time_point> next_deadline_{};
-    bool deadline_index_dirty_{false};
+    std::size_t external_hold_count_{0};
     std::uint64_t next_token_{1};
+    std::uint64_t poll_generation_{0};
     std::uint64_t wake_token_{0};
     bool submission_pending_{false};
     std::atomic_bool stop_requested_{false};
@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Thread-safe intrusive queue of remote wake-ups for event loops.
+ */
+
+#include "simplenet/runtime/task.hpp"
+
+#include <cstddef>
+#include <mutex>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Mutex-guarded FIFO of `remote_wakeup` nodes.
+ *
+ * `push` may be called from any thread; `pop` and `withdraw` run on the
+ * owning loop thread. Nodes are linked in place, so posting never allocates.
+ */
+class wakeup_queue {
+public:
+    wakeup_queue() noexcept = default;
+    ~wakeup_queue() = default;
+
+    wakeup_queue(const wakeup_queue&) = delete;
+    wakeup_queue& operator=(const wakeup_queue&) = delete;
+    wakeup_queue(wakeup_queue&&) = delete;
+    wakeup_queue& operator=(wakeup_queue&&) = delete;
+
+    /**
+     * @brief Append `wakeup` unless it is already queued.
+     * @return `true` when the queue was empty, i.e. the loop needs a signal.
+     */
+    [[nodiscard]] bool push(remote_wakeup& wakeup) noexcept;
+    /// @brief Unlink `wakeup` if it is still queued.
+    void withdraw(remote_wakeup& wakeup) noexcept;
+    /// @return Oldest queued wakeup (now unlinked), or `nullptr`.
+    [[nodiscard]] remote_wakeup *pop() noexcept;
+    /// @return Number of queued wakeups.
+    [[nodiscard]] std::size_t size() noexcept;
+    /// @return `true` when nothing is queued.
+    [[nodiscard]] bool empty() noexcept {
+        return size() == 0;
+    }
+
+private:
+    std::mutex mutex_{};
+    std::size_t size_{0};
+    remote_wakeup *head_{nullptr};
+    remote_wakeup *tail_{nullptr};
+};
+
+} // namespace simplenet::runtime
@@ -0,0 +1,152 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Chase-Lev work-stealing deque of pointers.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace simplenet::runtime {
+
+/**
+ * @brief Single-owner, multi-thief deque (Chase-Lev, C11 formulation).
+ *
+ * The owner thread pushes and pops at the bottom (LIFO, cache-warm work);
+ * any thread may steal from the top (FIFO, oldest work). The ring doubles
+ * when full; replaced rings are kept until destruction because a thief may
+ * still be reading one.
+ *
+ * @tparam T Pointer type; `nullptr` signals "nothing taken".
+ */
+template <class T>
+    requires std::is_pointer_v<T>
+class work_stealing_deque {
+public:
+    /// Initial ring capacity.
+    static constexpr std::size_t initial_capacity = 64;
+
+    work_stealing_deque() : rings_() {
+        rings_.push_back(std::make_unique<ring>(initial_capacity));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+    ~work_stealing_deque() = default;
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+    work_stealing_deque(work_stealing_deque&&) = delete;
+    work_stealing_deque& operator=(work_stealing_deque&&) = delete;
+
+    /// @brief Push at the bottom (owner thread only).
+    void push(T item) {
+        const auto bottom = bottom_.load(std::memory_order_relaxed);
+        const auto top = top_.load(std::memory_order_acquire);
+        auto *current = ring_.load(std::memory_order_relaxed);
+        if (bottom - top >= current->capacity()) {
+            current = grow(*current, top, bottom);
+        }
+        current->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /// @return Newest item (owner thread only), or `nullptr` when empty.
+    [[nodiscard]] T pop() noexcept {
+        const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        auto *current = ring_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T item = current->get(bottom);
+        if (top == bottom) {
+            // Last item: race thieves for it.
+            if (!top_.compare_exchange_strong(top, top + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// @return Oldest item (any thread), or `nullptr` when empty or contended.
+    [[nodiscard]] T steal() noexcept {
+        auto top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        auto *current = ring_.load(std::memory_order_acquire);
+        T item = current->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /// @return `true` when no item is visible (a racy snapshot).
+    [[nodiscard]] bool empty() const noexcept {
+        return top_.load(std::memory_order_acquire) >=
+               bottom_.load(std::memory_order_acquire);
+    }
+
+private:
+    class ring {
+    public:
+        explicit ring(std::size_t capacity)
+            : mask_(static_cast<std::int64_t>(capacity) - 1),
+              slots_(std::make_unique<std::atomic<T>[]>(capacity)) {}
+
+        [[nodiscard]] std::int64_t capacity() const noexcept {
+            return mask_ + 1;
+        }
+        [[nodiscard]] T get(std::int64_t index) const noexcept {
+            return slots_[static_cast<std::size_t>(index & mask_)].load(
+                std::memory_order_relaxed);
+        }
+        void put(std::int64_t index, T item) noexcept {
+            slots_[static_cast<std::size_t>(index & mask_)].store(
+                item, std::memory_order_relaxed);
+        }
+
+    private:
+        std::int64_t mask_;
+        std::unique_ptr<std::atomic<T>[]> slots_;
+    };
+
+    ring *grow(const ring& current, std::int64_t top,
+               std::int64_t bottom) {
+        const auto capacity = static_cast<std::size_t>(current.capacity()) * 2;
+        rings_.push_back(std::make_unique<ring>(capacity));
+        auto *next = rings_.back().get();
+        for (auto index = top; index < bottom; ++index) {
+            next->put(index, current.get(index));
+        }
+        ring_.store(next, std::memory_order_release);
+        return next;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<ring *> ring_{nullptr};
+    /// Every ring ever used, newest last (owner thread only).
+    std::vector<std::unique_ptr<ring>> rings_;
+};
+
+} // namespace simplenet::runtime
@@ -5,16 +5,25 @@
  * @brief Backpressure-aware queued TCP writer for async pipelines.
  */
 
+#include "simplenet/nonblocking/local.hpp"
 #include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/buffer_pool.hpp"
 #include "simplenet/runtime/cancel.hpp"
 #include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/ring_queue.hpp"
+#include "simplenet/runtime/shared_buffer.hpp"
 #include "simplenet/runtime/task.hpp"
+#include "simplenet/runtime/token_bucket.hpp"
 
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
+#include <memory>
+#include <optional>
 #include <span>
+#include <sys/uio.h>
+#include <variant>
 #include <vector>
 
 namespace simplenet::runtime {
@@ -27,6 +36,70 @@ struct watermarks {
     std::size_t low{64U * 1024U};
     /// Threshold that activates high-watermark state.
     std::size_t high{256U * 1024U};
+    /**
+     * When nonzero, set `TCP_NOTSENT_LOWAT` to this on the stream. The kernel
+     * then holds at most about this many unsent bytes, and the rest stays
+     * queued where `low` and `high` see it, instead of hiding in an
+     * autotuned send buffer.
+     */
+    std::size_t kernel_unsent{0};
+};
+
+/**
+ * @brief Small-message coalescing for `queued_writer`.
+ *
+ * With `max_message > 0`, copy-enqueued messages up to that size are
+ * appended into shared `chunk_size`-byte chunks rather than getting one
+ * allocation each, and flush sends each chunk as one contiguous region.
+ * Move-enqueued vectors are always queued as they are.
+ */
+struct coalescing {
+    /// Largest copy-enqueued message that is coalesced; `0` disables.
+    std::size_t max_message{0};
+    /// Chunk capacity; raised to `max_message` when smaller.
+    std::size_t chunk_size{16U * 1024U};
+};
+
+/**
+ * @brief Zero-copy sending for large `queued_writer` buffers.
+ *
+ * Move-enqueued and shared buffers of at least `min_bytes` are sent with
+ * `MSG_ZEROCOPY`. The writer keeps each such buffer until the kernel
+ * reports it released, reaping completions during `flush()` and waiting
+ * for the rest in `graceful_shutdown()`. Ignored when the socket refuses
+ * `SO_ZEROCOPY`.
+ */
+struct zerocopy_send {
+    /// Smallest buffer sent zero-copy; `0` disables.
+    std::size_t min_bytes{0};
+};
+
+/**
+ * @brief Send-rate limits for `queued_writer`.
+ *
+ * The writer sends no more than its buckets allow and, when they run dry,
+ * waits on a scheduler timer instead of the socket: `flush()` sleeps until
+ * enough tokens accrued, and auto-flush arms one `schedule_at()` timer per
+ * refill. Each write waits for a full bucket (or the whole queue when
+ * smaller), so a paced connection costs about one wake per `burst` bytes.
+ */
+struct pacing {
+    /// Per-connection rate in bytes per second; `0` leaves it unlimited.
+    std::uint64_t rate{0};
+    /// Per-connection bucket capacity; `0` picks 10 ms worth of `rate`.
+    std::size_t burst{0};
+    /**
+     * Bucket shared with other writers on the same loop, for an aggregate
+     * limit such as one per tenant. Applies on top of `rate`.
+     */
+    std::shared_ptr<token_bucket> shared{};
+    /**
+     * Hand `rate` to the kernel with `SO_MAX_PACING_RATE` instead of the
+     * per-connection bucket, so the loop does no work per paced byte. Falls
+     * back to the bucket when the socket refuses the option; `shared`
+     * always stays in user space.
+     */
+    bool kernel{false};
 };
 
 /// @brief Logical backpressure state returned by enqueue operations.
@@ -37,6 +110,11 @@ enum class backpressure_state {
 
 /**
  * @brief Buffered async TCP writer with explicit backpressure reporting.
+ *
+ * With zero-copy enabled, destroying the writer while sends are still in
+ * flight may change bytes the kernel has not transmitted yet; finish with
+ * `graceful_shutdown()`. A writer may be moved, but not while a `flush()`
+ * is suspended.
  */
 class queued_writer {
 public:
@@ -44,17 +122,56 @@ public:
      * @brief Construct from an owned stream and watermark settings.
      * @param stream Destination stream.
      * @param marks Low/high watermark values.
+     * @param coalesce Small-message coalescing (off by default).
+     * @param zerocopy Zero-copy sending of large buffers (off by default).
      */
     explicit queued_writer(simplenet::nonblocking::tcp_stream stream,
-                           watermarks marks = {});
+                           watermarks marks = {}, coalescing coalesce = {},
+                           zerocopy_send zerocopy = {});
+    /**
+     * @brief Queue writes to a Unix domain socket.
+     *
+     * Same as the `tcp_stream` overload; zero-copy and `kernel_unsent`
+     * are TCP features and stay off.
+     */
+    explicit queued_writer(simplenet::nonblocking::local_stream stream,
+                           watermarks marks = {}, coalescing coalesce = {});
 
     queued_writer(const queued_writer&) = delete;
     queued_writer& operator=(const queued_writer&) = delete;
-    queued_writer(queued_writer&&) noexcept = default;
-    queued_writer& operator=(queued_writer&&) noexcept = default;
+    queued_writer(queued_writer&& other) noexcept;
+    queued_writer& operator=(queued_writer&& other) noexcept;
+    ~queued_writer();
+
+    /**
+     * @brief Flush automatically once per iteration of `loop`.
+     *
+     * Each enqueue defers a flush to the end of `loop`'s current ready-queue
+     * drain, so whatever the runnable tasks queued in that pass, such as a
+     * batch of pipelined responses, leaves in one gathered write before the
+     * loop polls again. When the socket fills up, the writer waits for it
+     * to become writable and carries on by itself; an explicit `flush()`
+     * takes over while it runs. A write error is returned by the next
+     * `enqueue()` or `flush()`.
+     *
+     * @param loop Scheduler the writer is used on; must outlive the writer.
+     */
+    void enable_auto_flush(scheduler& loop);
+
+    /**
+     * @brief Limit how fast queued bytes leave; replaces earlier limits.
+     *
+     * Queued bytes are unaffected, so watermarks apply as usual and a
+     * producer faster than the rate sees `high_watermark`. Kernel pacing
+     * is a TCP feature and does nothing on Unix domain sockets.
+     * @param policy Limits; a default-constructed one removes them.
+     */
+    void set_pacing(pacing policy);
 
     /**
      * @brief Copy-enqueue bytes for later flush.
+     *
+     * Coalesced into the tail chunk when `bytes` fits the coalescing limit.
      * @param bytes Bytes to append into internal queue.
      * @return Backpressure state after enqueue.
      */
@@ -67,15 +184,45 @@ public:
      */
     [[nodiscard]] result<backpressure_state>
     enqueue(std::vector<std::byte>&& bytes);
+    /**
+     * @brief Queue a reference to `bytes`, with no copy.
+     *
+     * For fan-out: enqueue one buffer on every subscriber's writer and each
+     * costs a reference count bump. It is gathered into the same `writev`
+     * as neighbouring buffers.
+     * @return Backpressure state after enqueue.
+     */
+    [[nodiscard]] result<backpressure_state> enqueue(shared_buffer bytes);
+    /**
+     * @brief Queue the `size()` bytes of a pooled buffer, with no copy. The
+     *        buffer goes back to its pool once sent.
+     * @return Backpressure state after enqueue.
+     */
+    [[nodiscard]] result<backpressure_state> enqueue(pooled_buffer&& bytes);
+    /**
+     * @brief Queue `count` bytes of `file_fd` from `offset`, sent with
+     *        `sendfile(2)` in order with the surrounding buffers.
+     *
+     * The bytes never enter the queue's memory but count toward
+     * `queued_bytes()` and the watermarks. `file_fd` is borrowed and must
+     * stay open until they are flushed. A file that ends early fails the
+     * flush with `ENODATA`.
+     * @return Backpressure state after enqueue.
+     */
+    [[nodiscard]] result<backpressure_state>
+    enqueue_file(int file_fd, std::uint64_t offset, std::size_t count);
     /**
      * @brief Flush queued buffers with timeout and optional cancellation.
+     *
+     * Each syscall gathers up to `IOV_MAX` queued buffers.
      * @param timeout Per-operation timeout for async writes.
      * @param token Optional cancellation token.
      */
     [[nodiscard]] task<result<void>> flush(std::chrono::milliseconds timeout,
                                            cancel_token token = {});
     /**
-     * @brief Flush queue then shutdown stream write side.
+     * @brief Flush queue, shutdown stream write side, then wait until the
+     *        kernel has released every zero-copy buffer.
      * @param timeout Per-operation timeout for flush/write.
      * @param token Optional cancellation token.
      */
@@ -83,24 +230,130 @@ public:
     graceful_shutdown(std::chrono::milliseconds timeout,
                       cancel_token token = {});
 
+    /**
+     * @brief Free the scratch space kept for the next flush: the spare
+     *        coalescing chunk and the iovec list.
+     *
+     * The queue itself already frees its storage when drained, so after
+     * this an idle writer owns no heap memory. Call it when a connection
+     * goes quiet; the next flush allocates the scratch space again.
+     */
+    void trim() noexcept;
+
     /// @return Total bytes currently buffered.
     [[nodiscard]] std::size_t queued_bytes() const noexcept;
+    /// @return Zero-copy sends the kernel has not released yet.
+    [[nodiscard]] std::size_t zerocopy_in_flight() const noexcept;
+    /// @return Limits in effect; `kernel` is cleared when the socket refused it.
+    [[nodiscard]] const pacing& current_pacing() const noexcept;
+    /// @return `true` once `enable_auto_flush()` was called.
+    [[nodiscard]] bool auto_flush_enabled() const noexcept;
     /// @return Whether high-watermark state is currently active.
     [[nodiscard]] bool high_watermark_active() const noexcept;
     /// @return Underlying socket descriptor.
     [[nodiscard]] int native_handle() const noexcept;
+    /// @return The owned stream, for reads on the same socket.
+    [[nodiscard]] simplenet::nonblocking::tcp_stream& stream() noexcept;
 
 private:
+    /// Borrowed file range sent with `sendfile(2)`.
+    struct file_region {
+        int fd{-1};
+        std::uint64_t offset{0};
+        std::size_t length{0};
+    };
+
+    /// Owned, referenced, pooled or file-backed bytes of one region.
+    using payload = std::variant<std::vector<std::byte>, shared_buffer,
+                                 pooled_buffer, file_region>;
+
+    /// One queued region; `coalesced` chunks accept further appends.
+    struct queued_buffer {
+        payload data{};
+        bool coalesced{false};
+        /// Set once part of it went out zero-copy.
+        bool zerocopy{false};
+
+        [[nodiscard]] const file_region *file() const noexcept {
+            return std::get_if<file_region>(&data);
+        }
+        [[nodiscard]] std::size_t size() const noexcept {
+            const auto *region = file();
+            return region != nullptr ? region->length : contents().size();
+        }
+        /// In-memory bytes; empty for a file region.
+        [[nodiscard]] std::span<const std::byte> contents() const noexcept {
+            if (const auto *owned = std::get_if<std::vector<std::byte>>(&data)) {
+                return *owned;
+            }
+            if (const auto *shared = std::get_if<shared_buffer>(&data)) {
+                return shared->bytes();
+            }
+            if (const auto *pooled = std::get_if<pooled_buffer>(&data)) {
+                return pooled->bytes();
+            }
+            return {};
+        }
+    };
+
+    /// One zero-copy send awaiting release by the kernel.
+    struct zerocopy_record {
+        std::uint32_t id{0};
+        bool released{false};
+        /// Bytes of the buffer this send finished, kept until release.
+        payload held{};
+    };
+
+    /// Drain hook, writable waiter and deferred failure for auto-flush.
+    struct auto_flush_state;
+
     [[nodiscard]] result<backpressure_state>
     enqueue_owned(std::vector<std::byte>&& bytes);
+    [[nodiscard]] result<void> admit() const noexcept;
+    void append_coalesced(std::span<const std::byte> bytes);
+    [[nodiscard]] bool rejecting() const noexcept;
+    [[nodiscard]] backpressure_state state() const noexcept;
+    [[nodiscard]] backpressure_state note_enqueued(std::size_t bytes) noexcept;
     void update_backpressure_after_drain() noexcept;
+    [[nodiscard]] bool gather_front();
+    [[nodiscard]] result<std::size_t> send_front_file(std::size_t limit) noexcept;
+    void limit_gather(std::size_t bytes) noexcept;
+    [[nodiscard]] std::array<token_bucket *, 2> pacing_buckets() noexcept;
+    [[nodiscard]] std::size_t
+    pacing_threshold(const token_bucket& bucket) const noexcept;
+    [[nodiscard]] std::size_t pacing_allowance() noexcept;
+    [[nodiscard]] token_bucket::clock::time_point
+    pacing_ready_at(token_bucket::clock::time_point now) noexcept;
+    void note_written(bool zerocopy, std::uint32_t id, std::size_t bytes);
+    [[nodiscard]] result<void> write_available();
+    void auto_flush_now() noexcept;
+    void consume(std::size_t bytes) noexcept;
+    [[nodiscard]] bool sends_zerocopy(const queued_buffer& buffer) const noexcept;
+    void reap_zerocopy() noexcept;
 
     simplenet::nonblocking::tcp_stream stream_{};
     watermarks marks_{};
-    std::deque<std::vector<std::byte>> queue_{};
+    coalescing coalesce_{};
+    zerocopy_send zerocopy_{};
+    pacing pacing_{};
+    /// Per-connection bucket; unset when `rate` is zero or kernel-paced.
+    std::optional<token_bucket> bucket_{};
+    /// Holds no storage while drained.
+    ring_queue<queued_buffer> queue_{};
+    /// Drained chunk kept for reuse by the next coalesced append.
+    std::vector<std::byte> spare_chunk_{};
+    /// Zero-copy sends in id order; released ones are dropped from the front.
+    ring_queue<zerocopy_record> zerocopy_inflight_{};
+    /// Reused iovec list describing the queue head during `flush()`.
+    std::vector<::iovec> gather_{};
     std::size_t front_offset_{0};
     std::size_t queued_bytes_{0};
+    /// Set when the last write drew on `pacing_.shared`; see `pacing_ready_at`.
+    bool spent_shared_{false};
     bool high_watermark_active_{false};
+    /// Set while `flush()` owns `gather_`, which auto-flush must not touch.
+    bool flushing_{false};
+    std::unique_ptr<auto_flush_state> auto_flush_{};
 };
 
 } // namespace simplenet::runtime
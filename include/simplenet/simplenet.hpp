@@ -14,13 +14,42 @@
 #include "simplenet/epoll/reactor.hpp"
 #include "simplenet/io_context.hpp"
 #include "simplenet/ip_tcp.hpp"
+#include "simplenet/nonblocking/local.hpp"
 #include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/nonblocking/udp.hpp"
+#include "simplenet/runtime/acceptor.hpp"
+#include "simplenet/runtime/buffer_pool.hpp"
 #include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/channel.hpp"
+#include "simplenet/runtime/drain_queue.hpp"
 #include "simplenet/runtime/engine.hpp"
 #include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/fd_table.hpp"
+#include "simplenet/runtime/frame_pool.hpp"
+#include "simplenet/runtime/framed_reader.hpp"
+#include "simplenet/runtime/io_backend.hpp"
 #include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/loop_metrics.hpp"
+#include "simplenet/runtime/loop_pool.hpp"
+#include "simplenet/runtime/loop_watchdog.hpp"
+#include "simplenet/runtime/numa.hpp"
+#include "simplenet/runtime/op_latency.hpp"
+#include "simplenet/runtime/post_queue.hpp"
+#include "simplenet/runtime/receiver.hpp"
 #include "simplenet/runtime/resolver.hpp"
+#include "simplenet/runtime/resume_budget.hpp"
+#include "simplenet/runtime/ring_queue.hpp"
+#include "simplenet/runtime/shared_buffer.hpp"
+#include "simplenet/runtime/steady_timer.hpp"
 #include "simplenet/runtime/task.hpp"
+#include "simplenet/runtime/task_group.hpp"
+#include "simplenet/runtime/timer_wheel.hpp"
+#include "simplenet/runtime/token_bucket.hpp"
 #include "simplenet/runtime/uring_event_loop.hpp"
+#include "simplenet/runtime/wakeup_queue.hpp"
+#include "simplenet/runtime/work_stealing_deque.hpp"
 #include "simplenet/runtime/write_queue.hpp"
+#include "simplenet/thread_pool_context.hpp"
+#include "simplenet/uring/buffer_ring.hpp"
+#include "simplenet/uring/probe.hpp"
 #include "simplenet/uring/reactor.hpp"
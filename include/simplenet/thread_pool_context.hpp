@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Multi-threaded runtime context: one pinned event loop per thread.
+ */
+
+#include "simplenet/runtime/loop_pool.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace simplenet {
+
+/**
+ * @brief Owns and runs several independent event loops, one per thread.
+ *
+ * The multi-core counterpart of `io_context`: each loop is single-threaded
+ * and runs on its own (by default CPU-pinned) thread. Tasks never migrate;
+ * place them with `spawn_on()` and shard servers with `listen_sharded()`.
+ */
+class thread_pool_context {
+public:
+    /// Runtime backend selector.
+    using backend = runtime::engine::backend;
+    /// Construction options.
+    using options = runtime::loop_pool_options;
+
+    /// @brief Construct the pool described by `opts`.
+    explicit thread_pool_context(options opts = {}) : pool_(std::move(opts)) {}
+
+    /// @return `true` when every loop initialized.
+    [[nodiscard]] bool valid() const noexcept {
+        return pool_.valid();
+    }
+
+    /// @return Number of loops (and threads while running).
+    [[nodiscard]] std::size_t size() const noexcept {
+        return pool_.size();
+    }
+
+    /// @return CPU loop `index` is pinned to, or `-1`.
+    [[nodiscard]] int cpu(std::size_t index) const noexcept {
+        return pool_.cpu(index);
+    }
+
+    /// @return NUMA node of loop `index`, or `-1`.
+    [[nodiscard]] int numa_node(std::size_t index) const noexcept {
+        return pool_.numa_node(index);
+    }
+
+    /// @return The backend selected during construction.
+    [[nodiscard]] backend selected_backend() const noexcept {
+        return pool_.selected_backend();
+    }
+
+    /**
+     * @brief Schedule a root coroutine task on loop `index`.
+     *
+     * Call before `run()`, or from a task already running on that loop.
+     * @return `EINVAL` when `index >= size()`.
+     */
+    template <class T>
+    [[nodiscard]] result<void> spawn_on(std::size_t index,
+                                        runtime::task<T>&& work) noexcept {
+        return pool_.spawn_on(index, std::move(work));
+    }
+
+    /**
+     * @brief Run `work` on loop `index`; safe from any thread.
+     * @see runtime::loop_pool::post
+     */
+    template <class Work>
+    [[nodiscard]] result<void> post(std::size_t index, Work&& work) noexcept {
+        return pool_.post(index, std::forward<Work>(work));
+    }
+
+    /**
+     * @brief Schedule `factory(index)` on every loop.
+     *
+     * Keep a capturing coroutine lambda alive until `run()` returns.
+     * @tparam Factory Callable returning a task for a loop index.
+     */
+    template <class Factory>
+    void spawn_each(Factory&& factory) noexcept {
+        pool_.spawn_each(std::forward<Factory>(factory));
+    }
+
+    /**
+     * @brief Bind one `SO_REUSEPORT` listener per loop.
+     * @see runtime::loop_pool::listen_sharded
+     */
+    [[nodiscard]] result<std::vector<nonblocking::tcp_listener>>
+    listen_sharded(const nonblocking::endpoint& local, int backlog = SOMAXCONN,
+                   bool steer_by_cpu = false) const noexcept {
+        return pool_.listen_sharded(local, backlog, steer_by_cpu);
+    }
+
+    /**
+     * @brief Run all loops until their root tasks complete or stop is requested.
+     * @return Success or the first loop error.
+     */
+    [[nodiscard]] result<void> run() noexcept {
+        return pool_.run();
+    }
+
+    /// @brief Request shutdown of every loop; callable from any thread.
+    void stop() noexcept {
+        pool_.stop();
+    }
+
+private:
+    runtime::loop_pool pool_;
+};
+
+} // namespace simplenet
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Provided-buffer ring (`IORING_REGISTER_PBUF_RING`) for multishot reads.
+ */
+
+#include "simplenet/core/result.hpp"
+#include "simplenet/uring/reactor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <liburing.h>
+#include <memory>
+#include <span>
+
+namespace simplenet::uring {
+
+/**
+ * @brief Fixed-size pool of receive buffers the kernel picks from on demand.
+ *
+ * Buffers are handed to the kernel at creation and again on `recycle()`.
+ * Backing storage is reserved but only touched when the kernel fills a
+ * buffer, so resident memory follows traffic rather than connection count.
+ *
+ * The ring memory is owned here; destroy it only after the owning `reactor`
+ * has been torn down or the group has been unregistered.
+ */
+class buffer_ring {
+public:
+    /// Construct an empty, unregistered buffer ring.
+    buffer_ring() noexcept = default;
+    /// Release ring and buffer memory.
+    ~buffer_ring();
+
+    buffer_ring(const buffer_ring&) = delete;
+    buffer_ring& operator=(const buffer_ring&) = delete;
+    /// Move-construct ownership of the registered ring.
+    buffer_ring(buffer_ring&& other) noexcept;
+    /// Move-assign ownership of the registered ring.
+    buffer_ring& operator=(buffer_ring&& other) noexcept;
+
+    /**
+     * @brief Allocate buffers and register them with a ring.
+     * @param owner Ring to register with.
+     * @param group Buffer group id used by `IOSQE_BUFFER_SELECT`.
+     * @param count Number of buffers; must be a power of two up to 32768.
+     * @param buffer_size Size of each buffer in bytes.
+     */
+    [[nodiscard]] static result<buffer_ring>
+    create(reactor& owner, std::uint16_t group, std::uint16_t count,
+           std::size_t buffer_size) noexcept;
+
+    /**
+     * @brief Access the storage behind a kernel-selected buffer id.
+     * @param id Buffer id from the CQE flags.
+     */
+    [[nodiscard]] std::span<std::byte> buffer(std::uint16_t id) noexcept;
+    /**
+     * @brief Hand a buffer back to the kernel for reuse.
+     * @param id Buffer id previously returned in a CQE.
+     */
+    void recycle(std::uint16_t id) noexcept;
+
+    /// @return Registered buffer group id.
+    [[nodiscard]] std::uint16_t group() const noexcept;
+    /// @return Number of buffers in the ring.
+    [[nodiscard]] std::uint16_t count() const noexcept;
+    /// @return Size of each buffer in bytes.
+    [[nodiscard]] std::size_t buffer_size() const noexcept;
+    /// @return `true` when the ring is registered.
+    [[nodiscard]] bool valid() const noexcept;
+
+private:
+    void stage(std::uint16_t id, std::uint16_t offset) noexcept;
+    void publish(std::uint16_t added) noexcept;
+    void release() noexcept;
+
+    io_uring_buf_ring *ring_{nullptr};
+    std::unique_ptr<std::byte[]> storage_{};
+    std::size_t buffer_size_{0};
+    std::uint16_t count_{0};
+    std::uint16_t group_{0};
+    std::uint16_t tail_{0};
+};
+
+} // namespace simplenet::uring
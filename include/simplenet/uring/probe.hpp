@@ -0,0 +1,86 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Kernel `io_uring` capability probe used for backend selection.
+ */
+
+#include <cstdint>
+
+namespace simplenet::uring {
+
+/**
+ * @brief What this process may do with `io_uring` on the running kernel.
+ *
+ * Filled by `probe_support()` from a throwaway two-entry ring and
+ * `io_uring_get_probe_ring()`. Opcode flags stay `false` when no ring could
+ * be created.
+ */
+struct support {
+    /**
+     * `0` when a ring was created, otherwise the setup errno: `ENOSYS` on
+     * kernels without `io_uring`, `EPERM` when a seccomp filter or the
+     * `kernel.io_uring_disabled` sysctl blocks it, `ENOMEM` under a tight
+     * `RLIMIT_MEMLOCK`.
+     */
+    int setup_error{0};
+    /// `kernel.io_uring_disabled` (`0` when the sysctl does not exist).
+    int sysctl_disabled{0};
+    /// `Seccomp:` mode from `/proc/self/status`: `0` none, `1` strict, `2` filter.
+    int seccomp_mode{0};
+    /// `IORING_FEAT_*` bits reported at setup.
+    std::uint32_t features{0};
+
+    /// @name Opcodes the runtime submits unconditionally.
+    /// @{
+    bool poll_add{false};
+    bool async_cancel{false};
+    bool timeout{false};
+    bool accept{false};
+    bool connect{false};
+    bool recv{false};
+    bool send{false};
+    bool recvmsg{false};
+    bool sendmsg{false};
+    /// @}
+
+    /// @name Opcodes behind optional paths, each with a fallback.
+    /// @{
+    /// Per-operation deadlines without a separate timer.
+    bool link_timeout{false};
+    /// `MSG_ZEROCOPY`-style sends.
+    bool send_zc{false};
+    /// `async_splice()`.
+    bool splice{false};
+    /// Receives into `register_buffers()` regions.
+    bool read_fixed{false};
+    /// @}
+
+    /// @return `true` when a ring could be created.
+    [[nodiscard]] bool ring_available() const noexcept {
+        return setup_error == 0;
+    }
+
+    /// @return `true` when every unconditionally used opcode is supported.
+    [[nodiscard]] bool runtime_ready() const noexcept {
+        return ring_available() && poll_add && async_cancel && timeout &&
+               accept && connect && recv && send && recvmsg && sendmsg;
+    }
+};
+
+/**
+ * @brief Probe the kernel now.
+ *
+ * Costs one ring setup and teardown, so prefer `cached_support()` unless
+ * the answer may have changed (a new seccomp filter, say).
+ */
+[[nodiscard]] support probe_support() noexcept;
+
+/**
+ * @brief Result of the first `probe_support()` call in this process.
+ *
+ * Thread-safe; every later call returns the same object.
+ */
+[[nodiscard]] const support& cached_support() noexcept;
+
+} // namespace simplenet::uring
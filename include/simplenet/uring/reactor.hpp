@@ -10,10 +10,14 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <fcntl.h>
 #include <liburing.h>
 #include <memory>
 #include <optional>
 #include <span>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
 
 namespace simplenet::uring {
 
@@ -25,10 +29,51 @@ struct completion {
     std::uint64_t user_data{0};
     /// Kernel completion result (`res`).
     int result{0};
+    /// Kernel completion flags (`IORING_CQE_F_*`).
+    std::uint32_t flags{0};
 };
 
+/**
+ * @brief Ring setup flags requested from the kernel.
+ *
+ * Every flag is optional: `reactor::create()` retries without the ones the
+ * kernel rejects (`EINVAL`, or `EPERM` for SQPOLL) and reports what it got
+ * through `setup_flags()`.
+ */
+struct ring_options {
+    /// SQ entry count.
+    std::uint32_t queue_depth{256};
+    /// CQ entry count (`IORING_SETUP_CQSIZE`); `0` keeps twice the SQ depth.
+    std::uint32_t cq_entries{0};
+    /// Kernel thread polls the SQ (`IORING_SETUP_SQPOLL`), so submits are
+    /// usually free of syscalls at the cost of one busy core.
+    bool sqpoll{false};
+    /// Idle time before the SQPOLL thread sleeps.
+    std::uint32_t sqpoll_idle_ms{1000};
+    /// CPU to pin the SQPOLL thread to (`IORING_SETUP_SQ_AFF`); `-1` floats.
+    int sqpoll_cpu{-1};
+    /**
+     * `IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN`: completions
+     * are posted only when the loop waits. The ring then accepts submits
+     * only from the thread that created it, so construct the loop on the
+     * thread that runs it. Not combinable with `sqpoll`.
+     */
+    bool defer_taskrun{false};
+    /// `IORING_SETUP_COOP_TASKRUN`: no IPI to post completions.
+    bool coop_taskrun{false};
+};
+
+/// Slots in the sparse registered-file table created on first use.
+inline constexpr std::uint32_t registered_file_slots = 1024;
+
 /**
  * @brief RAII wrapper over a configured `io_uring` ring.
+ *
+ * Descriptors passed to `register_file()` are submitted by table index with
+ * `IOSQE_FIXED_FILE`, skipping the per-SQE file lookup and refcount, and
+ * receives into a `register_buffers()` region use `IORING_OP_READ_FIXED`.
+ * Both happen inside the `submit_*` calls, so callers keep passing plain
+ * descriptors and buffers.
  */
 class reactor {
 public:
@@ -49,6 +94,9 @@ public:
      */
     [[nodiscard]] static result<reactor>
     create(std::uint32_t entries = 256) noexcept;
+    /// @brief Create a ring with `options`, dropping unsupported flags.
+    [[nodiscard]] static result<reactor>
+    create(const ring_options& options) noexcept;
 
     /**
      * @brief Queue a poll-add request.
@@ -59,14 +107,153 @@ public:
     [[nodiscard]] result<void>
     submit_poll_add(std::uint64_t user_data, int fd,
                     std::uint32_t poll_mask) noexcept;
+    /**
+     * @brief Queue a poll-add linked to an `IORING_OP_LINK_TIMEOUT`.
+     *
+     * The kernel cancels the poll at `deadline` (absolute
+     * `CLOCK_MONOTONIC`), so its single CQE carries either the poll result
+     * or `-ECANCELED`. The timeout's own CQE has `user_data` `0`.
+     * @param deadline Read by the kernel when it takes the SQEs, which with
+     * SQPOLL may be after `submit()`; keep it until the poll completes.
+     * @return `EBUSY` without two free SQEs, `EOPNOTSUPP` unless
+     * `supports_link_timeout()`.
+     */
+    [[nodiscard]] result<void>
+    submit_poll_add(std::uint64_t user_data, int fd, std::uint32_t poll_mask,
+                    __kernel_timespec& deadline) noexcept;
+    /// @return `true` when the kernel accepts `IORING_OP_LINK_TIMEOUT`.
+    [[nodiscard]] bool supports_link_timeout() const noexcept;
     /**
      * @brief Queue a poll-remove request.
      * @param target_user_data Token of the poll-add to cancel.
      */
     [[nodiscard]] result<void>
     submit_poll_remove(std::uint64_t target_user_data) noexcept;
+    /**
+     * @brief Queue a completion-mode receive (`IORING_OP_RECV`).
+     * @param user_data Completion token.
+     * @param fd Connected socket.
+     * @param buffer Destination buffer; must stay valid until completion.
+     * @param flags `recv(2)` flags.
+     */
+    [[nodiscard]] result<void> submit_recv(std::uint64_t user_data, int fd,
+                                           std::span<std::byte> buffer,
+                                           int flags = 0) noexcept;
+    /**
+     * @brief Queue a completion-mode send (`IORING_OP_SEND`).
+     * @param user_data Completion token.
+     * @param fd Connected socket.
+     * @param buffer Source buffer; must stay valid until completion.
+     * @param flags `send(2)` flags.
+     */
+    [[nodiscard]] result<void>
+    submit_send(std::uint64_t user_data, int fd,
+                std::span<const std::byte> buffer,
+                int flags = MSG_NOSIGNAL) noexcept;
+    /**
+     * @brief Queue a zero-copy send (`IORING_OP_SEND_ZC`).
+     *
+     * Produces a result CQE flagged `IORING_CQE_F_MORE`, then a
+     * notification CQE (`IORING_CQE_F_NOTIF`) once the kernel no longer
+     * reads `buffer`.
+     * @param user_data Completion token shared by both CQEs.
+     * @param fd Connected socket.
+     * @param buffer Source buffer; must stay valid until the notification.
+     * @param flags `send(2)` flags.
+     */
+    [[nodiscard]] result<void>
+    submit_send_zc(std::uint64_t user_data, int fd,
+                   std::span<const std::byte> buffer,
+                   int flags = MSG_NOSIGNAL) noexcept;
+    /**
+     * @brief Queue a completion-mode scatter receive (`IORING_OP_RECVMSG`).
+     * @param user_data Completion token.
+     * @param fd Connected socket.
+     * @param message Message header and its iovecs; must stay valid until
+     *        completion.
+     * @param flags `recvmsg(2)` flags.
+     */
+    [[nodiscard]] result<void> submit_recvmsg(std::uint64_t user_data, int fd,
+                                              ::msghdr *message,
+                                              int flags = 0) noexcept;
+    /**
+     * @brief Queue a completion-mode gather send (`IORING_OP_SENDMSG`).
+     * @param user_data Completion token.
+     * @param fd Connected socket.
+     * @param message Message header and its iovecs; must stay valid until
+     *        completion.
+     * @param flags `sendmsg(2)` flags.
+     */
+    [[nodiscard]] result<void>
+    submit_sendmsg(std::uint64_t user_data, int fd, const ::msghdr *message,
+                   int flags = MSG_NOSIGNAL) noexcept;
+    /**
+     * @brief Queue a completion-mode accept (`IORING_OP_ACCEPT`).
+     * @param user_data Completion token; the result is the accepted descriptor.
+     * @param fd Listening socket.
+     * @param flags `accept4(2)` flags applied to the new descriptor.
+     */
+    [[nodiscard]] result<void>
+    submit_accept(std::uint64_t user_data, int fd,
+                  int flags = SOCK_NONBLOCK | SOCK_CLOEXEC) noexcept;
+    /**
+     * @brief Queue a multishot accept (`IORING_ACCEPT_MULTISHOT`).
+     *
+     * Each accepted connection produces a CQE flagged `IORING_CQE_F_MORE`
+     * until the request terminates.
+     * @param user_data Completion token shared by every CQE.
+     * @param fd Listening socket.
+     * @param flags `accept4(2)` flags applied to new descriptors.
+     */
+    [[nodiscard]] result<void>
+    submit_multishot_accept(std::uint64_t user_data, int fd,
+                            int flags = SOCK_NONBLOCK | SOCK_CLOEXEC) noexcept;
+    /**
+     * @brief Queue an async-cancel for a previously submitted request.
+     * @param target_user_data Token of the request to cancel.
+     */
+    [[nodiscard]] result<void>
+    submit_cancel(std::uint64_t target_user_data) noexcept;
+    /**
+     * @brief Queue a timeout (`IORING_OP_TIMEOUT`) that completes with `-ETIME`.
+     * @param user_data Completion token.
+     * @param timeout Expiry; read by the kernel at submit time, so it must
+     * stay valid until the next `submit()`.
+     * @param flags `IORING_TIMEOUT_*` flags; absolute `CLOCK_MONOTONIC` by default.
+     */
+    [[nodiscard]] result<void>
+    submit_timeout(std::uint64_t user_data, __kernel_timespec& timeout,
+                   unsigned flags = IORING_TIMEOUT_ABS) noexcept;
+    /**
+     * @brief Queue a completion-mode connect (`IORING_OP_CONNECT`).
+     * @param user_data Completion token.
+     * @param fd Unconnected socket.
+     * @param address Peer address; must stay valid until completion.
+     * @param address_length Size of `address` in bytes.
+     */
+    [[nodiscard]] result<void> submit_connect(std::uint64_t user_data, int fd,
+                                              const sockaddr *address,
+                                              socklen_t address_length) noexcept;
+    /**
+     * @brief Queue an in-kernel copy between descriptors (`IORING_OP_SPLICE`).
+     *
+     * One side must be a pipe. Descriptors are used as they are, never as
+     * registered files.
+     * @param user_data Completion token; the result is the byte count.
+     * @param fd_in Source descriptor.
+     * @param offset_in Read offset in `fd_in`; `-1` for pipes and sockets.
+     * @param fd_out Destination descriptor.
+     * @param length Bytes to move at most.
+     * @param flags `SPLICE_F_*` flags.
+     */
+    [[nodiscard]] result<void>
+    submit_splice(std::uint64_t user_data, int fd_in, std::int64_t offset_in,
+                  int fd_out, std::size_t length,
+                  unsigned flags = SPLICE_F_MOVE) noexcept;
     /// @brief Submit pending SQEs to the kernel.
     [[nodiscard]] result<void> submit() noexcept;
+    /// @return SQEs prepared but not yet handed to the kernel.
+    [[nodiscard]] std::size_t pending_submissions() const noexcept;
     /**
      * @brief Wait for completion events.
      * @param completions Output span for completions.
@@ -76,12 +263,91 @@ public:
     [[nodiscard]] result<std::size_t>
     wait(std::span<completion> completions,
          std::optional<std::chrono::milliseconds> timeout) noexcept;
+    /**
+     * @brief Submit pending SQEs and wait for completions in one syscall.
+     *
+     * Uses `io_uring_submit_and_wait_timeout`, so a loop iteration costs a
+     * single kernel entry. Pending SQEs are handed over even when the wait
+     * times out.
+     * @param completions Output span for completions.
+     * @param timeout Optional timeout. Empty means block indefinitely.
+     * @param min_complete Completions to wait for.
+     * @return Number of completions written; `EBUSY` when the kernel refuses
+     *         new SQEs until its CQ backlog is reaped.
+     */
+    [[nodiscard]] result<std::size_t>
+    submit_and_wait(std::span<completion> completions,
+                    std::optional<std::chrono::milliseconds> timeout,
+                    unsigned min_complete = 1) noexcept;
+
+    /**
+     * @brief Queue a multishot receive that selects provided buffers.
+     *
+     * Each CQE carries `IORING_CQE_F_BUFFER` and the chosen buffer id.
+     * @param user_data Completion token shared by every CQE.
+     * @param fd Connected socket.
+     * @param buffer_group Registered provided-buffer group id.
+     */
+    [[nodiscard]] result<void>
+    submit_recv_multishot(std::uint64_t user_data, int fd,
+                          std::uint16_t buffer_group) noexcept;
+
+    /**
+     * @brief Add `fd` to the registered-file table.
+     *
+     * The table itself is registered sparse on the first call. A registered
+     * file stays open while it is in the table, so `unregister_file()` must
+     * run before the descriptor is closed.
+     * @return `ENFILE` when every slot is taken; registering twice is a no-op.
+     */
+    [[nodiscard]] result<void> register_file(int fd) noexcept;
+    /**
+     * @brief Remove `fd` from the registered-file table.
+     *
+     * Pending SQEs are submitted first, since they name the slot.
+     */
+    [[nodiscard]] result<void> unregister_file(int fd) noexcept;
+    /// @return Table slot of `fd`, or empty when it is not registered.
+    [[nodiscard]] std::optional<std::uint32_t> file_slot(int fd) const noexcept;
+    /**
+     * @brief Register `buffers` as the ring's fixed buffers.
+     *
+     * The memory must stay valid until `unregister_buffers()` or the ring
+     * goes away. Replaces nothing: unregister first to change the set.
+     */
+    [[nodiscard]] result<void>
+    register_buffers(std::span<const ::iovec> buffers) noexcept;
+    /// @brief Drop the fixed buffers registered with `register_buffers()`.
+    [[nodiscard]] result<void> unregister_buffers() noexcept;
+
+    /// @return `IORING_SETUP_*` flags the ring was created with.
+    [[nodiscard]] std::uint32_t setup_flags() const noexcept;
+    /// @return `IORING_FEAT_*` bits reported by the kernel.
+    [[nodiscard]] std::uint32_t features() const noexcept;
 
     /// @return `true` when the ring is initialized.
     [[nodiscard]] bool valid() const noexcept;
+    /// @return Underlying ring, or `nullptr` when invalid.
+    [[nodiscard]] io_uring *native_handle() noexcept;
 
 private:
+    [[nodiscard]] result<io_uring_sqe *> acquire_sqe(std::uint64_t user_data,
+                                                     int fd) noexcept;
+    void target_file(io_uring_sqe *sqe, int fd) const noexcept;
+    [[nodiscard]] std::size_t reap(std::span<completion> completions) noexcept;
+    [[nodiscard]] std::optional<std::uint16_t>
+    fixed_buffer_index(std::span<const std::byte> buffer) const noexcept;
+
     std::unique_ptr<io_uring, void (*)(io_uring *)> ring_{nullptr, nullptr};
+    std::uint32_t setup_flags_{0};
+    std::uint32_t features_{0};
+    bool link_timeout_{false};
+    /// Slot + 1 per descriptor; `0` means not registered.
+    std::vector<std::uint32_t> file_slots_{};
+    std::vector<std::uint32_t> free_file_slots_{};
+    std::uint32_t used_file_slots_{0};
+    bool file_table_registered_{false};
+    std::vector<::iovec> fixed_buffers_{};
 };
 
 } // namespace simplenet::uring
@@ -1,6 +1,14 @@
 #!/usr/bin/env python3
-"""Generate README performance figures as static PNG images."""
+"""Generate README performance figures as static PNG images.
 
+Pass the CSV written by run_perf_suite.sh (OPEN_LOOP_CSV, by default
+build-perf/open_loop_latency.csv) as the first argument to also plot the
+open-loop latency percentiles.
+"""
+
+import csv
+import statistics
+import sys
 from pathlib import Path
 
 import matplotlib.pyplot as plt
@@ -152,6 +160,69 @@ def generate_async_paired_ratio(output_dir: Path) -> None:
     plt.close(fig)
 
 
+OPEN_LOOP_PERCENTILES = ["p50_us", "p99_us", "p999_us", "max_us"]
+OPEN_LOOP_COLORS = {
+    ("libsimplenet", "epoll"): "#0969da",
+    ("libsimplenet", "io_uring"): "#2da44e",
+    ("boost_asio", "epoll"): "#8250df",
+}
+
+
+def load_open_loop_medians(csv_path: Path) -> dict:
+    """Median of each percentile column per (rate, impl, backend)."""
+    samples: dict = {}
+    with csv_path.open(newline="") as handle:
+        for row in csv.DictReader(handle):
+            key = (int(row["rate"]), row["impl"], row["backend"])
+            for column in OPEN_LOOP_PERCENTILES:
+                samples.setdefault(key, {}).setdefault(column, []).append(
+                    float(row[column])
+                )
+    return {
+        key: {column: statistics.median(values) for column, values in columns.items()}
+        for key, columns in samples.items()
+    }
+
+
+def generate_open_loop_latency(output_dir: Path, csv_path: Path) -> None:
+    medians = load_open_loop_medians(csv_path)
+    if not medians:
+        return
+    rates = sorted({rate for rate, _, _ in medians})
+    variants = [variant for variant in OPEN_LOOP_COLORS if any(
+        (rate, *variant) in medians for rate in rates)]
+
+    fig, axes = plt.subplots(
+        1, len(rates), figsize=(4.8 * len(rates) + 1.0, 5.0), squeeze=False
+    )
+    x = np.arange(len(OPEN_LOOP_PERCENTILES))
+    width = 0.8 / max(len(variants), 1)
+    for ax, rate in zip(axes[0], rates, strict=True):
+        for offset, variant in enumerate(variants):
+            values = medians.get((rate, *variant))
+            if values is None:
+                continue
+            ax.bar(
+                x + (offset - (len(variants) - 1) / 2.0) * width,
+                [values[column] for column in OPEN_LOOP_PERCENTILES],
+                width,
+                label=f"{variant[0]} ({variant[1]})",
+                color=OPEN_LOOP_COLORS[variant],
+                edgecolor="#1f2328",
+                linewidth=0.6,
+            )
+        ax.set_yscale("log")
+        ax.set_xticks(x)
+        ax.set_xticklabels(["p50", "p99", "p99.9", "max"])
+        ax.set_title(f"{rate:,} req/s")
+    axes[0][0].set_ylabel("Latency (us, log scale, lower is better)")
+    axes[0][0].legend(loc="upper left")
+    fig.suptitle("Open-Loop Echo Latency (coordinated-omission corrected)")
+    fig.tight_layout()
+    fig.savefig(output_dir / "perf-open-loop-latency.png", dpi=180)
+    plt.close(fig)
+
+
 def main() -> None:
     repo_root = Path(__file__).resolve().parents[1]
     output_dir = repo_root / "docs" / "usage" / "figures"
@@ -161,6 +232,8 @@ def main() -> None:
     generate_core_relative(output_dir)
     generate_async_medians(output_dir)
     generate_async_paired_ratio(output_dir)
+    if len(sys.argv) > 1:
+        generate_open_loop_latency(output_dir, Path(sys.argv[1]))
 
 
 if __name__ == "__main__":
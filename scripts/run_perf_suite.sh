@@ -16,8 +16,32 @@ ASYNC_ECHO_CONNECTIONS="${ASYNC_ECHO_CONNECTIONS:-${ECHO_CONNECTIONS}}"
 ASYNC_URING_QUEUE_DEPTH="${ASYNC_URING_QUEUE_DEPTH:-512}"
 CHURN_ITERATIONS="${CHURN_ITERATIONS:-1500}"
 CHURN_CONNECTION_LEVELS="${CHURN_CONNECTION_LEVELS:-16,32,64}"
+OPEN_LOOP_RATES="${OPEN_LOOP_RATES:-10000,40000}"
+OPEN_LOOP_CONNECTIONS="${OPEN_LOOP_CONNECTIONS:-64}"
+OPEN_LOOP_PAYLOAD_SIZE="${OPEN_LOOP_PAYLOAD_SIZE:-64}"
+OPEN_LOOP_DURATION_MS="${OPEN_LOOP_DURATION_MS:-3000}"
+OPEN_LOOP_CSV="${OPEN_LOOP_CSV:-${BUILD_DIR}/open_loop_latency.csv}"
+SCALE_IDLE_LEVELS="${SCALE_IDLE_LEVELS:-1000,10000}"
+SCALE_ACTIVE_LEVELS="${SCALE_ACTIVE_LEVELS:-64}"
+SCALE_THREAD_LEVELS="${SCALE_THREAD_LEVELS:-1,2}"
+SCALE_PAYLOAD_SIZES="${SCALE_PAYLOAD_SIZES:-64,4096}"
+SCALE_DURATION_MS="${SCALE_DURATION_MS:-2000}"
+MICRO_ITERATIONS="${MICRO_ITERATIONS:-200000}"
+MICRO_RESIDENT_TIMERS="${MICRO_RESIDENT_TIMERS:-100000}"
 PERF_REPEATS="${PERF_REPEATS:-6}"
 
+# Cases of simplenet_perf_runtime_micro, in the order it runs them.
+MICRO_CASES=(
+  task_await task_chain schedule_resume wait_readable
+  writer_enqueue_flush timer_insert_cancel cancel_source_create
+)
+
+# Latency columns of simplenet_perf_open_loop_* PERF lines, in CSV order.
+OPEN_LOOP_PERCENTILES=(
+  p50_us p99_us p999_us max_us
+  uncorrected_p50_us uncorrected_p99_us uncorrected_p999_us uncorrected_max_us
+)
+
 die() {
   printf 'error: %s\n' "$*" >&2
   exit 1
@@ -697,6 +721,298 @@ run_async_pair_series() {
     "$(median_of_values "${paired_speed_ratio[@]}")"
 }
 
+record_open_loop_run() {
+  local line="$1"
+  local impl="$2"
+  local backend="$3"
+  local rate="$4"
+  local run_id="$5"
+  local position="$6"
+
+  local percentile_keys
+  percentile_keys="$(IFS=','; printf '%s' "${OPEN_LOOP_PERCENTILES[*]}")"
+  validate_perf_line "${line}" "${impl}" "open_loop_echo" \
+    "impl,scenario,backend,rate,connections,payload_size,duration_ms,requests,achieved_rate,${percentile_keys}" ||
+    die "malformed PERF line for ${impl} open_loop_echo: ${line}"
+
+  local value
+  local row
+  value="$(extract_perf_field "${line}" "backend")" ||
+    die "invalid backend in ${impl} open_loop_echo PERF line: ${line}"
+  assert_equals "${backend}" "${value}" "${impl} open_loop_echo backend"
+  value="$(extract_integer_field "${line}" "rate")" ||
+    die "invalid rate in ${impl} open_loop_echo PERF line: ${line}"
+  assert_equals "${rate}" "${value}" "${impl} open_loop_echo rate"
+  value="$(extract_integer_field "${line}" "connections")" ||
+    die "invalid connections in ${impl} open_loop_echo PERF line: ${line}"
+  assert_equals "${OPEN_LOOP_CONNECTIONS}" "${value}" "${impl} open_loop_echo connections"
+  value="$(extract_integer_field "${line}" "payload_size")" ||
+    die "invalid payload_size in ${impl} open_loop_echo PERF line: ${line}"
+  assert_equals "${OPEN_LOOP_PAYLOAD_SIZE}" "${value}" "${impl} open_loop_echo payload_size"
+
+  row="${impl},${backend},${rate},${OPEN_LOOP_CONNECTIONS},${OPEN_LOOP_PAYLOAD_SIZE},${run_id}"
+  value="$(extract_integer_field "${line}" "requests")" ||
+    die "invalid requests in ${impl} open_loop_echo PERF line: ${line}"
+  row+=",${value}"
+  for key in achieved_rate "${OPEN_LOOP_PERCENTILES[@]}"; do
+    value="$(extract_numeric_field "${line}" "${key}")" ||
+      die "invalid ${key} in ${impl} open_loop_echo PERF line: ${line}"
+    row+=",${value}"
+  done
+  printf '%s\n' "${row}" >>"${OPEN_LOOP_CSV}"
+
+  emit_perf_run_line "${line}" "${run_id}" "${position}"
+}
+
+run_open_loop_program() {
+  local impl="$1"
+  local backend="$2"
+  local rate="$3"
+
+  local args=(
+    --rate "${rate}"
+    --connections "${OPEN_LOOP_CONNECTIONS}"
+    --payload-size "${OPEN_LOOP_PAYLOAD_SIZE}"
+    --duration-ms "${OPEN_LOOP_DURATION_MS}"
+  )
+  if [[ "${impl}" == "libsimplenet" ]]; then
+    run_perf_program libsimplenet open_loop_echo \
+      "${BUILD_DIR}/example/simplenet_perf_open_loop_libsimplenet" \
+      "${args[@]}" --backend "${backend}" \
+      --uring-queue-depth "${ASYNC_URING_QUEUE_DEPTH}"
+  else
+    run_perf_program boost_asio open_loop_echo \
+      "${BUILD_DIR}/example/simplenet_perf_open_loop_boost_asio" "${args[@]}"
+  fi
+}
+
+run_open_loop_series() {
+  local rate="$1"
+
+  local variants=("libsimplenet:epoll")
+  if [[ "${ASYNC_IO_URING_AVAILABLE}" == "1" ]]; then
+    variants+=("libsimplenet:io_uring")
+  fi
+  variants+=("boost_asio:epoll")
+
+  local order
+  local rep
+  local position
+  local index
+  local variant
+  local line
+  for ((rep = 1; rep <= PERF_REPEATS; ++rep)); do
+    order=()
+    for ((index = 0; index < ${#variants[@]}; ++index)); do
+      if (( rep % 2 == 1 )); then
+        order+=("${variants[$index]}")
+      else
+        order+=("${variants[$(( ${#variants[@]} - 1 - index ))]}")
+      fi
+    done
+
+    position=1
+    for variant in "${order[@]}"; do
+      line="$(run_open_loop_program "${variant%%:*}" "${variant#*:}" "${rate}")"
+      record_open_loop_run "${line}" "${variant%%:*}" "${variant#*:}" "${rate}" \
+        "${rep}" "${position}"
+      position=$((position + 1))
+    done
+  done
+
+  local column
+  local key
+  local summary
+  for variant in "${variants[@]}"; do
+    summary=""
+    column=9
+    for key in "${OPEN_LOOP_PERCENTILES[@]}"; do
+      local samples=()
+      mapfile -t samples < <(awk -F',' -v impl="${variant%%:*}" \
+        -v backend="${variant#*:}" -v rate="${rate}" -v col="${column}" \
+        '$1 == impl && $2 == backend && $3 == rate { print $col }' "${OPEN_LOOP_CSV}")
+      summary+=",${key}=$(median_of_values "${samples[@]}")"
+      column=$((column + 1))
+    done
+    printf 'PERF_MEDIAN,impl=%s,scenario=open_loop_echo,backend=%s,runs=%s,rate=%s,connections=%s,payload_size=%s,duration_ms=%s%s\n' \
+      "${variant%%:*}" \
+      "${variant#*:}" \
+      "${PERF_REPEATS}" \
+      "${rate}" \
+      "${OPEN_LOOP_CONNECTIONS}" \
+      "${OPEN_LOOP_PAYLOAD_SIZE}" \
+      "${OPEN_LOOP_DURATION_MS}" \
+      "${summary}"
+  done
+}
+
+record_scale_run() {
+  local line="$1"
+  local backend="$2"
+  local threads="$3"
+  local idle="$4"
+  local active="$5"
+  local payload="$6"
+  local run_id="$7"
+  local throughput_name="$8"
+  local rss_name="$9"
+  local cpu_name="${10}"
+
+  validate_perf_line "${line}" "libsimplenet" "scalability" \
+    "impl,scenario,backend,threads,idle_connections,active_connections,payload_size,duration_ms,read_timeout_ms,requests,throughput_rps,rss_bytes_per_connection,loop_cpu_us_per_request,loop_cpu_utilization" ||
+    die "malformed PERF line for libsimplenet scalability: ${line}"
+
+  local value
+  value="$(extract_perf_field "${line}" "backend")" ||
+    die "invalid backend in libsimplenet scalability PERF line: ${line}"
+  assert_equals "${backend}" "${value}" "libsimplenet scalability backend"
+  value="$(extract_integer_field "${line}" "threads")" ||
+    die "invalid threads in libsimplenet scalability PERF line: ${line}"
+  assert_equals "${threads}" "${value}" "libsimplenet scalability threads"
+  value="$(extract_integer_field "${line}" "idle_connections")" ||
+    die "invalid idle_connections in libsimplenet scalability PERF line: ${line}"
+  assert_equals "${idle}" "${value}" "libsimplenet scalability idle_connections"
+  value="$(extract_integer_field "${line}" "active_connections")" ||
+    die "invalid active_connections in libsimplenet scalability PERF line: ${line}"
+  assert_equals "${active}" "${value}" "libsimplenet scalability active_connections"
+  value="$(extract_integer_field "${line}" "payload_size")" ||
+    die "invalid payload_size in libsimplenet scalability PERF line: ${line}"
+  assert_equals "${payload}" "${value}" "libsimplenet scalability payload_size"
+
+  value="$(extract_numeric_field "${line}" "throughput_rps")" ||
+    die "invalid throughput_rps in libsimplenet scalability PERF line: ${line}"
+  append_to_array "${throughput_name}" "${value}"
+  value="$(extract_numeric_field "${line}" "rss_bytes_per_connection")" ||
+    die "invalid rss_bytes_per_connection in libsimplenet scalability PERF line: ${line}"
+  append_to_array "${rss_name}" "${value}"
+  value="$(extract_numeric_field "${line}" "loop_cpu_us_per_request")" ||
+    die "invalid loop_cpu_us_per_request in libsimplenet scalability PERF line: ${line}"
+  append_to_array "${cpu_name}" "${value}"
+
+  emit_perf_run_line "${line}" "${run_id}" "1"
+}
+
+run_scale_series() {
+  local backend="$1"
+  local threads="$2"
+  local idle="$3"
+  local active="$4"
+  local payload="$5"
+
+  local throughput=()
+  local rss=()
+  local cpu=()
+  local line
+  local rep
+  for ((rep = 1; rep <= PERF_REPEATS; ++rep)); do
+    line="$(run_perf_program \
+      libsimplenet \
+      scalability \
+      "${BUILD_DIR}/example/simplenet_perf_scalability_libsimplenet" \
+      --backend "${backend}" \
+      --threads "${threads}" \
+      --client-threads "${threads}" \
+      --idle-connections "${idle}" \
+      --active-connections "${active}" \
+      --payload-size "${payload}" \
+      --duration-ms "${SCALE_DURATION_MS}" \
+      --uring-queue-depth "${ASYNC_URING_QUEUE_DEPTH}")"
+    record_scale_run "${line}" "${backend}" "${threads}" "${idle}" "${active}" \
+      "${payload}" "${rep}" throughput rss cpu
+  done
+
+  printf 'PERF_MEDIAN,impl=libsimplenet,scenario=scalability,backend=%s,runs=%s,threads=%s,idle_connections=%s,active_connections=%s,payload_size=%s,duration_ms=%s,throughput_rps=%s,rss_bytes_per_connection=%s,loop_cpu_us_per_request=%s\n' \
+    "${backend}" \
+    "${PERF_REPEATS}" \
+    "${threads}" \
+    "${idle}" \
+    "${active}" \
+    "${payload}" \
+    "${SCALE_DURATION_MS}" \
+    "$(median_of_values "${throughput[@]}")" \
+    "$(median_of_values "${rss[@]}")" \
+    "$(median_of_values "${cpu[@]}")"
+}
+
+run_scale_matrix() {
+  local backends=("epoll")
+  if [[ "${ASYNC_IO_URING_AVAILABLE}" == "1" ]]; then
+    backends+=("io_uring")
+  fi
+
+  local backend
+  local threads
+  local idle
+  local active
+  local payload
+  for backend in "${backends[@]}"; do
+    for threads in "${scale_threads[@]}"; do
+      for idle in "${scale_idle_levels[@]}"; do
+        for active in "${scale_active_levels[@]}"; do
+          for payload in "${scale_payloads[@]}"; do
+            run_scale_series "${backend}" "${threads}" "${idle}" "${active}" "${payload}"
+          done
+        done
+      done
+    done
+  done
+}
+
+run_micro_series() {
+  local backend="$1"
+  local micro_case="$2"
+
+  local ns_per_op=()
+  local line
+  local value
+  local rep
+  for ((rep = 1; rep <= PERF_REPEATS; ++rep)); do
+    line="$(run_perf_program \
+      libsimplenet \
+      runtime_micro \
+      "${BUILD_DIR}/example/simplenet_perf_runtime_micro" \
+      --backend "${backend}" \
+      --case "${micro_case}" \
+      --iterations "${MICRO_ITERATIONS}" \
+      --resident-timers "${MICRO_RESIDENT_TIMERS}")"
+    validate_perf_line "${line}" "libsimplenet" "runtime_micro" \
+      "impl,scenario,case,backend,iterations,ops,total_ms,ns_per_op,ops_per_sec" ||
+      die "malformed PERF line for libsimplenet runtime_micro: ${line}"
+    value="$(extract_perf_field "${line}" "case")" ||
+      die "invalid case in libsimplenet runtime_micro PERF line: ${line}"
+    assert_equals "${micro_case}" "${value}" "libsimplenet runtime_micro case"
+    value="$(extract_perf_field "${line}" "backend")" ||
+      die "invalid backend in libsimplenet runtime_micro PERF line: ${line}"
+    assert_equals "${backend}" "${value}" "libsimplenet runtime_micro backend"
+    value="$(extract_numeric_field "${line}" "ns_per_op")" ||
+      die "invalid ns_per_op in libsimplenet runtime_micro PERF line: ${line}"
+    append_to_array ns_per_op "${value}"
+    emit_perf_run_line "${line}" "${rep}" "1"
+  done
+
+  printf 'PERF_MEDIAN,impl=libsimplenet,scenario=runtime_micro,case=%s,backend=%s,runs=%s,iterations=%s,ns_per_op=%s\n' \
+    "${micro_case}" \
+    "${backend}" \
+    "${PERF_REPEATS}" \
+    "${MICRO_ITERATIONS}" \
+    "$(median_of_values "${ns_per_op[@]}")"
+}
+
+run_micro_suite() {
+  local backends=("epoll")
+  if [[ "${ASYNC_IO_URING_AVAILABLE}" == "1" ]]; then
+    backends+=("io_uring")
+  fi
+
+  local backend
+  local micro_case
+  for backend in "${backends[@]}"; do
+    for micro_case in "${MICRO_CASES[@]}"; do
+      run_micro_series "${backend}" "${micro_case}"
+    done
+  done
+}
+
 run_idle_series() {
   local libs_total_ms=()
   local libs_avg_ns=()
@@ -958,6 +1274,12 @@ require_positive_integer "ASYNC_ECHO_ITERATIONS" "${ASYNC_ECHO_ITERATIONS}"
 require_positive_integer "ASYNC_ECHO_CONNECTIONS" "${ASYNC_ECHO_CONNECTIONS}"
 require_positive_integer "ASYNC_URING_QUEUE_DEPTH" "${ASYNC_URING_QUEUE_DEPTH}"
 require_positive_integer "CHURN_ITERATIONS" "${CHURN_ITERATIONS}"
+require_positive_integer "OPEN_LOOP_CONNECTIONS" "${OPEN_LOOP_CONNECTIONS}"
+require_positive_integer "OPEN_LOOP_PAYLOAD_SIZE" "${OPEN_LOOP_PAYLOAD_SIZE}"
+require_positive_integer "OPEN_LOOP_DURATION_MS" "${OPEN_LOOP_DURATION_MS}"
+require_positive_integer "SCALE_DURATION_MS" "${SCALE_DURATION_MS}"
+require_positive_integer "MICRO_ITERATIONS" "${MICRO_ITERATIONS}"
+require_positive_integer "MICRO_RESIDENT_TIMERS" "${MICRO_RESIDENT_TIMERS}"
 require_positive_integer "PERF_REPEATS" "${PERF_REPEATS}"
 if (( PERF_REPEATS % 2 != 0 )); then
   die "PERF_REPEATS must be even to fully balance alternating run order"
@@ -967,8 +1289,18 @@ parse_csv_positive_integers "${ECHO_PAYLOAD_SIZES}" echo_payloads ||
   die "ECHO_PAYLOAD_SIZES must be comma-separated positive integers, got: ${ECHO_PAYLOAD_SIZES}"
 parse_csv_positive_integers "${ASYNC_ECHO_PAYLOAD_SIZES}" async_echo_payloads ||
   die "ASYNC_ECHO_PAYLOAD_SIZES must be comma-separated positive integers, got: ${ASYNC_ECHO_PAYLOAD_SIZES}"
+parse_csv_positive_integers "${OPEN_LOOP_RATES}" open_loop_rates ||
+  die "OPEN_LOOP_RATES must be comma-separated positive integers, got: ${OPEN_LOOP_RATES}"
 parse_csv_positive_integers "${CHURN_CONNECTION_LEVELS}" churn_levels ||
   die "CHURN_CONNECTION_LEVELS must be comma-separated positive integers, got: ${CHURN_CONNECTION_LEVELS}"
+parse_csv_positive_integers "${SCALE_IDLE_LEVELS}" scale_idle_levels ||
+  die "SCALE_IDLE_LEVELS must be comma-separated positive integers, got: ${SCALE_IDLE_LEVELS}"
+parse_csv_positive_integers "${SCALE_ACTIVE_LEVELS}" scale_active_levels ||
+  die "SCALE_ACTIVE_LEVELS must be comma-separated positive integers, got: ${SCALE_ACTIVE_LEVELS}"
+parse_csv_positive_integers "${SCALE_THREAD_LEVELS}" scale_threads ||
+  die "SCALE_THREAD_LEVELS must be comma-separated positive integers, got: ${SCALE_THREAD_LEVELS}"
+parse_csv_positive_integers "${SCALE_PAYLOAD_SIZES}" scale_payloads ||
+  die "SCALE_PAYLOAD_SIZES must be comma-separated positive integers, got: ${SCALE_PAYLOAD_SIZES}"
 
 cmake_args=(
   -S "${ROOT_DIR}"
@@ -984,13 +1316,17 @@ cmake --build "${BUILD_DIR}" \
   --target \
   simplenet_backend_switch \
   simplenet_perf_reactor_wait \
+  simplenet_perf_runtime_micro \
   simplenet_perf_tcp_echo_libsimplenet \
   simplenet_perf_connection_churn_libsimplenet \
   simplenet_perf_async_echo_libsimplenet \
+  simplenet_perf_open_loop_libsimplenet \
+  simplenet_perf_scalability_libsimplenet \
   simplenet_perf_boost_asio_wait \
   simplenet_perf_tcp_echo_boost_asio \
   simplenet_perf_connection_churn_boost_asio \
   simplenet_perf_async_echo_boost_asio \
+  simplenet_perf_open_loop_boost_asio \
   >/dev/null
 
 git_sha="unknown"
@@ -1081,7 +1417,26 @@ if [[ "${ASYNC_IO_URING_AVAILABLE}" != "1" ]]; then
   printf 'PERF_SKIP,scenario=async_tcp_echo,impl=libsimplenet,backend=io_uring,reason=backend_unavailable\n'
 fi
 
+printf 'PERF_META_OPEN_LOOP,rates=%s,connections=%s,payload_size=%s,duration_ms=%s,csv=%s\n' \
+  "${OPEN_LOOP_RATES}" \
+  "${OPEN_LOOP_CONNECTIONS}" \
+  "${OPEN_LOOP_PAYLOAD_SIZE}" \
+  "${OPEN_LOOP_DURATION_MS}" \
+  "${OPEN_LOOP_CSV}"
+printf 'PERF_META_MICRO,iterations=%s,resident_timers=%s\n' \
+  "${MICRO_ITERATIONS}" \
+  "${MICRO_RESIDENT_TIMERS}"
+printf 'PERF_META_SCALE,idle_levels=%s,active_levels=%s,thread_levels=%s,payload_sizes=%s,duration_ms=%s\n' \
+  "${SCALE_IDLE_LEVELS}" \
+  "${SCALE_ACTIVE_LEVELS}" \
+  "${SCALE_THREAD_LEVELS}" \
+  "${SCALE_PAYLOAD_SIZES}" \
+  "${SCALE_DURATION_MS}"
+printf 'impl,backend,rate,connections,payload_size,run,requests,achieved_rate,%s\n' \
+  "$(IFS=','; printf '%s' "${OPEN_LOOP_PERCENTILES[*]}")" >"${OPEN_LOOP_CSV}"
+
 run_idle_series
+run_micro_suite
 
 for payload in "${echo_payloads[@]}"; do
   run_echo_series "${payload}"
@@ -1094,3 +1449,9 @@ done
 for level in "${churn_levels[@]}"; do
   run_churn_series "${level}"
 done
+
+for rate in "${open_loop_rates[@]}"; do
+  run_open_loop_series "${rate}"
+done
+
+run_scale_matrix
@@ -1,5 +1,30 @@
 #include "simplenet/blocking/endpoint.hpp"
 
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+
+namespace {
+
+template <class Native>
+simplenet::blocking::socket_address wrap(const Native& native) noexcept {
+    simplenet::blocking::socket_address address{};
+    std::memcpy(&address.storage, &native, sizeof(native));
+    address.length = static_cast<::socklen_t>(sizeof(native));
+    return address;
+}
+
+template <class Native>
+bool holds(const simplenet::blocking::socket_address& address,
+           int family) noexcept {
+    return address.storage.ss_family == family &&
+           address.length >= static_cast<::socklen_t>(sizeof(Native));
+}
+
+} // namespace
+
 namespace simplenet::blocking {
 
 endpoint endpoint::loopback(std::uint16_t port) {
@@ -10,4 +35,118 @@ endpoint endpoint::any(std::uint16_t port) {
     return endpoint{.host = "0.0.0.0", .port = port};
 }
 
+result<socket_address>
+socket_address::from_endpoint(const endpoint& ep) noexcept {
+    ::sockaddr_in ipv4{};
+    if (::inet_pton(AF_INET, ep.host.c_str(), &ipv4.sin_addr) == 1) {
+        ipv4.sin_family = AF_INET;
+        ipv4.sin_port = ::htons(ep.port);
+        return wrap(ipv4);
+    }
+
+    ::sockaddr_in6 ipv6{};
+    if (::inet_pton(AF_INET6, ep.host.c_str(), &ipv6.sin6_addr) == 1) {
+        ipv6.sin6_family = AF_INET6;
+        ipv6.sin6_port = ::htons(ep.port);
+        return wrap(ipv6);
+    }
+    return err<socket_address>(make_error_from_errno(EINVAL));
+}
+
+result<socket_address> socket_address::from_native(const ::sockaddr *address,
+                                                   ::socklen_t length) noexcept {
+    if (address == nullptr ||
+        length > static_cast<::socklen_t>(sizeof(::sockaddr_storage))) {
+        return err<socket_address>(make_error_from_errno(EINVAL));
+    }
+
+    socket_address copy{};
+    std::memcpy(&copy.storage, address, static_cast<std::size_t>(length));
+    copy.length = length;
+    return copy;
+}
+
+socket_address socket_address::loopback(std::uint16_t port) noexcept {
+    ::sockaddr_in ipv4{};
+    ipv4.sin_family = AF_INET;
+    ipv4.sin_port = ::htons(port);
+    ipv4.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+    return wrap(ipv4);
+}
+
+socket_address socket_address::ipv6_loopback(std::uint16_t port) noexcept {
+    ::sockaddr_in6 ipv6{};
+    ipv6.sin6_family = AF_INET6;
+    ipv6.sin6_port = ::htons(port);
+    ipv6.sin6_addr = in6addr_loopback;
+    return wrap(ipv6);
+}
+
+socket_address socket_address::any(std::uint16_t port) noexcept {
+    ::sockaddr_in ipv4{};
+    ipv4.sin_family = AF_INET;
+    ipv4.sin_port = ::htons(port);
+    ipv4.sin_addr.s_addr = ::htonl(INADDR_ANY);
+    return wrap(ipv4);
+}
+
+socket_address socket_address::ipv6_any(std::uint16_t port) noexcept {
+    ::sockaddr_in6 ipv6{};
+    ipv6.sin6_family = AF_INET6;
+    ipv6.sin6_port = ::htons(port);
+    ipv6.sin6_addr = in6addr_any;
+    return wrap(ipv6);
+}
+
+result<endpoint> socket_address::to_endpoint() const noexcept {
+    std::array<char, INET6_ADDRSTRLEN> host{};
+    if (holds<::sockaddr_in>(*this, AF_INET)) {
+        ::sockaddr_in ipv4{};
+        std::memcpy(&ipv4, &storage, sizeof(ipv4));
+        if (::inet_ntop(AF_INET, &ipv4.sin_addr, host.data(),
+                        static_cast<::socklen_t>(host.size())) == nullptr) {
+            return err<endpoint>(error::from_errno());
+        }
+        return endpoint{.host = host.data(), .port = ::ntohs(ipv4.sin_port)};
+    }
+    if (holds<::sockaddr_in6>(*this, AF_INET6)) {
+        ::sockaddr_in6 ipv6{};
+        std::memcpy(&ipv6, &storage, sizeof(ipv6));
+        if (::inet_ntop(AF_INET6, &ipv6.sin6_addr, host.data(),
+                        static_cast<::socklen_t>(host.size())) == nullptr) {
+            return err<endpoint>(error::from_errno());
+        }
+        return endpoint{.host = host.data(), .port = ::ntohs(ipv6.sin6_port)};
+    }
+    return err<endpoint>(make_error_from_errno(EAFNOSUPPORT));
+}
+
+int socket_address::family() const noexcept {
+    return length == 0 ? AF_UNSPEC : storage.ss_family;
+}
+
+std::uint16_t socket_address::port() const noexcept {
+    if (holds<::sockaddr_in>(*this, AF_INET)) {
+        ::sockaddr_in ipv4{};
+        std::memcpy(&ipv4, &storage, sizeof(ipv4));
+        return ::ntohs(ipv4.sin_port);
+    }
+    if (holds<::sockaddr_in6>(*this, AF_INET6)) {
+        ::sockaddr_in6 ipv6{};
+        std::memcpy(&ipv6, &storage, sizeof(ipv6));
+        return ::ntohs(ipv6.sin6_port);
+    }
+    return 0;
+}
+
+const ::sockaddr *socket_address::data() const noexcept {
+    return reinterpret_cast<const ::sockaddr *>(&storage);
+}
+
+bool operator==(const socket_address& lhs, const socket_address& rhs) noexcept {
+    return lhs.length == rhs.length &&
+           std::memcmp(&lhs.storage, &rhs.storage,
+                       static_cast<std::size_t>(lhs.length)) == 0;
+}
+
 } // namespace simplenet::blocking
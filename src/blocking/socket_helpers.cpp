@@ -1,35 +1,22 @@
 #include "socket_helpers.hpp"
 
-#include <arpa/inet.h>
-#include <array>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <poll.h>
 #include <sys/socket.h>
 
 namespace simplenet::blocking::detail {
 
-result<sockaddr_in> to_sockaddr(const endpoint& ep) noexcept {
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = ::htons(ep.port);
-
-    const int parse_status =
-        ::inet_pton(AF_INET, ep.host.c_str(), &addr.sin_addr);
-    if (parse_status == 1) {
-        return addr;
-    }
-
-    return err<sockaddr_in>(make_error_from_errno(EINVAL));
-}
-
-result<endpoint> from_sockaddr(const sockaddr_in& addr) noexcept {
-    std::array<char, INET_ADDRSTRLEN> buffer{};
-    const char *converted =
-        ::inet_ntop(AF_INET, &addr.sin_addr, buffer.data(), buffer.size());
-    if (converted == nullptr) {
-        return err<endpoint>(error::from_errno());
+result<socket_address> local_address(int fd) noexcept {
+    socket_address address{};
+    address.length = static_cast<socklen_t>(sizeof(address.storage));
+    if (::getsockname(fd, reinterpret_cast<sockaddr *>(&address.storage),
+                      &address.length) != 0) {
+        return err<socket_address>(error::from_errno());
     }
-
-    return endpoint{.host = std::string{converted},
-                    .port = ntohs(addr.sin_port)};
+    return address;
 }
 
 result<void> set_reuse_addr(int fd) noexcept {
@@ -41,4 +28,33 @@ result<void> set_reuse_addr(int fd) noexcept {
     return err<void>(error::from_errno());
 }
 
+result<std::chrono::steady_clock::time_point>
+deadline_after(std::chrono::milliseconds timeout) noexcept {
+    using time_point = std::chrono::steady_clock::time_point;
+    if (timeout.count() < 0) {
+        return err<time_point>(make_error_from_errno(EINVAL));
+    }
+    return std::chrono::steady_clock::now() + timeout;
+}
+
+result<void> wait_ready(int fd, short events,
+                        std::chrono::steady_clock::time_point deadline) noexcept {
+    while (true) {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) {
+            return err<void>(make_error_from_errno(ETIMEDOUT));
+        }
+        ::pollfd entry{.fd = fd, .events = events, .revents = 0};
+        const int ready = ::poll(&entry, 1, static_cast<int>(std::min<std::int64_t>(
+                                                left.count(), INT_MAX)));
+        if (ready > 0) {
+            return ok();
+        }
+        if (ready < 0 && errno != EINTR) {
+            return err<void>(error::from_errno());
+        }
+    }
+}
+
 } // namespace simplenet::blocking::detail
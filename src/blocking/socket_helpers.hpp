@@ -3,12 +3,23 @@
 #include "simplenet/blocking/endpoint.hpp"
 #include "simplenet/core/result.hpp"
 
-#include <netinet/in.h>
+#include <chrono>
 
 namespace simplenet::blocking::detail {
 
-[[nodiscard]] result<sockaddr_in> to_sockaddr(const endpoint& ep) noexcept;
-[[nodiscard]] result<endpoint> from_sockaddr(const sockaddr_in& addr) noexcept;
+[[nodiscard]] result<socket_address> local_address(int fd) noexcept;
 [[nodiscard]] result<void> set_reuse_addr(int fd) noexcept;
 
+/// Absolute deadline for a timed call; `EINVAL` for a negative timeout.
+[[nodiscard]] result<std::chrono::steady_clock::time_point>
+deadline_after(std::chrono::milliseconds timeout) noexcept;
+/**
+ * @brief `poll()` until `fd` reports `events` or `deadline` passes.
+ * @return `ETIMEDOUT` at the deadline; error and hang-up states count as
+ *         ready, so the caller's next syscall reports them.
+ */
+[[nodiscard]] result<void>
+wait_ready(int fd, short events,
+           std::chrono::steady_clock::time_point deadline) noexcept;
+
 } // namespace simplenet::blocking::detail
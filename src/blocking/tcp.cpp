@@ -2,28 +2,110 @@
 
 #include "socket_helpers.hpp"
 
+#include <array>
 #include <cerrno>
+#include <optional>
+#include <poll.h>
 #include <sys/socket.h>
 
 namespace simplenet::blocking {
 
+namespace {
+
+enum class direction { send, receive };
+
+/**
+ * Move every byte of `buffers` through `fd`, resuming partial transfers
+ * mid-buffer. With a deadline the socket is tried with `MSG_DONTWAIT` and
+ * only polled on `EAGAIN`, so data that is already there costs no `poll()`.
+ */
+result<void> transfer_all(int fd, std::span<const ::iovec> buffers,
+                          direction dir,
+                          std::optional<std::chrono::steady_clock::time_point>
+                              deadline) noexcept {
+    constexpr std::size_t kWindow = 64;
+    const int base_flags = dir == direction::send ? MSG_NOSIGNAL : 0;
+    const int flags = deadline.has_value() ? base_flags | MSG_DONTWAIT : base_flags;
+    const short events = dir == direction::send ? POLLOUT : POLLIN;
+
+    std::size_t index = 0;
+    std::size_t offset = 0;
+    while (true) {
+        while (index < buffers.size() && offset == buffers[index].iov_len) {
+            ++index;
+            offset = 0;
+        }
+        if (index == buffers.size()) {
+            return ok();
+        }
+
+        std::array<::iovec, kWindow> window{};
+        std::size_t count = 0;
+        for (std::size_t at = index; at < buffers.size() && count < kWindow; ++at) {
+            const std::size_t skip = at == index ? offset : 0;
+            if (buffers[at].iov_len > skip) {
+                window[count++] = ::iovec{
+                    static_cast<std::byte*>(buffers[at].iov_base) + skip,
+                    buffers[at].iov_len - skip};
+            }
+        }
+
+        ::msghdr message{};
+        message.msg_iov = window.data();
+        message.msg_iovlen = count;
+        const ssize_t moved = dir == direction::send
+                                  ? ::sendmsg(fd, &message, flags)
+                                  : ::recvmsg(fd, &message, flags);
+        if (moved < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (deadline.has_value() && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                const auto ready = detail::wait_ready(fd, events, *deadline);
+                if (!ready.has_value()) {
+                    return ready;
+                }
+                continue;
+            }
+            return err<void>(error::from_errno());
+        }
+        if (moved == 0) {
+            return err<void>(make_error_from_errno(
+                dir == direction::send ? EPIPE : ECONNRESET));
+        }
+
+        auto advanced = static_cast<std::size_t>(moved);
+        while (advanced > 0) {
+            const std::size_t left = buffers[index].iov_len - offset;
+            if (advanced < left) {
+                offset += advanced;
+                break;
+            }
+            advanced -= left;
+            ++index;
+            offset = 0;
+        }
+    }
+}
+
+} // namespace
+
 tcp_stream::tcp_stream(simplenet::unique_fd fd) noexcept : fd_(std::move(fd)) {}
 
 result<tcp_stream> tcp_stream::connect(const endpoint& remote) noexcept {
-    const auto maybe_addr = detail::to_sockaddr(remote);
+    const auto maybe_addr = socket_address::from_endpoint(remote);
     if (!maybe_addr.has_value()) {
         return err<tcp_stream>(maybe_addr.error());
     }
 
-    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const auto& addr = maybe_addr.value();
+    const int fd = ::socket(addr.family(), SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (fd < 0) {
         return err<tcp_stream>(error::from_errno());
     }
 
     unique_fd owned_fd{fd};
-    auto addr = maybe_addr.value();
-    if (::connect(owned_fd.get(), reinterpret_cast<const sockaddr *>(&addr),
-                  sizeof(addr)) != 0) {
+    if (::connect(owned_fd.get(), addr.data(), addr.length) != 0) {
         return err<tcp_stream>(error::from_errno());
     }
 
@@ -68,6 +150,72 @@ tcp_stream::write_some(std::span<const std::byte> buffer) noexcept {
     return static_cast<std::size_t>(write_count);
 }
 
+result<std::size_t>
+tcp_stream::read_some(std::span<std::byte> buffer,
+                      std::chrono::milliseconds timeout) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    const auto deadline = detail::deadline_after(timeout);
+    if (!deadline.has_value()) {
+        return err<std::size_t>(deadline.error());
+    }
+    if (buffer.empty()) {
+        return static_cast<std::size_t>(0);
+    }
+
+    while (true) {
+        const ssize_t read_count =
+            ::recv(fd_.get(), buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (read_count >= 0) {
+            return static_cast<std::size_t>(read_count);
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return err<std::size_t>(error::from_errno());
+        }
+        const auto ready = detail::wait_ready(fd_.get(), POLLIN, deadline.value());
+        if (!ready.has_value()) {
+            return err<std::size_t>(ready.error());
+        }
+    }
+}
+
+result<std::size_t>
+tcp_stream::write_some(std::span<const std::byte> buffer,
+                       std::chrono::milliseconds timeout) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    const auto deadline = detail::deadline_after(timeout);
+    if (!deadline.has_value()) {
+        return err<std::size_t>(deadline.error());
+    }
+    if (buffer.empty()) {
+        return static_cast<std::size_t>(0);
+    }
+
+    while (true) {
+        const ssize_t write_count = ::send(fd_.get(), buffer.data(), buffer.size(),
+                                           MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (write_count >= 0) {
+            return static_cast<std::size_t>(write_count);
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return err<std::size_t>(error::from_errno());
+        }
+        const auto ready = detail::wait_ready(fd_.get(), POLLOUT, deadline.value());
+        if (!ready.has_value()) {
+            return err<std::size_t>(ready.error());
+        }
+    }
+}
+
 result<void> tcp_stream::shutdown_write() noexcept {
     if (!valid()) {
         return err<void>(make_error_from_errno(EBADF));
@@ -91,12 +239,13 @@ tcp_listener::tcp_listener(simplenet::unique_fd fd) noexcept : fd_(std::move(fd)
 
 result<tcp_listener> tcp_listener::bind(const endpoint& local,
                                         int backlog) noexcept {
-    const auto maybe_addr = detail::to_sockaddr(local);
+    const auto maybe_addr = socket_address::from_endpoint(local);
     if (!maybe_addr.has_value()) {
         return err<tcp_listener>(maybe_addr.error());
     }
 
-    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const auto& addr = maybe_addr.value();
+    const int fd = ::socket(addr.family(), SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (fd < 0) {
         return err<tcp_listener>(error::from_errno());
     }
@@ -107,9 +256,7 @@ result<tcp_listener> tcp_listener::bind(const endpoint& local,
         return err<tcp_listener>(reuse_status.error());
     }
 
-    auto addr = maybe_addr.value();
-    if (::bind(owned_fd.get(), reinterpret_cast<const sockaddr *>(&addr),
-               sizeof(addr)) != 0) {
+    if (::bind(owned_fd.get(), addr.data(), addr.length) != 0) {
         return err<tcp_listener>(error::from_errno());
     }
 
@@ -138,14 +285,11 @@ result<std::uint16_t> tcp_listener::local_port() const noexcept {
         return err<std::uint16_t>(make_error_from_errno(EBADF));
     }
 
-    sockaddr_in addr{};
-    auto addr_len = static_cast<socklen_t>(sizeof(addr));
-    if (::getsockname(fd_.get(), reinterpret_cast<sockaddr *>(&addr),
-                      &addr_len) != 0) {
-        return err<std::uint16_t>(error::from_errno());
+    const auto address = detail::local_address(fd_.get());
+    if (!address.has_value()) {
+        return err<std::uint16_t>(address.error());
     }
-
-    return ntohs(addr.sin_port);
+    return address.value().port();
 }
 
 int tcp_listener::native_handle() const noexcept {
@@ -158,65 +302,72 @@ bool tcp_listener::valid() const noexcept {
 
 result<void> write_all(tcp_stream& stream,
                        std::span<const std::byte> buffer) noexcept {
+    const ::iovec single{const_cast<std::byte*>(buffer.data()), buffer.size()};
+    return writev_all(stream, std::span{&single, 1});
+}
+
+result<void> read_exact(tcp_stream& stream,
+                        std::span<std::byte> buffer) noexcept {
+    const ::iovec single{buffer.data(), buffer.size()};
+    return readv_exact(stream, std::span{&single, 1});
+}
+
+result<void> write_all(tcp_stream& stream,
+                       std::span<const std::byte> buffer,
+                       std::chrono::milliseconds timeout) noexcept {
+    const ::iovec single{const_cast<std::byte*>(buffer.data()), buffer.size()};
+    return writev_all(stream, std::span{&single, 1}, timeout);
+}
+
+result<void> read_exact(tcp_stream& stream,
+                        std::span<std::byte> buffer,
+                        std::chrono::milliseconds timeout) noexcept {
+    const ::iovec single{buffer.data(), buffer.size()};
+    return readv_exact(stream, std::span{&single, 1}, timeout);
+}
+
+result<void> writev_all(tcp_stream& stream,
+                        std::span<const ::iovec> buffers) noexcept {
     if (!stream.valid()) {
         return err<void>(make_error_from_errno(EBADF));
     }
-    if (buffer.empty()) {
-        return ok();
-    }
+    return transfer_all(stream.native_handle(), buffers, direction::send,
+                        std::nullopt);
+}
 
-    const int fd = stream.native_handle();
-    const std::byte* ptr = buffer.data();
-    std::size_t remaining = buffer.size();
-    while (remaining > 0) {
-        const ssize_t write_count =
-            ::send(fd, ptr, remaining, MSG_NOSIGNAL);
-        if (write_count < 0) {
-            if (errno == EINTR) {
-                continue;
-            }
-            return err<void>(error::from_errno());
-        }
-        if (write_count == 0) {
-            return err<void>(make_error_from_errno(EPIPE));
-        }
-        const auto advanced = static_cast<std::size_t>(write_count);
-        ptr += advanced;
-        remaining -= advanced;
+result<void> readv_exact(tcp_stream& stream,
+                         std::span<const ::iovec> buffers) noexcept {
+    if (!stream.valid()) {
+        return err<void>(make_error_from_errno(EBADF));
     }
-
-    return ok();
+    return transfer_all(stream.native_handle(), buffers, direction::receive,
+                        std::nullopt);
 }
 
-result<void> read_exact(tcp_stream& stream,
-                        std::span<std::byte> buffer) noexcept {
+result<void> writev_all(tcp_stream& stream, std::span<const ::iovec> buffers,
+                        std::chrono::milliseconds timeout) noexcept {
     if (!stream.valid()) {
         return err<void>(make_error_from_errno(EBADF));
     }
-    if (buffer.empty()) {
-        return ok();
+    const auto deadline = detail::deadline_after(timeout);
+    if (!deadline.has_value()) {
+        return err<void>(deadline.error());
     }
+    return transfer_all(stream.native_handle(), buffers, direction::send,
+                        deadline.value());
+}
 
-    const int fd = stream.native_handle();
-    std::byte* ptr = buffer.data();
-    std::size_t remaining = buffer.size();
-    while (remaining > 0) {
-        const ssize_t read_count = ::recv(fd, ptr, remaining, 0);
-        if (read_count < 0) {
-            if (errno == EINTR) {
-                continue;
-            }
-            return err<void>(error::from_errno());
-        }
-        if (read_count == 0) {
-            return err<void>(make_error_from_errno(ECONNRESET));
-        }
-        const auto advanced = static_cast<std::size_t>(read_count);
-        ptr += advanced;
-        remaining -= advanced;
+result<void> readv_exact(tcp_stream& stream, std::span<const ::iovec> buffers,
+                         std::chrono::milliseconds timeout) noexcept {
+    if (!stream.valid()) {
+        return err<void>(make_error_from_errno(EBADF));
     }
-
-    return ok();
+    const auto deadline = detail::deadline_after(timeout);
+    if (!deadline.has_value()) {
+        return err<void>(deadline.error());
+    }
+    return transfer_all(stream.native_handle(), buffers, direction::receive,
+                        deadline.value());
 }
 
 } // namespace simplenet::blocking
@@ -2,21 +2,78 @@
 
 #include "socket_helpers.hpp"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
+#include <poll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
 
 namespace simplenet::blocking {
 
+namespace {
+
+struct batch_scratch {
+    std::vector<::mmsghdr> headers;
+    std::vector<::iovec> buffers;
+
+    void reserve(std::size_t count) {
+        if (headers.size() < count) {
+            headers.resize(count);
+            buffers.resize(count);
+        }
+    }
+};
+
+thread_local batch_scratch scratch{};
+
+bool would_block() noexcept {
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+/// One `recvmmsg` into `messages`; `errno` is left set on failure.
+int receive_batch(int fd, std::span<udp_message> messages, int flags) noexcept {
+    const auto count = std::min(messages.size(), udp_batch_limit);
+    scratch.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& slot = messages[i];
+        scratch.buffers[i] = ::iovec{.iov_base = slot.buffer.data(),
+                                     .iov_len = slot.buffer.size()};
+        auto& header = scratch.headers[i];
+        header = ::mmsghdr{};
+        header.msg_hdr.msg_name = &slot.from.storage;
+        header.msg_hdr.msg_namelen =
+            static_cast<::socklen_t>(sizeof(slot.from.storage));
+        header.msg_hdr.msg_iov = &scratch.buffers[i];
+        header.msg_hdr.msg_iovlen = 1;
+    }
+
+    const int received = ::recvmmsg(fd, scratch.headers.data(),
+                                    static_cast<unsigned int>(count), flags, nullptr);
+    for (std::size_t i = 0; received > 0 && i < static_cast<std::size_t>(received);
+         ++i) {
+        const auto& header = scratch.headers[i];
+        auto& slot = messages[i];
+        slot.size = header.msg_len;
+        slot.from.length = header.msg_hdr.msg_namelen;
+        slot.truncated = (header.msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+    return received;
+}
+
+} // namespace
+
 udp_socket::udp_socket(simplenet::unique_fd fd) noexcept : fd_(std::move(fd)) {}
 
 result<udp_socket> udp_socket::bind(const endpoint& local) noexcept {
-    const auto maybe_addr = detail::to_sockaddr(local);
+    const auto maybe_addr = socket_address::from_endpoint(local);
     if (!maybe_addr.has_value()) {
         return err<udp_socket>(maybe_addr.error());
     }
 
-    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    const auto& addr = maybe_addr.value();
+    const int fd = ::socket(addr.family(), SOCK_DGRAM | SOCK_CLOEXEC, 0);
     if (fd < 0) {
         return err<udp_socket>(error::from_errno());
     }
@@ -27,9 +84,7 @@ result<udp_socket> udp_socket::bind(const endpoint& local) noexcept {
         return err<udp_socket>(reuse_status.error());
     }
 
-    auto addr = maybe_addr.value();
-    if (::bind(owned_fd.get(), reinterpret_cast<const sockaddr *>(&addr),
-               sizeof(addr)) != 0) {
+    if (::bind(owned_fd.get(), addr.data(), addr.length) != 0) {
         return err<udp_socket>(error::from_errno());
     }
 
@@ -42,16 +97,14 @@ result<std::size_t> udp_socket::send_to(std::span<const std::byte> buffer,
         return err<std::size_t>(make_error_from_errno(EBADF));
     }
 
-    const auto maybe_addr = detail::to_sockaddr(remote);
+    const auto maybe_addr = socket_address::from_endpoint(remote);
     if (!maybe_addr.has_value()) {
         return err<std::size_t>(maybe_addr.error());
     }
 
-    auto addr = maybe_addr.value();
-    const ssize_t sent =
-        ::sendto(fd_.get(), buffer.data(), buffer.size(), MSG_NOSIGNAL,
-                 reinterpret_cast<const sockaddr *>(&addr),
-                 static_cast<socklen_t>(sizeof(addr)));
+    const auto& addr = maybe_addr.value();
+    const ssize_t sent = ::sendto(fd_.get(), buffer.data(), buffer.size(),
+                                  MSG_NOSIGNAL, addr.data(), addr.length);
 
     if (sent < 0) {
         return err<std::size_t>(error::from_errno());
@@ -69,18 +122,18 @@ udp_socket::recv_from(std::span<std::byte> buffer) noexcept {
         return err<received_datagram>(make_error_from_errno(EINVAL));
     }
 
-    sockaddr_in from_addr{};
-    auto from_len = static_cast<socklen_t>(sizeof(from_addr));
+    socket_address from_addr{};
+    from_addr.length = static_cast<socklen_t>(sizeof(from_addr.storage));
 
-    const ssize_t received =
-        ::recvfrom(fd_.get(), buffer.data(), buffer.size(), 0,
-                   reinterpret_cast<sockaddr *>(&from_addr), &from_len);
+    const ssize_t received = ::recvfrom(
+        fd_.get(), buffer.data(), buffer.size(), 0,
+        reinterpret_cast<sockaddr *>(&from_addr.storage), &from_addr.length);
 
     if (received < 0) {
         return err<received_datagram>(error::from_errno());
     }
 
-    const auto from_endpoint = detail::from_sockaddr(from_addr);
+    const auto from_endpoint = from_addr.to_endpoint();
     if (!from_endpoint.has_value()) {
         return err<received_datagram>(from_endpoint.error());
     }
@@ -89,18 +142,146 @@ udp_socket::recv_from(std::span<std::byte> buffer) noexcept {
                              .from = from_endpoint.value()};
 }
 
+result<received_datagram>
+udp_socket::recv_from(std::span<std::byte> buffer,
+                      std::chrono::milliseconds timeout) noexcept {
+    if (!valid()) {
+        return err<received_datagram>(make_error_from_errno(EBADF));
+    }
+    if (buffer.empty()) {
+        return err<received_datagram>(make_error_from_errno(EINVAL));
+    }
+    const auto deadline = detail::deadline_after(timeout);
+    if (!deadline.has_value()) {
+        return err<received_datagram>(deadline.error());
+    }
+
+    socket_address from_addr{};
+    while (true) {
+        from_addr.length = static_cast<socklen_t>(sizeof(from_addr.storage));
+        const ssize_t received = ::recvfrom(
+            fd_.get(), buffer.data(), buffer.size(), MSG_DONTWAIT,
+            reinterpret_cast<sockaddr *>(&from_addr.storage), &from_addr.length);
+        if (received >= 0) {
+            const auto from_endpoint = from_addr.to_endpoint();
+            if (!from_endpoint.has_value()) {
+                return err<received_datagram>(from_endpoint.error());
+            }
+            return received_datagram{.size = static_cast<std::size_t>(received),
+                                     .from = from_endpoint.value()};
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (!would_block()) {
+            return err<received_datagram>(error::from_errno());
+        }
+        const auto ready = detail::wait_ready(fd_.get(), POLLIN, deadline.value());
+        if (!ready.has_value()) {
+            return err<received_datagram>(ready.error());
+        }
+    }
+}
+
+result<std::size_t>
+udp_socket::recv_batch(std::span<udp_message> messages) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (messages.empty()) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    while (true) {
+        // Block for the first datagram only, then drain what is queued.
+        const int received = receive_batch(fd_.get(), messages, MSG_WAITFORONE);
+        if (received >= 0) {
+            return static_cast<std::size_t>(received);
+        }
+        if (errno != EINTR) {
+            return err<std::size_t>(error::from_errno());
+        }
+    }
+}
+
+result<std::size_t>
+udp_socket::recv_batch(std::span<udp_message> messages,
+                       std::chrono::milliseconds timeout) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (messages.empty()) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+    const auto deadline = detail::deadline_after(timeout);
+    if (!deadline.has_value()) {
+        return err<std::size_t>(deadline.error());
+    }
+
+    while (true) {
+        const int received = receive_batch(fd_.get(), messages, MSG_DONTWAIT);
+        if (received > 0) {
+            return static_cast<std::size_t>(received);
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && !would_block()) {
+            return err<std::size_t>(error::from_errno());
+        }
+        const auto ready = detail::wait_ready(fd_.get(), POLLIN, deadline.value());
+        if (!ready.has_value()) {
+            return err<std::size_t>(ready.error());
+        }
+    }
+}
+
+result<std::size_t>
+udp_socket::send_batch(std::span<const udp_outgoing> datagrams) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (datagrams.empty()) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    const auto count = std::min(datagrams.size(), udp_batch_limit);
+    scratch.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& datagram = datagrams[i];
+        scratch.buffers[i] = ::iovec{
+            .iov_base = const_cast<std::byte *>(datagram.payload.data()),
+            .iov_len = datagram.payload.size()};
+        auto& header = scratch.headers[i];
+        header = ::mmsghdr{};
+        header.msg_hdr.msg_name = const_cast<::sockaddr *>(datagram.to.data());
+        header.msg_hdr.msg_namelen = datagram.to.length;
+        header.msg_hdr.msg_iov = &scratch.buffers[i];
+        header.msg_hdr.msg_iovlen = 1;
+    }
+
+    while (true) {
+        const int sent = ::sendmmsg(fd_.get(), scratch.headers.data(),
+                                    static_cast<unsigned int>(count), MSG_NOSIGNAL);
+        if (sent >= 0) {
+            return static_cast<std::size_t>(sent);
+        }
+        if (errno != EINTR) {
+            return err<std::size_t>(error::from_errno());
+        }
+    }
+}
+
 result<std::uint16_t> udp_socket::local_port() const noexcept {
     if (!valid()) {
         return err<std::uint16_t>(make_error_from_errno(EBADF));
     }
 
-    sockaddr_in addr{};
-    auto addr_len = static_cast<socklen_t>(sizeof(addr));
-    if (::getsockname(fd_.get(), reinterpret_cast<sockaddr *>(&addr),
-                      &addr_len) != 0) {
-        return err<std::uint16_t>(error::from_errno());
+    const auto address = detail::local_address(fd_.get());
+    if (!address.has_value()) {
+        return err<std::uint16_t>(address.error());
     }
-    return ntohs(addr.sin_port);
+    return address.value().port();
 }
 
 int udp_socket::native_handle() const noexcept {
@@ -4,6 +4,20 @@
 #include <unistd.h>
 #include <utility>
 
+namespace {
+
+thread_local constinit simplenet::detail::close_listener *close_listeners =
+    nullptr;
+
+void notify_close(int fd) noexcept {
+    for (auto *listener = close_listeners; listener != nullptr;
+         listener = listener->next) {
+        listener->on_close(*listener, fd);
+    }
+}
+
+} // namespace
+
 namespace simplenet {
 
 unique_fd::unique_fd(int fd) noexcept : fd_(fd) {}
@@ -44,6 +58,7 @@ void unique_fd::reset(int fd) noexcept {
         return;
     }
     if (valid()) {
+        notify_close(fd_);
         (void)::close(fd_);
     }
     fd_ = fd;
@@ -58,6 +73,7 @@ result<void> close_fd(int fd) noexcept {
         return err<void>(make_error_from_errno(EBADF));
     }
 
+    notify_close(fd);
     if (::close(fd) == 0) {
         return ok();
     }
@@ -65,4 +81,24 @@ result<void> close_fd(int fd) noexcept {
     return err<void>(error::from_errno());
 }
 
+namespace detail {
+
+void add_close_listener(close_listener& listener) noexcept {
+    listener.next = close_listeners;
+    close_listeners = &listener;
+}
+
+void remove_close_listener(close_listener& listener) noexcept {
+    for (auto **link = &close_listeners; *link != nullptr;
+         link = &(*link)->next) {
+        if (*link == &listener) {
+            *link = listener.next;
+            listener.next = nullptr;
+            return;
+        }
+    }
+}
+
+} // namespace detail
+
 } // namespace simplenet
@@ -4,6 +4,7 @@
 #include <cerrno>
 #include <limits>
 #include <sys/epoll.h>
+#include <sys/ioctl.h>
 #include <vector>
 
 namespace simplenet::epoll {
@@ -12,6 +13,20 @@ namespace {
 
 constexpr std::size_t kMaxCachedEventBatch = 1024;
 
+/// `struct epoll_params` from `<linux/eventpoll.h>` (Linux 6.9+).
+struct epoll_params {
+    std::uint32_t busy_poll_usecs;
+    std::uint16_t busy_poll_budget;
+    std::uint8_t prefer_busy_poll;
+    std::uint8_t pad;
+};
+
+#ifdef EPOLL_IOC_SET_BUSY_POLL
+constexpr unsigned long kSetBusyPoll = EPOLL_IOC_SET_BUSY_POLL;
+#else
+constexpr unsigned long kSetBusyPoll = _IOW(0x8A, 0x01, epoll_params);
+#endif
+
 } // namespace
 
 reactor::reactor(simplenet::unique_fd epoll_fd) noexcept
@@ -38,8 +53,44 @@ result<void> reactor::remove(int fd) noexcept {
     return ctl(EPOLL_CTL_DEL, fd, 0, false);
 }
 
+result<void> reactor::set_busy_poll(std::chrono::microseconds usecs,
+                                    std::uint16_t budget,
+                                    bool prefer) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (usecs.count() < 0 ||
+        usecs.count() > std::numeric_limits<std::int32_t>::max()) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    epoll_params params{};
+    params.busy_poll_usecs = static_cast<std::uint32_t>(usecs.count());
+    params.busy_poll_budget = budget;
+    params.prefer_busy_poll = prefer ? 1 : 0;
+    if (::ioctl(epoll_fd_.get(), kSetBusyPoll, &params) != 0) {
+        return err<void>(error::from_errno());
+    }
+    return ok();
+}
+
 result<std::size_t> reactor::wait(std::span<ready_event> events,
                                   std::chrono::milliseconds timeout) noexcept {
+    if (events.size() > kMaxCachedEventBatch) {
+        std::vector<::epoll_event> uncached_events(events.size());
+        return wait_into(events, uncached_events, timeout);
+    }
+
+    thread_local std::vector<::epoll_event> cached_events{};
+    if (cached_events.size() < events.size()) {
+        cached_events.resize(events.size());
+    }
+    return wait_into(events, std::span{cached_events}.first(events.size()),
+                     timeout);
+}
+
+result<std::size_t> reactor::wait(std::span<::epoll_event> events,
+                                  std::chrono::milliseconds timeout) noexcept {
     if (!valid()) {
         return err<std::size_t>(make_error_from_errno(EBADF));
     }
@@ -47,20 +98,6 @@ result<std::size_t> reactor::wait(std::span<ready_event> events,
         return err<std::size_t>(make_error_from_errno(EINVAL));
     }
 
-    ::epoll_event *sys_events_ptr = nullptr;
-    std::vector<::epoll_event> uncached_events{};
-
-    if (events.size() <= kMaxCachedEventBatch) {
-        thread_local std::vector<::epoll_event> cached_events{};
-        if (cached_events.size() < events.size()) {
-            cached_events.resize(events.size());
-        }
-        sys_events_ptr = cached_events.data();
-    } else {
-        uncached_events.resize(events.size());
-        sys_events_ptr = uncached_events.data();
-    }
-
     int timeout_ms = -1;
     if (timeout.count() >= 0) {
         const auto clamped = std::min<long long>(
@@ -69,22 +106,33 @@ result<std::size_t> reactor::wait(std::span<ready_event> events,
         timeout_ms = static_cast<int>(clamped);
     }
 
-    const int ready_count =
-        ::epoll_wait(epoll_fd_.get(), sys_events_ptr,
-                     static_cast<int>(events.size()), timeout_ms);
+    const auto capacity = std::min<std::size_t>(
+        events.size(), static_cast<std::size_t>(std::numeric_limits<int>::max()));
+    const int ready_count = ::epoll_wait(epoll_fd_.get(), events.data(),
+                                         static_cast<int>(capacity), timeout_ms);
     if (ready_count < 0) {
         if (errno == EINTR) {
             return static_cast<std::size_t>(0);
         }
         return err<std::size_t>(error::from_errno());
     }
+    return static_cast<std::size_t>(ready_count);
+}
+
+result<std::size_t>
+reactor::wait_into(std::span<ready_event> events,
+                   std::span<::epoll_event> scratch,
+                   std::chrono::milliseconds timeout) noexcept {
+    const auto wait_result = wait(scratch, timeout);
+    if (!wait_result.has_value()) {
+        return wait_result;
+    }
 
-    for (int i = 0; i < ready_count; ++i) {
-        events[static_cast<std::size_t>(i)] = ready_event{
-            .fd = sys_events_ptr[static_cast<std::size_t>(i)].data.fd,
-            .events = sys_events_ptr[static_cast<std::size_t>(i)].events};
+    for (std::size_t i = 0; i < wait_result.value(); ++i) {
+        events[i] =
+            ready_event{.fd = scratch[i].data.fd, .events = scratch[i].events};
     }
-    return static_cast<std::size_t>(ready_count);
+    return wait_result;
 }
 
 int reactor::native_handle() const noexcept {
@@ -0,0 +1,268 @@
+#include "simplenet/nonblocking/local.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <sys/un.h>
+
+namespace {
+
+struct local_address {
+    ::sockaddr_un storage{};
+    socklen_t length{0};
+};
+
+int socket_type(simplenet::nonblocking::local_kind kind) noexcept {
+    return kind == simplenet::nonblocking::local_kind::seqpacket ? SOCK_SEQPACKET
+                                                                 : SOCK_STREAM;
+}
+
+/// `@name` maps to the abstract namespace; anything else is a path.
+simplenet::result<local_address> make_address(std::string_view path) noexcept {
+    if (path.empty()) {
+        return simplenet::err<local_address>(
+            simplenet::make_error_from_errno(EINVAL));
+    }
+
+    local_address address{};
+    address.storage.sun_family = AF_UNIX;
+    const bool abstract = path.front() == '@';
+    // Paths keep a terminating NUL; abstract names are sized exactly.
+    const std::size_t room =
+        sizeof(address.storage.sun_path) - (abstract ? 0U : 1U);
+    if (path.size() > room) {
+        return simplenet::err<local_address>(
+            simplenet::make_error_from_errno(ENAMETOOLONG));
+    }
+
+    std::memcpy(address.storage.sun_path, path.data(), path.size());
+    if (abstract) {
+        address.storage.sun_path[0] = '\0';
+    }
+    address.length = static_cast<socklen_t>(
+        offsetof(::sockaddr_un, sun_path) + path.size() + (abstract ? 0U : 1U));
+    return address;
+}
+
+simplenet::result<simplenet::unique_fd>
+open_local_socket(simplenet::nonblocking::local_kind kind) noexcept {
+    const int fd =
+        ::socket(AF_UNIX, socket_type(kind) | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return simplenet::err<simplenet::unique_fd>(simplenet::error::from_errno());
+    }
+    return simplenet::unique_fd{fd};
+}
+
+/// Ancillary buffer big enough for `max_passed_fds` descriptors.
+union fd_control {
+    ::cmsghdr header;
+    std::array<std::byte, CMSG_SPACE(sizeof(int) *
+                                     simplenet::nonblocking::max_passed_fds)>
+        bytes;
+};
+
+} // namespace
+
+namespace simplenet::nonblocking {
+
+local_stream::local_stream(simplenet::unique_fd fd) noexcept
+    : socket_(std::move(fd)) {}
+
+result<local_stream> local_stream::connect(std::string_view path,
+                                           local_kind kind) noexcept {
+    const auto address = make_address(path);
+    if (!address.has_value()) {
+        return err<local_stream>(address.error());
+    }
+    auto owned_fd = open_local_socket(kind);
+    if (!owned_fd.has_value()) {
+        return err<local_stream>(owned_fd.error());
+    }
+
+    if (::connect(owned_fd.value().get(),
+                  reinterpret_cast<const sockaddr *>(&address.value().storage),
+                  address.value().length) != 0) {
+        return err<local_stream>(error::from_errno());
+    }
+    return local_stream{std::move(owned_fd.value())};
+}
+
+result<std::pair<local_stream, local_stream>>
+local_stream::pair(local_kind kind) noexcept {
+    std::array<int, 2> fds{};
+    if (::socketpair(AF_UNIX, socket_type(kind) | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                     0, fds.data()) != 0) {
+        return err<std::pair<local_stream, local_stream>>(error::from_errno());
+    }
+    return std::pair{local_stream{simplenet::unique_fd{fds[0]}},
+                     local_stream{simplenet::unique_fd{fds[1]}}};
+}
+
+result<std::size_t> local_stream::read_some(std::span<std::byte> buffer) noexcept {
+    return socket_.read_some(buffer);
+}
+
+result<std::size_t>
+local_stream::write_some(std::span<const std::byte> buffer) noexcept {
+    return socket_.write_some(buffer);
+}
+
+result<std::size_t>
+local_stream::read_some(std::span<const ::iovec> buffers) noexcept {
+    return socket_.read_some(buffers);
+}
+
+result<std::size_t>
+local_stream::write_some(std::span<const ::iovec> buffers) noexcept {
+    return socket_.write_some(buffers);
+}
+
+result<void> local_stream::check_readable() noexcept {
+    return socket_.check_readable();
+}
+
+result<std::size_t> local_stream::send_fds(std::span<const std::byte> bytes,
+                                           std::span<const int> fds) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (bytes.empty() || fds.size() > max_passed_fds) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    ::iovec payload{const_cast<std::byte *>(bytes.data()), bytes.size()};
+    ::msghdr message{};
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+
+    fd_control control{};
+    if (!fds.empty()) {
+        const std::size_t fd_bytes = fds.size_bytes();
+        message.msg_control = control.bytes.data();
+        message.msg_controllen = CMSG_SPACE(fd_bytes);
+        auto *header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(fd_bytes);
+        std::memcpy(CMSG_DATA(header), fds.data(), fd_bytes);
+    }
+
+    const ssize_t count = ::sendmsg(native_handle(), &message, MSG_NOSIGNAL);
+    if (count < 0) {
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(count);
+}
+
+result<fd_message>
+local_stream::receive_fds(std::span<std::byte> buffer,
+                          std::span<simplenet::unique_fd> fds) noexcept {
+    if (!valid()) {
+        return err<fd_message>(make_error_from_errno(EBADF));
+    }
+
+    ::iovec payload{buffer.data(), buffer.size()};
+    ::msghdr message{};
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1;
+
+    // Room for exactly the slots offered, so the kernel closes the rest.
+    fd_control control{};
+    const std::size_t slots = std::min(fds.size(), max_passed_fds);
+    if (slots > 0U) {
+        message.msg_control = control.bytes.data();
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * slots);
+    }
+
+    const ssize_t count = ::recvmsg(native_handle(), &message, MSG_CMSG_CLOEXEC);
+    if (count < 0) {
+        return err<fd_message>(error::from_errno());
+    }
+
+    fd_message received{};
+    received.size = static_cast<std::size_t>(count);
+    received.truncated = (message.msg_flags & MSG_CTRUNC) != 0;
+    for (auto *header = CMSG_FIRSTHDR(&message); header != nullptr;
+         header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        const std::size_t count_in_header =
+            (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (std::size_t index = 0; index < count_in_header; ++index) {
+            int fd = -1;
+            std::memcpy(&fd, CMSG_DATA(header) + index * sizeof(int), sizeof(int));
+            if (received.fds < slots) {
+                fds[received.fds++].reset(fd);
+            } else {
+                (void)close_fd(fd);
+                received.truncated = true;
+            }
+        }
+    }
+    return received;
+}
+
+result<void> local_stream::shutdown_write() noexcept {
+    return socket_.shutdown_write();
+}
+
+int local_stream::native_handle() const noexcept {
+    return socket_.native_handle();
+}
+
+bool local_stream::valid() const noexcept {
+    return socket_.valid();
+}
+
+local_listener::local_listener(simplenet::unique_fd fd) noexcept
+    : fd_(std::move(fd)) {}
+
+result<local_listener> local_listener::bind(std::string_view path,
+                                            local_kind kind,
+                                            int backlog) noexcept {
+    const auto address = make_address(path);
+    if (!address.has_value()) {
+        return err<local_listener>(address.error());
+    }
+    auto owned_fd = open_local_socket(kind);
+    if (!owned_fd.has_value()) {
+        return err<local_listener>(owned_fd.error());
+    }
+
+    if (::bind(owned_fd.value().get(),
+               reinterpret_cast<const sockaddr *>(&address.value().storage),
+               address.value().length) != 0) {
+        return err<local_listener>(error::from_errno());
+    }
+    if (::listen(owned_fd.value().get(), backlog) != 0) {
+        return err<local_listener>(error::from_errno());
+    }
+    return local_listener{std::move(owned_fd.value())};
+}
+
+result<local_stream> local_listener::accept() noexcept {
+    if (!valid()) {
+        return err<local_stream>(make_error_from_errno(EBADF));
+    }
+
+    const int accepted =
+        ::accept4(fd_.get(), nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (accepted < 0) {
+        return err<local_stream>(error::from_errno());
+    }
+    return local_stream{simplenet::unique_fd{accepted}};
+}
+
+int local_listener::native_handle() const noexcept {
+    return fd_.get();
+}
+
+bool local_listener::valid() const noexcept {
+    return fd_.valid();
+}
+
+} // namespace simplenet::nonblocking
@@ -1,43 +1,166 @@
 #include "simplenet/nonblocking/tcp.hpp"
 
-#include <arpa/inet.h>
+#include <algorithm>
 #include <cerrno>
+#include <array>
+#include <climits>
+#include <cstring>
+#include <limits>
 #include <fcntl.h>
+#include <linux/errqueue.h>
+#include <linux/filter.h>
+#include <linux/tls.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/sendfile.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 namespace {
 
-simplenet::result<sockaddr_in>
-to_sockaddr(const simplenet::nonblocking::endpoint& ep) noexcept {
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = ::htons(ep.port);
-
-    const int parsed = ::inet_pton(AF_INET, ep.host.c_str(), &addr.sin_addr);
-    if (parsed == 1) {
-        return addr;
+simplenet::result<void> set_reuse_addr(int fd) noexcept {
+    int enabled = 1;
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled)) ==
+        0) {
+        return simplenet::ok();
     }
-    return simplenet::err<sockaddr_in>(simplenet::make_error_from_errno(EINVAL));
+    return simplenet::err<void>(simplenet::error::from_errno());
 }
 
-simplenet::result<void> set_reuse_addr(int fd) noexcept {
+simplenet::result<void> set_reuse_port(int fd) noexcept {
     int enabled = 1;
-    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled)) ==
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled)) ==
         0) {
         return simplenet::ok();
     }
     return simplenet::err<void>(simplenet::error::from_errno());
 }
 
-simplenet::result<int> make_stream_socket_nonblocking() noexcept {
-    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+simplenet::result<void> set_int_option(int fd, int level, int name,
+                                       int value) noexcept {
+    if (::setsockopt(fd, level, name, &value, sizeof(value)) == 0) {
+        return simplenet::ok();
+    }
+    return simplenet::err<void>(simplenet::error::from_errno());
+}
+
+simplenet::result<void>
+apply_socket_options(int fd,
+                     const simplenet::nonblocking::socket_options& options) noexcept {
+    if (options.receive_buffer < 0 || options.send_buffer < 0 ||
+        options.incoming_cpu < -1 || options.notsent_lowat > INT_MAX) {
+        return simplenet::err<void>(simplenet::make_error_from_errno(EINVAL));
+    }
+
+    struct pending_option {
+        bool wanted;
+        int level;
+        int name;
+        int value;
+    };
+    const std::array<pending_option, 7> pending{{
+        {options.no_delay, IPPROTO_TCP, TCP_NODELAY, 1},
+        {options.quick_ack, IPPROTO_TCP, TCP_QUICKACK, 1},
+        {options.fast_open_connect, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1},
+        {options.receive_buffer > 0, SOL_SOCKET, SO_RCVBUF,
+         options.receive_buffer},
+        {options.send_buffer > 0, SOL_SOCKET, SO_SNDBUF, options.send_buffer},
+        {options.incoming_cpu >= 0, SOL_SOCKET, SO_INCOMING_CPU,
+         options.incoming_cpu},
+        {options.notsent_lowat > 0, IPPROTO_TCP, TCP_NOTSENT_LOWAT,
+         static_cast<int>(options.notsent_lowat)},
+    }};
+    for (const auto& option : pending) {
+        if (!option.wanted) {
+            continue;
+        }
+        const auto status =
+            set_int_option(fd, option.level, option.name, option.value);
+        if (!status.has_value()) {
+            return status;
+        }
+    }
+    return simplenet::ok();
+}
+
+/// @return `true` when the key, IV, salt and version fit the cipher.
+bool tls_keys_match(const simplenet::nonblocking::tls_key_material& keys) noexcept {
+    using simplenet::nonblocking::tls_cipher;
+    if (keys.version != TLS_1_2_VERSION && keys.version != TLS_1_3_VERSION) {
+        return false;
+    }
+    const auto sizes_are = [&](std::size_t key, std::size_t iv, std::size_t salt) {
+        return keys.key.size() == key && keys.iv.size() == iv &&
+               keys.salt.size() == salt;
+    };
+    switch (keys.cipher) {
+    case tls_cipher::aes_gcm_128:
+        return sizes_are(TLS_CIPHER_AES_GCM_128_KEY_SIZE,
+                         TLS_CIPHER_AES_GCM_128_IV_SIZE,
+                         TLS_CIPHER_AES_GCM_128_SALT_SIZE);
+    case tls_cipher::aes_gcm_256:
+        return sizes_are(TLS_CIPHER_AES_GCM_256_KEY_SIZE,
+                         TLS_CIPHER_AES_GCM_256_IV_SIZE,
+                         TLS_CIPHER_AES_GCM_256_SALT_SIZE);
+    case tls_cipher::chacha20_poly1305:
+        return sizes_are(TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE,
+                         TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE,
+                         TLS_CIPHER_CHACHA20_POLY1305_SALT_SIZE);
+    }
+    return false;
+}
+
+/// Copy `keys` (already checked by `tls_keys_match`) into `TLS_TX`/`TLS_RX`.
+template <class Info>
+simplenet::result<void>
+install_tls_info(int fd, int direction, int cipher_type,
+                 const simplenet::nonblocking::tls_key_material& keys) noexcept {
+    Info info{};
+    info.info.version = keys.version;
+    info.info.cipher_type = static_cast<std::uint16_t>(cipher_type);
+    std::memcpy(info.key, keys.key.data(), keys.key.size());
+    std::memcpy(info.iv, keys.iv.data(), keys.iv.size());
+    std::memcpy(info.salt, keys.salt.data(), keys.salt.size());
+    // The kernel takes the sequence number in network byte order.
+    for (std::size_t index = 0; index < sizeof(info.rec_seq); ++index) {
+        info.rec_seq[index] = static_cast<unsigned char>(
+            keys.record_sequence >> (8U * (sizeof(info.rec_seq) - 1U - index)));
+    }
+
+    const int status = ::setsockopt(fd, SOL_TLS, direction, &info, sizeof(info));
+    const int saved_errno = errno;
+    ::explicit_bzero(&info, sizeof(info));
+    if (status != 0) {
+        return simplenet::err<void>(simplenet::make_error_from_errno(saved_errno));
+    }
+    return simplenet::ok();
+}
+
+simplenet::result<void>
+install_tls_keys(int fd, int direction,
+                 const simplenet::nonblocking::tls_key_material& keys) noexcept {
+    using simplenet::nonblocking::tls_cipher;
+    switch (keys.cipher) {
+    case tls_cipher::aes_gcm_128:
+        return install_tls_info<::tls12_crypto_info_aes_gcm_128>(
+            fd, direction, TLS_CIPHER_AES_GCM_128, keys);
+    case tls_cipher::aes_gcm_256:
+        return install_tls_info<::tls12_crypto_info_aes_gcm_256>(
+            fd, direction, TLS_CIPHER_AES_GCM_256, keys);
+    case tls_cipher::chacha20_poly1305:
+        return install_tls_info<::tls12_crypto_info_chacha20_poly1305>(
+            fd, direction, TLS_CIPHER_CHACHA20_POLY1305, keys);
+    }
+    return simplenet::err<void>(simplenet::make_error_from_errno(EINVAL));
+}
+
+simplenet::result<int> make_stream_socket_nonblocking(int family) noexcept {
+    int fd = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
     if (fd >= 0) {
         return fd;
     }
 
-    fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    fd = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (fd < 0) {
         return simplenet::err<int>(simplenet::error::from_errno());
     }
@@ -58,20 +181,26 @@ namespace simplenet::nonblocking {
 tcp_stream::tcp_stream(simplenet::unique_fd fd) noexcept : fd_(std::move(fd)) {}
 
 result<tcp_stream> tcp_stream::connect(const endpoint& remote) noexcept {
-    const auto maybe_addr = to_sockaddr(remote);
-    if (!maybe_addr.has_value()) {
-        return err<tcp_stream>(maybe_addr.error());
+    const auto address = socket_address::from_endpoint(remote);
+    if (!address.has_value()) {
+        return err<tcp_stream>(address.error());
     }
+    return connect(address.value());
+}
 
-    const auto maybe_fd = make_stream_socket_nonblocking();
+result<tcp_stream> tcp_stream::connect(const socket_address& remote,
+                                       const socket_options& options) noexcept {
+    const auto maybe_fd = make_stream_socket_nonblocking(remote.family());
     if (!maybe_fd.has_value()) {
         return err<tcp_stream>(maybe_fd.error());
     }
 
     unique_fd owned_fd{maybe_fd.value()};
-    auto addr = maybe_addr.value();
-    if (::connect(owned_fd.get(), reinterpret_cast<const sockaddr *>(&addr),
-                  sizeof(addr)) == 0) {
+    const auto option_status = apply_socket_options(owned_fd.get(), options);
+    if (!option_status.has_value()) {
+        return err<tcp_stream>(option_status.error());
+    }
+    if (::connect(owned_fd.get(), remote.data(), remote.length) == 0) {
         return tcp_stream{std::move(owned_fd)};
     }
 
@@ -81,6 +210,21 @@ result<tcp_stream> tcp_stream::connect(const endpoint& remote) noexcept {
     return err<tcp_stream>(error::from_errno());
 }
 
+result<tcp_stream> tcp_stream::open(int family,
+                                    const socket_options& options) noexcept {
+    const auto maybe_fd = make_stream_socket_nonblocking(family);
+    if (!maybe_fd.has_value()) {
+        return err<tcp_stream>(maybe_fd.error());
+    }
+
+    unique_fd owned_fd{maybe_fd.value()};
+    const auto option_status = apply_socket_options(owned_fd.get(), options);
+    if (!option_status.has_value()) {
+        return err<tcp_stream>(option_status.error());
+    }
+    return tcp_stream{std::move(owned_fd)};
+}
+
 result<void> tcp_stream::finish_connect() noexcept {
     if (!valid()) {
         return err<void>(make_error_from_errno(EBADF));
@@ -114,6 +258,18 @@ tcp_stream::read_some(std::span<std::byte> buffer) noexcept {
     return static_cast<std::size_t>(count);
 }
 
+result<void> tcp_stream::check_readable() noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+
+    std::byte probe{};
+    if (::recv(fd_.get(), &probe, 1, MSG_PEEK) < 0) {
+        return err<void>(error::from_errno());
+    }
+    return ok();
+}
+
 result<std::size_t>
 tcp_stream::write_some(std::span<const std::byte> buffer) noexcept {
     if (!valid()) {
@@ -125,6 +281,262 @@ tcp_stream::write_some(std::span<const std::byte> buffer) noexcept {
 
     const ssize_t count =
         ::send(fd_.get(), buffer.data(), buffer.size(), MSG_NOSIGNAL);
+    if (count < 0) {
+        // A deferred fast-open connect sent a bare SYN; wait for the
+        // handshake like any full socket.
+        if (errno == EINPROGRESS) {
+            return err<std::size_t>(make_error_from_errno(EAGAIN));
+        }
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(count);
+}
+
+result<std::size_t>
+tcp_stream::read_some(std::span<const ::iovec> buffers) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (buffers.empty()) {
+        return static_cast<std::size_t>(0);
+    }
+
+    ::msghdr message{};
+    message.msg_iov = const_cast<::iovec *>(buffers.data());
+    message.msg_iovlen = std::min<std::size_t>(buffers.size(), IOV_MAX);
+    const ssize_t count = ::recvmsg(fd_.get(), &message, 0);
+    if (count < 0) {
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(count);
+}
+
+result<std::size_t>
+tcp_stream::write_some(std::span<const ::iovec> buffers) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (buffers.empty()) {
+        return static_cast<std::size_t>(0);
+    }
+
+    ::msghdr message{};
+    message.msg_iov = const_cast<::iovec *>(buffers.data());
+    message.msg_iovlen = std::min<std::size_t>(buffers.size(), IOV_MAX);
+    const ssize_t count = ::sendmsg(fd_.get(), &message, MSG_NOSIGNAL);
+    if (count < 0) {
+        if (errno == EINPROGRESS) {
+            return err<std::size_t>(make_error_from_errno(EAGAIN));
+        }
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(count);
+}
+
+result<std::size_t> tcp_stream::send_file(int file_fd, std::uint64_t offset,
+                                          std::size_t count) noexcept {
+    if (!valid() || file_fd < 0) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (offset > static_cast<std::uint64_t>(INT64_MAX)) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+    if (count == 0U) {
+        return static_cast<std::size_t>(0);
+    }
+
+    auto position = static_cast<off_t>(offset);
+    const ssize_t count_sent = ::sendfile(fd_.get(), file_fd, &position, count);
+    if (count_sent < 0) {
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(count_sent);
+}
+
+result<void> tcp_stream::enable_zerocopy() noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    int enabled = 1;
+    if (::setsockopt(fd_.get(), SOL_SOCKET, SO_ZEROCOPY, &enabled,
+                     sizeof(enabled)) != 0) {
+        return err<void>(error::from_errno());
+    }
+    zerocopy_enabled_ = true;
+    return ok();
+}
+
+result<std::size_t>
+tcp_stream::write_some_zerocopy(std::span<const ::iovec> buffers) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (!zerocopy_enabled_) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+    if (buffers.empty()) {
+        return static_cast<std::size_t>(0);
+    }
+
+    ::msghdr message{};
+    message.msg_iov = const_cast<::iovec *>(buffers.data());
+    message.msg_iovlen = std::min<std::size_t>(buffers.size(), IOV_MAX);
+    const ssize_t count =
+        ::sendmsg(fd_.get(), &message, MSG_NOSIGNAL | MSG_ZEROCOPY);
+    if (count < 0) {
+        if (errno == EINPROGRESS) {
+            return err<std::size_t>(make_error_from_errno(EAGAIN));
+        }
+        return err<std::size_t>(error::from_errno());
+    }
+    if (count > 0) {
+        ++next_zerocopy_id_;
+    }
+    return static_cast<std::size_t>(count);
+}
+
+result<zerocopy_notification> tcp_stream::reap_zerocopy() noexcept {
+    if (!valid()) {
+        return err<zerocopy_notification>(make_error_from_errno(EBADF));
+    }
+
+    while (true) {
+        alignas(::cmsghdr) std::array<char, 128> control{};
+        ::msghdr message{};
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+        if (::recvmsg(fd_.get(), &message, MSG_ERRQUEUE) < 0) {
+            return err<zerocopy_notification>(error::from_errno());
+        }
+
+        for (auto *header = CMSG_FIRSTHDR(&message); header != nullptr;
+             header = CMSG_NXTHDR(&message, header)) {
+            const bool recverr =
+                (header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) ||
+                (header->cmsg_level == SOL_IPV6 &&
+                 header->cmsg_type == IPV6_RECVERR);
+            if (!recverr) {
+                continue;
+            }
+            ::sock_extended_err extended{};
+            std::memcpy(&extended, CMSG_DATA(header), sizeof(extended));
+            if (extended.ee_origin != SO_EE_ORIGIN_ZEROCOPY ||
+                extended.ee_errno != 0) {
+                continue;
+            }
+            return zerocopy_notification{
+                .first = extended.ee_info,
+                .last = extended.ee_data,
+                .copied = (extended.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0};
+        }
+        // Some other error-queue message; keep looking.
+    }
+}
+
+result<void> tcp_stream::attach_tls() noexcept {
+    if (ktls_tx_ || ktls_rx_) {
+        return ok();
+    }
+    static constexpr char ulp[] = "tls";
+    if (::setsockopt(fd_.get(), SOL_TCP, TCP_ULP, ulp, sizeof(ulp)) == 0 ||
+        errno == EEXIST) {
+        return ok();
+    }
+    return err<void>(error::from_errno());
+}
+
+result<void> tcp_stream::enable_ktls_tx(const tls_key_material& keys) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (!tls_keys_match(keys)) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+    if (auto attached = attach_tls(); !attached.has_value()) {
+        return attached;
+    }
+    if (auto installed = install_tls_keys(fd_.get(), TLS_TX, keys);
+        !installed.has_value()) {
+        return installed;
+    }
+    ktls_tx_ = true;
+    return ok();
+}
+
+result<void> tcp_stream::enable_ktls_rx(const tls_key_material& keys) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (!tls_keys_match(keys)) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+    if (auto attached = attach_tls(); !attached.has_value()) {
+        return attached;
+    }
+    if (auto installed = install_tls_keys(fd_.get(), TLS_RX, keys);
+        !installed.has_value()) {
+        return installed;
+    }
+    ktls_rx_ = true;
+    return ok();
+}
+
+result<tls_record> tcp_stream::read_tls_record(std::span<std::byte> buffer) noexcept {
+    if (!valid()) {
+        return err<tls_record>(make_error_from_errno(EBADF));
+    }
+    if (!ktls_rx_) {
+        return err<tls_record>(make_error_from_errno(EINVAL));
+    }
+
+    ::iovec vector{.iov_base = buffer.data(), .iov_len = buffer.size()};
+    alignas(::cmsghdr) std::array<char, CMSG_SPACE(sizeof(std::uint8_t))> control{};
+    ::msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    const ssize_t count = ::recvmsg(fd_.get(), &message, 0);
+    if (count < 0) {
+        return err<tls_record>(error::from_errno());
+    }
+
+    tls_record record{.size = static_cast<std::size_t>(count)};
+    for (auto *header = CMSG_FIRSTHDR(&message); header != nullptr;
+         header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_TLS &&
+            header->cmsg_type == TLS_GET_RECORD_TYPE) {
+            std::memcpy(&record.type, CMSG_DATA(header), sizeof(record.type));
+        }
+    }
+    return record;
+}
+
+result<std::size_t>
+tcp_stream::write_tls_record(std::uint8_t type,
+                             std::span<const std::byte> bytes) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (!ktls_tx_) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    ::iovec vector{.iov_base = const_cast<std::byte *>(bytes.data()),
+                   .iov_len = bytes.size()};
+    alignas(::cmsghdr) std::array<char, CMSG_SPACE(sizeof(type))> control{};
+    ::msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    auto *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_TLS;
+    header->cmsg_type = TLS_SET_RECORD_TYPE;
+    header->cmsg_len = CMSG_LEN(sizeof(type));
+    std::memcpy(CMSG_DATA(header), &type, sizeof(type));
+
+    const ssize_t count = ::sendmsg(fd_.get(), &message, MSG_NOSIGNAL);
     if (count < 0) {
         return err<std::size_t>(error::from_errno());
     }
@@ -156,6 +568,56 @@ result<void> tcp_stream::set_send_buffer_size(int bytes) noexcept {
     return err<void>(error::from_errno());
 }
 
+result<void> tcp_stream::set_options(const socket_options& options) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    return apply_socket_options(fd_.get(), options);
+}
+
+result<void> tcp_stream::set_busy_poll(std::chrono::microseconds usecs) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (usecs.count() < 0 || usecs.count() > INT_MAX) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    const int value = static_cast<int>(usecs.count());
+    if (::setsockopt(fd_.get(), SOL_SOCKET, SO_BUSY_POLL, &value,
+                     sizeof(value)) == 0) {
+        return ok();
+    }
+    return err<void>(error::from_errno());
+}
+
+result<void>
+tcp_stream::set_max_pacing_rate(std::uint64_t bytes_per_second) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+
+    // All ones is the kernel's "unlimited"; kernels before 5.0 take only
+    // a 32-bit value.
+    const std::uint64_t rate = bytes_per_second == 0U
+                                   ? std::numeric_limits<std::uint64_t>::max()
+                                   : bytes_per_second;
+    if (::setsockopt(fd_.get(), SOL_SOCKET, SO_MAX_PACING_RATE, &rate,
+                     sizeof(rate)) == 0) {
+        return ok();
+    }
+    if (errno != EINVAL) {
+        return err<void>(error::from_errno());
+    }
+    const auto narrow = static_cast<std::uint32_t>(
+        std::min<std::uint64_t>(rate, std::numeric_limits<std::uint32_t>::max()));
+    if (::setsockopt(fd_.get(), SOL_SOCKET, SO_MAX_PACING_RATE, &narrow,
+                     sizeof(narrow)) == 0) {
+        return ok();
+    }
+    return err<void>(error::from_errno());
+}
+
 int tcp_stream::native_handle() const noexcept {
     return fd_.get();
 }
@@ -168,12 +630,21 @@ tcp_listener::tcp_listener(simplenet::unique_fd fd) noexcept : fd_(std::move(fd)
 
 result<tcp_listener> tcp_listener::bind(const endpoint& local,
                                         int backlog) noexcept {
-    const auto maybe_addr = to_sockaddr(local);
-    if (!maybe_addr.has_value()) {
-        return err<tcp_listener>(maybe_addr.error());
+    return bind(local, listen_options{.backlog = backlog});
+}
+
+result<tcp_listener> tcp_listener::bind(const endpoint& local,
+                                        const listen_options& options) noexcept {
+    const auto address = socket_address::from_endpoint(local);
+    if (!address.has_value()) {
+        return err<tcp_listener>(address.error());
     }
+    return bind(address.value(), options);
+}
 
-    const auto maybe_fd = make_stream_socket_nonblocking();
+result<tcp_listener> tcp_listener::bind(const socket_address& local,
+                                        const listen_options& options) noexcept {
+    const auto maybe_fd = make_stream_socket_nonblocking(local.family());
     if (!maybe_fd.has_value()) {
         return err<tcp_listener>(maybe_fd.error());
     }
@@ -183,13 +654,50 @@ result<tcp_listener> tcp_listener::bind(const endpoint& local,
     if (!reuse_status.has_value()) {
         return err<tcp_listener>(reuse_status.error());
     }
-
-    auto addr = maybe_addr.value();
-    if (::bind(owned_fd.get(), reinterpret_cast<const sockaddr *>(&addr),
-               sizeof(addr)) != 0) {
+    if (options.reuse_port) {
+        const auto port_status = set_reuse_port(owned_fd.get());
+        if (!port_status.has_value()) {
+            return err<tcp_listener>(port_status.error());
+        }
+    }
+    if (local.family() == AF_INET6) {
+        const int v6_only = options.v6_only ? 1 : 0;
+        if (::setsockopt(owned_fd.get(), IPPROTO_IPV6, IPV6_V6ONLY, &v6_only,
+                         sizeof(v6_only)) != 0) {
+            return err<tcp_listener>(error::from_errno());
+        }
+    }
+
+    if (options.fast_open_queue < 0 || options.defer_accept.count() < 0 ||
+        options.defer_accept.count() > INT_MAX) {
+        return err<tcp_listener>(make_error_from_errno(EINVAL));
+    }
+    const auto option_status =
+        apply_socket_options(owned_fd.get(), options.socket);
+    if (!option_status.has_value()) {
+        return err<tcp_listener>(option_status.error());
+    }
+    if (options.defer_accept.count() > 0) {
+        const auto defer_status = set_int_option(
+            owned_fd.get(), IPPROTO_TCP, TCP_DEFER_ACCEPT,
+            static_cast<int>(options.defer_accept.count()));
+        if (!defer_status.has_value()) {
+            return err<tcp_listener>(defer_status.error());
+        }
+    }
+    if (options.fast_open_queue > 0) {
+        const auto fast_open_status =
+            set_int_option(owned_fd.get(), IPPROTO_TCP, TCP_FASTOPEN,
+                           options.fast_open_queue);
+        if (!fast_open_status.has_value()) {
+            return err<tcp_listener>(fast_open_status.error());
+        }
+    }
+
+    if (::bind(owned_fd.get(), local.data(), local.length) != 0) {
         return err<tcp_listener>(error::from_errno());
     }
-    if (::listen(owned_fd.get(), backlog) != 0) {
+    if (::listen(owned_fd.get(), options.backlog) != 0) {
         return err<tcp_listener>(error::from_errno());
     }
 
@@ -209,18 +717,89 @@ result<tcp_stream> tcp_listener::accept() noexcept {
     return tcp_stream{simplenet::unique_fd{accepted}};
 }
 
+result<tcp_stream> tcp_listener::accept(socket_address& peer) noexcept {
+    if (!valid()) {
+        return err<tcp_stream>(make_error_from_errno(EBADF));
+    }
+
+    peer.length = static_cast<socklen_t>(sizeof(peer.storage));
+    const int accepted =
+        ::accept4(fd_.get(), reinterpret_cast<sockaddr *>(&peer.storage),
+                  &peer.length, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (accepted < 0) {
+        peer.length = 0;
+        return err<tcp_stream>(error::from_errno());
+    }
+    return tcp_stream{simplenet::unique_fd{accepted}};
+}
+
+result<std::size_t>
+tcp_listener::accept_batch(std::span<tcp_stream> streams) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+
+    std::size_t count = 0;
+    while (count < streams.size()) {
+        const int accepted = ::accept4(fd_.get(), nullptr, nullptr,
+                                       SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (accepted < 0) {
+            // Report what was accepted; a lasting error shows up next call.
+            if (count > 0U) {
+                break;
+            }
+            return err<std::size_t>(error::from_errno());
+        }
+        streams[count++] = tcp_stream{simplenet::unique_fd{accepted}};
+    }
+    return count;
+}
+
 result<std::uint16_t> tcp_listener::local_port() const noexcept {
+    const auto address = local_address();
+    if (!address.has_value()) {
+        return err<std::uint16_t>(address.error());
+    }
+    return address.value().port();
+}
+
+result<socket_address> tcp_listener::local_address() const noexcept {
     if (!valid()) {
-        return err<std::uint16_t>(make_error_from_errno(EBADF));
+        return err<socket_address>(make_error_from_errno(EBADF));
     }
 
-    sockaddr_in addr{};
-    auto addr_len = static_cast<socklen_t>(sizeof(addr));
-    if (::getsockname(fd_.get(), reinterpret_cast<sockaddr *>(&addr),
-                      &addr_len) != 0) {
-        return err<std::uint16_t>(error::from_errno());
+    socket_address address{};
+    address.length = static_cast<socklen_t>(sizeof(address.storage));
+    if (::getsockname(fd_.get(), reinterpret_cast<sockaddr *>(&address.storage),
+                      &address.length) != 0) {
+        return err<socket_address>(error::from_errno());
+    }
+    return address;
+}
+
+result<void> tcp_listener::steer_by_cpu(std::uint32_t group_size) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (group_size == 0) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    // A = current CPU; A %= group_size; return A (index into the group).
+    std::array<sock_filter, 3> code{{
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0,
+         static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, group_size},
+        {BPF_RET | BPF_A, 0, 0, 0},
+    }};
+    sock_fprog program{};
+    program.len = static_cast<unsigned short>(code.size());
+    program.filter = code.data();
+    if (::setsockopt(fd_.get(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program,
+                     sizeof(program)) != 0) {
+        return err<void>(error::from_errno());
     }
-    return ntohs(addr.sin_port);
+    return ok();
 }
 
 int tcp_listener::native_handle() const noexcept {
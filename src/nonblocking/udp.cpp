@@ -0,0 +1,296 @@
+#include "simplenet/nonblocking/udp.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace {
+
+/// Per-thread `mmsghdr`/`iovec` scratch reused by every batch call.
+struct batch_scratch {
+    std::vector<::mmsghdr> headers;
+    std::vector<::iovec> buffers;
+
+    void reserve(std::size_t count) {
+        if (headers.size() < count) {
+            headers.resize(count);
+            buffers.resize(count);
+        }
+    }
+};
+
+thread_local batch_scratch scratch{};
+
+} // namespace
+
+namespace simplenet::nonblocking {
+
+udp_socket::udp_socket(simplenet::unique_fd fd) noexcept : fd_(std::move(fd)) {}
+
+result<udp_socket> udp_socket::bind(const endpoint& local) noexcept {
+    const auto address = socket_address::from_endpoint(local);
+    if (!address.has_value()) {
+        return err<udp_socket>(address.error());
+    }
+    return bind(address.value());
+}
+
+result<udp_socket> udp_socket::bind(const socket_address& local) noexcept {
+    const int fd =
+        ::socket(local.family(), SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return err<udp_socket>(error::from_errno());
+    }
+    simplenet::unique_fd owned{fd};
+
+    if (::bind(owned.get(), local.data(), local.length) != 0) {
+        return err<udp_socket>(error::from_errno());
+    }
+    return udp_socket{std::move(owned)};
+}
+
+result<std::size_t> udp_socket::send_to(std::span<const std::byte> buffer,
+                                        const socket_address& to) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+
+    const ssize_t sent = ::sendto(fd_.get(), buffer.data(), buffer.size(),
+                                  MSG_NOSIGNAL, to.data(), to.length);
+    if (sent < 0) {
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(sent);
+}
+
+result<udp_datagram> udp_socket::recv_from(std::span<std::byte> buffer) noexcept {
+    if (!valid()) {
+        return err<udp_datagram>(make_error_from_errno(EBADF));
+    }
+
+    ::iovec vector{.iov_base = buffer.data(), .iov_len = buffer.size()};
+    udp_datagram datagram{};
+    ::msghdr message{};
+    message.msg_name = &datagram.from.storage;
+    message.msg_namelen = static_cast<::socklen_t>(sizeof(datagram.from.storage));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+
+    const ssize_t received = ::recvmsg(fd_.get(), &message, 0);
+    if (received < 0) {
+        return err<udp_datagram>(error::from_errno());
+    }
+    datagram.size = static_cast<std::size_t>(received);
+    datagram.from.length = message.msg_namelen;
+    datagram.truncated = (message.msg_flags & MSG_TRUNC) != 0;
+    return datagram;
+}
+
+result<std::size_t>
+udp_socket::recv_batch(std::span<udp_message> messages) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (messages.empty()) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    const auto count = std::min(messages.size(), udp_batch_limit);
+    scratch.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& slot = messages[i];
+        scratch.buffers[i] = ::iovec{.iov_base = slot.buffer.data(),
+                                     .iov_len = slot.buffer.size()};
+        auto& header = scratch.headers[i];
+        header = ::mmsghdr{};
+        header.msg_hdr.msg_name = &slot.from.storage;
+        header.msg_hdr.msg_namelen =
+            static_cast<::socklen_t>(sizeof(slot.from.storage));
+        header.msg_hdr.msg_iov = &scratch.buffers[i];
+        header.msg_hdr.msg_iovlen = 1;
+    }
+
+    const int received = ::recvmmsg(fd_.get(), scratch.headers.data(),
+                                    static_cast<unsigned int>(count), 0, nullptr);
+    if (received < 0) {
+        return err<std::size_t>(error::from_errno());
+    }
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(received); ++i) {
+        const auto& header = scratch.headers[i];
+        auto& slot = messages[i];
+        slot.size = header.msg_len;
+        slot.from.length = header.msg_hdr.msg_namelen;
+        slot.truncated = (header.msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+    return static_cast<std::size_t>(received);
+}
+
+result<std::size_t>
+udp_socket::send_batch(std::span<const udp_outgoing> datagrams) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (datagrams.empty()) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    const auto count = std::min(datagrams.size(), udp_batch_limit);
+    scratch.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& datagram = datagrams[i];
+        scratch.buffers[i] = ::iovec{
+            .iov_base = const_cast<std::byte *>(datagram.payload.data()),
+            .iov_len = datagram.payload.size()};
+        auto& header = scratch.headers[i];
+        header = ::mmsghdr{};
+        header.msg_hdr.msg_name = const_cast<::sockaddr *>(datagram.to.data());
+        header.msg_hdr.msg_namelen = datagram.to.length;
+        header.msg_hdr.msg_iov = &scratch.buffers[i];
+        header.msg_hdr.msg_iovlen = 1;
+    }
+
+    const int sent = ::sendmmsg(fd_.get(), scratch.headers.data(),
+                                static_cast<unsigned int>(count), MSG_NOSIGNAL);
+    if (sent < 0) {
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(sent);
+}
+
+result<std::size_t>
+udp_socket::send_segmented(std::span<const std::byte> payload,
+                           const socket_address& to,
+                           std::uint16_t segment_size) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (segment_size == 0 ||
+        payload.size() > static_cast<std::size_t>(segment_size) * udp_max_segments) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    ::iovec vector{.iov_base = const_cast<std::byte *>(payload.data()),
+                   .iov_len = payload.size()};
+    alignas(::cmsghdr) std::array<char, CMSG_SPACE(sizeof(std::uint16_t))>
+        control{};
+    ::msghdr message{};
+    message.msg_name = const_cast<::sockaddr *>(to.data());
+    message.msg_namelen = to.length;
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    auto *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_UDP;
+    header->cmsg_type = UDP_SEGMENT;
+    header->cmsg_len = CMSG_LEN(sizeof(segment_size));
+    std::memcpy(CMSG_DATA(header), &segment_size, sizeof(segment_size));
+
+    const ssize_t sent = ::sendmsg(fd_.get(), &message, MSG_NOSIGNAL);
+    if (sent < 0) {
+        return err<std::size_t>(error::from_errno());
+    }
+    return static_cast<std::size_t>(sent);
+}
+
+result<udp_coalesced>
+udp_socket::recv_coalesced(std::span<std::byte> buffer) noexcept {
+    if (!valid()) {
+        return err<udp_coalesced>(make_error_from_errno(EBADF));
+    }
+
+    ::iovec vector{.iov_base = buffer.data(), .iov_len = buffer.size()};
+    alignas(::cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+    udp_coalesced coalesced{};
+    ::msghdr message{};
+    message.msg_name = &coalesced.from.storage;
+    message.msg_namelen = static_cast<::socklen_t>(sizeof(coalesced.from.storage));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    const ssize_t received = ::recvmsg(fd_.get(), &message, 0);
+    if (received < 0) {
+        return err<udp_coalesced>(error::from_errno());
+    }
+    const auto size = std::min(static_cast<std::size_t>(received), buffer.size());
+    coalesced.data = buffer.first(size);
+    coalesced.segment_size = size;
+    coalesced.from.length = message.msg_namelen;
+    coalesced.truncated = (message.msg_flags & MSG_TRUNC) != 0;
+
+    for (auto *header = CMSG_FIRSTHDR(&message); header != nullptr;
+         header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO) {
+            int segment_size = 0;
+            std::memcpy(&segment_size, CMSG_DATA(header), sizeof(segment_size));
+            if (segment_size > 0) {
+                coalesced.segment_size = static_cast<std::size_t>(segment_size);
+            }
+        }
+    }
+    return coalesced;
+}
+
+result<void> udp_socket::set_gso_segment_size(std::uint16_t segment_size) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    const int value = segment_size;
+    if (::setsockopt(fd_.get(), SOL_UDP, UDP_SEGMENT, &value, sizeof(value)) != 0) {
+        return err<void>(error::from_errno());
+    }
+    return ok();
+}
+
+result<void> udp_socket::enable_gro(bool enabled) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    const int value = enabled ? 1 : 0;
+    if (::setsockopt(fd_.get(), SOL_UDP, UDP_GRO, &value, sizeof(value)) != 0) {
+        return err<void>(error::from_errno());
+    }
+    return ok();
+}
+
+result<std::uint16_t> udp_socket::local_port() const noexcept {
+    const auto address = local_address();
+    if (!address.has_value()) {
+        return err<std::uint16_t>(address.error());
+    }
+    return address.value().port();
+}
+
+result<socket_address> udp_socket::local_address() const noexcept {
+    if (!valid()) {
+        return err<socket_address>(make_error_from_errno(EBADF));
+    }
+
+    socket_address address{};
+    address.length = static_cast<::socklen_t>(sizeof(address.storage));
+    if (::getsockname(fd_.get(), reinterpret_cast<::sockaddr *>(&address.storage),
+                      &address.length) != 0) {
+        return err<socket_address>(error::from_errno());
+    }
+    return address;
+}
+
+int udp_socket::native_handle() const noexcept {
+    return fd_.get();
+}
+
+bool udp_socket::valid() const noexcept {
+    return fd_.valid();
+}
+
+} // namespace simplenet::nonblocking
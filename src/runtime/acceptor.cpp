@@ -0,0 +1,129 @@
+#include "simplenet/runtime/acceptor.hpp"
+
+#include "simplenet/runtime/io_ops.hpp"
+
+#include <cerrno>
+#include <utility>
+
+namespace simplenet::runtime {
+
+/// Suspends until the multishot request buffers a connection or fails.
+class multishot_acceptor::next_connection_awaitable {
+public:
+    explicit next_connection_awaitable(multishot_acceptor& owner) noexcept
+        : owner_(owner) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return !owner_.ready_.empty() || owner_.pending_error_.has_value();
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (!requires(Promise& p) { p.scheduler_ptr(); }) {
+            owner_.fallback_ = true;
+            return false;
+        } else {
+            auto *active = handle.promise().scheduler_ptr();
+            if (active == nullptr || !active->supports_completion_io()) {
+                owner_.fallback_ = true;
+                return false;
+            }
+            if (owner_.waiter_) {
+                owner_.pending_error_ = make_error_from_errno(EBUSY);
+                return false;
+            }
+
+            if (!owner_.armed_) {
+                owner_.scheduler_ = active;
+                owner_.operation_ = io_operation{};
+                owner_.operation_.opcode = io_opcode::accept_multishot;
+                owner_.operation_.fd = owner_.listener_->native_handle();
+                owner_.operation_.on_completion = &multishot_acceptor::on_completion;
+                owner_.operation_.context = &owner_;
+
+                const auto submitted = active->submit_io(owner_.operation_);
+                if (!submitted.has_value()) {
+                    owner_.pending_error_ = submitted.error();
+                    return false;
+                }
+                owner_.armed_ = true;
+            }
+
+            owner_.waiter_ = handle;
+            return true;
+        }
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    multishot_acceptor& owner_;
+};
+
+multishot_acceptor::multishot_acceptor(
+    simplenet::nonblocking::tcp_listener& listener) noexcept
+    : listener_(&listener) {}
+
+multishot_acceptor::~multishot_acceptor() {
+    if (armed_ && scheduler_ != nullptr) {
+        scheduler_->abandon_io(operation_);
+    }
+}
+
+task<result<simplenet::nonblocking::tcp_stream>> multishot_acceptor::accept() {
+    if (!listener_->valid()) {
+        co_return err<simplenet::nonblocking::tcp_stream>(
+            make_error_from_errno(EBADF));
+    }
+
+    while (!fallback_) {
+        co_await next_connection_awaitable{*this};
+
+        if (!ready_.empty()) {
+            auto fd = std::move(ready_.front());
+            ready_.pop_front();
+            co_return simplenet::nonblocking::tcp_stream{std::move(fd)};
+        }
+        if (pending_error_.has_value()) {
+            const auto failure = pending_error_.value();
+            pending_error_.reset();
+            co_return err<simplenet::nonblocking::tcp_stream>(failure);
+        }
+        // The multishot request ended without a connection; the next
+        // iteration re-arms it.
+    }
+
+    co_return co_await async_accept(*listener_);
+}
+
+bool multishot_acceptor::multishot_active() const noexcept {
+    return armed_;
+}
+
+std::size_t multishot_acceptor::pending() const noexcept {
+    return ready_.size();
+}
+
+void multishot_acceptor::on_completion(io_operation& operation, int result,
+                                       bool more) noexcept {
+    auto& self = *static_cast<multishot_acceptor *>(operation.context);
+    if (!more) {
+        self.armed_ = false;
+    }
+
+    if (result >= 0) {
+        self.ready_.emplace_back(result);
+    } else if (result == -EINVAL || result == -EOPNOTSUPP) {
+        // Kernel predates multishot accept: serve connections one at a time.
+        self.fallback_ = true;
+    } else if (result != -ECANCELED) {
+        self.pending_error_ = make_error_from_errno(-result);
+    }
+
+    if (self.waiter_ && (!self.ready_.empty() || self.pending_error_.has_value() ||
+                         self.fallback_ || !self.armed_)) {
+        self.scheduler_->schedule(std::exchange(self.waiter_, {}));
+    }
+}
+
+} // namespace simplenet::runtime
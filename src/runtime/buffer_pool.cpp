@@ -0,0 +1,203 @@
+#include "simplenet/runtime/buffer_pool.hpp"
+
+#include "simplenet/runtime/numa.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <new>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+namespace simplenet::runtime {
+
+namespace {
+
+constexpr std::size_t min_class_size = 64;
+constexpr std::size_t huge_page_size = 2U * 1024U * 1024U;
+constexpr std::size_t page_size = 4096;
+/// Heap buffers are cache-line aligned, like arena ones.
+constexpr std::align_val_t heap_alignment{64};
+
+std::size_t round_up(std::size_t value, std::size_t unit) noexcept {
+    return (value + unit - 1U) / unit * unit;
+}
+
+} // namespace
+
+pooled_buffer::~pooled_buffer() {
+    release();
+}
+
+pooled_buffer& pooled_buffer::operator=(pooled_buffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = std::exchange(other.pool_, nullptr);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0U);
+        capacity_ = std::exchange(other.capacity_, 0U);
+    }
+    return *this;
+}
+
+void pooled_buffer::release() noexcept {
+    if (data_ == nullptr) {
+        return;
+    }
+    std::exchange(pool_, nullptr)->release(std::exchange(data_, nullptr), capacity_);
+    size_ = 0;
+    capacity_ = 0;
+}
+
+buffer_pool::buffer_pool(buffer_pool_options options) : options_(options) {
+    options_.min_size = std::bit_ceil(std::max(options_.min_size, min_class_size));
+    options_.max_size = std::bit_ceil(std::max(options_.max_size, options_.min_size));
+    classes_.resize(static_cast<std::size_t>(std::countr_zero(options_.max_size) -
+                                             std::countr_zero(options_.min_size)) +
+                    1U);
+    for (auto& size_class : classes_) {
+        size_class.free.reserve(options_.cache_per_class);
+    }
+
+    if (options_.arena_bytes == 0U) {
+        return;
+    }
+    void *region = MAP_FAILED;
+    if (options_.huge_pages) {
+        arena_size_ = round_up(options_.arena_bytes, huge_page_size);
+        region = ::mmap(nullptr, arena_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        huge_pages_ = region != MAP_FAILED;
+    }
+    if (region == MAP_FAILED) {
+        arena_size_ = round_up(options_.arena_bytes,
+                               options_.huge_pages ? huge_page_size : page_size);
+        region = ::mmap(nullptr, arena_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region != MAP_FAILED && options_.huge_pages) {
+            // Best effort: without THP the arena still works on small pages.
+            (void)::madvise(region, arena_size_, MADV_HUGEPAGE);
+        }
+    }
+    if (region == MAP_FAILED) {
+        arena_size_ = 0;
+        return;
+    }
+    if (options_.numa_node >= 0) {
+        // Best effort too: untouched pages then come from the local node.
+        (void)numa::prefer_node(region, arena_size_, options_.numa_node);
+    }
+    arena_ = static_cast<std::byte *>(region);
+}
+
+buffer_pool::~buffer_pool() {
+    trim();
+    if (arena_ != nullptr) {
+        (void)::munmap(arena_, arena_size_);
+    }
+}
+
+pooled_buffer buffer_pool::acquire(std::size_t size) {
+    ++stats_.acquisitions;
+    if (size > options_.max_size) {
+        ++stats_.heap_allocations;
+        auto *data = static_cast<std::byte *>(::operator new(size, heap_alignment));
+        return pooled_buffer{*this, data, size, size};
+    }
+
+    const std::size_t index = class_of(size);
+    const std::size_t capacity = options_.min_size << index;
+    auto& size_class = classes_[index];
+    std::byte *data = nullptr;
+    if (!size_class.free.empty()) {
+        data = size_class.free.back();
+        size_class.free.pop_back();
+        ++stats_.reuses;
+    } else {
+        // Room for this buffer on the free list once it comes back.
+        const std::size_t needed = size_class.outstanding + 1U;
+        if (size_class.free.capacity() < needed) {
+            size_class.free.reserve(std::max(needed, size_class.free.capacity() * 2U));
+        }
+        if (arena_size_ - stats_.arena_used >= capacity) {
+            data = arena_ + stats_.arena_used;
+            stats_.arena_used += capacity;
+            ++stats_.arena_allocations;
+        } else {
+            data = static_cast<std::byte *>(::operator new(capacity, heap_alignment));
+            ++stats_.heap_allocations;
+        }
+    }
+    ++size_class.outstanding;
+    return pooled_buffer{*this, data, size, capacity};
+}
+
+result<void> buffer_pool::register_with(scheduler& loop) noexcept {
+    if (arena_ == nullptr) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+    const std::array<::iovec, 1> region{
+        ::iovec{.iov_base = arena_, .iov_len = arena_size_}};
+    return loop.register_buffers(region);
+}
+
+std::span<const std::byte> buffer_pool::arena() const noexcept {
+    return {arena_, arena_size_};
+}
+
+bool buffer_pool::huge_pages() const noexcept {
+    return huge_pages_;
+}
+
+buffer_pool_stats buffer_pool::stats() const noexcept {
+    auto counters = stats_;
+    counters.cached_buffers = 0;
+    for (const auto& size_class : classes_) {
+        counters.cached_buffers += size_class.free.size();
+    }
+    return counters;
+}
+
+void buffer_pool::trim() noexcept {
+    for (auto& size_class : classes_) {
+        std::erase_if(size_class.free, [this](std::byte *data) {
+            if (in_arena(data)) {
+                return false;
+            }
+            ::operator delete(data, heap_alignment);
+            return true;
+        });
+    }
+}
+
+std::size_t buffer_pool::class_of(std::size_t size) const noexcept {
+    const std::size_t rounded = std::bit_ceil(std::max(size, options_.min_size));
+    return static_cast<std::size_t>(std::countr_zero(rounded) -
+                                    std::countr_zero(options_.min_size));
+}
+
+bool buffer_pool::in_arena(const std::byte *data) const noexcept {
+    return arena_ != nullptr && data >= arena_ && data < arena_ + arena_size_;
+}
+
+void buffer_pool::release(std::byte *data, std::size_t capacity) noexcept {
+    if (capacity > options_.max_size) {
+        ::operator delete(data, heap_alignment);
+        return;
+    }
+    auto& size_class = classes_[class_of(capacity)];
+    --size_class.outstanding;
+    if (in_arena(data) || size_class.free.size() < options_.cache_per_class) {
+        size_class.free.push_back(data);
+        return;
+    }
+    ::operator delete(data, heap_alignment);
+}
+
+buffer_pool& thread_buffer_pool() {
+    thread_local buffer_pool pool;
+    return pool;
+}
+
+} // namespace simplenet::runtime
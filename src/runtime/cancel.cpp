@@ -0,0 +1,157 @@
+#include "simplenet/runtime/cancel.hpp"
+
+#include <cstddef>
+
+namespace {
+
+using simplenet::runtime::detail::cancel_state;
+
+/// Upper bound on recycled states kept per thread.
+constexpr std::size_t kPoolCapacity = 64;
+
+/// Per-thread cache of released states.
+struct state_pool {
+    cancel_state *head{nullptr};
+    std::size_t size{0};
+
+    ~state_pool();
+};
+
+/// Trivially destructible, so it stays readable while `pool` is torn down.
+thread_local constinit bool pool_retired = false;
+thread_local state_pool pool{};
+
+state_pool::~state_pool() {
+    pool_retired = true;
+    while (head != nullptr) {
+        delete std::exchange(head, head->next_free);
+    }
+}
+
+} // namespace
+
+namespace simplenet::runtime {
+
+namespace detail {
+
+cancel_state *cancel_state::acquire() {
+    if (!pool_retired && pool.head != nullptr) {
+        auto *state = std::exchange(pool.head, pool.head->next_free);
+        --pool.size;
+        state->next_free = nullptr;
+        state->references.store(1, std::memory_order_relaxed);
+        state->requested.store(false, std::memory_order_relaxed);
+        return state;
+    }
+    return new cancel_state{};
+}
+
+void cancel_state::release(cancel_state *state) noexcept {
+    if (state->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    // Callbacks hold references, so none can still be registered here.
+    if (pool_retired || pool.size == kPoolCapacity) {
+        delete state;
+        return;
+    }
+    state->next_free = pool.head;
+    pool.head = state;
+    ++pool.size;
+}
+
+} // namespace detail
+
+bool cancel_source::request_stop() const noexcept {
+    auto *state = state_.get();
+    std::unique_lock lock{state->mutex};
+    if (state->requested.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    state->requested.store(true, std::memory_order_release);
+    state->running_thread = std::this_thread::get_id();
+
+    while (state->callbacks != nullptr) {
+        auto *callback = state->callbacks;
+        state->callbacks = callback->next_;
+        if (state->callbacks != nullptr) {
+            state->callbacks->prev_ = nullptr;
+        }
+        callback->prev_ = nullptr;
+        callback->next_ = nullptr;
+        callback->registered_ = false;
+
+        bool destroyed = false;
+        callback->destroyed_ = &destroyed;
+        state->running = callback;
+        lock.unlock();
+
+        callback->invoke_(*callback);
+
+        lock.lock();
+        if (!destroyed) {
+            callback->destroyed_ = nullptr;
+        }
+        state->running = nullptr;
+        state->callback_finished.notify_all();
+    }
+    return true;
+}
+
+void cancel_callback_base::attach(const cancel_token& token) noexcept {
+    auto *state = token.state_.get();
+    if (state == nullptr) {
+        return;
+    }
+
+    {
+        std::lock_guard lock{state->mutex};
+        if (!state->requested.load(std::memory_order_relaxed)) {
+            state_ = token.state_;
+            next_ = state->callbacks;
+            if (next_ != nullptr) {
+                next_->prev_ = this;
+            }
+            state->callbacks = this;
+            registered_ = true;
+            return;
+        }
+    }
+    invoke_(*this);
+}
+
+void cancel_callback_base::detach() noexcept {
+    auto *state = state_.get();
+    if (state == nullptr) {
+        return;
+    }
+
+    {
+        std::unique_lock lock{state->mutex};
+        if (registered_) {
+            if (prev_ != nullptr) {
+                prev_->next_ = next_;
+            } else {
+                state->callbacks = next_;
+            }
+            if (next_ != nullptr) {
+                next_->prev_ = prev_;
+            }
+            registered_ = false;
+        } else if (state->running == this) {
+            if (state->running_thread == std::this_thread::get_id()) {
+                // Destroyed from inside its own invocation.
+                if (destroyed_ != nullptr) {
+                    *destroyed_ = true;
+                }
+            } else {
+                state->callback_finished.wait(
+                    lock, [&] { return state->running != this; });
+            }
+        }
+    }
+    state_.reset();
+}
+
+} // namespace simplenet::runtime
@@ -0,0 +1,466 @@
+#include "simplenet/runtime/connection_pool.hpp"
+
+#include "simplenet/runtime/io_ops.hpp"
+
+#include "loop_cancellation.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <functional>
+#include <string_view>
+#include <sys/socket.h>
+#include <utility>
+
+namespace simplenet::runtime::detail {
+
+/// Queued `acquire()` call waiting for an active slot.
+struct pool_waiter {
+    std::coroutine_handle<> handle{};
+    scheduler *owner{nullptr};
+};
+
+/// Per-address state: idle connections oldest first, plus waiters.
+struct pool_host {
+    struct idle_connection {
+        simplenet::nonblocking::tcp_stream stream{};
+        std::chrono::steady_clock::time_point expires{};
+    };
+
+    std::deque<idle_connection> idle{};
+    std::deque<pool_waiter *> waiters{};
+    std::size_t active{0};
+};
+
+std::size_t socket_address_hash::operator()(
+    const simplenet::blocking::socket_address& address) const noexcept {
+    return std::hash<std::string_view>{}(
+        std::string_view{reinterpret_cast<const char *>(&address.storage),
+                         static_cast<std::size_t>(address.length)});
+}
+
+} // namespace simplenet::runtime::detail
+
+namespace {
+
+using simplenet::runtime::detail::pool_host;
+using simplenet::runtime::detail::pool_waiter;
+
+/**
+ * @return `true` when nothing is waiting on an idle socket: the peer has
+ * not closed it, it has no error and no unread bytes.
+ */
+bool idle_socket_clean(int fd) noexcept {
+    std::byte probe{};
+    const auto got = ::recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    return got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+/// How the reaper's idle wait ended.
+enum class idle_wake { expired, stopped, closing };
+
+/**
+ * @return `true` while `operation` is armed and has not fired: still in
+ * the epoll loop's wheel, or awaiting its io_uring completion.
+ */
+bool timer_pending(const simplenet::runtime::timer_operation& operation) noexcept {
+    return operation.entry.scheduled() || operation.token != 0U;
+}
+
+/// Destroys the awaiting coroutine's frame, which never resumes.
+struct release_frame {
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> self) const noexcept {
+        self.destroy();
+    }
+    void await_resume() const noexcept {}
+};
+
+/// Non-suspending awaitable that exposes the awaiting task's scheduler.
+class current_scheduler_awaitable {
+public:
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            scheduler_ = handle.promise().scheduler_ptr();
+        }
+        return false;
+    }
+
+    [[nodiscard]] simplenet::runtime::scheduler *await_resume() const noexcept {
+        return scheduler_;
+    }
+
+private:
+    simplenet::runtime::scheduler *scheduler_{nullptr};
+};
+
+} // namespace
+
+namespace simplenet::runtime {
+
+/// Parks an `acquire()` call until a slot frees up for its address.
+class connection_pool::slot_awaitable {
+public:
+    slot_awaitable(pool_host& host, cancel_token token, bool front) noexcept
+        : host_(host), token_(std::move(token)), front_(front) {}
+
+    slot_awaitable(const slot_awaitable&) = delete;
+    slot_awaitable& operator=(const slot_awaitable&) = delete;
+
+    ~slot_awaitable() {
+        if (queued_) {
+            cancellation_.disarm();
+            std::erase(host_.waiters, &waiter_);
+        }
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return token_.stop_requested();
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            waiter_.owner = handle.promise().scheduler_ptr();
+        }
+        if (waiter_.owner == nullptr) {
+            failed_ = true;
+            return false;
+        }
+
+        waiter_.handle = handle;
+        if (front_) {
+            host_.waiters.push_front(&waiter_);
+        } else {
+            host_.waiters.push_back(&waiter_);
+        }
+        queued_ = true;
+        cancellation_.arm(token_, *waiter_.owner, &on_stop, this);
+        return true;
+    }
+
+    [[nodiscard]] result<void> await_resume() noexcept {
+        cancellation_.disarm();
+        queued_ = false;
+        if (failed_) {
+            return err<void>(make_error_from_errno(EINVAL));
+        }
+        if (canceled_ || token_.stop_requested()) {
+            return err<void>(make_error_from_errno(ECANCELED));
+        }
+        return ok();
+    }
+
+private:
+    static void on_stop(void *context) noexcept {
+        auto& self = *static_cast<slot_awaitable *>(context);
+        if (std::erase(self.host_.waiters, &self.waiter_) == 0) {
+            return; // Already woken; the resume is on its way.
+        }
+        self.canceled_ = true;
+        self.waiter_.owner->schedule(self.waiter_.handle);
+    }
+
+    pool_host& host_;
+    cancel_token token_;
+    detail::loop_cancellation cancellation_{};
+    pool_waiter waiter_{};
+    bool front_{false};
+    bool queued_{false};
+    bool canceled_{false};
+    bool failed_{false};
+};
+
+/// Parks the idle reaper on the pool's timer operation.
+class connection_pool::idle_wait_awaitable {
+public:
+    idle_wait_awaitable(connection_pool& pool,
+                        std::chrono::steady_clock::time_point deadline) noexcept
+        : pool_(pool), deadline_(deadline) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return std::chrono::steady_clock::now() >= deadline_;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) noexcept {
+        pool_.idle_timer_.handle = handle;
+        suspended_ = pool_.scheduler_->schedule_at(deadline_, pool_.idle_timer_)
+                         .has_value();
+        if (suspended_) {
+            pool_.idle_wait_ = this;
+        }
+        return suspended_;
+    }
+
+    [[nodiscard]] idle_wake await_resume() noexcept {
+        if (!suspended_) {
+            return await_ready() ? idle_wake::expired : idle_wake::stopped;
+        }
+        if (closing_) {
+            return idle_wake::closing; // The pool may be gone.
+        }
+        pool_.idle_wait_ = nullptr;
+        return pool_.idle_timer_.result == 0 ? idle_wake::expired
+                                             : idle_wake::stopped;
+    }
+
+    /// Make the queued resume of a fired timer leave the pool alone.
+    void close() noexcept {
+        closing_ = true;
+    }
+
+private:
+    connection_pool& pool_;
+    std::chrono::steady_clock::time_point deadline_;
+    bool suspended_{false};
+    bool closing_{false};
+};
+
+pooled_connection::pooled_connection(connection_pool& pool,
+                                     detail::pool_host& host,
+                                     simplenet::nonblocking::tcp_stream stream,
+                                     bool reused) noexcept
+    : pool_(&pool), host_(&host), stream_(std::move(stream)), reused_(reused) {}
+
+pooled_connection::~pooled_connection() {
+    release(false);
+}
+
+pooled_connection::pooled_connection(pooled_connection&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      host_(std::exchange(other.host_, nullptr)),
+      stream_(std::move(other.stream_)), reused_(other.reused_) {}
+
+pooled_connection&
+pooled_connection::operator=(pooled_connection&& other) noexcept {
+    if (this != &other) {
+        release(false);
+        pool_ = std::exchange(other.pool_, nullptr);
+        host_ = std::exchange(other.host_, nullptr);
+        stream_ = std::move(other.stream_);
+        reused_ = other.reused_;
+    }
+    return *this;
+}
+
+void pooled_connection::recycle() noexcept {
+    release(true);
+}
+
+void pooled_connection::discard() noexcept {
+    release(false);
+}
+
+void pooled_connection::release(bool reusable) noexcept {
+    if (host_ == nullptr) {
+        return;
+    }
+    auto *pool = std::exchange(pool_, nullptr);
+    auto *host = std::exchange(host_, nullptr);
+    pool->release(*host, std::move(stream_), reusable);
+}
+
+connection_pool::connection_pool(connection_pool_options options) noexcept
+    : options_(options) {}
+
+connection_pool::~connection_pool() {
+    close_idle();
+    if (reaper_ && reaper_.done()) {
+        reaper_.destroy();
+    }
+}
+
+task<result<pooled_connection>>
+connection_pool::acquire(const simplenet::blocking::socket_address& remote,
+                         cancel_token token) {
+    const auto target = remote;
+    if (scheduler_ == nullptr) {
+        scheduler_ = co_await current_scheduler_awaitable{};
+    }
+
+    auto& slot = hosts_[target];
+    if (slot == nullptr) {
+        slot = std::make_unique<detail::pool_host>();
+    }
+    auto& host = *slot;
+
+    bool requeued = false;
+    while (true) {
+        if (auto lease = take_idle(host)) {
+            co_return std::move(*lease);
+        }
+        if (host.active < options_.max_active_per_host) {
+            break;
+        }
+        if (!requeued) {
+            ++stats_.waits;
+        }
+        // A woken waiter that lost its slot keeps its place at the front.
+        const auto woken = co_await slot_awaitable{host, token, requeued};
+        if (!woken.has_value()) {
+            co_return err<pooled_connection>(woken.error());
+        }
+        requeued = true;
+    }
+
+    ++host.active;
+    auto stream = co_await async_connect(target, options_.socket);
+    if (!stream.has_value()) {
+        --host.active;
+        wake_one(host);
+        co_return err<pooled_connection>(stream.error());
+    }
+    ++stats_.connects;
+    co_return pooled_connection{*this, host, std::move(stream.value()), false};
+}
+
+std::size_t connection_pool::idle_count(
+    const simplenet::blocking::socket_address& remote) const noexcept {
+    const auto found = hosts_.find(remote);
+    return found == hosts_.end() ? 0 : found->second->idle.size();
+}
+
+std::size_t connection_pool::active_count(
+    const simplenet::blocking::socket_address& remote) const noexcept {
+    const auto found = hosts_.find(remote);
+    return found == hosts_.end() ? 0 : found->second->active;
+}
+
+connection_pool_stats connection_pool::stats() const noexcept {
+    return stats_;
+}
+
+void connection_pool::close_idle() noexcept {
+    for (auto& [address, host] : hosts_) {
+        host->idle.clear();
+    }
+    stop_reaper();
+}
+
+std::optional<pooled_connection>
+connection_pool::take_idle(detail::pool_host& host) noexcept {
+    // Newest first: the least likely to have been closed by the peer.
+    while (!host.idle.empty()) {
+        auto stream = std::move(host.idle.back().stream);
+        host.idle.pop_back();
+        if (!idle_socket_clean(stream.native_handle())) {
+            ++stats_.stale;
+            continue;
+        }
+        ++host.active;
+        ++stats_.reuses;
+        return pooled_connection{*this, host, std::move(stream), true};
+    }
+    return std::nullopt;
+}
+
+void connection_pool::release(detail::pool_host& host,
+                              simplenet::nonblocking::tcp_stream stream,
+                              bool reusable) noexcept {
+    if (host.active > 0) {
+        --host.active;
+    }
+    if (reusable && stream.valid() &&
+        host.idle.size() < options_.max_idle_per_host &&
+        options_.idle_timeout > std::chrono::milliseconds{0}) {
+        host.idle.push_back(
+            {std::move(stream),
+             std::chrono::steady_clock::now() + options_.idle_timeout});
+        start_reaper();
+    }
+    wake_one(host);
+}
+
+void connection_pool::wake_one(detail::pool_host& host) noexcept {
+    if (host.waiters.empty()) {
+        return;
+    }
+    auto *waiter = host.waiters.front();
+    host.waiters.pop_front();
+    waiter->owner->schedule(waiter->handle);
+}
+
+void connection_pool::expire_idle(
+    std::chrono::steady_clock::time_point now) noexcept {
+    for (auto& [address, host] : hosts_) {
+        while (!host->idle.empty() && host->idle.front().expires <= now) {
+            host->idle.pop_front();
+            ++stats_.expired;
+        }
+    }
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+connection_pool::next_expiry() const noexcept {
+    std::optional<std::chrono::steady_clock::time_point> next{};
+    for (const auto& [address, host] : hosts_) {
+        if (!host->idle.empty() &&
+            (!next.has_value() || host->idle.front().expires < *next)) {
+            next = host->idle.front().expires;
+        }
+    }
+    return next;
+}
+
+void connection_pool::start_reaper() noexcept {
+    if (scheduler_ == nullptr) {
+        return;
+    }
+    if (reaper_) {
+        if (!reaper_.done()) {
+            return; // Armed, or queued to recompute its deadline.
+        }
+        reaper_.destroy();
+    }
+
+    // Run inline up to the timer wait, so the reaper is never left queued
+    // where `close_idle()` could not reach it.
+    auto handle = reap().release();
+    handle.promise().set_scheduler(scheduler_, false);
+    reaper_ = handle;
+    reaper_.resume();
+}
+
+void connection_pool::stop_reaper() noexcept {
+    if (!reaper_) {
+        return;
+    }
+    if (!reaper_.done()) {
+        if (!timer_pending(idle_timer_)) {
+            // Its timer fired and the resume is queued; that resume frees
+            // the frame without touching this pool.
+            if (idle_wait_ != nullptr) {
+                idle_wait_->close();
+            }
+            idle_wait_ = nullptr;
+            reaper_ = {};
+            return;
+        }
+        scheduler_->abandon_timer(idle_timer_);
+    }
+    idle_wait_ = nullptr;
+    reaper_.destroy();
+    reaper_ = {};
+}
+
+task<void> connection_pool::reap() {
+    while (const auto deadline = next_expiry()) {
+        const auto woke = co_await idle_wait_awaitable{*this, *deadline};
+        if (woke == idle_wake::closing) {
+            co_await release_frame{};
+        }
+        if (woke != idle_wake::expired) {
+            co_return;
+        }
+        expire_idle(std::chrono::steady_clock::now());
+    }
+}
+
+} // namespace simplenet::runtime
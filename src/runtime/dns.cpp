@@ -0,0 +1,586 @@
+#include "simplenet/runtime/dns.hpp"
+
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/nonblocking/udp.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <netinet/in.h>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <sys/socket.h>
+#include <utility>
+
+namespace {
+
+using simplenet::blocking::socket_address;
+using simplenet::runtime::dns_options;
+using address_list = std::vector<socket_address>;
+using std::chrono::steady_clock;
+
+constexpr std::uint16_t dns_port = 53;
+constexpr std::uint16_t type_a = 1;
+constexpr std::uint16_t type_aaaa = 28;
+constexpr std::uint16_t class_in = 1;
+constexpr std::size_t header_size = 12;
+constexpr std::uint16_t flag_response = 0x8000;
+constexpr std::uint16_t flag_truncated = 0x0200;
+constexpr std::uint16_t flag_recursion_desired = 0x0100;
+constexpr std::uint16_t rcode_mask = 0x000F;
+constexpr std::uint16_t rcode_name_error = 3;
+/// Receive buffer for one UDP answer; servers without EDNS cap at 512.
+constexpr std::size_t udp_answer_limit = 4096;
+
+/// How one server answered one query.
+enum class answer_kind {
+    /// Not a reply to this query; keep waiting.
+    unrelated,
+    /// Authoritative result, possibly with no addresses.
+    answered,
+    /// The name does not exist (`NXDOMAIN`).
+    no_name,
+    /// The answer did not fit; ask again over TCP.
+    truncated,
+    /// Server failure or refusal; ask the next server.
+    retry,
+};
+
+struct parsed_answer {
+    answer_kind kind{answer_kind::unrelated};
+    address_list addresses{};
+};
+
+/// One outstanding A or AAAA question.
+struct dns_query {
+    std::uint16_t type{type_a};
+    std::vector<std::byte> message{};
+    /// Set once any server gave a final answer.
+    bool done{false};
+    bool no_name{false};
+    /// Still waiting on the current server.
+    bool awaiting{false};
+    address_list addresses{};
+};
+
+std::uint16_t read_u16(std::span<const std::byte> bytes,
+                       std::size_t offset) noexcept {
+    return static_cast<std::uint16_t>(
+        (std::to_integer<unsigned>(bytes[offset]) << 8U) |
+        std::to_integer<unsigned>(bytes[offset + 1]));
+}
+
+void append_u16(std::vector<std::byte>& out, std::uint16_t value) {
+    out.push_back(static_cast<std::byte>(value >> 8U));
+    out.push_back(static_cast<std::byte>(value & 0xFFU));
+}
+
+/// Encode `host` as wire-format labels, or empty when it is malformed.
+std::vector<std::byte> encode_name(std::string_view host) {
+    if (!host.empty() && host.back() == '.') {
+        host.remove_suffix(1);
+    }
+    std::vector<std::byte> wire;
+    if (host.empty() || host.size() > 253) {
+        return wire;
+    }
+    while (true) {
+        const std::size_t dot = host.find('.');
+        const std::string_view label = host.substr(0, dot);
+        if (label.empty() || label.size() > 63) {
+            return {};
+        }
+        wire.push_back(static_cast<std::byte>(label.size()));
+        for (const char ch : label) {
+            wire.push_back(static_cast<std::byte>(ch));
+        }
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        host.remove_prefix(dot + 1);
+    }
+    wire.push_back(std::byte{0});
+    return wire;
+}
+
+std::uint16_t next_query_id() {
+    thread_local std::mt19937 engine{std::random_device{}()};
+    return static_cast<std::uint16_t>(engine());
+}
+
+std::vector<std::byte> build_query(std::span<const std::byte> name,
+                                   std::uint16_t id, std::uint16_t type) {
+    std::vector<std::byte> message;
+    message.reserve(header_size + name.size() + 4);
+    append_u16(message, id);
+    append_u16(message, flag_recursion_desired);
+    append_u16(message, 1); // QDCOUNT
+    append_u16(message, 0);
+    append_u16(message, 0);
+    append_u16(message, 0);
+    message.insert(message.end(), name.begin(), name.end());
+    append_u16(message, type);
+    append_u16(message, class_in);
+    return message;
+}
+
+/// @return Offset just past the name at `offset`, or empty when malformed.
+std::optional<std::size_t> skip_name(std::span<const std::byte> bytes,
+                                     std::size_t offset) noexcept {
+    while (offset < bytes.size()) {
+        const auto length = std::to_integer<unsigned>(bytes[offset]);
+        if (length == 0) {
+            return offset + 1;
+        }
+        if ((length & 0xC0U) == 0xC0U) {
+            return offset + 2 <= bytes.size() ? std::optional{offset + 2}
+                                              : std::nullopt;
+        }
+        if ((length & 0xC0U) != 0) {
+            return std::nullopt;
+        }
+        offset += 1 + length;
+    }
+    return std::nullopt;
+}
+
+bool same_letters(std::byte lhs, std::byte rhs) noexcept {
+    const auto fold = [](std::byte value) {
+        const auto ch = std::to_integer<unsigned char>(value);
+        return ch >= 'A' && ch <= 'Z' ? static_cast<unsigned char>(ch + 32)
+                                      : ch;
+    };
+    return fold(lhs) == fold(rhs);
+}
+
+socket_address make_address(std::span<const std::byte> rdata,
+                            std::uint16_t port) noexcept {
+    if (rdata.size() == 4) {
+        ::sockaddr_in ipv4{};
+        ipv4.sin_family = AF_INET;
+        ipv4.sin_port = ::htons(port);
+        std::memcpy(&ipv4.sin_addr, rdata.data(), rdata.size());
+        return socket_address::from_native(
+                   reinterpret_cast<const ::sockaddr *>(&ipv4), sizeof(ipv4))
+            .value();
+    }
+    ::sockaddr_in6 ipv6{};
+    ipv6.sin6_family = AF_INET6;
+    ipv6.sin6_port = ::htons(port);
+    std::memcpy(&ipv6.sin6_addr, rdata.data(), rdata.size());
+    return socket_address::from_native(
+               reinterpret_cast<const ::sockaddr *>(&ipv6), sizeof(ipv6))
+        .value();
+}
+
+/**
+ * Match `reply` against `query` and pull out its addresses.
+ *
+ * The id and the echoed question must both match, so a stray or spoofed
+ * datagram is skipped rather than trusted.
+ */
+parsed_answer parse_answer(std::span<const std::byte> reply,
+                           const dns_query& query, std::uint16_t port) {
+    const auto sent = std::span<const std::byte>{query.message};
+    const std::size_t question_size = sent.size() - header_size;
+    if (reply.size() < header_size + question_size ||
+        read_u16(reply, 0) != read_u16(sent, 0) || read_u16(reply, 4) != 1) {
+        return {};
+    }
+    const std::uint16_t flags = read_u16(reply, 2);
+    if ((flags & flag_response) == 0 ||
+        !std::equal(sent.begin() + header_size, sent.end(),
+                    reply.begin() + header_size, same_letters)) {
+        return {};
+    }
+    if ((flags & flag_truncated) != 0) {
+        return {.kind = answer_kind::truncated};
+    }
+    const auto rcode = static_cast<std::uint16_t>(flags & rcode_mask);
+    if (rcode == rcode_name_error) {
+        return {.kind = answer_kind::no_name};
+    }
+    if (rcode != 0) {
+        return {.kind = answer_kind::retry};
+    }
+
+    const std::size_t wanted = query.type == type_a ? 4U : 16U;
+    parsed_answer parsed{.kind = answer_kind::answered};
+    std::size_t offset = header_size + question_size;
+    for (std::uint16_t index = 0, count = read_u16(reply, 6); index < count;
+         ++index) {
+        const auto after_name = skip_name(reply, offset);
+        if (!after_name.has_value() || *after_name + 10 > reply.size()) {
+            break;
+        }
+        offset = *after_name;
+        const std::uint16_t type = read_u16(reply, offset);
+        const std::uint16_t klass = read_u16(reply, offset + 2);
+        const std::size_t length = read_u16(reply, offset + 8);
+        offset += 10;
+        if (offset + length > reply.size()) {
+            break;
+        }
+        // CNAME records are skipped; recursive servers append their target.
+        if (type == query.type && klass == class_in && length == wanted) {
+            parsed.addresses.push_back(
+                make_address(reply.subspan(offset, length), port));
+        }
+        offset += length;
+    }
+    return parsed;
+}
+
+/// Record a final or retry answer; other kinds leave `query` waiting.
+void apply(dns_query& query, parsed_answer parsed) {
+    switch (parsed.kind) {
+    case answer_kind::answered:
+        query.done = true;
+        query.addresses = std::move(parsed.addresses);
+        break;
+    case answer_kind::no_name:
+        query.done = true;
+        query.no_name = true;
+        break;
+    case answer_kind::unrelated:
+    case answer_kind::truncated:
+        return;
+    case answer_kind::retry:
+        break;
+    }
+    query.awaiting = false;
+}
+
+/// Re-ask `query` over TCP after a truncated UDP answer.
+simplenet::runtime::task<simplenet::result<void>>
+query_over_tcp(const socket_address& server, dns_query& query,
+               std::uint16_t port, steady_clock::time_point deadline,
+               simplenet::runtime::cancel_token token) {
+    using simplenet::err;
+    using simplenet::make_error_from_errno;
+
+    auto stream = simplenet::nonblocking::tcp_stream::connect(server);
+    if (!stream.has_value()) {
+        co_return err<void>(stream.error());
+    }
+    const auto connected = co_await simplenet::runtime::wait_writable_until(
+        stream.value().native_handle(), deadline, token);
+    if (!connected.has_value()) {
+        co_return connected;
+    }
+    if (auto status = stream.value().finish_connect(); !status.has_value()) {
+        co_return status;
+    }
+
+    std::vector<std::byte> frame;
+    append_u16(frame, static_cast<std::uint16_t>(query.message.size()));
+    frame.insert(frame.end(), query.message.begin(), query.message.end());
+    for (std::span<const std::byte> rest{frame}; !rest.empty();) {
+        const auto written = co_await simplenet::runtime::async_write_some_until(
+            stream.value(), rest, deadline, token);
+        if (!written.has_value()) {
+            co_return err<void>(written.error());
+        }
+        rest = rest.subspan(written.value());
+    }
+
+    // A two-byte length prefix, then the message itself.
+    std::vector<std::byte> reply(2);
+    for (std::size_t filled = 0, wanted = 2; filled < wanted;) {
+        const auto got = co_await simplenet::runtime::async_read_some_until(
+            stream.value(), std::span{reply}.subspan(filled), deadline, token);
+        if (!got.has_value()) {
+            co_return err<void>(got.error());
+        }
+        if (got.value() == 0) {
+            co_return err<void>(make_error_from_errno(ECONNRESET));
+        }
+        filled += got.value();
+        if (wanted == 2 && filled == 2) {
+            wanted = read_u16(reply, 0);
+            reply.assign(wanted, std::byte{0});
+            filled = 0;
+        }
+    }
+
+    auto parsed = parse_answer(reply, query, port);
+    if (parsed.kind == answer_kind::unrelated ||
+        parsed.kind == answer_kind::truncated) {
+        parsed.kind = answer_kind::retry;
+    }
+    apply(query, std::move(parsed));
+    co_return simplenet::ok();
+}
+
+/// Ask `server` every unfinished query and collect answers until `deadline`.
+simplenet::runtime::task<simplenet::result<void>>
+query_server(const socket_address& server, std::span<dns_query> queries,
+             std::uint16_t port, steady_clock::time_point deadline,
+             simplenet::runtime::cancel_token token) {
+    using simplenet::err;
+
+    auto socket = simplenet::nonblocking::udp_socket::bind(
+        server.family() == AF_INET6 ? socket_address::ipv6_any(0)
+                                    : socket_address::any(0));
+    if (!socket.has_value()) {
+        co_return err<void>(socket.error());
+    }
+    const int fd = socket.value().native_handle();
+
+    for (auto& query : queries) {
+        query.awaiting = !query.done;
+        while (query.awaiting) {
+            const auto sent = socket.value().send_to(query.message, server);
+            if (sent.has_value()) {
+                break;
+            }
+            if (!simplenet::nonblocking::is_would_block(sent.error())) {
+                co_return err<void>(sent.error());
+            }
+            const auto ready = co_await simplenet::runtime::wait_writable_until(
+                fd, deadline, token);
+            if (!ready.has_value()) {
+                co_return ready;
+            }
+        }
+    }
+
+    std::vector<std::byte> buffer(udp_answer_limit);
+    while (std::ranges::any_of(queries, &dns_query::awaiting)) {
+        const auto datagram = socket.value().recv_from(buffer);
+        if (!datagram.has_value()) {
+            if (!simplenet::nonblocking::is_would_block(datagram.error())) {
+                co_return err<void>(datagram.error());
+            }
+            const auto ready = co_await simplenet::runtime::wait_readable_until(
+                fd, deadline, token);
+            if (!ready.has_value()) {
+                co_return ready;
+            }
+            continue;
+        }
+        if (!(datagram.value().from == server)) {
+            continue;
+        }
+
+        const auto reply =
+            std::span<const std::byte>{buffer}.first(datagram.value().size);
+        for (auto& query : queries) {
+            if (!query.awaiting) {
+                continue;
+            }
+            auto parsed = parse_answer(reply, query, port);
+            if (parsed.kind == answer_kind::truncated) {
+                const auto status =
+                    co_await query_over_tcp(server, query, port, deadline, token);
+                if (!status.has_value()) {
+                    if (status.error().value() == ECANCELED) {
+                        co_return status;
+                    }
+                    query.awaiting = false;
+                }
+                break;
+            }
+            if (parsed.kind != answer_kind::unrelated) {
+                apply(query, std::move(parsed));
+                break;
+            }
+        }
+    }
+    co_return simplenet::ok();
+}
+
+std::optional<std::uint16_t> parse_port(std::string_view service) noexcept {
+    std::uint16_t port = 0;
+    const auto *end = service.data() + service.size();
+    const auto [last, status] = std::from_chars(service.data(), end, port);
+    if (service.empty() || status != std::errc{} || last != end) {
+        return std::nullopt;
+    }
+    return port;
+}
+
+/// Parse a numeric tail such as `timeout:3`, clamped to `[1, limit]`.
+std::optional<int> option_value(std::string_view word, std::string_view name,
+                                int limit) noexcept {
+    if (!word.starts_with(name)) {
+        return std::nullopt;
+    }
+    word.remove_prefix(name.size());
+    int value = 0;
+    const auto [last, status] =
+        std::from_chars(word.data(), word.data() + word.size(), value);
+    if (status != std::errc{} || last != word.data() + word.size()) {
+        return std::nullopt;
+    }
+    return std::clamp(value, 1, limit);
+}
+
+const dns_options& system_options() {
+    static const dns_options options = []() {
+        auto loaded = simplenet::runtime::load_resolv_conf();
+        if (loaded.has_value()) {
+            return std::move(loaded.value());
+        }
+        dns_options fallback{};
+        fallback.nameservers.push_back(socket_address::loopback(dns_port));
+        return fallback;
+    }();
+    return options;
+}
+
+} // namespace
+
+namespace simplenet::runtime {
+
+result<dns_options> load_resolv_conf(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return err<dns_options>(make_error_from_errno(errno != 0 ? errno
+                                                                 : ENOENT));
+    }
+
+    dns_options options{};
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string_view rest{line};
+        rest = rest.substr(0, rest.find_first_of("#;"));
+        std::vector<std::string_view> words;
+        while (!rest.empty()) {
+            const std::size_t start = rest.find_first_not_of(" \t\r");
+            if (start == std::string_view::npos) {
+                break;
+            }
+            rest.remove_prefix(start);
+            const std::size_t stop = rest.find_first_of(" \t\r");
+            words.push_back(rest.substr(0, stop));
+            rest.remove_prefix(stop == std::string_view::npos ? rest.size()
+                                                              : stop);
+        }
+        if (words.size() < 2) {
+            continue;
+        }
+
+        if (words[0] == "nameserver") {
+            // Scoped link-local servers (`fe80::1%eth0`) are not supported.
+            auto server = socket_address::from_endpoint(
+                {.host = std::string{words[1]}, .port = dns_port});
+            if (server.has_value() &&
+                options.nameservers.size() < dns_max_nameservers) {
+                options.nameservers.push_back(server.value());
+            }
+        } else if (words[0] == "options") {
+            for (const auto word : std::span{words}.subspan(1)) {
+                if (const auto seconds = option_value(word, "timeout:", 30)) {
+                    options.timeout = std::chrono::seconds{*seconds};
+                } else if (const auto tries =
+                               option_value(word, "attempts:", 5)) {
+                    options.attempts = *tries;
+                }
+            }
+        }
+    }
+
+    if (options.nameservers.empty()) {
+        options.nameservers.push_back(socket_address::loopback(dns_port));
+    }
+    return options;
+}
+
+task<result<std::vector<socket_address>>>
+async_dns_resolve(std::string host, std::string service, int family,
+                  dns_options options, cancel_token token) {
+    if (token.stop_requested()) {
+        co_return err<address_list>(make_error_from_errno(ECANCELED));
+    }
+    const auto port = parse_port(service);
+    if (!port.has_value() || options.attempts < 1 ||
+        options.timeout <= std::chrono::milliseconds{0} ||
+        (family != AF_UNSPEC && family != AF_INET && family != AF_INET6)) {
+        co_return err<address_list>(make_error_from_errno(EINVAL));
+    }
+
+    if (auto literal = socket_address::from_endpoint({.host = host,
+                                                      .port = *port});
+        literal.has_value()) {
+        if (family != AF_UNSPEC && literal.value().family() != family) {
+            co_return err<address_list>(make_error_from_errno(ENOENT));
+        }
+        co_return address_list{literal.value()};
+    }
+
+    const auto name = encode_name(host);
+    if (name.empty()) {
+        co_return err<address_list>(make_error_from_errno(EINVAL));
+    }
+    if (options.nameservers.empty()) {
+        options.nameservers = system_options().nameservers;
+    }
+
+    std::vector<dns_query> queries;
+    for (const std::uint16_t type : {type_aaaa, type_a}) {
+        if (family == AF_UNSPEC || family == (type == type_a ? AF_INET
+                                                             : AF_INET6)) {
+            std::uint16_t id = next_query_id();
+            while (!queries.empty() && id == read_u16(queries[0].message, 0)) {
+                id = next_query_id();
+            }
+            queries.push_back({.type = type,
+                               .message = build_query(name, id, type)});
+        }
+    }
+
+    error last_failure = make_error_from_errno(ETIMEDOUT);
+    bool have_addresses = false;
+    for (int attempt = 0; attempt < options.attempts && !have_addresses;
+         ++attempt) {
+        for (const auto& server : options.nameservers) {
+            const auto status = co_await query_server(
+                server, queries, *port, steady_clock::now() + options.timeout,
+                token);
+            if (!status.has_value()) {
+                if (status.error().value() == ECANCELED) {
+                    co_return err<address_list>(status.error());
+                }
+                last_failure = status.error();
+            }
+            // One family answering is enough; the other may never reply.
+            have_addresses = std::ranges::any_of(queries, [](const auto& q) {
+                return !q.addresses.empty();
+            });
+            if (have_addresses ||
+                std::ranges::all_of(queries, &dns_query::done)) {
+                break;
+            }
+            if (status.has_value()) {
+                last_failure = make_error_from_errno(EAGAIN);
+            }
+        }
+        if (std::ranges::all_of(queries, &dns_query::done)) {
+            break;
+        }
+    }
+
+    address_list addresses;
+    for (auto& query : queries) {
+        addresses.insert(addresses.end(), query.addresses.begin(),
+                         query.addresses.end());
+    }
+    if (!addresses.empty()) {
+        co_return addresses;
+    }
+    if (std::ranges::all_of(queries, &dns_query::done)) {
+        co_return err<address_list>(make_error_from_errno(ENOENT));
+    }
+    co_return err<address_list>(last_failure);
+}
+
+} // namespace simplenet::runtime
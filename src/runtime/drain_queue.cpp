@@ -0,0 +1,62 @@
+#include "simplenet/runtime/drain_queue.hpp"
+
+namespace simplenet::runtime {
+
+bool drain_queue::push(drain_hook& hook) noexcept {
+    if (hook.queued) {
+        return false;
+    }
+
+    hook.queued = true;
+    hook.next = nullptr;
+    hook.prev = tail_;
+    if (tail_ != nullptr) {
+        tail_->next = &hook;
+    } else {
+        head_ = &hook;
+    }
+    tail_ = &hook;
+    ++size_;
+    return true;
+}
+
+void drain_queue::withdraw(drain_hook& hook) noexcept {
+    if (!hook.queued) {
+        return;
+    }
+
+    if (hook.prev != nullptr) {
+        hook.prev->next = hook.next;
+    } else {
+        head_ = hook.next;
+    }
+    if (hook.next != nullptr) {
+        hook.next->prev = hook.prev;
+    } else {
+        tail_ = hook.prev;
+    }
+    hook.prev = nullptr;
+    hook.next = nullptr;
+    hook.queued = false;
+    --size_;
+}
+
+drain_hook *drain_queue::pop() noexcept {
+    auto *hook = head_;
+    if (hook == nullptr) {
+        return nullptr;
+    }
+
+    head_ = hook->next;
+    if (head_ != nullptr) {
+        head_->prev = nullptr;
+    } else {
+        tail_ = nullptr;
+    }
+    hook->next = nullptr;
+    hook->queued = false;
+    --size_;
+    return hook;
+}
+
+} // namespace simplenet::runtime
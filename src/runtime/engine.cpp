@@ -1,17 +1,40 @@
 #include "simplenet/runtime/engine.hpp"
 
+#include "simplenet/uring/probe.hpp"
+
 #include <cerrno>
 
 namespace simplenet::runtime {
 
 engine::engine(backend choice, std::uint32_t uring_queue_depth)
-    : backend_(choice) {
+    : engine(choice, uring_options{.queue_depth = uring_queue_depth}) {}
+
+engine::engine(backend choice, const uring_options& uring)
+    : backend_(resolve(choice)) {
+    if (choice == backend::automatic && backend_ == backend::io_uring) {
+        // The probe ring came up, yet this one may not (memlock, flags).
+        uring_loop_.emplace(uring);
+        if (uring_loop_->valid()) {
+            return;
+        }
+        uring_loop_.reset();
+        backend_ = backend::epoll;
+    }
+
     if (backend_ == backend::epoll) {
         epoll_loop_.emplace();
         return;
     }
 
-    uring_loop_.emplace(uring_queue_depth);
+    uring_loop_.emplace(uring);
+}
+
+engine::backend engine::resolve(backend choice) noexcept {
+    if (choice != backend::automatic) {
+        return choice;
+    }
+    return uring::cached_support().runtime_ready() ? backend::io_uring
+                                                   : backend::epoll;
 }
 
 engine::backend engine::selected_backend() const noexcept {
@@ -38,6 +61,16 @@ result<void> engine::run() noexcept {
     return err<void>(make_error_from_errno(EINVAL));
 }
 
+scheduler *engine::active_scheduler() noexcept {
+    if (epoll_loop_.has_value()) {
+        return &*epoll_loop_;
+    }
+    if (uring_loop_.has_value()) {
+        return &*uring_loop_;
+    }
+    return nullptr;
+}
+
 void engine::stop() noexcept {
     if (epoll_loop_.has_value()) {
         epoll_loop_->stop();
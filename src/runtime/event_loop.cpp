@@ -1,8 +1,8 @@
 #include "simplenet/runtime/event_loop.hpp"
 
 #include <algorithm>
-#include <array>
 #include <chrono>
+#include <initializer_list>
 #include <limits>
 #include <sys/eventfd.h>
 #include <sys/epoll.h>
@@ -13,17 +13,25 @@ namespace {
 constexpr std::uint32_t kReadReadyMask =
     EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
 constexpr std::uint32_t kWriteReadyMask = EPOLLOUT | EPOLLERR | EPOLLHUP;
-constexpr std::uint32_t kCommonFlags =
-    EPOLLET | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
+/// Interest every waited-on descriptor keeps until it closes.
+constexpr std::uint32_t kPersistentMask =
+    EPOLLIN | EPOLLOUT | EPOLLET | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
+
+/// Timer wheel tags: readiness-wait deadlines vs `schedule_at()` timers.
+constexpr std::uint32_t kWaiterTimerTag = 0;
+constexpr std::uint32_t kScheduledTimerTag = 1;
+
+/// Posted work run per loop iteration before I/O is polled again.
+constexpr std::size_t kPostedBatch = 64;
 
 } // namespace
 
 namespace simplenet::runtime {
 
 event_loop::event_loop() noexcept {
-    waiters_.reserve(256);
-    wait_results_.reserve(256);
-    root_tasks_.reserve(256);
+    set_poll_batch(default_poll_batch);
+    close_listener_.on_close = &on_descriptor_closed;
+    close_listener_.context = this;
 
     auto reactor_result = simplenet::epoll::reactor::create();
     if (!reactor_result.has_value()) {
@@ -61,15 +69,31 @@ result<void> event_loop::run() noexcept {
     stop_requested_.store(false, std::memory_order_release);
     loop_error_.reset();
 
-    std::array<simplenet::epoll::ready_event, 64> events{};
+    // Closes are only observed while running; anything cached about idle
+    // descriptors is dropped on the way out.
+    simplenet::detail::add_close_listener(close_listener_);
+    auto outcome = run_iterations();
+    if (recorder_.publish_due(true)) {
+        publish_metrics();
+    }
+    simplenet::detail::remove_close_listener(close_listener_);
+    forget_idle_registrations();
+    return outcome;
+}
 
+result<void> event_loop::run_iterations() noexcept {
     while (!stop_requested_.load(std::memory_order_acquire)) {
+        run_remote_wakeups();
+        run_posted_work();
         process_expired_waiters();
         if (stop_requested_.load(std::memory_order_acquire) ||
             loop_error_.has_value()) {
             break;
         }
 
+        recorder_.begin_resumes(ready_queue_.size());
+        budget_.begin_pass();
+        bool budget_spent = false;
         while (!ready_queue_.empty()) {
             const auto handle = ready_queue_.front();
             ready_queue_.pop_front();
@@ -78,7 +102,10 @@ result<void> event_loop::run() noexcept {
                 continue;
             }
 
+            watch_.begin(handle.address());
             handle.resume();
+            watch_.end();
+            recorder_.resumed();
             cleanup_completed_roots();
             process_expired_waiters();
 
@@ -86,6 +113,10 @@ result<void> event_loop::run() noexcept {
                 loop_error_.has_value()) {
                 break;
             }
+            if (budget_.spend()) {
+                budget_spent = true;
+                break;
+            }
         }
 
         if (stop_requested_.load(std::memory_order_acquire) ||
@@ -93,25 +124,34 @@ result<void> event_loop::run() noexcept {
             break;
         }
 
-        if (ready_queue_.empty()) {
-            if (active_task_count_ == 0 && pending_waiter_count_ == 0) {
+        run_drain_hooks();
+
+        // A spent budget still polls, without blocking, so I/O that became
+        // ready meanwhile is not stuck behind coroutines that stay ready.
+        const bool starving = budget_spent && !ready_queue_.empty();
+        if (starving) {
+            recorder_.budget_spent();
+        }
+        if (ready_queue_.empty() || starving) {
+            if (!starving && active_task_count_ == 0 &&
+                pending_waiter_count_ == 0 && external_hold_count_ == 0) {
                 break;
             }
 
-            if (pending_waiter_count_ == 0) {
+            if (!starving && pending_waiter_count_ == 0 &&
+                external_hold_count_ == 0) {
                 return err<void>(make_error_from_errno(EDEADLK));
             }
 
             int timeout_ms = -1;
-            if (next_deadline_.has_value()) {
+            if (const auto next_expiry = timers_.next_expiry()) {
                 const auto now = std::chrono::steady_clock::now();
-                const auto remaining = next_deadline_.value() - now;
+                const auto remaining = next_expiry.value() - now;
                 if (remaining <= std::chrono::milliseconds{0}) {
                     timeout_ms = 0;
                 } else {
                     const auto clamped = std::min<long long>(
-                        std::chrono::duration_cast<std::chrono::milliseconds>(
-                            remaining)
+                        std::chrono::ceil<std::chrono::milliseconds>(remaining)
                             .count(),
                         static_cast<long long>(
                             std::numeric_limits<int>::max()));
@@ -119,18 +159,27 @@ result<void> event_loop::run() noexcept {
                 }
             }
 
-            const auto wait_result =
-                reactor_.wait(events, std::chrono::milliseconds{timeout_ms});
+            if (!drain_hooks_.empty() || starving) {
+                timeout_ms = 0;
+            }
+
+            recorder_.begin_wait();
+            const auto wait_result = wait_for_events(timeout_ms);
             if (!wait_result.has_value()) {
                 return err<void>(wait_result.error());
             }
+            recorder_.waited(wait_result.value());
 
             for (std::size_t i = 0; i < wait_result.value(); ++i) {
-                process_ready_event(events[i]);
+                process_ready_event(events_[i]);
                 if (loop_error_.has_value()) {
                     break;
                 }
             }
+            note_batch(wait_result.value());
+            if (recorder_.publish_due(false)) {
+                publish_metrics();
+            }
         }
     }
 
@@ -144,6 +193,123 @@ result<void> event_loop::run() noexcept {
 
 void event_loop::stop() noexcept {
     stop_requested_.store(true, std::memory_order_release);
+    signal_wakeup();
+}
+
+void event_loop::set_busy_poll(std::chrono::microseconds max_spin) noexcept {
+    max_spin_ = std::max(max_spin, std::chrono::microseconds{0});
+    stats_.spin_budget = max_spin_;
+}
+
+result<void> event_loop::set_kernel_busy_poll(std::chrono::microseconds usecs,
+                                              std::uint16_t budget,
+                                              bool prefer) noexcept {
+    if (!valid()) {
+        return err<void>(init_error_.value_or(make_error_from_errno(EINVAL)));
+    }
+    return reactor_.set_busy_poll(usecs, budget, prefer);
+}
+
+void event_loop::set_poll_batch(std::size_t size,
+                                std::size_t max_size) noexcept {
+    size = std::max<std::size_t>(size, 1);
+    events_.resize(size);
+    max_poll_batch_ = std::max(size, max_size);
+    stats_.poll_batch = size;
+}
+
+void event_loop::note_batch(std::size_t ready) noexcept {
+    if (ready < events_.size()) {
+        return;
+    }
+    ++stats_.full_batches;
+    if (events_.size() < max_poll_batch_) {
+        events_.resize(std::min(events_.size() * 2, max_poll_batch_));
+        stats_.poll_batch = events_.size();
+    }
+}
+
+loop_stats event_loop::stats() const noexcept {
+    return stats_;
+}
+
+loop_metrics event_loop::metrics() const noexcept {
+    return recorder_.snapshot(pending_waiter_count_, timers_.size());
+}
+
+void event_loop::set_latency_sampling(bool on) noexcept {
+    recorder_.set_sampling(on);
+}
+
+void event_loop::set_metrics_hook(metrics_hook *hook) noexcept {
+    recorder_.set_hook(hook);
+}
+
+void event_loop::set_resume_budget(std::size_t max_resumes,
+                                   std::chrono::microseconds max_time) noexcept {
+    budget_.set(max_resumes, max_time);
+}
+
+void event_loop::set_watchdog(watchdog_hook *hook) noexcept {
+    watch_.set_hook(hook);
+}
+
+const loop_heartbeat& event_loop::heartbeat() const noexcept {
+    return watch_.heartbeat();
+}
+
+void event_loop::publish_metrics() noexcept {
+    recorder_.publish(pending_waiter_count_, timers_.size());
+}
+
+result<std::size_t> event_loop::wait_for_events(int timeout_ms) noexcept {
+    const std::span events{events_};
+    ++stats_.iterations;
+    if (timeout_ms == 0 || max_spin_.count() == 0) {
+        if (timeout_ms != 0) {
+            ++stats_.blocking_waits;
+        }
+        return reactor_.wait(events, std::chrono::milliseconds{timeout_ms});
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto spin_until = start + stats_.spin_budget;
+    if (timeout_ms > 0) {
+        spin_until =
+            std::min(spin_until, start + std::chrono::milliseconds{timeout_ms});
+    }
+
+    auto now = start;
+    do {
+        ++stats_.spin_polls;
+        auto polled = reactor_.wait(events, std::chrono::milliseconds{0});
+        now = std::chrono::steady_clock::now();
+        if (!polled.has_value() || polled.value() > 0) {
+            stats_.spin_time += now - start;
+            if (polled.has_value()) {
+                ++stats_.spin_hits;
+                stats_.spin_budget = std::min(stats_.spin_budget * 2, max_spin_);
+            }
+            return polled;
+        }
+    } while (now < spin_until);
+
+    stats_.spin_time += now - start;
+    stats_.spin_budget =
+        std::max({stats_.spin_budget / 2, max_spin_ / 16,
+                  std::chrono::microseconds{1}});
+
+    ++stats_.blocking_waits;
+    if (timeout_ms < 0) {
+        return reactor_.wait(events, std::chrono::milliseconds{-1});
+    }
+    const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+        start + std::chrono::milliseconds{timeout_ms} - now);
+    return reactor_.wait(events,
+                         std::max(left, std::chrono::milliseconds{0}));
+}
+
+void event_loop::signal_wakeup() noexcept {
     if (!wake_fd_.valid()) {
         return;
     }
@@ -167,234 +333,331 @@ void event_loop::schedule(std::coroutine_handle<> handle) noexcept {
     ready_queue_.push_back(handle);
 }
 
-void event_loop::on_task_completed() noexcept {
+void event_loop::on_task_completed(detail::task_link& root) noexcept {
+    live_roots_.erase(root);
+    finished_roots_.push(root);
+    if (active_task_count_ > 0) {
+        --active_task_count_;
+    }
+}
+
+void event_loop::on_detached_completed(detail::task_link& root) noexcept {
+    live_roots_.erase(root);
     if (active_task_count_ > 0) {
         --active_task_count_;
     }
 }
 
 result<void>
-event_loop::wait_for_readable(int fd, std::coroutine_handle<> handle,
-                              std::optional<std::chrono::milliseconds> timeout,
+event_loop::wait_for_readable(int fd, wait_operation& operation,
+                              std::optional<std::chrono::steady_clock::time_point>
+                                  deadline,
                               error timeout_error) noexcept {
-    return arm_waiter(fd, handle, true, timeout, timeout_error);
+    return arm_waiter(fd, operation, true, deadline, timeout_error);
 }
 
 result<void>
-event_loop::wait_for_writable(int fd, std::coroutine_handle<> handle,
-                              std::optional<std::chrono::milliseconds> timeout,
+event_loop::wait_for_writable(int fd, wait_operation& operation,
+                              std::optional<std::chrono::steady_clock::time_point>
+                                  deadline,
                               error timeout_error) noexcept {
-    return arm_waiter(fd, handle, false, timeout, timeout_error);
+    return arm_waiter(fd, operation, false, deadline, timeout_error);
 }
 
 result<void>
-event_loop::consume_wait_result(std::coroutine_handle<> handle) noexcept {
-    if (!handle) {
+event_loop::schedule_at(std::chrono::steady_clock::time_point deadline,
+                        timer_operation& operation) noexcept {
+    if (!valid()) {
+        return err<void>(init_error_.value_or(make_error_from_errno(EINVAL)));
+    }
+    if (!operation.handle) {
         return err<void>(make_error_from_errno(EINVAL));
     }
+    if (operation.entry.scheduled()) {
+        return err<void>(make_error_from_errno(EBUSY));
+    }
 
-    const auto key = handle_key(handle);
-    auto it = wait_results_.find(key);
-    if (it == wait_results_.end()) {
-        return ok();
+    operation.result = 0;
+    operation.entry.context = &operation;
+    operation.entry.tag = kScheduledTimerTag;
+    timers_.schedule(operation.entry, deadline);
+    ++pending_waiter_count_;
+    return ok();
+}
+
+bool event_loop::cancel_timer(timer_operation& operation) noexcept {
+    if (!operation.entry.scheduled()) {
+        return false;
     }
 
-    auto status = std::move(it->second);
-    wait_results_.erase(it);
-    return status;
+    timers_.cancel(operation.entry);
+    if (pending_waiter_count_ > 0) {
+        --pending_waiter_count_;
+    }
+    operation.result = -ECANCELED;
+    schedule(operation.handle);
+    return true;
+}
+
+void event_loop::abandon_timer(timer_operation& operation) noexcept {
+    if (!operation.entry.scheduled()) {
+        return;
+    }
+
+    timers_.cancel(operation.entry);
+    if (pending_waiter_count_ > 0) {
+        --pending_waiter_count_;
+    }
+}
+
+bool event_loop::cancel_wait(int fd, bool readable,
+                             wait_operation& operation) noexcept {
+    auto *slot = waiters_.find(fd);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    auto& registration = readable ? slot->readable : slot->writable;
+    if (registration != &operation) {
+        return false;
+    }
+    fail_registration(registration, make_error_from_errno(ECANCELED));
+    return true;
+}
+
+void event_loop::post_wakeup(remote_wakeup& wakeup) noexcept {
+    if (remote_wakeups_.push(wakeup)) {
+        signal_wakeup();
+    }
+}
+
+void event_loop::withdraw_wakeup(remote_wakeup& wakeup) noexcept {
+    remote_wakeups_.withdraw(wakeup);
+}
+
+bool event_loop::defer_to_drain(drain_hook& hook) noexcept {
+    drain_hooks_.push(hook);
+    return true;
+}
+
+void event_loop::withdraw_drain_hook(drain_hook& hook) noexcept {
+    drain_hooks_.withdraw(hook);
+}
+
+bool event_loop::post_work(posted_work& work) noexcept {
+    if (posted_.push(work)) {
+        signal_wakeup();
+    }
+    return true;
+}
+
+void event_loop::retain_external() noexcept {
+    ++external_hold_count_;
+}
+
+void event_loop::release_external() noexcept {
+    if (external_hold_count_ > 0) {
+        --external_hold_count_;
+    }
 }
 
 result<void>
-event_loop::arm_waiter(int fd, std::coroutine_handle<> handle, bool readable,
-                       std::optional<std::chrono::milliseconds> timeout,
+event_loop::arm_waiter(int fd, wait_operation& operation, bool readable,
+                       std::optional<std::chrono::steady_clock::time_point> deadline,
                        error timeout_error) noexcept {
     if (!valid()) {
         return err<void>(init_error_.value_or(make_error_from_errno(EINVAL)));
     }
-    if (fd < 0 || !handle) {
+    if (fd < 0 || !operation.handle) {
         return err<void>(make_error_from_errno(EBADF));
     }
 
-    if (timeout.has_value() &&
-        timeout.value() <= std::chrono::milliseconds{0}) {
-        wait_results_[handle_key(handle)] = err<void>(timeout_error);
-        schedule(handle);
+    operation.status = ok();
+    if (deadline.has_value() &&
+        deadline.value() <= std::chrono::steady_clock::now()) {
+        operation.status = err<void>(timeout_error);
+        schedule(operation.handle);
         return ok();
     }
 
-    auto [it, inserted] = waiters_.try_emplace(fd);
-    auto& slot = it->second;
+    auto *slot_ptr = waiters_.get_or_create(fd);
+    if (slot_ptr == nullptr) {
+        return err<void>(make_error_from_errno(ENOMEM));
+    }
+    auto& slot = *slot_ptr;
     auto& target_registration = readable ? slot.readable : slot.writable;
-    if (target_registration.handle) {
+    if (target_registration != nullptr) {
         return err<void>(make_error_from_errno(EBUSY));
     }
 
-    target_registration.handle = handle;
-    target_registration.timeout_error = timeout_error;
-    if (timeout.has_value()) {
-        target_registration.deadline =
-            std::chrono::steady_clock::now() + timeout.value();
-        ++timed_waiter_count_;
-        if (!next_deadline_.has_value() ||
-            target_registration.deadline.value() < next_deadline_.value()) {
-            next_deadline_ = target_registration.deadline.value();
+    // An edge reported while nobody waited completes the wait with no
+    // syscall, unless the caller has hit `EAGAIN` since and so already
+    // consumed it.
+    auto& seen_edge = readable ? slot.read_edge : slot.write_edge;
+    if (slot.registered && seen_edge) {
+        seen_edge = false;
+        if (!operation.after_would_block) {
+            schedule(operation.handle);
+            return ok();
         }
-    } else {
-        target_registration.deadline.reset();
     }
-    deadline_index_dirty_ = true;
+
+    target_registration = &operation;
+    operation.fd = fd;
+    operation.readable = readable;
+    operation.timer.context = &operation;
+    operation.timer.tag = kWaiterTimerTag;
+    if (deadline.has_value()) {
+        // Expiry just completes the wait; readiness overwrites this.
+        operation.status = err<void>(timeout_error);
+        timers_.schedule(operation.timer, deadline.value());
+    }
 
     ++pending_waiter_count_;
-    const auto refresh_result = refresh_interest(fd, slot);
-    if (!refresh_result.has_value()) {
-        if (target_registration.deadline.has_value() &&
-            timed_waiter_count_ > 0) {
-            --timed_waiter_count_;
-        }
-        target_registration = wait_registration{};
-        deadline_index_dirty_ = true;
+    const auto register_result =
+        ensure_registered(fd, slot, operation.owned_fd);
+    if (!register_result.has_value()) {
+        operation.status = ok();
+        release_registration(target_registration);
         if (pending_waiter_count_ > 0) {
             --pending_waiter_count_;
         }
-        if (!slot.readable.handle && !slot.writable.handle) {
-            waiters_.erase(it);
-        }
-        return refresh_result;
+        return register_result;
     }
 
     return ok();
 }
 
-result<void> event_loop::refresh_interest(int fd, waiter_slot& slot) noexcept {
-    const bool has_read_waiter = static_cast<bool>(slot.readable.handle);
-    const bool has_write_waiter = static_cast<bool>(slot.writable.handle);
-
-    std::uint32_t desired_mask = 0;
-    if (has_read_waiter || has_write_waiter) {
-        desired_mask = kCommonFlags;
-        if (has_read_waiter) {
-            desired_mask |= EPOLLIN;
-        }
-        if (has_write_waiter) {
-            desired_mask |= EPOLLOUT;
-        }
-    }
-
-    if (slot.registered_mask == desired_mask) {
+result<void> event_loop::ensure_registered(int fd, waiter_slot& slot,
+                                           bool owned) noexcept {
+    if (slot.registered) {
+        // An owned wait vouches that the close will be observed.
+        slot.transient = slot.transient && !owned;
         return ok();
     }
 
-    if (slot.registered_mask == 0 && desired_mask != 0) {
-        const auto add_result = reactor_.add(fd, desired_mask);
-        if (!add_result.has_value()) {
-            return add_result;
-        }
-        slot.registered_mask = desired_mask;
-        return ok();
-    }
-
-    if (slot.registered_mask != 0 && desired_mask == 0) {
-        const auto remove_result = reactor_.remove(fd);
-        if (!remove_result.has_value()) {
-            return remove_result;
-        }
-        slot.registered_mask = 0;
-        return ok();
-    }
-
-    const auto modify_result = reactor_.modify(fd, desired_mask);
-    if (!modify_result.has_value()) {
-        return modify_result;
-    }
-    slot.registered_mask = desired_mask;
+    ++stats_.interest_updates;
+    recorder_.interest_updated();
+    auto add_result = reactor_.add(fd, kPersistentMask);
+    if (!add_result.has_value() && add_result.error().value() == EEXIST) {
+        // Still registered from before `forget_idle_registrations()`; the
+        // modify re-arms the edge so nothing that happened since is lost.
+        ++stats_.interest_updates;
+        recorder_.interest_updated();
+        add_result = reactor_.modify(fd, kPersistentMask);
+    }
+    if (!add_result.has_value()) {
+        return add_result;
+    }
+    slot.registered = true;
+    // A raw descriptor may be closed with `::close()` behind the close
+    // listener's back, after which the kernel has dropped the registration
+    // and the number can be reused. Keep it only while a wait needs it.
+    slot.transient = !owned;
+    slot.read_edge = false;
+    slot.write_edge = false;
     return ok();
 }
 
-void event_loop::process_expired_waiters() noexcept {
-    if (timed_waiter_count_ == 0) {
-        next_deadline_.reset();
-        deadline_index_dirty_ = false;
+void event_loop::drop_transient_registration(int fd) noexcept {
+    auto *slot = waiters_.find(fd);
+    if (slot == nullptr || !slot->transient || slot->readable != nullptr ||
+        slot->writable != nullptr) {
         return;
     }
 
-    const auto now = std::chrono::steady_clock::now();
-    if (!deadline_index_dirty_ && next_deadline_.has_value() &&
-        now < next_deadline_.value()) {
+    ++stats_.interest_updates;
+    recorder_.interest_updated();
+    (void)reactor_.remove(fd);
+    slot->registered = false;
+    slot->transient = false;
+    slot->read_edge = false;
+    slot->write_edge = false;
+}
+
+void event_loop::on_descriptor_closed(
+    simplenet::detail::close_listener& listener, int fd) noexcept {
+    auto& self = *static_cast<event_loop *>(listener.context);
+    auto *slot = self.waiters_.find(fd);
+    if (slot == nullptr || !slot->registered) {
         return;
     }
 
-    auto next_deadline = std::chrono::steady_clock::time_point::max();
-    bool has_next_deadline = false;
-
-    for (auto it = waiters_.begin(); it != waiters_.end();) {
-        bool changed = false;
+    // A duplicate of the descriptor would otherwise keep reporting into
+    // the slot that the number's next owner gets.
+    ++self.stats_.interest_updates;
+    self.recorder_.interest_updated();
+    (void)self.reactor_.remove(fd);
+    slot->registered = false;
+    slot->transient = false;
+    slot->read_edge = false;
+    slot->write_edge = false;
+}
 
-        if (it->second.readable.handle &&
-            it->second.readable.deadline.has_value() &&
-            now >= it->second.readable.deadline.value()) {
-            wait_results_[handle_key(it->second.readable.handle)] =
-                err<void>(it->second.readable.timeout_error);
-            schedule(it->second.readable.handle);
-            if (timed_waiter_count_ > 0) {
-                --timed_waiter_count_;
-            }
-            it->second.readable = wait_registration{};
-            if (pending_waiter_count_ > 0) {
-                --pending_waiter_count_;
-            }
-            changed = true;
+void event_loop::forget_idle_registrations() noexcept {
+    waiters_.for_each([](waiter_slot& slot) {
+        if (slot.readable == nullptr && slot.writable == nullptr) {
+            slot.registered = false;
+            slot.read_edge = false;
+            slot.write_edge = false;
         }
+    });
+}
 
-        if (it->second.writable.handle &&
-            it->second.writable.deadline.has_value() &&
-            now >= it->second.writable.deadline.value()) {
-            wait_results_[handle_key(it->second.writable.handle)] =
-                err<void>(it->second.writable.timeout_error);
-            schedule(it->second.writable.handle);
-            if (timed_waiter_count_ > 0) {
-                --timed_waiter_count_;
-            }
-            it->second.writable = wait_registration{};
-            if (pending_waiter_count_ > 0) {
-                --pending_waiter_count_;
-            }
-            changed = true;
-        }
+void event_loop::process_expired_waiters() noexcept {
+    if (timers_.empty()) {
+        return;
+    }
 
-        if (changed) {
-            const auto refresh_result = refresh_interest(it->first, it->second);
-            if (!refresh_result.has_value()) {
-                loop_error_ = refresh_result.error();
-                stop_requested_.store(true, std::memory_order_release);
+    const auto fired = timers_.expire(
+        std::chrono::steady_clock::now(), [this](timer_entry& entry) {
+            if (entry.tag == kScheduledTimerTag) {
+                auto& operation = *static_cast<timer_operation*>(entry.context);
+                if (pending_waiter_count_ > 0) {
+                    --pending_waiter_count_;
+                }
+                operation.result = 0;
+                schedule(operation.handle);
                 return;
             }
-        }
-
-        if (!it->second.readable.handle && !it->second.writable.handle) {
-            it = waiters_.erase(it);
-        } else {
-            if (it->second.readable.handle &&
-                it->second.readable.deadline.has_value()) {
-                next_deadline =
-                    std::min(next_deadline, it->second.readable.deadline.value());
-                has_next_deadline = true;
-            }
-            if (it->second.writable.handle &&
-                it->second.writable.deadline.has_value()) {
-                next_deadline =
-                    std::min(next_deadline, it->second.writable.deadline.value());
-                has_next_deadline = true;
+            // The status already holds the timeout error.
+            auto& waiter = *static_cast<wait_operation*>(entry.context);
+            auto *slot = waiters_.find(waiter.fd);
+            if (slot != nullptr && !loop_error_.has_value()) {
+                complete_registration(waiter.readable ? slot->readable
+                                                      : slot->writable);
             }
-            ++it;
-        }
+        });
+    recorder_.timeouts_fired(fired);
+}
+
+void event_loop::fail_registration(wait_operation *& registration,
+                                   error reason) noexcept {
+    if (loop_error_.has_value() || registration == nullptr) {
+        return;
     }
 
-    if (has_next_deadline) {
-        next_deadline_ = next_deadline;
-    } else {
-        next_deadline_.reset();
+    registration->status = err<void>(reason);
+    complete_registration(registration);
+}
+
+void event_loop::complete_registration(wait_operation *& registration) noexcept {
+    if (registration == nullptr) {
+        return;
+    }
+
+    schedule(registration->handle);
+    release_registration(registration);
+    if (pending_waiter_count_ > 0) {
+        --pending_waiter_count_;
     }
-    deadline_index_dirty_ = false;
+}
+
+void event_loop::release_registration(wait_operation *& registration) noexcept {
+    const int fd = registration->fd;
+    timers_.cancel(registration->timer);
+    registration = nullptr;
+    drop_transient_registration(fd);
 }
 
 void event_loop::consume_wakeup() noexcept {
@@ -406,82 +669,107 @@ void event_loop::consume_wakeup() noexcept {
     while (::read(wake_fd_.get(), &signal, sizeof(signal)) < 0 && errno == EINTR) {}
 }
 
+void event_loop::run_remote_wakeups() noexcept {
+    // Only the wake-ups queued on entry: one that re-posts itself runs again
+    // after this iteration's I/O instead of starving it.
+    for (auto pending = remote_wakeups_.size(); pending > 0; --pending) {
+        auto *wakeup = remote_wakeups_.pop();
+        if (wakeup == nullptr) {
+            return;
+        }
+        wakeup->run(*wakeup);
+    }
+    if (!remote_wakeups_.empty()) {
+        signal_wakeup();
+    }
+}
+
+void event_loop::run_drain_hooks() noexcept {
+    // Only the hooks queued on entry, so one that defers itself again
+    // cannot keep the loop from polling.
+    for (auto pending = drain_hooks_.size(); pending > 0; --pending) {
+        auto *hook = drain_hooks_.pop();
+        if (hook == nullptr) {
+            return;
+        }
+        hook->run(*hook);
+    }
+}
+
+void event_loop::run_posted_work() noexcept {
+    posted_.rearm();
+    for (std::size_t ran = 0; ran < kPostedBatch; ++ran) {
+        auto *work = posted_.pop();
+        if (work == nullptr) {
+            return;
+        }
+        work->complete(*work, true);
+    }
+    // Batch cut short: make sure the rest gets another iteration.
+    if (posted_.claim_signal()) {
+        signal_wakeup();
+    }
+}
+
 void event_loop::process_ready_event(
-    const simplenet::epoll::ready_event& event) noexcept {
-    if (wake_fd_.valid() && event.fd == wake_fd_.get()) {
+    const ::epoll_event& event) noexcept {
+    const int fd = event.data.fd;
+    if (wake_fd_.valid() && fd == wake_fd_.get()) {
         consume_wakeup();
         return;
     }
 
-    auto it = waiters_.find(event.fd);
-    if (it == waiters_.end()) {
+    auto *slot_ptr = waiters_.find(fd);
+    if (slot_ptr == nullptr) {
         return;
     }
 
-    auto& slot = it->second;
+    auto& slot = *slot_ptr;
 
-    if (slot.readable.handle &&
-        simplenet::epoll::has_event(event.events, kReadReadyMask)) {
-        wait_results_[handle_key(slot.readable.handle)] = ok();
-        schedule(slot.readable.handle);
-        if (slot.readable.deadline.has_value() && timed_waiter_count_ > 0) {
-            --timed_waiter_count_;
-            deadline_index_dirty_ = true;
-        }
-        slot.readable = wait_registration{};
-        if (pending_waiter_count_ > 0) {
-            --pending_waiter_count_;
+    if (simplenet::epoll::has_event(event.events, kReadReadyMask)) {
+        if (slot.readable != nullptr) {
+            slot.readable->status = ok();
+            complete_registration(slot.readable);
+        } else {
+            slot.read_edge = slot.registered;
         }
     }
 
-    if (slot.writable.handle &&
-        simplenet::epoll::has_event(event.events, kWriteReadyMask)) {
-        wait_results_[handle_key(slot.writable.handle)] = ok();
-        schedule(slot.writable.handle);
-        if (slot.writable.deadline.has_value() && timed_waiter_count_ > 0) {
-            --timed_waiter_count_;
-            deadline_index_dirty_ = true;
-        }
-        slot.writable = wait_registration{};
-        if (pending_waiter_count_ > 0) {
-            --pending_waiter_count_;
+    if (simplenet::epoll::has_event(event.events, kWriteReadyMask)) {
+        if (slot.writable != nullptr) {
+            slot.writable->status = ok();
+            complete_registration(slot.writable);
+        } else {
+            slot.write_edge = slot.registered;
         }
     }
-
-    const auto refresh_result = refresh_interest(event.fd, slot);
-    if (!refresh_result.has_value()) {
-        loop_error_ = refresh_result.error();
-        stop_requested_.store(true, std::memory_order_release);
-        return;
-    }
-
-    if (!slot.readable.handle && !slot.writable.handle) {
-        waiters_.erase(it);
-    }
 }
 
-std::uintptr_t event_loop::handle_key(std::coroutine_handle<> handle) noexcept {
-    return reinterpret_cast<std::uintptr_t>(handle.address());
+void event_loop::cleanup_completed_roots() noexcept {
+    // Only roots that reached final suspend are listed, so this is O(1)
+    // per finished root and free when none finished.
+    destroy_roots(finished_roots_);
 }
 
-void event_loop::cleanup_completed_roots() noexcept {
-    for (auto it = root_tasks_.begin(); it != root_tasks_.end(); ) {
-        if (it->done()) {
-            it->destroy();
-            it = root_tasks_.erase(it);
-        } else {
-            ++it;
-        }
+void event_loop::destroy_roots(detail::task_list& roots) noexcept {
+    while (!roots.empty()) {
+        auto& root = *roots.front();
+        roots.erase(root);
+        root.frame.destroy();
     }
 }
 
 void event_loop::destroy_all_roots() noexcept {
-    for (auto handle : root_tasks_) {
-        if (handle) {
-            handle.destroy();
+    // Unhook armed deadlines while the frames holding them still exist.
+    waiters_.for_each([this](waiter_slot& slot) {
+        for (auto *registration : {&slot.readable, &slot.writable}) {
+            if (*registration != nullptr) {
+                release_registration(*registration);
+            }
         }
-    }
-    root_tasks_.clear();
+    });
+    destroy_roots(live_roots_);
+    destroy_roots(finished_roots_);
 }
 
 } // namespace simplenet::runtime
@@ -0,0 +1,136 @@
+#include "simplenet/runtime/frame_pool.hpp"
+
+#include <array>
+#include <new>
+#include <utility>
+
+namespace {
+
+using simplenet::runtime::frame_pool_granularity;
+using simplenet::runtime::frame_pool_max_size;
+
+constexpr std::size_t kClassCount = frame_pool_max_size / frame_pool_granularity;
+
+/// Upper bound on frames kept per size class and thread.
+constexpr std::size_t kClassCapacity = 256;
+
+/// Free-list link stored in the first bytes of a parked frame.
+struct free_frame {
+    free_frame *next{nullptr};
+};
+
+/// One free list per size class.
+struct frame_class {
+    free_frame *head{nullptr};
+    std::size_t size{0};
+};
+
+/// Per-thread cache of released frames.
+struct frame_cache {
+    std::array<frame_class, kClassCount> classes{};
+    simplenet::runtime::frame_pool_stats stats{};
+
+    ~frame_cache();
+    void trim() noexcept;
+};
+
+/// Trivially destructible, so it stays readable while `cache` is torn down.
+thread_local constinit bool cache_retired = false;
+thread_local frame_cache cache{};
+
+constexpr std::size_t class_index(std::size_t size) noexcept {
+    return (size - 1) / frame_pool_granularity;
+}
+
+constexpr std::size_t class_bytes(std::size_t index) noexcept {
+    return (index + 1) * frame_pool_granularity;
+}
+
+frame_cache::~frame_cache() {
+    cache_retired = true;
+    trim();
+}
+
+void frame_cache::trim() noexcept {
+    for (std::size_t index = 0; index < classes.size(); ++index) {
+        auto& bucket = classes[index];
+        while (bucket.head != nullptr) {
+            auto *frame = std::exchange(bucket.head, bucket.head->next);
+            ::operator delete(frame, class_bytes(index));
+        }
+        bucket.size = 0;
+    }
+    stats.cached_frames = 0;
+    stats.cached_bytes = 0;
+}
+
+} // namespace
+
+namespace simplenet::runtime {
+
+frame_pool_stats frame_pool_thread_stats() noexcept {
+    if (cache_retired) {
+        return {};
+    }
+    return cache.stats;
+}
+
+void frame_pool_trim() noexcept {
+    if (!cache_retired) {
+        cache.trim();
+    }
+}
+
+namespace detail {
+
+void *allocate_frame(std::size_t size) {
+    if (size == 0 || size > frame_pool_max_size) {
+        if (!cache_retired) {
+            ++cache.stats.allocations;
+            ++cache.stats.oversized;
+        }
+        return ::operator new(size);
+    }
+
+    const auto index = class_index(size);
+    if (cache_retired) {
+        return ::operator new(class_bytes(index));
+    }
+
+    ++cache.stats.allocations;
+    auto& bucket = cache.classes[index];
+    if (bucket.head == nullptr) {
+        return ::operator new(class_bytes(index));
+    }
+
+    auto *frame = std::exchange(bucket.head, bucket.head->next);
+    --bucket.size;
+    ++cache.stats.reuses;
+    --cache.stats.cached_frames;
+    cache.stats.cached_bytes -= class_bytes(index);
+    frame->~free_frame();
+    return frame;
+}
+
+void deallocate_frame(void *frame, std::size_t size) noexcept {
+    if (size == 0 || size > frame_pool_max_size) {
+        ::operator delete(frame, size);
+        return;
+    }
+
+    const auto index = class_index(size);
+    if (cache_retired || cache.classes[index].size == kClassCapacity) {
+        ::operator delete(frame, class_bytes(index));
+        return;
+    }
+
+    auto& bucket = cache.classes[index];
+    bucket.head = ::new (frame) free_frame{bucket.head};
+    ++bucket.size;
+    ++cache.stats.cached_frames;
+    cache.stats.cached_bytes += class_bytes(index);
+}
+
+} // namespace detail
+
+} // namespace simplenet::runtime
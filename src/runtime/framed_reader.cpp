@@ -0,0 +1,280 @@
+#include "simplenet/runtime/framed_reader.hpp"
+
+#include "simplenet/runtime/io_ops.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace simplenet::runtime {
+
+namespace {
+
+using decoded = result<std::optional<frame_extent>>;
+
+/// A complete frame of `header + payload + trailer` bytes, if all arrived.
+decoded frame_if_buffered(std::span<const std::byte> bytes, std::size_t header,
+                          std::size_t payload, std::size_t trailer = 0) noexcept {
+    if (bytes.size() - header < payload + trailer) {
+        return std::optional<frame_extent>{};
+    }
+    return std::optional<frame_extent>{
+        frame_extent{.header = header, .payload = payload, .trailer = trailer}};
+}
+
+/**
+ * Verify candidate starts in `mask`, bit `n` being `haystack[base + n]`.
+ * @return The offset of the first full match, or `haystack.size()`.
+ */
+[[maybe_unused]] std::size_t match_candidates(std::span<const std::byte> haystack,
+                                              std::span<const std::byte> needle,
+                                              std::size_t base,
+                                              std::uint32_t mask) noexcept {
+    while (mask != 0U) {
+        const auto start = base + static_cast<std::size_t>(std::countr_zero(mask));
+        // First and last bytes already matched; compare the middle.
+        if (std::memcmp(haystack.data() + start + 1U, needle.data() + 1U,
+                        needle.size() - 2U) == 0) {
+            return start;
+        }
+        mask &= mask - 1U;
+    }
+    return haystack.size();
+}
+
+/// Byte-at-a-time search of `haystack[from..)`.
+std::size_t find_scalar(std::span<const std::byte> haystack,
+                        std::span<const std::byte> needle, std::size_t from) noexcept {
+    while (from + needle.size() <= haystack.size()) {
+        const void *hit = std::memchr(haystack.data() + from,
+                                      std::to_integer<int>(needle.front()),
+                                      haystack.size() - from - needle.size() + 1U);
+        if (hit == nullptr) {
+            break;
+        }
+        const auto start =
+            static_cast<std::size_t>(static_cast<const std::byte *>(hit) - haystack.data());
+        if (std::memcmp(haystack.data() + start, needle.data(), needle.size()) == 0) {
+            return start;
+        }
+        from = start + 1U;
+    }
+    return haystack.size();
+}
+
+/**
+ * @return Offset of the first `needle` in `haystack`, or `haystack.size()`.
+ *
+ * Multi-byte needles compare the first and last needle bytes against a
+ * whole vector of candidate starts at once, so only real candidates reach
+ * `memcmp`; this stays fast even when the first byte alone is common.
+ * Single bytes go straight to the libc `memchr`, which is vectorised.
+ */
+std::size_t find_delimiter(std::span<const std::byte> haystack,
+                           std::span<const std::byte> needle) noexcept {
+    if (needle.size() == 1U || haystack.size() < needle.size()) {
+        return find_scalar(haystack, needle, 0);
+    }
+
+    std::size_t offset = 0;
+    [[maybe_unused]] const std::size_t last = needle.size() - 1U;
+#if defined(__AVX2__)
+    const __m256i first_wide = _mm256_set1_epi8(std::to_integer<char>(needle.front()));
+    const __m256i last_wide = _mm256_set1_epi8(std::to_integer<char>(needle.back()));
+    for (; offset + last + 32U <= haystack.size(); offset += 32U) {
+        const auto *at = haystack.data() + offset;
+        const __m256i starts =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(at));
+        const __m256i ends =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(at + last));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(starts, first_wide),
+                             _mm256_cmpeq_epi8(ends, last_wide))));
+        if (const auto found = match_candidates(haystack, needle, offset, mask);
+            found != haystack.size()) {
+            return found;
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i first_narrow = _mm_set1_epi8(std::to_integer<char>(needle.front()));
+    const __m128i last_narrow = _mm_set1_epi8(std::to_integer<char>(needle.back()));
+    for (; offset + last + 16U <= haystack.size(); offset += 16U) {
+        const auto *at = haystack.data() + offset;
+        const __m128i starts = _mm_loadu_si128(reinterpret_cast<const __m128i *>(at));
+        const __m128i ends =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(at + last));
+        const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(starts, first_narrow),
+                          _mm_cmpeq_epi8(ends, last_narrow))));
+        if (const auto found = match_candidates(haystack, needle, offset, mask);
+            found != haystack.size()) {
+            return found;
+        }
+    }
+#endif
+    return find_scalar(haystack, needle, offset);
+}
+
+} // namespace
+
+decoded length_prefix_decoder::decode(std::span<const std::byte> bytes) const noexcept {
+    if (header_size != 1U && header_size != 2U && header_size != 4U &&
+        header_size != 8U) {
+        return err<std::optional<frame_extent>>(make_error_from_errno(EINVAL));
+    }
+    if (bytes.size() < header_size) {
+        return std::optional<frame_extent>{};
+    }
+
+    std::uint64_t length = 0;
+    for (std::size_t index = 0; index < header_size; ++index) {
+        const auto octet = std::to_integer<std::uint64_t>(
+            bytes[big_endian ? index : header_size - 1U - index]);
+        length = (length << 8U) | octet;
+    }
+    if (length > max_payload) {
+        return err<std::optional<frame_extent>>(make_error_from_errno(EMSGSIZE));
+    }
+    return frame_if_buffered(bytes, header_size, static_cast<std::size_t>(length));
+}
+
+decoded varint_prefix_decoder::decode(std::span<const std::byte> bytes) const noexcept {
+    static constexpr std::size_t max_varint_bytes = 10;
+
+    std::uint64_t length = 0;
+    for (std::size_t index = 0; index < bytes.size(); ++index) {
+        if (index == max_varint_bytes) {
+            return err<std::optional<frame_extent>>(make_error_from_errno(EBADMSG));
+        }
+        const auto octet = std::to_integer<std::uint64_t>(bytes[index]);
+        length |= (octet & 0x7FU) << (7U * index);
+        if ((octet & 0x80U) != 0U) {
+            continue;
+        }
+        if (length > max_payload) {
+            return err<std::optional<frame_extent>>(make_error_from_errno(EMSGSIZE));
+        }
+        return frame_if_buffered(bytes, index + 1U, static_cast<std::size_t>(length));
+    }
+    return std::optional<frame_extent>{};
+}
+
+decoded delimiter_decoder::decode(std::span<const std::byte> bytes) noexcept {
+    if (delimiter.empty()) {
+        return err<std::optional<frame_extent>>(make_error_from_errno(EINVAL));
+    }
+
+    // A delimiter may straddle the old end, so back up by its length - 1.
+    const std::size_t from =
+        std::min(bytes.size(), searched - std::min(searched, delimiter.size() - 1U));
+    const auto found = find_delimiter(bytes.subspan(from), delimiter);
+    if (found == bytes.size() - from) {
+        searched = bytes.size();
+        if (bytes.size() > max_payload + delimiter.size() - 1U) {
+            return err<std::optional<frame_extent>>(make_error_from_errno(EMSGSIZE));
+        }
+        return std::optional<frame_extent>{};
+    }
+
+    searched = 0;
+    const auto payload = from + found;
+    if (payload > max_payload) {
+        return err<std::optional<frame_extent>>(make_error_from_errno(EMSGSIZE));
+    }
+    return frame_if_buffered(bytes, 0, payload, delimiter.size());
+}
+
+framed_reader::framed_reader(simplenet::nonblocking::tcp_stream& stream,
+                             framed_reader_options options)
+    : stream_(&stream), options_(options) {}
+
+std::span<const std::byte> framed_reader::buffered() const noexcept {
+    return std::span<const std::byte>{buffer_}.subspan(begin_ + pending_,
+                                                       end_ - begin_ - pending_);
+}
+
+std::size_t framed_reader::capacity() const noexcept {
+    return buffer_.size();
+}
+
+std::uint64_t framed_reader::reads() const noexcept {
+    return reads_;
+}
+
+void framed_reader::release() noexcept {
+    begin_ += std::exchange(pending_, 0U);
+    if (begin_ == end_) {
+        begin_ = 0;
+        end_ = 0;
+    }
+}
+
+result<std::optional<frame>> framed_reader::take(const frame_extent& extent) noexcept {
+    const auto view = buffered();
+    const std::size_t length = extent.header + extent.payload + extent.trailer;
+    if (length > view.size()) {
+        return err<std::optional<frame>>(make_error_from_errno(EINVAL));
+    }
+    pending_ = length;
+    return std::optional<frame>{frame{
+        .payload = view.subspan(extent.header, extent.payload),
+        .bytes = view.first(length)}};
+}
+
+task<result<std::size_t>> framed_reader::fill() {
+    if (options_.release_when_idle && begin_ == end_ && !buffer_.empty()) {
+        buffer_ = {};
+    }
+    if (buffer_.empty()) {
+        if (options_.release_when_idle) {
+            readable_operation wait{*stream_};
+            auto readable = co_await wait;
+            if (!readable.has_value()) {
+                co_return err<std::size_t>(readable.error());
+            }
+        }
+        buffer_.resize(std::max<std::size_t>(
+            std::min(options_.initial_capacity, options_.max_capacity), 1U));
+    }
+
+    // Slide the unread tail down once less than a quarter is left free, so
+    // reads stay large without moving bytes on every call.
+    const std::size_t free_tail = buffer_.size() - end_;
+    if (begin_ > 0U && free_tail < buffer_.size() / 4U) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if (end_ == buffer_.size()) {
+        if (buffer_.size() >= options_.max_capacity) {
+            co_return err<std::size_t>(make_error_from_errno(EMSGSIZE));
+        }
+        buffer_.resize(std::min(buffer_.size() * 2U, options_.max_capacity));
+    }
+
+    ++reads_;
+    const auto received = co_await async_read_some(
+        *stream_, std::span{buffer_}.subspan(end_));
+    if (received.has_value()) {
+        end_ += received.value();
+    }
+    co_return received;
+}
+
+task<result<std::optional<frame>>>
+async_read_until(framed_reader& reader, std::string_view delimiter,
+                 std::size_t max_line) {
+    delimiter_decoder decoder{
+        .delimiter = std::as_bytes(std::span{delimiter.data(), delimiter.size()}),
+        .max_payload = max_line};
+    co_return co_await reader.next(decoder);
+}
+
+} // namespace simplenet::runtime
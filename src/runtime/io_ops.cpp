@@ -1,38 +1,53 @@
 #include "simplenet/runtime/io_ops.hpp"
 
+#include "simplenet/epoll/reactor.hpp"
+#include "simplenet/runtime/op_latency.hpp"
+#include "simplenet/runtime/steady_timer.hpp"
+
+#include "loop_cancellation.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <chrono>
+#include <climits>
+#include <cstddef>
+#include <fcntl.h>
+#include <netinet/in.h>
 #include <optional>
-#include <sys/timerfd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
 #include <unistd.h>
+#include <vector>
 
 namespace {
 
 using namespace std::chrono_literals;
 
-[[nodiscard]] int get_sleep_timerfd() noexcept {
-    struct SleepTimerFd {
-        simplenet::unique_fd fd{};
-        SleepTimerFd() {
-            const int raw =
-                ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
-            if (raw >= 0) {
-                fd = simplenet::unique_fd{raw};
-            }
-        }
-    };
-    thread_local SleepTimerFd state{};
-    return state.fd.get();
-}
+/// What a readiness wait knows about its descriptor.
+enum class wait_kind {
+    /// Any descriptor, for any reason.
+    plain,
+    /// Right after `EAGAIN` on a descriptor the caller does not own.
+    raw_retry,
+    /// Right after `EAGAIN` on a descriptor a `unique_fd` owns.
+    retry,
+};
 
 class readiness_wait_awaitable {
 public:
-    readiness_wait_awaitable(int fd, bool readable,
-                             std::optional<std::chrono::milliseconds> timeout,
-                             simplenet::error timeout_error) noexcept
-        : fd_(fd), readable_(readable), timeout_(timeout),
-          timeout_error_(timeout_error) {}
+    readiness_wait_awaitable(
+        int fd, bool readable,
+        std::optional<std::chrono::steady_clock::time_point> deadline,
+        simplenet::error timeout_error,
+        simplenet::runtime::cancel_token token = {},
+        wait_kind kind = wait_kind::plain) noexcept
+        : fd_(fd), readable_(readable), deadline_(deadline),
+          timeout_error_(timeout_error), token_(std::move(token)) {
+        operation_.after_would_block = kind != wait_kind::plain;
+        operation_.owned_fd = kind == wait_kind::retry;
+    }
 
     [[nodiscard]] bool await_ready() const noexcept {
         return false;
@@ -45,18 +60,28 @@ public:
             return false;
         } else {
             scheduler_ = handle.promise().scheduler_ptr();
-            handle_ = handle;
+            operation_.handle = handle;
 
             if (scheduler_ == nullptr) {
                 status_ = simplenet::err<void>(simplenet::make_error_from_errno(EINVAL));
                 return false;
             }
+            if (token_.stop_requested()) {
+                status_ = simplenet::err<void>(
+                    simplenet::make_error_from_errno(ECANCELED));
+                return false;
+            }
 
             status_ = readable_
-                          ? scheduler_->wait_for_readable(fd_, handle, timeout_,
+                          ? scheduler_->wait_for_readable(fd_, operation_,
+                                                          deadline_,
                                                           timeout_error_)
-                          : scheduler_->wait_for_writable(fd_, handle, timeout_,
+                          : scheduler_->wait_for_writable(fd_, operation_,
+                                                          deadline_,
                                                           timeout_error_);
+            if (status_.has_value()) {
+                cancellation_.arm(token_, *scheduler_, &on_stop, this);
+            }
             return status_.has_value();
         }
     }
@@ -66,24 +91,181 @@ public:
             return status_;
         }
 
-        if (scheduler_ == nullptr || !handle_) {
-            return status_;
-        }
-        return scheduler_->consume_wait_result(handle_);
+        // The scheduler filled the outcome in before resuming us.
+        cancellation_.disarm();
+        return std::move(operation_.status);
     }
 
 private:
+    static void on_stop(void *context) noexcept {
+        auto& self = *static_cast<readiness_wait_awaitable *>(context);
+        (void)self.scheduler_->cancel_wait(self.fd_, self.readable_,
+                                           self.operation_);
+    }
+
     int fd_{-1};
     bool readable_{true};
-    std::optional<std::chrono::milliseconds> timeout_{};
+    std::optional<std::chrono::steady_clock::time_point> deadline_{};
     simplenet::error timeout_error_{simplenet::make_error_from_errno(ETIMEDOUT)};
+    simplenet::runtime::cancel_token token_{};
+    simplenet::runtime::detail::loop_cancellation cancellation_{};
     simplenet::runtime::scheduler *scheduler_{nullptr};
-    std::coroutine_handle<> handle_{};
+    simplenet::runtime::wait_operation operation_{};
     simplenet::result<void> status_{simplenet::ok()};
 };
 
-[[nodiscard]] bool is_timeout_error(const simplenet::error& err) noexcept {
-    return err.value() == ETIMEDOUT;
+/// Wait on an owned descriptor that just returned `EAGAIN`.
+readiness_wait_awaitable
+retry_wait(int fd, bool readable,
+           std::optional<std::chrono::steady_clock::time_point> deadline =
+               std::nullopt,
+           simplenet::runtime::cancel_token token = {}) noexcept {
+    return {fd, readable, deadline, simplenet::make_error_from_errno(ETIMEDOUT),
+            std::move(token), wait_kind::retry};
+}
+
+/**
+ * Non-suspending awaitable that exposes the awaiting task's scheduler.
+ */
+class current_scheduler_awaitable {
+public:
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            scheduler_ = handle.promise().scheduler_ptr();
+        }
+        return false;
+    }
+
+    [[nodiscard]] simplenet::runtime::scheduler *await_resume() const noexcept {
+        return scheduler_;
+    }
+
+private:
+    simplenet::runtime::scheduler *scheduler_{nullptr};
+};
+
+/**
+ * Suspend until a completion-mode operation finishes and yield its result.
+ */
+class completion_awaitable {
+public:
+    explicit completion_awaitable(
+        simplenet::runtime::io_operation& operation) noexcept
+        : operation_(operation) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (!requires(Promise& p) { p.scheduler_ptr(); }) {
+            status_ = simplenet::err<void>(simplenet::make_error_from_errno(EINVAL));
+            return false;
+        } else {
+            auto *scheduler = handle.promise().scheduler_ptr();
+            if (scheduler == nullptr) {
+                status_ = simplenet::err<void>(simplenet::make_error_from_errno(EINVAL));
+                return false;
+            }
+
+            operation_.handle = handle;
+            status_ = scheduler->submit_io(operation_);
+            return status_.has_value();
+        }
+    }
+
+    [[nodiscard]] simplenet::result<int> await_resume() const noexcept {
+        if (!status_.has_value()) {
+            return simplenet::err<int>(status_.error());
+        }
+        if (operation_.result < 0) {
+            // A fast-open socket still in its handshake: callers fall back
+            // to waiting for writability.
+            if (operation_.result == -EINPROGRESS && is_send()) {
+                return simplenet::err<int>(
+                    simplenet::make_error_from_errno(EAGAIN));
+            }
+            return simplenet::err<int>(
+                simplenet::make_error_from_errno(-operation_.result));
+        }
+        return operation_.result;
+    }
+
+private:
+    [[nodiscard]] bool is_send() const noexcept {
+        using simplenet::runtime::io_opcode;
+        return operation_.opcode == io_opcode::send ||
+               operation_.opcode == io_opcode::sendmsg ||
+               operation_.opcode == io_opcode::send_zc;
+    }
+
+    simplenet::runtime::io_operation& operation_;
+    simplenet::result<void> status_{simplenet::ok()};
+};
+
+[[nodiscard]] bool
+uses_completion_io(const simplenet::runtime::scheduler *scheduler) noexcept {
+    return scheduler != nullptr && scheduler->supports_completion_io();
+}
+
+/// RFC 8305 section 4 order: alternate families, first family first.
+[[nodiscard]] std::vector<simplenet::nonblocking::socket_address>
+interleave_families(
+    std::span<const simplenet::nonblocking::socket_address> candidates) {
+    const int first_family = candidates.front().family();
+    std::vector<simplenet::nonblocking::socket_address> preferred;
+    std::vector<simplenet::nonblocking::socket_address> other;
+    for (const auto& candidate : candidates) {
+        (candidate.family() == first_family ? preferred : other)
+            .push_back(candidate);
+    }
+
+    std::vector<simplenet::nonblocking::socket_address> order;
+    order.reserve(candidates.size());
+    for (std::size_t index = 0;
+         index < std::max(preferred.size(), other.size()); ++index) {
+        if (index < preferred.size()) {
+            order.push_back(preferred[index]);
+        }
+        if (index < other.size()) {
+            order.push_back(other[index]);
+        }
+    }
+    return order;
+}
+
+[[nodiscard]] std::span<const ::iovec>
+skip_empty(std::span<const ::iovec> buffers) noexcept {
+    while (!buffers.empty() && buffers.front().iov_len == 0U) {
+        buffers = buffers.subspan(1);
+    }
+    return buffers;
+}
+
+/**
+ * Wait until `fd` may hold new `MSG_ZEROCOPY` completions. They raise
+ * `EPOLLERR`, which wakes a waiter of either direction, so take the
+ * writable slot when another task already parks on the readable one.
+ */
+simplenet::runtime::task<simplenet::result<void>>
+wait_zerocopy(int fd, std::optional<std::chrono::steady_clock::time_point> deadline,
+              simplenet::runtime::cancel_token token, wait_kind kind) {
+    const auto readable = co_await readiness_wait_awaitable{
+        fd, true, deadline, simplenet::make_error_from_errno(ETIMEDOUT), token,
+        kind};
+    if (readable.has_value() || readable.error().value() != EBUSY) {
+        co_return readable;
+    }
+    const auto writable = co_await readiness_wait_awaitable{
+        fd, false, deadline, simplenet::make_error_from_errno(ETIMEDOUT), token,
+        kind};
+    co_return writable;
 }
 
 } // namespace
@@ -105,19 +287,74 @@ task<result<void>> wait_writable(int fd) {
 task<result<void>> wait_readable_for(int fd,
                                      std::chrono::milliseconds timeout) {
     const auto status = co_await readiness_wait_awaitable{
-        fd, true, timeout, make_error_from_errno(ETIMEDOUT)};
+        fd, true, std::chrono::steady_clock::now() + timeout,
+        make_error_from_errno(ETIMEDOUT)};
     co_return status;
 }
 
 task<result<void>> wait_writable_for(int fd,
                                      std::chrono::milliseconds timeout) {
     const auto status = co_await readiness_wait_awaitable{
-        fd, false, timeout, make_error_from_errno(ETIMEDOUT)};
+        fd, false, std::chrono::steady_clock::now() + timeout,
+        make_error_from_errno(ETIMEDOUT)};
+    co_return status;
+}
+
+task<result<void>>
+wait_readable_until(int fd, std::chrono::steady_clock::time_point deadline,
+                    cancel_token token) {
+    const auto status = co_await readiness_wait_awaitable{
+        fd, true, deadline, make_error_from_errno(ETIMEDOUT), token};
+    co_return status;
+}
+
+task<result<void>>
+wait_writable_until(int fd, std::chrono::steady_clock::time_point deadline,
+                    cancel_token token) {
+    const auto status = co_await readiness_wait_awaitable{
+        fd, false, deadline, make_error_from_errno(ETIMEDOUT), token};
+    co_return status;
+}
+
+task<result<void>>
+wait_zerocopy_until(int fd, std::chrono::steady_clock::time_point deadline,
+                    cancel_token token) {
+    const auto status = co_await wait_zerocopy(fd, deadline, std::move(token),
+                                            wait_kind::plain);
     co_return status;
 }
 
+namespace detail {
+
+task<result<void>>
+wait_after_would_block(int fd, bool readable,
+                       std::chrono::steady_clock::time_point deadline,
+                       cancel_token token) {
+    const auto status =
+        co_await retry_wait(fd, readable, deadline, std::move(token));
+    co_return status;
+}
+
+} // namespace detail
+
 task<result<simplenet::nonblocking::tcp_stream>>
 async_accept(simplenet::nonblocking::tcp_listener& listener) {
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && listener.valid()) {
+        io_operation operation{};
+        operation.opcode = io_opcode::accept;
+        operation.fd = listener.native_handle();
+
+        const auto accepted = co_await completion_awaitable{operation};
+        if (accepted.has_value()) {
+            co_return simplenet::nonblocking::tcp_stream{
+                simplenet::unique_fd{accepted.value()}};
+        }
+        if (!simplenet::nonblocking::is_would_block(accepted.error())) {
+            co_return err<simplenet::nonblocking::tcp_stream>(accepted.error());
+        }
+    }
+
     while (true) {
         auto accept_result = listener.accept();
         if (accept_result.has_value()) {
@@ -129,21 +366,84 @@ async_accept(simplenet::nonblocking::tcp_listener& listener) {
         }
 
         const auto wait_result =
-            co_await wait_readable(listener.native_handle());
+            co_await retry_wait(listener.native_handle(), true);
         if (!wait_result.has_value()) {
             co_return err<simplenet::nonblocking::tcp_stream>(wait_result.error());
         }
     }
 }
 
+task<result<std::size_t>>
+async_accept_batch(simplenet::nonblocking::tcp_listener& listener,
+                   std::span<simplenet::nonblocking::tcp_stream> streams) {
+    if (streams.empty()) {
+        co_return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+    while (true) {
+        auto accepted = listener.accept_batch(streams);
+        if (accepted.has_value() ||
+            !simplenet::nonblocking::is_would_block(accepted.error())) {
+            co_return accepted;
+        }
+
+        const auto wait_result =
+            co_await retry_wait(listener.native_handle(), true);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
 task<result<simplenet::nonblocking::tcp_stream>>
 async_connect(const simplenet::nonblocking::endpoint& endpoint) {
-    auto stream_result = simplenet::nonblocking::tcp_stream::connect(endpoint);
-    if (!stream_result.has_value()) {
-        co_return err<simplenet::nonblocking::tcp_stream>(stream_result.error());
+    const auto address =
+        simplenet::nonblocking::socket_address::from_endpoint(endpoint);
+    if (!address.has_value()) {
+        co_return err<simplenet::nonblocking::tcp_stream>(address.error());
     }
+    co_return co_await async_connect(address.value());
+}
+
+task<result<simplenet::nonblocking::tcp_stream>>
+async_connect(const simplenet::nonblocking::socket_address& address,
+              simplenet::nonblocking::socket_options options) {
+    simplenet::nonblocking::tcp_stream stream{};
 
-    auto stream = std::move(stream_result.value());
+    auto *active = co_await current_scheduler_awaitable{};
+    const detail::op_latency_timer timer{op_kind::connect, active};
+    if (uses_completion_io(active)) {
+        auto open_result =
+            simplenet::nonblocking::tcp_stream::open(address.family(), options);
+        if (!open_result.has_value()) {
+            co_return err<simplenet::nonblocking::tcp_stream>(open_result.error());
+        }
+        stream = std::move(open_result.value());
+
+        io_operation operation{};
+        operation.opcode = io_opcode::connect;
+        operation.fd = stream.native_handle();
+        operation.address = address.data();
+        operation.address_length = static_cast<std::uint32_t>(address.length);
+
+        const auto connected = co_await completion_awaitable{operation};
+        if (connected.has_value()) {
+            co_return std::move(stream);
+        }
+        // Older kernels may report an in-flight connect on nonblocking sockets;
+        // finish it through the readiness path below.
+        if (!simplenet::nonblocking::is_in_progress(connected.error()) &&
+            !simplenet::nonblocking::is_would_block(connected.error()) &&
+            connected.error().value() != EALREADY) {
+            co_return err<simplenet::nonblocking::tcp_stream>(connected.error());
+        }
+    } else {
+        auto stream_result =
+            simplenet::nonblocking::tcp_stream::connect(address, options);
+        if (!stream_result.has_value()) {
+            co_return err<simplenet::nonblocking::tcp_stream>(stream_result.error());
+        }
+        stream = std::move(stream_result.value());
+    }
 
     while (true) {
         const auto finish_result = stream.finish_connect();
@@ -156,15 +456,125 @@ async_connect(const simplenet::nonblocking::endpoint& endpoint) {
             co_return err<simplenet::nonblocking::tcp_stream>(finish_result.error());
         }
 
-        const auto wait_result = co_await wait_writable(stream.native_handle());
+        const auto wait_result = co_await retry_wait(stream.native_handle(), false);
         if (!wait_result.has_value()) {
             co_return err<simplenet::nonblocking::tcp_stream>(wait_result.error());
         }
     }
 }
 
+task<result<simplenet::nonblocking::tcp_stream>>
+async_connect(std::span<const simplenet::nonblocking::socket_address> candidates,
+              happy_eyeballs_options options) {
+    using simplenet::nonblocking::tcp_stream;
+
+    if (candidates.empty()) {
+        co_return err<tcp_stream>(make_error_from_errno(EINVAL));
+    }
+    // Only one candidate: nothing to race.
+    if (candidates.size() == 1U) {
+        co_return co_await async_connect(candidates.front(), options.socket);
+    }
+
+    // A fast-open connect reports success before any handshake, which
+    // would let the first attempt win the race unseen.
+    auto socket = options.socket;
+    socket.fast_open_connect = false;
+
+    auto group = simplenet::epoll::reactor::create();
+    if (!group.has_value()) {
+        co_return err<tcp_stream>(group.error());
+    }
+
+    const auto order = interleave_families(candidates);
+    std::vector<tcp_stream> pending;
+    std::size_t next = 0;
+    simplenet::error last_error = make_error_from_errno(ECONNREFUSED);
+    auto next_start = std::chrono::steady_clock::now();
+
+    while (true) {
+        // Start every attempt that is due; a failed start moves on at once.
+        while (next < order.size() &&
+               (pending.empty() ||
+                std::chrono::steady_clock::now() >= next_start)) {
+            auto started = tcp_stream::connect(order[next++], socket);
+            if (!started.has_value()) {
+                last_error = started.error();
+                continue;
+            }
+            const auto added =
+                group.value().add(started.value().native_handle(), EPOLLOUT);
+            if (!added.has_value()) {
+                last_error = added.error();
+                continue;
+            }
+            pending.push_back(std::move(started.value()));
+            next_start = std::chrono::steady_clock::now() + options.attempt_delay;
+        }
+        if (pending.empty()) {
+            co_return err<tcp_stream>(last_error);
+        }
+
+        const int group_fd = group.value().native_handle();
+        const auto ready = co_await retry_wait(
+            group_fd, true,
+            next < order.size() ? std::optional{next_start} : std::nullopt);
+        if (!ready.has_value() && ready.error().value() != ETIMEDOUT) {
+            co_return err<tcp_stream>(ready.error());
+        }
+
+        // The loop holds the group edge-triggered, and entries left behind
+        // in it raise no new edge: drain until a wait comes back short.
+        std::array<::epoll_event, 16> events{};
+        std::size_t count = events.size();
+        while (count == events.size()) {
+            const auto drained = group.value().wait(
+                std::span{events}, std::chrono::milliseconds{0});
+            if (!drained.has_value()) {
+                co_return err<tcp_stream>(drained.error());
+            }
+            count = drained.value();
+            for (std::size_t index = 0; index < count; ++index) {
+                const int fd = events[index].data.fd;
+                const auto attempt = std::ranges::find_if(
+                    pending, [fd](const tcp_stream& stream) {
+                        return stream.native_handle() == fd;
+                    });
+                if (attempt == pending.end()) {
+                    continue;
+                }
+                const auto status = attempt->finish_connect();
+                if (status.has_value()) {
+                    co_return std::move(*attempt);
+                }
+                last_error = status.error();
+                (void)group.value().remove(fd);
+                pending.erase(attempt);
+            }
+        }
+    }
+}
+
 task<result<std::size_t>> async_read_some(simplenet::nonblocking::tcp_stream& stream,
                                           std::span<std::byte> buffer) {
+    auto *active = co_await current_scheduler_awaitable{};
+    const detail::op_latency_timer timer{op_kind::read_some, active};
+    if (uses_completion_io(active) && stream.valid() && !buffer.empty()) {
+        io_operation operation{};
+        operation.opcode = io_opcode::recv;
+        operation.fd = stream.native_handle();
+        operation.buffer = buffer.data();
+        operation.length = buffer.size();
+
+        const auto received = co_await completion_awaitable{operation};
+        if (received.has_value()) {
+            co_return static_cast<std::size_t>(received.value());
+        }
+        if (!simplenet::nonblocking::is_would_block(received.error())) {
+            co_return err<std::size_t>(received.error());
+        }
+    }
+
     while (true) {
         auto read_result = stream.read_some(buffer);
         if (read_result.has_value()) {
@@ -175,7 +585,7 @@ task<result<std::size_t>> async_read_some(simplenet::nonblocking::tcp_stream& st
             co_return err<std::size_t>(read_result.error());
         }
 
-        const auto wait_result = co_await wait_readable(stream.native_handle());
+        const auto wait_result = co_await retry_wait(stream.native_handle(), true);
         if (!wait_result.has_value()) {
             co_return err<std::size_t>(wait_result.error());
         }
@@ -184,6 +594,23 @@ task<result<std::size_t>> async_read_some(simplenet::nonblocking::tcp_stream& st
 
 task<result<std::size_t>> async_write_some(simplenet::nonblocking::tcp_stream& stream,
                                            std::span<const std::byte> buffer) {
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && stream.valid() && !buffer.empty()) {
+        io_operation operation{};
+        operation.opcode = io_opcode::send;
+        operation.fd = stream.native_handle();
+        operation.buffer = const_cast<std::byte *>(buffer.data());
+        operation.length = buffer.size();
+
+        const auto sent = co_await completion_awaitable{operation};
+        if (sent.has_value()) {
+            co_return static_cast<std::size_t>(sent.value());
+        }
+        if (!simplenet::nonblocking::is_would_block(sent.error())) {
+            co_return err<std::size_t>(sent.error());
+        }
+    }
+
     while (true) {
         auto write_result = stream.write_some(buffer);
         if (write_result.has_value()) {
@@ -194,7 +621,190 @@ task<result<std::size_t>> async_write_some(simplenet::nonblocking::tcp_stream& s
             co_return err<std::size_t>(write_result.error());
         }
 
-        const auto wait_result = co_await wait_writable(stream.native_handle());
+        const auto wait_result = co_await retry_wait(stream.native_handle(), false);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+namespace {
+
+/// io_uring path of `async_sendfile()`: file to pipe, then pipe to socket.
+task<result<std::size_t>>
+splice_file_to_socket(simplenet::nonblocking::tcp_stream& stream, int file_fd,
+                      std::uint64_t offset, std::size_t count) {
+    std::array<int, 2> ends{};
+    if (::pipe2(ends.data(), O_CLOEXEC | O_NONBLOCK) != 0) {
+        co_return err<std::size_t>(error::from_errno());
+    }
+    const simplenet::unique_fd read_end{ends[0]};
+    const simplenet::unique_fd write_end{ends[1]};
+    // A bigger pipe moves more per round trip; the default is 64 KiB.
+    (void)::fcntl(write_end.get(), F_SETPIPE_SZ, 1 << 20);
+    const int capacity = ::fcntl(write_end.get(), F_GETPIPE_SZ);
+    const std::size_t chunk =
+        capacity > 0 ? static_cast<std::size_t>(capacity) : 64U * 1024U;
+
+    std::size_t total = 0;
+    while (total < count) {
+        io_operation fill{};
+        fill.opcode = io_opcode::splice;
+        fill.source_fd = file_fd;
+        fill.source_offset = static_cast<std::int64_t>(offset + total);
+        fill.fd = write_end.get();
+        fill.length = std::min(chunk, count - total);
+        const auto filled = co_await completion_awaitable{fill};
+        if (!filled.has_value()) {
+            co_return err<std::size_t>(filled.error());
+        }
+        if (filled.value() == 0) {
+            break; // End of file.
+        }
+
+        auto pending = static_cast<std::size_t>(filled.value());
+        while (pending > 0U) {
+            io_operation drain{};
+            drain.opcode = io_opcode::splice;
+            drain.source_fd = read_end.get();
+            drain.fd = stream.native_handle();
+            drain.length = pending;
+            const auto drained = co_await completion_awaitable{drain};
+            if (!drained.has_value()) {
+                co_return err<std::size_t>(drained.error());
+            }
+            if (drained.value() == 0) {
+                co_return err<std::size_t>(make_error_from_errno(EPIPE));
+            }
+            pending -= static_cast<std::size_t>(drained.value());
+            total += static_cast<std::size_t>(drained.value());
+        }
+    }
+    co_return total;
+}
+
+} // namespace
+
+task<result<std::size_t>>
+async_sendfile(simplenet::nonblocking::tcp_stream& stream, int file_fd,
+               std::uint64_t offset, std::size_t count) {
+    if (!stream.valid() || file_fd < 0) {
+        co_return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (offset > static_cast<std::uint64_t>(INT64_MAX) ||
+        count > static_cast<std::uint64_t>(INT64_MAX) - offset) {
+        co_return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active)) {
+        co_return co_await splice_file_to_socket(stream, file_fd, offset, count);
+    }
+
+    std::size_t total = 0;
+    while (total < count) {
+        const auto sent = stream.send_file(file_fd, offset + total, count - total);
+        if (sent.has_value()) {
+            if (sent.value() == 0U) {
+                break; // End of file.
+            }
+            total += sent.value();
+            continue;
+        }
+        if (!simplenet::nonblocking::is_would_block(sent.error())) {
+            co_return err<std::size_t>(sent.error());
+        }
+
+        const auto wait_result = co_await retry_wait(stream.native_handle(), false);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+    co_return total;
+}
+
+task<result<std::size_t>> async_splice(int in_fd, int out_fd, std::size_t count) {
+    if (in_fd < 0 || out_fd < 0) {
+        co_return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (count == 0U) {
+        co_return static_cast<std::size_t>(0);
+    }
+
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active)) {
+        io_operation operation{};
+        operation.opcode = io_opcode::splice;
+        operation.source_fd = in_fd;
+        operation.fd = out_fd;
+        operation.length = std::min<std::size_t>(count, UINT_MAX);
+        const auto moved = co_await completion_awaitable{operation};
+        if (!moved.has_value()) {
+            co_return err<std::size_t>(moved.error());
+        }
+        co_return static_cast<std::size_t>(moved.value());
+    }
+
+    while (true) {
+        const ssize_t moved = ::splice(in_fd, nullptr, out_fd, nullptr, count,
+                                       SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (moved >= 0) {
+            co_return static_cast<std::size_t>(moved);
+        }
+        if (errno != EAGAIN) {
+            co_return err<std::size_t>(error::from_errno());
+        }
+
+        // Wait on whichever side held it up. Regular files always poll
+        // ready, so they are never registered with epoll.
+        std::array<::pollfd, 2> probe{{{.fd = in_fd, .events = POLLIN, .revents = 0},
+                                       {.fd = out_fd, .events = POLLOUT, .revents = 0}}};
+        (void)::poll(probe.data(), probe.size(), 0);
+        const bool input_ready =
+            (probe[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+        const auto wait_result =
+            input_ready ? co_await readiness_wait_awaitable{
+                              out_fd, false, std::nullopt,
+                              make_error_from_errno(ETIMEDOUT), {},
+                              wait_kind::raw_retry}
+                        : co_await readiness_wait_awaitable{
+                              in_fd, true, std::nullopt,
+                              make_error_from_errno(ETIMEDOUT), {},
+                              wait_kind::raw_retry};
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+task<result<simplenet::nonblocking::tls_record>>
+async_read_tls_record(simplenet::nonblocking::tcp_stream& stream,
+                      std::span<std::byte> buffer) {
+    while (true) {
+        auto record = stream.read_tls_record(buffer);
+        if (record.has_value() ||
+            !simplenet::nonblocking::is_would_block(record.error())) {
+            co_return record;
+        }
+
+        const auto wait_result = co_await retry_wait(stream.native_handle(), true);
+        if (!wait_result.has_value()) {
+            co_return err<simplenet::nonblocking::tls_record>(wait_result.error());
+        }
+    }
+}
+
+task<result<std::size_t>>
+async_write_tls_record(simplenet::nonblocking::tcp_stream& stream,
+                       std::uint8_t type, std::span<const std::byte> bytes) {
+    while (true) {
+        auto written = stream.write_tls_record(type, bytes);
+        if (written.has_value() ||
+            !simplenet::nonblocking::is_would_block(written.error())) {
+            co_return written;
+        }
+
+        const auto wait_result = co_await retry_wait(stream.native_handle(), false);
         if (!wait_result.has_value()) {
             co_return err<std::size_t>(wait_result.error());
         }
@@ -233,73 +843,517 @@ task<result<void>> async_write_all(simplenet::nonblocking::tcp_stream& stream,
     co_return ok();
 }
 
-task<result<void>> async_sleep(std::chrono::milliseconds duration,
-                               cancel_token token) {
-    if (token.stop_requested()) {
-        co_return err<void>(make_error_from_errno(ECANCELED));
+task<result<std::size_t>> async_readv(simplenet::nonblocking::tcp_stream& stream,
+                                      std::span<const ::iovec> buffers) {
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && stream.valid() && !buffers.empty()) {
+        ::msghdr message{};
+        message.msg_iov = const_cast<::iovec *>(buffers.data());
+        message.msg_iovlen = std::min<std::size_t>(buffers.size(), IOV_MAX);
+
+        io_operation operation{};
+        operation.opcode = io_opcode::recvmsg;
+        operation.fd = stream.native_handle();
+        operation.buffer = &message;
+
+        const auto received = co_await completion_awaitable{operation};
+        if (received.has_value()) {
+            co_return static_cast<std::size_t>(received.value());
+        }
+        if (!simplenet::nonblocking::is_would_block(received.error())) {
+            co_return err<std::size_t>(received.error());
+        }
     }
-    if (duration <= std::chrono::milliseconds{0}) {
-        co_return ok();
+
+    while (true) {
+        auto read_result = stream.read_some(buffers);
+        if (read_result.has_value()) {
+            co_return read_result;
+        }
+
+        if (!simplenet::nonblocking::is_would_block(read_result.error())) {
+            co_return err<std::size_t>(read_result.error());
+        }
+
+        const auto wait_result = co_await retry_wait(stream.native_handle(), true);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+task<result<std::size_t>> async_writev(simplenet::nonblocking::tcp_stream& stream,
+                                       std::span<const ::iovec> buffers) {
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && stream.valid() && !buffers.empty()) {
+        ::msghdr message{};
+        message.msg_iov = const_cast<::iovec *>(buffers.data());
+        message.msg_iovlen = std::min<std::size_t>(buffers.size(), IOV_MAX);
+
+        io_operation operation{};
+        operation.opcode = io_opcode::sendmsg;
+        operation.fd = stream.native_handle();
+        operation.buffer = &message;
+
+        const auto sent = co_await completion_awaitable{operation};
+        if (sent.has_value()) {
+            co_return static_cast<std::size_t>(sent.value());
+        }
+        if (!simplenet::nonblocking::is_would_block(sent.error())) {
+            co_return err<std::size_t>(sent.error());
+        }
+    }
+
+    while (true) {
+        auto write_result = stream.write_some(buffers);
+        if (write_result.has_value()) {
+            co_return write_result;
+        }
+
+        if (!simplenet::nonblocking::is_would_block(write_result.error())) {
+            co_return err<std::size_t>(write_result.error());
+        }
+
+        const auto wait_result = co_await retry_wait(stream.native_handle(), false);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+task<result<void>> async_writev_all(simplenet::nonblocking::tcp_stream& stream,
+                                    std::span<const ::iovec> buffers) {
+    // Filled only once a write stops inside an entry.
+    std::vector<::iovec> remainder;
+    bool owned = false;
+
+    auto pending = skip_empty(buffers);
+    while (!pending.empty()) {
+        auto r = co_await async_writev(stream, pending);
+        if (!r.has_value()) {
+            co_return err<void>(r.error());
+        }
+        if (r.value() == 0U) {
+            co_return err<void>(make_error_from_errno(EPIPE));
+        }
+
+        auto written = r.value();
+        while (!pending.empty() && written >= pending.front().iov_len) {
+            written -= pending.front().iov_len;
+            pending = pending.subspan(1);
+        }
+        if (written > 0U) {
+            if (owned) {
+                remainder.erase(remainder.begin(),
+                                remainder.end() -
+                                    static_cast<std::ptrdiff_t>(pending.size()));
+            } else {
+                remainder.assign(pending.begin(), pending.end());
+                owned = true;
+            }
+            auto& head = remainder.front();
+            head.iov_base = static_cast<std::byte *>(head.iov_base) + written;
+            head.iov_len -= written;
+            pending = remainder;
+        }
+        pending = skip_empty(pending);
     }
+    co_return ok();
+}
 
-    const int timer_fd = get_sleep_timerfd();
-    if (timer_fd < 0) {
-        co_return err<void>(error::from_errno());
+task<result<std::size_t>>
+async_send_zerocopy(simplenet::nonblocking::tcp_stream& stream,
+                    std::span<const std::byte> buffer) {
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && stream.valid() && !buffer.empty()) {
+        io_operation operation{};
+        operation.opcode = io_opcode::send_zc;
+        operation.fd = stream.native_handle();
+        operation.buffer = const_cast<std::byte *>(buffer.data());
+        operation.length = buffer.size();
+
+        // Resumed after the notification CQE, so the buffer is free again.
+        const auto sent = co_await completion_awaitable{operation};
+        if (sent.has_value()) {
+            co_return static_cast<std::size_t>(sent.value());
+        }
+        const auto code = sent.error().value();
+        if (!simplenet::nonblocking::is_would_block(sent.error()) &&
+            code != EINVAL && code != EOPNOTSUPP) {
+            co_return err<std::size_t>(sent.error());
+        }
     }
 
-    const auto deadline = std::chrono::steady_clock::now() + duration;
+    if (!stream.zerocopy_enabled()) {
+        const auto enabled = stream.enable_zerocopy();
+        if (!enabled.has_value()) {
+            co_return err<std::size_t>(enabled.error());
+        }
+    }
 
+    const ::iovec region{.iov_base = const_cast<std::byte *>(buffer.data()),
+                         .iov_len = buffer.size()};
+    const auto id = stream.next_zerocopy_id();
+    std::size_t sent = 0;
     while (true) {
-        if (token.stop_requested()) {
-            co_return err<void>(make_error_from_errno(ECANCELED));
+        auto write_result =
+            stream.write_some_zerocopy(std::span<const ::iovec>{&region, 1});
+        if (write_result.has_value()) {
+            sent = write_result.value();
+            break;
+        }
+        if (!simplenet::nonblocking::is_would_block(write_result.error())) {
+            co_return err<std::size_t>(write_result.error());
+        }
+        const auto wait_result = co_await retry_wait(stream.native_handle(), false);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
         }
+    }
+    if (sent == 0U) {
+        co_return sent;
+    }
 
-        const auto now = std::chrono::steady_clock::now();
-        if (now >= deadline) {
-            co_return ok();
+    // Not bounded by a deadline or stop: the buffer must stay untouched
+    // until the kernel releases it.
+    while (true) {
+        auto notification = stream.reap_zerocopy();
+        if (notification.has_value()) {
+            if (notification->contains(id)) {
+                co_return sent;
+            }
+            continue;
         }
+        if (!simplenet::nonblocking::is_would_block(notification.error())) {
+            co_return err<std::size_t>(notification.error());
+        }
+        const auto woke =
+            co_await wait_zerocopy(stream.native_handle(), std::nullopt, {},
+                                 wait_kind::retry);
+        if (!woke.has_value()) {
+            co_return err<std::size_t>(woke.error());
+        }
+    }
+}
 
-        const auto remaining =
-            std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
-                                                                  now);
-        const auto slice = std::max<std::chrono::milliseconds>(
-            std::chrono::milliseconds{1},
-            std::min<std::chrono::milliseconds>(remaining, 20ms));
+task<result<simplenet::nonblocking::udp_datagram>>
+async_recv_from(simplenet::nonblocking::udp_socket& socket,
+                std::span<std::byte> buffer) {
+    using simplenet::nonblocking::udp_datagram;
 
-        ::itimerspec spec{};
-        spec.it_value.tv_sec = static_cast<std::time_t>(slice.count() / 1000);
-        spec.it_value.tv_nsec =
-            static_cast<long>((slice.count() % 1000) * 1000000L);
-        if (::timerfd_settime(timer_fd, 0, &spec, nullptr) != 0) {
-            co_return err<void>(error::from_errno());
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && socket.valid()) {
+        udp_datagram datagram{};
+        ::iovec vector{.iov_base = buffer.data(), .iov_len = buffer.size()};
+        ::msghdr message{};
+        message.msg_name = &datagram.from.storage;
+        message.msg_namelen =
+            static_cast<socklen_t>(sizeof(datagram.from.storage));
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+
+        io_operation operation{};
+        operation.opcode = io_opcode::recvmsg;
+        operation.fd = socket.native_handle();
+        operation.buffer = &message;
+
+        const auto received = co_await completion_awaitable{operation};
+        if (received.has_value()) {
+            datagram.size = static_cast<std::size_t>(received.value());
+            datagram.from.length = message.msg_namelen;
+            datagram.truncated = (message.msg_flags & MSG_TRUNC) != 0;
+            co_return datagram;
+        }
+        if (!simplenet::nonblocking::is_would_block(received.error())) {
+            co_return err<udp_datagram>(received.error());
+        }
+    }
+
+    while (true) {
+        auto received = socket.recv_from(buffer);
+        if (received.has_value() ||
+            !simplenet::nonblocking::is_would_block(received.error())) {
+            co_return received;
         }
 
-        const auto wait_result = co_await wait_readable(timer_fd);
+        const auto wait_result = co_await retry_wait(socket.native_handle(), true);
         if (!wait_result.has_value()) {
-            co_return err<void>(wait_result.error());
+            co_return err<udp_datagram>(wait_result.error());
         }
+    }
+}
+
+task<result<std::size_t>>
+async_send_to(simplenet::nonblocking::udp_socket& socket,
+              std::span<const std::byte> buffer,
+              const simplenet::nonblocking::socket_address& to) {
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && socket.valid()) {
+        ::iovec vector{.iov_base = const_cast<std::byte *>(buffer.data()),
+                       .iov_len = buffer.size()};
+        ::msghdr message{};
+        message.msg_name = const_cast<::sockaddr *>(to.data());
+        message.msg_namelen = to.length;
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+
+        io_operation operation{};
+        operation.opcode = io_opcode::sendmsg;
+        operation.fd = socket.native_handle();
+        operation.buffer = &message;
+
+        const auto sent = co_await completion_awaitable{operation};
+        if (sent.has_value()) {
+            co_return static_cast<std::size_t>(sent.value());
+        }
+        if (!simplenet::nonblocking::is_would_block(sent.error())) {
+            co_return err<std::size_t>(sent.error());
+        }
+    }
 
-        std::uint64_t expirations = 0;
-        const auto read_count =
-            ::read(timer_fd, &expirations, sizeof(expirations));
-        if (read_count < 0) {
-            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+    while (true) {
+        auto sent = socket.send_to(buffer, to);
+        if (sent.has_value() ||
+            !simplenet::nonblocking::is_would_block(sent.error())) {
+            co_return sent;
+        }
+
+        const auto wait_result = co_await retry_wait(socket.native_handle(), false);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+task<result<std::size_t>>
+async_recv_batch(simplenet::nonblocking::udp_socket& socket,
+                 std::span<simplenet::nonblocking::udp_message> messages) {
+    while (true) {
+        auto received = socket.recv_batch(messages);
+        if (received.has_value() ||
+            !simplenet::nonblocking::is_would_block(received.error())) {
+            co_return received;
+        }
+
+        const auto wait_result = co_await retry_wait(socket.native_handle(), true);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+task<result<std::size_t>>
+async_send_batch(simplenet::nonblocking::udp_socket& socket,
+                 std::span<const simplenet::nonblocking::udp_outgoing> datagrams) {
+    std::size_t total = 0;
+    while (total < datagrams.size()) {
+        auto sent = socket.send_batch(datagrams.subspan(total));
+        if (sent.has_value()) {
+            total += sent.value();
+            continue;
+        }
+        if (simplenet::nonblocking::is_would_block(sent.error())) {
+            const auto wait_result =
+                co_await retry_wait(socket.native_handle(), false);
+            if (wait_result.has_value()) {
                 continue;
             }
-            co_return err<void>(error::from_errno());
+            sent = err<std::size_t>(wait_result.error());
+        }
+        if (total > 0U) {
+            co_return total;
+        }
+        co_return err<std::size_t>(sent.error());
+    }
+    co_return total;
+}
+
+task<result<std::size_t>>
+async_send_segmented(simplenet::nonblocking::udp_socket& socket,
+                     std::span<const std::byte> payload,
+                     const simplenet::nonblocking::socket_address& to,
+                     std::uint16_t segment_size) {
+    while (true) {
+        auto sent = socket.send_segmented(payload, to, segment_size);
+        if (sent.has_value() ||
+            !simplenet::nonblocking::is_would_block(sent.error())) {
+            co_return sent;
+        }
+
+        const auto wait_result = co_await retry_wait(socket.native_handle(), false);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+task<result<simplenet::nonblocking::udp_coalesced>>
+async_recv_coalesced(simplenet::nonblocking::udp_socket& socket,
+                     std::span<std::byte> buffer) {
+    using simplenet::nonblocking::udp_coalesced;
+
+    while (true) {
+        auto received = socket.recv_coalesced(buffer);
+        if (received.has_value() ||
+            !simplenet::nonblocking::is_would_block(received.error())) {
+            co_return received;
+        }
+
+        const auto wait_result = co_await retry_wait(socket.native_handle(), true);
+        if (!wait_result.has_value()) {
+            co_return err<udp_coalesced>(wait_result.error());
+        }
+    }
+}
+
+task<result<simplenet::nonblocking::local_stream>>
+async_accept(simplenet::nonblocking::local_listener& listener) {
+    using simplenet::nonblocking::local_stream;
+
+    auto *active = co_await current_scheduler_awaitable{};
+    if (uses_completion_io(active) && listener.valid()) {
+        io_operation operation{};
+        operation.opcode = io_opcode::accept;
+        operation.fd = listener.native_handle();
+
+        const auto accepted = co_await completion_awaitable{operation};
+        if (accepted.has_value()) {
+            co_return local_stream{simplenet::unique_fd{accepted.value()}};
+        }
+        if (!simplenet::nonblocking::is_would_block(accepted.error())) {
+            co_return err<local_stream>(accepted.error());
+        }
+    }
+
+    while (true) {
+        auto accept_result = listener.accept();
+        if (accept_result.has_value() ||
+            !simplenet::nonblocking::is_would_block(accept_result.error())) {
+            co_return accept_result;
+        }
+
+        const auto wait_result =
+            co_await retry_wait(listener.native_handle(), true);
+        if (!wait_result.has_value()) {
+            co_return err<local_stream>(wait_result.error());
+        }
+    }
+}
+
+task<result<std::size_t>>
+async_read_some(simplenet::nonblocking::local_stream& stream,
+                std::span<std::byte> buffer) {
+    co_return co_await async_read_some(stream.socket(), buffer);
+}
+
+task<result<std::size_t>>
+async_write_some(simplenet::nonblocking::local_stream& stream,
+                 std::span<const std::byte> buffer) {
+    co_return co_await async_write_some(stream.socket(), buffer);
+}
+
+task<result<void>> async_read_exact(simplenet::nonblocking::local_stream& stream,
+                                    std::span<std::byte> buffer) {
+    co_return co_await async_read_exact(stream.socket(), buffer);
+}
+
+task<result<void>> async_write_all(simplenet::nonblocking::local_stream& stream,
+                                   std::span<const std::byte> buffer) {
+    co_return co_await async_write_all(stream.socket(), buffer);
+}
+
+task<result<std::size_t>> async_readv(simplenet::nonblocking::local_stream& stream,
+                                      std::span<const ::iovec> buffers) {
+    co_return co_await async_readv(stream.socket(), buffers);
+}
+
+task<result<std::size_t>> async_writev(simplenet::nonblocking::local_stream& stream,
+                                       std::span<const ::iovec> buffers) {
+    co_return co_await async_writev(stream.socket(), buffers);
+}
+
+task<result<void>> async_writev_all(simplenet::nonblocking::local_stream& stream,
+                                    std::span<const ::iovec> buffers) {
+    co_return co_await async_writev_all(stream.socket(), buffers);
+}
+
+task<result<std::size_t>>
+async_send_fds(simplenet::nonblocking::local_stream& stream,
+               std::span<const std::byte> bytes, std::span<const int> fds) {
+    while (true) {
+        auto sent = stream.send_fds(bytes, fds);
+        if (sent.has_value() ||
+            !simplenet::nonblocking::is_would_block(sent.error())) {
+            co_return sent;
+        }
+
+        const auto wait_result = co_await retry_wait(stream.native_handle(), false);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
         }
     }
 }
 
+task<result<simplenet::nonblocking::fd_message>>
+async_receive_fds(simplenet::nonblocking::local_stream& stream,
+                  std::span<std::byte> buffer,
+                  std::span<simplenet::unique_fd> fds) {
+    using simplenet::nonblocking::fd_message;
+
+    while (true) {
+        auto received = stream.receive_fds(buffer, fds);
+        if (received.has_value() ||
+            !simplenet::nonblocking::is_would_block(received.error())) {
+            co_return received;
+        }
+
+        const auto wait_result = co_await retry_wait(stream.native_handle(), true);
+        if (!wait_result.has_value()) {
+            co_return err<fd_message>(wait_result.error());
+        }
+    }
+}
+
+task<result<void>> async_sleep(std::chrono::milliseconds duration,
+                               cancel_token token) {
+    if (token.stop_requested()) {
+        co_return err<void>(make_error_from_errno(ECANCELED));
+    }
+    if (duration <= std::chrono::milliseconds{0}) {
+        co_return ok();
+    }
+
+    steady_timer timer{duration};
+    co_return co_await timer.wait(std::move(token));
+}
+
 task<result<std::size_t>> async_read_some_with_timeout(
     simplenet::nonblocking::tcp_stream& stream, std::span<std::byte> buffer,
     std::chrono::milliseconds timeout, cancel_token token) {
     if (timeout < std::chrono::milliseconds{0}) {
         co_return err<std::size_t>(make_error_from_errno(EINVAL));
     }
+    co_return co_await async_read_some_until(
+        stream, buffer, std::chrono::steady_clock::now() + timeout,
+        std::move(token));
+}
 
-    const auto deadline = std::chrono::steady_clock::now() + timeout;
+task<result<std::size_t>> async_write_some_with_timeout(
+    simplenet::nonblocking::tcp_stream& stream, std::span<const std::byte> buffer,
+    std::chrono::milliseconds timeout, cancel_token token) {
+    if (timeout < std::chrono::milliseconds{0}) {
+        co_return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
+    co_return co_await async_write_some_until(
+        stream, buffer, std::chrono::steady_clock::now() + timeout,
+        std::move(token));
+}
 
+task<result<std::size_t>>
+async_read_some_until(simplenet::nonblocking::tcp_stream& stream,
+                      std::span<std::byte> buffer,
+                      std::chrono::steady_clock::time_point deadline,
+                      cancel_token token) {
     while (true) {
         if (token.stop_requested()) {
             co_return err<std::size_t>(make_error_from_errno(ECANCELED));
@@ -314,42 +1368,52 @@ task<result<std::size_t>> async_read_some_with_timeout(
             co_return err<std::size_t>(read_result.error());
         }
 
-        const auto now = std::chrono::steady_clock::now();
-        if (now >= deadline) {
-            co_return err<std::size_t>(make_error_from_errno(ETIMEDOUT));
+        const auto wait_result = co_await retry_wait(
+            stream.native_handle(), true, deadline, token);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
+        }
+    }
+}
+
+task<result<std::size_t>>
+async_write_some_until(simplenet::nonblocking::tcp_stream& stream,
+                       std::span<const std::byte> buffer,
+                       std::chrono::steady_clock::time_point deadline,
+                       cancel_token token) {
+    while (true) {
+        if (token.stop_requested()) {
+            co_return err<std::size_t>(make_error_from_errno(ECANCELED));
         }
 
-        const auto remaining =
-            std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
-                                                                  now);
-        const auto slice = std::max<std::chrono::milliseconds>(
-            std::chrono::milliseconds{1},
-            std::min<std::chrono::milliseconds>(remaining, 20ms));
+        auto write_result = stream.write_some(buffer);
+        if (write_result.has_value()) {
+            co_return write_result;
+        }
 
-        const auto wait_result =
-            co_await wait_readable_for(stream.native_handle(), slice);
-        if (!wait_result.has_value() &&
-            !is_timeout_error(wait_result.error())) {
+        if (!simplenet::nonblocking::is_would_block(write_result.error())) {
+            co_return err<std::size_t>(write_result.error());
+        }
+
+        const auto wait_result = co_await retry_wait(
+            stream.native_handle(), false, deadline, token);
+        if (!wait_result.has_value()) {
             co_return err<std::size_t>(wait_result.error());
         }
     }
 }
 
-task<result<std::size_t>> async_write_some_with_timeout(
-    simplenet::nonblocking::tcp_stream& stream, std::span<const std::byte> buffer,
-    std::chrono::milliseconds timeout, cancel_token token) {
-    if (timeout < std::chrono::milliseconds{0}) {
-        co_return err<std::size_t>(make_error_from_errno(EINVAL));
-    }
-
-    const auto deadline = std::chrono::steady_clock::now() + timeout;
-
+task<result<std::size_t>>
+async_writev_until(simplenet::nonblocking::tcp_stream& stream,
+                   std::span<const ::iovec> buffers,
+                   std::chrono::steady_clock::time_point deadline,
+                   cancel_token token) {
     while (true) {
         if (token.stop_requested()) {
             co_return err<std::size_t>(make_error_from_errno(ECANCELED));
         }
 
-        auto write_result = stream.write_some(buffer);
+        auto write_result = stream.write_some(buffers);
         if (write_result.has_value()) {
             co_return write_result;
         }
@@ -358,22 +1422,36 @@ task<result<std::size_t>> async_write_some_with_timeout(
             co_return err<std::size_t>(write_result.error());
         }
 
-        const auto now = std::chrono::steady_clock::now();
-        if (now >= deadline) {
-            co_return err<std::size_t>(make_error_from_errno(ETIMEDOUT));
+        const auto wait_result = co_await retry_wait(
+            stream.native_handle(), false, deadline, token);
+        if (!wait_result.has_value()) {
+            co_return err<std::size_t>(wait_result.error());
         }
+    }
+}
 
-        const auto remaining =
-            std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
-                                                                  now);
-        const auto slice = std::max<std::chrono::milliseconds>(
-            std::chrono::milliseconds{1},
-            std::min<std::chrono::milliseconds>(remaining, 20ms));
+task<result<std::size_t>>
+async_writev_zerocopy_until(simplenet::nonblocking::tcp_stream& stream,
+                            std::span<const ::iovec> buffers,
+                            std::chrono::steady_clock::time_point deadline,
+                            cancel_token token) {
+    while (true) {
+        if (token.stop_requested()) {
+            co_return err<std::size_t>(make_error_from_errno(ECANCELED));
+        }
 
-        const auto wait_result =
-            co_await wait_writable_for(stream.native_handle(), slice);
-        if (!wait_result.has_value() &&
-            !is_timeout_error(wait_result.error())) {
+        auto write_result = stream.write_some_zerocopy(buffers);
+        if (write_result.has_value()) {
+            co_return write_result;
+        }
+
+        if (!simplenet::nonblocking::is_would_block(write_result.error())) {
+            co_return err<std::size_t>(write_result.error());
+        }
+
+        const auto wait_result = co_await retry_wait(
+            stream.native_handle(), false, deadline, token);
+        if (!wait_result.has_value()) {
             co_return err<std::size_t>(wait_result.error());
         }
     }
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <optional>
+
+namespace simplenet::runtime::detail {
+
+/**
+ * Forwards a token's stop request to the loop thread of a scheduler.
+ *
+ * Armed by an awaitable once its wait is registered and disarmed on resume
+ * (or frame destruction), so `on_stop` only ever runs on the loop thread
+ * while the wait may still be parked. `request_stop()` sets the flag before
+ * callbacks run, so a wait registered after the hand-off sees it.
+ */
+class loop_cancellation {
+public:
+    using handler = void (*)(void *context) noexcept;
+
+    loop_cancellation() noexcept = default;
+    ~loop_cancellation() {
+        disarm();
+    }
+
+    loop_cancellation(const loop_cancellation&) = delete;
+    loop_cancellation& operator=(const loop_cancellation&) = delete;
+    loop_cancellation(loop_cancellation&&) = delete;
+    loop_cancellation& operator=(loop_cancellation&&) = delete;
+
+    /// Call `on_stop(context)` on `owner`'s loop once `token` is stopped.
+    void arm(const cancel_token& token, scheduler& owner, handler on_stop,
+             void *context) noexcept {
+        if (!token.stop_possible()) {
+            return;
+        }
+        scheduler_ = &owner;
+        wakeup_.run = &run;
+        wakeup_.context = this;
+        on_stop_ = on_stop;
+        context_ = context;
+        callback_.emplace(token, forward{this});
+    }
+
+    /// Deregister and drop a hand-off that has not reached the loop yet.
+    void disarm() noexcept {
+        if (scheduler_ == nullptr) {
+            return;
+        }
+        callback_.reset();
+        scheduler_->withdraw_wakeup(wakeup_);
+        scheduler_ = nullptr;
+    }
+
+private:
+    struct forward {
+        loop_cancellation *self;
+
+        void operator()() const noexcept {
+            self->scheduler_->post_wakeup(self->wakeup_);
+        }
+    };
+
+    static void run(remote_wakeup& wakeup) noexcept {
+        auto& self = *static_cast<loop_cancellation *>(wakeup.context);
+        self.on_stop_(self.context_);
+    }
+
+    std::optional<cancel_callback<forward>> callback_{};
+    remote_wakeup wakeup_{};
+    scheduler *scheduler_{nullptr};
+    handler on_stop_{nullptr};
+    void *context_{nullptr};
+};
+
+} // namespace simplenet::runtime::detail
@@ -0,0 +1,120 @@
+#include "simplenet/runtime/loop_metrics.hpp"
+
+#include <cstdio>
+
+namespace simplenet::runtime {
+
+namespace {
+
+void append_sample(std::string& out, std::string_view name,
+                   std::string_view loop, std::uint64_t value) {
+    out.append(name);
+    out.append("{loop=\"");
+    out.append(loop);
+    out.append("\"} ");
+    out.append(std::to_string(value));
+    out.push_back('\n');
+}
+
+void append_metric(std::string& out, std::string_view name,
+                   std::string_view type, std::string_view help,
+                   std::string_view loop, std::uint64_t value) {
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+    append_sample(out, name, loop, value);
+}
+
+std::string seconds(std::uint64_t ns) {
+    std::array<char, 32> text{};
+    const int written = std::snprintf(text.data(), text.size(), "%.9g",
+                                      static_cast<double>(ns) * 1e-9);
+    return std::string{text.data(), static_cast<std::size_t>(std::max(written, 0))};
+}
+
+/// One `le` bucket per power of two, up to the one holding `max()`.
+void append_histogram(std::string& out, std::string_view name,
+                      std::string_view help, std::string_view loop,
+                      const latency_histogram& histogram) {
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" histogram\n");
+
+    const auto largest = static_cast<std::uint64_t>(histogram.max().count());
+    std::uint64_t cumulative = 0;
+    for (std::size_t index = 0; index < latency_histogram::bucket_count;
+         ++index) {
+        cumulative += histogram.count_at(index);
+        const auto upper = latency_histogram::bucket_upper_bound(index);
+        const bool row_end =
+            index + 1U == latency_histogram::bucket_count ||
+            latency_histogram::bucket_lower_bound(index + 1U) ==
+                std::bit_ceil(latency_histogram::bucket_lower_bound(index + 1U));
+        if (!row_end) {
+            continue;
+        }
+        out.append(name).append("_bucket{loop=\"").append(loop);
+        out.append("\",le=\"").append(seconds(upper)).append("\"} ");
+        out.append(std::to_string(cumulative)).push_back('\n');
+        if (upper > largest) {
+            break;
+        }
+    }
+    out.append(name).append("_bucket{loop=\"").append(loop);
+    out.append("\",le=\"+Inf\"} ");
+    out.append(std::to_string(histogram.count())).push_back('\n');
+
+    out.append(name).append("_sum{loop=\"").append(loop).append("\"} ");
+    out.append(seconds(static_cast<std::uint64_t>(histogram.sum().count())));
+    out.push_back('\n');
+    append_sample(out, std::string{name} + "_count", loop, histogram.count());
+}
+
+} // namespace
+
+std::string format_prometheus(const loop_metrics& metrics,
+                              std::string_view loop) {
+    std::string out;
+    out.reserve(4096);
+    append_metric(out, "simplenet_loop_iterations_total", "counter",
+                  "Passes through the loop's wait phase.", loop,
+                  metrics.iterations);
+    append_metric(out, "simplenet_loop_events_total", "counter",
+                  "Events or completions reaped by loop waits.", loop,
+                  metrics.events);
+    append_metric(out, "simplenet_loop_max_events_per_wait", "gauge",
+                  "Most events a single wait returned.", loop,
+                  metrics.max_events_per_wait);
+    append_metric(out, "simplenet_loop_resumes_total", "counter",
+                  "Coroutine resumes taken from the ready queue.", loop,
+                  metrics.resumes);
+    append_metric(out, "simplenet_loop_ready_high_water", "gauge",
+                  "Deepest ready queue seen at the start of a resume pass.",
+                  loop, metrics.ready_high_water);
+    append_metric(out, "simplenet_loop_budget_polls_total", "counter",
+                  "Resume passes cut short by the resume budget.", loop,
+                  metrics.budget_polls);
+    append_metric(out, "simplenet_loop_pending_waiters", "gauge",
+                  "Waits, timers and completion I/O outstanding.", loop,
+                  metrics.pending_waiters);
+    append_metric(out, "simplenet_loop_timed_waiters", "gauge",
+                  "Entries on the loop's timer wheel.", loop,
+                  metrics.timed_waiters);
+    append_metric(out, "simplenet_loop_timeouts_fired_total", "counter",
+                  "Timer-wheel entries fired.", loop, metrics.timeouts_fired);
+    append_metric(out, "simplenet_loop_interest_updates_total", "counter",
+                  "epoll_ctl calls.", loop, metrics.interest_updates);
+    append_metric(out, "simplenet_loop_sqes_submitted_total", "counter",
+                  "io_uring SQEs handed to the kernel.", loop,
+                  metrics.sqes_submitted);
+    append_metric(out, "simplenet_loop_submit_calls_total", "counter",
+                  "io_uring_enter calls that submitted SQEs.", loop,
+                  metrics.submit_calls);
+    append_histogram(out, "simplenet_loop_iteration_seconds",
+                     "Busy time of one loop pass.", loop,
+                     metrics.iteration_latency);
+    append_histogram(out, "simplenet_loop_resume_seconds",
+                     "Time one resume ran before suspending.", loop,
+                     metrics.resume_latency);
+    return out;
+}
+
+} // namespace simplenet::runtime
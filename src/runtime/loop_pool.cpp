@@ -0,0 +1,345 @@
+#include "simplenet/runtime/loop_pool.hpp"
+#include "simplenet/runtime/numa.hpp"
+#include "simplenet/runtime/work_stealing_deque.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+namespace {
+
+/// CPUs in the calling thread's affinity mask, in ascending order.
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/// Placement CPUs: the configured or allowed ones, narrowed to the node.
+std::vector<int> placement_cpus(const simplenet::runtime::loop_pool_options& options) {
+    auto cpus = options.cpus.empty() ? allowed_cpus() : options.cpus;
+    std::erase_if(cpus, [](int cpu) { return cpu < 0 || cpu >= CPU_SETSIZE; });
+    if (options.numa_node < 0) {
+        return cpus;
+    }
+    const auto local = simplenet::runtime::numa::cpus_of_node(options.numa_node);
+    std::vector<int> narrowed;
+    for (const int cpu : cpus) {
+        if (std::ranges::find(local, cpu) != local.end()) {
+            narrowed.push_back(cpu);
+        }
+    }
+    return narrowed.empty() ? cpus : narrowed;
+}
+
+} // namespace
+
+namespace simplenet::runtime {
+
+struct loop_pool::worker {
+    loop_pool *pool{nullptr};
+    std::size_t index{0};
+    pthread_t thread{};
+};
+
+/**
+ * Steal state for one loop: its job deque plus the wake-up that runs one
+ * job per pass on the loop thread.
+ */
+struct loop_pool::stealing_worker {
+    work_stealing_deque<detail::steal_job *> jobs{};
+    remote_wakeup pass{};
+    scheduler *loop{nullptr};
+    const std::vector<std::unique_ptr<stealing_worker>> *group{nullptr};
+    std::size_t index{0};
+    /// Round-robin cursor over peers to wake on submission.
+    std::size_t next_peer{0};
+
+    static void run_pass(remote_wakeup& wakeup) noexcept;
+    [[nodiscard]] detail::steal_job *take() noexcept;
+    [[nodiscard]] bool work_visible() const noexcept;
+};
+
+namespace {
+
+/// Pool loop running on this thread while its pool has work stealing on.
+thread_local constinit void *current_stealer = nullptr;
+
+} // namespace
+
+detail::steal_job *loop_pool::stealing_worker::take() noexcept {
+    if (auto *job = jobs.pop()) {
+        return job;
+    }
+    const auto count = group->size();
+    for (std::size_t offset = 1; offset < count; ++offset) {
+        if (auto *job = (*group)[(index + offset) % count]->jobs.steal()) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool loop_pool::stealing_worker::work_visible() const noexcept {
+    return std::ranges::any_of(*group, [](const auto& peer) {
+        return !peer->jobs.empty();
+    });
+}
+
+void loop_pool::stealing_worker::run_pass(remote_wakeup& wakeup) noexcept {
+    auto& self = *static_cast<stealing_worker *>(wakeup.context);
+    auto *job = self.take();
+    if (job == nullptr) {
+        return;
+    }
+    job->run(*job);
+    // One job per pass keeps this loop's own I/O flowing between jobs.
+    if (self.work_visible()) {
+        self.loop->post_wakeup(self.pass);
+    }
+}
+
+bool detail::submit_stealable(steal_job& job) noexcept {
+    auto *self = static_cast<loop_pool::stealing_worker *>(current_stealer);
+    if (self == nullptr) {
+        return false;
+    }
+
+    self->jobs.push(&job);
+    self->loop->post_wakeup(self->pass);
+
+    // Nudge one peer so an idle loop comes to steal.
+    const auto count = self->group->size();
+    if (count > 1) {
+        const auto peer =
+            (self->index + 1 + self->next_peer++ % (count - 1)) % count;
+        auto& target = *(*self->group)[peer];
+        target.loop->post_wakeup(target.pass);
+    }
+    return true;
+}
+
+loop_pool::loop_pool(loop_pool_options options)
+    : options_(std::move(options)), cpus_(placement_cpus(options_)) {
+    // Resolve once so every loop runs the same backend.
+    options_.selected_backend = engine::resolve(options_.selected_backend);
+    auto count = options_.threads;
+    if (count == 0) {
+        count = !cpus_.empty() ? cpus_.size()
+                               : std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    loops_.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        uring_options ring{.queue_depth = options_.uring_queue_depth};
+        if (options_.uring_sqpoll) {
+            ring.sqpoll = true;
+            ring.sqpoll_cpu = options_.sqpoll_cpus.empty()
+                                  ? placement_cpu(index)
+                                  : options_.sqpoll_cpus[index % options_.sqpoll_cpus.size()];
+        }
+        loops_.push_back(std::make_unique<engine>(options_.selected_backend, ring));
+    }
+
+    if (!options_.work_stealing) {
+        return;
+    }
+    stealers_.reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        auto stealer = std::make_unique<stealing_worker>();
+        stealer->pass.run = &stealing_worker::run_pass;
+        stealer->pass.context = stealer.get();
+        stealer->loop = loops_[index]->active_scheduler();
+        stealer->group = &stealers_;
+        stealer->index = index;
+        stealers_.push_back(std::move(stealer));
+    }
+}
+
+loop_pool::~loop_pool() {
+    // Withdraw pending passes before the loops that queue them go away.
+    for (const auto& stealer : stealers_) {
+        stealer->loop->withdraw_wakeup(stealer->pass);
+    }
+}
+
+int loop_pool::cpu(std::size_t index) const noexcept {
+    return index < loops_.size() ? placement_cpu(index) : -1;
+}
+
+int loop_pool::placement_cpu(std::size_t index) const noexcept {
+    if (!options_.pin_threads || cpus_.empty()) {
+        return -1;
+    }
+    return cpus_[index % cpus_.size()];
+}
+
+int loop_pool::numa_node(std::size_t index) const noexcept {
+    return numa::node_of_cpu(cpu(index));
+}
+
+bool loop_pool::valid() const noexcept {
+    return !loops_.empty() &&
+           std::ranges::all_of(loops_, [](const auto& loop) {
+               return loop->valid();
+           });
+}
+
+result<std::vector<nonblocking::tcp_listener>>
+loop_pool::listen_sharded(const nonblocking::endpoint& local, int backlog,
+                          bool steer_by_cpu) const noexcept {
+    std::vector<nonblocking::tcp_listener> listeners;
+    listeners.reserve(loops_.size());
+
+    auto bound = local;
+    nonblocking::listen_options options{.backlog = backlog, .reuse_port = true};
+    for (std::size_t index = 0; index < loops_.size(); ++index) {
+        if (options_.steer_incoming_cpu) {
+            options.socket.incoming_cpu = cpu(index);
+        }
+        auto listener = nonblocking::tcp_listener::bind(bound, options);
+        if (!listener.has_value()) {
+            return err<std::vector<nonblocking::tcp_listener>>(listener.error());
+        }
+        if (index == 0 && bound.port == 0) {
+            const auto port = listener->local_port();
+            if (!port.has_value()) {
+                return err<std::vector<nonblocking::tcp_listener>>(port.error());
+            }
+            bound.port = port.value();
+        }
+        listeners.push_back(std::move(listener.value()));
+    }
+
+    if (steer_by_cpu && !listeners.empty()) {
+        const auto steered = listeners.front().steer_by_cpu(
+            static_cast<std::uint32_t>(listeners.size()));
+        if (!steered.has_value()) {
+            return err<std::vector<nonblocking::tcp_listener>>(steered.error());
+        }
+    }
+    return listeners;
+}
+
+result<void> loop_pool::run() noexcept {
+    if (!valid()) {
+        for (const auto& loop : loops_) {
+            if (!loop->valid()) {
+                // Surfaces the backend's own initialization error.
+                return loop->run();
+            }
+        }
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    {
+        // A pending `stop()` stays set, so it ends this run.
+        std::lock_guard lock{state_mutex_};
+        first_error_.reset();
+    }
+
+    std::vector<worker> workers(loops_.size());
+    std::size_t started = 0;
+    for (; started < workers.size(); ++started) {
+        auto& current = workers[started];
+        current.pool = this;
+        current.index = started;
+
+        pthread_attr_t attributes;
+        if (::pthread_attr_init(&attributes) != 0) {
+            record_error(make_error_from_errno(ENOMEM));
+            break;
+        }
+        if (const int target = cpu(started); target >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(target, &set);
+            // Pinning is a preference; a failure leaves the thread floating.
+            (void)::pthread_attr_setaffinity_np(&attributes, sizeof(set), &set);
+        }
+        const int created = ::pthread_create(&current.thread, &attributes,
+                                             &worker_main, &current);
+        (void)::pthread_attr_destroy(&attributes);
+        if (created != 0) {
+            record_error(make_error_from_errno(created));
+            break;
+        }
+    }
+
+    for (std::size_t index = 0; index < started; ++index) {
+        (void)::pthread_join(workers[index].thread, nullptr);
+    }
+
+    std::lock_guard lock{state_mutex_};
+    stopping_ = false;
+    if (first_error_.has_value()) {
+        return err<void>(*first_error_);
+    }
+    return ok();
+}
+
+void loop_pool::stop() noexcept {
+    std::lock_guard lock{state_mutex_};
+    stopping_ = true;
+    for (const auto& loop : loops_) {
+        loop->stop();
+    }
+}
+
+void *loop_pool::worker_main(void *argument) noexcept {
+    auto& self = *static_cast<worker *>(argument);
+    self.pool->run_worker(self.index);
+    return nullptr;
+}
+
+void loop_pool::run_worker(std::size_t index) noexcept {
+    auto& loop = *loops_[index];
+    loop.spawn(honour_early_stop(index));
+
+    auto *stealer = stealers_.empty() ? nullptr : stealers_[index].get();
+    if (stealer != nullptr) {
+        current_stealer = stealer;
+        stealer->loop->retain_external();
+    }
+    const auto status = loop.run();
+    if (stealer != nullptr) {
+        stealer->loop->release_external();
+        current_stealer = nullptr;
+    }
+    if (!status.has_value()) {
+        record_error(status.error());
+    }
+}
+
+void loop_pool::record_error(error failure) noexcept {
+    {
+        std::lock_guard lock{state_mutex_};
+        if (!first_error_.has_value()) {
+            first_error_ = std::move(failure);
+        }
+    }
+    stop();
+}
+
+task<void> loop_pool::honour_early_stop(std::size_t index) noexcept {
+    // `engine::run()` clears pending stop requests on entry, so a `stop()`
+    // that raced with thread start-up is re-issued from inside the loop.
+    std::lock_guard lock{state_mutex_};
+    if (stopping_) {
+        loops_[index]->stop();
+    }
+    co_return;
+}
+
+} // namespace simplenet::runtime
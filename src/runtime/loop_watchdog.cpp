@@ -0,0 +1,142 @@
+#include "simplenet/runtime/loop_watchdog.hpp"
+
+#include <algorithm>
+
+namespace simplenet::runtime {
+
+namespace {
+
+/// Heartbeat of the resume running on this thread, if it is watched.
+thread_local loop_heartbeat *current_heartbeat = nullptr;
+
+[[nodiscard]] std::int64_t steady_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+void set_stall_tag(const char *tag) noexcept {
+    if (current_heartbeat != nullptr) {
+        current_heartbeat->tag.store(tag, std::memory_order_relaxed);
+    }
+}
+
+stall_monitor::stall_monitor(const watchdog_hook& hook,
+                             std::chrono::milliseconds period)
+    : hook_(&hook), period_(std::max(period, std::chrono::milliseconds{1})) {
+    thread_ = std::thread([this]() { run(); });
+}
+
+stall_monitor::~stall_monitor() {
+    {
+        const std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void stall_monitor::watch(const loop_heartbeat& heartbeat) {
+    const std::lock_guard lock{mutex_};
+    watched_.push_back(
+        {&heartbeat, heartbeat.sequence.load(std::memory_order_relaxed)});
+}
+
+void stall_monitor::unwatch(const loop_heartbeat& heartbeat) noexcept {
+    const std::lock_guard lock{mutex_};
+    std::erase_if(watched_, [&heartbeat](const watched& entry) {
+        return entry.heartbeat == &heartbeat;
+    });
+}
+
+void stall_monitor::run() noexcept {
+    std::unique_lock lock{mutex_};
+    while (!stop_) {
+        cv_.wait_for(lock, period_);
+        if (stop_) {
+            break;
+        }
+        const auto now = steady_ns();
+        for (auto& entry : watched_) {
+            const auto& beat = *entry.heartbeat;
+            // Seqlock read: a resume that ended and another that began
+            // between these loads would pair one's start with the other.
+            const auto sequence = beat.sequence.load(std::memory_order_acquire);
+            const auto started = beat.started.load(std::memory_order_acquire);
+            const auto *coroutine = beat.coroutine.load(std::memory_order_relaxed);
+            const auto *tag = beat.tag.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (started == 0 ||
+                beat.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+            const std::chrono::nanoseconds elapsed{now - started};
+            if (sequence == entry.reported || elapsed < hook_->threshold ||
+                hook_->report == nullptr) {
+                continue;
+            }
+            entry.reported = sequence;
+            // Called under the lock so `unwatch()` cannot race a report.
+            hook_->report(
+                stall_report{
+                    .coroutine = coroutine,
+                    .tag = tag,
+                    .elapsed = elapsed,
+                    .still_running = true,
+                },
+                hook_->context);
+        }
+    }
+}
+
+namespace detail {
+
+void stall_watch::set_hook(watchdog_hook *hook) noexcept {
+    hook_ = hook;
+    // Installed or removed mid-resume: leave nothing half-recorded.
+    heartbeat_.started.store(0, std::memory_order_release);
+    if (current_heartbeat == &heartbeat_) {
+        current_heartbeat = nullptr;
+    }
+}
+
+void stall_watch::start(const void *coroutine) noexcept {
+    heartbeat_.sequence.store(
+        heartbeat_.sequence.load(std::memory_order_relaxed) + 1U,
+        std::memory_order_relaxed);
+    // Orders the new sequence before the fields a monitor reads with it.
+    std::atomic_thread_fence(std::memory_order_release);
+    heartbeat_.coroutine.store(coroutine, std::memory_order_relaxed);
+    heartbeat_.tag.store(nullptr, std::memory_order_relaxed);
+    heartbeat_.started.store(steady_ns(), std::memory_order_release);
+    current_heartbeat = &heartbeat_;
+}
+
+void stall_watch::finish() noexcept {
+    current_heartbeat = nullptr;
+    const auto started = heartbeat_.started.load(std::memory_order_relaxed);
+    if (started == 0) {
+        return;
+    }
+    heartbeat_.started.store(0, std::memory_order_release);
+    const std::chrono::nanoseconds elapsed{steady_ns() - started};
+    if (elapsed < hook_->threshold || hook_->report == nullptr) {
+        return;
+    }
+    hook_->report(
+        stall_report{
+            .coroutine = heartbeat_.coroutine.load(std::memory_order_relaxed),
+            .tag = heartbeat_.tag.load(std::memory_order_relaxed),
+            .elapsed = elapsed,
+            .still_running = false,
+        },
+        hook_->context);
+}
+
+} // namespace detail
+
+} // namespace simplenet::runtime
@@ -0,0 +1,144 @@
+#include "simplenet/runtime/numa.hpp"
+
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+/// First line of `path` without its newline; empty when unreadable.
+std::string read_line(const std::string& path) {
+    std::FILE *file = std::fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return {};
+    }
+    std::array<char, 4096> line{};
+    std::string out;
+    if (std::fgets(line.data(), static_cast<int>(line.size()), file) != nullptr) {
+        out = line.data();
+    }
+    std::fclose(file);
+    while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) {
+        out.pop_back();
+    }
+    return out;
+}
+
+/// Parse a sysfs CPU list such as `0-3,8,10-11`.
+std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    const char *cursor = text.c_str();
+    while (*cursor != '\0') {
+        char *end = nullptr;
+        const long first = std::strtol(cursor, &end, 10);
+        if (end == cursor || first < 0) {
+            return {};
+        }
+        long last = first;
+        cursor = end;
+        if (*cursor == '-') {
+            last = std::strtol(cursor + 1, &end, 10);
+            if (end == cursor + 1 || last < first) {
+                return {};
+            }
+            cursor = end;
+        }
+        for (long cpu = first; cpu <= last && cpu <= INT_MAX; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+        if (*cursor == ',') {
+            ++cursor;
+        } else if (*cursor != '\0') {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+} // namespace
+
+namespace simplenet::runtime::numa {
+
+std::vector<int> cpus_of_node(int node) {
+    if (node < 0) {
+        return {};
+    }
+    return parse_cpu_list(read_line("/sys/devices/system/node/node" +
+                                    std::to_string(node) + "/cpulist"));
+}
+
+int node_of_cpu(int cpu) noexcept {
+    if (cpu < 0) {
+        return -1;
+    }
+    // Each CPU directory holds a `node<N>` link to its node.
+    char path[64];
+    (void)std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR *directory = ::opendir(path);
+    if (directory == nullptr) {
+        return -1;
+    }
+    int node = -1;
+    while (const dirent *entry = ::readdir(directory)) {
+        int parsed = -1;
+        char trailing = '\0';
+        if (std::strncmp(entry->d_name, "node", 4) == 0 &&
+            std::sscanf(entry->d_name + 4, "%d%c", &parsed, &trailing) == 1 &&
+            parsed >= 0) {
+            node = parsed;
+            break;
+        }
+    }
+    ::closedir(directory);
+    return node;
+}
+
+int node_of_interface(std::string_view name) noexcept {
+    if (name.empty() || name.find('/') != std::string_view::npos ||
+        name == "." || name == "..") {
+        return -1;
+    }
+    char path[128];
+    const int length = std::snprintf(path, sizeof(path),
+                                     "/sys/class/net/%.*s/device/numa_node",
+                                     static_cast<int>(name.size()), name.data());
+    if (length < 0 || static_cast<std::size_t>(length) >= sizeof(path)) {
+        return -1;
+    }
+    std::FILE *file = std::fopen(path, "r");
+    if (file == nullptr) {
+        return -1;
+    }
+    int node = -1;
+    if (std::fscanf(file, "%d", &node) != 1) {
+        node = -1;
+    }
+    std::fclose(file);
+    return node < 0 ? -1 : node;
+}
+
+result<void> prefer_node(void *address, std::size_t length, int node) noexcept {
+    constexpr std::size_t kWordBits = sizeof(unsigned long) * CHAR_BIT;
+    std::array<unsigned long, 16> mask{};
+    if (node < 0 || static_cast<std::size_t>(node) >= mask.size() * kWordBits) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+    const auto bit = static_cast<std::size_t>(node);
+    mask[bit / kWordBits] = 1UL << (bit % kWordBits);
+    // The kernel reads one bit fewer than `maxnode`.
+    if (::syscall(SYS_mbind, address, length, MPOL_PREFERRED, mask.data(),
+                  mask.size() * kWordBits + 1U, 0U) == 0) {
+        return ok();
+    }
+    return err<void>(error::from_errno());
+}
+
+} // namespace simplenet::runtime::numa
@@ -0,0 +1,257 @@
+#include "simplenet/runtime/op_latency.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+using simplenet::runtime::latency_histogram;
+using simplenet::runtime::op_backend_count;
+using simplenet::runtime::op_kind_count;
+using simplenet::runtime::op_latency_snapshot;
+
+std::atomic<bool> sampling{false};
+
+[[nodiscard]] std::uint64_t steady_ns() noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/// Tick source picked once per process.
+struct op_clock {
+    bool use_tsc{false};
+    /// Nanoseconds per tick.
+    double scale{1.0};
+
+    op_clock() noexcept {
+#if defined(__x86_64__)
+        // CPUID 0x80000007 EDX bit 8: the TSC ticks at a constant rate
+        // through frequency changes and deep sleep states.
+        unsigned eax = 0;
+        unsigned ebx = 0;
+        unsigned ecx = 0;
+        unsigned edx = 0;
+        if (__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx) == 0 ||
+            (edx & (1U << 8U)) == 0U) {
+            return;
+        }
+        // Calibrate over ~2ms against the monotonic clock.
+        const auto ns_start = steady_ns();
+        const auto tsc_start = __rdtsc();
+        auto ns_end = ns_start;
+        while (ns_end - ns_start < 2'000'000U) {
+            ns_end = steady_ns();
+        }
+        const auto tsc_end = __rdtsc();
+        if (tsc_end <= tsc_start) {
+            return;
+        }
+        scale = static_cast<double>(ns_end - ns_start) /
+                static_cast<double>(tsc_end - tsc_start);
+        use_tsc = true;
+#endif
+    }
+
+    [[nodiscard]] std::uint64_t ticks() const noexcept {
+#if defined(__x86_64__)
+        if (use_tsc) {
+            return __rdtsc();
+        }
+#endif
+        return steady_ns();
+    }
+};
+
+[[nodiscard]] const op_clock& clock_source() noexcept {
+    static const op_clock source{};
+    return source;
+}
+
+/// Written by its owning thread only; read by snapshots on any thread.
+struct shared_histogram {
+    std::array<std::atomic<std::uint64_t>, latency_histogram::bucket_count>
+        counts{};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> max{0};
+
+    void record(std::uint64_t ns) noexcept {
+        // Single writer: plain read-modify-write, no locked instruction.
+        auto& bucket = counts[latency_histogram::bucket_index(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1U,
+                     std::memory_order_relaxed);
+        sum.store(sum.load(std::memory_order_relaxed) + ns,
+                  std::memory_order_relaxed);
+        if (ns > max.load(std::memory_order_relaxed)) {
+            max.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    void read_into(latency_histogram& out) const noexcept {
+        std::array<std::uint64_t, latency_histogram::bucket_count> copy{};
+        for (std::size_t index = 0; index < copy.size(); ++index) {
+            copy[index] = counts[index].load(std::memory_order_relaxed);
+        }
+        out.merge_buckets(
+            copy,
+            std::chrono::nanoseconds{static_cast<std::int64_t>(
+                sum.load(std::memory_order_relaxed))},
+            std::chrono::nanoseconds{static_cast<std::int64_t>(
+                max.load(std::memory_order_relaxed))});
+    }
+};
+
+struct thread_histograms {
+    std::array<std::array<shared_histogram, op_kind_count>, op_backend_count>
+        histograms{};
+    thread_histograms *prev{nullptr};
+    thread_histograms *next{nullptr};
+
+    void read_into(op_latency_snapshot& out) const noexcept {
+        for (std::size_t backend = 0; backend < op_backend_count; ++backend) {
+            for (std::size_t kind = 0; kind < op_kind_count; ++kind) {
+                histograms[backend][kind].read_into(
+                    out.histograms[backend][kind]);
+            }
+        }
+    }
+};
+
+/// Live threads' histograms plus the totals of threads that exited.
+struct registry {
+    std::mutex mutex;
+    thread_histograms *head{nullptr};
+    op_latency_snapshot retired{};
+
+    void attach(thread_histograms& histograms) noexcept {
+        const std::lock_guard lock{mutex};
+        histograms.next = head;
+        if (head != nullptr) {
+            head->prev = &histograms;
+        }
+        head = &histograms;
+    }
+
+    void retire(thread_histograms& histograms) noexcept {
+        const std::lock_guard lock{mutex};
+        histograms.read_into(retired);
+        if (histograms.prev != nullptr) {
+            histograms.prev->next = histograms.next;
+        } else {
+            head = histograms.next;
+        }
+        if (histograms.next != nullptr) {
+            histograms.next->prev = histograms.prev;
+        }
+    }
+};
+
+[[nodiscard]] registry& threads() noexcept {
+    // Leaked so thread exits after static destruction still find it.
+    static auto *instance = new registry{};
+    return *instance;
+}
+
+/// Trivially destructible, so it stays readable while `slot` is torn down.
+thread_local constinit bool slot_retired = false;
+
+struct thread_slot {
+    std::unique_ptr<thread_histograms> histograms;
+
+    ~thread_slot() {
+        slot_retired = true;
+        if (histograms != nullptr) {
+            threads().retire(*histograms);
+        }
+    }
+
+    [[nodiscard]] thread_histograms *get() noexcept {
+        if (slot_retired) {
+            return nullptr;
+        }
+        if (histograms == nullptr) {
+            histograms.reset(new (std::nothrow) thread_histograms{});
+            if (histograms != nullptr) {
+                threads().attach(*histograms);
+            }
+        }
+        return histograms.get();
+    }
+};
+
+thread_local thread_slot slot{};
+
+} // namespace
+
+namespace simplenet::runtime {
+
+void set_op_latency_sampling(bool on) noexcept {
+    if constexpr (metrics_enabled) {
+        if (on) {
+            // Calibrate here rather than inside the first timed operation.
+            (void)clock_source();
+        }
+        sampling.store(on, std::memory_order_relaxed);
+    }
+}
+
+bool op_latency_sampling() noexcept {
+    return sampling.load(std::memory_order_relaxed);
+}
+
+op_latency_snapshot op_latency_thread_snapshot() noexcept {
+    op_latency_snapshot out{};
+    if (!slot_retired && slot.histograms != nullptr) {
+        slot.histograms->read_into(out);
+    }
+    return out;
+}
+
+op_latency_snapshot op_latency_process_snapshot() noexcept {
+    op_latency_snapshot out{};
+    auto& all = threads();
+    const std::lock_guard lock{all.mutex};
+    out.merge(all.retired);
+    for (auto *node = all.head; node != nullptr; node = node->next) {
+        node->read_into(out);
+    }
+    return out;
+}
+
+namespace detail {
+
+std::uint64_t op_clock_ticks() noexcept {
+    return clock_source().ticks();
+}
+
+bool op_latency_flag() noexcept {
+    return sampling.load(std::memory_order_relaxed);
+}
+
+void record_op_latency(op_kind kind, op_backend backend,
+                       std::uint64_t started) noexcept {
+    const auto& source = clock_source();
+    const auto now = source.ticks();
+    auto *histograms = slot.get();
+    if (histograms == nullptr || now < started) {
+        return;
+    }
+    const auto ns = static_cast<std::uint64_t>(
+        static_cast<double>(now - started) * source.scale);
+    histograms->histograms[static_cast<std::size_t>(backend)]
+                          [static_cast<std::size_t>(kind)]
+                              .record(ns);
+}
+
+} // namespace detail
+
+} // namespace simplenet::runtime
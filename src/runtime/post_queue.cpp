@@ -0,0 +1,55 @@
+#include "simplenet/runtime/post_queue.hpp"
+
+namespace simplenet::runtime {
+
+post_queue::~post_queue() {
+    while (auto *work = pop()) {
+        work->complete(*work, false);
+    }
+}
+
+void post_queue::link(posted_work& work) noexcept {
+    work.next.store(nullptr, std::memory_order_relaxed);
+    auto *previous = back_.exchange(&work, std::memory_order_acq_rel);
+    previous->next.store(&work, std::memory_order_release);
+}
+
+bool post_queue::push(posted_work& work) noexcept {
+    link(work);
+    return claim_signal();
+}
+
+posted_work *post_queue::pop() noexcept {
+    auto *front = front_;
+    auto *next = front->next.load(std::memory_order_acquire);
+
+    if (front == &stub_) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        front_ = next;
+        front = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+        front_ = next;
+        return front;
+    }
+
+    if (front != back_.load(std::memory_order_acquire)) {
+        // A producer swapped `back_` but has not linked its node yet.
+        return nullptr;
+    }
+
+    // `front` is the last node: park the stub behind it so it can be taken.
+    link(stub_);
+    next = front->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        front_ = next;
+        return front;
+    }
+    return nullptr;
+}
+
+} // namespace simplenet::runtime
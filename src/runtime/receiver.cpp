@@ -0,0 +1,211 @@
+#include "simplenet/runtime/receiver.hpp"
+
+#include "simplenet/runtime/io_ops.hpp"
+
+#include <cerrno>
+#include <utility>
+
+namespace simplenet::runtime {
+
+borrowed_buffer::borrowed_buffer(scheduler *owner, std::uint16_t id,
+                                 std::span<const std::byte> view) noexcept
+    : owner_(owner), id_(id), view_(view) {}
+
+borrowed_buffer::borrowed_buffer(std::vector<std::byte> owned) noexcept
+    : owned_(std::move(owned)) {
+    view_ = std::span<const std::byte>{owned_.data(), owned_.size()};
+}
+
+borrowed_buffer::~borrowed_buffer() {
+    release();
+}
+
+borrowed_buffer::borrowed_buffer(borrowed_buffer&& other) noexcept
+    : owner_(std::exchange(other.owner_, nullptr)), id_(other.id_),
+      view_(std::exchange(other.view_, {})), owned_(std::move(other.owned_)) {}
+
+borrowed_buffer& borrowed_buffer::operator=(borrowed_buffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        owner_ = std::exchange(other.owner_, nullptr);
+        id_ = other.id_;
+        view_ = std::exchange(other.view_, {});
+        owned_ = std::move(other.owned_);
+    }
+    return *this;
+}
+
+std::span<const std::byte> borrowed_buffer::data() const noexcept {
+    return view_;
+}
+
+std::size_t borrowed_buffer::size() const noexcept {
+    return view_.size();
+}
+
+bool borrowed_buffer::empty() const noexcept {
+    return view_.empty();
+}
+
+void borrowed_buffer::release() noexcept {
+    if (owner_ != nullptr) {
+        owner_->recycle_provided_buffer(id_);
+        owner_ = nullptr;
+    }
+    owned_.clear();
+    view_ = {};
+}
+
+/// Suspends until the multishot request delivers data or terminates.
+class multishot_receiver::next_chunk_awaitable {
+public:
+    explicit next_chunk_awaitable(multishot_receiver& owner) noexcept
+        : owner_(owner) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return !owner_.ready_.empty() || owner_.pending_error_.has_value();
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (!requires(Promise& p) { p.scheduler_ptr(); }) {
+            owner_.fallback_ = true;
+            return false;
+        } else {
+            auto *active = handle.promise().scheduler_ptr();
+            if (active == nullptr || !active->supports_completion_io()) {
+                owner_.fallback_ = true;
+                return false;
+            }
+            if (owner_.waiter_) {
+                owner_.pending_error_ = make_error_from_errno(EBUSY);
+                return false;
+            }
+
+            if (!owner_.armed_) {
+                owner_.scheduler_ = active;
+                owner_.operation_ = io_operation{};
+                owner_.operation_.opcode = io_opcode::recv_multishot;
+                owner_.operation_.fd = owner_.stream_->native_handle();
+                owner_.operation_.on_completion = &multishot_receiver::on_completion;
+                owner_.operation_.context = &owner_;
+
+                const auto submitted = active->submit_io(owner_.operation_);
+                if (!submitted.has_value()) {
+                    if (submitted.error().value() == EINVAL ||
+                        submitted.error().value() == EOPNOTSUPP) {
+                        // No provided-buffer support on this kernel.
+                        owner_.fallback_ = true;
+                    } else {
+                        owner_.pending_error_ = submitted.error();
+                    }
+                    return false;
+                }
+                owner_.armed_ = true;
+            }
+
+            owner_.waiter_ = handle;
+            return true;
+        }
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    multishot_receiver& owner_;
+};
+
+multishot_receiver::multishot_receiver(
+    simplenet::nonblocking::tcp_stream& stream) noexcept
+    : stream_(&stream) {}
+
+multishot_receiver::~multishot_receiver() {
+    if (scheduler_ == nullptr) {
+        return;
+    }
+    if (armed_) {
+        scheduler_->abandon_io(operation_);
+    }
+    for (const auto& pending : ready_) {
+        if (pending.buffer_id >= 0) {
+            scheduler_->recycle_provided_buffer(
+                static_cast<std::uint16_t>(pending.buffer_id));
+        }
+    }
+}
+
+task<result<borrowed_buffer>> multishot_receiver::receive() {
+    if (!stream_->valid()) {
+        co_return err<borrowed_buffer>(make_error_from_errno(EBADF));
+    }
+
+    while (!fallback_) {
+        co_await next_chunk_awaitable{*this};
+
+        if (!ready_.empty()) {
+            const auto next = ready_.front();
+            ready_.pop_front();
+            if (next.buffer_id < 0) {
+                co_return borrowed_buffer{};
+            }
+
+            const auto id = static_cast<std::uint16_t>(next.buffer_id);
+            const auto storage = scheduler_->provided_buffer(id);
+            co_return borrowed_buffer{
+                scheduler_, id,
+                std::span<const std::byte>{storage.data(), next.length}};
+        }
+        if (pending_error_.has_value()) {
+            const auto failure = pending_error_.value();
+            pending_error_.reset();
+            co_return err<borrowed_buffer>(failure);
+        }
+        if (exhausted_) {
+            // Every provided buffer is on loan; serve this read directly.
+            exhausted_ = false;
+            break;
+        }
+    }
+
+    std::vector<std::byte> storage(fallback_buffer_size);
+    const auto received = co_await async_read_some(
+        *stream_, std::span<std::byte>{storage.data(), storage.size()});
+    if (!received.has_value()) {
+        co_return err<borrowed_buffer>(received.error());
+    }
+    storage.resize(received.value());
+    co_return borrowed_buffer{std::move(storage)};
+}
+
+bool multishot_receiver::multishot_active() const noexcept {
+    return armed_;
+}
+
+void multishot_receiver::on_completion(io_operation& operation, int result,
+                                       bool more) noexcept {
+    auto& self = *static_cast<multishot_receiver *>(operation.context);
+    if (!more) {
+        self.armed_ = false;
+    }
+
+    if (result > 0 && operation.buffer_id >= 0) {
+        self.ready_.push_back(
+            chunk{operation.buffer_id, static_cast<std::size_t>(result)});
+    } else if (result == 0) {
+        self.ready_.push_back(chunk{});
+    } else if (result == -ENOBUFS) {
+        self.exhausted_ = true;
+    } else if (result == -EINVAL || result == -EOPNOTSUPP) {
+        self.fallback_ = true;
+    } else if (result < 0 && result != -ECANCELED) {
+        self.pending_error_ = make_error_from_errno(-result);
+    }
+
+    if (self.waiter_ &&
+        (!self.ready_.empty() || self.pending_error_.has_value() ||
+         self.exhausted_ || self.fallback_ || !self.armed_)) {
+        self.scheduler_->schedule(std::exchange(self.waiter_, {}));
+    }
+}
+
+} // namespace simplenet::runtime
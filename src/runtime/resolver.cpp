@@ -2,40 +2,180 @@
 
 #include "simplenet/runtime/io_ops.hpp"
 
+#include "loop_cancellation.hpp"
+
 #include <arpa/inet.h>
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
 #include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <new>
 #include <optional>
 #include <string>
 #include <sys/socket.h>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace {
 
-using namespace std::chrono_literals;
+using address_list = std::vector<simplenet::runtime::socket_address>;
+using simplenet::runtime::detail::posted_handle;
 
 struct resolve_state {
     std::mutex mutex{};
     bool ready{false};
     std::atomic_bool canceled{false};
-    std::optional<simplenet::result<std::vector<simplenet::runtime::endpoint>>>
-        result{};
+    std::optional<simplenet::result<address_list>> result{};
+    /// Parked waiter's resume node; taken once, by the worker or by a stop.
+    posted_handle *resume{nullptr};
 };
 
-simplenet::result<std::vector<simplenet::runtime::endpoint>>
-resolve_ipv4_tcp_endpoints(const std::string& host,
-                           const std::string& service) {
+/// Publish `outcome` and post the parked waiter, if any, to its loop.
+void complete(resolve_state& state,
+              simplenet::result<address_list> outcome) noexcept {
+    posted_handle *resume = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.result = std::move(outcome);
+        state.ready = true;
+        resume = std::exchange(state.resume, nullptr);
+    }
+    if (resume != nullptr && !resume->target->post_work(*resume)) {
+        resume->complete(*resume, false);
+    }
+}
+
+/**
+ * Parks the resolving coroutine until the worker posts it back.
+ *
+ * The resume node is allocated on the loop thread, so the worker's
+ * hand-off cannot fail for lack of memory. A stop request takes the node
+ * back on the loop thread and resumes the waiter with `ECANCELED`.
+ */
+class resolve_awaitable {
+public:
+    resolve_awaitable(std::shared_ptr<resolve_state> state,
+                      simplenet::runtime::cancel_token token) noexcept
+        : state_(std::move(state)), token_(std::move(token)) {}
+
+    resolve_awaitable(const resolve_awaitable&) = delete;
+    resolve_awaitable& operator=(const resolve_awaitable&) = delete;
+
+    ~resolve_awaitable() {
+        if (owner_ == nullptr) {
+            return;
+        }
+        // Destroyed while parked: make sure the worker never posts us.
+        cancellation_.disarm();
+        posted_handle *resume = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            resume = std::exchange(state_->resume, nullptr);
+        }
+        delete resume;
+        state_->canceled.store(true, std::memory_order_release);
+        owner_->release_external();
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->ready;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        simplenet::runtime::scheduler *owner = nullptr;
+        if constexpr (requires(Promise& p) { p.scheduler_ptr(); }) {
+            owner = handle.promise().scheduler_ptr();
+        }
+        if (owner == nullptr) {
+            failure_ = simplenet::make_error_from_errno(EINVAL);
+            return false;
+        }
+
+        auto *resume = new (std::nothrow) posted_handle{};
+        if (resume == nullptr) {
+            failure_ = simplenet::make_error_from_errno(ENOMEM);
+            return false;
+        }
+        resume->complete = &posted_handle::complete_node;
+        resume->handle = handle;
+        resume->target = owner;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->ready) {
+                delete resume;
+                return false;
+            }
+            state_->resume = resume;
+        }
+
+        // The loop thread is this one, so a post cannot run before here.
+        owner_ = owner;
+        owner->retain_external();
+        cancellation_.arm(token_, *owner, &on_stop, this);
+        return true;
+    }
+
+    simplenet::result<address_list> await_resume() noexcept {
+        if (owner_ != nullptr) {
+            cancellation_.disarm();
+            owner_->release_external();
+            owner_ = nullptr;
+        }
+        if (failure_.has_value()) {
+            return simplenet::err<address_list>(*failure_);
+        }
+        if (canceled_) {
+            return simplenet::err<address_list>(
+                simplenet::make_error_from_errno(ECANCELED));
+        }
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return std::move(state_->result.value());
+    }
+
+private:
+    static void on_stop(void *context) noexcept {
+        auto& self = *static_cast<resolve_awaitable *>(context);
+        posted_handle *resume = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(self.state_->mutex);
+            resume = std::exchange(self.state_->resume, nullptr);
+        }
+        if (resume == nullptr) {
+            return; // The worker's post is already on its way.
+        }
+        self.state_->canceled.store(true, std::memory_order_release);
+        self.canceled_ = true;
+        const auto waiter = resume->handle;
+        delete resume;
+        self.owner_->schedule(waiter);
+    }
+
+    std::shared_ptr<resolve_state> state_;
+    simplenet::runtime::cancel_token token_;
+    simplenet::runtime::detail::loop_cancellation cancellation_{};
+    simplenet::runtime::scheduler *owner_{nullptr};
+    std::optional<simplenet::error> failure_{};
+    bool canceled_{false};
+};
+
+simplenet::result<address_list>
+resolve_tcp_addresses(const std::string& host, const std::string& service,
+                      int family) {
     addrinfo hints{};
-    hints.ai_family = AF_INET;
+    hints.ai_family = family;
     hints.ai_socktype = SOCK_STREAM;
     hints.ai_protocol = IPPROTO_TCP;
 
@@ -48,86 +188,303 @@ resolve_ipv4_tcp_endpoints(const std::string& host,
         if      (resolve_status == EAI_AGAIN)  { mapped = EAGAIN; }
         else if (resolve_status == EAI_NONAME) { mapped = ENOENT; }
         else if (resolve_status == EAI_MEMORY) { mapped = ENOMEM; }
-        return simplenet::err<std::vector<simplenet::runtime::endpoint>>(
+        return simplenet::err<address_list>(
             simplenet::make_error_from_errno(mapped));
     }
 
-    std::vector<simplenet::runtime::endpoint> endpoints;
+    address_list addresses;
     for (addrinfo* cursor = raw_result; cursor != nullptr;
          cursor = cursor->ai_next) {
-        if (cursor->ai_family != AF_INET || cursor->ai_addr == nullptr) {
+        if ((cursor->ai_family != AF_INET && cursor->ai_family != AF_INET6) ||
+            cursor->ai_addr == nullptr) {
             continue;
         }
 
-        const auto* ipv4 =
-            reinterpret_cast<const sockaddr_in*>(cursor->ai_addr);
-        char host_buffer[INET_ADDRSTRLEN] = {};
-        const char* converted = ::inet_ntop(AF_INET, &ipv4->sin_addr,
-                                            host_buffer,
-                                            sizeof(host_buffer));
-        if (converted == nullptr) {
-            continue;
+        auto address = simplenet::runtime::socket_address::from_native(
+            cursor->ai_addr, cursor->ai_addrlen);
+        if (address.has_value()) {
+            addresses.push_back(address.value());
         }
-
-        endpoints.push_back(simplenet::runtime::endpoint{
-            std::string{host_buffer}, ntohs(ipv4->sin_port)});
     }
 
     ::freeaddrinfo(raw_result);
 
-    if (endpoints.empty()) {
-        return simplenet::err<std::vector<simplenet::runtime::endpoint>>(
+    if (addresses.empty()) {
+        return simplenet::err<address_list>(
             simplenet::make_error_from_errno(ENOENT));
     }
-    return endpoints;
+    return addresses;
+}
+
+/// Cache key: the three lookup inputs joined by NUL separators.
+std::string cache_key(const std::string& host, const std::string& service,
+                      int family) {
+    std::string key;
+    key.reserve(host.size() + service.size() + 4);
+    key.append(host).push_back('\0');
+    key.append(service).push_back('\0');
+    key.append(std::to_string(family));
+    return key;
+}
+
+/// @return `true` for failures another attempt would repeat.
+bool is_definite_failure(const simplenet::error& failure) noexcept {
+    const int code = failure.value();
+    return code != EAGAIN && code != ENOMEM && code != ECANCELED;
 }
 
-class resolver_worker final {
+/// One `getaddrinfo` call shared by every waiter that asked for `key`.
+struct lookup_job {
+    std::string key;
+    std::string host;
+    std::string service;
+    int family{AF_UNSPEC};
+    /// Guarded by the service mutex.
+    std::vector<std::shared_ptr<resolve_state>> waiters{};
+    /// Set for `detail::post_resolver_job` entries instead of a lookup.
+    std::function<void()> hook{};
+};
+
+struct cache_entry {
+    /// Set while a worker job for this key is queued or running.
+    std::shared_ptr<lookup_job> pending{};
+    std::optional<simplenet::result<address_list>> value{};
+    std::chrono::steady_clock::time_point expires{};
+};
+
+/**
+ * Answer cache plus the worker threads that fill it.
+ *
+ * One mutex guards the cache, the job queue and the counters; workers drop
+ * it while `getaddrinfo` runs.
+ */
+class resolver_service final {
 public:
-    static resolver_worker& instance() {
-        static resolver_worker worker;
-        return worker;
+    static resolver_service& instance() {
+        static resolver_service service;
+        return service;
+    }
+
+    /**
+     * Answer from the cache, or attach `waiter` to a lookup for the key.
+     * @return Cached outcome on a fresh hit; otherwise empty and `waiter`
+     * will be completed by a worker.
+     */
+    std::optional<simplenet::result<address_list>>
+    submit(std::string host, std::string service, int family,
+           const std::shared_ptr<resolve_state>& waiter) {
+        auto key = cache_key(host, service, family);
+        bool queued = false;
+        bool parked_workers = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto now = std::chrono::steady_clock::now();
+            auto found = cache_.find(key);
+            if (found != cache_.end()) {
+                auto& entry = found->second;
+                if (entry.value.has_value() && entry.expires > now) {
+                    ++(entry.value->has_value() ? stats_.hits
+                                                : stats_.negative_hits);
+                    return entry.value;
+                }
+                if (entry.pending != nullptr) {
+                    ++stats_.coalesced;
+                    entry.pending->waiters.push_back(waiter);
+                    return std::nullopt;
+                }
+            } else {
+                make_room(now);
+                found = cache_.emplace(key, cache_entry{}).first;
+            }
+
+            ++stats_.misses;
+            auto job = std::make_shared<lookup_job>(
+                lookup_job{std::move(key), std::move(host), std::move(service),
+                           family});
+            job->waiters.push_back(waiter);
+            found->second.pending = job;
+            jobs_.push_back(std::move(job));
+            queued = true;
+            parked_workers = threads_.size() > options_.workers;
+        }
+        // A parked worker could swallow a lone notification.
+        if (parked_workers) {
+            cv_.notify_all();
+        } else if (queued) {
+            cv_.notify_one();
+        }
+        return std::nullopt;
     }
 
-    void enqueue(std::string host, std::string service,
-                 std::shared_ptr<resolve_state> state) {
+    simplenet::result<void>
+    configure(const simplenet::runtime::resolver_options& options) {
+        if (options.workers == 0 ||
+            options.workers > simplenet::runtime::resolver_max_workers) {
+            return simplenet::err<void>(
+                simplenet::make_error_from_errno(EINVAL));
+        }
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            jobs_.push_back(
-                job{std::move(host), std::move(service), std::move(state)});
+            options_ = options;
+            while (threads_.size() < options.workers) {
+                const std::size_t index = threads_.size();
+                threads_.emplace_back([this, index]() { run(index); });
+            }
+            cap_entries(std::chrono::steady_clock::now());
         }
-        cv_.notify_one();
+        cv_.notify_all();
+        return simplenet::ok();
     }
 
-private:
-    struct job {
-        std::string host;
-        std::string service;
-        std::shared_ptr<resolve_state> state;
-    };
+    void post(std::function<void()> hook) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto job = std::make_shared<lookup_job>();
+            job->hook = std::move(hook);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_all();
+    }
 
-    resolver_worker() : thread_([this]() { run(); }) {}
+    simplenet::runtime::resolver_stats stats() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto copy = stats_;
+        copy.entries = cache_.size();
+        copy.workers = threads_.size();
+        return copy;
+    }
 
-    ~resolver_worker() {
+    void clear() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = cache_.begin(); it != cache_.end();) {
+            if (it->second.pending != nullptr) {
+                it->second.value.reset();
+                ++it;
+            } else {
+                it = cache_.erase(it);
+            }
+        }
+    }
+
+private:
+    resolver_service() {
+        threads_.emplace_back([this]() { run(0); });
+    }
+
+    ~resolver_service() {
         {
             std::lock_guard<std::mutex> lock(mutex_);
             stop_ = true;
         }
-        cv_.notify_one();
-        if (thread_.joinable()) {
-            thread_.join();
+        cv_.notify_all();
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    resolver_service(const resolver_service&) = delete;
+    resolver_service& operator=(const resolver_service&) = delete;
+
+    /// Keep one slot free for a new key. Caller holds `mutex_`.
+    void make_room(std::chrono::steady_clock::time_point now) {
+        if (cache_.size() < options_.max_entries) {
+            return;
+        }
+        std::erase_if(cache_, [now](const auto& item) {
+            return item.second.pending == nullptr && item.second.expires <= now;
+        });
+        if (cache_.size() < options_.max_entries) {
+            return;
+        }
+        evict_oldest();
+    }
+
+    /// Trim after `max_entries` shrank. Caller holds `mutex_`.
+    void cap_entries(std::chrono::steady_clock::time_point now) {
+        while (cache_.size() > options_.max_entries) {
+            const std::size_t before = cache_.size();
+            make_room(now);
+            if (cache_.size() == before) {
+                return;
+            }
+        }
+    }
+
+    /// Drop the settled entry that expires soonest. Caller holds `mutex_`.
+    void evict_oldest() {
+        auto oldest = cache_.end();
+        for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+            if (it->second.pending == nullptr &&
+                (oldest == cache_.end() ||
+                 it->second.expires < oldest->second.expires)) {
+                oldest = it;
+            }
+        }
+        if (oldest != cache_.end()) {
+            cache_.erase(oldest);
+            ++stats_.evictions;
         }
     }
 
-    resolver_worker(const resolver_worker&) = delete;
-    resolver_worker& operator=(const resolver_worker&) = delete;
+    /// Store `outcome` for `job` and hand back its waiters.
+    std::vector<std::shared_ptr<resolve_state>>
+    publish(lookup_job& job, const simplenet::result<address_list>& outcome) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto waiters = std::move(job.waiters);
+        const auto found = cache_.find(job.key);
+        if (found == cache_.end()) {
+            return waiters;
+        }
 
-    void run() {
+        auto& entry = found->second;
+        const auto ttl = outcome.has_value() ? options_.positive_ttl
+                         : is_definite_failure(outcome.error())
+                             ? options_.negative_ttl
+                             : std::chrono::milliseconds{0};
+        if (ttl <= std::chrono::milliseconds{0}) {
+            forget(job);
+            return waiters;
+        }
+        entry.pending.reset();
+        entry.value = outcome;
+        entry.expires = std::chrono::steady_clock::now() + ttl;
+        return waiters;
+    }
+
+    /// @return `true` when every waiter of `job` has gone. Caller holds `mutex_`.
+    static bool abandoned(const lookup_job& job) noexcept {
+        for (const auto& waiter : job.waiters) {
+            if (!waiter->canceled.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Detach `job` from its cache entry. Caller holds `mutex_`.
+    void forget(const lookup_job& job) {
+        const auto found = cache_.find(job.key);
+        if (found == cache_.end()) {
+            return;
+        }
+        found->second.pending.reset();
+        if (!found->second.value.has_value()) {
+            cache_.erase(found);
+        }
+    }
+
+    void run(std::size_t index) {
         while (true) {
-            job next{};
+            std::shared_ptr<lookup_job> next{};
+            std::vector<std::shared_ptr<resolve_state>> abandoned_waiters{};
             {
                 std::unique_lock<std::mutex> lock(mutex_);
-                cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                cv_.wait(lock, [this, index]() {
+                    return stop_ ||
+                           (!jobs_.empty() && index < options_.workers);
+                });
 
                 if (stop_ && jobs_.empty()) {
                     return;
@@ -135,29 +492,43 @@ private:
 
                 next = std::move(jobs_.front());
                 jobs_.pop_front();
+                if (!next->hook && abandoned(*next)) {
+                    // Later callers for this key must get a fresh job.
+                    forget(*next);
+                    abandoned_waiters = std::move(next->waiters);
+                }
+            }
+
+            if (next->hook) {
+                next->hook();
+                continue;
             }
 
-            if (next.state->canceled.load(std::memory_order_acquire)) {
-                std::lock_guard<std::mutex> lock(next.state->mutex);
-                next.state->result = simplenet::err<std::vector<simplenet::runtime::endpoint>>(
-                    simplenet::make_error_from_errno(ECANCELED));
-                next.state->ready = true;
+            if (!abandoned_waiters.empty()) {
+                for (const auto& waiter : abandoned_waiters) {
+                    complete(*waiter, simplenet::err<address_list>(
+                                          simplenet::make_error_from_errno(
+                                              ECANCELED)));
+                }
                 continue;
             }
 
-            auto resolved =
-                resolve_ipv4_tcp_endpoints(next.host, next.service);
-            std::lock_guard<std::mutex> lock(next.state->mutex);
-            next.state->result = std::move(resolved);
-            next.state->ready = true;
+            const auto outcome =
+                resolve_tcp_addresses(next->host, next->service, next->family);
+            for (const auto& waiter : publish(*next, outcome)) {
+                complete(*waiter, outcome);
+            }
         }
     }
 
     std::mutex mutex_{};
     std::condition_variable cv_{};
-    std::deque<job> jobs_{};
+    std::deque<std::shared_ptr<lookup_job>> jobs_{};
+    std::unordered_map<std::string, cache_entry> cache_{};
+    simplenet::runtime::resolver_options options_{};
+    simplenet::runtime::resolver_stats stats_{};
     bool stop_{false};
-    std::thread thread_{};
+    std::vector<std::thread> threads_{};
 };
 
 } // namespace
@@ -165,14 +536,30 @@ private:
 namespace simplenet::runtime {
 
 result<endpoint> parse_ipv4_endpoint(std::string_view value) {
+    auto parsed = parse_endpoint(value);
+    if (!parsed.has_value() || value.front() == '[') {
+        return err<endpoint>(make_error_from_errno(EINVAL));
+    }
+    return parsed;
+}
+
+result<endpoint> parse_endpoint(std::string_view value) {
     const std::size_t separator = value.rfind(':');
     if (separator == std::string_view::npos || separator == 0 ||
         separator + 1 >= value.size()) {
         return err<endpoint>(make_error_from_errno(EINVAL));
     }
 
-    const std::string host{value.substr(0, separator)};
-    const std::string port_text{value.substr(separator + 1)};
+    std::string_view host_text = value.substr(0, separator);
+    const bool bracketed = host_text.front() == '[';
+    if (bracketed) {
+        if (host_text.size() < 3 || host_text.back() != ']') {
+            return err<endpoint>(make_error_from_errno(EINVAL));
+        }
+        host_text = host_text.substr(1, host_text.size() - 2);
+    }
+    const std::string host{host_text};
+    const std::string_view port_text = value.substr(separator + 1);
 
     std::uint32_t port = 0;
     for (const char ch : port_text) {
@@ -185,8 +572,12 @@ result<endpoint> parse_ipv4_endpoint(std::string_view value) {
         }
     }
 
-    in_addr parsed{};
-    if (::inet_pton(AF_INET, host.c_str(), &parsed) != 1) {
+    in_addr ipv4{};
+    in6_addr ipv6{};
+    const bool valid =
+        bracketed ? ::inet_pton(AF_INET6, host.c_str(), &ipv6) == 1
+                  : ::inet_pton(AF_INET, host.c_str(), &ipv4) == 1;
+    if (!valid) {
         return err<endpoint>(make_error_from_errno(EINVAL));
     }
 
@@ -194,38 +585,77 @@ result<endpoint> parse_ipv4_endpoint(std::string_view value) {
 }
 
 std::string format_endpoint(const endpoint& value) {
+    if (value.host.find(':') != std::string::npos) {
+        return "[" + value.host + "]:" + std::to_string(value.port);
+    }
     return value.host + ":" + std::to_string(value.port);
 }
 
-task<result<std::vector<endpoint>>>
-async_resolve(std::string host, std::string service, cancel_token token) {
+task<result<std::vector<socket_address>>>
+async_resolve_addresses(std::string host, std::string service, int family,
+                        cancel_token token) {
     if (token.stop_requested()) {
-        co_return err<std::vector<endpoint>>(make_error_from_errno(ECANCELED));
+        co_return err<address_list>(make_error_from_errno(ECANCELED));
     }
 
     auto state = std::make_shared<resolve_state>();
-    resolver_worker::instance().enqueue(std::move(host), std::move(service),
-                                        state);
+    auto cached = resolver_service::instance().submit(
+        std::move(host), std::move(service), family, state);
+    if (cached.has_value()) {
+        co_return std::move(*cached);
+    }
+    co_return co_await resolve_awaitable{std::move(state), std::move(token)};
+}
 
-    while (true) {
-        if (token.stop_requested()) {
-            state->canceled.store(true, std::memory_order_release);
-            co_return err<std::vector<endpoint>>(
-                make_error_from_errno(ECANCELED));
-        }
+result<void> configure_resolver(const resolver_options& options) {
+    return resolver_service::instance().configure(options);
+}
 
-        {
-            std::lock_guard<std::mutex> lock(state->mutex);
-            if (state->ready) {
-                co_return std::move(state->result.value());
-            }
-        }
+resolver_stats resolver_counters() noexcept {
+    return resolver_service::instance().stats();
+}
 
-        const auto sleep_result = co_await async_sleep(10ms, token);
-        if (!sleep_result.has_value()) {
-            co_return err<std::vector<endpoint>>(sleep_result.error());
+void resolver_cache_clear() noexcept {
+    resolver_service::instance().clear();
+}
+
+task<result<std::vector<endpoint>>>
+async_resolve(std::string host, std::string service, cancel_token token) {
+    const auto addresses = co_await async_resolve_addresses(
+        std::move(host), std::move(service), AF_INET, std::move(token));
+    if (!addresses.has_value()) {
+        co_return err<std::vector<endpoint>>(addresses.error());
+    }
+
+    std::vector<endpoint> endpoints;
+    endpoints.reserve(addresses.value().size());
+    for (const auto& address : addresses.value()) {
+        auto formatted = address.to_endpoint();
+        if (formatted.has_value()) {
+            endpoints.push_back(std::move(formatted.value()));
         }
     }
+    co_return endpoints;
+}
+
+task<result<simplenet::nonblocking::tcp_stream>>
+async_connect(std::string host, std::string service,
+              happy_eyeballs_options options, cancel_token token) {
+    const auto addresses = co_await async_resolve_addresses(
+        std::move(host), std::move(service), AF_UNSPEC, std::move(token));
+    if (!addresses.has_value()) {
+        co_return err<simplenet::nonblocking::tcp_stream>(addresses.error());
+    }
+    co_return co_await async_connect(
+        std::span<const socket_address>{addresses.value()}, options);
 }
 
+namespace detail {
+
+void post_resolver_job(std::function<void()> job) {
+    resolver_service::instance().post(std::move(job));
+}
+
+} // namespace detail
+
 } // namespace simplenet::runtime
@@ -0,0 +1,126 @@
+#include "simplenet/runtime/shared_buffer.hpp"
+
+#include "simplenet/runtime/frame_pool.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace simplenet::runtime {
+
+/// Count and size, followed in the same allocation by the bytes.
+struct shared_buffer::block {
+    std::size_t count{1};
+    std::size_t size{0};
+    buffer_sharing sharing{buffer_sharing::loop_local};
+
+    [[nodiscard]] std::byte *data() noexcept {
+        return reinterpret_cast<std::byte *>(this + 1);
+    }
+    [[nodiscard]] std::size_t allocation() const noexcept {
+        return sizeof(block) + size;
+    }
+    void retain() noexcept {
+        if (sharing == buffer_sharing::loop_local) {
+            ++count;
+        } else {
+            std::atomic_ref{count}.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    /// @return `true` when this dropped the last reference.
+    [[nodiscard]] bool drop() noexcept {
+        if (sharing == buffer_sharing::loop_local) {
+            return --count == 0U;
+        }
+        return std::atomic_ref{count}.fetch_sub(1, std::memory_order_acq_rel) == 1U;
+    }
+};
+
+shared_buffer::~shared_buffer() {
+    release();
+}
+
+shared_buffer::shared_buffer(const shared_buffer& other) noexcept
+    : block_(other.block_) {
+    if (block_ != nullptr) {
+        block_->retain();
+    }
+}
+
+shared_buffer& shared_buffer::operator=(const shared_buffer& other) noexcept {
+    if (block_ != other.block_) {
+        if (other.block_ != nullptr) {
+            other.block_->retain();
+        }
+        release();
+        block_ = other.block_;
+    }
+    return *this;
+}
+
+shared_buffer& shared_buffer::operator=(shared_buffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        block_ = std::exchange(other.block_, nullptr);
+    }
+    return *this;
+}
+
+shared_buffer shared_buffer::copy_of(std::span<const std::byte> bytes,
+                                     buffer_sharing sharing) {
+    auto buffer = allocate(bytes.size(), sharing);
+    if (!bytes.empty()) {
+        std::memcpy(buffer.writable().data(), bytes.data(), bytes.size());
+    }
+    return buffer;
+}
+
+std::span<const std::byte> shared_buffer::bytes() const noexcept {
+    if (block_ == nullptr) {
+        return {};
+    }
+    return {block_->data(), block_->size};
+}
+
+std::size_t shared_buffer::size() const noexcept {
+    return block_ == nullptr ? 0U : block_->size;
+}
+
+std::size_t shared_buffer::use_count() const noexcept {
+    if (block_ == nullptr) {
+        return 0;
+    }
+    if (block_->sharing == buffer_sharing::loop_local) {
+        return block_->count;
+    }
+    return std::atomic_ref{block_->count}.load(std::memory_order_relaxed);
+}
+
+shared_buffer shared_buffer::allocate(std::size_t size, buffer_sharing sharing) {
+    shared_buffer buffer;
+    if (size == 0U) {
+        return buffer;
+    }
+    void *memory = detail::allocate_frame(sizeof(block) + size);
+    buffer.block_ = ::new (memory) block{.size = size, .sharing = sharing};
+    return buffer;
+}
+
+std::span<std::byte> shared_buffer::writable() noexcept {
+    if (block_ == nullptr) {
+        return {};
+    }
+    return {block_->data(), block_->size};
+}
+
+void shared_buffer::release() noexcept {
+    auto *held = std::exchange(block_, nullptr);
+    if (held == nullptr || !held->drop()) {
+        return;
+    }
+    const auto allocation = held->allocation();
+    held->~block();
+    detail::deallocate_frame(held, allocation);
+}
+
+} // namespace simplenet::runtime
@@ -0,0 +1,118 @@
+#include "simplenet/runtime/steady_timer.hpp"
+
+#include "loop_cancellation.hpp"
+
+#include <cerrno>
+#include <utility>
+
+namespace simplenet::runtime {
+
+/// Arms the owner's timer operation and suspends until the loop resumes it.
+class steady_timer::wait_awaitable {
+public:
+    wait_awaitable(steady_timer& owner, cancel_token token) noexcept
+        : owner_(owner), token_(std::move(token)) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return token_.stop_requested() || clock::now() >= owner_.expiry_;
+    }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        if constexpr (!requires(Promise& p) { p.scheduler_ptr(); }) {
+            status_ = err<void>(make_error_from_errno(EINVAL));
+            return false;
+        } else {
+            auto *active = handle.promise().scheduler_ptr();
+            if (active == nullptr) {
+                status_ = err<void>(make_error_from_errno(EINVAL));
+                return false;
+            }
+
+            owner_.operation_.handle = handle;
+            status_ = active->schedule_at(owner_.expiry_, owner_.operation_);
+            if (!status_.has_value()) {
+                return false;
+            }
+
+            owner_.scheduler_ = active;
+            owner_.waiting_ = true;
+            suspended_ = true;
+            cancellation_.arm(token_, *active, &on_stop, &owner_);
+            return true;
+        }
+    }
+
+    [[nodiscard]] result<void> await_resume() noexcept {
+        if (!suspended_) {
+            if (status_.has_value() && token_.stop_requested()) {
+                return err<void>(make_error_from_errno(ECANCELED));
+            }
+            return status_;
+        }
+
+        cancellation_.disarm();
+        owner_.waiting_ = false;
+        if (owner_.operation_.result < 0) {
+            return err<void>(make_error_from_errno(-owner_.operation_.result));
+        }
+        return ok();
+    }
+
+private:
+    static void on_stop(void *context) noexcept {
+        (void)static_cast<steady_timer *>(context)->cancel();
+    }
+
+    steady_timer& owner_;
+    cancel_token token_;
+    detail::loop_cancellation cancellation_{};
+    result<void> status_{ok()};
+    bool suspended_{false};
+};
+
+steady_timer::steady_timer(clock::time_point expiry) noexcept
+    : expiry_(expiry) {}
+
+steady_timer::steady_timer(clock::duration duration) noexcept
+    : expiry_(clock::now() + duration) {}
+
+steady_timer::~steady_timer() {
+    if (waiting_ && scheduler_ != nullptr) {
+        scheduler_->abandon_timer(operation_);
+    }
+}
+
+std::size_t steady_timer::expires_at(clock::time_point expiry) noexcept {
+    const auto cancelled = cancel();
+    expiry_ = expiry;
+    return cancelled;
+}
+
+std::size_t steady_timer::expires_after(clock::duration duration) noexcept {
+    return expires_at(clock::now() + duration);
+}
+
+steady_timer::clock::time_point steady_timer::expiry() const noexcept {
+    return expiry_;
+}
+
+task<result<void>> steady_timer::wait(cancel_token token) {
+    if (waiting_) {
+        co_return err<void>(make_error_from_errno(EBUSY));
+    }
+    co_return co_await wait_awaitable{*this, std::move(token)};
+}
+
+std::size_t steady_timer::cancel() noexcept {
+    if (!waiting_ || scheduler_ == nullptr) {
+        return 0;
+    }
+    return scheduler_->cancel_timer(operation_) ? 1U : 0U;
+}
+
+bool steady_timer::waiting() const noexcept {
+    return waiting_;
+}
+
+} // namespace simplenet::runtime
@@ -0,0 +1,261 @@
+#include "simplenet/runtime/timer_wheel.hpp"
+
+#include <bit>
+
+namespace {
+
+constexpr std::uint64_t kSlotBits = 8;
+constexpr std::uint64_t kSlotMask = (1ULL << kSlotBits) - 1;
+
+[[nodiscard]] constexpr std::size_t slot_index(std::uint64_t tick,
+                                               std::size_t level) noexcept {
+    return static_cast<std::size_t>((tick >> (kSlotBits * level)) & kSlotMask);
+}
+
+} // namespace
+
+namespace simplenet::runtime {
+
+timer_wheel::timer_wheel(clock::time_point epoch) noexcept : epoch_(epoch) {
+    for (auto& level : slots_) {
+        for (auto& head : level) {
+            head.prev = &head;
+            head.next = &head;
+        }
+    }
+    expired_.prev = &expired_;
+    expired_.next = &expired_;
+}
+
+void timer_wheel::schedule(timer_entry& entry,
+                           clock::time_point deadline) noexcept {
+    cancel(entry);
+
+    entry.deadline_ = deadline;
+    entry.expiry_tick_ = to_tick(deadline);
+    ++size_;
+    if (entry.expiry_tick_ <= current_tick_) {
+        entry.level_ = kExpiredLevel;
+        link_tail(expired_, entry);
+        return;
+    }
+    place(entry);
+}
+
+void timer_wheel::cancel(timer_entry& entry) noexcept {
+    if (!entry.scheduled()) {
+        return;
+    }
+    unlink(entry);
+}
+
+std::optional<timer_wheel::clock::time_point>
+timer_wheel::next_expiry() const noexcept {
+    if (expired_.next != &expired_) {
+        return epoch_ + tick{current_tick_};
+    }
+    if (const auto next = next_event_tick()) {
+        return epoch_ + tick{next.value()};
+    }
+    return std::nullopt;
+}
+
+void timer_wheel::advance(clock::time_point now) noexcept {
+    // A tick has passed once `now` reaches it, so round down here while
+    // deadlines round up; together that keeps timers from firing early.
+    const auto target =
+        now <= epoch_ ? std::uint64_t{0}
+                      : static_cast<std::uint64_t>(
+                            std::chrono::floor<tick>(now - epoch_).count());
+    while (current_tick_ < target) {
+        // Empty slots are skipped outright, so idle stretches cost nothing.
+        const auto next = next_event_tick();
+        if (!next.has_value() || next.value() > target) {
+            current_tick_ = target;
+            return;
+        }
+
+        current_tick_ = next.value();
+        if (slot_index(current_tick_, 0) == 0) {
+            // Cascade from the top so re-placed entries land in fresh slots.
+            if (slot_index(current_tick_, 1) == 0) {
+                if (slot_index(current_tick_, 2) == 0) {
+                    cascade(3, slot_index(current_tick_, 3));
+                }
+                cascade(2, slot_index(current_tick_, 2));
+            }
+            cascade(1, slot_index(current_tick_, 1));
+        }
+        move_to_expired(slot_index(current_tick_, 0));
+    }
+}
+
+std::optional<std::uint64_t> timer_wheel::next_event_tick() const noexcept {
+    // Level 0 only holds ticks of the current window, strictly ahead.
+    const auto current_slot = slot_index(current_tick_, 0);
+    if (current_slot + 1 < slots_per_level) {
+        if (const auto slot = next_occupied(0, current_slot + 1)) {
+            return (current_tick_ & ~kSlotMask) | slot.value();
+        }
+    }
+
+    // Coarser levels: a slot's entries all lie inside the current window of
+    // the level above, so the first non-empty slot found is the earliest.
+    for (std::size_t level = 1; level < level_count; ++level) {
+        const auto shift = kSlotBits * level;
+        const auto current = slot_index(current_tick_, level);
+        if (current + 1 < slots_per_level) {
+            if (const auto slot = next_occupied(level, current + 1)) {
+                const auto base = (current_tick_ >> (shift + kSlotBits))
+                                  << (shift + kSlotBits);
+                return base |
+                       (static_cast<std::uint64_t>(slot.value()) << shift);
+            }
+        }
+    }
+
+    // Top level wrapped into its next rotation.
+    const auto top_shift = kSlotBits * (level_count - 1);
+    if (const auto slot = next_occupied(level_count - 1, 0)) {
+        const auto rotation = ((current_tick_ >> (top_shift + kSlotBits)) + 1)
+                              << (top_shift + kSlotBits);
+        return rotation |
+               (static_cast<std::uint64_t>(slot.value()) << top_shift);
+    }
+
+    return std::nullopt;
+}
+
+void timer_wheel::place(timer_entry& entry) noexcept {
+    const auto expiry = entry.expiry_tick_;
+    std::size_t level = 0;
+    std::size_t slot = 0;
+
+    if ((expiry >> kSlotBits) == (current_tick_ >> kSlotBits)) {
+        level = 0;
+        slot = slot_index(expiry, 0);
+    } else if ((expiry >> (2 * kSlotBits)) ==
+               (current_tick_ >> (2 * kSlotBits))) {
+        level = 1;
+        slot = slot_index(expiry, 1);
+    } else if ((expiry >> (3 * kSlotBits)) ==
+               (current_tick_ >> (3 * kSlotBits))) {
+        level = 2;
+        slot = slot_index(expiry, 2);
+    } else {
+        level = 3;
+        const auto top_shift = 3 * kSlotBits;
+        const auto distance =
+            (expiry >> top_shift) - (current_tick_ >> top_shift);
+        if (distance <= kSlotMask) {
+            slot = slot_index(expiry, 3);
+        } else {
+            // Beyond the wheel span: park in the last slot of the rotation
+            // and re-place when it cascades.
+            slot = slot_index(current_tick_ + (kSlotMask << top_shift), 3);
+        }
+    }
+
+    entry.level_ = static_cast<std::uint8_t>(level);
+    entry.slot_ = static_cast<std::uint8_t>(slot);
+    link_tail(slots_[level][slot], entry);
+    occupied_[level][slot / 64] |= 1ULL << (slot % 64);
+}
+
+void timer_wheel::cascade(std::size_t level, std::size_t slot) noexcept {
+    auto& head = slots_[level][slot];
+    if (head.next == &head) {
+        return;
+    }
+
+    detail::timer_link pending{};
+    pending.next = head.next;
+    pending.prev = head.prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    head.next = &head;
+    head.prev = &head;
+    occupied_[level][slot / 64] &= ~(1ULL << (slot % 64));
+
+    while (pending.next != &pending) {
+        auto& entry = *static_cast<timer_entry*>(pending.next);
+        pending.next = entry.next;
+        entry.next->prev = &pending;
+        if (entry.expiry_tick_ <= current_tick_) {
+            entry.level_ = kExpiredLevel;
+            link_tail(expired_, entry);
+        } else {
+            place(entry);
+        }
+    }
+}
+
+void timer_wheel::move_to_expired(std::size_t slot) noexcept {
+    auto& head = slots_[0][slot];
+    if (head.next == &head) {
+        return;
+    }
+
+    for (auto* link = head.next; link != &head; link = link->next) {
+        static_cast<timer_entry*>(link)->level_ = kExpiredLevel;
+    }
+
+    expired_.prev->next = head.next;
+    head.next->prev = expired_.prev;
+    head.prev->next = &expired_;
+    expired_.prev = head.prev;
+    head.next = &head;
+    head.prev = &head;
+    occupied_[0][slot / 64] &= ~(1ULL << (slot % 64));
+}
+
+void timer_wheel::link_tail(detail::timer_link& head,
+                            timer_entry& entry) noexcept {
+    entry.prev = head.prev;
+    entry.next = &head;
+    head.prev->next = &entry;
+    head.prev = &entry;
+}
+
+void timer_wheel::unlink(timer_entry& entry) noexcept {
+    entry.prev->next = entry.next;
+    entry.next->prev = entry.prev;
+    entry.prev = nullptr;
+    entry.next = nullptr;
+    --size_;
+
+    if (entry.level_ == kExpiredLevel) {
+        return;
+    }
+    auto& head = slots_[entry.level_][entry.slot_];
+    if (head.next == &head) {
+        occupied_[entry.level_][entry.slot_ / 64] &=
+            ~(1ULL << (entry.slot_ % 64));
+    }
+}
+
+std::optional<std::size_t>
+timer_wheel::next_occupied(std::size_t level, std::size_t from) const noexcept {
+    const auto& words = occupied_[level];
+    auto word = from / 64;
+    auto bits = words[word] & (~0ULL << (from % 64));
+    while (true) {
+        if (bits != 0) {
+            return word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+        }
+        if (++word == kBitmapWords) {
+            return std::nullopt;
+        }
+        bits = words[word];
+    }
+}
+
+std::uint64_t timer_wheel::to_tick(clock::time_point point) const noexcept {
+    if (point <= epoch_) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(
+        std::chrono::ceil<tick>(point - epoch_).count());
+}
+
+} // namespace simplenet::runtime
@@ -0,0 +1,77 @@
+#include "simplenet/runtime/token_bucket.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace simplenet::runtime {
+
+token_bucket::token_bucket(std::uint64_t rate, std::size_t burst,
+                           clock::time_point now) noexcept {
+    set_rate(rate, burst, now);
+    tokens_ = static_cast<double>(burst_);
+}
+
+void token_bucket::set_rate(std::uint64_t rate, std::size_t burst,
+                            clock::time_point now) noexcept {
+    refill(now);
+    rate_ = rate;
+    if (burst == 0U) {
+        constexpr std::uint64_t kMinimumBurst = 1024;
+        burst = static_cast<std::size_t>(std::min<std::uint64_t>(
+            std::max(rate / 100U, kMinimumBurst),
+            std::numeric_limits<std::size_t>::max()));
+    }
+    burst_ = burst;
+    tokens_ = std::min(tokens_, static_cast<double>(burst_));
+    updated_ = now;
+}
+
+void token_bucket::refill(clock::time_point now) noexcept {
+    if (now <= updated_) {
+        return;
+    }
+    const double elapsed = std::chrono::duration<double>(now - updated_).count();
+    tokens_ = std::min(tokens_ + elapsed * static_cast<double>(rate_),
+                       static_cast<double>(burst_));
+    updated_ = now;
+}
+
+std::size_t token_bucket::available(clock::time_point now) noexcept {
+    if (rate_ == 0U) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    refill(now);
+    return static_cast<std::size_t>(tokens_);
+}
+
+void token_bucket::consume(std::size_t bytes) noexcept {
+    if (rate_ != 0U) {
+        tokens_ = std::max(0.0, tokens_ - static_cast<double>(bytes));
+    }
+}
+
+token_bucket::clock::time_point token_bucket::ready_at(std::size_t bytes,
+                                                       clock::time_point now) noexcept {
+    if (rate_ == 0U) {
+        return now;
+    }
+    refill(now);
+    const double wanted = static_cast<double>(std::min(bytes, burst_));
+    if (tokens_ >= wanted) {
+        return now;
+    }
+    const double seconds = (wanted - tokens_) / static_cast<double>(rate_);
+    return now + std::chrono::ceil<clock::duration>(
+                     std::chrono::duration<double>(seconds));
+}
+
+std::uint64_t token_bucket::rate() const noexcept {
+    return rate_;
+}
+
+std::size_t token_bucket::burst() const noexcept {
+    return burst_;
+}
+
+} // namespace simplenet::runtime
@@ -1,32 +1,81 @@
 #include "simplenet/runtime/uring_event_loop.hpp"
 
 #include <algorithm>
-#include <array>
 #include <cerrno>
 #include <chrono>
+#include <initializer_list>
 #include <limits>
 #include <poll.h>
+#include <span>
 #include <sys/eventfd.h>
 #include <unistd.h>
 
 namespace {
 
+/// Posted work run per loop iteration before I/O is polled again.
+constexpr std::size_t kPostedBatch = 64;
+
+/// Completions reaped per wait until `set_poll_batch()` says otherwise.
+constexpr std::size_t kDefaultPollBatch = 64;
+
+constexpr std::uint16_t kProvidedBufferGroup = 0;
+
 constexpr std::uint32_t kReadPollMask =
     static_cast<std::uint32_t>(POLLIN | POLLERR | POLLHUP | POLLRDHUP);
 constexpr std::uint32_t kWritePollMask =
     static_cast<std::uint32_t>(POLLOUT | POLLERR | POLLHUP);
 
+/**
+ * Readiness polls carry their waiter's address in the token: bit 63 marks a
+ * poll, bits 32-62 hold an arm generation, bits 1-31 the fd and bit 0 the
+ * direction. A CQE is matched against the slot without any lookup map, and
+ * the generation rejects completions of earlier, cancelled arms.
+ */
+constexpr std::uint64_t kPollTokenBit = 1ULL << 63;
+constexpr std::uint64_t kPollGenerationMask = (1ULL << 31) - 1;
+
+[[nodiscard]] constexpr std::uint64_t
+make_poll_token(int fd, bool readable, std::uint64_t generation) noexcept {
+    return kPollTokenBit | ((generation & kPollGenerationMask) << 32) |
+           (static_cast<std::uint64_t>(static_cast<std::uint32_t>(fd)) << 1) |
+           (readable ? 1U : 0U);
+}
+
+[[nodiscard]] constexpr int poll_token_fd(std::uint64_t token) noexcept {
+    return static_cast<int>((token >> 1) & 0x7FFFFFFFU);
+}
+
+[[nodiscard]] constexpr bool poll_token_readable(std::uint64_t token) noexcept {
+    return (token & 1U) != 0U;
+}
+
+/// steady_clock is CLOCK_MONOTONIC, the clock IORING_TIMEOUT_ABS uses.
+[[nodiscard]] __kernel_timespec
+to_kernel_timespec(std::chrono::steady_clock::time_point deadline) noexcept {
+    const auto since_epoch = std::max(deadline.time_since_epoch(),
+                                      std::chrono::steady_clock::duration{0});
+    const auto seconds = std::chrono::floor<std::chrono::seconds>(since_epoch);
+    __kernel_timespec expiry{};
+    expiry.tv_sec = seconds.count();
+    expiry.tv_nsec =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch -
+                                                             seconds)
+            .count();
+    return expiry;
+}
+
 } // namespace
 
 namespace simplenet::runtime {
 
-uring_event_loop::uring_event_loop(std::uint32_t queue_depth) noexcept {
-    waiters_.reserve(static_cast<std::size_t>(queue_depth));
-    inflight_polls_.reserve(static_cast<std::size_t>(queue_depth) * 2U);
-    wait_results_.reserve(static_cast<std::size_t>(queue_depth) * 2U);
-    root_tasks_.reserve(256);
+uring_event_loop::uring_event_loop(std::uint32_t queue_depth) noexcept
+    : uring_event_loop(uring_options{.queue_depth = queue_depth}) {}
+
+uring_event_loop::uring_event_loop(const uring_options& options) noexcept {
+    inflight_ops_.reserve(static_cast<std::size_t>(options.queue_depth) * 2U);
+    set_poll_batch(kDefaultPollBatch);
 
-    auto reactor_result = simplenet::uring::reactor::create(queue_depth);
+    auto reactor_result = simplenet::uring::reactor::create(options);
     if (!reactor_result.has_value()) {
         init_error_ = reactor_result.error();
         return;
@@ -55,6 +104,9 @@ uring_event_loop::uring_event_loop(std::uint32_t queue_depth) noexcept {
 }
 
 uring_event_loop::~uring_event_loop() {
+    // Tear the ring down first so the kernel cannot touch buffers that live in
+    // coroutine frames once those frames are destroyed.
+    reactor_ = simplenet::uring::reactor{};
     destroy_all_roots();
 }
 
@@ -62,6 +114,56 @@ bool uring_event_loop::valid() const noexcept {
     return init_error_.has_value() == false && reactor_.valid();
 }
 
+std::uint32_t uring_event_loop::setup_flags() const noexcept {
+    return reactor_.setup_flags();
+}
+
+void uring_event_loop::set_poll_batch(std::size_t size,
+                                      std::size_t max_size) noexcept {
+    size = std::max<std::size_t>(size, 1);
+    completions_.resize(size);
+    max_poll_batch_ = std::max(size, max_size);
+}
+
+std::size_t uring_event_loop::poll_batch() const noexcept {
+    return completions_.size();
+}
+
+loop_metrics uring_event_loop::metrics() const noexcept {
+    return recorder_.snapshot(pending_waiter_count_,
+                              timers_.size() + inflight_timers_.size());
+}
+
+void uring_event_loop::set_latency_sampling(bool on) noexcept {
+    recorder_.set_sampling(on);
+}
+
+void uring_event_loop::set_metrics_hook(metrics_hook *hook) noexcept {
+    recorder_.set_hook(hook);
+}
+
+bool uring_event_loop::uses_linked_timeouts() const noexcept {
+    return reactor_.supports_link_timeout();
+}
+
+void uring_event_loop::set_resume_budget(
+    std::size_t max_resumes, std::chrono::microseconds max_time) noexcept {
+    budget_.set(max_resumes, max_time);
+}
+
+void uring_event_loop::set_watchdog(watchdog_hook *hook) noexcept {
+    watch_.set_hook(hook);
+}
+
+const loop_heartbeat& uring_event_loop::heartbeat() const noexcept {
+    return watch_.heartbeat();
+}
+
+void uring_event_loop::publish_metrics() noexcept {
+    recorder_.publish(pending_waiter_count_,
+                      timers_.size() + inflight_timers_.size());
+}
+
 result<void> uring_event_loop::run() noexcept {
     if (!valid()) {
         return err<void>(init_error_.value_or(make_error_from_errno(EINVAL)));
@@ -70,15 +172,18 @@ result<void> uring_event_loop::run() noexcept {
     stop_requested_.store(false, std::memory_order_release);
     loop_error_.reset();
 
-    std::array<simplenet::uring::completion, 64> completions{};
-
     while (!stop_requested_.load(std::memory_order_acquire)) {
+        run_remote_wakeups();
+        run_posted_work();
         process_expired_waiters();
         if (stop_requested_.load(std::memory_order_acquire) ||
             loop_error_.has_value()) {
             break;
         }
 
+        recorder_.begin_resumes(ready_queue_.size());
+        budget_.begin_pass();
+        bool budget_spent = false;
         while (!ready_queue_.empty()) {
             const auto handle = ready_queue_.front();
             ready_queue_.pop_front();
@@ -87,7 +192,10 @@ result<void> uring_event_loop::run() noexcept {
                 continue;
             }
 
+            watch_.begin(handle.address());
             handle.resume();
+            watch_.end();
+            recorder_.resumed();
             cleanup_completed_roots();
             process_expired_waiters();
 
@@ -95,6 +203,10 @@ result<void> uring_event_loop::run() noexcept {
                 loop_error_.has_value()) {
                 break;
             }
+            if (budget_.spend()) {
+                budget_spent = true;
+                break;
+            }
         }
 
         if (stop_requested_.load(std::memory_order_acquire) ||
@@ -102,25 +214,34 @@ result<void> uring_event_loop::run() noexcept {
             break;
         }
 
-        if (ready_queue_.empty()) {
-            if (active_task_count_ == 0 && pending_waiter_count_ == 0) {
+        run_drain_hooks();
+
+        // A spent budget still polls, without blocking, so I/O that became
+        // ready meanwhile is not stuck behind coroutines that stay ready.
+        const bool starving = budget_spent && !ready_queue_.empty();
+        if (starving) {
+            recorder_.budget_spent();
+        }
+        if (ready_queue_.empty() || starving) {
+            if (!starving && active_task_count_ == 0 &&
+                pending_waiter_count_ == 0 && external_hold_count_ == 0) {
                 break;
             }
 
-            if (pending_waiter_count_ == 0) {
+            if (!starving && pending_waiter_count_ == 0 &&
+                external_hold_count_ == 0) {
                 return err<void>(make_error_from_errno(EDEADLK));
             }
 
             auto wait_timeout = std::optional<std::chrono::milliseconds>{};
-            if (next_deadline_.has_value()) {
+            if (const auto next_expiry = timers_.next_expiry()) {
                 const auto now = std::chrono::steady_clock::now();
-                const auto remaining = next_deadline_.value() - now;
+                const auto remaining = next_expiry.value() - now;
                 if (remaining <= std::chrono::milliseconds{0}) {
                     wait_timeout = std::chrono::milliseconds{0};
                 } else {
                     const auto clamped = std::min<long long>(
-                        std::chrono::duration_cast<std::chrono::milliseconds>(
-                            remaining)
+                        std::chrono::ceil<std::chrono::milliseconds>(remaining)
                             .count(),
                         static_cast<long long>(
                             std::numeric_limits<int>::max()));
@@ -128,22 +249,44 @@ result<void> uring_event_loop::run() noexcept {
                 }
             }
 
-            const auto submit_result = flush_submissions();
-            if (!submit_result.has_value()) {
-                return submit_result;
+            if (!drain_hooks_.empty() || starving) {
+                wait_timeout = std::chrono::milliseconds{0};
             }
 
-            const auto wait_result = reactor_.wait(completions, wait_timeout);
+            // Submitting and waiting share one kernel entry.
+            recorder_.begin_wait();
+            const auto queued = metrics_enabled ? reactor_.pending_submissions()
+                                                : std::size_t{0};
+            auto wait_result =
+                reactor_.submit_and_wait(completions_, wait_timeout);
+            if (wait_result.has_value()) {
+                submission_pending_ = false;
+                if (queued != 0U) {
+                    recorder_.submitted(queued);
+                }
+            } else if (wait_result.error().value() == EBUSY) {
+                // NODROP backlog: reap first, submit on a later pass.
+                wait_result = reactor_.wait(completions_, wait_timeout);
+            }
             if (!wait_result.has_value()) {
                 return err<void>(wait_result.error());
             }
+            recorder_.waited(wait_result.value());
 
             for (std::size_t i = 0; i < wait_result.value(); ++i) {
-                process_completion(completions[i]);
+                process_completion(completions_[i]);
                 if (loop_error_.has_value()) {
                     break;
                 }
             }
+            if (wait_result.value() == completions_.size() &&
+                completions_.size() < max_poll_batch_) {
+                completions_.resize(
+                    std::min(completions_.size() * 2, max_poll_batch_));
+            }
+            if (recorder_.publish_due(false)) {
+                publish_metrics();
+            }
         }
     }
 
@@ -152,6 +295,9 @@ result<void> uring_event_loop::run() noexcept {
     if (!flush_result.has_value() && !loop_error_.has_value()) {
         loop_error_ = flush_result.error();
     }
+    if (recorder_.publish_due(true)) {
+        publish_metrics();
+    }
 
     if (loop_error_.has_value()) {
         return err<void>(loop_error_.value());
@@ -162,6 +308,10 @@ result<void> uring_event_loop::run() noexcept {
 
 void uring_event_loop::stop() noexcept {
     stop_requested_.store(true, std::memory_order_release);
+    signal_wakeup();
+}
+
+void uring_event_loop::signal_wakeup() noexcept {
     if (!wake_fd_.valid()) {
         return;
     }
@@ -185,104 +335,286 @@ void uring_event_loop::schedule(std::coroutine_handle<> handle) noexcept {
     ready_queue_.push_back(handle);
 }
 
-void uring_event_loop::on_task_completed() noexcept {
+void uring_event_loop::on_task_completed(detail::task_link& root) noexcept {
+    live_roots_.erase(root);
+    finished_roots_.push(root);
+    if (active_task_count_ > 0) {
+        --active_task_count_;
+    }
+}
+
+void uring_event_loop::on_detached_completed(detail::task_link& root) noexcept {
+    live_roots_.erase(root);
     if (active_task_count_ > 0) {
         --active_task_count_;
     }
 }
 
 result<void> uring_event_loop::wait_for_readable(
-    int fd, std::coroutine_handle<> handle,
-    std::optional<std::chrono::milliseconds> timeout,
+    int fd, wait_operation& operation,
+    std::optional<std::chrono::steady_clock::time_point> deadline,
     error timeout_error) noexcept {
-    return arm_waiter(fd, handle, true, timeout, timeout_error);
+    return arm_waiter(fd, operation, true, deadline, timeout_error);
 }
 
 result<void> uring_event_loop::wait_for_writable(
-    int fd, std::coroutine_handle<> handle,
-    std::optional<std::chrono::milliseconds> timeout,
+    int fd, wait_operation& operation,
+    std::optional<std::chrono::steady_clock::time_point> deadline,
     error timeout_error) noexcept {
-    return arm_waiter(fd, handle, false, timeout, timeout_error);
+    return arm_waiter(fd, operation, false, deadline, timeout_error);
+}
+
+bool uring_event_loop::supports_completion_io() const noexcept {
+    return valid();
+}
+
+result<void> uring_event_loop::submit_io(io_operation& operation) noexcept {
+    if (!valid()) {
+        return err<void>(init_error_.value_or(make_error_from_errno(EINVAL)));
+    }
+    if (operation.fd < 0 ||
+        (!operation.handle && operation.on_completion == nullptr)) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+
+    const auto token = allocate_token();
+    const auto queue_result = queue_operation(token, operation);
+    if (!queue_result.has_value()) {
+        return queue_result;
+    }
+
+    operation.token = token;
+    inflight_ops_[token] = &operation;
+    ++pending_waiter_count_;
+    return ok();
+}
+
+void uring_event_loop::abandon_io(io_operation& operation) noexcept {
+    auto it = inflight_ops_.find(operation.token);
+    if (operation.token == 0U || it == inflight_ops_.end() ||
+        it->second != &operation) {
+        return;
+    }
+
+    inflight_ops_.erase(it);
+    abandoned_ops_[operation.token] = operation.opcode;
+    if (pending_waiter_count_ > 0) {
+        --pending_waiter_count_;
+    }
+
+    const auto cancel_result = queue_cancel(operation.token);
+    if (!cancel_result.has_value()) {
+        loop_error_ = cancel_result.error();
+        stop_requested_.store(true, std::memory_order_release);
+    }
+    operation.token = 0;
 }
 
 result<void>
-uring_event_loop::consume_wait_result(std::coroutine_handle<> handle) noexcept {
-    if (!handle) {
+uring_event_loop::schedule_at(std::chrono::steady_clock::time_point deadline,
+                              timer_operation& operation) noexcept {
+    if (!valid()) {
+        return err<void>(init_error_.value_or(make_error_from_errno(EINVAL)));
+    }
+    if (!operation.handle) {
         return err<void>(make_error_from_errno(EINVAL));
     }
+    if (operation.token != 0U) {
+        return err<void>(make_error_from_errno(EBUSY));
+    }
 
-    const auto key = handle_key(handle);
-    auto it = wait_results_.find(key);
-    if (it == wait_results_.end()) {
-        return ok();
+    const auto token = allocate_token();
+    auto& timer = inflight_timers_[token];
+    timer.operation = &operation;
+
+    timer.expiry = to_kernel_timespec(deadline);
+
+    auto submit_result = reactor_.submit_timeout(token, timer.expiry);
+    if (!submit_result.has_value() && submit_result.error().value() == EBUSY) {
+        const auto flush_result = flush_submissions();
+        if (!flush_result.has_value()) {
+            inflight_timers_.erase(token);
+            return flush_result;
+        }
+        submit_result = reactor_.submit_timeout(token, timer.expiry);
+    }
+    if (!submit_result.has_value()) {
+        inflight_timers_.erase(token);
+        return submit_result;
     }
 
-    auto status = std::move(it->second);
-    wait_results_.erase(it);
-    return status;
+    submission_pending_ = true;
+    operation.result = 0;
+    operation.token = token;
+    ++pending_waiter_count_;
+    return ok();
+}
+
+bool uring_event_loop::cancel_timer(timer_operation& operation) noexcept {
+    auto it = inflight_timers_.find(operation.token);
+    if (operation.token == 0U || it == inflight_timers_.end() ||
+        it->second.operation != &operation) {
+        return false;
+    }
+
+    // The timeout CQE then completes with -ECANCELED and resumes the handle.
+    const auto cancel_result = queue_cancel(operation.token);
+    if (!cancel_result.has_value()) {
+        loop_error_ = cancel_result.error();
+        stop_requested_.store(true, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void uring_event_loop::abandon_timer(timer_operation& operation) noexcept {
+    auto it = inflight_timers_.find(operation.token);
+    if (operation.token == 0U || it == inflight_timers_.end() ||
+        it->second.operation != &operation) {
+        return;
+    }
+
+    // Keep the entry (and its timespec) until the final CQE arrives.
+    it->second.operation = nullptr;
+    if (pending_waiter_count_ > 0) {
+        --pending_waiter_count_;
+    }
+
+    const auto cancel_result = queue_cancel(operation.token);
+    if (!cancel_result.has_value()) {
+        loop_error_ = cancel_result.error();
+        stop_requested_.store(true, std::memory_order_release);
+    }
+    operation.token = 0;
+}
+
+bool uring_event_loop::cancel_wait(int fd, bool readable,
+                                   wait_operation& operation) noexcept {
+    auto *slot = waiters_.find(fd);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    auto& registration = readable ? slot->readable : slot->writable;
+    if (registration != &operation) {
+        return false;
+    }
+    fail_registration(registration, make_error_from_errno(ECANCELED));
+    return true;
+}
+
+void uring_event_loop::post_wakeup(remote_wakeup& wakeup) noexcept {
+    if (remote_wakeups_.push(wakeup)) {
+        signal_wakeup();
+    }
+}
+
+void uring_event_loop::withdraw_wakeup(remote_wakeup& wakeup) noexcept {
+    remote_wakeups_.withdraw(wakeup);
+}
+
+result<void> uring_event_loop::register_file(int fd) noexcept {
+    return reactor_.register_file(fd);
+}
+
+result<void> uring_event_loop::unregister_file(int fd) noexcept {
+    return reactor_.unregister_file(fd);
 }
 
 result<void>
-uring_event_loop::arm_waiter(int fd, std::coroutine_handle<> handle,
+uring_event_loop::register_buffers(std::span<const ::iovec> buffers) noexcept {
+    return reactor_.register_buffers(buffers);
+}
+
+result<void> uring_event_loop::unregister_buffers() noexcept {
+    return reactor_.unregister_buffers();
+}
+
+bool uring_event_loop::defer_to_drain(drain_hook& hook) noexcept {
+    drain_hooks_.push(hook);
+    return true;
+}
+
+void uring_event_loop::withdraw_drain_hook(drain_hook& hook) noexcept {
+    drain_hooks_.withdraw(hook);
+}
+
+bool uring_event_loop::post_work(posted_work& work) noexcept {
+    if (posted_.push(work)) {
+        signal_wakeup();
+    }
+    return true;
+}
+
+void uring_event_loop::retain_external() noexcept {
+    ++external_hold_count_;
+}
+
+void uring_event_loop::release_external() noexcept {
+    if (external_hold_count_ > 0) {
+        --external_hold_count_;
+    }
+}
+
+result<void>
+uring_event_loop::arm_waiter(int fd, wait_operation& operation,
                              bool readable,
-                             std::optional<std::chrono::milliseconds> timeout,
+                             std::optional<std::chrono::steady_clock::time_point>
+                                 deadline,
                              error timeout_error) noexcept {
     if (!valid()) {
         return err<void>(init_error_.value_or(make_error_from_errno(EINVAL)));
     }
-    if (fd < 0 || !handle) {
+    if (fd < 0 || !operation.handle) {
         return err<void>(make_error_from_errno(EBADF));
     }
 
-    if (timeout.has_value() &&
-        timeout.value() <= std::chrono::milliseconds{0}) {
-        wait_results_[handle_key(handle)] = err<void>(timeout_error);
-        schedule(handle);
+    operation.status = ok();
+    if (deadline.has_value() &&
+        deadline.value() <= std::chrono::steady_clock::now()) {
+        operation.status = err<void>(timeout_error);
+        schedule(operation.handle);
         return ok();
     }
 
-    auto [it, inserted] = waiters_.try_emplace(fd);
-    (void)inserted;
-    auto& slot = it->second;
-    auto& target = readable ? slot.readable : slot.writable;
-    if (target.handle) {
+    auto *slot = waiters_.get_or_create(fd);
+    if (slot == nullptr) {
+        return err<void>(make_error_from_errno(ENOMEM));
+    }
+    auto& target = readable ? slot->readable : slot->writable;
+    if (target != nullptr) {
         return err<void>(make_error_from_errno(EBUSY));
     }
 
-    const auto token = allocate_token();
-    target.handle = handle;
-    target.timeout_error = timeout_error;
-    target.token = token;
-    if (timeout.has_value()) {
-        target.deadline = std::chrono::steady_clock::now() + timeout.value();
-        ++timed_waiter_count_;
-        if (!next_deadline_.has_value() ||
-            target.deadline.value() < next_deadline_.value()) {
-            next_deadline_ = target.deadline.value();
+    const auto token = make_poll_token(fd, readable, ++poll_generation_);
+    target = &operation;
+    operation.token = token;
+    operation.fd = fd;
+    operation.readable = readable;
+    operation.timer.context = &operation;
+    operation.kernel_deadline =
+        deadline.has_value() && reactor_.supports_link_timeout();
+    if (deadline.has_value()) {
+        // Expiry just completes the wait; the poll completion overwrites this.
+        operation.status = err<void>(timeout_error);
+        if (!operation.kernel_deadline) {
+            timers_.schedule(operation.timer, deadline.value());
         }
-    } else {
-        target.deadline.reset();
     }
-    deadline_index_dirty_ = true;
 
     ++pending_waiter_count_;
-    inflight_polls_[token] = poll_context{fd, readable};
 
+    const auto poll_mask = readable ? kReadPollMask : kWritePollMask;
     const auto add_result =
-        queue_poll_add(token, fd, readable ? kReadPollMask : kWritePollMask);
+        operation.kernel_deadline
+            ? queue_timed_poll_add(token, fd, poll_mask, deadline.value())
+            : queue_poll_add(token, fd, poll_mask);
     if (!add_result.has_value()) {
-        inflight_polls_.erase(token);
-        if (target.deadline.has_value() && timed_waiter_count_ > 0) {
-            --timed_waiter_count_;
-        }
-        target = wait_registration{};
-        deadline_index_dirty_ = true;
+        operation.status = ok();
+        release_registration(target);
         if (pending_waiter_count_ > 0) {
             --pending_waiter_count_;
         }
-        if (!slot.readable.handle && !slot.writable.handle) {
-            waiters_.erase(it);
-        }
         return add_result;
     }
 
@@ -309,120 +641,228 @@ uring_event_loop::queue_poll_add(std::uint64_t token, int fd,
     return ok();
 }
 
-result<void> uring_event_loop::queue_poll_remove(std::uint64_t token) noexcept {
-    if (token == 0U) {
+result<void> uring_event_loop::queue_timed_poll_add(
+    std::uint64_t token, int fd, std::uint32_t poll_mask,
+    std::chrono::steady_clock::time_point deadline) noexcept {
+    // Outlives the SQEs: SQPOLL may read them after the wait is gone.
+    auto& expiry = link_deadlines_[token];
+    expiry = to_kernel_timespec(deadline);
+
+    auto add_result = reactor_.submit_poll_add(token, fd, poll_mask, expiry);
+    if (!add_result.has_value() && add_result.error().value() == EBUSY) {
+        const auto flush_result = flush_submissions();
+        if (!flush_result.has_value()) {
+            link_deadlines_.erase(token);
+            return flush_result;
+        }
+        add_result = reactor_.submit_poll_add(token, fd, poll_mask, expiry);
+    }
+
+    if (!add_result.has_value()) {
+        link_deadlines_.erase(token);
+        return add_result;
+    }
+
+    submission_pending_ = true;
+    return ok();
+}
+
+result<void> uring_event_loop::queue_cancel(std::uint64_t token) noexcept {
+    if (!reactor_.valid()) {
+        // Ring already torn down (loop destruction); nothing left to cancel.
         return ok();
     }
 
-    auto remove_result = reactor_.submit_poll_remove(token);
-    if (!remove_result.has_value() && remove_result.error().value() == EBUSY) {
+    auto cancel_result = reactor_.submit_cancel(token);
+    if (!cancel_result.has_value() && cancel_result.error().value() == EBUSY) {
         const auto flush_result = flush_submissions();
         if (!flush_result.has_value()) {
             return flush_result;
         }
-        remove_result = reactor_.submit_poll_remove(token);
+        cancel_result = reactor_.submit_cancel(token);
+    }
+    if (!cancel_result.has_value()) {
+        return cancel_result;
     }
 
-    if (!remove_result.has_value()) {
-        if (remove_result.error().value() == ENOENT) {
-            return ok();
+    submission_pending_ = true;
+    return ok();
+}
+
+result<void>
+uring_event_loop::queue_operation(std::uint64_t token,
+                                  io_operation& operation) noexcept {
+    auto prepare = [&]() -> result<void> {
+        switch (operation.opcode) {
+        case io_opcode::recv:
+            return reactor_.submit_recv(
+                token, operation.fd,
+                std::span<std::byte>{static_cast<std::byte *>(operation.buffer),
+                                     operation.length});
+        case io_opcode::send:
+            return reactor_.submit_send(
+                token, operation.fd,
+                std::span<const std::byte>{
+                    static_cast<const std::byte *>(operation.buffer),
+                    operation.length});
+        case io_opcode::accept:
+            return reactor_.submit_accept(token, operation.fd);
+        case io_opcode::accept_multishot:
+            return reactor_.submit_multishot_accept(token, operation.fd);
+        case io_opcode::recv_multishot: {
+            const auto buffers = ensure_provided_buffers();
+            if (!buffers.has_value()) {
+                return buffers;
+            }
+            return reactor_.submit_recv_multishot(token, operation.fd,
+                                                  provided_buffers_.group());
         }
-        return remove_result;
+        case io_opcode::send_zc:
+            return reactor_.submit_send_zc(
+                token, operation.fd,
+                std::span<const std::byte>{
+                    static_cast<const std::byte *>(operation.buffer),
+                    operation.length});
+        case io_opcode::recvmsg:
+            return reactor_.submit_recvmsg(
+                token, operation.fd, static_cast<::msghdr *>(operation.buffer));
+        case io_opcode::sendmsg:
+            return reactor_.submit_sendmsg(
+                token, operation.fd,
+                static_cast<const ::msghdr *>(operation.buffer));
+        case io_opcode::splice:
+            return reactor_.submit_splice(token, operation.source_fd,
+                                          operation.source_offset, operation.fd,
+                                          operation.length);
+        case io_opcode::connect:
+            return reactor_.submit_connect(
+                token, operation.fd,
+                static_cast<const sockaddr *>(operation.address),
+                static_cast<socklen_t>(operation.address_length));
+        }
+        return err<void>(make_error_from_errno(EINVAL));
+    };
+
+    auto queue_result = prepare();
+    if (!queue_result.has_value() && queue_result.error().value() == EBUSY) {
+        const auto flush_result = flush_submissions();
+        if (!flush_result.has_value()) {
+            return flush_result;
+        }
+        queue_result = prepare();
+    }
+
+    if (!queue_result.has_value()) {
+        return queue_result;
     }
 
     submission_pending_ = true;
     return ok();
 }
 
+result<void> uring_event_loop::ensure_provided_buffers() noexcept {
+    if (provided_buffers_.valid()) {
+        return ok();
+    }
+
+    auto ring = simplenet::uring::buffer_ring::create(
+        reactor_, kProvidedBufferGroup, provided_buffer_count,
+        provided_buffer_size);
+    if (!ring.has_value()) {
+        return err<void>(ring.error());
+    }
+    provided_buffers_ = std::move(ring.value());
+    return ok();
+}
+
+std::span<std::byte>
+uring_event_loop::provided_buffer(std::uint16_t id) noexcept {
+    return provided_buffers_.buffer(id);
+}
+
+void uring_event_loop::recycle_provided_buffer(std::uint16_t id) noexcept {
+    provided_buffers_.recycle(id);
+}
+
 result<void> uring_event_loop::flush_submissions() noexcept {
     if (!submission_pending_) {
         return ok();
     }
 
+    const auto queued = metrics_enabled ? reactor_.pending_submissions()
+                                        : std::size_t{0};
     const auto submit_result = reactor_.submit();
     if (!submit_result.has_value()) {
+        // With IORING_FEAT_NODROP a CQ overflow backlog refuses new SQEs
+        // until completions are reaped; the next wait does that.
+        if (submit_result.error().value() == EBUSY) {
+            return ok();
+        }
         return submit_result;
     }
 
+    recorder_.submitted(queued);
     submission_pending_ = false;
     return ok();
 }
 
 void uring_event_loop::process_expired_waiters() noexcept {
-    if (timed_waiter_count_ == 0) {
-        next_deadline_.reset();
-        deadline_index_dirty_ = false;
+    if (timers_.empty()) {
         return;
     }
 
-    const auto now = std::chrono::steady_clock::now();
-    if (!deadline_index_dirty_ && next_deadline_.has_value() &&
-        now < next_deadline_.value()) {
-        return;
-    }
-
-    auto next_deadline = std::chrono::steady_clock::time_point::max();
-    bool has_next_deadline = false;
-
-    for (auto it = waiters_.begin(); it != waiters_.end();) {
-        auto expire_registration = [&](wait_registration& registration) {
-            if (!registration.handle || !registration.deadline.has_value() ||
-                now < registration.deadline.value()) {
-                if (registration.handle && registration.deadline.has_value()) {
-                    next_deadline =
-                        std::min(next_deadline, registration.deadline.value());
-                    has_next_deadline = true;
-                }
-                return;
+    const auto fired = timers_.expire(
+        std::chrono::steady_clock::now(), [this](timer_entry& entry) {
+            // The status already holds the timeout error.
+            auto& waiter = *static_cast<wait_operation*>(entry.context);
+            auto *slot = waiters_.find(waiter.fd);
+            if (slot != nullptr && !loop_error_.has_value()) {
+                complete_registration(waiter.readable ? slot->readable
+                                                      : slot->writable);
             }
+        });
+    recorder_.timeouts_fired(fired);
+}
 
-            wait_results_[handle_key(registration.handle)] =
-                err<void>(registration.timeout_error);
-            schedule(registration.handle);
-
-            const auto token = registration.token;
-            if (timed_waiter_count_ > 0) {
-                --timed_waiter_count_;
-            }
-            registration = wait_registration{};
-
-            if (pending_waiter_count_ > 0) {
-                --pending_waiter_count_;
-            }
+void uring_event_loop::fail_registration(wait_operation *& registration,
+                                         error reason) noexcept {
+    if (loop_error_.has_value() || registration == nullptr) {
+        return;
+    }
 
-            if (token != 0U) {
-                inflight_polls_.erase(token);
-                const auto remove_result = queue_poll_remove(token);
-                if (!remove_result.has_value()) {
-                    loop_error_ = remove_result.error();
-                    stop_requested_.store(true, std::memory_order_release);
-                }
-            }
-        };
+    registration->status = err<void>(reason);
+    complete_registration(registration);
+}
 
-        expire_registration(it->second.readable);
-        if (loop_error_.has_value()) {
-            return;
-        }
+void uring_event_loop::complete_registration(
+    wait_operation *& registration) noexcept {
+    if (registration == nullptr) {
+        return;
+    }
 
-        expire_registration(it->second.writable);
-        if (loop_error_.has_value()) {
-            return;
-        }
+    schedule(registration->handle);
+    const auto token = registration->token;
+    release_registration(registration);
+    if (pending_waiter_count_ > 0) {
+        --pending_waiter_count_;
+    }
 
-        if (!it->second.readable.handle && !it->second.writable.handle) {
-            it = waiters_.erase(it);
-        } else {
-            ++it;
+    if (token != 0U) {
+        // The poll's own -ECANCELED CQE then no longer matches any slot.
+        const auto cancel_result = queue_cancel(token);
+        if (!cancel_result.has_value()) {
+            loop_error_ = cancel_result.error();
+            stop_requested_.store(true, std::memory_order_release);
         }
     }
+}
 
-    if (has_next_deadline) {
-        next_deadline_ = next_deadline;
-    } else {
-        next_deadline_.reset();
-    }
-    deadline_index_dirty_ = false;
+void uring_event_loop::release_registration(
+    wait_operation *& registration) noexcept {
+    timers_.cancel(registration->timer);
+    registration->token = 0;
+    registration->kernel_deadline = false;
+    registration = nullptr;
 }
 
 void uring_event_loop::consume_wakeup() noexcept {
@@ -434,6 +874,48 @@ void uring_event_loop::consume_wakeup() noexcept {
     while (::read(wake_fd_.get(), &signal, sizeof(signal)) < 0 && errno == EINTR) {}
 }
 
+void uring_event_loop::run_remote_wakeups() noexcept {
+    // Only the wake-ups queued on entry: one that re-posts itself runs again
+    // after this iteration's I/O instead of starving it.
+    for (auto pending = remote_wakeups_.size(); pending > 0; --pending) {
+        auto *wakeup = remote_wakeups_.pop();
+        if (wakeup == nullptr) {
+            return;
+        }
+        wakeup->run(*wakeup);
+    }
+    if (!remote_wakeups_.empty()) {
+        signal_wakeup();
+    }
+}
+
+void uring_event_loop::run_drain_hooks() noexcept {
+    // Only the hooks queued on entry, so one that defers itself again
+    // cannot keep the loop from polling.
+    for (auto pending = drain_hooks_.size(); pending > 0; --pending) {
+        auto *hook = drain_hooks_.pop();
+        if (hook == nullptr) {
+            return;
+        }
+        hook->run(*hook);
+    }
+}
+
+void uring_event_loop::run_posted_work() noexcept {
+    posted_.rearm();
+    for (std::size_t ran = 0; ran < kPostedBatch; ++ran) {
+        auto *work = posted_.pop();
+        if (work == nullptr) {
+            return;
+        }
+        work->complete(*work, true);
+    }
+    // Batch cut short: make sure the rest gets another iteration.
+    if (posted_.claim_signal()) {
+        signal_wakeup();
+    }
+}
+
 void uring_event_loop::process_completion(
     const simplenet::uring::completion& completion) noexcept {
     const auto token = completion.user_data;
@@ -462,46 +944,118 @@ void uring_event_loop::process_completion(
         return;
     }
 
-    auto inflight_it = inflight_polls_.find(token);
-    if (inflight_it == inflight_polls_.end()) {
+    if ((token & kPollTokenBit) != 0U) {
+        process_poll_completion(completion);
         return;
     }
 
-    const auto context = inflight_it->second;
-    inflight_polls_.erase(inflight_it);
+    if (auto op_it = inflight_ops_.find(token); op_it != inflight_ops_.end()) {
+        auto *operation = op_it->second;
+        const bool more = (completion.flags & IORING_CQE_F_MORE) != 0U;
+        if (!more) {
+            inflight_ops_.erase(op_it);
+            operation->token = 0;
+            if (pending_waiter_count_ > 0) {
+                --pending_waiter_count_;
+            }
+        }
 
-    auto waiter_it = waiters_.find(context.fd);
-    if (waiter_it == waiters_.end()) {
+        // A zero-copy notification keeps the send's own result.
+        if ((completion.flags & IORING_CQE_F_NOTIF) == 0U) {
+            operation->result = completion.result;
+        }
+        operation->buffer_id =
+            (completion.flags & IORING_CQE_F_BUFFER) != 0U
+                ? static_cast<int>(completion.flags >> IORING_CQE_BUFFER_SHIFT)
+                : -1;
+        if (operation->on_completion != nullptr) {
+            operation->on_completion(*operation, completion.result, more);
+        } else if (!more) {
+            // Handle-based operations resume on their final CQE only.
+            schedule(operation->handle);
+        }
         return;
     }
 
-    auto& slot = waiter_it->second;
-    auto& registration = context.readable ? slot.readable : slot.writable;
+    if (auto timer_it = inflight_timers_.find(token);
+        timer_it != inflight_timers_.end()) {
+        auto *operation = timer_it->second.operation;
+        inflight_timers_.erase(timer_it);
+        if (operation == nullptr) {
+            return;
+        }
 
-    if (!registration.handle || registration.token != token) {
+        operation->token = 0;
+        if (pending_waiter_count_ > 0) {
+            --pending_waiter_count_;
+        }
+        // Expiry reports -ETIME; only cancellation is surfaced as an error.
+        if (completion.result == -ETIME) {
+            recorder_.timeouts_fired(1);
+        }
+        operation->result = completion.result == -ETIME ? 0 : completion.result;
+        schedule(operation->handle);
         return;
     }
 
-    if (completion.result >= 0) {
-        wait_results_[handle_key(registration.handle)] = ok();
-    } else {
-        wait_results_[handle_key(registration.handle)] =
-            err<void>(make_error_from_errno(-completion.result));
+    if (abandoned_ops_.contains(token)) {
+        process_abandoned_completion(completion);
+    }
+}
+
+void uring_event_loop::process_poll_completion(
+    const simplenet::uring::completion& completion) noexcept {
+    const auto token = completion.user_data;
+    if (!link_deadlines_.empty()) {
+        link_deadlines_.erase(token);
+    }
+    auto *slot = waiters_.find(poll_token_fd(token));
+    if (slot == nullptr) {
+        return;
     }
 
-    schedule(registration.handle);
-    if (registration.deadline.has_value() && timed_waiter_count_ > 0) {
-        --timed_waiter_count_;
-        deadline_index_dirty_ = true;
+    auto& registration =
+        poll_token_readable(token) ? slot->readable : slot->writable;
+    if (registration == nullptr || registration->token != token) {
+        return;
+    }
+
+    if (completion.result == -ECANCELED && registration->kernel_deadline) {
+        // The linked timeout fired; the status holds the timeout error.
+        recorder_.timeouts_fired(1);
+    } else {
+        registration->status =
+            completion.result >= 0
+                ? ok()
+                : err<void>(make_error_from_errno(-completion.result));
     }
-    registration = wait_registration{};
+    schedule(registration->handle);
+    release_registration(registration);
 
     if (pending_waiter_count_ > 0) {
         --pending_waiter_count_;
     }
+}
 
-    if (!slot.readable.handle && !slot.writable.handle) {
-        waiters_.erase(waiter_it);
+void uring_event_loop::process_abandoned_completion(
+    const simplenet::uring::completion& completion) noexcept {
+    auto it = abandoned_ops_.find(completion.user_data);
+    if (it == abandoned_ops_.end()) {
+        return;
+    }
+
+    const bool accepts = it->second == io_opcode::accept ||
+                         it->second == io_opcode::accept_multishot;
+    if (accepts && completion.result >= 0) {
+        // Nobody is left to own a connection accepted after abandonment.
+        (void)::close(completion.result);
+    }
+    if ((completion.flags & IORING_CQE_F_BUFFER) != 0U) {
+        provided_buffers_.recycle(static_cast<std::uint16_t>(
+            completion.flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+    if ((completion.flags & IORING_CQE_F_MORE) == 0U) {
+        abandoned_ops_.erase(it);
     }
 }
 
@@ -510,47 +1064,53 @@ std::uint64_t uring_event_loop::allocate_token() noexcept {
         auto token = next_token_;
         ++next_token_;
 
-        if (next_token_ == 0U) {
-            ++next_token_;
+        // The top bit is reserved for readiness poll tokens.
+        if ((next_token_ & kPollTokenBit) != 0U) {
+            next_token_ = 1;
         }
 
         if (token == 0U) {
             continue;
         }
 
-        if (!inflight_polls_.contains(token)) {
+        if (!inflight_ops_.contains(token) &&
+            !abandoned_ops_.contains(token) &&
+            !inflight_timers_.contains(token)) {
             return token;
         }
     }
 }
 
-std::uintptr_t
-uring_event_loop::handle_key(std::coroutine_handle<> handle) noexcept {
-    return reinterpret_cast<std::uintptr_t>(handle.address());
+void uring_event_loop::cleanup_completed_roots() noexcept {
+    // Only roots that reached final suspend are listed, so this is O(1)
+    // per finished root and free when none finished.
+    destroy_roots(finished_roots_);
 }
 
-void uring_event_loop::cleanup_completed_roots() noexcept {
-    for (auto it = root_tasks_.begin(); it != root_tasks_.end(); ) {
-        if (it->done()) {
-            it->destroy();
-            it = root_tasks_.erase(it);
-        } else {
-            ++it;
-        }
+void uring_event_loop::destroy_roots(detail::task_list& roots) noexcept {
+    while (!roots.empty()) {
+        auto& root = *roots.front();
+        roots.erase(root);
+        root.frame.destroy();
     }
 }
 
 void uring_event_loop::destroy_all_roots() noexcept {
-    for (auto handle : root_tasks_) {
-        if (handle) {
-            handle.destroy();
+    // Unhook armed deadlines while the frames holding them still exist.
+    waiters_.for_each([this](waiter_slot& slot) {
+        for (auto *registration : {&slot.readable, &slot.writable}) {
+            if (*registration != nullptr) {
+                release_registration(*registration);
+            }
         }
-    }
+    });
+    destroy_roots(live_roots_);
+    destroy_roots(finished_roots_);
 
-    root_tasks_.clear();
     waiters_.clear();
-    inflight_polls_.clear();
-    wait_results_.clear();
+    inflight_ops_.clear();
+    abandoned_ops_.clear();
+    inflight_timers_.clear();
     pending_waiter_count_ = 0;
     active_task_count_ = 0;
 }
@@ -0,0 +1,71 @@
+#include "simplenet/runtime/wakeup_queue.hpp"
+
+namespace simplenet::runtime {
+
+bool wakeup_queue::push(remote_wakeup& wakeup) noexcept {
+    std::lock_guard lock{mutex_};
+    if (wakeup.queued) {
+        return false;
+    }
+
+    const bool was_empty = head_ == nullptr;
+    wakeup.queued = true;
+    wakeup.next = nullptr;
+    wakeup.prev = tail_;
+    if (tail_ != nullptr) {
+        tail_->next = &wakeup;
+    } else {
+        head_ = &wakeup;
+    }
+    tail_ = &wakeup;
+    ++size_;
+    return was_empty;
+}
+
+void wakeup_queue::withdraw(remote_wakeup& wakeup) noexcept {
+    std::lock_guard lock{mutex_};
+    if (!wakeup.queued) {
+        return;
+    }
+
+    if (wakeup.prev != nullptr) {
+        wakeup.prev->next = wakeup.next;
+    } else {
+        head_ = wakeup.next;
+    }
+    if (wakeup.next != nullptr) {
+        wakeup.next->prev = wakeup.prev;
+    } else {
+        tail_ = wakeup.prev;
+    }
+    wakeup.prev = nullptr;
+    wakeup.next = nullptr;
+    wakeup.queued = false;
+    --size_;
+}
+
+remote_wakeup *wakeup_queue::pop() noexcept {
+    std::lock_guard lock{mutex_};
+    auto *wakeup = head_;
+    if (wakeup == nullptr) {
+        return nullptr;
+    }
+
+    head_ = wakeup->next;
+    if (head_ != nullptr) {
+        head_->prev = nullptr;
+    } else {
+        tail_ = nullptr;
+    }
+    wakeup->next = nullptr;
+    wakeup->queued = false;
+    --size_;
+    return wakeup;
+}
+
+std::size_t wakeup_queue::size() noexcept {
+    std::lock_guard lock{mutex_};
+    return size_;
+}
+
+} // namespace simplenet::runtime
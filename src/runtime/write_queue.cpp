@@ -1,32 +1,376 @@
 #include "simplenet/runtime/write_queue.hpp"
 
+#include "simplenet/runtime/op_latency.hpp"
+#include "simplenet/runtime/steady_timer.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <chrono>
+#include <climits>
+#include <coroutine>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <utility>
 
 namespace {
 
-using namespace std::chrono_literals;
+/// Shared-bucket pacing step: one full-sized TCP segment over Ethernet.
+constexpr std::size_t kSharedPacingChunk = 1448;
+
+/**
+ * @brief Parked coroutine used as a callback where a handle is expected.
+ *
+ * Readiness waits resume a coroutine handle; this frame turns each resume
+ * into one `run(context)` call, so the writer can wait for writability
+ * without a task. Once orphaned (`context == nullptr`), it frees itself
+ * after the resumes still queued for it.
+ */
+struct callback_frame {
+    struct promise_type {
+        void (*run)(void *context) noexcept {nullptr};
+        void *context{nullptr};
+        std::size_t orphaned_resumes{0};
+
+        callback_frame get_return_object() noexcept {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+
+    std::coroutine_handle<promise_type> handle{};
+};
+
+/// Yields the running frame's promise without suspending.
+struct own_promise {
+    callback_frame::promise_type *promise{nullptr};
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+    bool await_suspend(
+        std::coroutine_handle<callback_frame::promise_type> self) noexcept {
+        promise = &self.promise();
+        return false;
+    }
+    [[nodiscard]] callback_frame::promise_type& await_resume() const noexcept {
+        return *promise;
+    }
+};
+
+callback_frame make_callback_frame() {
+    auto& promise = co_await own_promise{};
+    for (;;) {
+        co_await std::suspend_always{};
+        if (promise.context != nullptr) {
+            promise.run(promise.context);
+        } else if (--promise.orphaned_resumes == 0U) {
+            co_return;
+        }
+    }
+}
+
+/// Marks an explicit flush in progress for its lifetime.
+class flag_scope {
+public:
+    explicit flag_scope(bool& flag) noexcept : flag_(flag) {
+        flag_ = true;
+    }
+    ~flag_scope() {
+        flag_ = false;
+    }
+
+    flag_scope(const flag_scope&) = delete;
+    flag_scope& operator=(const flag_scope&) = delete;
+
+private:
+    bool& flag_;
+};
 
 } // namespace
 
 namespace simplenet::runtime {
 
+struct queued_writer::auto_flush_state {
+    queued_writer *owner{nullptr};
+    scheduler *loop{nullptr};
+    drain_hook drain{};
+    wait_operation writable{};
+    std::coroutine_handle<callback_frame::promise_type> resumer{};
+    /// Wakes the writer once the pacing buckets have refilled.
+    timer_operation refill{};
+    std::coroutine_handle<callback_frame::promise_type> refill_resumer{};
+    int fd{-1};
+    bool armed{false};
+    bool refill_armed{false};
+    /// Resumes still queued for waits that were cancelled.
+    std::size_t stale_wakes{0};
+    std::optional<error> failure{};
+
+    auto_flush_state(queued_writer& writer, scheduler& target) noexcept
+        : owner(&writer), loop(&target) {
+        drain.run = &on_drain;
+        drain.context = this;
+    }
+
+    ~auto_flush_state() {
+        loop->withdraw_drain_hook(drain);
+        if (refill_resumer) {
+            if (!refill_armed) {
+                refill_resumer.destroy();
+            } else {
+                // Cancelled or already fired, one resume is outstanding.
+                (void)loop->cancel_timer(refill);
+                refill_resumer.promise().context = nullptr;
+                refill_resumer.promise().orphaned_resumes = 1;
+            }
+        }
+        if (!resumer) {
+            return;
+        }
+        auto pending = stale_wakes;
+        if (armed) {
+            // Either this dequeues the waiter or its wake is already queued;
+            // one resume is outstanding in both cases.
+            (void)loop->cancel_wait(fd, false, writable);
+            ++pending;
+        }
+        if (pending == 0U) {
+            resumer.destroy();
+            return;
+        }
+        resumer.promise().context = nullptr;
+        resumer.promise().orphaned_resumes = pending;
+    }
+
+    auto_flush_state(const auto_flush_state&) = delete;
+    auto_flush_state& operator=(const auto_flush_state&) = delete;
+
+    void defer() noexcept {
+        if (!armed && !refill_armed) {
+            (void)loop->defer_to_drain(drain);
+        }
+    }
+
+    void arm(int descriptor) {
+        if (!resumer) {
+            resumer = make_callback_frame().handle;
+            resumer.promise().run = &on_writable;
+            resumer.promise().context = this;
+        }
+        fd = descriptor;
+        writable.handle = resumer;
+        writable.status = ok();
+        writable.after_would_block = true;
+        writable.owned_fd = true;
+        auto armed_result = loop->wait_for_writable(
+            fd, writable, std::nullopt, make_error_from_errno(ETIMEDOUT));
+        if (!armed_result.has_value()) {
+            failure = armed_result.error();
+            return;
+        }
+        armed = true;
+    }
+
+    /// Wake at `at`, when the pacing buckets allow the next write.
+    void arm_refill(std::chrono::steady_clock::time_point at) {
+        if (!refill_resumer) {
+            refill_resumer = make_callback_frame().handle;
+            refill_resumer.promise().run = &on_refill;
+            refill_resumer.promise().context = this;
+        }
+        refill.handle = refill_resumer;
+        auto armed_result = loop->schedule_at(at, refill);
+        if (!armed_result.has_value()) {
+            failure = armed_result.error();
+            return;
+        }
+        refill_armed = true;
+    }
+
+    /// Hand the socket to an explicit flush; a queued wake becomes stale.
+    void pause() noexcept {
+        loop->withdraw_drain_hook(drain);
+        if (armed) {
+            (void)loop->cancel_wait(fd, false, writable);
+            armed = false;
+            ++stale_wakes;
+        }
+    }
+
+    static void on_drain(drain_hook& hook) noexcept {
+        static_cast<auto_flush_state *>(hook.context)->owner->auto_flush_now();
+    }
+
+    /// A refill that fires during an explicit flush finds `flushing_` set.
+    static void on_refill(void *context) noexcept {
+        auto& self = *static_cast<auto_flush_state *>(context);
+        self.refill_armed = false;
+        self.owner->auto_flush_now();
+    }
+
+    static void on_writable(void *context) noexcept {
+        auto& self = *static_cast<auto_flush_state *>(context);
+        if (self.stale_wakes > 0U) {
+            --self.stale_wakes;
+            return;
+        }
+        self.armed = false;
+        if (!self.writable.status.has_value()) {
+            self.failure = self.writable.status.error();
+            return;
+        }
+        self.owner->auto_flush_now();
+    }
+};
+
 queued_writer::queued_writer(simplenet::nonblocking::tcp_stream stream,
-                             watermarks marks)
-    : stream_(std::move(stream)), marks_(marks) {
+                             watermarks marks, coalescing coalesce,
+                             zerocopy_send zerocopy)
+    : stream_(std::move(stream)), marks_(marks), coalesce_(coalesce),
+      zerocopy_(zerocopy) {
     if (marks_.low == 0) {
         marks_.low = 1;
     }
     if (marks_.high < marks_.low) {
         marks_.high = marks_.low;
     }
+    if (marks_.kernel_unsent != 0U) {
+        // Best effort, like zero-copy below: without it the writer still
+        // works, only with more bytes parked in the kernel.
+        const auto lowat = std::min<std::size_t>(marks_.kernel_unsent, INT_MAX);
+        (void)stream_.set_options(
+            {.notsent_lowat = static_cast<std::uint32_t>(lowat)});
+    }
+    if (coalesce_.chunk_size < coalesce_.max_message) {
+        coalesce_.chunk_size = coalesce_.max_message;
+    }
+    if (zerocopy_.min_bytes != 0U && !stream_.zerocopy_enabled() &&
+        !stream_.enable_zerocopy().has_value()) {
+        zerocopy_.min_bytes = 0;
+    }
+}
+
+queued_writer::queued_writer(simplenet::nonblocking::local_stream stream,
+                             watermarks marks, coalescing coalesce)
+    : queued_writer(std::move(stream.socket()),
+                    watermarks{.low = marks.low, .high = marks.high}, coalesce) {}
+
+queued_writer::queued_writer(queued_writer&& other) noexcept
+    : stream_(std::move(other.stream_)), marks_(other.marks_),
+      coalesce_(other.coalesce_), zerocopy_(other.zerocopy_),
+      pacing_(std::move(other.pacing_)), bucket_(other.bucket_),
+      queue_(std::move(other.queue_)),
+      spare_chunk_(std::move(other.spare_chunk_)),
+      zerocopy_inflight_(std::move(other.zerocopy_inflight_)),
+      gather_(std::move(other.gather_)), front_offset_(other.front_offset_),
+      queued_bytes_(other.queued_bytes_), spent_shared_(other.spent_shared_),
+      high_watermark_active_(other.high_watermark_active_),
+      flushing_(other.flushing_), auto_flush_(std::move(other.auto_flush_)) {
+    if (auto_flush_ != nullptr) {
+        auto_flush_->owner = this;
+    }
+}
+
+queued_writer& queued_writer::operator=(queued_writer&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    // Tear down our hooks before the stream they refer to goes away.
+    auto_flush_.reset();
+    stream_ = std::move(other.stream_);
+    marks_ = other.marks_;
+    coalesce_ = other.coalesce_;
+    zerocopy_ = other.zerocopy_;
+    pacing_ = std::move(other.pacing_);
+    bucket_ = other.bucket_;
+    queue_ = std::move(other.queue_);
+    spare_chunk_ = std::move(other.spare_chunk_);
+    zerocopy_inflight_ = std::move(other.zerocopy_inflight_);
+    gather_ = std::move(other.gather_);
+    front_offset_ = other.front_offset_;
+    queued_bytes_ = other.queued_bytes_;
+    spent_shared_ = other.spent_shared_;
+    high_watermark_active_ = other.high_watermark_active_;
+    flushing_ = other.flushing_;
+    auto_flush_ = std::move(other.auto_flush_);
+    if (auto_flush_ != nullptr) {
+        auto_flush_->owner = this;
+    }
+    return *this;
+}
+
+queued_writer::~queued_writer() = default;
+
+void queued_writer::enable_auto_flush(scheduler& loop) {
+    auto_flush_ = std::make_unique<auto_flush_state>(*this, loop);
+    if (queued_bytes_ > 0U) {
+        auto_flush_->defer();
+    }
+}
+
+void queued_writer::set_pacing(pacing policy) {
+    const bool was_kernel = pacing_.kernel;
+    if (policy.kernel && policy.rate != 0U) {
+        // Best effort, like zero-copy: a refusal leaves the bucket to do it.
+        policy.kernel = stream_.set_max_pacing_rate(policy.rate).has_value();
+    } else {
+        policy.kernel = false;
+    }
+    if (was_kernel && !policy.kernel) {
+        (void)stream_.set_max_pacing_rate(0);
+    }
+
+    if (policy.rate == 0U || policy.kernel) {
+        bucket_.reset();
+    } else if (bucket_.has_value()) {
+        bucket_->set_rate(policy.rate, policy.burst);
+    } else {
+        bucket_.emplace(policy.rate, policy.burst);
+    }
+    pacing_ = std::move(policy);
+    if (auto_flush_ != nullptr && queued_bytes_ > 0U) {
+        auto_flush_->defer();
+    }
+}
+
+const pacing& queued_writer::current_pacing() const noexcept {
+    return pacing_;
+}
+
+bool queued_writer::auto_flush_enabled() const noexcept {
+    return auto_flush_ != nullptr;
 }
 
 result<backpressure_state>
 queued_writer::enqueue(std::span<const std::byte> bytes) {
-    std::vector<std::byte> copy(bytes.begin(), bytes.end());
-    return enqueue_owned(std::move(copy));
+    if (bytes.size() > coalesce_.max_message) {
+        std::vector<std::byte> copy(bytes.begin(), bytes.end());
+        return enqueue_owned(std::move(copy));
+    }
+
+    if (auto admitted = admit(); !admitted.has_value()) {
+        return err<backpressure_state>(admitted.error());
+    }
+    if (bytes.empty()) {
+        return state();
+    }
+    if (rejecting()) {
+        return err<backpressure_state>(make_error_from_errno(EWOULDBLOCK));
+    }
+
+    append_coalesced(bytes);
+    return note_enqueued(bytes.size());
 }
 
 result<backpressure_state>
@@ -36,60 +380,196 @@ queued_writer::enqueue(std::vector<std::byte>&& bytes) {
 
 result<backpressure_state>
 queued_writer::enqueue_owned(std::vector<std::byte>&& bytes) {
-    if (!stream_.valid()) {
-        return err<backpressure_state>(make_error_from_errno(EBADF));
+    if (auto admitted = admit(); !admitted.has_value()) {
+        return err<backpressure_state>(admitted.error());
     }
 
     if (bytes.empty()) {
-        return high_watermark_active_ ? backpressure_state::high_watermark
-                                      : backpressure_state::normal;
+        return state();
+    }
+    if (rejecting()) {
+        return err<backpressure_state>(make_error_from_errno(EWOULDBLOCK));
+    }
+
+    const auto size = bytes.size();
+    queue_.push_back(queued_buffer{.data = std::move(bytes)});
+    return note_enqueued(size);
+}
+
+result<backpressure_state> queued_writer::enqueue(shared_buffer bytes) {
+    if (auto admitted = admit(); !admitted.has_value()) {
+        return err<backpressure_state>(admitted.error());
     }
 
-    if (high_watermark_active_ && queued_bytes_ >= marks_.low) {
+    if (bytes.empty()) {
+        return state();
+    }
+    if (rejecting()) {
         return err<backpressure_state>(make_error_from_errno(EWOULDBLOCK));
     }
 
-    queued_bytes_ += bytes.size();
-    queue_.push_back(std::move(bytes));
+    const auto size = bytes.size();
+    queue_.push_back(queued_buffer{.data = std::move(bytes)});
+    return note_enqueued(size);
+}
 
-    if (queued_bytes_ >= marks_.high) {
-        high_watermark_active_ = true;
+result<backpressure_state> queued_writer::enqueue(pooled_buffer&& bytes) {
+    if (auto admitted = admit(); !admitted.has_value()) {
+        return err<backpressure_state>(admitted.error());
+    }
+
+    if (bytes.size() == 0U) {
+        return state();
+    }
+    if (rejecting()) {
+        return err<backpressure_state>(make_error_from_errno(EWOULDBLOCK));
+    }
+
+    const auto size = bytes.size();
+    queue_.push_back(queued_buffer{.data = std::move(bytes)});
+    return note_enqueued(size);
+}
+
+result<backpressure_state>
+queued_writer::enqueue_file(int file_fd, std::uint64_t offset,
+                            std::size_t count) {
+    if (auto admitted = admit(); !admitted.has_value()) {
+        return err<backpressure_state>(admitted.error());
+    }
+    if (file_fd < 0) {
+        return err<backpressure_state>(make_error_from_errno(EBADF));
+    }
+    if (count == 0U) {
+        return state();
     }
+    if (rejecting()) {
+        return err<backpressure_state>(make_error_from_errno(EWOULDBLOCK));
+    }
+
+    queue_.push_back(queued_buffer{
+        .data = file_region{.fd = file_fd, .offset = offset, .length = count}});
+    return note_enqueued(count);
+}
+
+void queued_writer::append_coalesced(std::span<const std::byte> bytes) {
+    // Appends stay within the reserved capacity, so a flush in progress
+    // never sees a chunk move.
+    auto *tail = queue_.empty() || !queue_.back().coalesced
+                     ? nullptr
+                     : std::get_if<std::vector<std::byte>>(&queue_.back().data);
+    if (tail == nullptr || tail->capacity() - tail->size() < bytes.size()) {
+        auto chunk = std::move(spare_chunk_);
+        spare_chunk_ = {};
+        chunk.clear();
+        chunk.reserve(coalesce_.chunk_size);
+        queue_.push_back(
+            queued_buffer{.data = std::move(chunk), .coalesced = true});
+        tail = std::get_if<std::vector<std::byte>>(&queue_.back().data);
+    }
+    tail->insert(tail->end(), bytes.begin(), bytes.end());
+}
 
+result<void> queued_writer::admit() const noexcept {
+    if (!stream_.valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (auto_flush_ != nullptr && auto_flush_->failure.has_value()) {
+        return err<void>(auto_flush_->failure.value());
+    }
+    return ok();
+}
+
+bool queued_writer::rejecting() const noexcept {
+    return high_watermark_active_ && queued_bytes_ >= marks_.low;
+}
+
+backpressure_state queued_writer::state() const noexcept {
     return high_watermark_active_ ? backpressure_state::high_watermark
                                   : backpressure_state::normal;
 }
 
+backpressure_state queued_writer::note_enqueued(std::size_t bytes) noexcept {
+    queued_bytes_ += bytes;
+    if (queued_bytes_ >= marks_.high) {
+        high_watermark_active_ = true;
+    }
+    if (auto_flush_ != nullptr) {
+        auto_flush_->defer();
+    }
+    return state();
+}
+
 task<result<void>> queued_writer::flush(std::chrono::milliseconds timeout,
                                         cancel_token token) {
     if (timeout < std::chrono::milliseconds{0}) {
         co_return err<void>(make_error_from_errno(EINVAL));
     }
 
+    if (auto_flush_ != nullptr) {
+        if (auto_flush_->failure.has_value()) {
+            co_return err<void>(auto_flush_->failure.value());
+        }
+        auto_flush_->pause();
+    }
+    const flag_scope flushing{flushing_};
+    if (queued_bytes_ == 0) {
+        co_return ok();
+    }
+    const auto timer = co_await detail::start_op_timer{op_kind::flush};
+
     const auto deadline = std::chrono::steady_clock::now() + timeout;
     while (queued_bytes_ > 0) {
         if (token.stop_requested()) {
             co_return err<void>(make_error_from_errno(ECANCELED));
         }
 
-        const auto now = std::chrono::steady_clock::now();
-        if (now >= deadline) {
-            co_return err<void>(make_error_from_errno(ETIMEDOUT));
+        reap_zerocopy();
+
+        const auto allowance = pacing_allowance();
+        if (allowance == 0U) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                co_return err<void>(make_error_from_errno(ETIMEDOUT));
+            }
+            steady_timer refill{std::min(pacing_ready_at(now), deadline)};
+            const auto waited = co_await refill.wait(token);
+            if (!waited.has_value()) {
+                co_return waited;
+            }
+            continue;
         }
 
-        auto& front = queue_.front();
-        const auto remaining_bytes = front.size() - front_offset_;
-        const auto remaining_span = std::span<const std::byte>{
-            front.data() + front_offset_, remaining_bytes};
-
-        const auto remaining_time =
-            std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
-                                                                  now);
-        const auto slice = std::max<std::chrono::milliseconds>(
-            1ms, std::min<std::chrono::milliseconds>(remaining_time, 100ms));
-
-        auto write_result = co_await async_write_some_with_timeout(
-            stream_, remaining_span, slice, token);
+        if (queue_.front().file() != nullptr) {
+            const auto sent = send_front_file(allowance);
+            if (sent.has_value()) {
+                consume(sent.value());
+                update_backpressure_after_drain();
+                continue;
+            }
+            if (!simplenet::nonblocking::is_would_block(sent.error())) {
+                co_return err<void>(sent.error());
+            }
+            const auto writable = co_await detail::wait_after_would_block(
+                stream_.native_handle(), false, deadline, token);
+            if (!writable.has_value()) {
+                co_return writable;
+            }
+            continue;
+        }
+
+        // The ring may move its entries when more data is enqueued
+        // mid-flush, but every payload keeps its bytes outside the entry,
+        // so the list stays valid across the await.
+        const bool zerocopy = gather_front();
+        limit_gather(allowance);
+
+        // Every partial write shares the one deadline registered up front.
+        const auto id = stream_.next_zerocopy_id();
+        auto write_result =
+            zerocopy ? co_await async_writev_zerocopy_until(stream_, gather_,
+                                                            deadline, token)
+                     : co_await async_writev_until(stream_, gather_, deadline,
+                                                   token);
         if (!write_result.has_value()) {
             co_return err<void>(write_result.error());
         }
@@ -97,18 +577,179 @@ task<result<void>> queued_writer::flush(std::chrono::milliseconds timeout,
             co_return err<void>(make_error_from_errno(EPIPE));
         }
 
-        front_offset_ += write_result.value();
-        queued_bytes_ -= write_result.value();
-        if (front_offset_ == front.size()) {
-            queue_.pop_front();
-            front_offset_ = 0;
-        }
-        update_backpressure_after_drain();
+        note_written(zerocopy, id, write_result.value());
     }
 
     co_return ok();
 }
 
+bool queued_writer::gather_front() {
+    gather_.clear();
+    const bool zerocopy = sends_zerocopy(queue_.front());
+    auto offset = front_offset_;
+    for (auto& buffer : queue_) {
+        if (gather_.size() == static_cast<std::size_t>(IOV_MAX) ||
+            buffer.file() != nullptr ||
+            (!gather_.empty() && (zerocopy || sends_zerocopy(buffer)))) {
+            break;
+        }
+        const auto contents = buffer.contents().subspan(offset);
+        gather_.push_back(
+            ::iovec{.iov_base = const_cast<std::byte *>(contents.data()),
+                    .iov_len = contents.size()});
+        offset = 0;
+    }
+    return zerocopy;
+}
+
+result<std::size_t> queued_writer::send_front_file(std::size_t limit) noexcept {
+    const auto& region = *queue_.front().file();
+    const auto sent =
+        stream_.send_file(region.fd, region.offset + front_offset_,
+                          std::min(region.length - front_offset_, limit));
+    if (sent.has_value() && sent.value() == 0U) {
+        // The file is shorter than the length it was queued with.
+        return err<std::size_t>(make_error_from_errno(ENODATA));
+    }
+    return sent;
+}
+
+void queued_writer::limit_gather(std::size_t bytes) noexcept {
+    for (std::size_t i = 0; i < gather_.size(); ++i) {
+        if (gather_[i].iov_len >= bytes) {
+            gather_[i].iov_len = bytes;
+            gather_.resize(i + 1U);
+            return;
+        }
+        bytes -= gather_[i].iov_len;
+    }
+}
+
+std::array<token_bucket *, 2> queued_writer::pacing_buckets() noexcept {
+    return {bucket_.has_value() ? &*bucket_ : nullptr, pacing_.shared.get()};
+}
+
+std::size_t
+queued_writer::pacing_threshold(const token_bucket& bucket) const noexcept {
+    // Wait for the whole queue rather than trickling out what refilled, but
+    // on a shared bucket for one full-sized segment at most: writers with
+    // shorter queues would otherwise spend every refill before a full burst
+    // accrued for a long queue, and starve it.
+    const auto wanted = &bucket == pacing_.shared.get()
+                            ? std::min(queued_bytes_, kSharedPacingChunk)
+                            : queued_bytes_;
+    return std::min(wanted, bucket.burst());
+}
+
+std::size_t queued_writer::pacing_allowance() noexcept {
+    auto allowance = std::numeric_limits<std::size_t>::max();
+    if (!bucket_.has_value() && pacing_.shared == nullptr) {
+        return allowance;
+    }
+    const auto now = token_bucket::clock::now();
+    for (auto *bucket : pacing_buckets()) {
+        if (bucket == nullptr) {
+            continue;
+        }
+        const auto available = bucket->available(now);
+        if (available < pacing_threshold(*bucket)) {
+            return 0U;
+        }
+        allowance = std::min(allowance, available);
+    }
+    return allowance;
+}
+
+token_bucket::clock::time_point
+queued_writer::pacing_ready_at(token_bucket::clock::time_point now) noexcept {
+    // Writers sharing a bucket all wake at the same refill, and the first to
+    // run takes it. One that just spent the bucket therefore waits for a
+    // segment more, so the writers it beat go first next time.
+    const bool spent_shared = std::exchange(spent_shared_, false);
+    auto ready = now;
+    for (auto *bucket : pacing_buckets()) {
+        if (bucket == nullptr) {
+            continue;
+        }
+        auto wanted = pacing_threshold(*bucket);
+        if (spent_shared && bucket == pacing_.shared.get()) {
+            wanted += kSharedPacingChunk;
+        }
+        ready = std::max(ready, bucket->ready_at(wanted, now));
+    }
+    return ready;
+}
+
+void queued_writer::note_written(bool zerocopy, std::uint32_t id,
+                                 std::size_t bytes) {
+    if (zerocopy) {
+        queue_.front().zerocopy = true;
+        zerocopy_inflight_.push_back(zerocopy_record{.id = id});
+    }
+    consume(bytes);
+    update_backpressure_after_drain();
+}
+
+result<void> queued_writer::write_available() {
+    while (queued_bytes_ > 0U) {
+        reap_zerocopy();
+        const auto allowance = pacing_allowance();
+        if (allowance == 0U) {
+            return ok();
+        }
+        if (queue_.front().file() != nullptr) {
+            const auto sent = send_front_file(allowance);
+            if (!sent.has_value()) {
+                if (simplenet::nonblocking::is_would_block(sent.error())) {
+                    return ok();
+                }
+                return err<void>(sent.error());
+            }
+            consume(sent.value());
+            update_backpressure_after_drain();
+            continue;
+        }
+        const bool zerocopy = gather_front();
+        limit_gather(allowance);
+        const auto id = stream_.next_zerocopy_id();
+        const auto written =
+            zerocopy ? stream_.write_some_zerocopy(gather_)
+                     : stream_.write_some(std::span<const ::iovec>{gather_});
+        if (!written.has_value()) {
+            if (simplenet::nonblocking::is_would_block(written.error())) {
+                return ok();
+            }
+            return err<void>(written.error());
+        }
+        if (written.value() == 0U) {
+            return err<void>(make_error_from_errno(EPIPE));
+        }
+        note_written(zerocopy, id, written.value());
+    }
+    return ok();
+}
+
+void queued_writer::auto_flush_now() noexcept {
+    auto& state = *auto_flush_;
+    if (flushing_ || state.armed || state.refill_armed ||
+        state.failure.has_value() || queued_bytes_ == 0U) {
+        return;
+    }
+    const auto written = write_available();
+    if (!written.has_value()) {
+        state.failure = written.error();
+        return;
+    }
+    if (queued_bytes_ == 0U) {
+        return;
+    }
+    if (pacing_allowance() == 0U) {
+        state.arm_refill(pacing_ready_at(std::chrono::steady_clock::now()));
+    } else {
+        state.arm(stream_.native_handle());
+    }
+}
+
 task<result<void>>
 queued_writer::graceful_shutdown(std::chrono::milliseconds timeout,
                                  cancel_token token) {
@@ -121,13 +762,58 @@ queued_writer::graceful_shutdown(std::chrono::milliseconds timeout,
     if (!shutdown_result.has_value()) {
         co_return shutdown_result;
     }
+
+    // Releases follow the peer's ACKs and raise EPOLLERR on the socket.
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    reap_zerocopy();
+    while (!zerocopy_inflight_.empty()) {
+        const auto woke =
+            co_await wait_zerocopy_until(stream_.native_handle(), deadline, token);
+        if (!woke.has_value()) {
+            co_return woke;
+        }
+        reap_zerocopy();
+    }
     co_return ok();
 }
 
+void queued_writer::trim() noexcept {
+    spare_chunk_ = {};
+    if (!flushing_) {
+        gather_ = {};
+    }
+}
+
 std::size_t queued_writer::queued_bytes() const noexcept {
     return queued_bytes_;
 }
 
+bool queued_writer::sends_zerocopy(const queued_buffer& buffer) const noexcept {
+    return zerocopy_.min_bytes != 0U && !buffer.coalesced &&
+           buffer.file() == nullptr && buffer.size() >= zerocopy_.min_bytes;
+}
+
+void queued_writer::reap_zerocopy() noexcept {
+    while (!zerocopy_inflight_.empty()) {
+        const auto notification = stream_.reap_zerocopy();
+        if (!notification.has_value()) {
+            break;
+        }
+        for (auto& record : zerocopy_inflight_) {
+            if (notification->contains(record.id)) {
+                record.released = true;
+            }
+        }
+    }
+    while (!zerocopy_inflight_.empty() && zerocopy_inflight_.front().released) {
+        zerocopy_inflight_.pop_front();
+    }
+}
+
+std::size_t queued_writer::zerocopy_in_flight() const noexcept {
+    return zerocopy_inflight_.size();
+}
+
 bool queued_writer::high_watermark_active() const noexcept {
     return high_watermark_active_;
 }
@@ -136,6 +822,37 @@ int queued_writer::native_handle() const noexcept {
     return stream_.native_handle();
 }
 
+simplenet::nonblocking::tcp_stream& queued_writer::stream() noexcept {
+    return stream_;
+}
+
+void queued_writer::consume(std::size_t bytes) noexcept {
+    queued_bytes_ -= bytes;
+    spent_shared_ = pacing_.shared != nullptr;
+    for (auto *bucket : pacing_buckets()) {
+        if (bucket != nullptr) {
+            bucket->consume(bytes);
+        }
+    }
+    while (bytes > 0U) {
+        auto& front = queue_.front();
+        const auto left = front.size() - front_offset_;
+        if (bytes < left) {
+            front_offset_ += bytes;
+            return;
+        }
+        bytes -= left;
+        if (front.zerocopy) {
+            // The kernel may still read it; the latest send record owns it.
+            zerocopy_inflight_.back().held = std::move(front.data);
+        } else if (front.coalesced && spare_chunk_.capacity() == 0U) {
+            spare_chunk_ = std::move(std::get<std::vector<std::byte>>(front.data));
+        }
+        queue_.pop_front();
+        front_offset_ = 0;
+    }
+}
+
 void queued_writer::update_backpressure_after_drain() noexcept {
     if (high_watermark_active_ && queued_bytes_ <= marks_.low) {
         high_watermark_active_ = false;
@@ -0,0 +1,158 @@
+#include "simplenet/uring/buffer_ring.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <new>
+#include <sys/mman.h>
+#include <utility>
+
+namespace {
+
+[[nodiscard]] std::size_t ring_bytes(std::uint16_t count) noexcept {
+    return static_cast<std::size_t>(count) * sizeof(io_uring_buf);
+}
+
+// The ring is an array of `io_uring_buf` whose first entry's `resv` field
+// doubles as the tail. Entries are addressed directly rather than through
+// `io_uring_buf_ring::bufs`, because `__DECLARE_FLEX_ARRAY` shifts that member
+// when the uapi header is compiled as C++ on some kernels.
+[[nodiscard]] io_uring_buf *ring_entries(io_uring_buf_ring *ring) noexcept {
+    return reinterpret_cast<io_uring_buf *>(ring);
+}
+
+} // namespace
+
+namespace simplenet::uring {
+
+buffer_ring::~buffer_ring() {
+    release();
+}
+
+buffer_ring::buffer_ring(buffer_ring&& other) noexcept
+    : ring_(std::exchange(other.ring_, nullptr)),
+      storage_(std::move(other.storage_)),
+      buffer_size_(std::exchange(other.buffer_size_, 0U)),
+      count_(std::exchange(other.count_, 0U)),
+      group_(std::exchange(other.group_, 0U)),
+      tail_(std::exchange(other.tail_, 0U)) {}
+
+buffer_ring& buffer_ring::operator=(buffer_ring&& other) noexcept {
+    if (this != &other) {
+        release();
+        ring_ = std::exchange(other.ring_, nullptr);
+        storage_ = std::move(other.storage_);
+        buffer_size_ = std::exchange(other.buffer_size_, 0U);
+        count_ = std::exchange(other.count_, 0U);
+        group_ = std::exchange(other.group_, 0U);
+        tail_ = std::exchange(other.tail_, 0U);
+    }
+    return *this;
+}
+
+result<buffer_ring> buffer_ring::create(reactor& owner, std::uint16_t group,
+                                        std::uint16_t count,
+                                        std::size_t buffer_size) noexcept {
+    if (!owner.valid()) {
+        return err<buffer_ring>(make_error_from_errno(EBADF));
+    }
+    if (count == 0U || count > 32768U || !std::has_single_bit(count) ||
+        buffer_size == 0U || buffer_size > 0xFFFFFFFFU) {
+        return err<buffer_ring>(make_error_from_errno(EINVAL));
+    }
+
+    void *memory = ::mmap(nullptr, ring_bytes(count), PROT_READ | PROT_WRITE,
+                          MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (memory == MAP_FAILED) {
+        return err<buffer_ring>(error::from_errno());
+    }
+
+    buffer_ring ring{};
+    ring.ring_ = static_cast<io_uring_buf_ring *>(memory);
+    ring.count_ = count;
+    ring.group_ = group;
+    ring.buffer_size_ = buffer_size;
+    // Default-initialized so pages stay untouched until the kernel fills them.
+    ring.storage_.reset(new (std::nothrow)
+                            std::byte[static_cast<std::size_t>(count) * buffer_size]);
+    if (ring.storage_ == nullptr) {
+        return err<buffer_ring>(make_error_from_errno(ENOMEM));
+    }
+
+    io_uring_buf_reg registration{};
+    registration.ring_addr = reinterpret_cast<std::uintptr_t>(memory);
+    registration.ring_entries = count;
+    registration.bgid = group;
+    const int register_result =
+        ::io_uring_register_buf_ring(owner.native_handle(), &registration, 0U);
+    if (register_result < 0) {
+        return err<buffer_ring>(make_error_from_errno(-register_result));
+    }
+
+    for (std::uint16_t id = 0; id < count; ++id) {
+        ring.stage(id, id);
+    }
+    ring.publish(count);
+    return ring;
+}
+
+std::span<std::byte> buffer_ring::buffer(std::uint16_t id) noexcept {
+    if (!valid() || id >= count_) {
+        return {};
+    }
+    return std::span<std::byte>{
+        storage_.get() + static_cast<std::size_t>(id) * buffer_size_,
+        buffer_size_};
+}
+
+void buffer_ring::recycle(std::uint16_t id) noexcept {
+    if (!valid() || id >= count_) {
+        return;
+    }
+    stage(id, 0);
+    publish(1);
+}
+
+std::uint16_t buffer_ring::group() const noexcept {
+    return group_;
+}
+
+std::uint16_t buffer_ring::count() const noexcept {
+    return count_;
+}
+
+std::size_t buffer_ring::buffer_size() const noexcept {
+    return buffer_size_;
+}
+
+bool buffer_ring::valid() const noexcept {
+    return ring_ != nullptr && storage_ != nullptr;
+}
+
+void buffer_ring::stage(std::uint16_t id, std::uint16_t offset) noexcept {
+    const auto slot = static_cast<std::uint16_t>(tail_ + offset) &
+                      static_cast<std::uint16_t>(count_ - 1U);
+    auto& entry = ring_entries(ring_)[slot];
+    entry.addr = reinterpret_cast<std::uintptr_t>(
+        storage_.get() + static_cast<std::size_t>(id) * buffer_size_);
+    entry.len = static_cast<std::uint32_t>(buffer_size_);
+    entry.bid = id;
+}
+
+void buffer_ring::publish(std::uint16_t added) noexcept {
+    tail_ = static_cast<std::uint16_t>(tail_ + added);
+    std::atomic_ref<std::uint16_t>{ring_entries(ring_)[0].resv}.store(
+        tail_, std::memory_order_release);
+}
+
+void buffer_ring::release() noexcept {
+    if (ring_ != nullptr) {
+        (void)::munmap(ring_, ring_bytes(count_));
+        ring_ = nullptr;
+    }
+    storage_.reset();
+    count_ = 0;
+    tail_ = 0;
+}
+
+} // namespace simplenet::uring
@@ -0,0 +1,75 @@
+#include "simplenet/uring/probe.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <liburing.h>
+
+namespace {
+
+/// First integer after `key` in `path`, or `fallback` when absent.
+int read_number(const char *path, const char *key, int fallback) noexcept {
+    std::FILE *file = std::fopen(path, "r");
+    if (file == nullptr) {
+        return fallback;
+    }
+
+    int value = fallback;
+    char line[256];
+    const std::size_t key_length = std::strlen(key);
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        if (std::strncmp(line, key, key_length) == 0) {
+            (void)std::sscanf(line + key_length, "%d", &value);
+            break;
+        }
+    }
+    std::fclose(file);
+    return value;
+}
+
+} // namespace
+
+namespace simplenet::uring {
+
+support probe_support() noexcept {
+    support out{};
+    out.sysctl_disabled = read_number("/proc/sys/kernel/io_uring_disabled", "", 0);
+    out.seccomp_mode = read_number("/proc/self/status", "Seccomp:", 0);
+
+    io_uring ring{};
+    io_uring_params params{};
+    const int init_result = ::io_uring_queue_init_params(2U, &ring, &params);
+    if (init_result < 0) {
+        out.setup_error = -init_result;
+        return out;
+    }
+    out.features = params.features;
+
+    if (auto *probe = ::io_uring_get_probe_ring(&ring); probe != nullptr) {
+        const auto supported = [probe](int opcode) noexcept {
+            return ::io_uring_opcode_supported(probe, opcode) != 0;
+        };
+        out.poll_add = supported(IORING_OP_POLL_ADD);
+        out.async_cancel = supported(IORING_OP_ASYNC_CANCEL);
+        out.timeout = supported(IORING_OP_TIMEOUT);
+        out.accept = supported(IORING_OP_ACCEPT);
+        out.connect = supported(IORING_OP_CONNECT);
+        out.recv = supported(IORING_OP_RECV);
+        out.send = supported(IORING_OP_SEND);
+        out.recvmsg = supported(IORING_OP_RECVMSG);
+        out.sendmsg = supported(IORING_OP_SENDMSG);
+        out.link_timeout = supported(IORING_OP_LINK_TIMEOUT);
+        out.send_zc = supported(IORING_OP_SEND_ZC);
+        out.splice = supported(IORING_OP_SPLICE);
+        out.read_fixed = supported(IORING_OP_READ_FIXED);
+        ::io_uring_free_probe(probe);
+    }
+    ::io_uring_queue_exit(&ring);
+    return out;
+}
+
+const support& cached_support() noexcept {
+    static const support detected = probe_support();
+    return detected;
+}
+
+} // namespace simplenet::uring
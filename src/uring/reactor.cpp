@@ -1,7 +1,10 @@
 #include "simplenet/uring/reactor.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <chrono>
+#include <climits>
 #include <new>
 
 namespace {
@@ -31,12 +34,53 @@ to_kernel_timespec(std::chrono::milliseconds timeout) noexcept {
     return ts;
 }
 
+/// `user_data` of liburing's internal timeout SQE (`LIBURING_UDATA_TIMEOUT`).
+constexpr std::uint64_t kLiburingTimeoutData = ~std::uint64_t{0};
+
+/// CQE pointers fetched per `io_uring_peek_batch_cqe` call.
+constexpr std::size_t kReapBatch = 64;
+
+/// Flags dropped in this order until the kernel accepts the setup.
+constexpr std::array<unsigned, 4> kOptionalSetupFlags{
+    IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN,
+    IORING_SETUP_COOP_TASKRUN,
+    IORING_SETUP_SQPOLL | IORING_SETUP_SQ_AFF,
+    IORING_SETUP_CQSIZE,
+};
+
+[[nodiscard]] unsigned
+requested_setup_flags(const simplenet::uring::ring_options& options) noexcept {
+    unsigned flags = 0;
+    if (options.cq_entries != 0U) {
+        flags |= IORING_SETUP_CQSIZE;
+    }
+    if (options.sqpoll) {
+        flags |= IORING_SETUP_SQPOLL;
+        if (options.sqpoll_cpu >= 0) {
+            flags |= IORING_SETUP_SQ_AFF;
+        }
+    }
+    if (options.defer_taskrun) {
+        flags |= IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    }
+    if (options.coop_taskrun) {
+        flags |= IORING_SETUP_COOP_TASKRUN;
+    }
+    return flags;
+}
+
 } // namespace
 
 namespace simplenet::uring {
 
 reactor::reactor(std::unique_ptr<io_uring, void (*)(io_uring *)> ring) noexcept
-    : ring_(std::move(ring)) {}
+    : ring_(std::move(ring)) {
+    if (auto *probe = ::io_uring_get_probe_ring(ring_.get()); probe != nullptr) {
+        link_timeout_ =
+            ::io_uring_opcode_supported(probe, IORING_OP_LINK_TIMEOUT) != 0;
+        ::io_uring_free_probe(probe);
+    }
+}
 
 result<reactor> reactor::create(std::uint32_t entries) noexcept {
     if (entries == 0U) {
@@ -58,6 +102,54 @@ result<reactor> reactor::create(std::uint32_t entries) noexcept {
     return reactor{std::move(ring)};
 }
 
+result<reactor> reactor::create(const ring_options& options) noexcept {
+    if (options.queue_depth == 0U) {
+        return err<reactor>(make_error_from_errno(EINVAL));
+    }
+
+    std::unique_ptr<io_uring, void (*)(io_uring *)> ring{
+        new (std::nothrow) io_uring{}, destroy_ring};
+    if (ring == nullptr) {
+        return err<reactor>(make_error_from_errno(ENOMEM));
+    }
+
+    auto flags = requested_setup_flags(options);
+    auto next_optional = kOptionalSetupFlags.begin();
+    for (;;) {
+        io_uring_params params{};
+        params.flags = flags;
+        params.cq_entries = options.cq_entries;
+        params.sq_thread_idle = options.sqpoll_idle_ms;
+        if ((flags & IORING_SETUP_SQ_AFF) != 0U) {
+            params.sq_thread_cpu = static_cast<std::uint32_t>(options.sqpoll_cpu);
+        }
+
+        const int init_result = ::io_uring_queue_init_params(
+            static_cast<unsigned>(options.queue_depth), ring.get(), &params);
+        if (init_result == 0) {
+            reactor created{std::move(ring)};
+            created.setup_flags_ = flags;
+            created.features_ = params.features;
+            return created;
+        }
+        if (init_result != -EINVAL && init_result != -EPERM) {
+            return err<reactor>(make_error_from_errno(-init_result));
+        }
+
+        // Older kernels reject unknown flags; retry with one fewer.
+        while (next_optional != kOptionalSetupFlags.end() &&
+               (flags & *next_optional) == 0U) {
+            ++next_optional;
+        }
+        if (next_optional == kOptionalSetupFlags.end()) {
+            return err<reactor>(make_error_from_errno(-init_result));
+        }
+        flags &= ~*next_optional;
+        ++next_optional;
+        *ring = io_uring{};
+    }
+}
+
 result<void> reactor::submit_poll_add(std::uint64_t user_data, int fd,
                                       std::uint32_t poll_mask) noexcept {
     if (!valid()) {
@@ -73,10 +165,44 @@ result<void> reactor::submit_poll_add(std::uint64_t user_data, int fd,
     }
 
     ::io_uring_prep_poll_add(sqe, fd, poll_mask);
+    target_file(sqe, fd);
     ::io_uring_sqe_set_data64(sqe, user_data);
     return ok();
 }
 
+result<void> reactor::submit_poll_add(std::uint64_t user_data, int fd,
+                                      std::uint32_t poll_mask,
+                                      __kernel_timespec& deadline) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (user_data == 0U || fd < 0 || poll_mask == 0U) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+    if (!link_timeout_) {
+        return err<void>(make_error_from_errno(EOPNOTSUPP));
+    }
+    // Both halves of the link must land in the same submission.
+    if (::io_uring_sq_space_left(ring_.get()) < 2U) {
+        return err<void>(make_error_from_errno(EBUSY));
+    }
+
+    io_uring_sqe *poll = ::io_uring_get_sqe(ring_.get());
+    ::io_uring_prep_poll_add(poll, fd, poll_mask);
+    target_file(poll, fd);
+    poll->flags |= IOSQE_IO_LINK;
+    ::io_uring_sqe_set_data64(poll, user_data);
+
+    io_uring_sqe *timeout = ::io_uring_get_sqe(ring_.get());
+    ::io_uring_prep_link_timeout(timeout, &deadline, IORING_TIMEOUT_ABS);
+    ::io_uring_sqe_set_data64(timeout, 0U);
+    return ok();
+}
+
+bool reactor::supports_link_timeout() const noexcept {
+    return link_timeout_;
+}
+
 result<void>
 reactor::submit_poll_remove(std::uint64_t target_user_data) noexcept {
     if (!valid()) {
@@ -96,6 +222,218 @@ reactor::submit_poll_remove(std::uint64_t target_user_data) noexcept {
     return ok();
 }
 
+result<io_uring_sqe *> reactor::acquire_sqe(std::uint64_t user_data,
+                                            int fd) noexcept {
+    if (!valid()) {
+        return err<io_uring_sqe *>(make_error_from_errno(EBADF));
+    }
+    if (user_data == 0U || fd < 0) {
+        return err<io_uring_sqe *>(make_error_from_errno(EINVAL));
+    }
+
+    io_uring_sqe *sqe = ::io_uring_get_sqe(ring_.get());
+    if (sqe == nullptr) {
+        return err<io_uring_sqe *>(make_error_from_errno(EBUSY));
+    }
+    return sqe;
+}
+
+result<void> reactor::submit_recv(std::uint64_t user_data, int fd,
+                                  std::span<std::byte> buffer,
+                                  int flags) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    const auto fixed = flags == 0 ? fixed_buffer_index(buffer) : std::nullopt;
+    if (fixed.has_value()) {
+        ::io_uring_prep_read_fixed(sqe.value(), fd, buffer.data(),
+                                   static_cast<unsigned>(buffer.size()), 0,
+                                   fixed.value());
+    } else {
+        ::io_uring_prep_recv(sqe.value(), fd, buffer.data(), buffer.size(),
+                             flags);
+    }
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_send_zc(std::uint64_t user_data, int fd,
+                                     std::span<const std::byte> buffer,
+                                     int flags) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_send_zc(sqe.value(), fd, buffer.data(), buffer.size(), flags,
+                            0);
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_recvmsg(std::uint64_t user_data, int fd,
+                                     ::msghdr *message, int flags) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_recvmsg(sqe.value(), fd, message,
+                            static_cast<unsigned>(flags));
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_sendmsg(std::uint64_t user_data, int fd,
+                                     const ::msghdr *message,
+                                     int flags) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_sendmsg(sqe.value(), fd, message,
+                            static_cast<unsigned>(flags));
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_send(std::uint64_t user_data, int fd,
+                                  std::span<const std::byte> buffer,
+                                  int flags) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_send(sqe.value(), fd, buffer.data(), buffer.size(), flags);
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_accept(std::uint64_t user_data, int fd,
+                                    int flags) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_accept(sqe.value(), fd, nullptr, nullptr, flags);
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_multishot_accept(std::uint64_t user_data, int fd,
+                                              int flags) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_multishot_accept(sqe.value(), fd, nullptr, nullptr, flags);
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_recv_multishot(std::uint64_t user_data, int fd,
+                                            std::uint16_t buffer_group) noexcept {
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_recv_multishot(sqe.value(), fd, nullptr, 0, 0);
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_flags(sqe.value(), IOSQE_BUFFER_SELECT);
+    sqe.value()->buf_group = buffer_group;
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_cancel(std::uint64_t target_user_data) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (target_user_data == 0U) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    io_uring_sqe *sqe = ::io_uring_get_sqe(ring_.get());
+    if (sqe == nullptr) {
+        return err<void>(make_error_from_errno(EBUSY));
+    }
+
+    ::io_uring_prep_cancel64(sqe, target_user_data, 0);
+    ::io_uring_sqe_set_data64(sqe, 0U);
+    return ok();
+}
+
+result<void> reactor::submit_timeout(std::uint64_t user_data,
+                                     __kernel_timespec& timeout,
+                                     unsigned flags) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (user_data == 0U) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    io_uring_sqe *sqe = ::io_uring_get_sqe(ring_.get());
+    if (sqe == nullptr) {
+        return err<void>(make_error_from_errno(EBUSY));
+    }
+
+    ::io_uring_prep_timeout(sqe, &timeout, 0, flags);
+    ::io_uring_sqe_set_data64(sqe, user_data);
+    return ok();
+}
+
+result<void> reactor::submit_connect(std::uint64_t user_data, int fd,
+                                     const sockaddr *address,
+                                     socklen_t address_length) noexcept {
+    if (address == nullptr || address_length == 0U) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    auto sqe = acquire_sqe(user_data, fd);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_connect(sqe.value(), fd, address, address_length);
+    target_file(sqe.value(), fd);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
+result<void> reactor::submit_splice(std::uint64_t user_data, int fd_in,
+                                    std::int64_t offset_in, int fd_out,
+                                    std::size_t length,
+                                    unsigned flags) noexcept {
+    if (fd_in < 0 || length > UINT_MAX) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+
+    auto sqe = acquire_sqe(user_data, fd_out);
+    if (!sqe.has_value()) {
+        return err<void>(sqe.error());
+    }
+
+    ::io_uring_prep_splice(sqe.value(), fd_in, offset_in, fd_out, -1,
+                           static_cast<unsigned>(length), flags);
+    ::io_uring_sqe_set_data64(sqe.value(), user_data);
+    return ok();
+}
+
 result<void> reactor::submit() noexcept {
     if (!valid()) {
         return err<void>(make_error_from_errno(EBADF));
@@ -108,6 +446,13 @@ result<void> reactor::submit() noexcept {
     return ok();
 }
 
+std::size_t reactor::pending_submissions() const noexcept {
+    if (!valid()) {
+        return 0;
+    }
+    return ::io_uring_sq_ready(ring_.get());
+}
+
 result<std::size_t>
 reactor::wait(std::span<completion> completions,
               std::optional<std::chrono::milliseconds> timeout) noexcept {
@@ -139,34 +484,213 @@ reactor::wait(std::span<completion> completions,
         return err<std::size_t>(make_error_from_errno(-wait_result));
     }
 
-    std::size_t completion_count = 0;
+    return reap(completions);
+}
 
-    auto consume_cqe = [&](io_uring_cqe *cqe) {
-        completions[completion_count] =
-            completion{::io_uring_cqe_get_data64(cqe), cqe->res};
-        ++completion_count;
-        ::io_uring_cqe_seen(ring_.get(), cqe);
-    };
+result<std::size_t>
+reactor::submit_and_wait(std::span<completion> completions,
+                         std::optional<std::chrono::milliseconds> timeout,
+                         unsigned min_complete) noexcept {
+    if (!valid()) {
+        return err<std::size_t>(make_error_from_errno(EBADF));
+    }
+    if (completions.empty()) {
+        return err<std::size_t>(make_error_from_errno(EINVAL));
+    }
 
-    consume_cqe(first_cqe);
+    io_uring_cqe *first_cqe = nullptr;
+    __kernel_timespec timeout_spec{};
+    if (timeout.has_value()) {
+        timeout_spec = to_kernel_timespec(timeout.value());
+    }
+    const int wait_result = ::io_uring_submit_and_wait_timeout(
+        ring_.get(), &first_cqe, min_complete,
+        timeout.has_value() ? &timeout_spec : nullptr, nullptr);
+    if (wait_result < 0 && wait_result != -ETIME && wait_result != -EINTR) {
+        return err<std::size_t>(make_error_from_errno(-wait_result));
+    }
+
+    return reap(completions);
+}
 
+std::size_t reactor::reap(std::span<completion> completions) noexcept {
+    // One acquire of the CQ tail per batch and one release of the head,
+    // instead of a round trip per CQE.
+    std::array<io_uring_cqe *, kReapBatch> batch{};
+    std::size_t completion_count = 0;
     while (completion_count < completions.size()) {
-        io_uring_cqe *cqe = nullptr;
-        const int peek_result = ::io_uring_peek_cqe(ring_.get(), &cqe);
-        if (peek_result == -EAGAIN || cqe == nullptr) {
+        const auto wanted =
+            std::min(batch.size(), completions.size() - completion_count);
+        const unsigned ready = ::io_uring_peek_batch_cqe(
+            ring_.get(), batch.data(), static_cast<unsigned>(wanted));
+        if (ready == 0U) {
             break;
         }
-        if (peek_result < 0) {
-            return err<std::size_t>(make_error_from_errno(-peek_result));
+        for (unsigned index = 0; index < ready; ++index) {
+            const auto *cqe = batch[index];
+            if (::io_uring_cqe_get_data64(cqe) == kLiburingTimeoutData) {
+                continue;
+            }
+            completions[completion_count] =
+                completion{::io_uring_cqe_get_data64(cqe), cqe->res, cqe->flags};
+            ++completion_count;
         }
-        consume_cqe(cqe);
+        ::io_uring_cq_advance(ring_.get(), ready);
     }
-
     return completion_count;
 }
 
+result<void> reactor::register_file(int fd) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (fd < 0) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+    if (file_slot(fd).has_value()) {
+        return ok();
+    }
+
+    if (!file_table_registered_) {
+        const int sparse_result = ::io_uring_register_files_sparse(
+            ring_.get(), registered_file_slots);
+        if (sparse_result < 0) {
+            return err<void>(make_error_from_errno(-sparse_result));
+        }
+        file_table_registered_ = true;
+    }
+
+    std::uint32_t slot = 0;
+    if (!free_file_slots_.empty()) {
+        slot = free_file_slots_.back();
+    } else if (used_file_slots_ < registered_file_slots) {
+        slot = used_file_slots_;
+    } else {
+        return err<void>(make_error_from_errno(ENFILE));
+    }
+
+    const auto index = static_cast<std::size_t>(fd);
+    if (index >= file_slots_.size()) {
+        file_slots_.resize(index + 1U, 0U);
+    }
+    const int update_result =
+        ::io_uring_register_files_update(ring_.get(), slot, &fd, 1U);
+    if (update_result < 0) {
+        return err<void>(make_error_from_errno(-update_result));
+    }
+
+    if (!free_file_slots_.empty()) {
+        free_file_slots_.pop_back();
+    } else {
+        ++used_file_slots_;
+    }
+    file_slots_[index] = slot + 1U;
+    return ok();
+}
+
+result<void> reactor::unregister_file(int fd) noexcept {
+    const auto slot = file_slot(fd);
+    if (!slot.has_value()) {
+        return ok();
+    }
+
+    const int submit_result = ::io_uring_submit(ring_.get());
+    if (submit_result < 0) {
+        return err<void>(make_error_from_errno(-submit_result));
+    }
+    int cleared = -1;
+    const int update_result =
+        ::io_uring_register_files_update(ring_.get(), slot.value(), &cleared, 1U);
+    if (update_result < 0) {
+        return err<void>(make_error_from_errno(-update_result));
+    }
+
+    file_slots_[static_cast<std::size_t>(fd)] = 0U;
+    free_file_slots_.push_back(slot.value());
+    return ok();
+}
+
+std::optional<std::uint32_t> reactor::file_slot(int fd) const noexcept {
+    const auto index = static_cast<std::size_t>(fd);
+    if (fd < 0 || index >= file_slots_.size() || file_slots_[index] == 0U) {
+        return std::nullopt;
+    }
+    return file_slots_[index] - 1U;
+}
+
+result<void>
+reactor::register_buffers(std::span<const ::iovec> buffers) noexcept {
+    if (!valid()) {
+        return err<void>(make_error_from_errno(EBADF));
+    }
+    if (buffers.empty() || buffers.size() > UINT16_MAX) {
+        return err<void>(make_error_from_errno(EINVAL));
+    }
+    if (!fixed_buffers_.empty()) {
+        return err<void>(make_error_from_errno(EBUSY));
+    }
+
+    const int register_result = ::io_uring_register_buffers(
+        ring_.get(), buffers.data(), static_cast<unsigned>(buffers.size()));
+    if (register_result < 0) {
+        return err<void>(make_error_from_errno(-register_result));
+    }
+    fixed_buffers_.assign(buffers.begin(), buffers.end());
+    return ok();
+}
+
+result<void> reactor::unregister_buffers() noexcept {
+    if (fixed_buffers_.empty()) {
+        return ok();
+    }
+
+    // Reads already queued name buffer indexes; hand them over first.
+    const int submit_result = ::io_uring_submit(ring_.get());
+    if (submit_result < 0) {
+        return err<void>(make_error_from_errno(-submit_result));
+    }
+    const int unregister_result = ::io_uring_unregister_buffers(ring_.get());
+    if (unregister_result < 0) {
+        return err<void>(make_error_from_errno(-unregister_result));
+    }
+    fixed_buffers_.clear();
+    return ok();
+}
+
+void reactor::target_file(io_uring_sqe *sqe, int fd) const noexcept {
+    if (const auto slot = file_slot(fd)) {
+        sqe->fd = static_cast<int>(slot.value());
+        sqe->flags |= IOSQE_FIXED_FILE;
+    }
+}
+
+std::optional<std::uint16_t>
+reactor::fixed_buffer_index(std::span<const std::byte> buffer) const noexcept {
+    const auto *first = buffer.data();
+    const auto *last = first + buffer.size();
+    for (std::size_t index = 0; index < fixed_buffers_.size(); ++index) {
+        const auto *base = static_cast<const std::byte *>(fixed_buffers_[index].iov_base);
+        if (first >= base && last <= base + fixed_buffers_[index].iov_len) {
+            return static_cast<std::uint16_t>(index);
+        }
+    }
+    return std::nullopt;
+}
+
+std::uint32_t reactor::setup_flags() const noexcept {
+    return setup_flags_;
+}
+
+std::uint32_t reactor::features() const noexcept {
+    return features_;
+}
+
 bool reactor::valid() const noexcept {
     return ring_ != nullptr;
 }
 
+io_uring *reactor::native_handle() noexcept {
+    return ring_.get();
+}
+
 } // namespace simplenet::uring
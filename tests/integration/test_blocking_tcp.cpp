@@ -1,6 +1,8 @@
 #include "simplenet/blocking/tcp.hpp"
 
 #include <array>
+#include <cerrno>
+#include <chrono>
 #include <future>
 #include <gtest/gtest.h>
 #include <thread>
@@ -73,4 +75,78 @@ TEST(blocking_tcp_test, echo_round_trip_on_loopback) {
     EXPECT_EQ(response, request);
 }
 
+TEST(blocking_tcp_test, ipv6_loopback_connects) {
+    auto listener_result =
+        simplenet::blocking::tcp_listener::bind({.host = "::1", .port = 0});
+    if (!listener_result.has_value() &&
+        (listener_result.error().value() == EAFNOSUPPORT ||
+         listener_result.error().value() == EADDRNOTAVAIL)) {
+        GTEST_SKIP() << "IPv6 loopback unavailable";
+    }
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    const auto port_result = listener_result.value().local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    const auto client_result = simplenet::blocking::tcp_stream::connect(
+        {.host = "::1", .port = port_result.value()});
+    ASSERT_TRUE(client_result.has_value()) << client_result.error().message();
+    EXPECT_TRUE(listener_result.value().accept().has_value());
+}
+
+TEST(blocking_tcp_test, vectored_round_trip_and_read_timeout) {
+    using namespace std::chrono_literals;
+    auto listener_result =
+        simplenet::blocking::tcp_listener::bind(simplenet::blocking::endpoint::loopback(0));
+    ASSERT_TRUE(listener_result.has_value()) << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    // The connection completes from the backlog, so one thread suffices.
+    auto client_result = simplenet::blocking::tcp_stream::connect(
+        simplenet::blocking::endpoint::loopback(port_result.value()));
+    ASSERT_TRUE(client_result.has_value()) << client_result.error().message();
+    auto client = std::move(client_result.value());
+    auto server_result = listener.accept();
+    ASSERT_TRUE(server_result.has_value()) << server_result.error().message();
+    auto server = std::move(server_result.value());
+
+    std::array<std::byte, 3> header{std::byte{'h'}, std::byte{'d'}, std::byte{'r'}};
+    std::array<std::byte, 5> body{std::byte{'b'}, std::byte{'o'}, std::byte{'d'},
+                                  std::byte{'y'}, std::byte{'!'}};
+    const std::array<::iovec, 3> outbound{::iovec{header.data(), header.size()},
+                                          ::iovec{nullptr, 0},
+                                          ::iovec{body.data(), body.size()}};
+    const auto write_result = simplenet::blocking::writev_all(client, outbound, 1s);
+    ASSERT_TRUE(write_result.has_value()) << write_result.error().message();
+
+    // Split the reads across the header/body boundary.
+    std::array<std::byte, 2> first{};
+    std::array<std::byte, 6> second{};
+    const std::array<::iovec, 2> inbound{::iovec{first.data(), first.size()},
+                                         ::iovec{second.data(), second.size()}};
+    const auto read_result = simplenet::blocking::readv_exact(server, inbound);
+    ASSERT_TRUE(read_result.has_value()) << read_result.error().message();
+    EXPECT_EQ(first[0], std::byte{'h'});
+    EXPECT_EQ(second[1], std::byte{'b'});
+    EXPECT_EQ(second[5], std::byte{'!'});
+
+    std::array<std::byte, 4> idle{};
+    const auto started = std::chrono::steady_clock::now();
+    const auto timed_out =
+        simplenet::blocking::read_exact(server, std::span<std::byte>{idle}, 50ms);
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error().value(), ETIMEDOUT);
+    EXPECT_GE(std::chrono::steady_clock::now() - started, 50ms);
+
+    const auto some = server.read_some(std::span<std::byte>{idle}, 0ms);
+    ASSERT_FALSE(some.has_value());
+    EXPECT_EQ(some.error().value(), ETIMEDOUT);
+    const auto negative =
+        simplenet::blocking::read_exact(server, std::span<std::byte>{idle}, -1ms);
+    ASSERT_FALSE(negative.has_value());
+    EXPECT_EQ(negative.error().value(), EINVAL);
+}
+
 } // namespace
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cerrno>
+#include <chrono>
 #include <future>
 #include <gtest/gtest.h>
 #include <thread>
@@ -90,4 +91,57 @@ TEST(blocking_udp_test, recv_from_empty_buffer_returns_einval) {
     EXPECT_EQ(receive_result.error().value(), EINVAL);
 }
 
+TEST(blocking_udp_test, batch_round_trip_and_receive_timeout) {
+    using namespace std::chrono_literals;
+    auto server_result =
+        simplenet::blocking::udp_socket::bind(simplenet::blocking::endpoint::loopback(0));
+    ASSERT_TRUE(server_result.has_value()) << server_result.error().message();
+    auto server = std::move(server_result.value());
+    auto port_result = server.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+    auto client_result =
+        simplenet::blocking::udp_socket::bind(simplenet::blocking::endpoint::loopback(0));
+    ASSERT_TRUE(client_result.has_value()) << client_result.error().message();
+    auto client = std::move(client_result.value());
+
+    const auto to = simplenet::blocking::socket_address::from_endpoint(
+        simplenet::blocking::endpoint::loopback(port_result.value()));
+    ASSERT_TRUE(to.has_value()) << to.error().message();
+    std::array<std::byte, 4> first{};
+    first.fill(std::byte{1});
+    std::array<std::byte, 8> second{};
+    second.fill(std::byte{2});
+    const std::array<simplenet::blocking::udp_outgoing, 2> outgoing{
+        simplenet::blocking::udp_outgoing{.payload = first, .to = to.value()},
+        simplenet::blocking::udp_outgoing{.payload = second, .to = to.value()}};
+    const auto sent = client.send_batch(outgoing);
+    ASSERT_TRUE(sent.has_value()) << sent.error().message();
+    EXPECT_EQ(sent.value(), 2U);
+
+    std::array<std::array<std::byte, 16>, 4> storage{};
+    std::array<simplenet::blocking::udp_message, 4> messages{};
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        messages[i].buffer = storage[i];
+    }
+    std::size_t received = 0;
+    while (received < 2) {
+        const auto batch = server.recv_batch(std::span{messages}.subspan(received));
+        ASSERT_TRUE(batch.has_value()) << batch.error().message();
+        received += batch.value();
+    }
+    EXPECT_EQ(messages[0].size, 4U);
+    EXPECT_EQ(messages[1].size, 8U);
+    EXPECT_EQ(storage[1][0], std::byte{2});
+    EXPECT_FALSE(messages[1].truncated);
+    EXPECT_EQ(messages[0].from.port(), client.local_port().value());
+
+    const auto timed_out = server.recv_batch(messages, 30ms);
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error().value(), ETIMEDOUT);
+    std::array<std::byte, 16> single{};
+    const auto single_timeout = server.recv_from(std::span<std::byte>{single}, 0ms);
+    ASSERT_FALSE(single_timeout.has_value());
+    EXPECT_EQ(single_timeout.error().value(), ETIMEDOUT);
+}
+
 } // namespace
@@ -8,6 +8,7 @@
 #include <fcntl.h>
 #include <future>
 #include <gtest/gtest.h>
+#include <span>
 #include <sys/epoll.h>
 #include <unistd.h>
 #include <vector>
@@ -237,6 +238,36 @@ TEST(epoll_reactor_test, lifecycle_add_wait_remove_on_pipe) {
     ASSERT_TRUE(remove_result.has_value()) << remove_result.error().message();
 }
 
+TEST(epoll_reactor_test, native_wait_fills_caller_events) {
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    simplenet::unique_fd read_end{pipe_fds[0]};
+    simplenet::unique_fd write_end{pipe_fds[1]};
+
+    auto reactor_result = simplenet::epoll::reactor::create();
+    ASSERT_TRUE(reactor_result.has_value()) << reactor_result.error().message();
+    auto reactor = std::move(reactor_result.value());
+    ASSERT_TRUE(reactor.add(read_end.get(), EPOLLIN | EPOLLET).has_value());
+
+    std::array<::epoll_event, 4> events{};
+    const auto idle = reactor.wait(events, std::chrono::milliseconds{0});
+    ASSERT_TRUE(idle.has_value()) << idle.error().message();
+    EXPECT_EQ(idle.value(), 0U);
+
+    constexpr std::array<std::byte, 1> one_byte{std::byte{0x7F}};
+    ASSERT_EQ(::write(write_end.get(), one_byte.data(), one_byte.size()), 1);
+    const auto ready = reactor.wait(events, std::chrono::milliseconds{200});
+    ASSERT_TRUE(ready.has_value()) << ready.error().message();
+    ASSERT_EQ(ready.value(), 1U);
+    EXPECT_EQ(events[0].data.fd, read_end.get());
+    EXPECT_TRUE(simplenet::epoll::has_event(events[0].events, EPOLLIN));
+
+    const auto empty =
+        reactor.wait(std::span<::epoll_event>{}, std::chrono::milliseconds{0});
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().value(), EINVAL);
+}
+
 TEST(epoll_reactor_test, edge_triggered_echo_handles_partial_io_and_eagain) {
     constexpr std::size_t payload_size = 512U * 1024U;
 
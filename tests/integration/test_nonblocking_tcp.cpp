@@ -0,0 +1,634 @@
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+#include "simplenet/runtime/write_queue.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using simplenet::nonblocking::listen_options;
+using simplenet::nonblocking::socket_address;
+using simplenet::nonblocking::socket_options;
+using simplenet::nonblocking::tcp_listener;
+using simplenet::nonblocking::tcp_stream;
+
+int int_option(int fd, int level, int name) {
+    int value = -1;
+    auto length = static_cast<socklen_t>(sizeof(value));
+    EXPECT_EQ(::getsockopt(fd, level, name, &value, &length), 0)
+        << "getsockopt errno " << errno;
+    return value;
+}
+
+bool wait_for(int fd, short events, std::chrono::milliseconds timeout) {
+    ::pollfd entry{.fd = fd, .events = events, .revents = 0};
+    return ::poll(&entry, 1, static_cast<int>(timeout.count())) == 1;
+}
+
+tcp_listener bind_loopback(const listen_options& options = {}) {
+    auto bound = tcp_listener::bind(socket_address::loopback(0), options);
+    EXPECT_TRUE(bound.has_value()) << bound.error().message();
+    return bound.has_value() ? std::move(bound.value()) : tcp_listener{};
+}
+
+template <class Loop> void fast_open_round_trip(Loop& loop) {
+    auto listener = bind_loopback(listen_options{.fast_open_queue = 16});
+    const auto address = listener.local_address().value();
+
+    std::array<std::byte, 4> received{};
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_accept(listener);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        const auto read = co_await simplenet::runtime::async_read_exact(
+            stream.value(), received);
+        EXPECT_TRUE(read.has_value());
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(
+            address, socket_options{.fast_open_connect = true});
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        const std::array<std::byte, 4> payload{std::byte{'p'}, std::byte{'i'},
+                                               std::byte{'n'}, std::byte{'g'}};
+        const auto written = co_await simplenet::runtime::async_write_all(
+            stream.value(), payload);
+        EXPECT_TRUE(written.has_value());
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(received[0], std::byte{'p'});
+    EXPECT_EQ(received[3], std::byte{'g'});
+}
+
+template <class Loop> void accept_burst(Loop& loop) {
+    auto listener = bind_loopback();
+    const auto address = listener.local_address().value();
+
+    constexpr std::size_t burst = 6;
+    std::array<tcp_stream, burst> clients{};
+    for (auto& client : clients) {
+        auto connected = tcp_stream::connect(address);
+        ASSERT_TRUE(connected.has_value());
+        client = std::move(connected.value());
+        ASSERT_TRUE(wait_for(client.native_handle(), POLLOUT, 1000ms));
+    }
+
+    std::size_t total = 0;
+    int wakeups = 0;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        std::array<tcp_stream, 4> accepted{};
+        while (total < burst) {
+            const auto count = co_await simplenet::runtime::async_accept_batch(
+                listener, accepted);
+            if (!count.has_value()) {
+                ADD_FAILURE() << count.error().message();
+                co_return;
+            }
+            total += count.value();
+            ++wakeups;
+        }
+    };
+    loop.spawn(server());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(total, burst);
+    // The whole backlog was queued up front: two full-span drains.
+    EXPECT_EQ(wakeups, 2);
+}
+
+simplenet::unique_fd make_blob(std::size_t size) {
+    simplenet::unique_fd blob{::memfd_create("simplenet-blob", MFD_CLOEXEC)};
+    EXPECT_TRUE(blob.valid());
+    std::vector<std::byte> bytes(size);
+    for (std::size_t index = 0; index < size; ++index) {
+        bytes[index] = static_cast<std::byte>((index * 7U) % 251U);
+    }
+    EXPECT_EQ(::write(blob.get(), bytes.data(), bytes.size()),
+              static_cast<ssize_t>(size));
+    return blob;
+}
+
+simplenet::runtime::task<std::vector<std::byte>> read_to_end(tcp_stream& stream) {
+    std::vector<std::byte> received;
+    std::array<std::byte, 16 * 1024> buffer{};
+    while (true) {
+        const auto read =
+            co_await simplenet::runtime::async_read_some(stream, buffer);
+        if (!read.has_value() || read.value() == 0U) {
+            EXPECT_TRUE(read.has_value());
+            co_return received;
+        }
+        received.insert(received.end(), buffer.begin(),
+                        buffer.begin() + static_cast<std::ptrdiff_t>(read.value()));
+    }
+}
+
+template <class Loop> void sendfile_round_trip(Loop& loop) {
+    constexpr std::size_t kSize = 3U * 1024U * 1024U;
+    constexpr std::size_t kOffset = 100;
+    const auto blob = make_blob(kSize);
+    auto listener = bind_loopback();
+    const auto address = listener.local_address().value();
+
+    std::size_t sent = 0;
+    std::vector<std::byte> received;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_accept(listener);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        // Asks for more than the file holds: stops at end of file.
+        const auto result = co_await simplenet::runtime::async_sendfile(
+            stream.value(), blob.get(), kOffset, kSize);
+        if (!result.has_value()) {
+            ADD_FAILURE() << result.error().message();
+            co_return;
+        }
+        sent = result.value();
+        EXPECT_TRUE(stream.value().shutdown_write().has_value());
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        received = co_await read_to_end(stream.value());
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(sent, kSize - kOffset);
+    ASSERT_EQ(received.size(), kSize - kOffset);
+    EXPECT_EQ(received.front(), static_cast<std::byte>((kOffset * 7U) % 251U));
+    EXPECT_EQ(received.back(), static_cast<std::byte>(((kSize - 1U) * 7U) % 251U));
+}
+
+template <class Loop> void splice_round_trip(Loop& loop) {
+    std::array<int, 2> ends{};
+    ASSERT_EQ(::pipe2(ends.data(), O_CLOEXEC | O_NONBLOCK), 0);
+    const simplenet::unique_fd pipe_read{ends[0]};
+    const simplenet::unique_fd pipe_write{ends[1]};
+    auto listener = bind_loopback();
+    const auto address = listener.local_address().value();
+
+    std::array<std::byte, 7> outbound{};
+    std::array<std::byte, 4> inbound{};
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_accept(listener);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        const char message[] = "splice!";
+        EXPECT_EQ(::write(pipe_write.get(), message, 7), 7);
+        const auto to_socket = co_await simplenet::runtime::async_splice(
+            pipe_read.get(), stream.value().native_handle(), 64);
+        EXPECT_EQ(to_socket.value_or(0), 7U);
+
+        // Nothing queued yet: waits for the peer's bytes.
+        const auto to_pipe = co_await simplenet::runtime::async_splice(
+            stream.value().native_handle(), pipe_write.get(), 64);
+        EXPECT_EQ(to_pipe.value_or(0), 4U);
+        EXPECT_EQ(::read(pipe_read.get(), inbound.data(), inbound.size()), 4);
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        const auto read =
+            co_await simplenet::runtime::async_read_exact(stream.value(), outbound);
+        EXPECT_TRUE(read.has_value());
+        const std::array<std::byte, 4> reply{std::byte{'b'}, std::byte{'a'},
+                                             std::byte{'c'}, std::byte{'k'}};
+        const auto written =
+            co_await simplenet::runtime::async_write_all(stream.value(), reply);
+        EXPECT_TRUE(written.has_value());
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(outbound[0], std::byte{'s'});
+    EXPECT_EQ(outbound[6], std::byte{'!'});
+    EXPECT_EQ(inbound[0], std::byte{'b'});
+    EXPECT_EQ(inbound[3], std::byte{'k'});
+}
+
+// A connected loopback pair: `first` is the client, `second` the server.
+std::pair<tcp_stream, tcp_stream> connected_pair() {
+    auto listener = bind_loopback();
+    auto client = tcp_stream::connect(listener.local_address().value());
+    EXPECT_TRUE(client.has_value());
+    EXPECT_TRUE(wait_for(listener.native_handle(), POLLIN, 1000ms));
+    auto server = listener.accept();
+    EXPECT_TRUE(server.has_value());
+    EXPECT_TRUE(client.has_value() &&
+                wait_for(client.value().native_handle(), POLLOUT, 1000ms));
+    return {client.has_value() ? std::move(client.value()) : tcp_stream{},
+            server.has_value() ? std::move(server.value()) : tcp_stream{}};
+}
+
+} // namespace
+
+TEST(nonblocking_tcp_test, stream_options_are_applied_before_connect) {
+    auto listener = bind_loopback();
+    const auto address = listener.local_address().value();
+
+    auto stream = tcp_stream::connect(
+        address, socket_options{.no_delay = true,
+                                .receive_buffer = 64 * 1024,
+                                .incoming_cpu = 0,
+                                .notsent_lowat = 16 * 1024});
+    ASSERT_TRUE(stream.has_value()) << stream.error().message();
+    const int fd = stream.value().native_handle();
+
+    EXPECT_EQ(int_option(fd, IPPROTO_TCP, TCP_NODELAY), 1);
+    // The kernel doubles SO_RCVBUF for its own bookkeeping.
+    EXPECT_GE(int_option(fd, SOL_SOCKET, SO_RCVBUF), 64 * 1024);
+    EXPECT_EQ(int_option(fd, SOL_SOCKET, SO_INCOMING_CPU), 0);
+    EXPECT_EQ(int_option(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT), 16 * 1024);
+}
+
+TEST(nonblocking_tcp_test, unset_options_keep_kernel_defaults) {
+    auto stream = tcp_stream::open(AF_INET, socket_options{});
+    ASSERT_TRUE(stream.has_value());
+    EXPECT_EQ(int_option(stream.value().native_handle(), IPPROTO_TCP,
+                         TCP_NODELAY),
+              0);
+
+    const auto applied = stream.value().set_options({.no_delay = true});
+    ASSERT_TRUE(applied.has_value());
+    EXPECT_EQ(int_option(stream.value().native_handle(), IPPROTO_TCP,
+                         TCP_NODELAY),
+              1);
+}
+
+TEST(nonblocking_tcp_test, invalid_options_are_rejected) {
+    const auto buffer = tcp_stream::open(AF_INET, {.receive_buffer = -1});
+    ASSERT_FALSE(buffer.has_value());
+    EXPECT_EQ(buffer.error().value(), EINVAL);
+
+    const auto queue = tcp_listener::bind(socket_address::loopback(0),
+                                          listen_options{.fast_open_queue = -1});
+    ASSERT_FALSE(queue.has_value());
+    EXPECT_EQ(queue.error().value(), EINVAL);
+}
+
+TEST(nonblocking_tcp_test, listener_options_reach_accepted_connections) {
+    auto listener = bind_loopback(listen_options{
+        .fast_open_queue = 16, .socket = socket_options{.no_delay = true}});
+    ASSERT_TRUE(listener.valid());
+    EXPECT_EQ(int_option(listener.native_handle(), IPPROTO_TCP, TCP_FASTOPEN),
+              16);
+
+    auto client = tcp_stream::connect(listener.local_address().value());
+    ASSERT_TRUE(client.has_value());
+    ASSERT_TRUE(wait_for(listener.native_handle(), POLLIN, 1000ms));
+    auto accepted = listener.accept();
+    ASSERT_TRUE(accepted.has_value()) << accepted.error().message();
+    EXPECT_EQ(int_option(accepted.value().native_handle(), IPPROTO_TCP,
+                         TCP_NODELAY),
+              1);
+}
+
+TEST(nonblocking_tcp_test, defer_accept_waits_for_the_first_bytes) {
+    auto listener = bind_loopback(listen_options{.defer_accept = 5s});
+    ASSERT_TRUE(listener.valid());
+    EXPECT_GT(int_option(listener.native_handle(), IPPROTO_TCP,
+                         TCP_DEFER_ACCEPT),
+              0);
+
+    auto client = tcp_stream::connect(listener.local_address().value());
+    ASSERT_TRUE(client.has_value());
+    ASSERT_TRUE(wait_for(client.value().native_handle(), POLLOUT, 1000ms));
+
+    // Handshake done, but no data yet: nothing to accept.
+    EXPECT_FALSE(wait_for(listener.native_handle(), POLLIN, 100ms));
+    const auto early = listener.accept();
+    ASSERT_FALSE(early.has_value());
+    EXPECT_TRUE(simplenet::nonblocking::is_would_block(early.error()));
+
+    const std::array<std::byte, 1> hello{std::byte{'h'}};
+    ASSERT_TRUE(client.value().write_some(hello).has_value());
+    ASSERT_TRUE(wait_for(listener.native_handle(), POLLIN, 1000ms));
+    EXPECT_TRUE(listener.accept().has_value());
+}
+
+TEST(nonblocking_tcp_test, fast_open_connect_sends_with_the_first_write) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    fast_open_round_trip(loop);
+}
+
+TEST(nonblocking_tcp_test, fast_open_connect_on_the_uring_backend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    fast_open_round_trip(loop);
+}
+
+TEST(nonblocking_tcp_test, queued_writer_caps_unsent_kernel_bytes) {
+    auto listener = bind_loopback();
+    auto stream = tcp_stream::connect(listener.local_address().value());
+    ASSERT_TRUE(stream.has_value());
+
+    simplenet::runtime::queued_writer writer{
+        std::move(stream.value()),
+        simplenet::runtime::watermarks{.kernel_unsent = 32 * 1024}};
+    EXPECT_EQ(int_option(writer.native_handle(), IPPROTO_TCP,
+                         TCP_NOTSENT_LOWAT),
+              32 * 1024);
+}
+
+TEST(nonblocking_tcp_test, accept_batch_drains_the_listen_queue) {
+    auto listener = bind_loopback();
+    const auto address = listener.local_address().value();
+
+    std::array<tcp_stream, 5> clients{};
+    for (auto& client : clients) {
+        auto connected = tcp_stream::connect(address);
+        ASSERT_TRUE(connected.has_value());
+        client = std::move(connected.value());
+        ASSERT_TRUE(wait_for(client.native_handle(), POLLOUT, 1000ms));
+    }
+
+    std::array<tcp_stream, 8> accepted{};
+    const auto count = listener.accept_batch(accepted);
+    ASSERT_TRUE(count.has_value()) << count.error().message();
+    EXPECT_EQ(count.value(), clients.size());
+    for (std::size_t index = 0; index < count.value(); ++index) {
+        const int flags = ::fcntl(accepted[index].native_handle(), F_GETFL);
+        EXPECT_NE(flags & O_NONBLOCK, 0);
+    }
+
+    const auto empty = listener.accept_batch(accepted);
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_TRUE(simplenet::nonblocking::is_would_block(empty.error()));
+}
+
+TEST(nonblocking_tcp_test, async_accept_batch_takes_a_burst_per_wakeup) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    accept_burst(loop);
+}
+
+TEST(nonblocking_tcp_test, async_accept_batch_on_the_uring_backend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    accept_burst(loop);
+}
+
+TEST(nonblocking_tcp_test, async_sendfile_streams_a_file_region) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    sendfile_round_trip(loop);
+}
+
+TEST(nonblocking_tcp_test, async_sendfile_splices_on_the_uring_backend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    sendfile_round_trip(loop);
+}
+
+TEST(nonblocking_tcp_test, async_splice_moves_bytes_through_a_pipe) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    splice_round_trip(loop);
+}
+
+TEST(nonblocking_tcp_test, async_splice_on_the_uring_backend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    splice_round_trip(loop);
+}
+
+TEST(nonblocking_tcp_test, queued_writer_sends_file_segments_in_order) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    constexpr std::size_t kFileBytes = 512U * 1024U;
+    const auto blob = make_blob(kFileBytes);
+    auto listener = bind_loopback();
+    const auto address = listener.local_address().value();
+
+    std::vector<std::byte> received;
+    bool high_after_file = false;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_accept(listener);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        simplenet::runtime::queued_writer writer{std::move(stream.value())};
+        const std::array<std::byte, 2> head{std::byte{'H'}, std::byte{'D'}};
+        const std::array<std::byte, 2> tail{std::byte{'T'}, std::byte{'L'}};
+        EXPECT_TRUE(writer.enqueue(head).has_value());
+        const auto state = writer.enqueue_file(blob.get(), 0, kFileBytes);
+        high_after_file =
+            state.has_value() &&
+            state.value() == simplenet::runtime::backpressure_state::high_watermark;
+        // Above the high watermark, memory enqueues are refused until it drains.
+        EXPECT_FALSE(writer.enqueue(tail).has_value());
+        EXPECT_TRUE((co_await writer.flush(2s)).has_value());
+        EXPECT_TRUE(writer.enqueue(tail).has_value());
+        EXPECT_TRUE((co_await writer.graceful_shutdown(2s)).has_value());
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        received = co_await read_to_end(stream.value());
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_TRUE(high_after_file);
+    ASSERT_EQ(received.size(), kFileBytes + 4U);
+    EXPECT_EQ(received[0], std::byte{'H'});
+    EXPECT_EQ(received[2], std::byte{0});
+    EXPECT_EQ(received[kFileBytes + 1U],
+              static_cast<std::byte>(((kFileBytes - 1U) * 7U) % 251U));
+    EXPECT_EQ(received[kFileBytes + 2U], std::byte{'T'});
+}
+
+TEST(nonblocking_tcp_test, queued_writer_reports_a_file_shorter_than_queued) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    const auto blob = make_blob(1024);
+    auto listener = bind_loopback();
+    const auto address = listener.local_address().value();
+
+    simplenet::result<void> flushed = simplenet::ok();
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_accept(listener);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        simplenet::runtime::queued_writer writer{std::move(stream.value())};
+        EXPECT_TRUE(writer.enqueue_file(blob.get(), 0, 4096).has_value());
+        flushed = co_await writer.flush(2s);
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        EXPECT_TRUE(stream.has_value());
+        if (stream.has_value()) {
+            (void)co_await read_to_end(stream.value());
+        }
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    ASSERT_FALSE(flushed.has_value());
+    EXPECT_EQ(flushed.error().value(), ENODATA);
+}
+
+TEST(nonblocking_tcp_test, ktls_rejects_mismatched_keys_and_plain_records) {
+    auto [client, server] = connected_pair();
+    ASSERT_TRUE(client.valid());
+
+    const std::array<std::byte, 16> key{};
+    const std::array<std::byte, 8> iv{};
+    const std::array<std::byte, 4> salt{};
+    const auto short_salt = client.enable_ktls_tx(
+        {.key = key, .iv = iv, .salt = std::span{salt}.first(2)});
+    ASSERT_FALSE(short_salt.has_value());
+    EXPECT_EQ(short_salt.error().value(), EINVAL);
+    const auto wrong_cipher = client.enable_ktls_rx(
+        {.cipher = simplenet::nonblocking::tls_cipher::aes_gcm_256,
+         .key = key, .iv = iv, .salt = salt});
+    ASSERT_FALSE(wrong_cipher.has_value());
+    EXPECT_EQ(wrong_cipher.error().value(), EINVAL);
+    const auto old_version = client.enable_ktls_tx(
+        {.version = 0x0301, .key = key, .iv = iv, .salt = salt});
+    ASSERT_FALSE(old_version.has_value());
+    EXPECT_EQ(old_version.error().value(), EINVAL);
+    EXPECT_FALSE(client.ktls_tx_enabled());
+
+    std::array<std::byte, 8> buffer{};
+    const auto read = client.read_tls_record(buffer);
+    ASSERT_FALSE(read.has_value());
+    EXPECT_EQ(read.error().value(), EINVAL);
+    const auto written =
+        client.write_tls_record(simplenet::nonblocking::tls_alert, buffer);
+    ASSERT_FALSE(written.has_value());
+    EXPECT_EQ(written.error().value(), EINVAL);
+
+    tcp_stream closed;
+    const auto unopened = closed.enable_ktls_tx({.key = key, .iv = iv, .salt = salt});
+    ASSERT_FALSE(unopened.has_value());
+    EXPECT_EQ(unopened.error().value(), EBADF);
+}
+
+TEST(nonblocking_tcp_test, ktls_session_carries_data_and_control_records) {
+    using simplenet::nonblocking::tls_alert;
+    using simplenet::nonblocking::tls_application_data;
+
+    auto [client, server] = connected_pair();
+    ASSERT_TRUE(client.valid() && server.valid());
+
+    std::array<std::byte, 16> key{};
+    key.fill(std::byte{0x42});
+    const std::array<std::byte, 8> iv{std::byte{1}};
+    const std::array<std::byte, 4> salt{std::byte{2}};
+    const simplenet::nonblocking::tls_key_material keys{
+        .key = key, .iv = iv, .salt = salt};
+    const auto tx = client.enable_ktls_tx(keys);
+    if (!tx.has_value() && (tx.error().value() == ENOENT ||
+                            tx.error().value() == EOPNOTSUPP)) {
+        GTEST_SKIP() << "kernel TLS unavailable: " << tx.error().message();
+    }
+    ASSERT_TRUE(tx.has_value()) << tx.error().message();
+    ASSERT_TRUE(server.enable_ktls_rx(keys).has_value());
+    EXPECT_TRUE(client.ktls_tx_enabled());
+    EXPECT_TRUE(server.ktls_rx_enabled());
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    std::vector<simplenet::nonblocking::tls_record> records;
+    std::array<std::byte, 64> plaintext{};
+    simplenet::result<std::size_t> plain_read = simplenet::ok(std::size_t{0});
+    auto sender = [&]() -> simplenet::runtime::task<void> {
+        const std::array<std::byte, 5> hello{std::byte{'h'}, std::byte{'e'},
+                                             std::byte{'l'}, std::byte{'l'},
+                                             std::byte{'o'}};
+        EXPECT_TRUE(
+            (co_await simplenet::runtime::async_write_all(client, hello)).has_value());
+        const std::array<std::byte, 2> close_notify{std::byte{1}, std::byte{0}};
+        const auto alert = co_await simplenet::runtime::async_write_tls_record(
+            client, tls_alert, close_notify);
+        EXPECT_TRUE(alert.has_value());
+    };
+    auto receiver = [&]() -> simplenet::runtime::task<void> {
+        auto data = co_await simplenet::runtime::async_read_tls_record(
+            server, plaintext);
+        if (!data.has_value()) {
+            ADD_FAILURE() << data.error().message();
+            co_return;
+        }
+        records.push_back(data.value());
+        // The alert is next: an ordinary read refuses it.
+        while (!wait_for(server.native_handle(), POLLIN, 0ms)) {
+            (void)co_await simplenet::runtime::async_sleep(1ms);
+        }
+        plain_read = server.read_some(plaintext);
+        auto control = co_await simplenet::runtime::async_read_tls_record(
+            server, std::span{plaintext}.subspan(data.value().size));
+        if (!control.has_value()) {
+            ADD_FAILURE() << control.error().message();
+            co_return;
+        }
+        records.push_back(control.value());
+    };
+    loop.spawn(receiver());
+    loop.spawn(sender());
+
+    ASSERT_TRUE(loop.run().has_value());
+    ASSERT_EQ(records.size(), 2U);
+    EXPECT_EQ(records[0].type, tls_application_data);
+    EXPECT_EQ(records[0].size, 5U);
+    EXPECT_EQ(plaintext[0], std::byte{'h'});
+    EXPECT_EQ(records[1].type, tls_alert);
+    EXPECT_EQ(records[1].size, 2U);
+    ASSERT_FALSE(plain_read.has_value());
+    EXPECT_EQ(plain_read.error().value(), EIO);
+}
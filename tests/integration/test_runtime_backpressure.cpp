@@ -1,14 +1,20 @@
 #include "simplenet/blocking/tcp.hpp"
+#include "simplenet/nonblocking/local.hpp"
 #include "simplenet/nonblocking/tcp.hpp"
 #include "simplenet/runtime/event_loop.hpp"
 #include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
 #include "simplenet/runtime/write_queue.hpp"
 
 #include <array>
+#include <atomic>
 #include <cerrno>
 #include <chrono>
 #include <future>
 #include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <sys/socket.h>
 #include <thread>
 #include <vector>
 
@@ -159,4 +165,788 @@ TEST(runtime_backpressure_test,
     EXPECT_EQ(client_result.value(), server_result.value());
 }
 
+/// Send many small messages, each tenth one move-enqueued, and check order.
+void expect_small_messages_arrive_in_order(
+    simplenet::runtime::coalescing coalesce) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    // More messages than IOV_MAX, so one flush spans several gathers.
+    constexpr std::size_t kMessages = 2500;
+    constexpr std::size_t kMessageSize = 16;
+    std::vector<std::byte> expected;
+    expected.reserve(kMessages * kMessageSize);
+    for (std::size_t index = 0; index < kMessages * kMessageSize; ++index) {
+        expected.push_back(static_cast<std::byte>((index * 7U) % 253U));
+    }
+
+    simplenet::result<void> server_status = simplenet::ok();
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+        simplenet::runtime::queued_writer writer(
+            std::move(accept_result.value()),
+            simplenet::runtime::watermarks{1U << 20U, 1U << 21U}, coalesce);
+        for (std::size_t index = 0; index < kMessages; ++index) {
+            const auto message = std::span<const std::byte>{
+                expected.data() + index * kMessageSize, kMessageSize};
+            const auto queued =
+                index % 10U == 9U
+                    ? writer.enqueue(
+                          std::vector<std::byte>(message.begin(), message.end()))
+                    : writer.enqueue(message);
+            if (!queued.has_value()) {
+                server_status = simplenet::err<void>(queued.error());
+                co_return;
+            }
+            if (index == kMessages / 2U) {
+                // Flush half-way so later appends reuse drained chunks.
+                server_status = co_await writer.flush(2s);
+                if (!server_status.has_value()) {
+                    co_return;
+                }
+            }
+        }
+        server_status = co_await writer.graceful_shutdown(2s);
+    };
+    loop.spawn(server());
+
+    std::vector<std::byte> received;
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (!client.has_value()) {
+            return;
+        }
+        std::array<std::byte, 4096> buffer{};
+        while (true) {
+            auto read_result =
+                client.value().read_some(std::span<std::byte>{buffer});
+            if (!read_result.has_value() || read_result.value() == 0U) {
+                break;
+            }
+            received.insert(received.end(), buffer.begin(),
+                            buffer.begin() +
+                                static_cast<std::ptrdiff_t>(read_result.value()));
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    EXPECT_EQ(received, expected);
+}
+
+TEST(runtime_backpressure_test, flush_gathers_many_small_buffers_in_order) {
+    expect_small_messages_arrive_in_order({});
+}
+
+TEST(runtime_backpressure_test, coalesced_small_messages_arrive_in_order) {
+    expect_small_messages_arrive_in_order(
+        simplenet::runtime::coalescing{.max_message = 64, .chunk_size = 1000});
+}
+
+TEST(runtime_backpressure_test, shared_buffer_fans_out_without_copies) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::socket_address::loopback(0));
+    ASSERT_TRUE(listener_result.has_value());
+    auto listener = std::move(listener_result.value());
+    const auto address = listener.local_address().value();
+
+    constexpr std::size_t kSubscribers = 20;
+    std::vector<std::byte> tick(3000);
+    for (std::size_t index = 0; index < tick.size(); ++index) {
+        tick[index] = static_cast<std::byte>(index % 251U);
+    }
+    const auto message = simplenet::runtime::shared_buffer::copy_of(tick);
+    const std::array<std::byte, 2> prefix{std::byte{'>'}, std::byte{'>'}};
+
+    std::size_t peak_references = 0;
+    auto publisher = [&]() -> simplenet::runtime::task<void> {
+        std::vector<simplenet::runtime::queued_writer> writers;
+        for (std::size_t index = 0; index < kSubscribers; ++index) {
+            auto accepted = co_await simplenet::runtime::async_accept(listener);
+            if (!accepted.has_value()) {
+                ADD_FAILURE() << accepted.error().message();
+                co_return;
+            }
+            writers.emplace_back(std::move(accepted.value()));
+        }
+        for (auto& writer : writers) {
+            EXPECT_TRUE(writer.enqueue(std::span<const std::byte>{prefix}).has_value());
+            EXPECT_TRUE(writer.enqueue(message).has_value());
+            EXPECT_EQ(writer.queued_bytes(), prefix.size() + tick.size());
+        }
+        peak_references = message.use_count();
+        for (auto& writer : writers) {
+            const auto done = co_await writer.graceful_shutdown(2s);
+            EXPECT_TRUE(done.has_value());
+        }
+    };
+
+    std::vector<std::vector<std::byte>> received(kSubscribers);
+    auto subscriber = [&](std::size_t slot) -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        std::array<std::byte, 1024> buffer{};
+        while (true) {
+            const auto got =
+                co_await simplenet::runtime::async_read_some(stream.value(), buffer);
+            if (!got.has_value() || got.value() == 0U) {
+                break;
+            }
+            received[slot].insert(received[slot].end(), buffer.begin(),
+                                  buffer.begin() +
+                                      static_cast<std::ptrdiff_t>(got.value()));
+        }
+    };
+    loop.spawn(publisher());
+    for (std::size_t slot = 0; slot < kSubscribers; ++slot) {
+        loop.spawn(subscriber(slot));
+    }
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(peak_references, kSubscribers + 1U);
+    EXPECT_EQ(message.use_count(), 1U);
+    std::vector<std::byte> expected(prefix.begin(), prefix.end());
+    expected.insert(expected.end(), tick.begin(), tick.end());
+    for (const auto& bytes : received) {
+        EXPECT_EQ(bytes, expected);
+    }
+}
+
+/// Echo `rounds` messages through pooled read buffers handed to the writer.
+template <class Loop>
+void pooled_echo(Loop& loop, simplenet::runtime::buffer_pool& pool) {
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::socket_address::loopback(0));
+    ASSERT_TRUE(listener_result.has_value());
+    auto listener = std::move(listener_result.value());
+    const auto address = listener.local_address().value();
+
+    constexpr int kRounds = 50;
+    simplenet::runtime::buffer_pool_stats warmed{};
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accepted = co_await simplenet::runtime::async_accept(listener);
+        if (!accepted.has_value()) {
+            ADD_FAILURE() << accepted.error().message();
+            co_return;
+        }
+        auto stream = std::move(accepted.value());
+        auto peer = stream.native_handle();
+        simplenet::runtime::queued_writer writer{std::move(stream)};
+        simplenet::nonblocking::tcp_stream reader{simplenet::unique_fd{::dup(peer)}};
+        for (int round = 0;; ++round) {
+            auto buffer = pool.acquire(2048);
+            const auto got =
+                co_await simplenet::runtime::async_read_some(reader, buffer.bytes());
+            if (!got.has_value() || got.value() == 0U) {
+                break;
+            }
+            buffer.resize(got.value());
+            EXPECT_TRUE(writer.enqueue(std::move(buffer)).has_value());
+            const auto flushed = co_await writer.flush(2s);
+            EXPECT_TRUE(flushed.has_value());
+            if (round == 0) {
+                warmed = pool.stats();
+            }
+        }
+        writer.trim();
+        EXPECT_EQ(writer.queued_bytes(), 0U);
+        const auto after = pool.stats();
+        EXPECT_EQ(after.heap_allocations, warmed.heap_allocations);
+        EXPECT_EQ(after.arena_allocations, warmed.arena_allocations);
+        EXPECT_GE(after.reuses - warmed.reuses, static_cast<std::uint64_t>(kRounds - 1));
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        std::array<std::byte, 700> message{};
+        std::array<std::byte, 700> echoed{};
+        for (int round = 0; round < kRounds; ++round) {
+            message.fill(static_cast<std::byte>(round));
+            const auto wrote =
+                co_await simplenet::runtime::async_write_all(stream.value(), message);
+            EXPECT_TRUE(wrote.has_value());
+            const auto read =
+                co_await simplenet::runtime::async_read_exact(stream.value(), echoed);
+            EXPECT_TRUE(read.has_value());
+            EXPECT_EQ(echoed, message);
+        }
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+    ASSERT_TRUE(loop.run().has_value());
+}
+
+TEST(runtime_backpressure_test, pooled_buffers_echo_without_new_allocations) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    simplenet::runtime::buffer_pool pool;
+    pooled_echo(loop, pool);
+}
+
+TEST(runtime_backpressure_test, pooled_arena_reads_as_uring_fixed_buffers) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    simplenet::runtime::buffer_pool pool{
+        simplenet::runtime::buffer_pool_options{.arena_bytes = 256U * 1024U}};
+    ASSERT_FALSE(pool.arena().empty());
+    const auto registered = pool.register_with(loop);
+    if (!registered.has_value()) {
+        GTEST_SKIP() << "fixed buffers unavailable: " << registered.error().message();
+    }
+    pooled_echo(loop, pool);
+    EXPECT_EQ(pool.stats().heap_allocations, 0U);
+    EXPECT_TRUE(loop.unregister_buffers().has_value());
+}
+
+TEST(runtime_backpressure_test, zerocopy_buffers_are_held_until_released) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    constexpr std::size_t kLarge = 64U * 1024U;
+    std::vector<std::byte> expected;
+    for (std::size_t index = 0; index < 4U * kLarge + 300U; ++index) {
+        expected.push_back(static_cast<std::byte>((index * 11U) % 251U));
+    }
+
+    bool supported = true;
+    std::size_t in_flight_after = 1;
+    simplenet::result<void> server_status = simplenet::ok();
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+        auto stream = std::move(accept_result.value());
+        if (!stream.enable_zerocopy().has_value()) {
+            supported = false;
+            co_return;
+        }
+        simplenet::runtime::queued_writer writer(
+            std::move(stream), simplenet::runtime::watermarks{1U << 20U, 1U << 21U},
+            {}, simplenet::runtime::zerocopy_send{.min_bytes = 4096});
+
+        // Large move-in buffers go zero-copy; the small copy-ins in between
+        // are still sent normally and in order.
+        std::size_t offset = 0;
+        for (std::size_t round = 0; round < 4U; ++round) {
+            (void)writer.enqueue(std::vector<std::byte>(
+                expected.begin() + static_cast<std::ptrdiff_t>(offset),
+                expected.begin() + static_cast<std::ptrdiff_t>(offset + kLarge)));
+            offset += kLarge;
+            (void)writer.enqueue(std::span<const std::byte>{
+                expected.data() + offset, 75U});
+            offset += 75U;
+        }
+        server_status = co_await writer.graceful_shutdown(2s);
+        in_flight_after = writer.zerocopy_in_flight();
+    };
+    loop.spawn(server());
+
+    std::vector<std::byte> received;
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (!client.has_value()) {
+            return;
+        }
+        std::array<std::byte, 4096> buffer{};
+        while (true) {
+            auto read_result =
+                client.value().read_some(std::span<std::byte>{buffer});
+            if (!read_result.has_value() || read_result.value() == 0U) {
+                break;
+            }
+            received.insert(received.end(), buffer.begin(),
+                            buffer.begin() +
+                                static_cast<std::ptrdiff_t>(read_result.value()));
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    if (!supported) {
+        GTEST_SKIP() << "SO_ZEROCOPY unavailable";
+    }
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(in_flight_after, 0U);
+}
+
+TEST(runtime_backpressure_test, flush_waits_out_a_stalled_reader_within_deadline) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    // Large enough to fill loopback socket buffers while the reader stalls
+    // for longer than any internal wait slice used to be.
+    constexpr std::size_t kPayloadSize = std::size_t{16} << 20;
+
+    std::promise<simplenet::result<void>> server_promise;
+    auto server_future = server_promise.get_future();
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_promise.set_value(simplenet::err<void>(accept_result.error()));
+            loop.stop();
+            co_return;
+        }
+
+        simplenet::runtime::queued_writer writer(
+            std::move(accept_result.value()),
+            simplenet::runtime::watermarks{kPayloadSize, kPayloadSize * 2});
+        const auto enqueue_result = writer.enqueue(
+            std::vector<std::byte>(kPayloadSize, std::byte{0x5A}));
+        if (!enqueue_result.has_value()) {
+            server_promise.set_value(simplenet::err<void>(enqueue_result.error()));
+            loop.stop();
+            co_return;
+        }
+
+        server_promise.set_value(co_await writer.graceful_shutdown(5s));
+        loop.stop();
+    };
+    loop.spawn(server());
+
+    std::promise<simplenet::result<std::size_t>> client_promise;
+    auto client_future = client_promise.get_future();
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client_result = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (!client_result.has_value()) {
+            client_promise.set_value(
+                simplenet::err<std::size_t>(client_result.error()));
+            return;
+        }
+        auto client = std::move(client_result.value());
+
+        std::this_thread::sleep_for(300ms);
+        std::size_t received = 0;
+        std::vector<std::byte> buffer(64 * 1024);
+        while (true) {
+            auto read_result = client.read_some(std::span<std::byte>{buffer});
+            if (!read_result.has_value()) {
+                client_promise.set_value(
+                    simplenet::err<std::size_t>(read_result.error()));
+                return;
+            }
+            if (read_result.value() == 0U) {
+                break;
+            }
+            received += read_result.value();
+        }
+        client_promise.set_value(received);
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    const auto server_result = server_future.get();
+    ASSERT_TRUE(server_result.has_value()) << server_result.error().message();
+    const auto client_result = client_future.get();
+    ASSERT_TRUE(client_result.has_value()) << client_result.error().message();
+    EXPECT_EQ(client_result.value(), kPayloadSize);
+}
+
+TEST(runtime_backpressure_test, auto_flush_sends_each_iteration_and_resumes) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    constexpr std::size_t kMessages = 64;
+    constexpr std::size_t kMessageSize = 16;
+    // Far more than the socket buffers hold while the reader stalls.
+    constexpr std::size_t kBulk = std::size_t{8} << 20;
+    std::vector<std::byte> expected;
+    for (std::size_t index = 0; index < kMessages * kMessageSize + kBulk;
+         ++index) {
+        expected.push_back(static_cast<std::byte>((index * 13U) % 241U));
+    }
+
+    std::size_t queued_before_drain = 0;
+    std::size_t queued_after_drain = 1;
+    simplenet::result<void> server_status = simplenet::ok();
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+        simplenet::runtime::queued_writer writer(
+            std::move(accept_result.value()),
+            simplenet::runtime::watermarks{kBulk * 2U, kBulk * 4U});
+        writer.enable_auto_flush(loop);
+
+        // A pipelined batch stays queued until the ready queue drains.
+        for (std::size_t index = 0; index < kMessages; ++index) {
+            (void)writer.enqueue(std::span<const std::byte>{
+                expected.data() + index * kMessageSize, kMessageSize});
+        }
+        queued_before_drain = writer.queued_bytes();
+        (void)co_await simplenet::runtime::async_sleep(1ms);
+        queued_after_drain = writer.queued_bytes();
+
+        // The bulk write fills the socket; auto-flush finishes it alone.
+        const auto offset =
+            static_cast<std::ptrdiff_t>(kMessages * kMessageSize);
+        (void)writer.enqueue(
+            std::vector<std::byte>(expected.begin() + offset, expected.end()));
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (writer.queued_bytes() > 0U &&
+               std::chrono::steady_clock::now() < deadline) {
+            (void)co_await simplenet::runtime::async_sleep(1ms);
+        }
+        server_status = co_await writer.graceful_shutdown(2s);
+    };
+    loop.spawn(server());
+
+    std::vector<std::byte> received;
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (!client.has_value()) {
+            return;
+        }
+        std::this_thread::sleep_for(100ms);
+        std::vector<std::byte> buffer(64 * 1024);
+        while (true) {
+            auto read_result =
+                client.value().read_some(std::span<std::byte>{buffer});
+            if (!read_result.has_value() || read_result.value() == 0U) {
+                break;
+            }
+            received.insert(received.end(), buffer.begin(),
+                            buffer.begin() +
+                                static_cast<std::ptrdiff_t>(read_result.value()));
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    EXPECT_EQ(queued_before_drain, kMessages * kMessageSize);
+    EXPECT_EQ(queued_after_drain, 0U);
+    EXPECT_EQ(received, expected);
+}
+
+TEST(runtime_backpressure_test, auto_flush_writer_can_die_while_waiting) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    constexpr std::size_t kBulk = std::size_t{8} << 20;
+    std::atomic_bool server_done{false};
+    std::size_t left_queued = 0;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (accept_result.has_value()) {
+            simplenet::runtime::queued_writer first(
+                std::move(accept_result.value()),
+                simplenet::runtime::watermarks{kBulk * 2U, kBulk * 4U});
+            first.enable_auto_flush(loop);
+            (void)first.enqueue(std::vector<std::byte>(kBulk, std::byte{0x42}));
+            (void)co_await simplenet::runtime::async_sleep(5ms);
+            // Moving re-targets the pending writable wait; destroying the
+            // writer then cancels it.
+            auto writer = std::move(first);
+            left_queued = writer.queued_bytes();
+        }
+        server_done.store(true);
+    };
+    loop.spawn(server());
+
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        while (!server_done.load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_GT(left_queued, 0U);
+}
+
+
+/// Read exactly `count` bytes already sitting in `peer`'s receive queue.
+std::vector<std::byte> drain_peer(simplenet::nonblocking::local_stream& peer,
+                                  std::size_t count) {
+    std::vector<std::byte> received(count);
+    std::size_t done = 0;
+    while (done < count) {
+        const auto read = peer.read_some(std::span{received}.subspan(done));
+        if (!read.has_value() || read.value() == 0U) {
+            break;
+        }
+        done += read.value();
+    }
+    received.resize(done);
+    return received;
+}
+
+std::vector<std::byte> pattern(std::size_t count, unsigned seed) {
+    std::vector<std::byte> bytes(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        bytes[index] = static_cast<std::byte>((index * seed) % 251U);
+    }
+    return bytes;
+}
+
+TEST(runtime_backpressure_test, paced_flush_spreads_bytes_at_the_rate) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto made = simplenet::nonblocking::local_stream::pair();
+    ASSERT_TRUE(made.has_value()) << made.error().message();
+    auto& peer = made.value().second;
+
+    // 10 KiB leave at once; the other 50 KiB take 250 ms at 200 KB/s.
+    const auto expected = pattern(60U * 1024U, 7U);
+    std::chrono::steady_clock::duration elapsed{};
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        simplenet::runtime::queued_writer writer(
+            std::move(made.value().first),
+            simplenet::runtime::watermarks{1U << 20, 2U << 20});
+        writer.set_pacing({.rate = 200'000, .burst = 10U * 1024U});
+        (void)writer.enqueue(std::span<const std::byte>{expected});
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto flushed = co_await writer.flush(5s);
+        elapsed = std::chrono::steady_clock::now() - start;
+        if (!flushed.has_value()) {
+            ADD_FAILURE() << flushed.error().message();
+        }
+        // A deadline shorter than the pacing delay still applies.
+        (void)writer.enqueue(std::span<const std::byte>{expected});
+        const auto late = co_await writer.flush(20ms);
+        if (late.has_value() || late.error().value() != ETIMEDOUT) {
+            ADD_FAILURE() << "paced flush ignored its deadline";
+        }
+    };
+    loop.spawn(server());
+    const auto run_result = loop.run();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_GE(elapsed, 200ms);
+    EXPECT_EQ(drain_peer(peer, expected.size()), expected);
+}
+
+TEST(runtime_backpressure_test, shared_bucket_caps_auto_flushing_writers) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto made_a = simplenet::nonblocking::local_stream::pair();
+    auto made_b = simplenet::nonblocking::local_stream::pair();
+    ASSERT_TRUE(made_a.has_value()) << made_a.error().message();
+    ASSERT_TRUE(made_b.has_value()) << made_b.error().message();
+
+    // Two 24 KiB queues share 150 KB/s and an initial 8 KiB: about 270 ms,
+    // where either writer alone would be done at once.
+    const auto expected_a = pattern(24U * 1024U, 3U);
+    const auto expected_b = pattern(24U * 1024U, 11U);
+    auto tenant = std::make_shared<simplenet::runtime::token_bucket>(
+        150'000, 8U * 1024U);
+    std::chrono::steady_clock::duration elapsed{};
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        simplenet::runtime::queued_writer writer_a(std::move(made_a.value().first));
+        simplenet::runtime::queued_writer writer_b(std::move(made_b.value().first));
+        for (auto *writer : {&writer_a, &writer_b}) {
+            writer->enable_auto_flush(loop);
+            writer->set_pacing({.shared = tenant});
+        }
+        const auto start = std::chrono::steady_clock::now();
+        (void)writer_a.enqueue(std::span<const std::byte>{expected_a});
+        (void)writer_b.enqueue(std::span<const std::byte>{expected_b});
+        const auto deadline = start + 5s;
+        while ((writer_a.queued_bytes() > 0U || writer_b.queued_bytes() > 0U) &&
+               std::chrono::steady_clock::now() < deadline) {
+            (void)co_await simplenet::runtime::async_sleep(1ms);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+    };
+    loop.spawn(server());
+    const auto run_result = loop.run();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_GE(elapsed, 200ms);
+    EXPECT_LT(elapsed, 5s);
+    EXPECT_EQ(drain_peer(made_a.value().second, expected_a.size()), expected_a);
+    EXPECT_EQ(drain_peer(made_b.value().second, expected_b.size()), expected_b);
+}
+
+TEST(runtime_backpressure_test, shared_bucket_does_not_starve_a_long_queue) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto made_long = simplenet::nonblocking::local_stream::pair();
+    auto made_short = simplenet::nonblocking::local_stream::pair();
+    ASSERT_TRUE(made_long.has_value()) << made_long.error().message();
+    ASSERT_TRUE(made_short.has_value()) << made_short.error().message();
+
+    // The short writer keeps 4 KiB queued and spends every refill that
+    // reaches it, so a full 16 KiB burst never accrues for the long one.
+    const auto expected = pattern(32U * 1024U, 13U);
+    const auto chatter = pattern(4U * 1024U, 5U);
+    auto tenant = std::make_shared<simplenet::runtime::token_bucket>(
+        100'000, 16U * 1024U);
+    std::chrono::steady_clock::duration elapsed{};
+    std::size_t long_left = 0;
+    std::size_t short_rounds = 0;
+    std::size_t short_sent = 0;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        simplenet::runtime::queued_writer long_writer(
+            std::move(made_long.value().first));
+        simplenet::runtime::queued_writer short_writer(
+            std::move(made_short.value().first));
+        for (auto *writer : {&long_writer, &short_writer}) {
+            writer->enable_auto_flush(loop);
+            writer->set_pacing({.shared = tenant});
+        }
+        const auto start = std::chrono::steady_clock::now();
+        (void)long_writer.enqueue(std::span<const std::byte>{expected});
+        const auto deadline = start + 1500ms;
+        while (long_writer.queued_bytes() > 0U &&
+               std::chrono::steady_clock::now() < deadline) {
+            if (short_writer.queued_bytes() == 0U) {
+                (void)short_writer.enqueue(std::span<const std::byte>{chatter});
+                ++short_rounds;
+            }
+            (void)co_await simplenet::runtime::async_sleep(1ms);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        long_left = long_writer.queued_bytes();
+        short_sent = short_rounds * chatter.size() - short_writer.queued_bytes();
+    };
+    loop.spawn(server());
+    const auto run_result = loop.run();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(long_left, 0U);
+    EXPECT_LT(elapsed, 1500ms);
+    EXPECT_GT(short_sent, 4U * 1024U);
+    EXPECT_EQ(drain_peer(made_long.value().second, expected.size()), expected);
+}
+
+TEST(runtime_backpressure_test, paced_writer_can_die_while_waiting_for_tokens) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto made = simplenet::nonblocking::local_stream::pair();
+    ASSERT_TRUE(made.has_value()) << made.error().message();
+
+    std::size_t left_queued = 0;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        {
+            simplenet::runtime::queued_writer writer(std::move(made.value().first));
+            writer.enable_auto_flush(loop);
+            writer.set_pacing({.rate = 1000});
+            (void)writer.enqueue(pattern(8U * 1024U, 5U));
+            (void)co_await simplenet::runtime::async_sleep(5ms);
+            left_queued = writer.queued_bytes();
+        }
+        // The cancelled refill timer still resumes its orphaned frame.
+        (void)co_await simplenet::runtime::async_sleep(2ms);
+    };
+    loop.spawn(server());
+    const auto run_result = loop.run();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(left_queued, 7U * 1024U);
+}
+
+TEST(runtime_backpressure_test, kernel_pacing_sets_the_socket_rate_cap) {
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto port_result = listener_result.value().local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+    auto stream = simplenet::nonblocking::tcp_stream::connect(
+        simplenet::nonblocking::endpoint::loopback(port_result.value()));
+    ASSERT_TRUE(stream.has_value()) << stream.error().message();
+
+    simplenet::runtime::queued_writer writer(std::move(stream.value()));
+    writer.set_pacing({.rate = 1'000'000, .kernel = true});
+    const auto read_rate = [&writer]() {
+        std::uint64_t rate = 0;
+        socklen_t length = sizeof(rate);
+        if (::getsockopt(writer.native_handle(), SOL_SOCKET, SO_MAX_PACING_RATE,
+                         &rate, &length) != 0) {
+            return std::uint64_t{0};
+        }
+        return length == sizeof(std::uint32_t)
+                   ? static_cast<std::uint64_t>(static_cast<std::uint32_t>(rate))
+                   : rate;
+    };
+    if (!writer.current_pacing().kernel) {
+        GTEST_SKIP() << "SO_MAX_PACING_RATE refused";
+    }
+    EXPECT_EQ(read_rate(), 1'000'000U);
+
+    // Dropping the limit lifts the kernel cap again.
+    writer.set_pacing({});
+    EXPECT_FALSE(writer.current_pacing().kernel);
+    EXPECT_EQ(read_rate(), std::numeric_limits<std::uint64_t>::max());
+}
+
 } // namespace
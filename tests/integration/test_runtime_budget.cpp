@@ -0,0 +1,117 @@
+#include "simplenet/core/unique_fd.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/resume_budget.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <array>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::task;
+
+task<void> take_turns(char name, int rounds, std::string& order) {
+    for (int round = 0; round < rounds; ++round) {
+        order.push_back(name);
+        co_await simplenet::runtime::yield();
+    }
+}
+
+struct starvation_probe {
+    bool readable{false};
+    int spins{0};
+};
+
+/// Stays ready until the reader ran, or gives up after `limit` yields.
+task<void> spinner(starvation_probe& probe, int limit) {
+    while (!probe.readable && probe.spins < limit) {
+        ++probe.spins;
+        co_await simplenet::runtime::yield();
+    }
+}
+
+task<void> reader(int fd, starvation_probe& probe) {
+    const auto ready = co_await simplenet::runtime::wait_readable(fd);
+    if (!ready.has_value()) {
+        ADD_FAILURE() << ready.error().message();
+        co_return;
+    }
+    probe.readable = true;
+}
+
+template <class Loop> void expect_yield_interleaves(Loop& loop) {
+    std::string order;
+    loop.spawn(take_turns('a', 3, order));
+    loop.spawn(take_turns('b', 3, order));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(order, "ababab");
+}
+
+template <class Loop>
+void expect_budget_lets_io_through(Loop& loop, std::size_t max_resumes,
+                                   std::chrono::microseconds max_time) {
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds.data()),
+              0);
+    const simplenet::unique_fd left{fds[0]};
+    const simplenet::unique_fd right{fds[1]};
+    ASSERT_EQ(::write(right.get(), "x", 1), 1);
+
+    constexpr int limit = 1'000'000;
+    starvation_probe probe;
+    loop.set_resume_budget(max_resumes, max_time);
+    loop.spawn(spinner(probe, limit));
+    loop.spawn(reader(left.get(), probe));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(probe.readable);
+    EXPECT_LT(probe.spins, limit);
+    if constexpr (simplenet::runtime::metrics_enabled) {
+        EXPECT_GT(loop.metrics().budget_polls, 0U);
+    }
+}
+
+TEST(runtime_budget_test, epoll_yield_interleaves_ready_coroutines) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_yield_interleaves(loop);
+}
+
+TEST(runtime_budget_test, uring_yield_interleaves_ready_coroutines) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_yield_interleaves(loop);
+}
+
+TEST(runtime_budget_test, epoll_resume_count_budget_polls_for_io) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_budget_lets_io_through(loop, 16, 0us);
+}
+
+TEST(runtime_budget_test, epoll_resume_time_budget_polls_for_io) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_budget_lets_io_through(loop, 0, 100us);
+}
+
+TEST(runtime_budget_test, uring_resume_count_budget_polls_for_io) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_budget_lets_io_through(loop, 16, 0us);
+}
+
+} // namespace
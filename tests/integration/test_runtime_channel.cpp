@@ -0,0 +1,238 @@
+#include "simplenet/runtime/channel.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::channel;
+using simplenet::runtime::mpmc_channel;
+using simplenet::runtime::task;
+
+// Bumps a counter when the frame holding it is destroyed.
+struct frame_probe {
+    int& destroyed;
+    ~frame_probe() {
+        ++destroyed;
+    }
+};
+
+template <class Loop> void expect_channel_orders_and_backpressures(Loop& loop) {
+    constexpr int kItems = 50;
+    channel<std::string> pipe{4};
+    std::vector<std::string> received;
+    std::size_t peak = 0;
+    auto producer = [&]() -> task<void> {
+        for (int index = 0; index < kItems; ++index) {
+            const auto sent = co_await pipe.send(std::to_string(index));
+            if (!sent.has_value()) {
+                ADD_FAILURE() << sent.error().message();
+            }
+            peak = std::max(peak, pipe.size());
+        }
+        pipe.close();
+    };
+    auto consumer = [&]() -> task<void> {
+        while (true) {
+            auto item = co_await pipe.receive();
+            if (!item.has_value()) {
+                co_return;
+            }
+            received.push_back(std::move(*item));
+            // Yield so the producer fills the buffer up to capacity.
+            (void)co_await simplenet::runtime::async_sleep(0ms);
+        }
+    };
+    loop.spawn(consumer());
+    loop.spawn(producer());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_EQ(received.size(), static_cast<std::size_t>(kItems));
+    for (int index = 0; index < kItems; ++index) {
+        EXPECT_EQ(received[static_cast<std::size_t>(index)], std::to_string(index));
+    }
+    EXPECT_EQ(peak, pipe.capacity());
+}
+
+TEST(runtime_channel_test, orders_items_and_holds_back_producers) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_channel_orders_and_backpressures(loop);
+}
+
+TEST(runtime_channel_test, orders_items_and_holds_back_producers_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_channel_orders_and_backpressures(loop);
+}
+
+TEST(runtime_channel_test, close_fails_senders_and_drains_receivers) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    channel<int> pipe{1};
+    int parked_error = 0;
+    int late_error = 0;
+    std::vector<std::optional<int>> received;
+    auto sender = [&]() -> task<void> {
+        (void)co_await pipe.send(1);
+        // The buffer is full: this one parks until close().
+        const auto parked = co_await pipe.send(2);
+        parked_error = parked.has_value() ? 0 : parked.error().value();
+        const auto late = co_await pipe.send(3);
+        late_error = late.has_value() ? 0 : late.error().value();
+    };
+    auto closer = [&]() -> task<void> {
+        (void)co_await simplenet::runtime::async_sleep(10ms);
+        pipe.close();
+        for (int index = 0; index < 2; ++index) {
+            received.push_back(co_await pipe.receive());
+        }
+    };
+    loop.spawn(sender());
+    loop.spawn(closer());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(parked_error, EPIPE);
+    EXPECT_EQ(late_error, EPIPE);
+    ASSERT_EQ(received.size(), 2U);
+    EXPECT_EQ(received[0], std::optional<int>{1});
+    EXPECT_EQ(received[1], std::nullopt);
+}
+
+TEST(runtime_channel_test, try_operations_never_park) {
+    channel<int> pipe{2};
+    EXPECT_EQ(pipe.try_receive(), std::nullopt);
+    EXPECT_TRUE(pipe.try_send(1));
+    EXPECT_TRUE(pipe.try_send(2));
+    int rejected = 3;
+    EXPECT_FALSE(pipe.try_send(std::move(rejected)));
+    EXPECT_EQ(pipe.size(), 2U);
+    EXPECT_EQ(pipe.try_receive(), std::optional<int>{1});
+    pipe.close();
+    EXPECT_FALSE(pipe.try_send(4));
+    EXPECT_EQ(pipe.try_receive(), std::optional<int>{2});
+    EXPECT_EQ(pipe.try_receive(), std::nullopt);
+}
+
+TEST(runtime_channel_test, teardown_unlinks_parked_operations) {
+    int destroyed = 0;
+    channel<int> pipe{1};
+    {
+        auto loop = std::make_unique<simplenet::runtime::event_loop>();
+        ASSERT_TRUE(loop->valid());
+        auto receiver = [&]() -> task<void> {
+            frame_probe probe{destroyed};
+            (void)co_await pipe.receive();
+            ADD_FAILURE() << "receiver resumed";
+        };
+        auto stopper = [&loop]() -> task<void> {
+            loop->stop();
+            co_return;
+        };
+        loop->spawn(receiver());
+        loop->spawn(stopper());
+        const auto run_result = loop->run();
+        ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+        loop.reset();
+    }
+    EXPECT_EQ(destroyed, 1);
+    // The destroyed receiver left no dangling link behind.
+    EXPECT_TRUE(pipe.try_send(7));
+    EXPECT_EQ(pipe.try_receive(), std::optional<int>{7});
+}
+
+TEST(runtime_channel_test, mpmc_moves_every_item_between_loops) {
+    constexpr std::uint64_t kPerProducer = 5000;
+    mpmc_channel<std::uint64_t> pipe{8};
+    EXPECT_EQ(pipe.capacity(), 8U);
+
+    simplenet::runtime::event_loop epoll;
+    ASSERT_TRUE(epoll.valid());
+    std::uint64_t received_sum = 0;
+    std::uint64_t received_count = 0;
+    int producers_left = 2;
+    auto run_consumer = [&]() {
+        simplenet::runtime::event_loop loop;
+        ASSERT_TRUE(loop.valid());
+        auto consumer = [&]() -> task<void> {
+            while (true) {
+                auto item = co_await pipe.receive();
+                if (!item.has_value()) {
+                    co_return;
+                }
+                received_sum += *item;
+                ++received_count;
+            }
+        };
+        loop.spawn(consumer());
+        const auto run_result = loop.run();
+        EXPECT_TRUE(run_result.has_value()) << run_result.error().message();
+    };
+    std::thread consumer_thread{run_consumer};
+
+    // Both producers share one loop on this thread; the last one closes.
+    auto producer = [&](std::uint64_t first) -> task<void> {
+        for (std::uint64_t value = first; value < first + kPerProducer; ++value) {
+            const auto sent = co_await pipe.send(value);
+            if (!sent.has_value()) {
+                ADD_FAILURE() << sent.error().message();
+            }
+        }
+        if (--producers_left == 0) {
+            pipe.close();
+        }
+    };
+    epoll.spawn(producer(0));
+    epoll.spawn(producer(kPerProducer));
+    const auto run_result = epoll.run();
+    consumer_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    constexpr std::uint64_t kTotal = 2 * kPerProducer;
+    EXPECT_EQ(received_count, kTotal);
+    EXPECT_EQ(received_sum, kTotal * (kTotal - 1) / 2);
+}
+
+TEST(runtime_channel_test, mpmc_close_wakes_a_receiver_on_another_loop) {
+    mpmc_channel<int> pipe{2};
+    std::optional<int> received{0};
+    std::thread receiver_thread{[&]() {
+        simplenet::runtime::uring_event_loop loop;
+        if (!loop.valid()) {
+            received = std::nullopt;
+            pipe.close();
+            return;
+        }
+        auto receiver = [&]() -> task<void> {
+            received = co_await pipe.receive();
+        };
+        loop.spawn(receiver());
+        const auto run_result = loop.run();
+        EXPECT_TRUE(run_result.has_value()) << run_result.error().message();
+    }};
+
+    std::this_thread::sleep_for(20ms);
+    pipe.close();
+    receiver_thread.join();
+    EXPECT_EQ(received, std::nullopt);
+    int late = 1;
+    EXPECT_FALSE(pipe.try_send(std::move(late)));
+}
+
+} // namespace
@@ -0,0 +1,416 @@
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/connection_pool.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using simplenet::nonblocking::socket_address;
+using simplenet::nonblocking::tcp_listener;
+using simplenet::nonblocking::tcp_stream;
+using simplenet::runtime::connection_pool;
+using simplenet::runtime::connection_pool_options;
+using simplenet::runtime::pooled_connection;
+
+// Loopback listener whose accepted streams stay open until cleared.
+struct test_server {
+    tcp_listener listener{};
+    socket_address address{};
+    std::vector<tcp_stream> accepted{};
+
+    test_server() {
+        auto bound = tcp_listener::bind(socket_address::loopback(0));
+        EXPECT_TRUE(bound.has_value()) << bound.error().message();
+        if (bound.has_value()) {
+            listener = std::move(bound.value());
+            address = listener.local_address().value();
+        }
+    }
+
+    simplenet::runtime::task<void> accept(int count) {
+        for (int index = 0; index < count; ++index) {
+            auto stream = co_await simplenet::runtime::async_accept(listener);
+            if (!stream.has_value()) {
+                ADD_FAILURE() << stream.error().message();
+                co_return;
+            }
+            accepted.push_back(std::move(stream.value()));
+        }
+    }
+};
+
+// Blocks the loop thread so the next timer pass expires a shorter sleep
+// and the pool's idle timer together; the sleep's waiter resumes first.
+simplenet::runtime::task<void> stall_loop() {
+    std::this_thread::sleep_for(60ms);
+    co_return;
+}
+
+} // namespace
+
+TEST(runtime_connection_pool_test, recycled_connection_is_reused) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool;
+
+    bool second_reused = false;
+    int second_fd = -1;
+    int first_fd = -1;
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto first = co_await pool.acquire(server.address);
+        if (!first.has_value()) {
+            ADD_FAILURE() << first.error().message();
+            co_return;
+        }
+        EXPECT_FALSE(first.value().reused());
+        first_fd = first.value().stream().native_handle();
+        EXPECT_EQ(pool.active_count(server.address), 1U);
+        first.value().recycle();
+        EXPECT_EQ(pool.idle_count(server.address), 1U);
+
+        auto second = co_await pool.acquire(server.address);
+        if (!second.has_value()) {
+            ADD_FAILURE() << second.error().message();
+            co_return;
+        }
+        second_reused = second.value().reused();
+        second_fd = second.value().stream().native_handle();
+        second.value().recycle();
+        pool.close_idle();
+    };
+    loop.spawn(server.accept(1));
+    loop.spawn(client());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(second_reused);
+    EXPECT_EQ(second_fd, first_fd);
+    EXPECT_EQ(server.accepted.size(), 1U);
+    EXPECT_EQ(pool.stats().connects, 1U);
+    EXPECT_EQ(pool.stats().reuses, 1U);
+    EXPECT_EQ(pool.idle_count(server.address), 0U);
+}
+
+TEST(runtime_connection_pool_test, dropped_lease_closes_its_connection) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool;
+
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        {
+            auto first = co_await pool.acquire(server.address);
+            if (!first.has_value()) {
+                ADD_FAILURE() << first.error().message();
+                co_return;
+            }
+        }
+        EXPECT_EQ(pool.idle_count(server.address), 0U);
+        EXPECT_EQ(pool.active_count(server.address), 0U);
+        auto second = co_await pool.acquire(server.address);
+        if (!second.has_value()) {
+            ADD_FAILURE() << second.error().message();
+            co_return;
+        }
+        EXPECT_FALSE(second.value().reused());
+    };
+    loop.spawn(server.accept(2));
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(pool.stats().connects, 2U);
+    EXPECT_EQ(pool.stats().reuses, 0U);
+}
+
+TEST(runtime_connection_pool_test, checkout_drops_connections_the_peer_closed) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool;
+
+    bool reused = true;
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto first = co_await pool.acquire(server.address);
+        if (!first.has_value()) {
+            ADD_FAILURE() << first.error().message();
+            co_return;
+        }
+        first.value().recycle();
+
+        // Wait for the server side to exist, close it, let the FIN land.
+        while (server.accepted.empty()) {
+            (void)co_await simplenet::runtime::async_sleep(1ms);
+        }
+        server.accepted.clear();
+        (void)co_await simplenet::runtime::async_sleep(10ms);
+
+        auto second = co_await pool.acquire(server.address);
+        if (!second.has_value()) {
+            ADD_FAILURE() << second.error().message();
+            co_return;
+        }
+        reused = second.value().reused();
+        pool.close_idle();
+    };
+    loop.spawn(server.accept(2));
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_FALSE(reused);
+    EXPECT_EQ(pool.stats().stale, 1U);
+    EXPECT_EQ(pool.stats().connects, 2U);
+}
+
+TEST(runtime_connection_pool_test, exhausted_pool_queues_until_a_recycle) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool{connection_pool_options{.max_active_per_host = 1}};
+
+    std::vector<int> order;
+    bool waiter_reused = false;
+    auto holder = [&]() -> simplenet::runtime::task<void> {
+        auto lease = co_await pool.acquire(server.address);
+        if (!lease.has_value()) {
+            ADD_FAILURE() << lease.error().message();
+            co_return;
+        }
+        order.push_back(1);
+        (void)co_await simplenet::runtime::async_sleep(20ms);
+        order.push_back(2);
+        lease.value().recycle();
+    };
+    auto waiter = [&]() -> simplenet::runtime::task<void> {
+        auto lease = co_await pool.acquire(server.address);
+        if (!lease.has_value()) {
+            ADD_FAILURE() << lease.error().message();
+            co_return;
+        }
+        order.push_back(3);
+        waiter_reused = lease.value().reused();
+        EXPECT_EQ(pool.active_count(server.address), 1U);
+        lease.value().recycle();
+        pool.close_idle();
+    };
+    loop.spawn(server.accept(1));
+    loop.spawn(holder());
+    loop.spawn(waiter());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_TRUE(waiter_reused);
+    EXPECT_EQ(pool.stats().waits, 1U);
+    EXPECT_EQ(pool.stats().connects, 1U);
+}
+
+TEST(runtime_connection_pool_test, queued_acquire_observes_cancellation) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool{connection_pool_options{.max_active_per_host = 1}};
+
+    simplenet::runtime::cancel_source source;
+    simplenet::result<pooled_connection> queued =
+        simplenet::err<pooled_connection>(
+            simplenet::make_error_from_errno(EINVAL));
+    auto holder = [&]() -> simplenet::runtime::task<void> {
+        auto lease = co_await pool.acquire(server.address);
+        if (!lease.has_value()) {
+            ADD_FAILURE() << lease.error().message();
+            co_return;
+        }
+        (void)co_await simplenet::runtime::async_sleep(50ms);
+    };
+    auto waiter = [&]() -> simplenet::runtime::task<void> {
+        queued = co_await pool.acquire(server.address, source.token());
+    };
+    auto stopper = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(5ms);
+        source.request_stop();
+        EXPECT_FALSE(queued.has_value());
+    };
+    loop.spawn(server.accept(1));
+    loop.spawn(holder());
+    loop.spawn(waiter());
+    loop.spawn(stopper());
+
+    ASSERT_TRUE(loop.run().has_value());
+    ASSERT_FALSE(queued.has_value());
+    EXPECT_EQ(queued.error().value(), ECANCELED);
+    EXPECT_EQ(pool.active_count(server.address), 0U);
+}
+
+TEST(runtime_connection_pool_test, idle_timer_closes_unused_connections) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool{connection_pool_options{.idle_timeout = 30ms}};
+
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto lease = co_await pool.acquire(server.address);
+        if (!lease.has_value()) {
+            ADD_FAILURE() << lease.error().message();
+            co_return;
+        }
+        lease.value().recycle();
+    };
+    loop.spawn(server.accept(1));
+    loop.spawn(client());
+
+    // The armed idle timer keeps the loop running until it fires.
+    const auto started = std::chrono::steady_clock::now();
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_GE(std::chrono::steady_clock::now() - started, 25ms);
+    EXPECT_EQ(pool.idle_count(server.address), 0U);
+    EXPECT_EQ(pool.stats().expired, 1U);
+}
+
+TEST(runtime_connection_pool_test, idle_list_is_capped_per_host) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool{connection_pool_options{.max_idle_per_host = 1}};
+
+    std::size_t idle_after = 0;
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto first = co_await pool.acquire(server.address);
+        auto second = co_await pool.acquire(server.address);
+        if (!first.has_value() || !second.has_value()) {
+            ADD_FAILURE();
+            co_return;
+        }
+        first.value().recycle();
+        second.value().recycle();
+        idle_after = pool.idle_count(server.address);
+        pool.close_idle();
+    };
+    loop.spawn(server.accept(2));
+    loop.spawn(client());
+
+    // `close_idle()` disarmed the 30 s idle timer, so the loop ends now.
+    const auto started = std::chrono::steady_clock::now();
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 5s);
+    EXPECT_EQ(idle_after, 1U);
+}
+
+TEST(runtime_connection_pool_test, pool_destroyed_with_an_armed_timer) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        connection_pool pool;
+        auto lease = co_await pool.acquire(server.address);
+        if (!lease.has_value()) {
+            ADD_FAILURE() << lease.error().message();
+            co_return;
+        }
+        lease.value().recycle();
+    };
+    loop.spawn(server.accept(1));
+    loop.spawn(client());
+
+    const auto started = std::chrono::steady_clock::now();
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 5s);
+}
+
+TEST(runtime_connection_pool_test, pool_destroyed_while_its_fired_reaper_is_queued) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    // On the heap, so a reaper that touches it after the reset trips ASan.
+    auto pool = std::make_unique<connection_pool>(
+        connection_pool_options{.idle_timeout = 20ms});
+
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto lease = co_await pool->acquire(server.address);
+        if (!lease.has_value()) {
+            ADD_FAILURE() << lease.error().message();
+            co_return;
+        }
+        lease.value().recycle();
+        loop.spawn(stall_loop());
+        (void)co_await simplenet::runtime::async_sleep(1ms);
+        pool.reset();
+    };
+    loop.spawn(server.accept(1));
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(pool, nullptr);
+}
+
+TEST(runtime_connection_pool_test, close_idle_while_its_fired_reaper_is_queued) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    test_server server;
+    connection_pool pool{connection_pool_options{.idle_timeout = 20ms}};
+
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto first = co_await pool.acquire(server.address);
+        if (!first.has_value()) {
+            ADD_FAILURE() << first.error().message();
+            co_return;
+        }
+        first.value().recycle();
+        loop.spawn(stall_loop());
+        (void)co_await simplenet::runtime::async_sleep(1ms);
+        pool.close_idle();
+
+        // A fresh reaper takes over the timer and expires the next idle one.
+        auto second = co_await pool.acquire(server.address);
+        if (!second.has_value()) {
+            ADD_FAILURE() << second.error().message();
+            co_return;
+        }
+        second.value().recycle();
+    };
+    loop.spawn(server.accept(2));
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(pool.idle_count(server.address), 0U);
+    EXPECT_EQ(pool.stats().expired, 1U);
+}
+
+TEST(runtime_connection_pool_test, idle_timer_runs_on_the_uring_backend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    test_server server;
+    connection_pool expiring{connection_pool_options{.idle_timeout = 20ms}};
+
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        connection_pool closing;
+        auto first = co_await expiring.acquire(server.address);
+        auto second = co_await closing.acquire(server.address);
+        if (!first.has_value() || !second.has_value()) {
+            ADD_FAILURE() << "acquire failed";
+            co_return;
+        }
+        first.value().recycle();
+        second.value().recycle();
+    };
+    loop.spawn(server.accept(2));
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(expiring.stats().expired, 1U);
+    EXPECT_EQ(expiring.idle_count(server.address), 0U);
+}
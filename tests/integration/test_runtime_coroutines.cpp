@@ -1,21 +1,88 @@
 #include "simplenet/blocking/tcp.hpp"
 #include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/acceptor.hpp"
 #include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/frame_pool.hpp"
 #include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/receiver.hpp"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cerrno>
 #include <chrono>
+#include <cstdint>
 #include <fcntl.h>
 #include <future>
 #include <gtest/gtest.h>
+#include <memory>
+#include <sys/socket.h>
+#include <stdexcept>
 #include <thread>
 #include <unistd.h>
 #include <vector>
 
 namespace {
 
+simplenet::runtime::task<int> value_of(int value) {
+    co_return value;
+}
+
+simplenet::runtime::task<void> record(std::vector<int>& log, int marker) {
+    log.push_back(marker);
+    co_return;
+}
+
+simplenet::runtime::task<void> record_nested(std::vector<int>& log) {
+    log.push_back(1);
+    co_await record(log, 2);
+    log.push_back(3);
+}
+
+simplenet::runtime::task<void> record_root(std::vector<int>& log) {
+    co_await record_nested(log);
+    log.push_back(4);
+}
+
+TEST(runtime_coroutines_test, awaited_tasks_resume_without_scheduler_hops) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    constexpr int kAwaits = 1000;
+    long long sum = 0;
+    std::vector<int> log;
+    auto chain = [&]() -> simplenet::runtime::task<void> {
+        for (int index = 0; index < kAwaits; ++index) {
+            sum += co_await value_of(1);
+        }
+        co_await record_root(log);
+    };
+    loop.spawn(chain());
+    loop.spawn(record(log, 5));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(sum, kAwaits);
+    // The whole chain finished before the second root got a turn.
+    EXPECT_EQ(log, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST(runtime_coroutines_test, inline_depth_limit_hops_through_scheduler) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    loop.set_inline_depth_limit(1);
+    EXPECT_EQ(loop.inline_depth_limit(), 1U);
+
+    std::vector<int> log;
+    loop.spawn(record_root(log));
+    loop.spawn(record(log, 5));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    // Depth 1 ran inline; the depth-2 task was queued behind the second root.
+    EXPECT_EQ(log, (std::vector<int>{1, 5, 2, 3, 4}));
+}
+
 TEST(runtime_coroutines_test, wait_readable_suspends_and_resumes_in_order) {
     simplenet::runtime::event_loop loop;
     ASSERT_TRUE(loop.valid());
@@ -171,6 +238,268 @@ TEST(runtime_coroutines_test, async_accept_read_write_echo) {
     ASSERT_TRUE(client_result.has_value()) << client_result.error().message();
 }
 
+TEST(runtime_coroutines_test, vectored_ops_round_trip_across_partial_writes) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 32);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    // Large enough that the kernel accepts it in several partial writes.
+    std::vector<std::byte> header(24, std::byte{0x11});
+    std::vector<std::byte> body(1024U * 1024U);
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<std::byte>((i * 31U) % 241U);
+    }
+    const std::array<::iovec, 3> outbound{
+        ::iovec{.iov_base = header.data(), .iov_len = header.size()},
+        ::iovec{.iov_base = nullptr, .iov_len = 0},
+        ::iovec{.iov_base = body.data(), .iov_len = body.size()},
+    };
+
+    std::vector<std::byte> echoed_header(header.size());
+    std::vector<std::byte> echoed_body(body.size());
+    simplenet::result<void> reader_status = simplenet::ok();
+    auto reader = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            reader_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+        auto peer = std::move(accept_result.value());
+
+        std::size_t total = 0;
+        const auto expected = header.size() + body.size();
+        while (total < expected) {
+            // Rebuild the scatter list past what already arrived.
+            std::array<::iovec, 2> inbound{};
+            std::size_t count = 0;
+            if (total < header.size()) {
+                inbound[count++] = ::iovec{.iov_base = echoed_header.data() + total,
+                                           .iov_len = header.size() - total};
+            }
+            const auto body_offset = total > header.size() ? total - header.size() : 0;
+            inbound[count++] = ::iovec{.iov_base = echoed_body.data() + body_offset,
+                                       .iov_len = body.size() - body_offset};
+
+            auto received = co_await simplenet::runtime::async_readv(
+                peer, std::span<const ::iovec>{inbound.data(), count});
+            if (!received.has_value() || received.value() == 0U) {
+                reader_status = simplenet::err<void>(
+                    received.has_value()
+                        ? simplenet::make_error_from_errno(ECONNRESET)
+                        : received.error());
+                co_return;
+            }
+            total += received.value();
+        }
+    };
+    loop.spawn(reader());
+
+    simplenet::result<void> writer_status = simplenet::ok();
+    std::thread writer_thread([&, port = port_result.value()]() {
+        simplenet::runtime::event_loop client_loop;
+        auto writer = [&]() -> simplenet::runtime::task<void> {
+            auto stream = co_await simplenet::runtime::async_connect(
+                simplenet::nonblocking::endpoint::loopback(port));
+            if (!stream.has_value()) {
+                writer_status = simplenet::err<void>(stream.error());
+                co_return;
+            }
+            writer_status = co_await simplenet::runtime::async_writev_all(
+                stream.value(), std::span<const ::iovec>{outbound});
+        };
+        client_loop.spawn(writer());
+        const auto client_run = client_loop.run();
+        if (!client_run.has_value()) {
+            writer_status = client_run;
+        }
+    });
+
+    const auto run_result = loop.run();
+    writer_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(writer_status.has_value()) << writer_status.error().message();
+    ASSERT_TRUE(reader_status.has_value()) << reader_status.error().message();
+    EXPECT_EQ(echoed_header, header);
+    EXPECT_EQ(echoed_body, body);
+}
+
+TEST(runtime_coroutines_test, zerocopy_send_completes_after_release) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 32);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    std::vector<std::byte> payload(32U * 1024U);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<std::byte>((i * 5U) % 239U);
+    }
+    const auto expected = payload;
+
+    simplenet::result<void> sender_status = simplenet::ok();
+    auto sender = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            sender_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+        auto peer = std::move(accept_result.value());
+        std::size_t total = 0;
+        while (total < payload.size()) {
+            auto sent = co_await simplenet::runtime::async_send_zerocopy(
+                peer, std::span<const std::byte>{payload}.subspan(total));
+            if (!sent.has_value()) {
+                sender_status = simplenet::err<void>(sent.error());
+                co_return;
+            }
+            total += sent.value();
+        }
+        // Released: scribbling now cannot reach the wire.
+        std::ranges::fill(payload, std::byte{0});
+        (void)peer.shutdown_write();
+    };
+    loop.spawn(sender());
+
+    std::vector<std::byte> received;
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (!client.has_value()) {
+            return;
+        }
+        std::array<std::byte, 4096> buffer{};
+        while (true) {
+            auto read_result =
+                client.value().read_some(std::span<std::byte>{buffer});
+            if (!read_result.has_value() || read_result.value() == 0U) {
+                break;
+            }
+            received.insert(received.end(), buffer.begin(),
+                            buffer.begin() +
+                                static_cast<std::ptrdiff_t>(read_result.value()));
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    if (!sender_status.has_value() &&
+        sender_status.error().value() == ENOPROTOOPT) {
+        GTEST_SKIP() << "SO_ZEROCOPY unavailable";
+    }
+    ASSERT_TRUE(sender_status.has_value()) << sender_status.error().message();
+    EXPECT_EQ(received, expected);
+}
+
+TEST(runtime_coroutines_test, frameless_ops_echo_without_task_frames) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    constexpr std::size_t kPayload = 64;
+    constexpr int kRounds = 200;
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 32);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    simplenet::result<void> server_status = simplenet::ok();
+    std::uint64_t frames_during_echo = 0;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+        auto peer = std::move(accept_result.value());
+        std::array<std::byte, kPayload> buffer{};
+
+        const auto before = simplenet::runtime::frame_pool_thread_stats();
+        for (int round = 0; round < kRounds; ++round) {
+            std::size_t filled = 0;
+            while (filled < buffer.size()) {
+                auto received = co_await simplenet::runtime::read_some_op(
+                    peer, std::span<std::byte>{buffer}.subspan(filled));
+                if (!received.has_value() || received.value() == 0U) {
+                    server_status = simplenet::err<void>(
+                        received.has_value()
+                            ? simplenet::make_error_from_errno(ECONNRESET)
+                            : received.error());
+                    co_return;
+                }
+                filled += received.value();
+            }
+            std::size_t sent = 0;
+            while (sent < buffer.size()) {
+                auto written = co_await simplenet::runtime::write_some_op(
+                    peer, std::span<const std::byte>{buffer}.subspan(sent));
+                if (!written.has_value()) {
+                    server_status = simplenet::err<void>(written.error());
+                    co_return;
+                }
+                sent += written.value();
+            }
+        }
+        frames_during_echo =
+            simplenet::runtime::frame_pool_thread_stats().allocations -
+            before.allocations;
+    };
+    loop.spawn(server());
+
+    simplenet::result<void> client_status = simplenet::ok();
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (!client.has_value()) {
+            client_status = simplenet::err<void>(client.error());
+            return;
+        }
+        std::array<std::byte, kPayload> outbound{};
+        std::array<std::byte, kPayload> echoed{};
+        for (int round = 0; round < kRounds; ++round) {
+            outbound.fill(static_cast<std::byte>(round));
+            auto status = simplenet::blocking::write_all(
+                client.value(), std::span<const std::byte>{outbound});
+            if (status.has_value()) {
+                status = simplenet::blocking::read_exact(
+                    client.value(), std::span<std::byte>{echoed});
+            }
+            if (!status.has_value() || echoed != outbound) {
+                client_status = status.has_value()
+                                    ? simplenet::err<void>(
+                                          simplenet::make_error_from_errno(EBADMSG))
+                                    : status;
+                return;
+            }
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    ASSERT_TRUE(client_status.has_value()) << client_status.error().message();
+    EXPECT_EQ(frames_during_echo, 0U);
+}
+
 TEST(runtime_coroutines_test,
      async_connect_path_completes_handshake_and_round_trip) {
     simplenet::runtime::event_loop loop;
@@ -269,4 +598,539 @@ TEST(runtime_coroutines_test,
     ASSERT_TRUE(client_result.has_value()) << client_result.error().message();
 }
 
+TEST(runtime_coroutines_test, multishot_acceptor_falls_back_to_readiness_accept) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    constexpr std::size_t connection_count = 3;
+    std::size_t accepted = 0;
+    bool ever_armed = false;
+    simplenet::result<void> server_status = simplenet::ok();
+
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        simplenet::runtime::multishot_acceptor acceptor{listener};
+        for (std::size_t i = 0; i < connection_count; ++i) {
+            auto accept_result = co_await acceptor.accept();
+            if (!accept_result.has_value()) {
+                server_status = simplenet::err<void>(accept_result.error());
+                co_return;
+            }
+            ++accepted;
+            ever_armed = ever_armed || acceptor.multishot_active();
+        }
+    };
+    loop.spawn(server());
+
+    std::thread client_thread([port = port_result.value()]() {
+        std::vector<simplenet::blocking::tcp_stream> clients;
+        for (std::size_t i = 0; i < connection_count; ++i) {
+            auto client = simplenet::blocking::tcp_stream::connect(
+                simplenet::blocking::endpoint::loopback(port));
+            if (client.has_value()) {
+                clients.push_back(std::move(client.value()));
+            }
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    EXPECT_EQ(accepted, connection_count);
+    EXPECT_FALSE(ever_armed);
+}
+
+TEST(runtime_coroutines_test, multishot_receiver_falls_back_to_owned_buffers) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 4);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    std::vector<std::byte> outbound(32U * 1024U, std::byte{0x5a});
+    std::vector<std::byte> inbound;
+    bool ever_armed = false;
+    simplenet::result<void> server_status = simplenet::ok();
+
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+
+        auto peer = std::move(accept_result.value());
+        simplenet::runtime::multishot_receiver receiver{peer};
+        while (true) {
+            auto chunk = co_await receiver.receive();
+            if (!chunk.has_value()) {
+                server_status = simplenet::err<void>(chunk.error());
+                co_return;
+            }
+            ever_armed = ever_armed || receiver.multishot_active();
+            if (chunk.value().empty()) {
+                break;
+            }
+            const auto bytes = chunk.value().data();
+            inbound.insert(inbound.end(), bytes.begin(), bytes.end());
+        }
+    };
+    loop.spawn(server());
+
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (client.has_value()) {
+            (void)simplenet::blocking::write_all(
+                client.value(), std::span<const std::byte>{outbound});
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    EXPECT_FALSE(ever_armed);
+    EXPECT_EQ(inbound, outbound);
+}
+
+TEST(runtime_coroutines_test, poll_batch_grows_when_waits_fill_it) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    loop.set_poll_batch(2, 16);
+    EXPECT_EQ(loop.stats().poll_batch, 2U);
+
+    constexpr std::size_t kPipes = 40;
+    std::vector<simplenet::unique_fd> read_ends;
+    std::vector<simplenet::unique_fd> write_ends;
+    for (std::size_t i = 0; i < kPipes; ++i) {
+        std::array<int, 2> fds{};
+        ASSERT_EQ(::pipe2(fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+        read_ends.emplace_back(fds[0]);
+        write_ends.emplace_back(fds[1]);
+        ASSERT_EQ(::write(fds[1], "x", 1), 1);
+    }
+
+    std::size_t woken = 0;
+    auto waiter = [&](int fd) -> simplenet::runtime::task<void> {
+        if ((co_await simplenet::runtime::wait_readable(fd)).has_value()) {
+            ++woken;
+        }
+    };
+    for (const auto& read_end : read_ends) {
+        loop.spawn(waiter(read_end.get()));
+    }
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(woken, kPipes);
+
+    // 2 + 4 + 8 fill their batches and 16 is the cap.
+    const auto stats = loop.stats();
+    EXPECT_GE(stats.full_batches, 3U);
+    EXPECT_EQ(stats.poll_batch, 16U);
+}
+
+TEST(runtime_coroutines_test, steady_state_waits_make_no_epoll_ctl_calls) {
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()),
+              0);
+    ASSERT_EQ(::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK),
+              0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    simplenet::unique_fd peer{fds[1]};
+
+    std::thread echo([&]() {
+        std::byte byte{};
+        while (::read(peer.get(), &byte, 1) == 1) {
+            if (::write(peer.get(), &byte, 1) != 1) {
+                break;
+            }
+        }
+    });
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    constexpr int kRounds = 100;
+    int echoed = 0;
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        std::array<std::byte, 1> buffer{std::byte{0x42}};
+        for (int round = 0; round < kRounds; ++round) {
+            if (::write(stream.native_handle(), buffer.data(), 1) != 1) {
+                break;
+            }
+            const auto got =
+                co_await simplenet::runtime::async_read_some(stream, buffer);
+            if (!got.has_value() || got.value() != 1U) {
+                break;
+            }
+            ++echoed;
+        }
+    };
+    loop.spawn(client());
+
+    const auto run_result = loop.run();
+    EXPECT_TRUE(stream.shutdown_write().has_value());
+    echo.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(echoed, kRounds);
+    // One registration for the stream's lifetime, however many waits.
+    EXPECT_EQ(loop.stats().interest_updates, 1U);
+}
+
+TEST(runtime_coroutines_test, reused_descriptor_number_is_registered_again) {
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, fds.data()),
+              0);
+    const int first_number = fds[0];
+    auto first = std::make_unique<simplenet::nonblocking::tcp_stream>(
+        simplenet::unique_fd{fds[0]});
+    simplenet::unique_fd first_peer{fds[1]};
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    simplenet::result<std::size_t> timed_out = simplenet::ok(std::size_t{0});
+    simplenet::result<std::size_t> reused = simplenet::ok(std::size_t{0});
+    bool same_number = false;
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        std::array<std::byte, 4> buffer{};
+        timed_out = co_await simplenet::runtime::async_read_some_until(
+            *first, buffer, std::chrono::steady_clock::now() +
+                                std::chrono::milliseconds{10});
+        first.reset();
+        first_peer.reset();
+
+        std::array<int, 2> next{};
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0,
+                         next.data()) != 0) {
+            co_return;
+        }
+        same_number = next[0] == first_number;
+        simplenet::nonblocking::tcp_stream second{simplenet::unique_fd{next[0]}};
+        simplenet::unique_fd second_peer{next[1]};
+
+        auto writer = [&]() -> simplenet::runtime::task<void> {
+            (void)co_await simplenet::runtime::async_sleep(
+                std::chrono::milliseconds{10});
+            const std::byte byte{0x5A};
+            EXPECT_EQ(::write(second_peer.get(), &byte, 1), 1);
+        };
+        loop.spawn(writer());
+        reused = co_await simplenet::runtime::async_read_some_until(
+            second, buffer,
+            std::chrono::steady_clock::now() + std::chrono::seconds{2});
+    };
+    loop.spawn(work());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error().value(), ETIMEDOUT);
+    EXPECT_TRUE(same_number);
+    ASSERT_TRUE(reused.has_value()) << reused.error().message();
+    EXPECT_EQ(reused.value(), 1U);
+}
+
+TEST(runtime_coroutines_test, frameless_read_ignores_edges_it_already_drained) {
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, fds.data()),
+              0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    simplenet::unique_fd peer{fds[1]};
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    std::vector<simplenet::result<std::size_t>> reads;
+    auto reader = [&]() -> simplenet::runtime::task<void> {
+        std::array<std::byte, 8> buffer{};
+        reads.push_back(co_await simplenet::runtime::read_some_op(stream, buffer));
+        // The second byte's edge is seen while nobody is waiting.
+        (void)co_await simplenet::runtime::async_sleep(
+            std::chrono::milliseconds{30});
+        reads.push_back(co_await simplenet::runtime::read_some_op(stream, buffer));
+        // Drained: this one must park, not wake on the old edge.
+        reads.push_back(co_await simplenet::runtime::read_some_op(stream, buffer));
+    };
+    auto writer = [&]() -> simplenet::runtime::task<void> {
+        const std::byte byte{0x5A};
+        for (const auto pause : {5, 5, 60}) {
+            (void)co_await simplenet::runtime::async_sleep(
+                std::chrono::milliseconds{pause});
+            EXPECT_EQ(::write(peer.get(), &byte, 1), 1);
+        }
+    };
+    loop.spawn(reader());
+    loop.spawn(writer());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_EQ(reads.size(), 3U);
+    for (const auto& read : reads) {
+        ASSERT_TRUE(read.has_value()) << read.error().message();
+        EXPECT_EQ(read.value(), 1U);
+    }
+}
+
+TEST(runtime_coroutines_test, raw_descriptor_closed_behind_the_loop_is_waited_again) {
+    std::array<int, 2> first{};
+    ASSERT_EQ(::pipe2(first.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    const int first_number = first[0];
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    simplenet::result<void> timed_out = simplenet::ok();
+    simplenet::result<void> reused = simplenet::ok();
+    bool same_number = false;
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        timed_out = co_await simplenet::runtime::wait_readable_for(
+            first[0], std::chrono::milliseconds{10});
+        // Closed without unique_fd, so the loop's close listener never
+        // hears of it.
+        ::close(first[0]);
+        ::close(first[1]);
+
+        std::array<int, 2> next{};
+        if (::pipe2(next.data(), O_NONBLOCK | O_CLOEXEC) != 0) {
+            co_return;
+        }
+        const simplenet::unique_fd read_end{next[0]};
+        const simplenet::unique_fd write_end{next[1]};
+        same_number = next[0] == first_number;
+        const std::byte byte{0x5A};
+        EXPECT_EQ(::write(write_end.get(), &byte, 1), 1);
+        reused = co_await simplenet::runtime::wait_readable_until(
+            read_end.get(),
+            std::chrono::steady_clock::now() + std::chrono::seconds{2});
+    };
+    loop.spawn(work());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error().value(), ETIMEDOUT);
+    EXPECT_TRUE(same_number);
+    EXPECT_TRUE(reused.has_value()) << reused.error().message();
+}
+
+TEST(runtime_coroutines_test, waits_after_eagain_resume_once) {
+    if constexpr (!simplenet::runtime::metrics_enabled) {
+        GTEST_SKIP() << "built without SIMPLENET_ENABLE_METRICS";
+    }
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, fds.data()),
+              0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    simplenet::unique_fd peer{fds[1]};
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    std::uint64_t read_resumes = 0;
+    std::uint64_t write_resumes = 0;
+    simplenet::result<std::size_t> read = simplenet::ok(std::size_t{0});
+    simplenet::result<std::size_t> written = simplenet::ok(std::size_t{0});
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        std::array<std::byte, 64> buffer{};
+        (void)co_await simplenet::runtime::async_read_some_until(
+            stream, buffer,
+            std::chrono::steady_clock::now() + std::chrono::milliseconds{5});
+        // Reported readable and writable while nobody waits: both edges
+        // are cached, then spent here without the loop's knowledge.
+        const std::byte byte{0x5A};
+        EXPECT_EQ(::write(peer.get(), &byte, 1), 1);
+        (void)co_await simplenet::runtime::async_sleep(
+            std::chrono::milliseconds{10});
+        EXPECT_TRUE(stream.read_some(buffer).has_value());
+        while (stream.write_some(buffer).has_value()) {
+        }
+
+        // Each wait should park once and wake once, at its deadline.
+        const auto before_read = loop.metrics().resumes;
+        read = co_await simplenet::runtime::async_read_some_until(
+            stream, buffer,
+            std::chrono::steady_clock::now() + std::chrono::milliseconds{10});
+        read_resumes = loop.metrics().resumes - before_read;
+
+        const auto before_write = loop.metrics().resumes;
+        written = co_await simplenet::runtime::async_write_some_until(
+            stream, buffer,
+            std::chrono::steady_clock::now() + std::chrono::milliseconds{10});
+        write_resumes = loop.metrics().resumes - before_write;
+    };
+    loop.spawn(work());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(read.has_value());
+    EXPECT_EQ(read.error().value(), ETIMEDOUT);
+    ASSERT_FALSE(written.has_value());
+    EXPECT_EQ(written.error().value(), ETIMEDOUT);
+    EXPECT_EQ(read_resumes, 1U);
+    EXPECT_EQ(write_resumes, 1U);
+}
+
+TEST(runtime_coroutines_test, readable_wait_holds_no_buffer) {
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, fds.data()),
+              0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    simplenet::unique_fd peer{fds[1]};
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    std::vector<simplenet::result<void>> waits;
+    std::vector<std::size_t> reads;
+    auto reader = [&]() -> simplenet::runtime::task<void> {
+        // Parks until the byte arrives, then again until the peer closes.
+        for (int round = 0; round < 2; ++round) {
+            waits.push_back(co_await simplenet::runtime::readable_op(stream));
+            std::array<std::byte, 4> buffer{};
+            const auto got = stream.read_some(buffer);
+            reads.push_back(got.value_or(99U));
+        }
+        // End of stream stays readable, so this one completes at once.
+        waits.push_back(co_await simplenet::runtime::readable_op(stream));
+    };
+    auto writer = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{20});
+        const std::byte byte{0x5A};
+        EXPECT_EQ(::write(peer.get(), &byte, 1), 1);
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{20});
+        peer.reset();
+    };
+    loop.spawn(reader());
+    loop.spawn(writer());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_EQ(waits.size(), 3U);
+    for (const auto& wait : waits) {
+        EXPECT_TRUE(wait.has_value()) << wait.error().message();
+    }
+    EXPECT_EQ(reads, (std::vector<std::size_t>{1U, 0U}));
+}
+
+TEST(runtime_coroutines_test, finished_roots_are_freed_while_others_stay_parked) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    constexpr int kParked = 2000;
+    constexpr int kQuick = 500;
+    struct frame_probe {
+        int& destroyed;
+        ~frame_probe() {
+            ++destroyed;
+        }
+    };
+    int quick_destroyed = 0;
+    int destroyed_at_check = -1;
+    int parked_finished = 0;
+    auto parked = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{40});
+        ++parked_finished;
+    };
+    auto quick = [&]() -> simplenet::runtime::task<void> {
+        frame_probe probe{quick_destroyed};
+        co_return;
+    };
+    auto checker = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{10});
+        destroyed_at_check = quick_destroyed;
+    };
+    for (int index = 0; index < kParked; ++index) {
+        loop.spawn(parked());
+        if (index % (kParked / kQuick) == 0) {
+            loop.spawn(quick());
+        }
+    }
+    loop.spawn(checker());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    // Each quick root was reclaimed right after its resume, not when the
+    // parked ones finished.
+    EXPECT_EQ(destroyed_at_check, kQuick);
+    EXPECT_EQ(parked_finished, kParked);
+}
+
+TEST(runtime_coroutines_test, detached_roots_free_their_frames_at_final_suspend) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    struct frame_probe {
+        int& destroyed;
+        ~frame_probe() {
+            ++destroyed;
+        }
+    };
+    int destroyed = 0;
+    int destroyed_at_check = -1;
+    auto handler = [&](int delay_ms) -> simplenet::runtime::task<int> {
+        frame_probe probe{destroyed};
+        (void)co_await simplenet::runtime::async_sleep(
+            std::chrono::milliseconds{delay_ms});
+        co_return delay_ms;
+    };
+    auto failing = [&]() -> simplenet::runtime::task<void> {
+        frame_probe probe{destroyed};
+        throw std::runtime_error("dropped with the frame");
+        co_return;
+    };
+    auto checker = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{20});
+        destroyed_at_check = destroyed;
+    };
+    loop.spawn_detached(handler(5));
+    loop.spawn_detached(failing());
+    loop.spawn_detached(handler(40));
+    loop.spawn(checker());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(destroyed_at_check, 2);
+    // `run()` waited for the last detached root.
+    EXPECT_EQ(destroyed, 3);
+
+    // One still parked when the loop goes away is destroyed with it.
+    {
+        simplenet::runtime::event_loop inner;
+        ASSERT_TRUE(inner.valid());
+        auto stopper = [&]() -> simplenet::runtime::task<void> {
+            (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{5});
+            inner.stop();
+        };
+        inner.spawn_detached(handler(10000));
+        inner.spawn(stopper());
+        (void)inner.run();
+        EXPECT_EQ(destroyed, 3);
+    }
+    EXPECT_EQ(destroyed, 4);
+}
+
 } // namespace
@@ -0,0 +1,350 @@
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/nonblocking/udp.hpp"
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/dns.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <span>
+#include <string>
+#include <sys/socket.h>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using simplenet::nonblocking::socket_address;
+using simplenet::nonblocking::tcp_listener;
+using simplenet::nonblocking::udp_socket;
+using address_result = simplenet::result<std::vector<socket_address>>;
+
+constexpr std::uint16_t kTypeA = 1;
+constexpr std::uint16_t kTypeAaaa = 28;
+
+// How the fake server treats each query.
+struct server_behaviour {
+    std::uint16_t rcode{0};
+    bool truncate{false};
+    // Extra A record appended to TCP answers to tell them apart.
+    bool tcp_marker{false};
+};
+
+void append_u16(std::vector<std::byte>& out, std::uint16_t value) {
+    out.push_back(static_cast<std::byte>(value >> 8U));
+    out.push_back(static_cast<std::byte>(value & 0xFFU));
+}
+
+std::uint16_t query_type(std::span<const std::byte> query) {
+    const std::size_t at = query.size() - 4;
+    return static_cast<std::uint16_t>(
+        (std::to_integer<unsigned>(query[at]) << 8U) |
+        std::to_integer<unsigned>(query[at + 1]));
+}
+
+void append_record(std::vector<std::byte>& out, std::uint16_t type,
+                   std::span<const std::uint8_t> rdata) {
+    append_u16(out, 0xC00C); // Pointer to the question name.
+    append_u16(out, type);
+    append_u16(out, 1);
+    append_u16(out, 0);
+    append_u16(out, 60);
+    append_u16(out, static_cast<std::uint16_t>(rdata.size()));
+    for (const auto octet : rdata) {
+        out.push_back(static_cast<std::byte>(octet));
+    }
+}
+
+// Echo id and question; answer A with 192.0.2.10 and AAAA with 2001:db8::10.
+std::vector<std::byte> make_reply(std::span<const std::byte> query,
+                                  const server_behaviour& behaviour,
+                                  bool over_tcp) {
+    std::vector<std::byte> reply(query.begin(), query.end());
+    const bool answers = behaviour.rcode == 0 && !(behaviour.truncate && !over_tcp);
+    const std::uint16_t type = query_type(query);
+    std::uint16_t count = answers ? 1 : 0;
+    if (answers && over_tcp && behaviour.tcp_marker && type == kTypeA) {
+        count = 2;
+    }
+
+    std::uint16_t flags = static_cast<std::uint16_t>(0x8180U | behaviour.rcode);
+    if (behaviour.truncate && !over_tcp) {
+        flags |= 0x0200U;
+    }
+    reply[2] = static_cast<std::byte>(flags >> 8U);
+    reply[3] = static_cast<std::byte>(flags & 0xFFU);
+    reply[6] = std::byte{0};
+    reply[7] = static_cast<std::byte>(count);
+
+    if (answers && type == kTypeA) {
+        append_record(reply, kTypeA, std::array<std::uint8_t, 4>{192, 0, 2, 10});
+        if (count == 2) {
+            append_record(reply, kTypeA,
+                          std::array<std::uint8_t, 4>{192, 0, 2, 99});
+        }
+    } else if (answers && type == kTypeAaaa) {
+        std::array<std::uint8_t, 16> v6{0x20, 0x01, 0x0d, 0xb8};
+        v6[15] = 0x10;
+        append_record(reply, kTypeAaaa, v6);
+    }
+    return reply;
+}
+
+// Answers `expected` UDP queries, then returns.
+simplenet::runtime::task<void> serve_udp(udp_socket& socket, int expected,
+                                         server_behaviour behaviour) {
+    std::array<std::byte, 512> buffer{};
+    for (int handled = 0; handled < expected; ++handled) {
+        const auto datagram =
+            co_await simplenet::runtime::async_recv_from(socket, buffer);
+        if (!datagram.has_value()) {
+            ADD_FAILURE() << datagram.error().message();
+            co_return;
+        }
+        const auto reply = make_reply(
+            std::span{buffer}.first(datagram.value().size), behaviour, false);
+        const auto sent = co_await simplenet::runtime::async_send_to(
+            socket, reply, datagram.value().from);
+        EXPECT_TRUE(sent.has_value());
+    }
+}
+
+// Answers one length-prefixed TCP query.
+simplenet::runtime::task<void> serve_tcp(tcp_listener& listener,
+                                         server_behaviour behaviour) {
+    auto stream = co_await simplenet::runtime::async_accept(listener);
+    if (!stream.has_value()) {
+        ADD_FAILURE() << stream.error().message();
+        co_return;
+    }
+    std::array<std::byte, 2> prefix{};
+    auto status =
+        co_await simplenet::runtime::async_read_exact(stream.value(), prefix);
+    if (!status.has_value()) {
+        ADD_FAILURE() << status.error().message();
+        co_return;
+    }
+    std::vector<std::byte> query(
+        (std::to_integer<std::size_t>(prefix[0]) << 8U) |
+        std::to_integer<std::size_t>(prefix[1]));
+    status = co_await simplenet::runtime::async_read_exact(stream.value(), query);
+    if (!status.has_value()) {
+        ADD_FAILURE() << status.error().message();
+        co_return;
+    }
+
+    const auto reply = make_reply(query, behaviour, true);
+    std::vector<std::byte> frame;
+    append_u16(frame, static_cast<std::uint16_t>(reply.size()));
+    frame.insert(frame.end(), reply.begin(), reply.end());
+    status = co_await simplenet::runtime::async_write_all(stream.value(), frame);
+    EXPECT_TRUE(status.has_value());
+}
+
+udp_socket bind_server() {
+    auto bound = udp_socket::bind(socket_address::loopback(0));
+    EXPECT_TRUE(bound.has_value()) << bound.error().message();
+    return bound.has_value() ? std::move(bound.value()) : udp_socket{};
+}
+
+simplenet::runtime::dns_options options_for(const udp_socket& server) {
+    simplenet::runtime::dns_options options{};
+    options.nameservers.push_back(server.local_address().value());
+    options.timeout = 2s;
+    options.attempts = 1;
+    return options;
+}
+
+bool contains(const std::vector<socket_address>& addresses,
+              const std::string& host, std::uint16_t port) {
+    const auto wanted = socket_address::from_endpoint({.host = host, .port = port});
+    for (const auto& address : addresses) {
+        if (wanted.has_value() && address == wanted.value()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class Loop>
+address_result resolve_with(Loop& loop, udp_socket& server, int family,
+                            int expected, server_behaviour behaviour) {
+    address_result outcome = simplenet::err<std::vector<socket_address>>(
+        simplenet::make_error_from_errno(EINVAL));
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        outcome = co_await simplenet::runtime::async_dns_resolve(
+            "service.example", "8080", family, options_for(server));
+    };
+    loop.spawn(serve_udp(server, expected, behaviour));
+    loop.spawn(client());
+    const auto run_result = loop.run();
+    EXPECT_TRUE(run_result.has_value()) << run_result.error().message();
+    return outcome;
+}
+
+} // namespace
+
+TEST(runtime_dns_test, load_resolv_conf_reads_servers_and_options) {
+    const std::string path = ::testing::TempDir() + "simplenet_resolv.conf";
+    {
+        std::ofstream file(path);
+        file << "# local resolvers\n"
+             << "nameserver 192.0.2.53\n"
+             << "nameserver 2001:db8::53 ; second\n"
+             << "nameserver fe80::1%eth0\n"
+             << "search example.com\n"
+             << "options ndots:2 timeout:3 attempts:9\n"
+             << "nameserver 192.0.2.54\n"
+             << "nameserver 192.0.2.55\n";
+    }
+
+    const auto loaded = simplenet::runtime::load_resolv_conf(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(loaded.has_value()) << loaded.error().message();
+    const auto& servers = loaded.value().nameservers;
+    ASSERT_EQ(servers.size(), simplenet::runtime::dns_max_nameservers);
+    EXPECT_TRUE(contains(servers, "192.0.2.53", 53));
+    EXPECT_TRUE(contains(servers, "2001:db8::53", 53));
+    EXPECT_TRUE(contains(servers, "192.0.2.54", 53));
+    EXPECT_EQ(loaded.value().timeout, 3s);
+    EXPECT_EQ(loaded.value().attempts, 5);
+
+    EXPECT_FALSE(
+        simplenet::runtime::load_resolv_conf(path + ".missing").has_value());
+}
+
+TEST(runtime_dns_test, resolves_a_and_aaaa_in_parallel) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto server = bind_server();
+
+    const auto outcome = resolve_with(loop, server, AF_UNSPEC, 2, {});
+    ASSERT_TRUE(outcome.has_value()) << outcome.error().message();
+    ASSERT_EQ(outcome.value().size(), 2U);
+    EXPECT_EQ(outcome.value().front().family(), AF_INET6);
+    EXPECT_TRUE(contains(outcome.value(), "2001:db8::10", 8080));
+    EXPECT_TRUE(contains(outcome.value(), "192.0.2.10", 8080));
+}
+
+TEST(runtime_dns_test, resolves_on_the_uring_backend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    auto server = bind_server();
+
+    const auto outcome = resolve_with(loop, server, AF_INET, 1, {});
+    ASSERT_TRUE(outcome.has_value()) << outcome.error().message();
+    ASSERT_EQ(outcome.value().size(), 1U);
+    EXPECT_TRUE(contains(outcome.value(), "192.0.2.10", 8080));
+}
+
+TEST(runtime_dns_test, unknown_name_reports_enoent) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto server = bind_server();
+
+    const auto outcome = resolve_with(loop, server, AF_UNSPEC, 2, {.rcode = 3});
+    ASSERT_FALSE(outcome.has_value());
+    EXPECT_EQ(outcome.error().value(), ENOENT);
+}
+
+TEST(runtime_dns_test, truncated_answer_retries_over_tcp) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto server = bind_server();
+    auto listener = tcp_listener::bind(server.local_address().value());
+    ASSERT_TRUE(listener.has_value()) << listener.error().message();
+
+    const server_behaviour behaviour{.truncate = true, .tcp_marker = true};
+    loop.spawn(serve_tcp(listener.value(), behaviour));
+    const auto outcome = resolve_with(loop, server, AF_INET, 1, behaviour);
+    ASSERT_TRUE(outcome.has_value()) << outcome.error().message();
+    EXPECT_EQ(outcome.value().size(), 2U);
+    EXPECT_TRUE(contains(outcome.value(), "192.0.2.99", 8080));
+}
+
+TEST(runtime_dns_test, silent_server_times_out) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto server = bind_server();
+
+    auto options = options_for(server);
+    options.timeout = 30ms;
+    options.attempts = 2;
+    address_result outcome = simplenet::ok(std::vector<socket_address>{});
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        outcome = co_await simplenet::runtime::async_dns_resolve(
+            "service.example", "80", AF_UNSPEC, options);
+    };
+    loop.spawn(client());
+    ASSERT_TRUE(loop.run().has_value());
+    ASSERT_FALSE(outcome.has_value());
+    EXPECT_EQ(outcome.error().value(), ETIMEDOUT);
+}
+
+TEST(runtime_dns_test, stop_request_ends_a_pending_lookup_at_once) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto server = bind_server();
+
+    simplenet::runtime::cancel_source source;
+    address_result outcome = simplenet::ok(std::vector<socket_address>{});
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        outcome = co_await simplenet::runtime::async_dns_resolve(
+            "service.example", "80", AF_UNSPEC, options_for(server),
+            source.token());
+    };
+    auto stopper = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(20ms);
+        source.request_stop();
+    };
+    loop.spawn(client());
+    loop.spawn(stopper());
+
+    const auto started = std::chrono::steady_clock::now();
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 1s);
+    ASSERT_FALSE(outcome.has_value());
+    EXPECT_EQ(outcome.error().value(), ECANCELED);
+}
+
+TEST(runtime_dns_test, literals_and_bad_input_skip_the_network) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    address_result literal = simplenet::ok(std::vector<socket_address>{});
+    address_result wrong_family = literal;
+    address_result bad_name = literal;
+    address_result bad_port = literal;
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        literal = co_await simplenet::runtime::async_dns_resolve("::1", "443");
+        wrong_family = co_await simplenet::runtime::async_dns_resolve(
+            "::1", "443", AF_INET);
+        bad_name = co_await simplenet::runtime::async_dns_resolve("a..b", "80");
+        bad_port =
+            co_await simplenet::runtime::async_dns_resolve("example", "http");
+    };
+    loop.spawn(client());
+    ASSERT_TRUE(loop.run().has_value());
+
+    ASSERT_TRUE(literal.has_value());
+    ASSERT_EQ(literal.value().size(), 1U);
+    EXPECT_EQ(literal.value().front(), socket_address::ipv6_loopback(443));
+    ASSERT_FALSE(wrong_family.has_value());
+    EXPECT_EQ(wrong_family.error().value(), ENOENT);
+    ASSERT_FALSE(bad_name.has_value());
+    EXPECT_EQ(bad_name.error().value(), EINVAL);
+    ASSERT_FALSE(bad_port.has_value());
+    EXPECT_EQ(bad_port.error().value(), EINVAL);
+}
@@ -1,25 +1,283 @@
+#include "simplenet/io_context.hpp"
 #include "simplenet/runtime/engine.hpp"
+#include "simplenet/runtime/io_backend.hpp"
 #include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/loop_pool.hpp"
+#include "simplenet/uring/probe.hpp"
 
 #include <array>
 #include <atomic>
 #include <cerrno>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <fcntl.h>
 #include <future>
 #include <gtest/gtest.h>
+#include <span>
+#include <sys/socket.h>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 namespace {
 
+static_assert(simplenet::runtime::io_backend<simplenet::runtime::event_loop>);
+static_assert(simplenet::runtime::io_backend<simplenet::runtime::uring_event_loop>);
+static_assert(!simplenet::runtime::io_backend<simplenet::runtime::engine>);
+static_assert(
+    simplenet::runtime::completion_backend<simplenet::runtime::uring_event_loop>);
+static_assert(
+    !simplenet::runtime::completion_backend<simplenet::runtime::event_loop>);
+
+template <class Context>
+simplenet::runtime::task<void> wait_on_context(Context& context, int fd,
+                                               simplenet::result<void>& out) {
+    out = co_await context.readable(fd);
+}
+
+template <class Context> void expect_static_context_waits(Context& context) {
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    const simplenet::unique_fd read_end{pipe_fds[0]};
+    const simplenet::unique_fd write_end{pipe_fds[1]};
+    constexpr std::array<std::byte, 1> marker{std::byte{0x42}};
+    ASSERT_EQ(::write(write_end.get(), marker.data(), marker.size()), 1);
+
+    simplenet::result<void> readable{
+        simplenet::err<void>(simplenet::make_error_from_errno(EINPROGRESS))};
+    context.spawn(wait_on_context(context, read_end.get(), readable));
+
+    const auto run_result = context.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(readable.has_value()) << readable.error().message();
+}
+
+constexpr std::size_t echo_payload_size = 64U * 1024U;
+
+template <class Context>
+simplenet::runtime::task<void>
+echo_on_context(Context& context,
+                simplenet::nonblocking::tcp_listener& listener) {
+    auto accepted = co_await context.async_accept(listener);
+    if (!accepted.has_value()) {
+        ADD_FAILURE() << accepted.error().message();
+        co_return;
+    }
+    auto peer = std::move(accepted.value());
+    std::array<std::byte, 4096> chunk{};
+    std::size_t echoed = 0;
+    while (echoed < echo_payload_size) {
+        const auto received = co_await context.async_read_some(peer, chunk);
+        if (!received.has_value() || received.value() == 0U) {
+            ADD_FAILURE() << "server read ended after " << echoed << " bytes";
+            co_return;
+        }
+        std::span<const std::byte> pending{chunk.data(), received.value()};
+        while (!pending.empty()) {
+            const auto sent = co_await context.async_write_some(peer, pending);
+            if (!sent.has_value()) {
+                ADD_FAILURE() << sent.error().message();
+                co_return;
+            }
+            pending = pending.subspan(sent.value());
+        }
+        echoed += received.value();
+    }
+}
+
+template <class Context>
+simplenet::runtime::task<void>
+send_on_context(Context& context, std::uint16_t port,
+                std::vector<std::byte>& inbound) {
+    auto connected = co_await simplenet::runtime::async_connect(
+        simplenet::nonblocking::endpoint::loopback(port));
+    if (!connected.has_value()) {
+        ADD_FAILURE() << connected.error().message();
+        co_return;
+    }
+    auto stream = std::move(connected.value());
+    std::vector<std::byte> outbound(echo_payload_size);
+    for (std::size_t i = 0; i < outbound.size(); ++i) {
+        outbound[i] = static_cast<std::byte>((i * 13U) % 251U);
+    }
+
+    std::span<const std::byte> pending{outbound};
+    while (!pending.empty()) {
+        const auto sent = co_await context.async_write_some(stream, pending);
+        if (!sent.has_value()) {
+            ADD_FAILURE() << sent.error().message();
+            co_return;
+        }
+        pending = pending.subspan(sent.value());
+    }
+
+    inbound.resize(echo_payload_size);
+    std::size_t total = 0;
+    while (total < inbound.size()) {
+        const auto received = co_await context.async_read_some(
+            stream, std::span<std::byte>{inbound}.subspan(total));
+        if (!received.has_value() || received.value() == 0U) {
+            ADD_FAILURE() << "client read ended after " << total << " bytes";
+            co_return;
+        }
+        total += received.value();
+    }
+    EXPECT_EQ(inbound, outbound);
+}
+
+template <class Context> void expect_static_context_echo(Context& context) {
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 8);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+    const auto port = listener.local_port();
+    ASSERT_TRUE(port.has_value()) << port.error().message();
+
+    std::vector<std::byte> inbound;
+    context.spawn(echo_on_context(context, listener));
+    context.spawn(send_on_context(context, port.value(), inbound));
+
+    const auto run_result = context.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(inbound.size(), echo_payload_size);
+}
+
+TEST(runtime_engine_test, epoll_io_context_waits_without_engine) {
+    simplenet::epoll_io_context context;
+    ASSERT_TRUE(context.valid());
+    static_assert(!simplenet::epoll_io_context::completion_io);
+    expect_static_context_waits(context);
+}
+
+TEST(runtime_engine_test, uring_io_context_waits_without_engine) {
+    simplenet::uring_io_context context{
+        simplenet::runtime::uring_options{.queue_depth = 64}};
+    if (!context.valid()) {
+        GTEST_SKIP() << "io_uring backend unavailable";
+    }
+    static_assert(simplenet::uring_io_context::completion_io);
+    context.loop().set_poll_batch(32);
+    expect_static_context_waits(context);
+}
+
+TEST(runtime_engine_test, epoll_io_context_echoes_through_static_calls) {
+    simplenet::epoll_io_context context;
+    ASSERT_TRUE(context.valid());
+    expect_static_context_echo(context);
+}
+
+TEST(runtime_engine_test, uring_io_context_echoes_through_static_calls) {
+    simplenet::uring_io_context context{
+        simplenet::runtime::uring_options{.queue_depth = 64}};
+    if (!context.valid()) {
+        GTEST_SKIP() << "io_uring backend unavailable";
+    }
+    expect_static_context_echo(context);
+}
+
+TEST(runtime_engine_test, static_context_read_rejects_foreign_loop) {
+    simplenet::epoll_io_context context;
+    simplenet::runtime::event_loop other;
+    ASSERT_TRUE(context.valid());
+    ASSERT_TRUE(other.valid());
+
+    std::array<int, 2> socket_fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, socket_fds.data()),
+              0);
+    const simplenet::unique_fd peer_end{socket_fds[1]};
+    simplenet::nonblocking::tcp_stream stream{
+        simplenet::unique_fd{socket_fds[0]}};
+
+    simplenet::result<std::size_t> received{std::size_t{0}};
+    auto read_coroutine = [&]() -> simplenet::runtime::task<void> {
+        std::array<std::byte, 1> buffer{};
+        received = co_await context.async_read_some(stream, buffer);
+    };
+    other.spawn(read_coroutine());
+    const auto run_result = other.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(received.has_value());
+    EXPECT_EQ(received.error().value(), EINVAL);
+}
+
+TEST(runtime_engine_test, static_context_wait_rejects_foreign_loop) {
+    simplenet::epoll_io_context context;
+    simplenet::runtime::event_loop other;
+    ASSERT_TRUE(context.valid());
+    ASSERT_TRUE(other.valid());
+
+    simplenet::result<void> readable{simplenet::ok()};
+    other.spawn(wait_on_context(context, STDIN_FILENO, readable));
+    const auto run_result = other.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(readable.has_value());
+    EXPECT_EQ(readable.error().value(), EINVAL);
+}
+
 TEST(runtime_engine_test, default_backend_is_epoll) {
     simplenet::runtime::engine runtime;
     EXPECT_EQ(runtime.selected_backend(), simplenet::runtime::engine::backend::epoll);
     EXPECT_TRUE(runtime.valid());
 }
 
+TEST(runtime_engine_test, automatic_backend_follows_probe) {
+    using backend = simplenet::runtime::engine::backend;
+    EXPECT_EQ(simplenet::runtime::engine::resolve(backend::epoll), backend::epoll);
+    EXPECT_EQ(simplenet::runtime::engine::resolve(backend::io_uring),
+              backend::io_uring);
+    const auto expected = simplenet::uring::cached_support().runtime_ready()
+                              ? backend::io_uring
+                              : backend::epoll;
+    EXPECT_EQ(simplenet::runtime::engine::resolve(backend::automatic), expected);
+
+    simplenet::runtime::engine runtime{backend::automatic, 64};
+    EXPECT_TRUE(runtime.valid());
+    EXPECT_NE(runtime.selected_backend(), backend::automatic);
+    // Only a failing second ring setup can move it off the probe's choice.
+    if (runtime.selected_backend() == backend::io_uring) {
+        EXPECT_EQ(expected, backend::io_uring);
+    }
+
+    bool ran = false;
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        const auto slept =
+            co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{1});
+        if (!slept.has_value()) {
+            ADD_FAILURE() << slept.error().message();
+        }
+        ran = true;
+    };
+    runtime.spawn(work());
+    const auto run_result = runtime.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(ran);
+}
+
+TEST(runtime_engine_test, automatic_pool_reports_one_backend) {
+    using backend = simplenet::runtime::engine::backend;
+    simplenet::runtime::loop_pool pool{simplenet::runtime::loop_pool_options{
+        .selected_backend = backend::automatic, .threads = 2, .pin_threads = false}};
+    EXPECT_EQ(pool.selected_backend(),
+              simplenet::runtime::engine::resolve(backend::automatic));
+    for (std::size_t index = 0; index < pool.size(); ++index) {
+        EXPECT_EQ(pool.loop(index).selected_backend(), pool.selected_backend());
+    }
+}
+
+TEST(runtime_engine_test, epoll_backend_has_no_registered_files) {
+    simplenet::runtime::engine runtime;
+    auto *active = runtime.active_scheduler();
+    ASSERT_NE(active, nullptr);
+
+    const auto registered = active->register_file(STDIN_FILENO);
+    ASSERT_FALSE(registered.has_value());
+    EXPECT_EQ(registered.error().value(), EOPNOTSUPP);
+    EXPECT_TRUE(active->unregister_file(STDIN_FILENO).has_value());
+}
+
 TEST(runtime_engine_test, epoll_backend_runs_simple_task) {
     simplenet::runtime::engine runtime{simplenet::runtime::engine::backend::epoll};
     ASSERT_TRUE(runtime.valid());
@@ -99,6 +357,29 @@ TEST(runtime_engine_test, uring_backend_runs_readiness_task_when_available) {
         << completion_result.error().message();
 }
 
+TEST(runtime_engine_test, uring_backend_runs_with_defer_taskrun_when_available) {
+    simplenet::runtime::engine runtime{
+        simplenet::runtime::engine::backend::io_uring,
+        simplenet::runtime::uring_options{.queue_depth = 64,
+                                          .defer_taskrun = true,
+                                          .coop_taskrun = true}};
+    if (!runtime.valid()) {
+        GTEST_SKIP() << "io_uring backend unavailable";
+    }
+
+    bool slept = false;
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        const auto sleep_result =
+            co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{2});
+        slept = sleep_result.has_value();
+    };
+    runtime.spawn(work());
+
+    const auto run_result = runtime.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(slept);
+}
+
 TEST(runtime_engine_test, epoll_backend_stop_from_external_thread_is_responsive) {
     using namespace std::chrono_literals;
 
@@ -0,0 +1,441 @@
+#include "simplenet/runtime/framed_reader.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using simplenet::nonblocking::socket_address;
+using simplenet::nonblocking::tcp_listener;
+using simplenet::runtime::delimiter_decoder;
+using simplenet::runtime::frame_extent;
+using simplenet::runtime::framed_reader;
+using simplenet::runtime::framed_reader_options;
+using simplenet::runtime::length_prefix_decoder;
+using simplenet::runtime::varint_prefix_decoder;
+
+std::vector<std::byte> bytes_of(std::string_view text) {
+    const auto *first = reinterpret_cast<const std::byte *>(text.data());
+    return {first, first + text.size()};
+}
+
+std::string text_of(std::span<const std::byte> bytes) {
+    return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+// Big-endian 32-bit length prefix followed by `payload`.
+void append_frame(std::vector<std::byte>& wire, std::string_view payload) {
+    const auto length = static_cast<std::uint32_t>(payload.size());
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        wire.push_back(static_cast<std::byte>((length >> shift) & 0xFFU));
+    }
+    const auto body = bytes_of(payload);
+    wire.insert(wire.end(), body.begin(), body.end());
+}
+
+/// What the server side saw: frame payloads, the final status and reads.
+struct session {
+    std::vector<std::string> frames{};
+    simplenet::result<void> status = simplenet::ok();
+    bool clean_eof{false};
+    std::uint64_t reads{0};
+    std::size_t capacity{0};
+};
+
+/**
+ * Send `chunks` from a client, each with its own write, then close; the
+ * server collects frames with `decoder` until end of stream or an error.
+ */
+template <class Loop, class Decoder>
+session exchange(Loop& loop, Decoder decoder,
+                 const std::vector<std::vector<std::byte>>& chunks,
+                 framed_reader_options options = {}) {
+    auto bound = tcp_listener::bind(socket_address::loopback(0));
+    EXPECT_TRUE(bound.has_value());
+    auto listener = std::move(bound.value());
+    const auto address = listener.local_address().value();
+
+    session seen;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_accept(listener);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        framed_reader reader{stream.value(), options};
+        while (true) {
+            auto next = co_await reader.next(decoder);
+            if (!next.has_value()) {
+                seen.status = simplenet::err<void>(next.error());
+                break;
+            }
+            if (!next.value().has_value()) {
+                seen.clean_eof = true;
+                break;
+            }
+            seen.frames.push_back(text_of(next.value()->payload));
+        }
+        seen.reads = reader.reads();
+        seen.capacity = reader.capacity();
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        for (const auto& chunk : chunks) {
+            const auto written =
+                co_await simplenet::runtime::async_write_all(stream.value(), chunk);
+            EXPECT_TRUE(written.has_value());
+            (void)co_await simplenet::runtime::async_sleep(
+                std::chrono::milliseconds{2});
+        }
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+    EXPECT_TRUE(loop.run().has_value());
+    return seen;
+}
+
+template <class Loop> void pipelined_frames_share_one_read(Loop& loop) {
+    std::vector<std::byte> wire;
+    append_frame(wire, "alpha");
+    append_frame(wire, "");
+    append_frame(wire, "gamma");
+
+    const auto seen = exchange(loop, length_prefix_decoder{}, {wire});
+    EXPECT_TRUE(seen.status.has_value());
+    EXPECT_TRUE(seen.clean_eof);
+    EXPECT_EQ(seen.frames, (std::vector<std::string>{"alpha", "", "gamma"}));
+    // One read for all three frames, one more to see end of stream.
+    EXPECT_EQ(seen.reads, 2U);
+}
+
+/**
+ * Two frames a pause apart into a reader that frees its buffer when idle;
+ * `capacity()` is sampled while it waits between them.
+ */
+template <class Loop> void idle_reader_holds_no_buffer(Loop& loop) {
+    auto bound = tcp_listener::bind(socket_address::loopback(0));
+    ASSERT_TRUE(bound.has_value());
+    auto listener = std::move(bound.value());
+    const auto address = listener.local_address().value();
+
+    std::vector<std::string> frames;
+    std::size_t busy_capacity = 0;
+    std::size_t idle_capacity = 1;
+    framed_reader *active = nullptr;
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accepted = co_await simplenet::runtime::async_accept(listener);
+        if (!accepted.has_value()) {
+            ADD_FAILURE() << accepted.error().message();
+            co_return;
+        }
+        framed_reader reader{accepted.value(),
+                             framed_reader_options{.release_when_idle = true}};
+        active = &reader;
+        EXPECT_EQ(reader.capacity(), 0U);
+        length_prefix_decoder decoder{};
+        while (true) {
+            auto next = co_await reader.next(decoder);
+            if (!next.has_value() || !next.value().has_value()) {
+                break;
+            }
+            busy_capacity = reader.capacity();
+            frames.push_back(text_of(next.value()->payload));
+        }
+        active = nullptr;
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        for (const std::string_view payload : {"first", "second"}) {
+            std::vector<std::byte> wire;
+            append_frame(wire, payload);
+            const auto written =
+                co_await simplenet::runtime::async_write_all(stream.value(), wire);
+            EXPECT_TRUE(written.has_value());
+            (void)co_await simplenet::runtime::async_sleep(
+                std::chrono::milliseconds{40});
+            if (active != nullptr && payload == "first") {
+                idle_capacity = active->capacity();
+            }
+        }
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(frames, (std::vector<std::string>{"first", "second"}));
+    EXPECT_EQ(busy_capacity, framed_reader_options{}.initial_capacity);
+    EXPECT_EQ(idle_capacity, 0U);
+}
+
+} // namespace
+
+TEST(runtime_framed_reader_test, length_prefix_decoder_reads_each_width) {
+    const std::vector<std::byte> little{std::byte{3}, std::byte{0}, std::byte{'a'},
+                                        std::byte{'b'}, std::byte{'c'}};
+    const auto le = length_prefix_decoder{.header_size = 2, .big_endian = false}
+                        .decode(little);
+    ASSERT_TRUE(le.has_value() && le.value().has_value());
+    EXPECT_EQ(le.value()->header, 2U);
+    EXPECT_EQ(le.value()->payload, 3U);
+
+    const auto be = length_prefix_decoder{.header_size = 2}.decode(little);
+    ASSERT_TRUE(be.has_value());
+    EXPECT_FALSE(be.value().has_value()); // 0x0300 bytes announced.
+
+    const auto large =
+        length_prefix_decoder{.header_size = 2, .max_payload = 16}.decode(little);
+    ASSERT_FALSE(large.has_value());
+    EXPECT_EQ(large.error().value(), EMSGSIZE);
+
+    const auto odd = length_prefix_decoder{.header_size = 3}.decode(little);
+    ASSERT_FALSE(odd.has_value());
+    EXPECT_EQ(odd.error().value(), EINVAL);
+}
+
+TEST(runtime_framed_reader_test, varint_prefix_decoder_handles_multibyte_lengths) {
+    std::vector<std::byte> wire{std::byte{0xAC}, std::byte{0x02}}; // 300
+    wire.resize(2U + 300U, std::byte{'x'});
+    const auto whole = varint_prefix_decoder{}.decode(wire);
+    ASSERT_TRUE(whole.has_value() && whole.value().has_value());
+    EXPECT_EQ(whole.value()->header, 2U);
+    EXPECT_EQ(whole.value()->payload, 300U);
+
+    const auto partial =
+        varint_prefix_decoder{}.decode(std::span{wire}.first(1));
+    ASSERT_TRUE(partial.has_value());
+    EXPECT_FALSE(partial.value().has_value());
+
+    const std::vector<std::byte> endless(11, std::byte{0xFF});
+    const auto runaway = varint_prefix_decoder{}.decode(endless);
+    ASSERT_FALSE(runaway.has_value());
+    EXPECT_EQ(runaway.error().value(), EBADMSG);
+}
+
+TEST(runtime_framed_reader_test, delimiter_decoder_finds_a_split_delimiter) {
+    const auto crlf = bytes_of("\r\n");
+    delimiter_decoder decoder{.delimiter = crlf};
+    const auto wire = bytes_of("hello\r\n");
+
+    const auto first = decoder.decode(std::span{wire}.first(6));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_FALSE(first.value().has_value());
+    EXPECT_EQ(decoder.searched, 6U);
+
+    const auto second = decoder.decode(wire);
+    ASSERT_TRUE(second.has_value() && second.value().has_value());
+    EXPECT_EQ(second.value()->payload, 5U);
+    EXPECT_EQ(second.value()->trailer, 2U);
+    EXPECT_EQ(decoder.searched, 0U);
+
+    delimiter_decoder bounded{.delimiter = crlf, .max_payload = 4};
+    const auto overlong = bounded.decode(std::span{wire}.first(6));
+    ASSERT_FALSE(overlong.has_value());
+    EXPECT_EQ(overlong.error().value(), EMSGSIZE);
+}
+
+TEST(runtime_framed_reader_test, pipelined_frames_share_one_read) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    pipelined_frames_share_one_read(loop);
+}
+
+TEST(runtime_framed_reader_test, pipelined_frames_on_the_uring_backend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    pipelined_frames_share_one_read(loop);
+}
+
+TEST(runtime_framed_reader_test, split_frame_grows_and_compacts_the_buffer) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    const std::string large(200, 'L');
+    std::vector<std::byte> wire;
+    append_frame(wire, "head");
+    append_frame(wire, large);
+    append_frame(wire, "tail");
+    // Cut inside the prefix and inside the large payload.
+    const std::vector<std::vector<std::byte>> chunks{
+        {wire.begin(), wire.begin() + 10},
+        {wire.begin() + 10, wire.begin() + 100},
+        {wire.begin() + 100, wire.end()}};
+
+    const auto seen = exchange(loop, length_prefix_decoder{}, chunks,
+                               framed_reader_options{.initial_capacity = 64});
+    EXPECT_TRUE(seen.status.has_value());
+    EXPECT_TRUE(seen.clean_eof);
+    EXPECT_EQ(seen.frames, (std::vector<std::string>{"head", large, "tail"}));
+    EXPECT_GE(seen.capacity, 256U);
+}
+
+TEST(runtime_framed_reader_test, delimited_lines_and_varint_frames) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    const auto crlf = bytes_of("\r\n");
+    const auto lines = exchange(loop, delimiter_decoder{.delimiter = crlf},
+                                {bytes_of("GET / HTTP/1.1\r\nHost: a\r"),
+                                 bytes_of("\n\r\n")});
+    EXPECT_TRUE(lines.clean_eof);
+    EXPECT_EQ(lines.frames,
+              (std::vector<std::string>{"GET / HTTP/1.1", "Host: a", ""}));
+
+    simplenet::runtime::event_loop varint_loop;
+    ASSERT_TRUE(varint_loop.valid());
+    const std::vector<std::byte> wire{std::byte{2}, std::byte{'o'}, std::byte{'k'},
+                                      std::byte{0}};
+    const auto frames = exchange(varint_loop, varint_prefix_decoder{}, {wire});
+    EXPECT_TRUE(frames.clean_eof);
+    EXPECT_EQ(frames.frames, (std::vector<std::string>{"ok", ""}));
+}
+
+TEST(runtime_framed_reader_test, errors_stop_the_stream) {
+    simplenet::runtime::event_loop truncated_loop;
+    ASSERT_TRUE(truncated_loop.valid());
+    std::vector<std::byte> wire;
+    append_frame(wire, "complete");
+    append_frame(wire, "cut short");
+    wire.resize(wire.size() - 3U);
+    const auto truncated = exchange(truncated_loop, length_prefix_decoder{}, {wire});
+    EXPECT_EQ(truncated.frames, (std::vector<std::string>{"complete"}));
+    ASSERT_FALSE(truncated.status.has_value());
+    EXPECT_EQ(truncated.status.error().value(), ECONNRESET);
+
+    simplenet::runtime::event_loop capped_loop;
+    ASSERT_TRUE(capped_loop.valid());
+    std::vector<std::byte> large;
+    append_frame(large, std::string(100, 'x'));
+    const auto capped = exchange(
+        capped_loop, length_prefix_decoder{}, {large},
+        framed_reader_options{.initial_capacity = 16, .max_capacity = 64});
+    ASSERT_FALSE(capped.status.has_value());
+    EXPECT_EQ(capped.status.error().value(), EMSGSIZE);
+}
+
+TEST(runtime_framed_reader_test, decoder_satisfies_the_concept) {
+    static_assert(simplenet::runtime::frame_decoder<length_prefix_decoder>);
+    static_assert(simplenet::runtime::frame_decoder<varint_prefix_decoder>);
+    static_assert(simplenet::runtime::frame_decoder<delimiter_decoder>);
+    static_assert(!simplenet::runtime::frame_decoder<frame_extent>);
+    SUCCEED();
+}
+
+TEST(runtime_framed_reader_test, delimiter_scan_matches_a_plain_search) {
+    // Lengths and positions straddle the 16- and 32-byte vector steps, and
+    // the filler is full of near misses for the first and last bytes.
+    for (const std::string_view needle : {"\n", "\r\n", "\r\n\r\n", "--bound"}) {
+        const auto pattern = bytes_of(needle);
+        for (std::size_t size = 0; size < 80; ++size) {
+            for (std::size_t at = 0; at <= size; at += 7) {
+                std::vector<std::byte> hay(size, std::byte{'\r'});
+                for (std::size_t index = 1; index < hay.size(); index += 3) {
+                    hay[index] = std::byte{'\n'};
+                    hay[index - 1] = std::byte{'-'};
+                }
+                if (at + pattern.size() <= hay.size()) {
+                    std::ranges::copy(pattern, hay.begin() + static_cast<long>(at));
+                }
+                const auto expected = std::ranges::search(hay, pattern);
+
+                delimiter_decoder decoder{.delimiter = pattern,
+                                          .max_payload = 1024};
+                const auto found = decoder.decode(hay);
+                ASSERT_TRUE(found.has_value());
+                if (expected.empty()) {
+                    EXPECT_FALSE(found.value().has_value())
+                        << needle.size() << " in " << size;
+                } else {
+                    ASSERT_TRUE(found.value().has_value())
+                        << needle.size() << " in " << size << " at " << at;
+                    EXPECT_EQ(found.value()->payload,
+                              static_cast<std::size_t>(expected.begin() - hay.begin()));
+                }
+            }
+        }
+    }
+}
+
+TEST(runtime_framed_reader_test, read_until_returns_lines_across_partial_reads) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto bound = tcp_listener::bind(socket_address::loopback(0));
+    ASSERT_TRUE(bound.has_value());
+    auto listener = std::move(bound.value());
+    const auto address = listener.local_address().value();
+
+    std::vector<std::string> lines;
+    std::string lookahead;
+    simplenet::result<std::optional<simplenet::runtime::frame>> overlong =
+        std::optional<simplenet::runtime::frame>{};
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_accept(listener);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        framed_reader reader{stream.value()};
+        for (int index = 0; index < 3; ++index) {
+            auto line = co_await simplenet::runtime::async_read_until(reader, "\r\n");
+            if (!line.has_value() || !line.value().has_value()) {
+                ADD_FAILURE() << "line " << index;
+                co_return;
+            }
+            lines.push_back(text_of(line.value()->payload));
+        }
+        lookahead = text_of(reader.buffered());
+        overlong = co_await simplenet::runtime::async_read_until(reader, "\r\n", 4);
+    };
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(address);
+        if (!stream.has_value()) {
+            ADD_FAILURE() << stream.error().message();
+            co_return;
+        }
+        for (const std::string_view part : {"*2\r", "\n$3\r\nGET", "\r\n+PONG-and-more"}) {
+            const auto written = co_await simplenet::runtime::async_write_all(
+                stream.value(), bytes_of(part));
+            EXPECT_TRUE(written.has_value());
+            (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{2});
+        }
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    ASSERT_TRUE(loop.run().has_value());
+    EXPECT_EQ(lines, (std::vector<std::string>{"*2", "$3", "GET"}));
+    EXPECT_EQ(lookahead, "+PONG-and-more");
+    ASSERT_FALSE(overlong.has_value());
+    EXPECT_EQ(overlong.error().value(), EMSGSIZE);
+}
+
+TEST(runtime_framed_reader_test, idle_reader_releases_its_buffer) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    idle_reader_holds_no_buffer(loop);
+}
+
+TEST(runtime_framed_reader_test, idle_reader_releases_its_buffer_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    idle_reader_holds_no_buffer(loop);
+}
@@ -0,0 +1,295 @@
+#include "simplenet/nonblocking/local.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+#include "simplenet/runtime/write_queue.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using simplenet::nonblocking::local_kind;
+using simplenet::nonblocking::local_listener;
+using simplenet::nonblocking::local_stream;
+using simplenet::runtime::task;
+
+/// Abstract name unique to this process and `label`.
+std::string abstract_name(const char *label) {
+    return "@simplenet-test-" + std::to_string(::getpid()) + "-" + label;
+}
+
+std::pair<local_stream, local_stream> make_pair(local_kind kind) {
+    auto made = local_stream::pair(kind);
+    EXPECT_TRUE(made.has_value()) << made.error().message();
+    return made.has_value() ? std::move(made.value())
+                            : std::pair<local_stream, local_stream>{};
+}
+
+std::span<const std::byte> bytes_of(std::string_view text) {
+    return std::as_bytes(std::span{text.data(), text.size()});
+}
+
+template <class Loop> void echo_round_trip(Loop& loop, const char *label) {
+    const auto name = abstract_name(label);
+    auto bound = local_listener::bind(name);
+    ASSERT_TRUE(bound.has_value()) << bound.error().message();
+    auto listener = std::move(bound.value());
+
+    std::array<std::byte, 5> echoed{};
+    auto server = [&]() -> task<void> {
+        auto accepted = co_await simplenet::runtime::async_accept(listener);
+        if (!accepted.has_value()) {
+            ADD_FAILURE() << accepted.error().message();
+            co_return;
+        }
+        std::array<std::byte, 5> request{};
+        const auto read = co_await simplenet::runtime::async_read_exact(
+            accepted.value(), request);
+        if (!read.has_value()) {
+            ADD_FAILURE() << read.error().message();
+            co_return;
+        }
+        const auto written = co_await simplenet::runtime::async_write_all(
+            accepted.value(), request);
+        if (!written.has_value()) {
+            ADD_FAILURE() << written.error().message();
+        }
+    };
+    auto client = [&]() -> task<void> {
+        auto connected = local_stream::connect(name);
+        if (!connected.has_value()) {
+            ADD_FAILURE() << connected.error().message();
+            co_return;
+        }
+        const auto written = co_await simplenet::runtime::async_write_all(
+            connected.value(), bytes_of("hello"));
+        if (!written.has_value()) {
+            ADD_FAILURE() << written.error().message();
+            co_return;
+        }
+        const auto read = co_await simplenet::runtime::async_read_exact(
+            connected.value(), echoed);
+        if (!read.has_value()) {
+            ADD_FAILURE() << read.error().message();
+        }
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(echoed.data()),
+                          echoed.size()),
+              "hello");
+}
+
+/// Sends a pipe's write end over the socket; the receiver writes through it.
+template <class Loop> void pass_pipe(Loop& loop) {
+    auto [left, right] = make_pair(local_kind::stream);
+    std::array<int, 2> ends{};
+    ASSERT_EQ(::pipe(ends.data()), 0);
+    const simplenet::unique_fd read_end{ends[0]};
+    simplenet::unique_fd write_end{ends[1]};
+
+    simplenet::nonblocking::fd_message message{};
+    auto sender = [&]() -> task<void> {
+        const std::array<int, 1> fds{write_end.get()};
+        const auto sent =
+            co_await simplenet::runtime::async_send_fds(left, bytes_of("p"), fds);
+        if (!sent.has_value()) {
+            ADD_FAILURE() << sent.error().message();
+        }
+        // The receiver holds its own duplicate from here on.
+        write_end.reset();
+    };
+    auto receiver = [&]() -> task<void> {
+        std::array<std::byte, 4> buffer{};
+        std::array<simplenet::unique_fd, 2> fds{};
+        auto received =
+            co_await simplenet::runtime::async_receive_fds(right, buffer, fds);
+        if (!received.has_value()) {
+            ADD_FAILURE() << received.error().message();
+            co_return;
+        }
+        message = received.value();
+        if (message.fds == 1U) {
+            EXPECT_EQ(::write(fds[0].get(), "via", 3), 3);
+        }
+    };
+    loop.spawn(receiver());
+    loop.spawn(sender());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(message.size, 1U);
+    EXPECT_EQ(message.fds, 1U);
+    EXPECT_FALSE(message.truncated);
+
+    std::array<char, 8> piped{};
+    ASSERT_EQ(::read(read_end.get(), piped.data(), piped.size()), 3);
+    EXPECT_EQ(std::string(piped.data(), 3), "via");
+    // Every write end is closed now, so the pipe reports end of file.
+    EXPECT_EQ(::read(read_end.get(), piped.data(), piped.size()), 0);
+}
+
+TEST(runtime_local_test, epoll_listener_echoes) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    echo_round_trip(loop, "epoll-echo");
+}
+
+TEST(runtime_local_test, uring_listener_echoes) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    echo_round_trip(loop, "uring-echo");
+}
+
+TEST(runtime_local_test, filesystem_path_binds_and_connects) {
+    const auto path = testing::TempDir() + "simplenet-local-" +
+                      std::to_string(::getpid()) + ".sock";
+    (void)::unlink(path.c_str());
+    auto listener = local_listener::bind(path);
+    ASSERT_TRUE(listener.has_value()) << listener.error().message();
+
+    auto client = local_stream::connect(path);
+    ASSERT_TRUE(client.has_value()) << client.error().message();
+    auto server = listener.value().accept();
+    ASSERT_TRUE(server.has_value()) << server.error().message();
+
+    // The path outlives the listener and blocks a second bind.
+    listener.value() = local_listener{};
+    auto again = local_listener::bind(path);
+    ASSERT_FALSE(again.has_value());
+    EXPECT_EQ(again.error().value(), EADDRINUSE);
+    EXPECT_EQ(::unlink(path.c_str()), 0);
+}
+
+TEST(runtime_local_test, rejects_unusable_addresses) {
+    const auto empty = local_stream::connect("");
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().value(), EINVAL);
+
+    const auto too_long = local_listener::bind(std::string(200, 'x'));
+    ASSERT_FALSE(too_long.has_value());
+    EXPECT_EQ(too_long.error().value(), ENAMETOOLONG);
+
+    const auto missing = local_stream::connect(abstract_name("nobody"));
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().value(), ECONNREFUSED);
+}
+
+TEST(runtime_local_test, seqpacket_keeps_message_boundaries) {
+    auto [left, right] = make_pair(local_kind::seqpacket);
+    ASSERT_TRUE(left.write_some(bytes_of("one")).has_value());
+    ASSERT_TRUE(left.write_some(bytes_of("three")).has_value());
+
+    std::array<std::byte, 16> buffer{};
+    const auto first = right.read_some(buffer);
+    ASSERT_TRUE(first.has_value()) << first.error().message();
+    EXPECT_EQ(first.value(), 3U);
+    const auto second = right.read_some(buffer);
+    ASSERT_TRUE(second.has_value()) << second.error().message();
+    EXPECT_EQ(second.value(), 5U);
+}
+
+TEST(runtime_local_test, epoll_loop_passes_descriptors) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    pass_pipe(loop);
+}
+
+TEST(runtime_local_test, uring_loop_passes_descriptors) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    pass_pipe(loop);
+}
+
+TEST(runtime_local_test, extra_descriptors_are_closed_and_reported) {
+    auto [left, right] = make_pair(local_kind::seqpacket);
+    std::array<int, 2> ends{};
+    ASSERT_EQ(::pipe(ends.data()), 0);
+    const simplenet::unique_fd read_end{ends[0]};
+    const simplenet::unique_fd write_end{ends[1]};
+
+    const std::array<int, 2> fds{read_end.get(), write_end.get()};
+    const auto sent = left.send_fds(bytes_of("x"), fds);
+    ASSERT_TRUE(sent.has_value()) << sent.error().message();
+
+    std::array<std::byte, 4> buffer{};
+    std::array<simplenet::unique_fd, 1> slots{};
+    const auto received = right.receive_fds(buffer, slots);
+    ASSERT_TRUE(received.has_value()) << received.error().message();
+    EXPECT_EQ(received.value().size, 1U);
+    EXPECT_EQ(received.value().fds, 1U);
+    EXPECT_TRUE(received.value().truncated);
+    EXPECT_TRUE(slots[0].valid());
+}
+
+TEST(runtime_local_test, send_fds_needs_payload) {
+    auto [left, right] = make_pair(local_kind::stream);
+    const std::array<int, 1> fds{left.native_handle()};
+    const auto sent = left.send_fds({}, fds);
+    ASSERT_FALSE(sent.has_value());
+    EXPECT_EQ(sent.error().value(), EINVAL);
+}
+
+TEST(runtime_local_test, queued_writer_flushes_to_local_stream) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    auto [left, right] = make_pair(local_kind::stream);
+
+    constexpr std::size_t kMessages = 64;
+    std::vector<std::byte> received;
+    auto writer_task = [&]() -> task<void> {
+        simplenet::runtime::queued_writer writer{std::move(left)};
+        for (std::size_t index = 0; index < kMessages; ++index) {
+            if (!writer.enqueue(bytes_of("0123456789abcdef")).has_value()) {
+                ADD_FAILURE() << "enqueue failed";
+                co_return;
+            }
+        }
+        const auto shut = co_await writer.graceful_shutdown(1s);
+        if (!shut.has_value()) {
+            ADD_FAILURE() << shut.error().message();
+        }
+    };
+    auto reader_task = [&]() -> task<void> {
+        std::array<std::byte, 256> buffer{};
+        while (true) {
+            const auto read =
+                co_await simplenet::runtime::async_read_some(right, buffer);
+            if (!read.has_value()) {
+                ADD_FAILURE() << read.error().message();
+                co_return;
+            }
+            if (read.value() == 0U) {
+                co_return;
+            }
+            received.insert(received.end(), buffer.begin(),
+                            buffer.begin() +
+                                static_cast<std::ptrdiff_t>(read.value()));
+        }
+    };
+    loop.spawn(writer_task());
+    loop.spawn(reader_task());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(received.size(), kMessages * 16U);
+}
+
+} // namespace
@@ -0,0 +1,349 @@
+#include "simplenet/blocking/tcp.hpp"
+#include "simplenet/runtime/engine.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/loop_pool.hpp"
+#include "simplenet/runtime/numa.hpp"
+#include "simplenet/thread_pool_context.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <sched.h>
+#include <set>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using simplenet::runtime::loop_pool;
+
+TEST(runtime_loop_pool_test, spawn_each_runs_every_loop_on_its_own_thread) {
+    simplenet::thread_pool_context context{{.threads = 3}};
+    ASSERT_TRUE(context.valid());
+    ASSERT_EQ(context.size(), 3U);
+
+    std::vector<std::thread::id> seen(context.size());
+    auto record = [&](std::size_t index) -> simplenet::runtime::task<void> {
+        seen[index] = std::this_thread::get_id();
+        co_return;
+    };
+    context.spawn_each(record);
+
+    const auto run_result = context.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+
+    const std::set<std::thread::id> distinct(seen.begin(), seen.end());
+    EXPECT_EQ(distinct.size(), seen.size());
+    EXPECT_FALSE(distinct.contains(std::thread::id{}));
+    EXPECT_FALSE(distinct.contains(std::this_thread::get_id()));
+}
+
+TEST(runtime_loop_pool_test, spawn_on_targets_one_loop_and_rejects_bad_index) {
+    loop_pool pool{{.threads = 2, .pin_threads = false}};
+    ASSERT_TRUE(pool.valid());
+
+    std::atomic<int> ran{0};
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        ran.fetch_add(1);
+        co_return;
+    };
+    EXPECT_TRUE(pool.spawn_on(1, work()).has_value());
+
+    const auto rejected = pool.spawn_on(2, work());
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error().value(), EINVAL);
+
+    const auto run_result = pool.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(ran.load(), 1);
+}
+
+TEST(runtime_loop_pool_test, stop_from_another_thread_ends_parked_loops) {
+    loop_pool pool{{.threads = 2}};
+    ASSERT_TRUE(pool.valid());
+
+    auto park = [](std::size_t) -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::seconds{30});
+    };
+    pool.spawn_each(park);
+
+    std::thread stopper{[&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        pool.stop();
+    }};
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto run_result = pool.run();
+    stopper.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds{5});
+}
+
+TEST(runtime_loop_pool_test, stop_before_run_is_not_lost) {
+    loop_pool pool{{.threads = 2}};
+    ASSERT_TRUE(pool.valid());
+
+    auto park = [](std::size_t) -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::seconds{30});
+    };
+    pool.spawn_each(park);
+
+    // Stopping before the run, or while the workers start, still ends it
+    // long before the sleeps would.
+    pool.stop();
+    auto started = std::chrono::steady_clock::now();
+    auto run_result = pool.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds{5});
+
+    pool.spawn_each(park);
+    std::thread stopper{[&] { pool.stop(); }};
+    started = std::chrono::steady_clock::now();
+    run_result = pool.run();
+    stopper.join();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds{5});
+}
+
+void expect_sharded_listeners_accept(loop_pool::backend backend,
+                                     bool steer_by_cpu) {
+    loop_pool pool{{.selected_backend = backend, .threads = 2}};
+    if (!pool.valid()) {
+        GTEST_SKIP() << "backend unavailable";
+    }
+
+    auto listeners_result = pool.listen_sharded(
+        simplenet::nonblocking::endpoint::loopback(0), 64, steer_by_cpu);
+    ASSERT_TRUE(listeners_result.has_value())
+        << listeners_result.error().message();
+    auto& listeners = listeners_result.value();
+    ASSERT_EQ(listeners.size(), pool.size());
+
+    const auto port_result = listeners.front().local_port();
+    ASSERT_TRUE(port_result.has_value());
+    const auto port = port_result.value();
+    for (const auto& listener : listeners) {
+        const auto shared_port = listener.local_port();
+        ASSERT_TRUE(shared_port.has_value());
+        EXPECT_EQ(shared_port.value(), port);
+    }
+
+    constexpr int kConnections = 16;
+    std::atomic<int> accepted{0};
+    auto serve = [&](std::size_t index) -> simplenet::runtime::task<void> {
+        auto& listener = listeners[index];
+        while (true) {
+            auto stream = co_await simplenet::runtime::async_accept(listener);
+            if (!stream.has_value()) {
+                co_return;
+            }
+            if (accepted.fetch_add(1) + 1 == kConnections) {
+                pool.stop();
+                co_return;
+            }
+        }
+    };
+    pool.spawn_each(serve);
+
+    std::vector<simplenet::blocking::tcp_stream> clients;
+    std::thread connector{[&] {
+        for (int attempt = 0; attempt < kConnections; ++attempt) {
+            auto client = simplenet::blocking::tcp_stream::connect(
+                simplenet::blocking::endpoint::loopback(port));
+            if (client.has_value()) {
+                clients.push_back(std::move(client.value()));
+            }
+        }
+    }};
+
+    const auto run_result = pool.run();
+    connector.join();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(clients.size(), static_cast<std::size_t>(kConnections));
+    EXPECT_EQ(accepted.load(), kConnections);
+}
+
+TEST(runtime_loop_pool_test, epoll_sharded_listeners_share_port) {
+    expect_sharded_listeners_accept(loop_pool::backend::epoll, false);
+}
+
+TEST(runtime_loop_pool_test, uring_sharded_listeners_share_port) {
+    expect_sharded_listeners_accept(loop_pool::backend::io_uring, false);
+}
+
+TEST(runtime_loop_pool_test, cpu_steered_listeners_accept) {
+    expect_sharded_listeners_accept(loop_pool::backend::epoll, true);
+}
+
+simplenet::runtime::task<std::thread::id>
+wait_for_peer_job(std::atomic<int>& running, int expected) {
+    running.fetch_add(1);
+    const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (running.load() < expected &&
+           std::chrono::steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    co_return std::this_thread::get_id();
+}
+
+TEST(runtime_loop_pool_test, idle_loop_steals_work_and_caller_resumes_home) {
+    loop_pool pool{{.threads = 2, .pin_threads = false, .work_stealing = true}};
+    ASSERT_TRUE(pool.valid());
+
+    // Both jobs come from loop 0; they can only overlap (and so finish
+    // before the give-up deadline) if loop 1 steals one of them.
+    constexpr int kJobs = 2;
+    std::atomic<int> running{0};
+    std::atomic<int> finished{0};
+    std::vector<std::thread::id> job_threads(kJobs);
+    std::vector<std::thread::id> home_threads(kJobs);
+    std::vector<std::thread::id> resumed_threads(kJobs);
+
+    auto caller = [&](int slot) -> simplenet::runtime::task<void> {
+        home_threads[slot] = std::this_thread::get_id();
+        job_threads[slot] = co_await simplenet::runtime::stealable(
+            wait_for_peer_job(running, kJobs));
+        resumed_threads[slot] = std::this_thread::get_id();
+        if (finished.fetch_add(1) + 1 == kJobs) {
+            pool.stop();
+        }
+    };
+    for (int slot = 0; slot < kJobs; ++slot) {
+        ASSERT_TRUE(pool.spawn_on(0, caller(slot)).has_value());
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto run_result = pool.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds{4});
+
+    ASSERT_EQ(finished.load(), kJobs);
+    EXPECT_NE(job_threads[0], job_threads[1]);
+    for (int slot = 0; slot < kJobs; ++slot) {
+        EXPECT_EQ(resumed_threads[slot], home_threads[slot]);
+        EXPECT_EQ(home_threads[slot], home_threads[0]);
+    }
+}
+
+simplenet::runtime::task<int> add_and_try_to_sleep(int left, int right) {
+    const auto slept =
+        co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{1});
+    co_return slept.has_value() ? -1 : left + right;
+}
+
+TEST(runtime_loop_pool_test, stealable_runs_inline_without_a_stealing_pool) {
+    simplenet::runtime::engine runtime;
+    ASSERT_TRUE(runtime.valid());
+
+    int sum = 0;
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        // No scheduler inside the job, so the sleep is refused.
+        sum = co_await simplenet::runtime::stealable(add_and_try_to_sleep(2, 3));
+    };
+    runtime.spawn(work());
+
+    const auto run_result = runtime.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(sum, 5);
+}
+
+
+/// First CPU in this process's affinity mask.
+int first_allowed_cpu() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return -1;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+TEST(runtime_loop_pool_test, placement_pins_loops_and_steers_listeners) {
+    const int target = first_allowed_cpu();
+    ASSERT_GE(target, 0);
+    loop_pool pool{{.threads = 2, .cpus = {target}, .steer_incoming_cpu = true}};
+    ASSERT_TRUE(pool.valid());
+    EXPECT_EQ(pool.cpu(0), target);
+    EXPECT_EQ(pool.cpu(1), target);
+    EXPECT_EQ(pool.cpu(2), -1);
+    EXPECT_EQ(pool.numa_node(1), simplenet::runtime::numa::node_of_cpu(target));
+
+    auto listeners = pool.listen_sharded(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listeners.has_value()) << listeners.error().message();
+    for (const auto& listener : listeners.value()) {
+        int incoming = -1;
+        socklen_t length = sizeof(incoming);
+        ASSERT_EQ(::getsockopt(listener.native_handle(), SOL_SOCKET,
+                               SO_INCOMING_CPU, &incoming, &length),
+                  0);
+        EXPECT_EQ(incoming, target);
+    }
+
+    std::vector<int> ran_on(pool.size(), -1);
+    auto record = [&](std::size_t index) -> simplenet::runtime::task<void> {
+        ran_on[index] = ::sched_getcpu();
+        co_return;
+    };
+    pool.spawn_each(record);
+    const auto run_result = pool.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(ran_on, (std::vector<int>{target, target}));
+}
+
+TEST(runtime_loop_pool_test, numa_node_narrows_placement_to_its_cpus) {
+    const int node = simplenet::runtime::numa::node_of_cpu(first_allowed_cpu());
+    if (node < 0) {
+        GTEST_SKIP() << "no NUMA topology in sysfs";
+    }
+    const auto local = simplenet::runtime::numa::cpus_of_node(node);
+    loop_pool pool{{.numa_node = node}};
+    ASSERT_TRUE(pool.valid());
+    ASSERT_GE(pool.size(), 1U);
+    for (std::size_t index = 0; index < pool.size(); ++index) {
+        EXPECT_NE(std::ranges::find(local, pool.cpu(index)), local.end());
+        EXPECT_EQ(pool.numa_node(index), node);
+    }
+
+    // A node without any allowed CPU leaves the placement as it was.
+    const loop_pool unaffected{{.numa_node = 4095}};
+    const loop_pool plain{};
+    EXPECT_EQ(unaffected.size(), plain.size());
+}
+
+TEST(runtime_loop_pool_test, uring_sqpoll_pool_runs_with_pinned_poll_threads) {
+    loop_pool pool{{.selected_backend = loop_pool::backend::io_uring,
+                    .threads = 1,
+                    .uring_sqpoll = true}};
+    if (!pool.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    // SQPOLL may be dropped (EPERM without privileges); the ring still runs.
+    bool ran = false;
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        co_await simplenet::runtime::yield();
+        ran = true;
+    };
+    ASSERT_TRUE(pool.spawn_on(0, work()).has_value());
+    const auto run_result = pool.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(ran);
+}
+
+TEST(runtime_loop_pool_test, unpinned_loops_report_no_cpu) {
+    const loop_pool pool{{.threads = 1, .pin_threads = false}};
+    EXPECT_EQ(pool.cpu(0), -1);
+    EXPECT_EQ(pool.numa_node(0), -1);
+}
+
+} // namespace
@@ -0,0 +1,238 @@
+#include "simplenet/core/unique_fd.hpp"
+#include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/loop_metrics.hpp"
+#include "simplenet/runtime/op_latency.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+#include "simplenet/runtime/write_queue.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::task;
+
+struct published {
+    int calls{0};
+    std::uint64_t last_iterations{0};
+    std::uint64_t last_timed{0};
+};
+
+void record_publish(const simplenet::runtime::loop_metrics& metrics,
+                    void *context) noexcept {
+    auto& seen = *static_cast<published *>(context);
+    ++seen.calls;
+    seen.last_iterations = metrics.iterations;
+    seen.last_timed = metrics.timed_waiters;
+}
+
+task<void> sleeper(int rounds) {
+    for (int round = 0; round < rounds; ++round) {
+        (void)co_await simplenet::runtime::async_sleep(2ms);
+    }
+}
+
+template <class Loop> void expect_loop_counts_and_publishes(Loop& loop) {
+    if constexpr (!simplenet::runtime::metrics_enabled) {
+        GTEST_SKIP() << "built without SIMPLENET_ENABLE_METRICS";
+    }
+    published seen;
+    simplenet::runtime::metrics_hook hook{
+        .publish = &record_publish, .context = &seen, .interval = 0ms};
+    loop.set_metrics_hook(&hook);
+    loop.set_latency_sampling(true);
+    loop.spawn(sleeper(10));
+    loop.spawn(sleeper(10));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    loop.set_metrics_hook(nullptr);
+
+    const auto metrics = loop.metrics();
+    EXPECT_GE(metrics.iterations, 10U);
+    EXPECT_GE(metrics.resumes, 20U);
+    EXPECT_GE(metrics.ready_high_water, 2U);
+    EXPECT_GE(metrics.timeouts_fired, 10U);
+    EXPECT_EQ(metrics.pending_waiters, 0U);
+    EXPECT_EQ(metrics.timed_waiters, 0U);
+    EXPECT_EQ(metrics.resume_latency.count(), metrics.resumes);
+    EXPECT_GT(metrics.iteration_latency.count(), 0U);
+    EXPECT_LT(metrics.iteration_latency.count(), metrics.iterations);
+
+    // A zero interval publishes after every wait, plus once at the end.
+    EXPECT_EQ(static_cast<std::uint64_t>(seen.calls), metrics.iterations + 1U);
+    EXPECT_EQ(seen.last_iterations, metrics.iterations);
+}
+
+TEST(runtime_metrics_test, epoll_loop_counts_and_publishes) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_loop_counts_and_publishes(loop);
+}
+
+TEST(runtime_metrics_test, uring_loop_counts_and_publishes) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_loop_counts_and_publishes(loop);
+    if constexpr (simplenet::runtime::metrics_enabled) {
+        const auto metrics = loop.metrics();
+        // Each sleep is a kernel timeout SQE.
+        EXPECT_GE(metrics.sqes_submitted, 20U);
+        EXPECT_GE(metrics.submit_calls, 1U);
+        EXPECT_LE(metrics.submit_calls, metrics.sqes_submitted);
+    }
+}
+
+TEST(runtime_metrics_test, epoll_loop_counts_interest_updates) {
+    if constexpr (!simplenet::runtime::metrics_enabled) {
+        GTEST_SKIP() << "built without SIMPLENET_ENABLE_METRICS";
+    }
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    const simplenet::unique_fd peer{fds[1]};
+    auto reader = [&]() -> task<void> {
+        std::array<std::byte, 16> buffer{};
+        (void)co_await simplenet::runtime::async_read_some_with_timeout(
+            stream, buffer, 10ms);
+    };
+    loop.spawn(reader());
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    const auto metrics = loop.metrics();
+    EXPECT_EQ(metrics.interest_updates, loop.stats().interest_updates);
+    EXPECT_GE(metrics.interest_updates, 1U);
+    EXPECT_EQ(metrics.timeouts_fired, 1U);
+    // Sampling was never turned on.
+    EXPECT_EQ(metrics.resume_latency.count(), 0U);
+}
+
+template <class Loop>
+void run_timed_exchange(simplenet::runtime::op_backend backend) {
+    if constexpr (!simplenet::runtime::metrics_enabled) {
+        GTEST_SKIP() << "built without SIMPLENET_ENABLE_METRICS";
+    }
+    using simplenet::runtime::op_kind;
+    const auto before = simplenet::runtime::op_latency_process_snapshot();
+    simplenet::runtime::set_op_latency_sampling(true);
+
+    bool skipped = false;
+    simplenet::result<void> status = simplenet::ok();
+    std::size_t received = 0;
+    // Its own thread, so the totals also cover a thread that has exited.
+    std::thread worker{[&]() {
+        Loop loop;
+        if (!loop.valid()) {
+            skipped = true;
+            return;
+        }
+        auto listener = simplenet::nonblocking::tcp_listener::bind(
+            simplenet::nonblocking::endpoint::loopback(0), 8);
+        if (!listener.has_value()) {
+            status = simplenet::err<void>(listener.error());
+            return;
+        }
+        const auto port = listener.value().local_port();
+        auto server = [&]() -> task<void> {
+            auto peer = co_await simplenet::runtime::async_accept(listener.value());
+            if (!peer.has_value()) {
+                status = simplenet::err<void>(peer.error());
+                co_return;
+            }
+            (void)co_await simplenet::runtime::async_sleep(5ms);
+            simplenet::runtime::queued_writer writer{std::move(peer.value())};
+            constexpr std::string_view reply{"pong"};
+            (void)writer.enqueue(std::as_bytes(std::span{reply}));
+            const auto flushed = co_await writer.flush(1s);
+            if (!flushed.has_value()) {
+                status = flushed;
+            }
+        };
+        auto client = [&]() -> task<void> {
+            auto stream = co_await simplenet::runtime::async_connect(
+                simplenet::nonblocking::endpoint::loopback(port.value()));
+            if (!stream.has_value()) {
+                status = simplenet::err<void>(stream.error());
+                co_return;
+            }
+            std::array<std::byte, 16> buffer{};
+            const auto read = co_await simplenet::runtime::async_read_some(
+                stream.value(), buffer);
+            received = read.has_value() ? read.value() : 0U;
+        };
+        loop.spawn(server());
+        loop.spawn(client());
+        const auto run_result = loop.run();
+        if (!run_result.has_value()) {
+            status = run_result;
+        }
+    }};
+    worker.join();
+    simplenet::runtime::set_op_latency_sampling(false);
+    if (skipped) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    ASSERT_TRUE(status.has_value()) << status.error().message();
+    EXPECT_EQ(received, 4U);
+
+    const auto after = simplenet::runtime::op_latency_process_snapshot();
+    const auto samples = [&](op_kind kind) {
+        return after.at(kind, backend).count() - before.at(kind, backend).count();
+    };
+    EXPECT_EQ(samples(op_kind::connect), 1U);
+    EXPECT_EQ(samples(op_kind::read_some), 1U);
+    EXPECT_EQ(samples(op_kind::flush), 1U);
+    // The read waited out the server's sleep.
+    EXPECT_GE(after.at(op_kind::read_some, backend).max(), 4ms);
+    EXPECT_LT(after.at(op_kind::connect, backend).value_at_quantile(0.5), 1s);
+}
+
+TEST(runtime_metrics_test, op_latency_covers_epoll_operations) {
+    run_timed_exchange<simplenet::runtime::event_loop>(
+        simplenet::runtime::op_backend::readiness);
+}
+
+TEST(runtime_metrics_test, op_latency_covers_uring_operations) {
+    run_timed_exchange<simplenet::runtime::uring_event_loop>(
+        simplenet::runtime::op_backend::completion);
+}
+
+TEST(runtime_metrics_test, op_latency_is_off_by_default) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    EXPECT_FALSE(simplenet::runtime::op_latency_sampling());
+    const auto before = simplenet::runtime::op_latency_thread_snapshot();
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    const simplenet::unique_fd peer{fds[1]};
+    auto reader = [&]() -> task<void> {
+        std::array<std::byte, 16> buffer{};
+        (void)co_await simplenet::runtime::async_read_some_with_timeout(
+            stream, buffer, 1ms);
+    };
+    loop.spawn(reader());
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    const auto after = simplenet::runtime::op_latency_thread_snapshot();
+    EXPECT_EQ(after.at(simplenet::runtime::op_kind::read_some,
+                       simplenet::runtime::op_backend::readiness)
+                  .count(),
+              before.at(simplenet::runtime::op_kind::read_some,
+                        simplenet::runtime::op_backend::readiness)
+                  .count());
+}
+
+} // namespace
@@ -0,0 +1,130 @@
+#include "simplenet/io_context.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <coroutine>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Parks the awaiting coroutine until a foreign thread posts it back,
+/// after first posting `burst` callables that log into `order`.
+struct foreign_round_trip {
+    std::vector<int>& order;
+    std::vector<std::thread::id>& ran_on;
+    int burst;
+    std::thread& poster;
+    simplenet::runtime::scheduler *owner{nullptr};
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <class Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) {
+        owner = handle.promise().scheduler_ptr();
+        owner->retain_external();
+        poster = std::thread{[this, handle] {
+            for (int index = 0; index < burst; ++index) {
+                const auto posted = owner->post([this, index]() noexcept {
+                    order.push_back(index);
+                    ran_on.push_back(std::this_thread::get_id());
+                });
+                EXPECT_TRUE(posted.has_value());
+            }
+            EXPECT_TRUE(owner->post(handle).has_value());
+        }};
+    }
+
+    void await_resume() const noexcept {
+        owner->release_external();
+    }
+};
+
+template <class Loop> void expect_foreign_posts_run_in_order(Loop& loop) {
+    constexpr int kBurst = 500;
+    std::vector<int> order;
+    std::vector<std::thread::id> ran_on;
+    std::thread poster;
+    std::thread::id loop_thread{};
+    std::thread::id resumed_on{};
+
+    auto work = [&]() -> simplenet::runtime::task<void> {
+        loop_thread = std::this_thread::get_id();
+        co_await foreign_round_trip{order, ran_on, kBurst, poster};
+        resumed_on = std::this_thread::get_id();
+    };
+    loop.spawn(work());
+
+    const auto run_result = loop.run();
+    if (poster.joinable()) {
+        poster.join();
+    }
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+
+    EXPECT_EQ(resumed_on, loop_thread);
+    ASSERT_EQ(order.size(), static_cast<std::size_t>(kBurst));
+    for (int index = 0; index < kBurst; ++index) {
+        EXPECT_EQ(order[static_cast<std::size_t>(index)], index);
+        EXPECT_EQ(ran_on[static_cast<std::size_t>(index)], loop_thread);
+    }
+}
+
+template <class Loop> void expect_unrun_posts_are_discarded() {
+    auto alive = std::make_shared<int>(0);
+    bool ran = false;
+    {
+        Loop loop;
+        if (!loop.valid()) {
+            GTEST_SKIP() << "backend unavailable";
+        }
+        const auto posted = loop.post([keep = alive, &ran]() noexcept {
+            ran = true;
+        });
+        ASSERT_TRUE(posted.has_value());
+        EXPECT_EQ(alive.use_count(), 2);
+    }
+    EXPECT_FALSE(ran);
+    EXPECT_EQ(alive.use_count(), 1);
+}
+
+TEST(runtime_post_test, epoll_foreign_posts_run_in_order_on_loop) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_foreign_posts_run_in_order(loop);
+}
+
+TEST(runtime_post_test, uring_foreign_posts_run_in_order_on_loop) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    expect_foreign_posts_run_in_order(loop);
+}
+
+TEST(runtime_post_test, epoll_unrun_posts_are_discarded) {
+    expect_unrun_posts_are_discarded<simplenet::runtime::event_loop>();
+}
+
+TEST(runtime_post_test, uring_unrun_posts_are_discarded) {
+    expect_unrun_posts_are_discarded<simplenet::runtime::uring_event_loop>();
+}
+
+TEST(runtime_post_test, io_context_runs_work_posted_before_run) {
+    simplenet::io_context context;
+    ASSERT_TRUE(context.valid());
+
+    int ran = 0;
+    ASSERT_TRUE(context.post([&ran]() noexcept { ++ran; }).has_value());
+    auto work = []() -> simplenet::runtime::task<void> { co_return; };
+    context.spawn(work());
+
+    const auto run_result = context.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(ran, 1);
+}
+
+} // namespace
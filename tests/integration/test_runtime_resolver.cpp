@@ -1,14 +1,83 @@
 #include "simplenet/runtime/cancel.hpp"
 #include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
 #include "simplenet/runtime/resolver.hpp"
 
+#include "simplenet/blocking/tcp.hpp"
+
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <future>
 #include <gtest/gtest.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
 
 namespace {
 
+using namespace std::chrono_literals;
+
+using address_result =
+    simplenet::result<std::vector<simplenet::runtime::socket_address>>;
+
+// Resolve `host`/`service` on a fresh loop.
+address_result resolve_once(const std::string& host,
+                            const std::string& service) {
+    simplenet::runtime::event_loop loop;
+    address_result outcome =
+        simplenet::err<std::vector<simplenet::runtime::socket_address>>(
+            simplenet::make_error_from_errno(EINVAL));
+    auto lookup = [&]() -> simplenet::runtime::task<void> {
+        outcome = co_await simplenet::runtime::async_resolve_addresses(
+            host, service, AF_INET);
+    };
+    loop.spawn(lookup());
+    const auto run_result = loop.run();
+    EXPECT_TRUE(run_result.has_value());
+    return outcome;
+}
+
+// Restores default resolver settings when a test changes them.
+struct resolver_settings_guard {
+    ~resolver_settings_guard() {
+        EXPECT_TRUE(simplenet::runtime::configure_resolver({}).has_value());
+    }
+};
+
+bool ipv6_unavailable(const simplenet::error& failure) {
+    return failure.value() == EAFNOSUPPORT || failure.value() == EADDRNOTAVAIL;
+}
+
+// Run `connect` to completion on a fresh loop and report its result.
+simplenet::result<simplenet::nonblocking::tcp_stream>
+run_connect(simplenet::runtime::task<
+            simplenet::result<simplenet::nonblocking::tcp_stream>>
+                connect) {
+    simplenet::runtime::event_loop loop;
+    simplenet::result<simplenet::nonblocking::tcp_stream> outcome =
+        simplenet::err<simplenet::nonblocking::tcp_stream>(
+            simplenet::make_error_from_errno(EINVAL));
+    auto drive = [&]() -> simplenet::runtime::task<void> {
+        outcome = co_await std::move(connect);
+    };
+    loop.spawn(drive());
+    const auto run_result = loop.run();
+    EXPECT_TRUE(run_result.has_value()) << run_result.error().message();
+    return outcome;
+}
+
+// A port that refuses connections: bound once, then released.
+std::uint16_t refused_port() {
+    auto probe = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::runtime::socket_address::loopback(0));
+    EXPECT_TRUE(probe.has_value());
+    return probe.has_value() ? probe.value().local_port().value_or(0) : 0;
+}
+
 TEST(runtime_resolver_test, parse_and_format_ipv4_endpoint_round_trip) {
     const auto parsed = simplenet::runtime::parse_ipv4_endpoint("127.0.0.1:8080");
     ASSERT_TRUE(parsed.has_value()) << parsed.error().message();
@@ -51,6 +120,485 @@ TEST(runtime_resolver_test, async_resolve_returns_localhost_endpoints) {
         [](const simplenet::runtime::endpoint& value) { return value.port == 80; }));
 }
 
+TEST(runtime_resolver_test, socket_address_parses_ipv4_and_ipv6_literals) {
+    using simplenet::runtime::socket_address;
+
+    const auto ipv4 =
+        socket_address::from_endpoint({.host = "127.0.0.1", .port = 80});
+    ASSERT_TRUE(ipv4.has_value()) << ipv4.error().message();
+    EXPECT_EQ(ipv4.value().family(), AF_INET);
+    EXPECT_EQ(ipv4.value().port(), 80U);
+    EXPECT_EQ(ipv4.value(), socket_address::loopback(80));
+
+    const auto ipv6 = socket_address::from_endpoint({.host = "::1", .port = 443});
+    ASSERT_TRUE(ipv6.has_value()) << ipv6.error().message();
+    EXPECT_EQ(ipv6.value().family(), AF_INET6);
+    EXPECT_EQ(ipv6.value().port(), 443U);
+    EXPECT_EQ(ipv6.value(), socket_address::ipv6_loopback(443));
+    const auto formatted = ipv6.value().to_endpoint();
+    ASSERT_TRUE(formatted.has_value()) << formatted.error().message();
+    EXPECT_EQ(formatted.value().host, "::1");
+    EXPECT_EQ(formatted.value().port, 443U);
+
+    EXPECT_FALSE(socket_address::from_endpoint({.host = "localhost", .port = 1})
+                     .has_value());
+    EXPECT_EQ(socket_address{}.family(), AF_UNSPEC);
+    EXPECT_EQ(socket_address::any(0).to_endpoint().value().host, "0.0.0.0");
+}
+
+TEST(runtime_resolver_test, resolved_addresses_connect_without_text) {
+    using simplenet::runtime::socket_address;
+
+    auto listener = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::loopback(0));
+    ASSERT_TRUE(listener.has_value()) << listener.error().message();
+    const auto port = listener.value().local_port();
+    ASSERT_TRUE(port.has_value()) << port.error().message();
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    simplenet::result<std::vector<socket_address>> resolved =
+        simplenet::ok(std::vector<socket_address>{});
+    bool connected = false;
+    socket_address peer{};
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        resolved = co_await simplenet::runtime::async_resolve_addresses(
+            "127.0.0.1", std::to_string(port.value()), AF_INET);
+        if (!resolved.has_value() || resolved.value().empty()) {
+            co_return;
+        }
+        auto stream =
+            co_await simplenet::runtime::async_connect(resolved.value().front());
+        connected = stream.has_value();
+    };
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        while (true) {
+            auto accepted = listener.value().accept(peer);
+            if (accepted.has_value()) {
+                co_return;
+            }
+            if (!simplenet::nonblocking::is_would_block(accepted.error())) {
+                ADD_FAILURE() << accepted.error().message();
+                co_return;
+            }
+            const auto ready = co_await simplenet::runtime::wait_readable(
+                listener.value().native_handle());
+            if (!ready.has_value()) {
+                co_return;
+            }
+        }
+    };
+    loop.spawn(server());
+    loop.spawn(client());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(resolved.has_value()) << resolved.error().message();
+    ASSERT_EQ(resolved.value().size(), 1U);
+    EXPECT_EQ(resolved.value().front(), socket_address::loopback(port.value()));
+    EXPECT_TRUE(connected);
+    EXPECT_EQ(peer.family(), AF_INET);
+    EXPECT_NE(peer.port(), 0U);
+}
+
+TEST(runtime_resolver_test, ipv6_listener_and_connect_use_binary_addresses) {
+    using simplenet::runtime::socket_address;
+
+    auto listener = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::ipv6_loopback(0));
+    if (!listener.has_value() &&
+        (listener.error().value() == EAFNOSUPPORT ||
+         listener.error().value() == EADDRNOTAVAIL)) {
+        GTEST_SKIP() << "IPv6 loopback unavailable";
+    }
+    ASSERT_TRUE(listener.has_value()) << listener.error().message();
+    const auto local = listener.value().local_address();
+    ASSERT_TRUE(local.has_value()) << local.error().message();
+    EXPECT_EQ(local.value().family(), AF_INET6);
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    bool connected = false;
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto stream = co_await simplenet::runtime::async_connect(local.value());
+        connected = stream.has_value();
+    };
+    loop.spawn(client());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(connected);
+
+    socket_address peer{};
+    const auto accepted = listener.value().accept(peer);
+    ASSERT_TRUE(accepted.has_value()) << accepted.error().message();
+    EXPECT_EQ(peer.family(), AF_INET6);
+    EXPECT_EQ(peer.to_endpoint().value().host, "::1");
+}
+
+TEST(runtime_resolver_test, parse_endpoint_accepts_bracketed_ipv6) {
+    const auto ipv6 = simplenet::runtime::parse_endpoint("[::1]:443");
+    ASSERT_TRUE(ipv6.has_value()) << ipv6.error().message();
+    EXPECT_EQ(ipv6.value().host, "::1");
+    EXPECT_EQ(ipv6.value().port, 443U);
+    EXPECT_EQ(simplenet::runtime::format_endpoint(ipv6.value()), "[::1]:443");
+
+    const auto ipv4 = simplenet::runtime::parse_endpoint("10.0.0.1:80");
+    ASSERT_TRUE(ipv4.has_value()) << ipv4.error().message();
+    EXPECT_EQ(simplenet::runtime::format_endpoint(ipv4.value()), "10.0.0.1:80");
+
+    EXPECT_FALSE(simplenet::runtime::parse_endpoint("::1:443").has_value());
+    EXPECT_FALSE(simplenet::runtime::parse_endpoint("[::1]").has_value());
+    EXPECT_FALSE(simplenet::runtime::parse_endpoint("[::1:443").has_value());
+    EXPECT_FALSE(simplenet::runtime::parse_endpoint("[]:443").has_value());
+    EXPECT_FALSE(simplenet::runtime::parse_endpoint("[1.2.3.4]:80").has_value());
+    EXPECT_FALSE(simplenet::runtime::parse_ipv4_endpoint("[::1]:443").has_value());
+}
+
+TEST(runtime_resolver_test, dual_stack_listener_accepts_ipv4_clients) {
+    using simplenet::runtime::socket_address;
+
+    auto dual = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::ipv6_any(0));
+    if (!dual.has_value() && ipv6_unavailable(dual.error())) {
+        GTEST_SKIP() << "IPv6 unavailable";
+    }
+    ASSERT_TRUE(dual.has_value()) << dual.error().message();
+    const auto port = dual.value().local_port().value();
+
+    const auto mapped = run_connect(
+        simplenet::runtime::async_connect(socket_address::loopback(port)));
+    ASSERT_TRUE(mapped.has_value()) << mapped.error().message();
+    socket_address peer{};
+    ASSERT_TRUE(dual.value().accept(peer).has_value());
+    EXPECT_EQ(peer.family(), AF_INET6);
+    EXPECT_EQ(peer.to_endpoint().value().host, "::ffff:127.0.0.1");
+
+    auto v6_only = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::ipv6_any(0), {.v6_only = true});
+    ASSERT_TRUE(v6_only.has_value()) << v6_only.error().message();
+    const auto v6_port = v6_only.value().local_port().value();
+    const auto refused = run_connect(
+        simplenet::runtime::async_connect(socket_address::loopback(v6_port)));
+    ASSERT_FALSE(refused.has_value());
+    EXPECT_EQ(refused.error().value(), ECONNREFUSED);
+}
+
+TEST(runtime_resolver_test, happy_eyeballs_moves_on_when_an_attempt_fails) {
+    using simplenet::runtime::socket_address;
+
+    auto live = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::loopback(0));
+    ASSERT_TRUE(live.has_value()) << live.error().message();
+    const std::vector<socket_address> candidates{
+        socket_address::loopback(refused_port()),
+        socket_address::loopback(live.value().local_port().value()),
+    };
+
+    // A refusal starts the next attempt at once, long before the delay.
+    const auto started = std::chrono::steady_clock::now();
+    const auto connected = run_connect(simplenet::runtime::async_connect(
+        candidates, {.attempt_delay = 10s}));
+    ASSERT_TRUE(connected.has_value()) << connected.error().message();
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 2s);
+    EXPECT_TRUE(live.value().accept().has_value());
+}
+
+TEST(runtime_resolver_test, happy_eyeballs_races_past_a_hanging_attempt) {
+    using simplenet::runtime::socket_address;
+
+    // A full accept queue drops further SYNs, so connects to it hang.
+    auto stalled = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::loopback(0), {.backlog = 0});
+    ASSERT_TRUE(stalled.has_value()) << stalled.error().message();
+    const auto stalled_port = stalled.value().local_port().value();
+    auto filler = simplenet::blocking::tcp_stream::connect(
+        simplenet::blocking::endpoint::loopback(stalled_port));
+    ASSERT_TRUE(filler.has_value()) << filler.error().message();
+
+    auto live = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::loopback(0));
+    ASSERT_TRUE(live.has_value()) << live.error().message();
+    const std::vector<socket_address> candidates{
+        socket_address::loopback(stalled_port),
+        socket_address::loopback(live.value().local_port().value()),
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto connected = run_connect(simplenet::runtime::async_connect(
+        candidates, {.attempt_delay = 50ms}));
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    ASSERT_TRUE(connected.has_value()) << connected.error().message();
+    EXPECT_GE(elapsed, 50ms);
+    EXPECT_LT(elapsed, 900ms);
+    EXPECT_TRUE(live.value().accept().has_value());
+}
+
+TEST(runtime_resolver_test, happy_eyeballs_drains_more_results_than_one_batch) {
+    using simplenet::runtime::socket_address;
+
+    auto live = simplenet::nonblocking::tcp_listener::bind(
+        socket_address::loopback(0));
+    ASSERT_TRUE(live.has_value()) << live.error().message();
+    // Refusals settle as the attempts start, ahead of the live one, so they
+    // fill more than one batch of results.
+    std::vector<socket_address> candidates(40, socket_address::loopback(
+                                                   refused_port()));
+    candidates.push_back(
+        socket_address::loopback(live.value().local_port().value()));
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    simplenet::result<simplenet::nonblocking::tcp_stream> connected =
+        simplenet::err<simplenet::nonblocking::tcp_stream>(
+            simplenet::make_error_from_errno(EINVAL));
+    bool finished = false;
+    auto drive = [&]() -> simplenet::runtime::task<void> {
+        connected = co_await simplenet::runtime::async_connect(
+            candidates, {.attempt_delay = 0ms});
+        finished = true;
+        loop.stop();
+    };
+    // Left to itself, a stalled race would wait forever.
+    auto guard = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(3s);
+        loop.stop();
+    };
+    loop.spawn(drive());
+    loop.spawn(guard());
+    const auto run_result = loop.run();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(finished);
+    ASSERT_TRUE(connected.has_value()) << connected.error().message();
+    EXPECT_TRUE(live.value().accept().has_value());
+}
+
+TEST(runtime_resolver_test, happy_eyeballs_reports_the_last_failure) {
+    using simplenet::runtime::socket_address;
+
+    const std::vector<socket_address> candidates{
+        socket_address::loopback(refused_port()),
+        socket_address::loopback(refused_port()),
+    };
+    const auto connected = run_connect(simplenet::runtime::async_connect(
+        candidates, {.attempt_delay = 10s}));
+    ASSERT_FALSE(connected.has_value());
+    EXPECT_EQ(connected.error().value(), ECONNREFUSED);
+
+    const auto empty = run_connect(simplenet::runtime::async_connect(
+        std::span<const socket_address>{}));
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().value(), EINVAL);
+}
+
+TEST(runtime_resolver_test, async_resolve_resumes_as_soon_as_the_lookup_ends) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    // Polling every 10 ms would need at least 200 ms for these lookups.
+    constexpr int kLookups = 20;
+    int resolved = 0;
+    auto lookups = [&]() -> simplenet::runtime::task<void> {
+        for (int index = 0; index < kLookups; ++index) {
+            const auto addresses =
+                co_await simplenet::runtime::async_resolve_addresses(
+                    "127.0.0.1", "80", AF_INET);
+            resolved += addresses.has_value() ? 1 : 0;
+        }
+    };
+    loop.spawn(lookups());
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto run_result = loop.run();
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(resolved, kLookups);
+    EXPECT_LT(elapsed, 150ms);
+}
+
+TEST(runtime_resolver_test, async_resolve_cancellation_wakes_a_parked_lookup) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    simplenet::runtime::resolver_cache_clear();
+
+    // Hold every worker on a gated job so the target is still queued when
+    // the stop lands.
+    std::promise<void> release;
+    const std::shared_future<void> gate = release.get_future().share();
+    for (std::size_t index = 0; index < simplenet::runtime::resolver_max_workers;
+         ++index) {
+        simplenet::runtime::detail::post_resolver_job([gate]() { gate.wait(); });
+    }
+    bool released = false;
+
+    simplenet::runtime::cancel_source source;
+    simplenet::result<std::vector<simplenet::runtime::socket_address>>
+        target_result = simplenet::ok(
+            std::vector<simplenet::runtime::socket_address>{});
+    bool workers_held_on_resume = false;
+    auto target = [&]() -> simplenet::runtime::task<void> {
+        target_result = co_await simplenet::runtime::async_resolve_addresses(
+            "localhost", "80", AF_UNSPEC, source.token());
+        workers_held_on_resume =
+            gate.wait_for(0s) == std::future_status::timeout;
+        release.set_value();
+        released = true;
+    };
+    auto stopper = [&]() -> simplenet::runtime::task<void> {
+        source.request_stop();
+        co_return;
+    };
+    loop.spawn(target());
+    loop.spawn(stopper());
+
+    const auto run_result = loop.run();
+    if (!released) {
+        release.set_value();
+    }
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(target_result.has_value());
+    EXPECT_EQ(target_result.error().value(), ECANCELED);
+    EXPECT_TRUE(workers_held_on_resume);
+}
+
+TEST(runtime_resolver_test, resolver_cache_answers_repeated_lookups) {
+    simplenet::runtime::resolver_cache_clear();
+    const auto before = simplenet::runtime::resolver_counters();
+
+    const auto first = resolve_once("127.0.0.1", "4101");
+    const auto second = resolve_once("127.0.0.1", "4101");
+    ASSERT_TRUE(first.has_value()) << first.error().message();
+    ASSERT_TRUE(second.has_value()) << second.error().message();
+    EXPECT_EQ(first.value(), second.value());
+
+    const auto after = simplenet::runtime::resolver_counters();
+    EXPECT_EQ(after.misses - before.misses, 1U);
+    EXPECT_EQ(after.hits - before.hits, 1U);
+    EXPECT_GE(after.entries, 1U);
+
+    simplenet::runtime::resolver_cache_clear();
+    (void)resolve_once("127.0.0.1", "4101");
+    EXPECT_EQ(simplenet::runtime::resolver_counters().misses - before.misses,
+              2U);
+}
+
+TEST(runtime_resolver_test, resolver_coalesces_concurrent_lookups) {
+    simplenet::runtime::resolver_cache_clear();
+    const auto before = simplenet::runtime::resolver_counters();
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    constexpr int kLookups = 8;
+    int resolved = 0;
+    auto lookup = [&]() -> simplenet::runtime::task<void> {
+        const auto addresses =
+            co_await simplenet::runtime::async_resolve_addresses("localhost",
+                                                                 "4102");
+        resolved += addresses.has_value() ? 1 : 0;
+    };
+    for (int index = 0; index < kLookups; ++index) {
+        loop.spawn(lookup());
+    }
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(resolved, kLookups);
+
+    // Later tasks join the first job, or hit its answer if it has landed.
+    const auto after = simplenet::runtime::resolver_counters();
+    EXPECT_EQ(after.misses - before.misses, 1U);
+    EXPECT_EQ((after.coalesced - before.coalesced) + (after.hits - before.hits),
+              static_cast<std::uint64_t>(kLookups - 1));
+}
+
+TEST(runtime_resolver_test, resolver_caches_failures_for_the_negative_ttl) {
+    resolver_settings_guard restore;
+    ASSERT_TRUE(simplenet::runtime::configure_resolver(
+                    {.positive_ttl = 30s, .negative_ttl = 50ms})
+                    .has_value());
+    simplenet::runtime::resolver_cache_clear();
+    const auto before = simplenet::runtime::resolver_counters();
+
+    const auto first = resolve_once("127.0.0.1", "no-such-simplenet-service");
+    const auto second = resolve_once("127.0.0.1", "no-such-simplenet-service");
+    ASSERT_FALSE(first.has_value());
+    ASSERT_FALSE(second.has_value());
+    EXPECT_EQ(first.error().value(), second.error().value());
+    EXPECT_EQ(simplenet::runtime::resolver_counters().negative_hits -
+                  before.negative_hits,
+              1U);
+
+    std::this_thread::sleep_for(80ms);
+    (void)resolve_once("127.0.0.1", "no-such-simplenet-service");
+    EXPECT_EQ(simplenet::runtime::resolver_counters().misses - before.misses,
+              2U);
+}
+
+TEST(runtime_resolver_test, resolver_positive_ttl_expires_answers) {
+    resolver_settings_guard restore;
+    ASSERT_TRUE(
+        simplenet::runtime::configure_resolver({.positive_ttl = 30ms})
+            .has_value());
+    simplenet::runtime::resolver_cache_clear();
+    const auto before = simplenet::runtime::resolver_counters();
+
+    ASSERT_TRUE(resolve_once("127.0.0.1", "4103").has_value());
+    std::this_thread::sleep_for(60ms);
+    ASSERT_TRUE(resolve_once("127.0.0.1", "4103").has_value());
+
+    const auto after = simplenet::runtime::resolver_counters();
+    EXPECT_EQ(after.misses - before.misses, 2U);
+    EXPECT_EQ(after.hits - before.hits, 0U);
+}
+
+TEST(runtime_resolver_test, resolver_evicts_past_max_entries) {
+    resolver_settings_guard restore;
+    ASSERT_TRUE(
+        simplenet::runtime::configure_resolver({.max_entries = 2}).has_value());
+    simplenet::runtime::resolver_cache_clear();
+    const auto before = simplenet::runtime::resolver_counters();
+
+    for (const char *service : {"4104", "4105", "4106"}) {
+        ASSERT_TRUE(resolve_once("127.0.0.1", service).has_value());
+    }
+    const auto after = simplenet::runtime::resolver_counters();
+    EXPECT_EQ(after.entries, 2U);
+    EXPECT_EQ(after.evictions - before.evictions, 1U);
+}
+
+TEST(runtime_resolver_test, resolver_worker_pool_is_bounded) {
+    resolver_settings_guard restore;
+    EXPECT_FALSE(
+        simplenet::runtime::configure_resolver({.workers = 0}).has_value());
+    EXPECT_FALSE(simplenet::runtime::configure_resolver(
+                     {.workers = simplenet::runtime::resolver_max_workers + 1})
+                     .has_value());
+
+    ASSERT_TRUE(
+        simplenet::runtime::configure_resolver({.workers = 4}).has_value());
+    EXPECT_GE(simplenet::runtime::resolver_counters().workers, 4U);
+
+    // Lookups still finish after parking the extra workers again.
+    ASSERT_TRUE(
+        simplenet::runtime::configure_resolver({.workers = 1}).has_value());
+    simplenet::runtime::resolver_cache_clear();
+    simplenet::runtime::event_loop loop;
+    int resolved = 0;
+    auto lookup = [&](int service) -> simplenet::runtime::task<void> {
+        const auto addresses =
+            co_await simplenet::runtime::async_resolve_addresses(
+                "127.0.0.1", std::to_string(service), AF_INET);
+        resolved += addresses.has_value() ? 1 : 0;
+    };
+    for (int index = 0; index < 16; ++index) {
+        loop.spawn(lookup(4200 + index));
+    }
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(resolved, 16);
+}
+
 TEST(runtime_resolver_test, async_resolve_observes_cancellation_before_start) {
     simplenet::runtime::event_loop loop;
     ASSERT_TRUE(loop.valid());
@@ -0,0 +1,331 @@
+#include "simplenet/runtime/cancel.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/task_group.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::task;
+
+task<int> sleep_then(std::chrono::milliseconds delay, int value,
+                     simplenet::runtime::cancel_token token = {}) {
+    const auto slept = co_await simplenet::runtime::async_sleep(delay, token);
+    co_return slept.has_value() ? value : -slept.error().value();
+}
+
+task<void> sleep_void(std::chrono::milliseconds delay, int& woke) {
+    const auto slept = co_await simplenet::runtime::async_sleep(delay);
+    woke = slept.has_value() ? 1 : -1;
+}
+
+// Bumps a counter when the frame holding it is destroyed.
+struct frame_probe {
+    int& destroyed;
+    ~frame_probe() {
+        ++destroyed;
+    }
+};
+
+template <class Loop> void expect_when_all_overlaps_children(Loop& loop) {
+    std::tuple<int, std::monostate, int> values{};
+    int woke = 0;
+    std::chrono::steady_clock::duration elapsed{};
+    auto parent = [&]() -> task<void> {
+        const auto started = std::chrono::steady_clock::now();
+        values = co_await simplenet::runtime::when_all(
+            sleep_then(60ms, 1), sleep_void(60ms, woke), sleep_then(60ms, 3));
+        elapsed = std::chrono::steady_clock::now() - started;
+    };
+    loop.spawn(parent());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(std::get<0>(values), 1);
+    EXPECT_EQ(std::get<2>(values), 3);
+    EXPECT_EQ(woke, 1);
+    EXPECT_GE(elapsed, 60ms);
+    // Run one after another the three sleeps would take 180ms.
+    EXPECT_LT(elapsed, 170ms);
+}
+
+template <class Loop> void expect_when_all_fans_out_a_vector(Loop& loop) {
+    constexpr int kChildren = 20;
+    std::vector<int> values;
+    std::chrono::steady_clock::duration elapsed{};
+    auto parent = [&]() -> task<void> {
+        std::vector<task<int>> calls;
+        for (int index = 0; index < kChildren; ++index) {
+            // Reversed delays: completion order differs from input order.
+            calls.push_back(sleep_then(
+                std::chrono::milliseconds{2 * (kChildren - index)}, index));
+        }
+        const auto started = std::chrono::steady_clock::now();
+        values = co_await simplenet::runtime::when_all(std::move(calls));
+        elapsed = std::chrono::steady_clock::now() - started;
+    };
+    loop.spawn(parent());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_EQ(values.size(), static_cast<std::size_t>(kChildren));
+    for (int index = 0; index < kChildren; ++index) {
+        EXPECT_EQ(values[static_cast<std::size_t>(index)], index);
+    }
+    EXPECT_LT(elapsed, 300ms);
+}
+
+template <class Loop> void expect_when_any_cancels_losers(Loop& loop) {
+    simplenet::runtime::cancel_source losers;
+    simplenet::runtime::when_any_result<int> winner{};
+    std::chrono::steady_clock::duration elapsed{};
+    int loser_value = 0;
+    auto loser = [&]() -> task<int> {
+        loser_value = co_await sleep_then(10s, 2, losers.token());
+        co_return loser_value;
+    };
+    auto parent = [&]() -> task<void> {
+        const auto started = std::chrono::steady_clock::now();
+        winner = co_await simplenet::runtime::when_any(losers, loser(),
+                                                       sleep_then(10ms, 1));
+        elapsed = std::chrono::steady_clock::now() - started;
+    };
+    loop.spawn(parent());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(winner.index, 1U);
+    EXPECT_EQ(winner.value, 1);
+    // The loser finished, cancelled, before `when_any` resumed.
+    EXPECT_EQ(loser_value, -ECANCELED);
+    EXPECT_LT(elapsed, 2s);
+}
+
+template <class Loop> void expect_group_failure_cancels_siblings(Loop& loop) {
+    simplenet::result<void> joined = simplenet::ok();
+    std::vector<int> sibling_errors;
+    int destroyed = 0;
+    std::size_t running_after_failure = 0;
+    std::chrono::steady_clock::duration elapsed{};
+
+    auto sibling = [&](simplenet::runtime::cancel_token token)
+        -> task<simplenet::result<void>> {
+        frame_probe probe{destroyed};
+        const auto slept = co_await simplenet::runtime::async_sleep(10s, token);
+        sibling_errors.push_back(slept.has_value() ? 0 : slept.error().value());
+        co_return slept;
+    };
+    auto failing = [&]() -> task<simplenet::result<void>> {
+        (void)co_await simplenet::runtime::async_sleep(10ms);
+        co_return simplenet::err<void>(simplenet::make_error_from_errno(EPIPE));
+    };
+    auto parent = [&]() -> task<void> {
+        simplenet::runtime::task_group group;
+        const auto started = std::chrono::steady_clock::now();
+        co_await group.spawn(sibling(group.token()));
+        co_await group.spawn(failing());
+        co_await group.spawn(sibling(group.token()));
+        EXPECT_EQ(group.size(), 3U);
+        joined = co_await group.join();
+        elapsed = std::chrono::steady_clock::now() - started;
+        running_after_failure = group.size();
+    };
+    loop.spawn(parent());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(joined.has_value());
+    EXPECT_EQ(joined.error().value(), EPIPE);
+    EXPECT_EQ(sibling_errors, (std::vector<int>{ECANCELED, ECANCELED}));
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_EQ(running_after_failure, 0U);
+    EXPECT_LT(elapsed, 2s);
+}
+
+template <class Loop> void expect_group_frames_free_on_completion(Loop& loop) {
+    int destroyed = 0;
+    int destroyed_while_joining = -1;
+    bool rethrown = false;
+    auto quick = [&]() -> task<void> {
+        frame_probe probe{destroyed};
+        (void)co_await simplenet::runtime::async_sleep(5ms);
+    };
+    auto throwing = [&]() -> task<void> {
+        frame_probe probe{destroyed};
+        (void)co_await simplenet::runtime::async_sleep(30ms);
+        throw std::runtime_error("child failed");
+    };
+    auto watcher = [&]() -> task<void> {
+        (void)co_await simplenet::runtime::async_sleep(20ms);
+        destroyed_while_joining = destroyed;
+    };
+    auto parent = [&]() -> task<void> {
+        simplenet::runtime::task_group group;
+        co_await group.spawn(quick());
+        co_await group.spawn(throwing());
+        co_await group.spawn(watcher());
+        try {
+            (void)co_await group.join();
+        } catch (const std::runtime_error&) {
+            rethrown = true;
+        }
+        // Never started, so nothing to wait for.
+        co_await group.spawn(task<void>{});
+        const auto empty = co_await group.join();
+        EXPECT_TRUE(empty.has_value());
+    };
+    loop.spawn(parent());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    // The quick child's frame was gone while its sibling still ran.
+    EXPECT_EQ(destroyed_while_joining, 1);
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_TRUE(rethrown);
+}
+
+// Stopping the loop mid-join destroys the parent, and with its group the
+// children still parked on timers.
+template <class Loop>
+void expect_teardown_destroys_running_children(std::unique_ptr<Loop> owner) {
+    auto& loop = *owner;
+    int destroyed = 0;
+    auto parked = [&]() -> task<void> {
+        frame_probe probe{destroyed};
+        (void)co_await simplenet::runtime::async_sleep(10s);
+    };
+    auto parent = [&]() -> task<void> {
+        simplenet::runtime::task_group group;
+        co_await group.spawn(parked());
+        co_await group.spawn(parked());
+        (void)co_await group.join();
+    };
+    auto stopper = [&]() -> task<void> {
+        (void)co_await simplenet::runtime::async_sleep(5ms);
+        loop.stop();
+    };
+    loop.spawn(parent());
+    loop.spawn(stopper());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(destroyed, 0);
+    owner.reset();
+    EXPECT_EQ(destroyed, 2);
+}
+
+TEST(runtime_task_group_test, when_all_overlaps_children) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_when_all_overlaps_children(loop);
+}
+
+TEST(runtime_task_group_test, when_all_overlaps_children_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_when_all_overlaps_children(loop);
+}
+
+TEST(runtime_task_group_test, when_all_fans_out_a_vector) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_when_all_fans_out_a_vector(loop);
+}
+
+TEST(runtime_task_group_test, when_all_fans_out_a_vector_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_when_all_fans_out_a_vector(loop);
+}
+
+TEST(runtime_task_group_test, when_any_cancels_losers) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_when_any_cancels_losers(loop);
+}
+
+TEST(runtime_task_group_test, when_any_cancels_losers_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_when_any_cancels_losers(loop);
+}
+
+TEST(runtime_task_group_test, synchronous_winner_skips_remaining_children) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    simplenet::runtime::cancel_source losers;
+    bool second_ran = false;
+    std::size_t index = 99;
+    auto first = []() -> task<void> { co_return; };
+    auto second = [&]() -> task<void> {
+        second_ran = true;
+        co_return;
+    };
+    auto parent = [&]() -> task<void> {
+        std::vector<task<void>> racers;
+        racers.push_back(first());
+        racers.push_back(second());
+        const auto winner =
+            co_await simplenet::runtime::when_any(losers, std::move(racers));
+        index = winner.index;
+    };
+    loop.spawn(parent());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(index, 0U);
+    EXPECT_FALSE(second_ran);
+    EXPECT_TRUE(losers.token().stop_requested());
+}
+
+TEST(runtime_task_group_test, group_failure_cancels_siblings) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_group_failure_cancels_siblings(loop);
+}
+
+TEST(runtime_task_group_test, group_failure_cancels_siblings_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_group_failure_cancels_siblings(loop);
+}
+
+TEST(runtime_task_group_test, group_frames_free_on_completion) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_group_frames_free_on_completion(loop);
+}
+
+TEST(runtime_task_group_test, teardown_destroys_running_children) {
+    auto loop = std::make_unique<simplenet::runtime::event_loop>();
+    ASSERT_TRUE(loop->valid());
+    expect_teardown_destroys_running_children(std::move(loop));
+}
+
+TEST(runtime_task_group_test, teardown_destroys_running_children_on_uring) {
+    auto loop = std::make_unique<simplenet::runtime::uring_event_loop>();
+    if (!loop->valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_teardown_destroys_running_children(std::move(loop));
+}
+
+} // namespace
@@ -3,19 +3,252 @@
 #include "simplenet/runtime/cancel.hpp"
 #include "simplenet/runtime/event_loop.hpp"
 #include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/steady_timer.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
 
 #include <array>
 #include <atomic>
 #include <cerrno>
 #include <chrono>
+#include <cstddef>
+#include <fcntl.h>
 #include <future>
 #include <gtest/gtest.h>
+#include <sys/socket.h>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 namespace {
 
 using namespace std::chrono_literals;
 
+struct timed_wait_outcome {
+    std::chrono::milliseconds timeout{};
+    std::chrono::milliseconds elapsed{};
+    int error_code{-1};
+};
+
+// Arms many timed readable waits at once; every third pipe is already
+// readable, the rest must time out no earlier than their own deadline.
+template <class Loop>
+void expect_many_timed_waiters_resolve_independently(Loop& loop) {
+    constexpr std::size_t kWaiters = 48;
+    std::vector<simplenet::unique_fd> read_ends;
+    std::vector<simplenet::unique_fd> write_ends;
+    for (std::size_t i = 0; i < kWaiters; ++i) {
+        std::array<int, 2> fds{};
+        ASSERT_EQ(::pipe2(fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+        read_ends.emplace_back(fds[0]);
+        write_ends.emplace_back(fds[1]);
+        if (i % 3 == 0) {
+            const char byte = 'x';
+            ASSERT_EQ(::write(fds[1], &byte, 1), 1);
+        }
+    }
+
+    std::vector<timed_wait_outcome> outcomes(kWaiters);
+    std::vector<std::size_t> timeout_order;
+    const auto started = std::chrono::steady_clock::now();
+
+    auto waiter = [&](std::size_t index) -> simplenet::runtime::task<void> {
+        auto& outcome = outcomes[index];
+        outcome.timeout = 20ms + std::chrono::milliseconds{(index % 6) * 10};
+        const auto wait_result = co_await simplenet::runtime::wait_readable_for(
+            read_ends[index].get(), outcome.timeout);
+        outcome.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started);
+        outcome.error_code = wait_result.has_value() ? 0 : wait_result.error().value();
+        if (!wait_result.has_value()) {
+            timeout_order.push_back(index);
+        }
+    };
+    for (std::size_t i = 0; i < kWaiters; ++i) {
+        loop.spawn(waiter(i));
+    }
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+
+    for (std::size_t i = 0; i < kWaiters; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_EQ(outcomes[i].error_code, 0) << "waiter " << i;
+        } else {
+            EXPECT_EQ(outcomes[i].error_code, ETIMEDOUT) << "waiter " << i;
+            EXPECT_GE(outcomes[i].elapsed, outcomes[i].timeout) << "waiter " << i;
+        }
+    }
+
+    ASSERT_EQ(timeout_order.size(), kWaiters - kWaiters / 3);
+    for (std::size_t i = 1; i < timeout_order.size(); ++i) {
+        EXPECT_LE(outcomes[timeout_order[i - 1]].timeout,
+                  outcomes[timeout_order[i]].timeout);
+    }
+}
+
+// Sleepers used to share one timerfd, so a second concurrent sleep hit EBUSY.
+template <class Loop> void expect_concurrent_sleepers_all_complete(Loop& loop) {
+    constexpr std::size_t kSleepers = 32;
+    std::vector<int> error_codes(kSleepers, -1);
+    std::vector<std::chrono::milliseconds> elapsed(kSleepers);
+    const auto started = std::chrono::steady_clock::now();
+
+    auto sleeper = [&](std::size_t index) -> simplenet::runtime::task<void> {
+        const auto duration = 5ms + std::chrono::milliseconds{index % 4 * 10};
+        const auto sleep_result =
+            co_await simplenet::runtime::async_sleep(duration);
+        elapsed[index] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started);
+        error_codes[index] =
+            sleep_result.has_value() ? 0 : sleep_result.error().value();
+        if (elapsed[index] < duration) {
+            error_codes[index] = EINVAL;
+        }
+    };
+    for (std::size_t i = 0; i < kSleepers; ++i) {
+        loop.spawn(sleeper(i));
+    }
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    for (std::size_t i = 0; i < kSleepers; ++i) {
+        EXPECT_EQ(error_codes[i], 0) << "sleeper " << i;
+    }
+}
+
+template <class Loop> void expect_steady_timer_cancel_wakes_waiter(Loop& loop) {
+    simplenet::runtime::steady_timer timer{10s};
+    std::promise<simplenet::result<void>> wait_promise;
+    auto wait_future = wait_promise.get_future();
+    simplenet::result<void> second_wait = simplenet::ok();
+    std::size_t cancelled = 0;
+    const auto started = std::chrono::steady_clock::now();
+
+    auto waiter = [&]() -> simplenet::runtime::task<void> {
+        wait_promise.set_value(co_await timer.wait());
+    };
+    auto canceller = [&]() -> simplenet::runtime::task<void> {
+        second_wait = co_await timer.wait();
+        const auto sleep_result = co_await simplenet::runtime::async_sleep(20ms);
+        (void)sleep_result;
+        cancelled = timer.cancel();
+    };
+    loop.spawn(waiter());
+    loop.spawn(canceller());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+
+    EXPECT_EQ(cancelled, 1U);
+    ASSERT_FALSE(second_wait.has_value());
+    EXPECT_EQ(second_wait.error().value(), EBUSY);
+
+    const auto wait_result = wait_future.get();
+    ASSERT_FALSE(wait_result.has_value());
+    EXPECT_EQ(wait_result.error().value(), ECANCELED);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 2s);
+    EXPECT_FALSE(timer.waiting());
+}
+
+// Stopping with a sleeper still armed destroys its frame in the loop
+// destructor; the timer must be disarmed without touching freed memory.
+template <class Loop> void expect_stop_with_pending_sleep_is_clean(Loop& loop) {
+    auto sleeper = []() -> simplenet::runtime::task<void> {
+        const auto sleep_result = co_await simplenet::runtime::async_sleep(10s);
+        (void)sleep_result;
+    };
+    auto stopper = [&]() -> simplenet::runtime::task<void> {
+        const auto sleep_result = co_await simplenet::runtime::async_sleep(5ms);
+        (void)sleep_result;
+        loop.stop();
+    };
+    loop.spawn(sleeper());
+    loop.spawn(stopper());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+}
+
+// A read parked with a far deadline must be dequeued as soon as another
+// thread stops its token, leaving the descriptor free for the next wait.
+template <class Loop>
+void expect_cross_thread_stop_wakes_read_waiter(Loop& loop) {
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, fds.data()),
+              0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    simplenet::unique_fd peer{fds[1]};
+
+    simplenet::runtime::cancel_source source;
+    std::array<std::byte, 16> buffer{};
+    int cancelled_error = 0;
+    std::chrono::steady_clock::duration cancel_latency{};
+    simplenet::result<std::size_t> second_read = simplenet::ok(std::size_t{0});
+
+    auto reader = [&]() -> simplenet::runtime::task<void> {
+        const auto started = std::chrono::steady_clock::now();
+        const auto first = co_await simplenet::runtime::async_read_some_until(
+            stream, buffer, started + 10s, source.token());
+        cancel_latency = std::chrono::steady_clock::now() - started;
+        cancelled_error = first.has_value() ? 0 : first.error().value();
+
+        const std::byte byte{0x5A};
+        EXPECT_EQ(::write(peer.get(), &byte, 1), 1);
+        second_read = co_await simplenet::runtime::async_read_some_until(
+            stream, buffer, std::chrono::steady_clock::now() + 2s);
+    };
+    loop.spawn(reader());
+
+    std::thread canceller([&]() {
+        std::this_thread::sleep_for(30ms);
+        EXPECT_TRUE(source.request_stop());
+    });
+    const auto run_result = loop.run();
+    canceller.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(cancelled_error, ECANCELED);
+    EXPECT_LT(cancel_latency, 1s);
+    ASSERT_TRUE(second_read.has_value()) << second_read.error().message();
+    EXPECT_EQ(second_read.value(), 1U);
+}
+
+// Stopping a token from another coroutine on the same loop wakes both a
+// steady_timer wait and an async_sleep without waiting out their expiry.
+template <class Loop> void expect_in_loop_stop_wakes_timers(Loop& loop) {
+    simplenet::runtime::cancel_source source;
+    simplenet::runtime::steady_timer timer{10s};
+    int timer_error = 0;
+    int sleep_error = 0;
+    const auto started = std::chrono::steady_clock::now();
+
+    auto timer_waiter = [&]() -> simplenet::runtime::task<void> {
+        const auto wait_result = co_await timer.wait(source.token());
+        timer_error = wait_result.has_value() ? 0 : wait_result.error().value();
+    };
+    auto sleeper = [&]() -> simplenet::runtime::task<void> {
+        const auto sleep_result =
+            co_await simplenet::runtime::async_sleep(10s, source.token());
+        sleep_error = sleep_result.has_value() ? 0 : sleep_result.error().value();
+    };
+    auto stopper = [&]() -> simplenet::runtime::task<void> {
+        const auto sleep_result = co_await simplenet::runtime::async_sleep(10ms);
+        (void)sleep_result;
+        source.request_stop();
+    };
+    loop.spawn(timer_waiter());
+    loop.spawn(sleeper());
+    loop.spawn(stopper());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(timer_error, ECANCELED);
+    EXPECT_EQ(sleep_error, ECANCELED);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 1s);
+    EXPECT_FALSE(timer.waiting());
+}
+
 TEST(runtime_timers_test, async_sleep_completes_after_requested_duration) {
     simplenet::runtime::event_loop loop;
     ASSERT_TRUE(loop.valid());
@@ -141,4 +374,196 @@ TEST(runtime_timers_test, read_with_timeout_returns_timed_out_error) {
     EXPECT_EQ(read_result.error().value(), ETIMEDOUT);
 }
 
+TEST(runtime_timers_test, concurrent_sleepers_all_complete) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_concurrent_sleepers_all_complete(loop);
+}
+
+TEST(runtime_timers_test, concurrent_sleepers_all_complete_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    expect_concurrent_sleepers_all_complete(loop);
+}
+
+TEST(runtime_timers_test, steady_timer_cancel_wakes_waiter) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_steady_timer_cancel_wakes_waiter(loop);
+}
+
+TEST(runtime_timers_test, steady_timer_cancel_wakes_waiter_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    expect_steady_timer_cancel_wakes_waiter(loop);
+}
+
+TEST(runtime_timers_test, stop_with_pending_sleep_is_clean) {
+    {
+        simplenet::runtime::event_loop loop;
+        ASSERT_TRUE(loop.valid());
+        expect_stop_with_pending_sleep_is_clean(loop);
+    }
+    simplenet::runtime::uring_event_loop uring_loop;
+    if (uring_loop.valid()) {
+        expect_stop_with_pending_sleep_is_clean(uring_loop);
+    }
+}
+
+TEST(runtime_timers_test, steady_timer_with_past_expiry_completes_immediately) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    simplenet::runtime::steady_timer timer;
+    simplenet::result<void> wait_result =
+        simplenet::err<void>(simplenet::make_error_from_errno(EINVAL));
+    auto waiter = [&]() -> simplenet::runtime::task<void> {
+        wait_result = co_await timer.wait();
+    };
+    loop.spawn(waiter());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_TRUE(wait_result.has_value());
+}
+
+TEST(runtime_timers_test, many_timed_waiters_resolve_independently) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_many_timed_waiters_resolve_independently(loop);
+}
+
+TEST(runtime_timers_test, many_timed_waiters_resolve_independently_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    expect_many_timed_waiters_resolve_independently(loop);
+}
+
+TEST(runtime_timers_test, cross_thread_stop_wakes_read_waiter) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_cross_thread_stop_wakes_read_waiter(loop);
+}
+
+TEST(runtime_timers_test, cross_thread_stop_wakes_read_waiter_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    expect_cross_thread_stop_wakes_read_waiter(loop);
+}
+
+TEST(runtime_timers_test, in_loop_stop_wakes_timers) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_in_loop_stop_wakes_timers(loop);
+}
+
+TEST(runtime_timers_test, in_loop_stop_wakes_timers_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    expect_in_loop_stop_wakes_timers(loop);
+}
+
+TEST(runtime_timers_test, busy_poll_spin_shrinks_while_idle) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    loop.set_busy_poll(2ms);
+    EXPECT_EQ(loop.stats().spin_budget, 2ms);
+
+    const auto kernel = loop.set_kernel_busy_poll(0us);
+    if (!kernel.has_value()) {
+        EXPECT_TRUE(kernel.error().value() == ENOTTY ||
+                    kernel.error().value() == EINVAL)
+            << kernel.error().message();
+    }
+
+    std::chrono::steady_clock::duration slept{};
+    auto sleeper = [&]() -> simplenet::runtime::task<void> {
+        const auto started = std::chrono::steady_clock::now();
+        for (int round = 0; round < 5; ++round) {
+            EXPECT_TRUE((co_await simplenet::runtime::async_sleep(10ms))
+                            .has_value());
+        }
+        slept = std::chrono::steady_clock::now() - started;
+    };
+    loop.spawn(sleeper());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_GE(slept, 50ms);
+
+    const auto stats = loop.stats();
+    EXPECT_GE(stats.iterations, 5U);
+    EXPECT_GE(stats.blocking_waits, 5U);
+    EXPECT_GT(stats.spin_polls, 0U);
+    EXPECT_GT(stats.spin_time.count(), 0);
+    // Nothing arrives while spinning, so the budget decays to its floor.
+    EXPECT_LT(stats.spin_budget, 2ms);
+    EXPECT_GE(stats.spin_budget, 125us);
+}
+
+TEST(runtime_timers_test, busy_poll_spin_catches_prompt_replies) {
+    std::array<int, 2> fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()),
+              0);
+    ASSERT_EQ(::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK),
+              0);
+    simplenet::nonblocking::tcp_stream stream{simplenet::unique_fd{fds[0]}};
+    simplenet::unique_fd peer{fds[1]};
+    EXPECT_TRUE(stream.set_busy_poll(0us).has_value());
+    const auto negative = stream.set_busy_poll(-1us);
+    ASSERT_FALSE(negative.has_value());
+    EXPECT_EQ(negative.error().value(), EINVAL);
+
+    std::thread echo([&]() {
+        std::byte byte{};
+        while (::read(peer.get(), &byte, 1) == 1) {
+            if (::write(peer.get(), &byte, 1) != 1) {
+                break;
+            }
+        }
+    });
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    loop.set_busy_poll(5ms);
+
+    constexpr int kRounds = 50;
+    int echoed = 0;
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        std::array<std::byte, 1> buffer{std::byte{0x42}};
+        for (int round = 0; round < kRounds; ++round) {
+            if (::write(stream.native_handle(), buffer.data(), 1) != 1) {
+                break;
+            }
+            const auto got =
+                co_await simplenet::runtime::async_read_some(stream, buffer);
+            if (!got.has_value() || got.value() != 1U) {
+                break;
+            }
+            ++echoed;
+        }
+    };
+    loop.spawn(client());
+
+    const auto run_result = loop.run();
+    EXPECT_TRUE(stream.shutdown_write().has_value());
+    echo.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(echoed, kRounds);
+    const auto stats = loop.stats();
+    EXPECT_GT(stats.spin_hits, 0U);
+    EXPECT_LE(stats.spin_hits, stats.iterations);
+}
+
 } // namespace
@@ -0,0 +1,324 @@
+#include "simplenet/nonblocking/udp.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using simplenet::nonblocking::endpoint;
+using simplenet::nonblocking::socket_address;
+using simplenet::nonblocking::udp_coalesced;
+using simplenet::nonblocking::udp_message;
+using simplenet::nonblocking::udp_outgoing;
+using simplenet::nonblocking::udp_segments;
+using simplenet::nonblocking::udp_socket;
+
+udp_socket bind_loopback() {
+    auto bound = udp_socket::bind(endpoint::loopback(0));
+    EXPECT_TRUE(bound.has_value()) << bound.error().message();
+    return bound.has_value() ? std::move(bound.value()) : udp_socket{};
+}
+
+socket_address address_of(const udp_socket& socket) {
+    auto address = socket.local_address();
+    EXPECT_TRUE(address.has_value()) << address.error().message();
+    return address.value_or(socket_address{});
+}
+
+std::array<std::byte, 4> payload_for(std::size_t index) {
+    return {std::byte{0xAB}, static_cast<std::byte>(index),
+            static_cast<std::byte>(index >> 8U), std::byte{0xCD}};
+}
+
+// Ten 100-byte segments, each starting with its index.
+constexpr std::size_t kSegmentSize = 100;
+constexpr std::size_t kSegments = 10;
+
+std::vector<std::byte> segmented_payload() {
+    std::vector<std::byte> payload(kSegmentSize * kSegments);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<std::byte>(i / kSegmentSize);
+    }
+    return payload;
+}
+
+bool offload_unsupported(const simplenet::error& failure) {
+    return failure.value() == EIO || failure.value() == ENOPROTOOPT ||
+           failure.value() == EOPNOTSUPP;
+}
+
+// A receiver drains a burst through `async_recv_batch` while the sender
+// pushes it with `async_send_batch`, then answers with `async_send_to`.
+template <class Loop>
+void expect_async_batches_round_trip(Loop& loop) {
+    constexpr std::size_t kDatagrams = 200;
+    auto receiver = bind_loopback();
+    auto sender = bind_loopback();
+    ASSERT_TRUE(receiver.valid());
+    ASSERT_TRUE(sender.valid());
+    const auto receiver_address = address_of(receiver);
+    const auto sender_address = address_of(sender);
+
+    std::vector<std::array<std::byte, 4>> payloads;
+    std::vector<udp_outgoing> outgoing;
+    for (std::size_t i = 0; i < kDatagrams; ++i) {
+        payloads.push_back(payload_for(i));
+    }
+    for (const auto& payload : payloads) {
+        outgoing.push_back(udp_outgoing{.payload = payload, .to = receiver_address});
+    }
+
+    std::size_t received = 0;
+    std::size_t batches = 0;
+    bool senders_match = true;
+    simplenet::result<std::size_t> pushed = simplenet::ok(std::size_t{0});
+    simplenet::result<simplenet::nonblocking::udp_datagram> reply =
+        simplenet::ok(simplenet::nonblocking::udp_datagram{});
+
+    auto receive = [&]() -> simplenet::runtime::task<void> {
+        std::vector<std::array<std::byte, 16>> storage(64);
+        std::vector<udp_message> slots;
+        for (auto& bytes : storage) {
+            slots.push_back(udp_message{.buffer = bytes});
+        }
+        while (received < kDatagrams) {
+            const auto got =
+                co_await simplenet::runtime::async_recv_batch(receiver, slots);
+            if (!got.has_value()) {
+                ADD_FAILURE() << got.error().message();
+                co_return;
+            }
+            ++batches;
+            for (std::size_t i = 0; i < got.value(); ++i) {
+                senders_match = senders_match && slots[i].size == 4U &&
+                                slots[i].from == sender_address;
+            }
+            received += got.value();
+        }
+        const std::array<std::byte, 2> ack{std::byte{'o'}, std::byte{'k'}};
+        const auto acked = co_await simplenet::runtime::async_send_to(
+            receiver, ack, sender_address);
+        EXPECT_TRUE(acked.has_value() && acked.value() == ack.size());
+    };
+    auto send = [&]() -> simplenet::runtime::task<void> {
+        pushed = co_await simplenet::runtime::async_send_batch(sender, outgoing);
+        std::array<std::byte, 8> buffer{};
+        reply = co_await simplenet::runtime::async_recv_from(sender, buffer);
+    };
+    loop.spawn(receive());
+    loop.spawn(send());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(pushed.has_value()) << pushed.error().message();
+    EXPECT_EQ(pushed.value(), kDatagrams);
+    EXPECT_EQ(received, kDatagrams);
+    EXPECT_LT(batches, kDatagrams);
+    EXPECT_TRUE(senders_match);
+    ASSERT_TRUE(reply.has_value()) << reply.error().message();
+    EXPECT_EQ(reply.value().size, 2U);
+    EXPECT_EQ(reply.value().from, receiver_address);
+}
+
+TEST(runtime_udp_test, socket_address_round_trips_endpoints) {
+    const auto address = socket_address::from_endpoint(endpoint::loopback(4242));
+    ASSERT_TRUE(address.has_value()) << address.error().message();
+    EXPECT_EQ(address.value().port(), 4242U);
+
+    const auto formatted = address.value().to_endpoint();
+    ASSERT_TRUE(formatted.has_value()) << formatted.error().message();
+    EXPECT_EQ(formatted.value().host, "127.0.0.1");
+    EXPECT_EQ(formatted.value().port, 4242U);
+
+    const auto invalid =
+        socket_address::from_endpoint(endpoint{.host = "localhost", .port = 1});
+    ASSERT_FALSE(invalid.has_value());
+    EXPECT_EQ(invalid.error().value(), EINVAL);
+}
+
+TEST(runtime_udp_test, recv_from_reports_binary_sender_and_would_block) {
+    auto receiver = bind_loopback();
+    auto sender = bind_loopback();
+
+    std::array<std::byte, 8> buffer{};
+    const auto empty = receiver.recv_from(buffer);
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_TRUE(simplenet::nonblocking::is_would_block(empty.error()));
+
+    const std::array<std::byte, 12> payload{};
+    const auto sent = sender.send_to(payload, address_of(receiver));
+    ASSERT_TRUE(sent.has_value()) << sent.error().message();
+    EXPECT_EQ(sent.value(), payload.size());
+
+    const auto got = receiver.recv_from(buffer);
+    ASSERT_TRUE(got.has_value()) << got.error().message();
+    EXPECT_EQ(got.value().size, buffer.size());
+    EXPECT_TRUE(got.value().truncated);
+    EXPECT_EQ(got.value().from, address_of(sender));
+}
+
+TEST(runtime_udp_test, batches_move_many_datagrams_per_call) {
+    constexpr std::size_t kDatagrams = 32;
+    auto receiver = bind_loopback();
+    auto sender = bind_loopback();
+    const auto to = address_of(receiver);
+
+    std::vector<std::array<std::byte, 4>> payloads;
+    std::vector<udp_outgoing> outgoing;
+    for (std::size_t i = 0; i < kDatagrams; ++i) {
+        payloads.push_back(payload_for(i));
+    }
+    for (const auto& payload : payloads) {
+        outgoing.push_back(udp_outgoing{.payload = payload, .to = to});
+    }
+    const auto sent = sender.send_batch(outgoing);
+    ASSERT_TRUE(sent.has_value()) << sent.error().message();
+    EXPECT_EQ(sent.value(), kDatagrams);
+
+    std::vector<std::array<std::byte, 4>> storage(kDatagrams * 2);
+    std::vector<udp_message> slots;
+    for (auto& bytes : storage) {
+        slots.push_back(udp_message{.buffer = bytes});
+    }
+    const auto got = receiver.recv_batch(slots);
+    ASSERT_TRUE(got.has_value()) << got.error().message();
+    ASSERT_EQ(got.value(), kDatagrams);
+    for (std::size_t i = 0; i < kDatagrams; ++i) {
+        EXPECT_EQ(slots[i].size, 4U);
+        EXPECT_FALSE(slots[i].truncated);
+        EXPECT_EQ(slots[i].from, address_of(sender));
+        EXPECT_EQ(storage[i], payloads[i]);
+    }
+
+    const auto drained = receiver.recv_batch(slots);
+    ASSERT_FALSE(drained.has_value());
+    EXPECT_TRUE(simplenet::nonblocking::is_would_block(drained.error()));
+}
+
+TEST(runtime_udp_test, segments_split_coalesced_bytes) {
+    const std::array<std::byte, 250> bytes{};
+    const udp_segments segments{bytes, 100};
+    EXPECT_EQ(segments.size(), 3U);
+
+    std::vector<std::size_t> sizes;
+    for (const auto segment : segments) {
+        sizes.push_back(segment.size());
+    }
+    EXPECT_EQ(sizes, (std::vector<std::size_t>{100, 100, 50}));
+
+    const udp_segments whole{bytes, 0};
+    EXPECT_EQ(whole.size(), 1U);
+    EXPECT_EQ((*whole.begin()).size(), bytes.size());
+    EXPECT_EQ(udp_segments{}.size(), 0U);
+    EXPECT_EQ(udp_segments{}.begin(), udp_segments{}.end());
+}
+
+TEST(runtime_udp_test, segmented_send_arrives_as_separate_datagrams) {
+    auto receiver = bind_loopback();
+    auto sender = bind_loopback();
+    const auto payload = segmented_payload();
+
+    const auto too_many = sender.send_segmented(payload, address_of(receiver), 10);
+    ASSERT_FALSE(too_many.has_value());
+    EXPECT_EQ(too_many.error().value(), EINVAL);
+
+    const auto sent = sender.send_segmented(payload, address_of(receiver),
+                                            static_cast<std::uint16_t>(kSegmentSize));
+    if (!sent.has_value() && offload_unsupported(sent.error())) {
+        GTEST_SKIP() << "UDP_SEGMENT unsupported: " << sent.error().message();
+    }
+    ASSERT_TRUE(sent.has_value()) << sent.error().message();
+    EXPECT_EQ(sent.value(), payload.size());
+
+    std::vector<std::array<std::byte, 256>> storage(kSegments * 2);
+    std::vector<udp_message> slots;
+    for (auto& bytes : storage) {
+        slots.push_back(udp_message{.buffer = bytes});
+    }
+    const auto got = receiver.recv_batch(slots);
+    ASSERT_TRUE(got.has_value()) << got.error().message();
+    ASSERT_EQ(got.value(), kSegments);
+    for (std::size_t i = 0; i < kSegments; ++i) {
+        EXPECT_EQ(slots[i].size, kSegmentSize);
+        EXPECT_EQ(storage[i][0], static_cast<std::byte>(i));
+    }
+}
+
+TEST(runtime_udp_test, gro_receive_splits_back_into_segments) {
+    auto receiver = bind_loopback();
+    auto sender = bind_loopback();
+    const auto gro = receiver.enable_gro();
+    if (!gro.has_value() && offload_unsupported(gro.error())) {
+        GTEST_SKIP() << "UDP_GRO unsupported: " << gro.error().message();
+    }
+    ASSERT_TRUE(gro.has_value()) << gro.error().message();
+
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    const auto payload = segmented_payload();
+    const auto to = address_of(receiver);
+
+    simplenet::result<std::size_t> sent = simplenet::ok(std::size_t{0});
+    std::vector<std::size_t> segment_sizes;
+    std::vector<std::byte> leading_bytes;
+    std::size_t receives = 0;
+
+    auto receive = [&]() -> simplenet::runtime::task<void> {
+        std::vector<std::byte> buffer(64 * 1024);
+        while (segment_sizes.size() < kSegments) {
+            const auto got =
+                co_await simplenet::runtime::async_recv_coalesced(receiver, buffer);
+            if (!got.has_value()) {
+                ADD_FAILURE() << got.error().message();
+                co_return;
+            }
+            ++receives;
+            EXPECT_FALSE(got.value().truncated);
+            EXPECT_EQ(got.value().from, address_of(sender));
+            for (const auto segment : got.value().segments()) {
+                segment_sizes.push_back(segment.size());
+                leading_bytes.push_back(segment.front());
+            }
+        }
+    };
+    auto send = [&]() -> simplenet::runtime::task<void> {
+        sent = co_await simplenet::runtime::async_send_segmented(
+            sender, payload, to, static_cast<std::uint16_t>(kSegmentSize));
+    };
+    loop.spawn(receive());
+    loop.spawn(send());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    if (!sent.has_value() && offload_unsupported(sent.error())) {
+        GTEST_SKIP() << "UDP_SEGMENT unsupported: " << sent.error().message();
+    }
+    ASSERT_TRUE(sent.has_value()) << sent.error().message();
+    EXPECT_EQ(segment_sizes, std::vector<std::size_t>(kSegments, kSegmentSize));
+    for (std::size_t i = 0; i < leading_bytes.size(); ++i) {
+        EXPECT_EQ(leading_bytes[i], static_cast<std::byte>(i));
+    }
+    EXPECT_LE(receives, kSegments);
+}
+
+TEST(runtime_udp_test, async_batches_round_trip) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_async_batches_round_trip(loop);
+}
+
+TEST(runtime_udp_test, async_batches_round_trip_on_uring) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    expect_async_batches_round_trip(loop);
+}
+
+} // namespace
@@ -1,6 +1,9 @@
 #include "simplenet/blocking/tcp.hpp"
 #include "simplenet/nonblocking/tcp.hpp"
+#include "simplenet/runtime/acceptor.hpp"
+#include "simplenet/runtime/cancel.hpp"
 #include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/receiver.hpp"
 #include "simplenet/runtime/uring_event_loop.hpp"
 
 #include <array>
@@ -11,6 +14,7 @@
 #include <fcntl.h>
 #include <future>
 #include <gtest/gtest.h>
+#include <stdexcept>
 #include <thread>
 #include <unistd.h>
 #include <vector>
@@ -19,6 +23,15 @@ namespace {
 
 using namespace std::chrono_literals;
 
+TEST(runtime_uring_test, poll_batch_is_configurable) {
+    simplenet::runtime::uring_event_loop loop;
+    EXPECT_EQ(loop.poll_batch(), 64U);
+    loop.set_poll_batch(0);
+    EXPECT_EQ(loop.poll_batch(), 1U);
+    loop.set_poll_batch(512, 256);
+    EXPECT_EQ(loop.poll_batch(), 512U);
+}
+
 TEST(runtime_uring_test, wait_readable_suspends_and_resumes) {
     simplenet::runtime::uring_event_loop loop;
     if (!loop.valid()) {
@@ -241,4 +254,444 @@ TEST(runtime_uring_test, read_with_timeout_returns_timed_out_error) {
     EXPECT_EQ(read_result.error().value(), ETIMEDOUT);
 }
 
+TEST(runtime_uring_test, timed_wait_expires_without_timer_wheel_entry) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    const simplenet::unique_fd read_end{pipe_fds[0]};
+    const simplenet::unique_fd write_end{pipe_fds[1]};
+
+    simplenet::result<void> waited{simplenet::ok()};
+    std::uint64_t timed_during_wait = 99;
+    auto waiter = [&]() -> simplenet::runtime::task<void> {
+        waited = co_await simplenet::runtime::wait_readable_for(read_end.get(), 40ms);
+    };
+    auto sampler = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(10ms);
+        timed_during_wait = loop.metrics().timed_waiters;
+    };
+    loop.spawn(waiter());
+    loop.spawn(sampler());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(waited.has_value());
+    EXPECT_EQ(waited.error().value(), ETIMEDOUT);
+    if constexpr (simplenet::runtime::metrics_enabled) {
+        EXPECT_EQ(timed_during_wait, loop.uses_linked_timeouts() ? 0U : 1U);
+    }
+}
+
+TEST(runtime_uring_test, timed_wait_completes_or_cancels_before_deadline) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    const simplenet::unique_fd read_end{pipe_fds[0]};
+    const simplenet::unique_fd write_end{pipe_fds[1]};
+
+    simplenet::runtime::cancel_source stop;
+    simplenet::result<void> readable{
+        simplenet::err<void>(simplenet::make_error_from_errno(EINPROGRESS))};
+    simplenet::result<void> cancelled{simplenet::ok()};
+    auto waiter = [&]() -> simplenet::runtime::task<void> {
+        readable = co_await simplenet::runtime::wait_readable_for(read_end.get(), 5s);
+        std::array<std::byte, 1> drained{};
+        (void)::read(read_end.get(), drained.data(), drained.size());
+        cancelled = co_await simplenet::runtime::wait_readable_until(
+            read_end.get(), std::chrono::steady_clock::now() + 5s, stop.token());
+    };
+    auto driver = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(10ms);
+        constexpr std::array<std::byte, 1> marker{std::byte{0x7}};
+        (void)::write(write_end.get(), marker.data(), marker.size());
+        (void)co_await simplenet::runtime::async_sleep(10ms);
+        stop.request_stop();
+    };
+    loop.spawn(waiter());
+    loop.spawn(driver());
+
+    // Neither 5s deadline may hold the loop once its wait is over.
+    const auto start = std::chrono::steady_clock::now();
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 2s);
+    EXPECT_TRUE(readable.has_value()) << readable.error().message();
+    ASSERT_FALSE(cancelled.has_value());
+    EXPECT_EQ(cancelled.error().value(), ECANCELED);
+}
+
+TEST(runtime_uring_test, completion_mode_connect_accept_echo_round_trip) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+    ASSERT_TRUE(loop.supports_completion_io());
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 16);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    constexpr std::array<std::byte, 5> payload{
+        std::byte{'h'}, std::byte{'e'}, std::byte{'l'}, std::byte{'l'},
+        std::byte{'o'}};
+    simplenet::result<void> server_status = simplenet::ok();
+    simplenet::result<void> client_status =
+        simplenet::err<void>(simplenet::make_error_from_errno(EINPROGRESS));
+
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+
+        auto peer = std::move(accept_result.value());
+        std::array<std::byte, payload.size()> inbound{};
+        auto read_status = co_await simplenet::runtime::async_read_exact(
+            peer, std::span<std::byte>{inbound});
+        if (!read_status.has_value()) {
+            server_status = read_status;
+            co_return;
+        }
+
+        server_status = co_await simplenet::runtime::async_write_all(
+            peer, std::span<const std::byte>{inbound});
+    };
+
+    auto client = [&](std::uint16_t port) -> simplenet::runtime::task<void> {
+        auto connect_result = co_await simplenet::runtime::async_connect(
+            simplenet::nonblocking::endpoint::loopback(port));
+        if (!connect_result.has_value()) {
+            client_status = simplenet::err<void>(connect_result.error());
+            co_return;
+        }
+
+        auto stream = std::move(connect_result.value());
+        auto write_status = co_await simplenet::runtime::async_write_all(
+            stream, std::span<const std::byte>{payload});
+        if (!write_status.has_value()) {
+            client_status = write_status;
+            co_return;
+        }
+
+        std::array<std::byte, payload.size()> echoed{};
+        auto read_status = co_await simplenet::runtime::async_read_exact(
+            stream, std::span<std::byte>{echoed});
+        if (!read_status.has_value()) {
+            client_status = read_status;
+            co_return;
+        }
+
+        client_status = echoed == payload
+                            ? simplenet::ok()
+                            : simplenet::err<void>(
+                                  simplenet::make_error_from_errno(EBADMSG));
+    };
+
+    loop.spawn(server());
+    loop.spawn(client(port_result.value()));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    ASSERT_TRUE(client_status.has_value()) << client_status.error().message();
+}
+
+TEST(runtime_uring_test, completion_mode_connect_reports_refused_port) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+
+    std::uint16_t closed_port = 0;
+    {
+        auto probe = simplenet::nonblocking::tcp_listener::bind(
+            simplenet::nonblocking::endpoint::loopback(0), 1);
+        ASSERT_TRUE(probe.has_value()) << probe.error().message();
+        auto port_result = probe.value().local_port();
+        ASSERT_TRUE(port_result.has_value());
+        closed_port = port_result.value();
+    }
+
+    simplenet::result<void> status = simplenet::ok();
+    auto client = [&]() -> simplenet::runtime::task<void> {
+        auto connect_result = co_await simplenet::runtime::async_connect(
+            simplenet::nonblocking::endpoint::loopback(closed_port));
+        status = connect_result.has_value()
+                     ? simplenet::ok()
+                     : simplenet::err<void>(connect_result.error());
+    };
+    loop.spawn(client());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().value(), ECONNREFUSED);
+}
+
+TEST(runtime_uring_test, multishot_acceptor_streams_connection_burst) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 64);
+    ASSERT_TRUE(listener_result.has_value())
+        << listener_result.error().message();
+    auto listener = std::move(listener_result.value());
+
+    auto port_result = listener.local_port();
+    ASSERT_TRUE(port_result.has_value()) << port_result.error().message();
+
+    constexpr std::size_t connection_count = 8;
+    std::size_t accepted = 0;
+    bool stayed_armed = true;
+    simplenet::result<void> server_status = simplenet::ok();
+
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        simplenet::runtime::multishot_acceptor acceptor{listener};
+        for (std::size_t i = 0; i < connection_count; ++i) {
+            auto accept_result = co_await acceptor.accept();
+            if (!accept_result.has_value()) {
+                server_status = simplenet::err<void>(accept_result.error());
+                co_return;
+            }
+            if (!accept_result.value().valid()) {
+                server_status =
+                    simplenet::err<void>(simplenet::make_error_from_errno(EBADF));
+                co_return;
+            }
+            ++accepted;
+            stayed_armed = stayed_armed && acceptor.multishot_active();
+        }
+    };
+    loop.spawn(server());
+
+    std::thread client_thread([port = port_result.value()]() {
+        std::vector<simplenet::blocking::tcp_stream> clients;
+        for (std::size_t i = 0; i < connection_count; ++i) {
+            auto client = simplenet::blocking::tcp_stream::connect(
+                simplenet::blocking::endpoint::loopback(port));
+            if (client.has_value()) {
+                clients.push_back(std::move(client.value()));
+            }
+        }
+        std::this_thread::sleep_for(50ms);
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    ASSERT_TRUE(server_status.has_value()) << server_status.error().message();
+    EXPECT_EQ(accepted, connection_count);
+    EXPECT_TRUE(stayed_armed);
+}
+
+simplenet::result<void>
+receive_stream_holding_buffers(simplenet::runtime::uring_event_loop& loop,
+                               std::size_t payload_size,
+                               bool hold_buffers) {
+    auto listener_result = simplenet::nonblocking::tcp_listener::bind(
+        simplenet::nonblocking::endpoint::loopback(0), 4);
+    if (!listener_result.has_value()) {
+        return simplenet::err<void>(listener_result.error());
+    }
+    auto listener = std::move(listener_result.value());
+    auto port_result = listener.local_port();
+    if (!port_result.has_value()) {
+        return simplenet::err<void>(port_result.error());
+    }
+
+    std::vector<std::byte> outbound(payload_size);
+    for (std::size_t i = 0; i < outbound.size(); ++i) {
+        outbound[i] = static_cast<std::byte>((i * 13U) % 251U);
+    }
+
+    std::vector<std::byte> inbound;
+    bool was_armed = false;
+    simplenet::result<void> server_status = simplenet::ok();
+
+    auto server = [&]() -> simplenet::runtime::task<void> {
+        auto accept_result = co_await simplenet::runtime::async_accept(listener);
+        if (!accept_result.has_value()) {
+            server_status = simplenet::err<void>(accept_result.error());
+            co_return;
+        }
+
+        auto peer = std::move(accept_result.value());
+        simplenet::runtime::multishot_receiver receiver{peer};
+        std::vector<simplenet::runtime::borrowed_buffer> held;
+        while (true) {
+            auto chunk = co_await receiver.receive();
+            if (!chunk.has_value()) {
+                server_status = simplenet::err<void>(chunk.error());
+                co_return;
+            }
+            was_armed = was_armed || receiver.multishot_active();
+            if (chunk.value().empty()) {
+                break;
+            }
+            const auto bytes = chunk.value().data();
+            inbound.insert(inbound.end(), bytes.begin(), bytes.end());
+            if (hold_buffers) {
+                held.push_back(std::move(chunk.value()));
+            }
+        }
+    };
+    loop.spawn(server());
+
+    std::thread client_thread([&, port = port_result.value()]() {
+        auto client = simplenet::blocking::tcp_stream::connect(
+            simplenet::blocking::endpoint::loopback(port));
+        if (client.has_value()) {
+            (void)simplenet::blocking::write_all(
+                client.value(), std::span<const std::byte>{outbound});
+        }
+    });
+
+    const auto run_result = loop.run();
+    client_thread.join();
+
+    if (!run_result.has_value()) {
+        return run_result;
+    }
+    if (!server_status.has_value()) {
+        return server_status;
+    }
+    if (!was_armed || inbound != outbound) {
+        return simplenet::err<void>(simplenet::make_error_from_errno(EBADMSG));
+    }
+    return simplenet::ok();
+}
+
+TEST(runtime_uring_test, multishot_receiver_streams_provided_buffers) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+
+    const auto status = receive_stream_holding_buffers(loop, 256U * 1024U, false);
+    ASSERT_TRUE(status.has_value()) << status.error().message();
+}
+
+TEST(runtime_uring_test, multishot_receiver_preserves_order_when_pool_exhausted) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable for runtime loop";
+    }
+
+    const std::size_t pool_bytes =
+        static_cast<std::size_t>(
+            simplenet::runtime::uring_event_loop::provided_buffer_count) *
+        simplenet::runtime::uring_event_loop::provided_buffer_size;
+    const auto status = receive_stream_holding_buffers(loop, pool_bytes * 2U, true);
+    ASSERT_TRUE(status.has_value()) << status.error().message();
+}
+
+TEST(runtime_uring_test, finished_roots_are_freed_while_others_stay_parked) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+
+    struct frame_probe {
+        int& destroyed;
+        ~frame_probe() {
+            ++destroyed;
+        }
+    };
+    int quick_destroyed = 0;
+    int destroyed_at_check = -1;
+    auto parked = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{40});
+    };
+    auto quick = [&]() -> simplenet::runtime::task<void> {
+        frame_probe probe{quick_destroyed};
+        co_return;
+    };
+    auto checker = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{10});
+        destroyed_at_check = quick_destroyed;
+    };
+    for (int index = 0; index < 200; ++index) {
+        loop.spawn(parked());
+        loop.spawn(quick());
+    }
+    loop.spawn(checker());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(destroyed_at_check, 200);
+}
+
+TEST(runtime_uring_test, detached_roots_free_their_frames_at_final_suspend) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    struct frame_probe {
+        int& destroyed;
+        ~frame_probe() {
+            ++destroyed;
+        }
+    };
+    int destroyed = 0;
+    int destroyed_at_check = -1;
+    auto handler = [&](int delay_ms) -> simplenet::runtime::task<int> {
+        frame_probe probe{destroyed};
+        (void)co_await simplenet::runtime::async_sleep(
+            std::chrono::milliseconds{delay_ms});
+        co_return delay_ms;
+    };
+    auto failing = [&]() -> simplenet::runtime::task<void> {
+        frame_probe probe{destroyed};
+        throw std::runtime_error("dropped with the frame");
+        co_return;
+    };
+    auto checker = [&]() -> simplenet::runtime::task<void> {
+        (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{20});
+        destroyed_at_check = destroyed;
+    };
+    loop.spawn_detached(handler(5));
+    loop.spawn_detached(failing());
+    loop.spawn_detached(handler(40));
+    loop.spawn(checker());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(destroyed_at_check, 2);
+    // `run()` waited for the last detached root.
+    EXPECT_EQ(destroyed, 3);
+
+    // One still parked when the loop goes away is destroyed with it.
+    {
+        simplenet::runtime::uring_event_loop inner;
+        ASSERT_TRUE(inner.valid());
+        auto stopper = [&]() -> simplenet::runtime::task<void> {
+            (void)co_await simplenet::runtime::async_sleep(std::chrono::milliseconds{5});
+            inner.stop();
+        };
+        inner.spawn_detached(handler(10000));
+        inner.spawn(stopper());
+        (void)inner.run();
+        EXPECT_EQ(destroyed, 3);
+    }
+    EXPECT_EQ(destroyed, 4);
+}
+
 } // namespace
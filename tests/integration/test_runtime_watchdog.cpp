@@ -0,0 +1,130 @@
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/io_ops.hpp"
+#include "simplenet/runtime/loop_watchdog.hpp"
+#include "simplenet/runtime/uring_event_loop.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::stall_report;
+using simplenet::runtime::task;
+
+struct collected {
+    std::mutex mutex;
+    std::vector<stall_report> reports;
+
+    std::vector<stall_report> copy() {
+        const std::lock_guard lock{mutex};
+        return reports;
+    }
+};
+
+void collect(const stall_report& stall, void *context) noexcept {
+    auto& seen = *static_cast<collected *>(context);
+    const std::lock_guard lock{seen.mutex};
+    seen.reports.push_back(stall);
+}
+
+task<void> quick(int rounds) {
+    for (int round = 0; round < rounds; ++round) {
+        (void)co_await simplenet::runtime::async_sleep(1ms);
+    }
+}
+
+/// Blocks its loop for `hold` inside one resume.
+task<void> hog(std::chrono::milliseconds hold) {
+    (void)co_await simplenet::runtime::async_sleep(1ms);
+    simplenet::runtime::set_stall_tag("hog");
+    std::this_thread::sleep_for(hold);
+}
+
+template <class Loop> void expect_slow_resume_reported(Loop& loop) {
+    collected seen;
+    simplenet::runtime::watchdog_hook hook{
+        .report = &collect, .context = &seen, .threshold = 3ms};
+    loop.set_watchdog(&hook);
+    loop.spawn(quick(5));
+    loop.spawn(hog(10ms));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    loop.set_watchdog(nullptr);
+
+    const auto reports = seen.copy();
+    ASSERT_EQ(reports.size(), 1U);
+    EXPECT_NE(reports[0].coroutine, nullptr);
+    ASSERT_NE(reports[0].tag, nullptr);
+    EXPECT_EQ(std::string_view{reports[0].tag}, "hog");
+    EXPECT_GE(reports[0].elapsed, 10ms);
+    EXPECT_FALSE(reports[0].still_running);
+}
+
+TEST(runtime_watchdog_test, epoll_loop_reports_slow_resume) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+    expect_slow_resume_reported(loop);
+}
+
+TEST(runtime_watchdog_test, uring_loop_reports_slow_resume) {
+    simplenet::runtime::uring_event_loop loop;
+    if (!loop.valid()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    expect_slow_resume_reported(loop);
+}
+
+TEST(runtime_watchdog_test, monitor_reports_stall_while_it_runs) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    collected seen;
+    simplenet::runtime::watchdog_hook hook{
+        .report = &collect, .context = &seen, .threshold = 5ms};
+    loop.set_watchdog(&hook);
+    {
+        simplenet::runtime::stall_monitor monitor{hook, 1ms};
+        monitor.watch(loop.heartbeat());
+        loop.spawn(hog(50ms));
+        const auto run_result = loop.run();
+        ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+        monitor.unwatch(loop.heartbeat());
+    }
+    loop.set_watchdog(nullptr);
+
+    // One report from the monitor mid-stall, one from the loop at its end.
+    const auto reports = seen.copy();
+    ASSERT_EQ(reports.size(), 2U);
+    EXPECT_TRUE(reports[0].still_running);
+    EXPECT_FALSE(reports[1].still_running);
+    EXPECT_EQ(reports[0].coroutine, reports[1].coroutine);
+    ASSERT_NE(reports[0].tag, nullptr);
+    EXPECT_EQ(std::string_view{reports[0].tag}, "hog");
+    EXPECT_GE(reports[0].elapsed, 5ms);
+    EXPECT_LT(reports[0].elapsed, reports[1].elapsed);
+}
+
+TEST(runtime_watchdog_test, uninstalled_watchdog_reports_nothing) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    collected seen;
+    simplenet::runtime::watchdog_hook hook{
+        .report = &collect, .context = &seen, .threshold = 1ms};
+    loop.set_watchdog(&hook);
+    loop.set_watchdog(nullptr);
+    loop.spawn(hog(5ms));
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+
+    EXPECT_TRUE(seen.copy().empty());
+    EXPECT_EQ(loop.heartbeat().started.load(), 0);
+}
+
+} // namespace
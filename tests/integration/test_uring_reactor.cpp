@@ -1,17 +1,43 @@
 #include "simplenet/core/unique_fd.hpp"
+#include "simplenet/uring/buffer_ring.hpp"
+#include "simplenet/uring/probe.hpp"
 #include "simplenet/uring/reactor.hpp"
 
 #include <array>
+#include <cerrno>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
 #include <unistd.h>
 
 namespace {
 
+TEST(uring_reactor_test, probe_matches_ring_setup) {
+    const auto detected = simplenet::uring::probe_support();
+    auto reactor_result = simplenet::uring::reactor::create(8U);
+    EXPECT_EQ(detected.ring_available(), reactor_result.has_value());
+    if (!detected.ring_available()) {
+        EXPECT_FALSE(detected.runtime_ready());
+        EXPECT_FALSE(detected.poll_add);
+        GTEST_SKIP() << "io_uring unavailable, setup errno "
+                     << detected.setup_error;
+    }
+    EXPECT_NE(detected.features, 0U);
+    // Present on every kernel with a probe interface.
+    EXPECT_TRUE(detected.poll_add);
+    EXPECT_TRUE(detected.timeout);
+    EXPECT_EQ(&simplenet::uring::cached_support(),
+              &simplenet::uring::cached_support());
+    EXPECT_EQ(simplenet::uring::cached_support().runtime_ready(),
+              detected.runtime_ready());
+}
+
 TEST(uring_reactor_test, poll_add_waits_for_pipe_readability) {
     auto reactor_result = simplenet::uring::reactor::create();
     if (!reactor_result.has_value()) {
@@ -86,4 +112,320 @@ TEST(uring_reactor_test, timeout_returns_zero_ready_completions) {
     ASSERT_TRUE(reactor.submit().has_value());
 }
 
+TEST(uring_reactor_test, linked_timeout_cancels_poll_at_deadline) {
+    auto reactor_result = simplenet::uring::reactor::create();
+    if (!reactor_result.has_value()) {
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reactor_result.error().message();
+    }
+    auto reactor = std::move(reactor_result.value());
+    if (!reactor.supports_link_timeout()) {
+        GTEST_SKIP() << "IORING_OP_LINK_TIMEOUT unsupported";
+    }
+
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    simplenet::unique_fd read_end{pipe_fds[0]};
+    simplenet::unique_fd write_end{pipe_fds[1]};
+
+    ::timespec now{};
+    ASSERT_EQ(::clock_gettime(CLOCK_MONOTONIC, &now), 0);
+    __kernel_timespec deadline{};
+    deadline.tv_sec = now.tv_sec;
+    deadline.tv_nsec = now.tv_nsec + 20'000'000;
+    if (deadline.tv_nsec >= 1'000'000'000) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1'000'000'000;
+    }
+
+    constexpr std::uint64_t request_token = 3;
+    const auto add_result =
+        reactor.submit_poll_add(request_token, read_end.get(), POLLIN, deadline);
+    ASSERT_TRUE(add_result.has_value()) << add_result.error().message();
+    ASSERT_TRUE(reactor.submit().has_value());
+
+    // One CQE for the poll and one, with user data 0, for the timeout.
+    int poll_result = 0;
+    int timeout_result = 0;
+    std::array<simplenet::uring::completion, 8> completions{};
+    for (int round = 0; round < 10 && (poll_result == 0 || timeout_result == 0);
+         ++round) {
+        const auto wait_result =
+            reactor.wait(completions, std::chrono::milliseconds{100});
+        ASSERT_TRUE(wait_result.has_value()) << wait_result.error().message();
+        for (std::size_t i = 0; i < wait_result.value(); ++i) {
+            if (completions[i].user_data == request_token) {
+                poll_result = completions[i].result;
+            } else if (completions[i].user_data == 0U) {
+                timeout_result = completions[i].result;
+            }
+        }
+    }
+    EXPECT_EQ(poll_result, -ECANCELED);
+    EXPECT_EQ(timeout_result, -ETIME);
+}
+
+TEST(uring_reactor_test, send_and_recv_complete_with_byte_counts) {
+    auto reactor_result = simplenet::uring::reactor::create();
+    if (!reactor_result.has_value()) {
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reactor_result.error().message();
+    }
+    auto reactor = std::move(reactor_result.value());
+
+    std::array<int, 2> socket_fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, socket_fds.data()),
+              0);
+    simplenet::unique_fd left{socket_fds[0]};
+    simplenet::unique_fd right{socket_fds[1]};
+
+    constexpr std::uint64_t recv_token = 3;
+    constexpr std::uint64_t send_token = 4;
+    std::array<std::byte, 16> inbound{};
+    constexpr std::array<std::byte, 4> outbound{std::byte{1}, std::byte{2},
+                                                std::byte{3}, std::byte{4}};
+
+    ASSERT_TRUE(reactor.submit_recv(recv_token, right.get(), inbound).has_value());
+    ASSERT_TRUE(reactor.submit().has_value());
+    ASSERT_TRUE(reactor.submit_send(send_token, left.get(), outbound).has_value());
+    ASSERT_TRUE(reactor.submit().has_value());
+
+    std::array<simplenet::uring::completion, 8> completions{};
+    int recv_result = -1;
+    int send_result = -1;
+    for (int attempt = 0; attempt < 10 && (recv_result < 0 || send_result < 0);
+         ++attempt) {
+        const auto wait_result =
+            reactor.wait(completions, std::chrono::milliseconds{100});
+        ASSERT_TRUE(wait_result.has_value()) << wait_result.error().message();
+        for (std::size_t i = 0; i < wait_result.value(); ++i) {
+            if (completions[i].user_data == recv_token) {
+                recv_result = completions[i].result;
+            } else if (completions[i].user_data == send_token) {
+                send_result = completions[i].result;
+            }
+        }
+    }
+
+    EXPECT_EQ(send_result, static_cast<int>(outbound.size()));
+    ASSERT_EQ(recv_result, static_cast<int>(outbound.size()));
+    EXPECT_EQ(inbound[0], std::byte{1});
+    EXPECT_EQ(inbound[3], std::byte{4});
+}
+
+TEST(uring_reactor_test, multishot_recv_selects_provided_buffers) {
+    auto reactor_result = simplenet::uring::reactor::create();
+    if (!reactor_result.has_value()) {
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reactor_result.error().message();
+    }
+    auto reactor = std::move(reactor_result.value());
+
+    auto ring_result = simplenet::uring::buffer_ring::create(reactor, 7, 8, 64);
+    if (!ring_result.has_value()) {
+        GTEST_SKIP() << "provided buffer rings unavailable: "
+                     << ring_result.error().message();
+    }
+    auto ring = std::move(ring_result.value());
+    EXPECT_EQ(ring.count(), 8U);
+    EXPECT_EQ(ring.buffer_size(), 64U);
+
+    std::array<int, 2> socket_fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, socket_fds.data()),
+              0);
+    simplenet::unique_fd left{socket_fds[0]};
+    simplenet::unique_fd right{socket_fds[1]};
+
+    constexpr std::uint64_t recv_token = 5;
+    ASSERT_TRUE(
+        reactor.submit_recv_multishot(recv_token, right.get(), ring.group())
+            .has_value());
+    ASSERT_TRUE(reactor.submit().has_value());
+
+    constexpr std::array<std::byte, 3> payload{std::byte{7}, std::byte{8},
+                                               std::byte{9}};
+    ASSERT_EQ(::write(left.get(), payload.data(), payload.size()), 3);
+
+    std::array<simplenet::uring::completion, 8> completions{};
+    const auto wait_result =
+        reactor.wait(completions, std::chrono::milliseconds{250});
+    ASSERT_TRUE(wait_result.has_value()) << wait_result.error().message();
+    ASSERT_GE(wait_result.value(), 1U);
+
+    const auto& first = completions[0];
+    ASSERT_EQ(first.user_data, recv_token);
+    ASSERT_EQ(first.result, 3);
+    ASSERT_NE(first.flags & IORING_CQE_F_BUFFER, 0U);
+    EXPECT_NE(first.flags & IORING_CQE_F_MORE, 0U);
+
+    const auto id =
+        static_cast<std::uint16_t>(first.flags >> IORING_CQE_BUFFER_SHIFT);
+    const auto bytes = ring.buffer(id);
+    ASSERT_EQ(bytes.size(), 64U);
+    EXPECT_EQ(bytes[0], std::byte{7});
+    EXPECT_EQ(bytes[2], std::byte{9});
+    ring.recycle(id);
+
+    ASSERT_TRUE(reactor.submit_cancel(recv_token).has_value());
+    ASSERT_TRUE(reactor.submit().has_value());
+}
+
+TEST(uring_reactor_test, registered_files_and_buffers_are_used_transparently) {
+    auto reactor_result = simplenet::uring::reactor::create();
+    if (!reactor_result.has_value()) {
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reactor_result.error().message();
+    }
+    auto reactor = std::move(reactor_result.value());
+
+    std::array<int, 2> socket_fds{};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0, socket_fds.data()),
+              0);
+    simplenet::unique_fd left{socket_fds[0]};
+    simplenet::unique_fd right{socket_fds[1]};
+
+    const auto files_result = reactor.register_file(right.get());
+    if (!files_result.has_value()) {
+        GTEST_SKIP() << "registered files unavailable: "
+                     << files_result.error().message();
+    }
+    ASSERT_TRUE(reactor.register_file(right.get()).has_value());
+    ASSERT_TRUE(reactor.register_file(left.get()).has_value());
+    EXPECT_EQ(reactor.file_slot(right.get()), 0U);
+    EXPECT_EQ(reactor.file_slot(left.get()), 1U);
+
+    std::array<std::byte, 64> arena{};
+    const std::array<::iovec, 1> fixed{
+        ::iovec{.iov_base = arena.data(), .iov_len = arena.size()}};
+    const bool buffers_registered = reactor.register_buffers(fixed).has_value();
+
+    constexpr std::uint64_t recv_token = 7;
+    constexpr std::uint64_t send_token = 8;
+    constexpr std::array<std::byte, 3> outbound{std::byte{9}, std::byte{8},
+                                                std::byte{7}};
+    ASSERT_TRUE(reactor
+                    .submit_recv(recv_token, right.get(),
+                                 std::span<std::byte>{arena}.subspan(16, 16))
+                    .has_value());
+    ASSERT_TRUE(reactor.submit_send(send_token, left.get(), outbound).has_value());
+    ASSERT_TRUE(reactor.submit().has_value());
+
+    std::array<simplenet::uring::completion, 8> completions{};
+    int recv_result = -1;
+    int send_result = -1;
+    for (int attempt = 0; attempt < 10 && (recv_result < 0 || send_result < 0);
+         ++attempt) {
+        const auto wait_result =
+            reactor.wait(completions, std::chrono::milliseconds{100});
+        ASSERT_TRUE(wait_result.has_value()) << wait_result.error().message();
+        for (std::size_t i = 0; i < wait_result.value(); ++i) {
+            if (completions[i].user_data == recv_token) {
+                recv_result = completions[i].result;
+            } else if (completions[i].user_data == send_token) {
+                send_result = completions[i].result;
+            }
+        }
+    }
+
+    EXPECT_EQ(send_result, static_cast<int>(outbound.size()));
+    ASSERT_EQ(recv_result, static_cast<int>(outbound.size()));
+    EXPECT_EQ(arena[16], std::byte{9});
+    EXPECT_EQ(arena[18], std::byte{7});
+
+    ASSERT_TRUE(reactor.unregister_file(right.get()).has_value());
+    EXPECT_FALSE(reactor.file_slot(right.get()).has_value());
+    ASSERT_TRUE(reactor.unregister_file(left.get()).has_value());
+    if (buffers_registered) {
+        EXPECT_TRUE(reactor.unregister_buffers().has_value());
+    }
+}
+
+TEST(uring_reactor_test, setup_options_fall_back_to_supported_flags) {
+    EXPECT_FALSE(simplenet::uring::reactor::create(
+                     simplenet::uring::ring_options{.queue_depth = 0})
+                     .has_value());
+
+    const simplenet::uring::ring_options options{
+        .queue_depth = 64,
+        .cq_entries = 512,
+        .defer_taskrun = true,
+        .coop_taskrun = true,
+    };
+    auto reactor_result = simplenet::uring::reactor::create(options);
+    if (!reactor_result.has_value()) {
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reactor_result.error().message();
+    }
+    auto reactor = std::move(reactor_result.value());
+
+    constexpr std::uint32_t requested =
+        IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER |
+        IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_COOP_TASKRUN;
+    EXPECT_EQ(reactor.setup_flags() & ~requested, 0U);
+
+    // The ring works with whatever subset was accepted.
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    simplenet::unique_fd read_end{pipe_fds[0]};
+    simplenet::unique_fd write_end{pipe_fds[1]};
+    ASSERT_TRUE(reactor.submit_poll_add(5, read_end.get(), POLLIN).has_value());
+    ASSERT_TRUE(reactor.submit().has_value());
+    constexpr std::array<std::byte, 1> payload{std::byte{0x33}};
+    ASSERT_EQ(::write(write_end.get(), payload.data(), payload.size()), 1);
+
+    std::array<simplenet::uring::completion, 4> completions{};
+    const auto wait_result =
+        reactor.wait(completions, std::chrono::milliseconds{250});
+    ASSERT_TRUE(wait_result.has_value()) << wait_result.error().message();
+    ASSERT_EQ(wait_result.value(), 1U);
+    EXPECT_EQ(completions[0].user_data, 5U);
+}
+
+TEST(uring_reactor_test, submit_and_wait_reaps_completions_in_batches) {
+    auto reactor_result = simplenet::uring::reactor::create();
+    if (!reactor_result.has_value()) {
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reactor_result.error().message();
+    }
+    auto reactor = std::move(reactor_result.value());
+
+    std::array<int, 2> pipe_fds{};
+    ASSERT_EQ(::pipe2(pipe_fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+    simplenet::unique_fd read_end{pipe_fds[0]};
+    simplenet::unique_fd write_end{pipe_fds[1]};
+
+    // More polls than one peek batch, all completed by a single write.
+    constexpr std::uint64_t kPolls = 100;
+    for (std::uint64_t token = 1; token <= kPolls; ++token) {
+        ASSERT_TRUE(
+            reactor.submit_poll_add(token, read_end.get(), POLLIN).has_value());
+    }
+    std::array<simplenet::uring::completion, 128> completions{};
+    const auto idle =
+        reactor.submit_and_wait(completions, std::chrono::milliseconds{0});
+    ASSERT_TRUE(idle.has_value()) << idle.error().message();
+    EXPECT_EQ(idle.value(), 0U);
+
+    constexpr std::array<std::byte, 1> payload{std::byte{0x44}};
+    ASSERT_EQ(::write(write_end.get(), payload.data(), payload.size()), 1);
+
+    std::size_t reaped = 0;
+    std::uint64_t token_sum = 0;
+    for (int attempt = 0; attempt < 10 && reaped < kPolls; ++attempt) {
+        const auto wait_result = reactor.submit_and_wait(
+            std::span{completions}.subspan(reaped),
+            std::chrono::milliseconds{100});
+        ASSERT_TRUE(wait_result.has_value()) << wait_result.error().message();
+        for (std::size_t i = reaped; i < reaped + wait_result.value(); ++i) {
+            token_sum += completions[i].user_data;
+        }
+        reaped += wait_result.value();
+    }
+    EXPECT_EQ(reaped, kPolls);
+    EXPECT_EQ(token_sum, kPolls * (kPolls + 1U) / 2U);
+}
+
 } // namespace
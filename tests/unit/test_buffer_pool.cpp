@@ -0,0 +1,119 @@
+#include "simplenet/runtime/buffer_pool.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using simplenet::runtime::buffer_pool;
+using simplenet::runtime::buffer_pool_options;
+using simplenet::runtime::pooled_buffer;
+
+TEST(buffer_pool_test, requests_round_up_to_power_of_two_classes) {
+    buffer_pool pool{buffer_pool_options{.min_size = 100, .max_size = 5000}};
+    const auto small = pool.acquire(1);
+    EXPECT_EQ(small.size(), 1U);
+    EXPECT_EQ(small.capacity(), 128U);
+    const auto middle = pool.acquire(129);
+    EXPECT_EQ(middle.capacity(), 256U);
+    const auto top = pool.acquire(8192 / 2 + 1);
+    EXPECT_EQ(top.capacity(), 8192U);
+
+    // Past the largest class: a one-off buffer of exactly that size.
+    const auto large = pool.acquire(10000);
+    EXPECT_EQ(large.capacity(), 10000U);
+}
+
+TEST(buffer_pool_test, released_buffers_are_reused_without_allocating) {
+    buffer_pool pool;
+    std::byte *first = nullptr;
+    {
+        auto buffer = pool.acquire(4000);
+        first = buffer.bytes().data();
+    }
+    EXPECT_EQ(pool.stats().cached_buffers, 1U);
+
+    const auto before = pool.stats();
+    for (int round = 0; round < 100; ++round) {
+        auto buffer = pool.acquire(3000);
+        EXPECT_EQ(buffer.bytes().data(), first);
+        buffer.resize(10);
+        EXPECT_EQ(buffer.size(), 10U);
+        buffer.resize(1U << 20U);
+        EXPECT_EQ(buffer.size(), buffer.capacity());
+    }
+    const auto after = pool.stats();
+    EXPECT_EQ(after.heap_allocations, before.heap_allocations);
+    EXPECT_EQ(after.reuses - before.reuses, 100U);
+}
+
+TEST(buffer_pool_test, heap_cache_is_bounded_per_class) {
+    buffer_pool pool{buffer_pool_options{.cache_per_class = 2}};
+    {
+        std::vector<pooled_buffer> held;
+        for (int index = 0; index < 5; ++index) {
+            held.push_back(pool.acquire(512));
+        }
+    }
+    EXPECT_EQ(pool.stats().cached_buffers, 2U);
+    pool.trim();
+    EXPECT_EQ(pool.stats().cached_buffers, 0U);
+}
+
+TEST(buffer_pool_test, arena_backs_buffers_until_it_runs_out) {
+    buffer_pool pool{buffer_pool_options{.max_size = 64U * 1024U,
+                                         .arena_bytes = 128U * 1024U}};
+    const auto arena = pool.arena();
+    ASSERT_EQ(arena.size(), 128U * 1024U);
+
+    std::vector<pooled_buffer> held;
+    for (int index = 0; index < 3; ++index) {
+        held.push_back(pool.acquire(64U * 1024U));
+    }
+    EXPECT_EQ(held[0].bytes().data(), arena.data());
+    EXPECT_GE(held[1].bytes().data(), arena.data());
+    EXPECT_EQ(pool.stats().arena_allocations, 2U);
+    EXPECT_EQ(pool.stats().heap_allocations, 1U);
+    EXPECT_EQ(pool.stats().arena_used, arena.size());
+
+    held.clear();
+    pool.trim();
+    // Arena buffers stay cached; the heap one was freed.
+    EXPECT_EQ(pool.stats().cached_buffers, 2U);
+}
+
+TEST(buffer_pool_test, huge_page_arena_falls_back_gracefully) {
+    buffer_pool pool{buffer_pool_options{.arena_bytes = 1, .huge_pages = true}};
+    // One huge page, from MAP_HUGETLB or transparent huge pages.
+    EXPECT_EQ(pool.arena().size(), 2U * 1024U * 1024U);
+    auto buffer = pool.acquire(1000);
+    buffer.bytes()[999] = std::byte{1};
+    EXPECT_EQ(pool.stats().arena_allocations, 1U);
+}
+
+TEST(buffer_pool_test, numa_preferred_arena_still_serves_buffers) {
+    // Node 0 exists on every Linux host; a refused `mbind` is ignored.
+    buffer_pool pool{buffer_pool_options{.arena_bytes = 64U * 1024U, .numa_node = 0}};
+    ASSERT_EQ(pool.arena().size(), 64U * 1024U);
+    auto buffer = pool.acquire(4096);
+    buffer.bytes()[4095] = std::byte{1};
+    EXPECT_EQ(buffer.bytes().data(), pool.arena().data());
+}
+
+TEST(buffer_pool_test, moved_handles_return_once) {
+    buffer_pool pool;
+    auto first = pool.acquire(64);
+    auto second = std::move(first);
+    EXPECT_FALSE(first.valid());
+    EXPECT_TRUE(second.valid());
+    first = pool.acquire(64);
+    first = std::move(second);
+    second = {};
+    EXPECT_EQ(pool.stats().cached_buffers, 1U);
+    first = {};
+    EXPECT_EQ(pool.stats().cached_buffers, 2U);
+    EXPECT_EQ(&simplenet::runtime::thread_buffer_pool(),
+              &simplenet::runtime::thread_buffer_pool());
+}
+
+} // namespace
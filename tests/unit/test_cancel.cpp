@@ -0,0 +1,121 @@
+#include "simplenet/runtime/cancel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <optional>
+#include <thread>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::cancel_callback;
+using simplenet::runtime::cancel_source;
+using simplenet::runtime::cancel_token;
+
+TEST(cancel_test, request_stop_runs_registered_callbacks_once) {
+    cancel_source source;
+    int first = 0;
+    int second = 0;
+    cancel_callback first_callback{source.token(), [&]() noexcept { ++first; }};
+    cancel_callback second_callback{source.token(),
+                                    [&]() noexcept { ++second; }};
+
+    EXPECT_FALSE(source.token().stop_requested());
+    EXPECT_TRUE(source.request_stop());
+    EXPECT_FALSE(source.request_stop());
+    EXPECT_TRUE(source.token().stop_requested());
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+}
+
+TEST(cancel_test, callback_registered_after_stop_runs_inline) {
+    cancel_source source;
+    source.request_stop();
+
+    int calls = 0;
+    cancel_callback callback{source.token(), [&]() noexcept { ++calls; }};
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(cancel_test, destroyed_callback_is_not_invoked) {
+    cancel_source source;
+    int calls = 0;
+    {
+        cancel_callback callback{source.token(), [&]() noexcept { ++calls; }};
+    }
+    source.request_stop();
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(cancel_test, default_token_never_invokes_callbacks) {
+    const cancel_token token;
+    int calls = 0;
+    cancel_callback callback{token, [&]() noexcept { ++calls; }};
+    EXPECT_FALSE(token.stop_possible());
+    EXPECT_FALSE(token.stop_requested());
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(cancel_test, callback_may_destroy_its_own_registration) {
+    // The callback type cannot name its own optional, so reset it through
+    // a type-erased hook.
+    struct self_reset {
+        void (*reset)(void *slot) noexcept;
+        void *slot;
+        int *calls;
+        void operator()() const noexcept {
+            ++*calls;
+            reset(slot);
+        }
+    };
+    using slot_type = std::optional<cancel_callback<self_reset>>;
+
+    cancel_source source;
+    int calls = 0;
+    slot_type callback;
+    callback.emplace(source.token(),
+                     self_reset{[](void *slot) noexcept {
+                                    static_cast<slot_type *>(slot)->reset();
+                                },
+                                &callback, &calls});
+    source.request_stop();
+    EXPECT_EQ(calls, 1);
+    EXPECT_FALSE(callback.has_value());
+}
+
+TEST(cancel_test, destruction_waits_for_callback_running_on_another_thread) {
+    cancel_source source;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    bool finished_before_destruction = false;
+
+    std::thread stopper;
+    {
+        cancel_callback callback{source.token(), [&]() noexcept {
+                                     entered.store(true);
+                                     std::this_thread::sleep_for(50ms);
+                                     finished.store(true);
+                                 }};
+        stopper = std::thread{[&]() { source.request_stop(); }};
+        while (!entered.load()) {
+            std::this_thread::yield();
+        }
+    }
+    finished_before_destruction = finished.load();
+    stopper.join();
+    EXPECT_TRUE(finished_before_destruction);
+}
+
+TEST(cancel_test, recycled_state_starts_unrequested) {
+    for (int i = 0; i < 4; ++i) {
+        cancel_source source;
+        EXPECT_FALSE(source.token().stop_requested());
+        int calls = 0;
+        cancel_callback callback{source.token(), [&]() noexcept { ++calls; }};
+        source.request_stop();
+        EXPECT_EQ(calls, 1);
+    }
+}
+
+} // namespace
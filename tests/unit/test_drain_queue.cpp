@@ -0,0 +1,84 @@
+#include "simplenet/runtime/drain_queue.hpp"
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using simplenet::runtime::drain_hook;
+using simplenet::runtime::drain_queue;
+
+TEST(drain_queue_test, pops_in_fifo_order_and_ignores_requeues) {
+    drain_queue queue;
+    drain_hook first{};
+    drain_hook second{};
+    drain_hook third{};
+
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.push(first));
+    EXPECT_TRUE(queue.push(second));
+    EXPECT_FALSE(queue.push(first));
+    EXPECT_TRUE(queue.push(third));
+    EXPECT_EQ(queue.size(), 3U);
+
+    queue.withdraw(second);
+    EXPECT_FALSE(second.queued);
+    queue.withdraw(second);
+    EXPECT_EQ(queue.size(), 2U);
+
+    EXPECT_EQ(queue.pop(), &first);
+    EXPECT_FALSE(first.queued);
+    EXPECT_EQ(queue.pop(), &third);
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.empty());
+}
+
+struct recording_hook : drain_hook {
+    std::vector<int> *log{nullptr};
+
+    recording_hook() noexcept {
+        run = [](drain_hook& hook) noexcept {
+            static_cast<recording_hook&>(hook).log->push_back(0);
+        };
+    }
+};
+
+simplenet::runtime::task<void> log_step(std::vector<int>& log, int step) {
+    log.push_back(step);
+    co_return;
+}
+
+TEST(drain_queue_test, loop_runs_hooks_once_ready_tasks_drain) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    std::vector<int> log;
+    recording_hook hook{};
+    hook.log = &log;
+    recording_hook withdrawn{};
+    withdrawn.log = &log;
+
+    auto first = [&]() -> simplenet::runtime::task<void> {
+        log.push_back(1);
+        EXPECT_TRUE(loop.defer_to_drain(hook));
+        EXPECT_TRUE(loop.defer_to_drain(hook));
+        EXPECT_TRUE(loop.defer_to_drain(withdrawn));
+        co_return;
+    };
+    auto second = [&]() -> simplenet::runtime::task<void> {
+        log.push_back(2);
+        loop.withdraw_drain_hook(withdrawn);
+        co_return;
+    };
+    loop.spawn(first());
+    loop.spawn(second());
+    loop.spawn(log_step(log, 3));
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(log, (std::vector<int>{1, 2, 3, 0}));
+}
+
+} // namespace
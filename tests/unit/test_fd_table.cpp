@@ -0,0 +1,62 @@
+#include "simplenet/runtime/fd_table.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using simplenet::runtime::fd_table;
+
+struct test_slot {
+    int value{0};
+};
+
+TEST(fd_table_test, find_returns_null_until_slot_is_created) {
+    fd_table<test_slot> table;
+    EXPECT_EQ(table.find(3), nullptr);
+    EXPECT_EQ(table.find(-1), nullptr);
+    EXPECT_EQ(table.get_or_create(-1), nullptr);
+
+    auto *slot = table.get_or_create(3);
+    ASSERT_NE(slot, nullptr);
+    slot->value = 7;
+    EXPECT_EQ(table.find(3), slot);
+    EXPECT_EQ(table.find(3)->value, 7);
+}
+
+TEST(fd_table_test, slots_keep_their_address_as_the_table_grows) {
+    fd_table<test_slot> table;
+    auto *low = table.get_or_create(1);
+    ASSERT_NE(low, nullptr);
+    low->value = 1;
+
+    auto *high = table.get_or_create(10'000);
+    ASSERT_NE(high, nullptr);
+    high->value = 2;
+
+    EXPECT_EQ(table.find(1), low);
+    EXPECT_EQ(low->value, 1);
+    EXPECT_EQ(table.find(10'000), high);
+    // Chunks in between stay unallocated.
+    EXPECT_EQ(table.find(5'000), nullptr);
+}
+
+TEST(fd_table_test, for_each_visits_allocated_slots_and_clear_releases_them) {
+    fd_table<test_slot> table;
+    table.get_or_create(0)->value = 1;
+    table.get_or_create(200)->value = 2;
+
+    std::vector<int> values;
+    table.for_each([&](test_slot& slot) {
+        if (slot.value != 0) {
+            values.push_back(slot.value);
+        }
+    });
+    EXPECT_EQ(values, (std::vector<int>{1, 2}));
+
+    table.clear();
+    EXPECT_EQ(table.find(0), nullptr);
+    EXPECT_EQ(table.find(200), nullptr);
+}
+
+} // namespace
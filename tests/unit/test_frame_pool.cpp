@@ -0,0 +1,91 @@
+#include "simplenet/runtime/event_loop.hpp"
+#include "simplenet/runtime/frame_pool.hpp"
+#include "simplenet/runtime/task.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace {
+
+using simplenet::runtime::frame_pool_thread_stats;
+namespace detail = simplenet::runtime::detail;
+
+simplenet::runtime::task<int> answer() {
+    co_return 42;
+}
+
+TEST(frame_pool_test, released_frames_are_reused_per_size_class) {
+    simplenet::runtime::frame_pool_trim();
+    const auto before = frame_pool_thread_stats();
+    EXPECT_EQ(before.cached_frames, 0U);
+
+    void *first = detail::allocate_frame(100);
+    detail::deallocate_frame(first, 100);
+    EXPECT_EQ(frame_pool_thread_stats().cached_frames, 1U);
+    EXPECT_EQ(frame_pool_thread_stats().cached_bytes, 128U);
+
+    // Any size in the same class takes the parked frame.
+    void *second = detail::allocate_frame(120);
+    EXPECT_EQ(second, first);
+    const auto after = frame_pool_thread_stats();
+    EXPECT_EQ(after.allocations - before.allocations, 2U);
+    EXPECT_EQ(after.reuses - before.reuses, 1U);
+    EXPECT_EQ(after.cached_frames, 0U);
+    detail::deallocate_frame(second, 120);
+
+    simplenet::runtime::frame_pool_trim();
+    EXPECT_EQ(frame_pool_thread_stats().cached_frames, 0U);
+    EXPECT_EQ(frame_pool_thread_stats().cached_bytes, 0U);
+}
+
+TEST(frame_pool_test, oversized_frames_bypass_the_pool) {
+    const auto before = frame_pool_thread_stats();
+    constexpr auto kSize = simplenet::runtime::frame_pool_max_size + 1;
+    void *frame = detail::allocate_frame(kSize);
+    detail::deallocate_frame(frame, kSize);
+
+    const auto after = frame_pool_thread_stats();
+    EXPECT_EQ(after.oversized - before.oversized, 1U);
+    EXPECT_EQ(after.cached_frames, before.cached_frames);
+}
+
+TEST(frame_pool_test, steady_state_awaits_do_not_touch_the_heap) {
+    simplenet::runtime::event_loop loop;
+    ASSERT_TRUE(loop.valid());
+
+    constexpr int kAwaits = 1000;
+    int sum = 0;
+    simplenet::runtime::frame_pool_stats warm{};
+    auto chain = [&]() -> simplenet::runtime::task<void> {
+        sum += co_await answer();
+        warm = frame_pool_thread_stats();
+        for (int index = 1; index < kAwaits; ++index) {
+            sum += co_await answer();
+        }
+    };
+    loop.spawn(chain());
+
+    const auto run_result = loop.run();
+    ASSERT_TRUE(run_result.has_value()) << run_result.error().message();
+    EXPECT_EQ(sum, 42 * kAwaits);
+
+    const auto done = frame_pool_thread_stats();
+    EXPECT_GE(done.allocations - warm.allocations,
+              static_cast<std::uint64_t>(kAwaits - 1));
+    // After the first await, every child frame came from the free list.
+    EXPECT_EQ(done.allocations - warm.allocations, done.reuses - warm.reuses);
+}
+
+TEST(frame_pool_test, pools_are_per_thread) {
+    void *frame = detail::allocate_frame(64);
+    detail::deallocate_frame(frame, 64);
+    EXPECT_GE(frame_pool_thread_stats().cached_frames, 1U);
+
+    simplenet::runtime::frame_pool_stats other{};
+    std::thread worker([&] { other = frame_pool_thread_stats(); });
+    worker.join();
+    EXPECT_EQ(other.cached_frames, 0U);
+    EXPECT_EQ(other.allocations, 0U);
+}
+
+} // namespace
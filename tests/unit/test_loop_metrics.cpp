@@ -0,0 +1,89 @@
+#include "simplenet/runtime/loop_metrics.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::latency_histogram;
+
+TEST(loop_metrics_test, buckets_tile_the_range_without_gaps) {
+    EXPECT_EQ(latency_histogram::bucket_index(0), 0U);
+    EXPECT_EQ(latency_histogram::bucket_index(15), 15U);
+    for (std::size_t index = 0; index + 1U < latency_histogram::bucket_count;
+         ++index) {
+        const auto lower = latency_histogram::bucket_lower_bound(index);
+        const auto upper = latency_histogram::bucket_upper_bound(index);
+        ASSERT_EQ(upper, latency_histogram::bucket_lower_bound(index + 1U));
+        ASSERT_EQ(latency_histogram::bucket_index(lower), index);
+        ASSERT_EQ(latency_histogram::bucket_index(upper - 1U), index);
+        // Each bucket is at most 1/16 of the values it holds.
+        ASSERT_LE((upper - lower) * 16U, std::max<std::uint64_t>(lower, 16U));
+    }
+    EXPECT_EQ(latency_histogram::bucket_index(~std::uint64_t{0}),
+              latency_histogram::bucket_count - 1U);
+}
+
+TEST(loop_metrics_test, quantiles_stay_within_bucket_precision) {
+    latency_histogram histogram;
+    EXPECT_EQ(histogram.value_at_quantile(0.5), 0ns);
+    for (int value = 1; value <= 1000; ++value) {
+        histogram.record(std::chrono::microseconds{value});
+    }
+    EXPECT_EQ(histogram.count(), 1000U);
+    EXPECT_EQ(histogram.max(), 1000us);
+    EXPECT_EQ(histogram.sum(), std::chrono::microseconds{500500});
+
+    const auto median = histogram.value_at_quantile(0.5);
+    EXPECT_GE(median, 500us);
+    EXPECT_LE(median, 500us + 500us / 16);
+    const auto p99 = histogram.value_at_quantile(0.99);
+    EXPECT_GE(p99, 990us);
+    EXPECT_LE(p99, 1000us);
+    EXPECT_EQ(histogram.value_at_quantile(1.0), 1000us);
+
+    latency_histogram other;
+    other.record(-5ns);
+    other.record(2s);
+    histogram.merge(other);
+    EXPECT_EQ(histogram.count(), 1002U);
+    EXPECT_EQ(histogram.max(), 2s);
+    EXPECT_EQ(histogram.count_at(0), 1U);
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0U);
+}
+
+TEST(loop_metrics_test, prometheus_text_has_counters_and_cumulative_buckets) {
+    simplenet::runtime::loop_metrics metrics;
+    metrics.iterations = 7;
+    metrics.resumes = 42;
+    metrics.resume_latency.record(3ns);
+    metrics.resume_latency.record(100ns);
+    metrics.resume_latency.record(1us);
+
+    const auto text = simplenet::runtime::format_prometheus(metrics, "io-0");
+    EXPECT_NE(text.find("# TYPE simplenet_loop_iterations_total counter\n"
+                        "simplenet_loop_iterations_total{loop=\"io-0\"} 7\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("simplenet_loop_resumes_total{loop=\"io-0\"} 42\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE simplenet_loop_resume_seconds histogram\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("simplenet_loop_resume_seconds_bucket{loop=\"io-0\","
+                        "le=\"4e-09\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("simplenet_loop_resume_seconds_bucket{loop=\"io-0\","
+                        "le=\"1.28e-07\"} 2\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("simplenet_loop_resume_seconds_bucket{loop=\"io-0\","
+                        "le=\"+Inf\"} 3\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("simplenet_loop_resume_seconds_count{loop=\"io-0\"} 3\n"),
+              std::string::npos);
+    // Buckets stop at the first power of two past the largest sample.
+    EXPECT_EQ(text.find("le=\"2.048e-06\""), std::string::npos);
+}
+
+} // namespace
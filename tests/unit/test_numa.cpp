@@ -0,0 +1,57 @@
+#include "simplenet/runtime/numa.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <gtest/gtest.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+namespace {
+
+namespace numa = simplenet::runtime::numa;
+
+TEST(numa_test, cpu_and_node_lookups_agree) {
+    const int cpu = ::sched_getcpu();
+    ASSERT_GE(cpu, 0);
+    const int node = numa::node_of_cpu(cpu);
+    if (node < 0) {
+        GTEST_SKIP() << "no NUMA topology in sysfs";
+    }
+    const auto cpus = numa::cpus_of_node(node);
+    EXPECT_NE(std::ranges::find(cpus, cpu), cpus.end());
+    EXPECT_TRUE(std::ranges::is_sorted(cpus));
+}
+
+TEST(numa_test, unknown_nodes_cpus_and_interfaces_report_nothing) {
+    EXPECT_TRUE(numa::cpus_of_node(-1).empty());
+    EXPECT_TRUE(numa::cpus_of_node(1 << 20).empty());
+    EXPECT_EQ(numa::node_of_cpu(-1), -1);
+    EXPECT_EQ(numa::node_of_cpu(1 << 20), -1);
+    // Loopback has no device, and names cannot leave the sysfs directory.
+    EXPECT_EQ(numa::node_of_interface("lo"), -1);
+    EXPECT_EQ(numa::node_of_interface("../../devices"), -1);
+    EXPECT_EQ(numa::node_of_interface(""), -1);
+}
+
+TEST(numa_test, prefer_node_binds_untouched_pages) {
+    constexpr std::size_t kLength = 64U * 1024U;
+    void *region = ::mmap(nullptr, kLength, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(region, MAP_FAILED);
+
+    const auto rejected = numa::prefer_node(region, kLength, -1);
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error().value(), EINVAL);
+
+    const auto preferred = numa::prefer_node(region, kLength, 0);
+    if (!preferred.has_value() && (preferred.error().value() == ENOSYS ||
+                                   preferred.error().value() == EPERM)) {
+        ::munmap(region, kLength);
+        GTEST_SKIP() << "mbind unavailable: " << preferred.error().message();
+    }
+    EXPECT_TRUE(preferred.has_value()) << preferred.error().message();
+    static_cast<unsigned char *>(region)[0] = 1;
+    ::munmap(region, kLength);
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+#include "simplenet/runtime/ring_queue.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using simplenet::runtime::ring_queue;
+
+TEST(ring_queue_test, empty_queue_owns_no_storage) {
+    ring_queue<int> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.capacity(), 0U);
+    EXPECT_EQ(queue.begin(), queue.end());
+
+    queue.push_back(1);
+    EXPECT_GT(queue.capacity(), 0U);
+    queue.pop_front();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.capacity(), 0U);
+}
+
+TEST(ring_queue_test, keeps_fifo_order_across_wraps_and_growth) {
+    ring_queue<std::string> queue;
+    int next_in = 0;
+    int next_out = 0;
+    // Interleave so the head walks around the ring before it grows.
+    for (int round = 0; round < 50; ++round) {
+        for (int push = 0; push < 3; ++push) {
+            queue.push_back(std::to_string(next_in++));
+        }
+        for (int pop = 0; pop < 2; ++pop) {
+            ASSERT_EQ(queue.front(), std::to_string(next_out++));
+            queue.pop_front();
+        }
+    }
+    EXPECT_EQ(queue.size(), 50U);
+    EXPECT_EQ(queue.back(), std::to_string(next_in - 1));
+
+    std::vector<std::string> seen(queue.begin(), queue.end());
+    ASSERT_EQ(seen.size(), 50U);
+    EXPECT_EQ(seen.front(), std::to_string(next_out));
+    EXPECT_EQ(seen.back(), std::to_string(next_in - 1));
+}
+
+TEST(ring_queue_test, moves_and_clear_destroy_each_element_once) {
+    auto tracked = std::make_shared<int>(0);
+    {
+        ring_queue<std::shared_ptr<int>> queue;
+        for (int index = 0; index < 9; ++index) {
+            queue.push_back(std::shared_ptr<int>{tracked});
+        }
+        EXPECT_EQ(tracked.use_count(), 10);
+
+        auto moved = std::move(queue);
+        EXPECT_TRUE(queue.empty());
+        EXPECT_EQ(queue.capacity(), 0U);
+        EXPECT_EQ(moved.size(), 9U);
+
+        ring_queue<std::shared_ptr<int>> assigned;
+        assigned.push_back(std::shared_ptr<int>{tracked});
+        assigned = std::move(moved);
+        EXPECT_EQ(tracked.use_count(), 10);
+
+        assigned.pop_front();
+        EXPECT_EQ(tracked.use_count(), 9);
+        const auto& view = assigned;
+        int visited = 0;
+        for (const auto& element : view) {
+            EXPECT_EQ(element, tracked);
+            ++visited;
+        }
+        EXPECT_EQ(visited, 8);
+        assigned.clear();
+        EXPECT_EQ(tracked.use_count(), 1);
+        EXPECT_EQ(assigned.capacity(), 0U);
+        assigned.push_back(std::shared_ptr<int>{tracked});
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+} // namespace
@@ -0,0 +1,86 @@
+#include "simplenet/runtime/frame_pool.hpp"
+#include "simplenet/runtime/shared_buffer.hpp"
+
+#include <array>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using simplenet::runtime::buffer_sharing;
+using simplenet::runtime::frame_pool_thread_stats;
+using simplenet::runtime::shared_buffer;
+
+TEST(shared_buffer_test, copies_share_one_block) {
+    const std::array<std::byte, 3> message{std::byte{1}, std::byte{2}, std::byte{3}};
+    auto original = shared_buffer::copy_of(message);
+    ASSERT_EQ(original.size(), 3U);
+    EXPECT_EQ(original.use_count(), 1U);
+
+    {
+        std::vector<shared_buffer> subscribers(100, original);
+        EXPECT_EQ(original.use_count(), 101U);
+        EXPECT_EQ(subscribers.back().bytes().data(), original.bytes().data());
+    }
+    EXPECT_EQ(original.use_count(), 1U);
+
+    auto moved = std::move(original);
+    EXPECT_TRUE(original.empty());
+    EXPECT_EQ(original.use_count(), 0U);
+    EXPECT_EQ(moved.use_count(), 1U);
+    EXPECT_EQ(moved.bytes()[2], std::byte{3});
+
+    shared_buffer assigned;
+    assigned = moved;
+    EXPECT_EQ(moved.use_count(), 2U);
+    assigned = shared_buffer{};
+    EXPECT_EQ(moved.use_count(), 1U);
+}
+
+TEST(shared_buffer_test, build_fills_in_place_and_empty_allocates_nothing) {
+    const auto built = shared_buffer::build(4, [](std::span<std::byte> out) {
+        for (std::size_t index = 0; index < out.size(); ++index) {
+            out[index] = static_cast<std::byte>(index * 2U);
+        }
+    });
+    ASSERT_EQ(built.size(), 4U);
+    EXPECT_EQ(built.bytes()[3], std::byte{6});
+
+    const auto before = frame_pool_thread_stats().allocations;
+    const auto empty = shared_buffer::copy_of({});
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.use_count(), 0U);
+    EXPECT_EQ(frame_pool_thread_stats().allocations, before);
+}
+
+TEST(shared_buffer_test, small_blocks_are_recycled_through_the_frame_pool) {
+    const std::vector<std::byte> message(256, std::byte{0x5A});
+    { (void)shared_buffer::copy_of(message); }
+    const auto before = frame_pool_thread_stats();
+    { (void)shared_buffer::copy_of(message); }
+    const auto after = frame_pool_thread_stats();
+    EXPECT_EQ(after.allocations - before.allocations, 1U);
+    EXPECT_EQ(after.reuses - before.reuses, 1U);
+}
+
+TEST(shared_buffer_test, cross_thread_copies_release_safely) {
+    const std::vector<std::byte> message(64, std::byte{0x11});
+    auto original = shared_buffer::copy_of(message, buffer_sharing::cross_thread);
+
+    std::vector<std::thread> threads;
+    for (int worker = 0; worker < 4; ++worker) {
+        threads.emplace_back([original] {
+            for (int round = 0; round < 10000; ++round) {
+                const shared_buffer copy = original;
+                EXPECT_EQ(copy.bytes()[0], std::byte{0x11});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(original.use_count(), 1U);
+}
+
+} // namespace
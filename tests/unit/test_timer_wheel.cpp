@@ -0,0 +1,146 @@
+#include "simplenet/runtime/timer_wheel.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::timer_entry;
+using simplenet::runtime::timer_wheel;
+
+const auto kEpoch = timer_wheel::clock::time_point{} + 1000h;
+
+std::vector<int> expire_ids(timer_wheel& wheel,
+                            timer_wheel::clock::time_point now) {
+    std::vector<int> fired;
+    wheel.expire(now, [&](timer_entry& entry) {
+        fired.push_back(*static_cast<int*>(entry.context));
+    });
+    return fired;
+}
+
+TEST(timer_wheel_test, fires_entries_at_their_deadline_not_before) {
+    timer_wheel wheel{kEpoch};
+    int id = 7;
+    timer_entry entry;
+    entry.context = &id;
+
+    wheel.schedule(entry, kEpoch + 10ms);
+    EXPECT_TRUE(entry.scheduled());
+    EXPECT_EQ(wheel.size(), 1U);
+
+    EXPECT_TRUE(expire_ids(wheel, kEpoch + 9ms).empty());
+    EXPECT_TRUE(expire_ids(wheel, kEpoch + 9ms + 999us).empty());
+    EXPECT_EQ(expire_ids(wheel, kEpoch + 10ms), std::vector<int>{7});
+    EXPECT_FALSE(entry.scheduled());
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timer_wheel_test, cascades_entries_across_all_levels_in_order) {
+    timer_wheel wheel{kEpoch};
+    const std::array<std::chrono::milliseconds, 6> deadlines{
+        3ms, 255ms, 256ms, 70s, 5h, 400h};
+    std::array<int, deadlines.size()> ids{};
+    std::array<timer_entry, deadlines.size()> entries;
+    for (std::size_t i = deadlines.size(); i-- > 0;) {
+        ids[i] = static_cast<int>(i);
+        entries[i].context = &ids[i];
+        wheel.schedule(entries[i], kEpoch + deadlines[i]);
+    }
+
+    for (std::size_t i = 0; i < deadlines.size(); ++i) {
+        const auto next = wheel.next_expiry();
+        ASSERT_TRUE(next.has_value());
+        EXPECT_LE(next.value(), kEpoch + deadlines[i]);
+
+        EXPECT_TRUE(expire_ids(wheel, kEpoch + deadlines[i] - 1ms).empty())
+            << "entry " << i << " fired early";
+        EXPECT_EQ(expire_ids(wheel, kEpoch + deadlines[i]),
+                  std::vector<int>{static_cast<int>(i)});
+    }
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.next_expiry().has_value());
+}
+
+TEST(timer_wheel_test, deadlines_beyond_wheel_span_still_fire) {
+    timer_wheel wheel{kEpoch};
+    int id = 1;
+    timer_entry entry;
+    entry.context = &id;
+    wheel.schedule(entry, kEpoch + 24h * 60);
+
+    // Follow next_expiry() like a loop would; only a handful of cascade
+    // wakeups should be needed to reach a two-month deadline.
+    auto now = kEpoch;
+    std::vector<int> fired;
+    int wakeups = 0;
+    while (fired.empty() && wakeups < 64) {
+        const auto next = wheel.next_expiry();
+        ASSERT_TRUE(next.has_value());
+        ASSERT_GT(next.value(), now);
+        now = next.value();
+        fired = expire_ids(wheel, now);
+        ++wakeups;
+    }
+    EXPECT_EQ(fired, std::vector<int>{1});
+    EXPECT_GE(now, kEpoch + 24h * 60);
+}
+
+TEST(timer_wheel_test, cancel_unlinks_entry_in_constant_time) {
+    timer_wheel wheel{kEpoch};
+    std::array<int, 3> ids{0, 1, 2};
+    std::array<timer_entry, 3> entries;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        entries[i].context = &ids[i];
+        wheel.schedule(entries[i], kEpoch + 5ms);
+    }
+
+    wheel.cancel(entries[1]);
+    wheel.cancel(entries[1]);
+    EXPECT_FALSE(entries[1].scheduled());
+    EXPECT_EQ(wheel.size(), 2U);
+    EXPECT_EQ(expire_ids(wheel, kEpoch + 5ms), (std::vector<int>{0, 2}));
+}
+
+TEST(timer_wheel_test, past_deadlines_fire_on_next_expire) {
+    timer_wheel wheel{kEpoch};
+    EXPECT_TRUE(expire_ids(wheel, kEpoch + 50ms).empty());
+
+    int id = 3;
+    timer_entry entry;
+    entry.context = &id;
+    wheel.schedule(entry, kEpoch + 10ms);
+    ASSERT_TRUE(wheel.next_expiry().has_value());
+    EXPECT_LE(wheel.next_expiry().value(), kEpoch + 50ms);
+    EXPECT_EQ(expire_ids(wheel, kEpoch + 50ms), std::vector<int>{3});
+}
+
+TEST(timer_wheel_test, callbacks_may_reschedule_and_cancel_pending_entries) {
+    timer_wheel wheel{kEpoch};
+    std::array<int, 2> ids{0, 1};
+    std::array<timer_entry, 2> entries;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        entries[i].context = &ids[i];
+        wheel.schedule(entries[i], kEpoch + 2ms);
+    }
+
+    std::vector<int> fired;
+    wheel.expire(kEpoch + 2ms, [&](timer_entry& entry) {
+        const int id = *static_cast<int*>(entry.context);
+        fired.push_back(id);
+        if (id == 0) {
+            wheel.cancel(entries[1]);
+            wheel.schedule(entry, kEpoch + 4ms);
+        }
+    });
+    EXPECT_EQ(fired, std::vector<int>{0});
+    EXPECT_TRUE(entries[0].scheduled());
+    EXPECT_EQ(entries[0].deadline(), kEpoch + 4ms);
+    EXPECT_EQ(expire_ids(wheel, kEpoch + 4ms), std::vector<int>{0});
+}
+
+} // namespace
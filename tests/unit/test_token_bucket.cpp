@@ -0,0 +1,58 @@
+#include "simplenet/runtime/token_bucket.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <limits>
+
+namespace {
+
+using namespace std::chrono_literals;
+using simplenet::runtime::token_bucket;
+
+const auto kEpoch = token_bucket::clock::time_point{} + 1000h;
+
+TEST(token_bucket_test, starts_full_and_refills_at_rate) {
+    token_bucket bucket{1000, 500, kEpoch};
+    EXPECT_EQ(bucket.available(kEpoch), 500U);
+
+    bucket.consume(500);
+    EXPECT_EQ(bucket.available(kEpoch), 0U);
+    EXPECT_EQ(bucket.available(kEpoch + 100ms), 100U);
+    // Refill stops at the capacity.
+    EXPECT_EQ(bucket.available(kEpoch + 10s), 500U);
+}
+
+TEST(token_bucket_test, ready_at_is_when_enough_tokens_accrued) {
+    token_bucket bucket{1000, 500, kEpoch};
+    bucket.consume(500);
+
+    EXPECT_EQ(bucket.ready_at(250, kEpoch), kEpoch + 250ms);
+    // Requests above the capacity wait for a full bucket only.
+    EXPECT_EQ(bucket.ready_at(5000, kEpoch), kEpoch + 500ms);
+    EXPECT_EQ(bucket.ready_at(100, kEpoch + 200ms), kEpoch + 200ms);
+}
+
+TEST(token_bucket_test, default_burst_is_ten_milliseconds_of_rate) {
+    const token_bucket fast{std::uint64_t{10} << 20, 0, kEpoch};
+    EXPECT_EQ(fast.burst(), (std::size_t{10} << 20) / 100U);
+    const token_bucket slow{1000, 0, kEpoch};
+    EXPECT_EQ(slow.burst(), 1024U);
+}
+
+TEST(token_bucket_test, zero_rate_never_limits) {
+    token_bucket bucket{0, 0, kEpoch};
+    bucket.consume(1U << 30);
+    EXPECT_EQ(bucket.available(kEpoch), std::numeric_limits<std::size_t>::max());
+    EXPECT_EQ(bucket.ready_at(1U << 30, kEpoch), kEpoch);
+}
+
+TEST(token_bucket_test, set_rate_keeps_tokens_within_new_capacity) {
+    token_bucket bucket{1000, 800, kEpoch};
+    bucket.set_rate(2000, 300, kEpoch);
+    EXPECT_EQ(bucket.available(kEpoch), 300U);
+    bucket.consume(300);
+    EXPECT_EQ(bucket.available(kEpoch + 100ms), 200U);
+}
+
+} // namespace
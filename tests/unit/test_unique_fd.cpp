@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 #include <stdexcept>
 #include <unistd.h>
+#include <vector>
 
 namespace {
 
@@ -120,4 +121,35 @@ TEST(unique_fd_test, close_fd_reports_error_for_invalid_descriptor) {
     EXPECT_EQ(close_result.error().value(), EBADF);
 }
 
+TEST(unique_fd_test, close_listeners_see_descriptors_before_they_close) {
+    struct observed {
+        std::vector<int> fds;
+        bool was_open{true};
+    } seen;
+
+    simplenet::detail::close_listener listener{};
+    listener.context = &seen;
+    listener.on_close = [](simplenet::detail::close_listener& self,
+                           int fd) noexcept {
+        auto& state = *static_cast<observed *>(self.context);
+        state.fds.push_back(fd);
+        state.was_open = state.was_open && ::fcntl(fd, F_GETFD) != -1;
+    };
+    simplenet::detail::add_close_listener(listener);
+
+    const auto fds = make_pipe();
+    {
+        simplenet::unique_fd read_end{fds[0]};
+    }
+    EXPECT_TRUE(simplenet::close_fd(fds[1]).has_value());
+    simplenet::detail::remove_close_listener(listener);
+
+    const auto other = make_pipe();
+    simplenet::unique_fd{other[0]}.reset();
+    EXPECT_TRUE(simplenet::close_fd(other[1]).has_value());
+
+    EXPECT_EQ(seen.fds, (std::vector<int>{fds[0], fds[1]}));
+    EXPECT_TRUE(seen.was_open);
+}
+
 } // namespace
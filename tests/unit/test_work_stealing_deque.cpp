@@ -0,0 +1,91 @@
+#include "simplenet/runtime/work_stealing_deque.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using simplenet::runtime::work_stealing_deque;
+
+TEST(work_stealing_deque_test, owner_pops_newest_and_thieves_take_oldest) {
+    work_stealing_deque<int *> deque;
+    std::array<int, 3> items{1, 2, 3};
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+
+    for (auto& item : items) {
+        deque.push(&item);
+    }
+    EXPECT_FALSE(deque.empty());
+    EXPECT_EQ(deque.pop(), &items[2]);
+    EXPECT_EQ(deque.steal(), &items[0]);
+    EXPECT_EQ(deque.pop(), &items[1]);
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.pop(), nullptr);
+}
+
+TEST(work_stealing_deque_test, growth_keeps_every_item) {
+    constexpr std::size_t kCount = work_stealing_deque<int *>::initial_capacity * 5;
+    work_stealing_deque<int *> deque;
+    std::vector<int> items(kCount);
+
+    // Offset top from zero so the copy into the larger ring wraps.
+    deque.push(&items[0]);
+    EXPECT_EQ(deque.steal(), &items[0]);
+    for (std::size_t index = 1; index < kCount; ++index) {
+        deque.push(&items[index]);
+    }
+
+    for (std::size_t index = 1; index < kCount; ++index) {
+        EXPECT_EQ(deque.steal(), &items[index]);
+    }
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(work_stealing_deque_test, concurrent_thieves_take_each_item_once) {
+    constexpr std::size_t kCount = 20'000;
+    constexpr std::size_t kThieves = 3;
+    work_stealing_deque<std::atomic<int> *> deque;
+    std::vector<std::atomic<int>> taken(kCount);
+    std::atomic<bool> done{false};
+
+    auto claim = [](std::atomic<int> *item) { item->fetch_add(1); };
+
+    std::vector<std::thread> thieves;
+    for (std::size_t thief = 0; thief < kThieves; ++thief) {
+        thieves.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (auto *item = deque.steal()) {
+                    claim(item);
+                }
+            }
+        });
+    }
+
+    for (std::size_t index = 0; index < kCount; ++index) {
+        deque.push(&taken[index]);
+        if (index % 3 == 0) {
+            if (auto *item = deque.pop()) {
+                claim(item);
+            }
+        }
+    }
+    while (auto *item = deque.pop()) {
+        claim(item);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    for (const auto& count : taken) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+} // namespace